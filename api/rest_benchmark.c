@@ -0,0 +1,467 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "api/rest_server.h"
+#include "core/model_manager.h"
+#include "utils/logger.h"
+
+/**
+ * @brief REST API 服务器压力测试
+ *
+ * 在进程内启动服务器，用单线程 epoll 客户端在回环地址上保持大量并发连接，
+ * 每个连接循环发送请求，统计吞吐量和延迟分布。默认每个请求使用新连接，
+ * 保持连接时在同一连接上连续发送，流水线深度大于1时一次发出多个请求再依次读取响应。
+ */
+
+#define LATENCY_BUCKET_US 10
+#define LATENCY_BUCKETS 100000      /* 最多统计 1 秒 */
+#define RESPONSE_BUFFER_SIZE 4096
+#define CHUNK_SIZE 16384
+
+typedef struct {
+    uint32_t connections;
+    double duration;
+    uint32_t reactors;
+    uint32_t workers;
+    size_t body_size;
+    bool keep_alive;
+    uint32_t pipeline;
+    bool chunked;
+} RestBenchConfig;
+
+typedef enum {
+    CLIENT_CONNECTING = 0,
+    CLIENT_SENDING,
+    CLIENT_RECEIVING
+} ClientState;
+
+typedef struct {
+    int fd;
+    ClientState state;
+    size_t sent;
+    size_t received;
+    size_t expected;                /**< 完整响应长度（0表示响应头未收完） */
+    uint32_t pending;               /**< 本批次还未收到的响应数 */
+    bool watch_out;                 /**< 是否在等待可写事件 */
+    double start_us;
+    char buffer[RESPONSE_BUFFER_SIZE];
+} Client;
+
+typedef struct {
+    struct sockaddr_in addr;
+    int epoll_fd;
+    char* request;                  /**< 一个批次的请求（流水线深度个请求首尾相接） */
+    size_t request_length;
+    uint32_t pipeline;
+    bool keep_alive;
+    uint64_t completed;
+    uint64_t errors;
+    uint32_t* histogram;
+    double max_latency_us;
+} BenchState;
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static void print_usage(const char* program_name) {
+    printf("REST API 服务器压力测试\n");
+    printf("\n");
+    printf("用法: %s [选项]\n", program_name);
+    printf("\n");
+    printf("选项:\n");
+    printf("  -c, --connections <数量>  并发连接数 (默认: 1000)\n");
+    printf("  -d, --duration <秒>       测试时长 (默认: 5)\n");
+    printf("  -r, --reactors <数量>     服务器 reactor 线程数 (默认: 1)\n");
+    printf("  -w, --workers <数量>      服务器工作线程数 (默认: 在线 CPU 数)\n");
+    printf("  -b, --body <字节>         发送推理请求并附带指定大小的请求体 (默认: 0，发送健康检查)\n");
+    printf("  -k, --keep-alive          保持连接，在同一连接上连续发送请求\n");
+    printf("  -p, --pipeline <深度>     每个连接一次发出的请求数 (默认: 1，大于1时保持连接)\n");
+    printf("  --chunked                 请求体使用分块传输 (每块 16KB)\n");
+    printf("  --help                    显示帮助信息\n");
+}
+
+// 构造一个请求报文
+static char* build_single_request(const RestBenchConfig* config, size_t* length) {
+    const char* connection = config->keep_alive ? "keep-alive" : "close";
+    char header[256];
+    int header_length;
+    if (config->body_size == 0) {
+        header_length = snprintf(header, sizeof(header),
+                                 "GET /health HTTP/1.1\r\nHost: localhost\r\nConnection: %s\r\n\r\n", connection);
+    } else if (config->chunked) {
+        header_length = snprintf(header, sizeof(header),
+                                 "POST /models/bench/infer HTTP/1.1\r\nHost: localhost\r\nConnection: %s\r\n"
+                                 "Content-Type: application/octet-stream\r\nTransfer-Encoding: chunked\r\n\r\n",
+                                 connection);
+    } else {
+        header_length = snprintf(header, sizeof(header),
+                                 "POST /models/bench/infer HTTP/1.1\r\nHost: localhost\r\nConnection: %s\r\n"
+                                 "Content-Type: application/octet-stream\r\nContent-Length: %zu\r\n\r\n",
+                                 connection, config->body_size);
+    }
+
+    // 分块时每块最多带 16 字节的大小行和 CRLF
+    size_t chunk_count = config->chunked ? (config->body_size + CHUNK_SIZE - 1) / CHUNK_SIZE : 0;
+    char* request = malloc((size_t)header_length + config->body_size + chunk_count * 16 + 8);
+    if (!request) return NULL;
+
+    memcpy(request, header, (size_t)header_length);
+    size_t position = (size_t)header_length;
+    for (size_t offset = 0; offset < config->body_size;) {
+        size_t size = config->body_size - offset;
+        if (config->chunked) {
+            if (size > CHUNK_SIZE) size = CHUNK_SIZE;
+            position += (size_t)sprintf(request + position, "%zx\r\n", size);
+        }
+        for (size_t i = 0; i < size; i++) {
+            request[position++] = (char)('a' + (offset + i) % 26);
+        }
+        if (config->chunked) {
+            memcpy(request + position, "\r\n", 2);
+            position += 2;
+        }
+        offset += size;
+    }
+    if (config->chunked && config->body_size > 0) {
+        memcpy(request + position, "0\r\n\r\n", 5);
+        position += 5;
+    }
+    *length = position;
+    return request;
+}
+
+// 构造一个批次的请求：流水线深度个相同的请求
+static char* build_request(const RestBenchConfig* config, size_t* length) {
+    size_t single_length = 0;
+    char* single = build_single_request(config, &single_length);
+    if (!single) return NULL;
+
+    char* request = malloc(single_length * config->pipeline);
+    if (request) {
+        for (uint32_t i = 0; i < config->pipeline; i++) {
+            memcpy(request + i * single_length, single, single_length);
+        }
+        *length = single_length * config->pipeline;
+    }
+    free(single);
+    return request;
+}
+
+static void record_latency(BenchState* state, double latency_us) {
+    size_t bucket = (size_t)(latency_us / LATENCY_BUCKET_US);
+    if (bucket >= LATENCY_BUCKETS) bucket = LATENCY_BUCKETS - 1;
+    state->histogram[bucket]++;
+    if (latency_us > state->max_latency_us) state->max_latency_us = latency_us;
+}
+
+static double latency_percentile(const BenchState* state, double percentile) {
+    uint64_t target = (uint64_t)((double)state->completed * percentile);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += state->histogram[i];
+        if (seen > target) return (double)(i + 1) * LATENCY_BUCKET_US;
+    }
+    return state->max_latency_us;
+}
+
+// 建立新连接并开始发送请求
+static int client_connect(BenchState* state, Client* client) {
+    client->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (client->fd < 0) return -1;
+
+    int opt = 1;
+    setsockopt(client->fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+    client->state = CLIENT_CONNECTING;
+    client->sent = 0;
+    client->received = 0;
+    client->expected = 0;
+    client->pending = state->pipeline;
+    client->watch_out = true;
+    client->start_us = now_us();
+
+    if (connect(client->fd, (struct sockaddr*)&state->addr, sizeof(state->addr)) != 0 && errno != EINPROGRESS) {
+        close(client->fd);
+        client->fd = -1;
+        return -1;
+    }
+
+    struct epoll_event event = { .events = EPOLLOUT | EPOLLIN, .data.ptr = client };
+    if (epoll_ctl(state->epoll_fd, EPOLL_CTL_ADD, client->fd, &event) != 0) {
+        close(client->fd);
+        client->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+static void client_restart(BenchState* state, Client* client, bool failed) {
+    if (failed) state->errors++;
+    close(client->fd);
+    client->fd = -1;
+    if (client_connect(state, client) != 0) {
+        state->errors++;
+    }
+}
+
+static void client_send(BenchState* state, Client* client) {
+    client->state = CLIENT_SENDING;
+    while (client->sent < state->request_length) {
+        ssize_t sent = send(client->fd, state->request + client->sent, state->request_length - client->sent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            client->sent += (size_t)sent;
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!client->watch_out) {
+                struct epoll_event event = { .events = EPOLLOUT | EPOLLIN, .data.ptr = client };
+                epoll_ctl(state->epoll_fd, EPOLL_CTL_MOD, client->fd, &event);
+                client->watch_out = true;
+            }
+            return;
+        }
+        client_restart(state, client, true);
+        return;
+    }
+
+    client->state = CLIENT_RECEIVING;
+    if (client->watch_out) {
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = client };
+        epoll_ctl(state->epoll_fd, EPOLL_CTL_MOD, client->fd, &event);
+        client->watch_out = false;
+    }
+}
+
+// 保持连接时在同一连接上发送下一批请求
+static void client_next_batch(BenchState* state, Client* client) {
+    client->sent = 0;
+    client->pending = state->pipeline;
+    client->start_us = now_us();
+    client_send(state, client);
+}
+
+// 读取响应，一批全部收到后记录延迟，继续下一批或重新连接
+static void client_receive(BenchState* state, Client* client) {
+    for (;;) {
+        ssize_t received = recv(client->fd, client->buffer + client->received,
+                                sizeof(client->buffer) - 1 - client->received, 0);
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (received <= 0) {
+            client_restart(state, client, true);
+            return;
+        }
+        client->received += (size_t)received;
+        client->buffer[client->received] = '\0';
+
+        // 缓冲区中可能有多个流水线响应
+        for (;;) {
+            if (client->expected == 0) {
+                char* header_end = strstr(client->buffer, "\r\n\r\n");
+                if (!header_end) {
+                    if (client->received >= sizeof(client->buffer) - 1) {
+                        client_restart(state, client, true);
+                        return;
+                    }
+                    break;
+                }
+                const char* length = strstr(client->buffer, "Content-Length:");
+                if (!length || length > header_end || strncmp(client->buffer, "HTTP/1.1 200", 12) != 0) {
+                    client_restart(state, client, true);
+                    return;
+                }
+                client->expected = (size_t)(header_end + 4 - client->buffer) + strtoul(length + 15, NULL, 10);
+                if (client->expected >= sizeof(client->buffer)) {
+                    client_restart(state, client, true);
+                    return;
+                }
+            }
+            if (client->received < client->expected) break;
+
+            state->completed++;
+            record_latency(state, now_us() - client->start_us);
+            client->received -= client->expected;
+            memmove(client->buffer, client->buffer + client->expected, client->received + 1);
+            client->expected = 0;
+
+            if (--client->pending == 0) {
+                if (!state->keep_alive || client->received > 0) {
+                    client_restart(state, client, client->received > 0);
+                } else {
+                    client_next_batch(state, client);
+                }
+                return;
+            }
+        }
+    }
+}
+
+static int run_benchmark(const RestBenchConfig* config, uint16_t port) {
+    BenchState state;
+    memset(&state, 0, sizeof(state));
+    state.addr.sin_family = AF_INET;
+    state.addr.sin_port = htons(port);
+    state.addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    state.request = build_request(config, &state.request_length);
+    state.pipeline = config->pipeline;
+    state.keep_alive = config->keep_alive;
+    state.histogram = calloc(LATENCY_BUCKETS, sizeof(uint32_t));
+    state.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+    Client* clients = calloc(config->connections, sizeof(Client));
+    if (!state.request || !state.histogram || !clients || state.epoll_fd < 0) {
+        printf("❌ 初始化客户端失败\n");
+        free(state.request);
+        free(state.histogram);
+        free(clients);
+        if (state.epoll_fd >= 0) close(state.epoll_fd);
+        return -1;
+    }
+
+    uint32_t opened = 0;
+    for (uint32_t i = 0; i < config->connections; i++) {
+        if (client_connect(&state, &clients[i]) == 0) opened++;
+    }
+    printf("建立 %u/%u 个并发连接，运行 %.1f 秒...\n", opened, config->connections, config->duration);
+
+    struct epoll_event events[256];
+    double start = now_us();
+    double end = start + config->duration * 1e6;
+    while (now_us() < end) {
+        int count = epoll_wait(state.epoll_fd, events, 256, 100);
+        for (int i = 0; i < count; i++) {
+            Client* client = events[i].data.ptr;
+            if (client->fd < 0) continue;
+
+            if (events[i].events & EPOLLERR) {
+                client_restart(&state, client, true);
+            } else if (client->state == CLIENT_CONNECTING || client->state == CLIENT_SENDING) {
+                if (events[i].events & EPOLLOUT) client_send(&state, client);
+            } else if (client->state == CLIENT_RECEIVING) {
+                client_receive(&state, client);
+            }
+        }
+    }
+    double elapsed = (now_us() - start) / 1e6;
+
+    printf("\n结果:\n");
+    printf("  完成请求:   %llu\n", (unsigned long long)state.completed);
+    printf("  错误:       %llu\n", (unsigned long long)state.errors);
+    printf("  吞吐量:     %.0f 请求/秒\n", (double)state.completed / elapsed);
+    if (state.completed > 0) {
+        printf("  延迟 P50:   %.2f ms\n", latency_percentile(&state, 0.50) / 1000.0);
+        printf("  延迟 P99:   %.2f ms\n", latency_percentile(&state, 0.99) / 1000.0);
+        printf("  延迟最大:   %.2f ms\n", state.max_latency_us / 1000.0);
+    }
+
+    for (uint32_t i = 0; i < config->connections; i++) {
+        if (clients[i].fd >= 0) close(clients[i].fd);
+    }
+    close(state.epoll_fd);
+    free(clients);
+    free(state.histogram);
+    free(state.request);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    RestBenchConfig config = { 1000, 5.0, 1, 0, 0, false, 1, false };
+
+    static struct option long_options[] = {
+        {"connections", required_argument, 0, 'c'},
+        {"duration", required_argument, 0, 'd'},
+        {"reactors", required_argument, 0, 'r'},
+        {"workers", required_argument, 0, 'w'},
+        {"body", required_argument, 0, 'b'},
+        {"keep-alive", no_argument, 0, 'k'},
+        {"pipeline", required_argument, 0, 'p'},
+        {"chunked", no_argument, 0, 'C'},
+        {"help", no_argument, 0, 'H'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "c:d:r:w:b:kp:H", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'c':
+                config.connections = (uint32_t)atoi(optarg);
+                break;
+            case 'd':
+                config.duration = atof(optarg);
+                break;
+            case 'r':
+                config.reactors = (uint32_t)atoi(optarg);
+                break;
+            case 'w':
+                config.workers = (uint32_t)atoi(optarg);
+                break;
+            case 'b':
+                config.body_size = (size_t)atol(optarg);
+                break;
+            case 'k':
+                config.keep_alive = true;
+                break;
+            case 'p':
+                config.pipeline = (uint32_t)atoi(optarg);
+                break;
+            case 'C':
+                config.chunked = true;
+                break;
+            case 'H':
+            default:
+                print_usage(argv[0]);
+                return 0;
+        }
+    }
+
+    if (config.pipeline > 1) {
+        config.keep_alive = true;
+    }
+    if (config.connections == 0 || config.duration <= 0 || config.pipeline == 0) {
+        printf("❌ 无效的参数\n");
+        return 1;
+    }
+
+    logger_init(LOG_LEVEL_WARN, NULL);
+    logger_set_console_output(true);
+
+    ModelManager* manager = model_manager_create();
+    if (!manager) {
+        printf("❌ 模型管理器创建失败\n");
+        return 1;
+    }
+
+    rest_server_config_t server_config = {0};
+    server_config.reactors = config.reactors;
+    server_config.workers = config.workers;
+    server_config.max_connections = config.connections * 2;
+
+    RestServer* server = rest_server_create_with_config("127.0.0.1", 0, manager, &server_config);
+    if (!server || rest_server_start(server) != 0) {
+        printf("❌ REST服务器启动失败\n");
+        rest_server_destroy(server);
+        model_manager_destroy(manager);
+        return 1;
+    }
+
+    printf("REST API 压力测试: 端口 %u，%u 个reactor，请求体 %zu 字节%s，%s，流水线深度 %u\n",
+           rest_server_get_port(server), config.reactors, config.body_size, config.chunked ? "（分块）" : "",
+           config.keep_alive ? "保持连接" : "每个请求新建连接", config.pipeline);
+    int result = run_benchmark(&config, rest_server_get_port(server));
+
+    rest_server_destroy(server);
+    model_manager_destroy(manager);
+    logger_cleanup();
+    return result == 0 ? 0 : 1;
+}
@@ -1,122 +1,567 @@
+#define _GNU_SOURCE  // accept4, memmem
+
 #include "api/rest_server.h"
 #include "utils/logger.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
 #include <pthread.h>
 #include <signal.h>
+#include <stdatomic.h>
 
 /**
  * @brief REST API 服务器实现
- * 
- * 注意：这是一个简化的HTTP服务器实现，仅用于演示
+ *
+ * 每个 reactor 线程持有一个 epoll 实例，以非阻塞方式接受连接、增量读取和解析请求、发送响应；
+ * 请求完整后连接从 epoll 中移除并放入任务队列，由工作线程执行处理函数生成响应，
+ * 再通过完成队列和 eventfd 交回所属的 reactor 发送。
+ *
+ * 连接默认保持（HTTP/1.1 keep-alive），响应发完后先处理输入缓冲区中已到达的流水线请求，
+ * 没有时再等待新数据；同一连接上的请求按顺序逐个处理，响应顺序与请求一致。
+ * 请求体支持 Content-Length 和分块传输（chunked，原地解码）。输入缓冲区按 2 的幂规格
+ * 从 reactor 的缓冲池分配，连接空闲时归还，空闲连接不占用输入缓冲区。
+ *
+ * 注意：HTTP 解析只覆盖本服务的 API 所需的子集，
  * 生产环境建议使用专业的HTTP库如libmicrohttpd或civetweb
  */
 
+#define DEFAULT_MAX_CONNECTIONS 10000
+#define DEFAULT_MAX_REQUEST_SIZE (64u * 1024 * 1024)
+#define DEFAULT_IDLE_TIMEOUT_MS 60000
+#define READ_CHUNK_SIZE 16384
+#define MAX_EVENTS 256
+#define MAX_CHUNK_LINE 1024         /* 分块大小行和尾部字段行的最大长度 */
+
+// 缓冲池规格：16KB 到 64MB 的 2 的幂，每个 reactor 最多缓存 64MB 空闲缓冲区
+#define BUFFER_POOL_MIN_SHIFT 14
+#define BUFFER_POOL_CLASSES 13
+#define BUFFER_POOL_MAX_CACHED (64u * 1024 * 1024)
+
+// 解析HTTP请求
+typedef struct {
+    char method[16];
+    char path[256];
+    char* body;                     /**< 指向连接的输入缓冲区，以 '\0' 结尾 */
+    size_t body_length;
+    bool keep_alive;                /**< 响应后是否保持连接 */
+} HttpRequest;
+
+typedef enum {
+    CONN_READING = 0,               /**< 等待请求数据 */
+    CONN_PROCESSING,                /**< 请求在工作线程中处理 */
+    CONN_WRITING                    /**< 发送响应 */
+} ConnectionState;
+
+// 分块请求体解码状态
+typedef enum {
+    CHUNK_SIZE = 0,                 /**< 等待分块大小行 */
+    CHUNK_DATA,                     /**< 读取分块数据 */
+    CHUNK_DATA_END,                 /**< 等待分块数据后的 CRLF */
+    CHUNK_TRAILER                   /**< 读取尾部字段直到空行 */
+} ChunkState;
+
+typedef struct Reactor Reactor;
+
+typedef struct Connection {
+    int fd;
+    Reactor* reactor;
+    ConnectionState state;
+    bool registered;                /**< 是否在 epoll 中 */
+    uint64_t last_active_ms;        /**< 最近一次读写进展的时间 */
+    
+    // 输入缓冲区（从 reactor 的缓冲池分配）
+    char* in;
+    size_t in_length;
+    size_t in_capacity;
+    size_t scanned;                 /**< 已查找过请求头结束标记的长度 */
+    size_t header_length;           /**< 请求头长度（0表示请求头未收完） */
+    size_t content_length;
+    bool chunked;
+    bool expect_continue;           /**< 客户端等待 100 Continue 后才发送请求体 */
+    ChunkState chunk_state;
+    size_t chunk_position;          /**< 分块请求体已解析到的输入位置 */
+    size_t chunk_remaining;         /**< 当前分块剩余的数据字节数 */
+    size_t request_length;          /**< 完整请求在输入缓冲区中占用的字节数 */
+    char saved_byte;                /**< 请求体结尾 '\0' 覆盖的字节（可能是下一个流水线请求的开头） */
+    HttpRequest request;
+    
+    // 输出缓冲区
+    char* out;
+    size_t out_length;
+    size_t out_capacity;
+    size_t out_sent;
+    
+    struct Connection* next_job;    /**< 任务队列或完成队列中的下一个 */
+    struct Connection* prev;        /**< reactor 连接链表（按最近活动时间排序） */
+    struct Connection* next;
+} Connection;
+
+// 按规格缓存的空闲缓冲区，只在所属 reactor 线程中使用
+typedef struct {
+    char* free_lists[BUFFER_POOL_CLASSES];
+    size_t cached_bytes;
+} BufferPool;
+
+struct Reactor {
+    RestServer* server;
+    int epoll_fd;
+    int listen_fd;
+    int event_fd;                   /**< 工作线程完成请求或服务器停止时唤醒 */
+    pthread_t thread;
+    bool started;
+    pthread_mutex_t done_mutex;
+    Connection* done;               /**< 已生成响应、等待发送的连接 */
+    Connection* connections;        /**< 最久未活动的连接在前 */
+    Connection* connections_tail;
+    uint32_t connection_count;
+    uint32_t max_connections;
+    BufferPool pool;
+    uint64_t now_ms;                /**< 本轮事件循环的时间 */
+    uint64_t last_sweep_ms;
+};
+
 struct RestServer {
     char* host;
     uint16_t port;
-    int server_fd;
     bool running;
-    pthread_t server_thread;
     ModelManager* model_manager;
     pthread_mutex_t mutex;
+    rest_server_config_t config;
+    
+    Reactor* reactors;
+    uint32_t reactor_count;
+    atomic_bool stopping;
+    
+    // 工作线程和任务队列
+    pthread_t* workers;
+    uint32_t worker_count;
+    pthread_mutex_t queue_mutex;
+    pthread_cond_t queue_cond;
+    Connection* queue_head;
+    Connection* queue_tail;
+    bool workers_stop;
 };
 
-// HTTP响应模板
-static const char* HTTP_200_JSON = 
+// epoll 事件中区分监听 socket 和 eventfd 的标记
+static char LISTEN_TAG;
+static char WAKE_TAG;
+
+// HTTP响应模板（Connection 头由请求决定）
+static const char* HTTP_200_JSON =
     "HTTP/1.1 200 OK\r\n"
     "Content-Type: application/json\r\n"
     "Access-Control-Allow-Origin: *\r\n"
-    "Connection: close\r\n"
+    "Connection: %s\r\n"
     "Content-Length: %zu\r\n"
     "\r\n"
     "%s";
 
-static const char* HTTP_404 = 
+static const char* HTTP_404 =
     "HTTP/1.1 404 Not Found\r\n"
     "Content-Type: text/plain\r\n"
-    "Connection: close\r\n"
+    "Connection: %s\r\n"
     "Content-Length: 13\r\n"
     "\r\n"
     "404 Not Found";
 
-static const char* HTTP_400 = 
+static const char* HTTP_400 =
     "HTTP/1.1 400 Bad Request\r\n"
     "Content-Type: text/plain\r\n"
-    "Connection: close\r\n"
+    "Connection: %s\r\n"
     "Content-Length: 15\r\n"
     "\r\n"
     "400 Bad Request";
 
-static const char* HTTP_500 = 
+static const char* HTTP_413 =
+    "HTTP/1.1 413 Payload Too Large\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: %s\r\n"
+    "Content-Length: 21\r\n"
+    "\r\n"
+    "413 Payload Too Large";
+
+static const char* HTTP_500 =
     "HTTP/1.1 500 Internal Server Error\r\n"
     "Content-Type: text/plain\r\n"
-    "Connection: close\r\n"
+    "Connection: %s\r\n"
     "Content-Length: 25\r\n"
     "\r\n"
     "500 Internal Server Error";
 
-// 解析HTTP请求
-typedef struct {
-    char method[16];
-    char path[256];
-    char body[4096];
-    size_t body_length;
-} HttpRequest;
+static const char* HTTP_501 =
+    "HTTP/1.1 501 Not Implemented\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: %s\r\n"
+    "Content-Length: 19\r\n"
+    "\r\n"
+    "501 Not Implemented";
+
+static const char HTTP_100_CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+// 取不小于 size 的缓冲区，capacity 返回实际容量
+static char* buffer_pool_get(BufferPool* pool, size_t size, size_t* capacity) {
+    size_t class_size = (size_t)1 << BUFFER_POOL_MIN_SHIFT;
+    for (int i = 0; i < BUFFER_POOL_CLASSES; i++, class_size <<= 1) {
+        if (class_size < size) continue;
+        
+        char* buffer = pool->free_lists[i];
+        if (buffer) {
+            memcpy(&pool->free_lists[i], buffer, sizeof(char*));
+            pool->cached_bytes -= class_size;
+        } else {
+            buffer = malloc(class_size);
+        }
+        if (buffer) *capacity = class_size;
+        return buffer;
+    }
+    
+    // 超过最大规格的缓冲区不缓存
+    char* buffer = malloc(size);
+    if (buffer) *capacity = size;
+    return buffer;
+}
+
+static void buffer_pool_put(BufferPool* pool, char* buffer, size_t capacity) {
+    if (!buffer) return;
+    
+    size_t class_size = (size_t)1 << BUFFER_POOL_MIN_SHIFT;
+    for (int i = 0; i < BUFFER_POOL_CLASSES; i++, class_size <<= 1) {
+        if (class_size != capacity) continue;
+        if (pool->cached_bytes + capacity > BUFFER_POOL_MAX_CACHED) break;
+        
+        // 空闲缓冲区的开头存放链表指针
+        memcpy(buffer, &pool->free_lists[i], sizeof(char*));
+        pool->free_lists[i] = buffer;
+        pool->cached_bytes += capacity;
+        return;
+    }
+    free(buffer);
+}
+
+static void buffer_pool_clear(BufferPool* pool) {
+    for (int i = 0; i < BUFFER_POOL_CLASSES; i++) {
+        while (pool->free_lists[i]) {
+            char* buffer = pool->free_lists[i];
+            memcpy(&pool->free_lists[i], buffer, sizeof(char*));
+            free(buffer);
+        }
+    }
+    pool->cached_bytes = 0;
+}
+
+// 按模板生成响应（复用连接的输出缓冲区）
+static void respond_format(Connection* conn, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    
+    conn->out_length = 0;
+    conn->out_sent = 0;
+    if (length < 0) {
+        va_end(args_copy);
+        return;
+    }
+    
+    if ((size_t)length + 1 > conn->out_capacity) {
+        char* out = realloc(conn->out, (size_t)length + 1);
+        if (!out) {
+            LOG_ERROR("分配响应缓冲区失败");
+            va_end(args_copy);
+            return;
+        }
+        conn->out = out;
+        conn->out_capacity = (size_t)length + 1;
+    }
+    
+    vsnprintf(conn->out, (size_t)length + 1, format, args_copy);
+    va_end(args_copy);
+    conn->out_length = (size_t)length;
+}
+
+static const char* connection_header(const Connection* conn) {
+    return conn->request.keep_alive ? "keep-alive" : "close";
+}
+
+// 设置固定响应
+static void respond_raw(Connection* conn, const char* response) {
+    respond_format(conn, response, connection_header(conn));
+}
 
-static int parse_http_request(const char* request_data, HttpRequest* request) {
-    if (!request_data || !request) {
+static void respond_json(Connection* conn, const char* body) {
+    respond_format(conn, HTTP_200_JSON, connection_header(conn), strlen(body), body);
+}
+
+// 解析请求行，HTTP/1.1 及以后的版本默认保持连接
+static int parse_request_line(const char* data, HttpRequest* request) {
+    char version[16] = {0};
+    if (sscanf(data, "%15s %255s %15s", request->method, request->path, version) < 2) {
         return -1;
     }
+    request->keep_alive = strncmp(version, "HTTP/1.", 7) == 0 && version[7] >= '1' && version[7] <= '9';
+    return 0;
+}
+
+// 去掉请求头取值末尾的空白
+static void trim_header_value(char* value) {
+    size_t length = strlen(value);
+    while (length > 0 && (value[length - 1] == ' ' || value[length - 1] == '\t')) {
+        value[--length] = '\0';
+    }
+}
+
+// 逗号分隔的请求头取值中是否包含指定标记（不区分大小写）
+static bool header_has_token(const char* value, const char* token) {
+    size_t token_length = strlen(token);
+    const char* p = value;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') p++;
+        const char* end = p;
+        while (*end && *end != ',') end++;
+        const char* last = end;
+        while (last > p && (last[-1] == ' ' || last[-1] == '\t')) last--;
+        if ((size_t)(last - p) == token_length && strncasecmp(p, token, token_length) == 0) {
+            return true;
+        }
+        p = end;
+    }
+    return false;
+}
+
+// 解析请求头，成功时记录请求头长度和请求体的传输方式
+static int parse_headers(Connection* conn, char* header_end, size_t max_request_size, const char** error_response) {
+    conn->header_length = (size_t)(header_end - conn->in) + 4;
+    *header_end = '\0';
     
-    // 解析请求行
-    char* line_end = strstr(request_data, "\r\n");
-    if (!line_end) {
+    memset(&conn->request, 0, sizeof(conn->request));
+    if (parse_request_line(conn->in, &conn->request) != 0) {
+        *error_response = HTTP_400;
         return -1;
     }
     
-    sscanf(request_data, "%15s %255s", request->method, request->path);
+    // 逐行解析请求头
+    bool has_content_length = false;
+    conn->content_length = 0;
+    conn->chunked = false;
+    conn->expect_continue = false;
+    char* line = strstr(conn->in, "\r\n");
+    while (line) {
+        line += 2;
+        char* line_end = strstr(line, "\r\n");
+        if (line_end) *line_end = '\0';
+        
+        char* colon = strchr(line, ':');
+        if (colon) {
+            *colon = '\0';
+            char* value = colon + 1;
+            while (*value == ' ' || *value == '\t') value++;
+            trim_header_value(value);
+            
+            if (strcasecmp(line, "Content-Length") == 0) {
+                char* end = NULL;
+                errno = 0;
+                unsigned long long length = strtoull(value, &end, 10);
+                if (errno != 0 || end == value || *end != '\0' ||
+                    (has_content_length && length != conn->content_length)) {
+                    *error_response = HTTP_400;
+                    return -1;
+                }
+                if (conn->header_length > max_request_size || length > max_request_size - conn->header_length) {
+                    *error_response = HTTP_413;
+                    return -1;
+                }
+                conn->content_length = (size_t)length;
+                has_content_length = true;
+            } else if (strcasecmp(line, "Transfer-Encoding") == 0) {
+                if (strcasecmp(value, "chunked") == 0) {
+                    conn->chunked = true;
+                } else if (strcasecmp(value, "identity") != 0) {
+                    *error_response = HTTP_501;
+                    return -1;
+                }
+            } else if (strcasecmp(line, "Connection") == 0) {
+                if (header_has_token(value, "close")) {
+                    conn->request.keep_alive = false;
+                } else if (header_has_token(value, "keep-alive")) {
+                    conn->request.keep_alive = true;
+                }
+            } else if (strcasecmp(line, "Expect") == 0 && strcasecmp(value, "100-continue") == 0) {
+                conn->expect_continue = true;
+            }
+        }
+        line = line_end;
+    }
     
-    // 查找请求体
-    char* body_start = strstr(request_data, "\r\n\r\n");
-    if (body_start) {
-        body_start += 4;  // 跳过 \r\n\r\n
-        size_t body_len = strlen(body_start);
-        if (body_len < sizeof(request->body)) {
-            strcpy(request->body, body_start);
-            request->body_length = body_len;
+    // 同时给出两种长度时无法确定请求边界，拒绝以免与上游代理对请求的划分不一致
+    if (conn->chunked && has_content_length) {
+        *error_response = HTTP_400;
+        return -1;
+    }
+    
+    if (conn->chunked) {
+        conn->chunk_state = CHUNK_SIZE;
+        conn->chunk_position = conn->header_length;
+        conn->chunk_remaining = 0;
+    } else {
+        conn->request_length = conn->header_length + conn->content_length;
+    }
+    if (conn->expect_continue && !conn->chunked && conn->content_length == 0) {
+        conn->expect_continue = false;
+    }
+    return 0;
+}
+
+/**
+ * @brief 增量解码分块请求体
+ *
+ * 数据原地前移到请求头之后，解码后的请求体长度记在 request.body_length。
+ *
+ * @return int 1请求体完整，0需要更多数据，-1出错
+ */
+static int parse_chunked_body(Connection* conn, size_t max_request_size, const char** error_response) {
+    for (;;) {
+        char* data = conn->in + conn->chunk_position;
+        size_t available = conn->in_length - conn->chunk_position;
+        
+        if (conn->chunk_state == CHUNK_DATA) {
+            size_t length = available < conn->chunk_remaining ? available : conn->chunk_remaining;
+            if (length == 0) return 0;
+            
+            memmove(conn->in + conn->header_length + conn->request.body_length, data, length);
+            conn->request.body_length += length;
+            conn->chunk_position += length;
+            conn->chunk_remaining -= length;
+            if (conn->chunk_remaining == 0) conn->chunk_state = CHUNK_DATA_END;
+            continue;
+        }
+        
+        // 其余状态按行处理
+        char* line_end = memmem(data, available, "\r\n", 2);
+        if (!line_end) {
+            if (available > MAX_CHUNK_LINE) {
+                *error_response = HTTP_400;
+                return -1;
+            }
+            return 0;
+        }
+        size_t line_length = (size_t)(line_end - data);
+        *line_end = '\0';
+        conn->chunk_position += line_length + 2;
+        if (conn->chunk_position > max_request_size) {
+            *error_response = HTTP_413;
+            return -1;
+        }
+        
+        if (conn->chunk_state == CHUNK_SIZE) {
+            // 分块大小为十六进制，其后可带扩展参数
+            char* end = NULL;
+            errno = 0;
+            unsigned long long size = strtoull(data, &end, 16);
+            if (errno != 0 || end == data || (*end != '\0' && *end != ';' && *end != ' ' && *end != '\t')) {
+                *error_response = HTTP_400;
+                return -1;
+            }
+            if (size > max_request_size - conn->chunk_position) {
+                *error_response = HTTP_413;
+                return -1;
+            }
+            conn->chunk_remaining = (size_t)size;
+            conn->chunk_state = size > 0 ? CHUNK_DATA : CHUNK_TRAILER;
+        } else if (conn->chunk_state == CHUNK_DATA_END) {
+            if (line_length != 0) {
+                *error_response = HTTP_400;
+                return -1;
+            }
+            conn->chunk_state = CHUNK_SIZE;
+        } else if (line_length == 0) {
+            // 尾部字段以空行结束，字段本身忽略
+            conn->request_length = conn->chunk_position;
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief 增量解析请求
+ *
+ * @return int 1请求完整，0需要更多数据，-1出错（error_response 为应返回的错误响应）
+ */
+static int parse_http_request(Connection* conn, size_t max_request_size, const char** error_response) {
+    if (conn->header_length == 0) {
+        // 只在新到达的数据中查找请求头结束标记
+        size_t start = conn->scanned > 3 ? conn->scanned - 3 : 0;
+        char* header_end = NULL;
+        if (conn->in_length >= start + 4) {
+            header_end = memmem(conn->in + start, conn->in_length - start, "\r\n\r\n", 4);
         }
+        conn->scanned = conn->in_length;
+        
+        if (!header_end) {
+            if (conn->in_length > max_request_size) {
+                *error_response = HTTP_413;
+                return -1;
+            }
+            return 0;
+        }
+        
+        if (parse_headers(conn, header_end, max_request_size, error_response) != 0) {
+            return -1;
+        }
+    }
+    
+    if (conn->chunked) {
+        int result = parse_chunked_body(conn, max_request_size, error_response);
+        if (result <= 0) return result;
     } else {
-        request->body[0] = '\0';
-        request->body_length = 0;
+        if (conn->in_length < conn->request_length) return 0;
+        conn->request.body_length = conn->content_length;
     }
     
-    return 0;
+    // 请求体以 '\0' 结尾，处理函数按字符串使用（缓冲区始终多留一个字节）；
+    // 被覆盖的字节可能属于下一个流水线请求，处理完后恢复
+    size_t body_end = conn->header_length + conn->request.body_length;
+    conn->request.body = conn->in + conn->header_length;
+    if (body_end < conn->in_length) conn->saved_byte = conn->in[body_end];
+    conn->in[body_end] = '\0';
+    conn->expect_continue = false;
+    return 1;
 }
 
 // API处理函数
-static void handle_health_check(int client_fd) {
+static void handle_health_check(Connection* conn) {
     const char* response_body = "{\"status\":\"healthy\",\"service\":\"modyn\"}";
-    char response[1024];
-    
-    snprintf(response, sizeof(response), HTTP_200_JSON, strlen(response_body), response_body);
-    send(client_fd, response, strlen(response), 0);
+    respond_json(conn, response_body);
     
     LOG_DEBUG("处理健康检查请求");
 }
 
-static void handle_models_list(int client_fd, ModelManager* manager) {
+static void handle_models_list(Connection* conn, ModelManager* manager) {
     if (!manager) {
-        send(client_fd, HTTP_500, strlen(HTTP_500), 0);
+        respond_raw(conn, HTTP_500);
         return;
     }
     
     // 简化实现：返回固定的模型列表
-    const char* response_body = 
+    const char* response_body =
         "{"
         "\"models\":["
         "{\"id\":\"dummy_model\",\"status\":\"loaded\",\"backend\":\"dummy\"},"
@@ -125,16 +570,14 @@ static void handle_models_list(int client_fd, ModelManager* manager) {
         "\"count\":2"
         "}";
     
-    char response[2048];
-    snprintf(response, sizeof(response), HTTP_200_JSON, strlen(response_body), response_body);
-    send(client_fd, response, strlen(response), 0);
+    respond_json(conn, response_body);
     
     LOG_DEBUG("处理模型列表请求");
 }
 
-static void handle_model_load(int client_fd, ModelManager* manager, const char* body) {
+static void handle_model_load(Connection* conn, ModelManager* manager, const char* body) {
     if (!manager || !body) {
-        send(client_fd, HTTP_400, strlen(HTTP_400), 0);
+        respond_raw(conn, HTTP_400);
         return;
     }
     
@@ -143,8 +586,8 @@ static void handle_model_load(int client_fd, ModelManager* manager, const char*
     char model_id[256] = {0};
     
     // 查找model_path和model_id
-    char* path_start = strstr(body, "\"model_path\":");
-    char* id_start = strstr(body, "\"model_id\":");
+    const char* path_start = strstr(body, "\"model_path\":");
+    const char* id_start = strstr(body, "\"model_id\":");
     
     if (path_start && id_start) {
         sscanf(path_start, "\"model_path\":\"%255[^\"]\"", model_path);
@@ -162,44 +605,37 @@ static void handle_model_load(int client_fd, ModelManager* manager, const char*
         if (model) {
             char response_body[512];
             snprintf(response_body, sizeof(response_body),
-                    "{\"status\":\"success\",\"message\":\"Model loaded\",\"model_id\":\"%s\"}", 
+                    "{\"status\":\"success\",\"message\":\"Model loaded\",\"model_id\":\"%s\"}",
                     model_id);
-            
-            char response[1024];
-            snprintf(response, sizeof(response), HTTP_200_JSON, strlen(response_body), response_body);
-            send(client_fd, response, strlen(response), 0);
+            respond_json(conn, response_body);
             
             LOG_INFO("通过API加载模型成功: %s", model_id);
         } else {
             const char* error_body = "{\"status\":\"error\",\"message\":\"Failed to load model\"}";
-            char response[1024];
-            snprintf(response, sizeof(response), HTTP_200_JSON, strlen(error_body), error_body);
-            send(client_fd, response, strlen(response), 0);
+            respond_json(conn, error_body);
             
             LOG_ERROR("通过API加载模型失败: %s", model_id);
         }
     } else {
-        send(client_fd, HTTP_400, strlen(HTTP_400), 0);
+        respond_raw(conn, HTTP_400);
     }
 }
 
-static void handle_model_infer(int client_fd, ModelManager* manager, const char* model_id, const char* body) {
+static void handle_model_infer(Connection* conn, ModelManager* manager, const char* model_id, const char* body) {
     if (!manager || !model_id || !body) {
-        send(client_fd, HTTP_400, strlen(HTTP_400), 0);
+        respond_raw(conn, HTTP_400);
         return;
     }
     
     ModelHandle model = model_manager_get(manager, model_id);
     if (!model) {
         const char* error_body = "{\"status\":\"error\",\"message\":\"Model not found\"}";
-        char response[1024];
-        snprintf(response, sizeof(response), HTTP_200_JSON, strlen(error_body), error_body);
-        send(client_fd, response, strlen(response), 0);
+        respond_json(conn, error_body);
         return;
     }
     
     // 简化实现：返回虚拟推理结果
-    const char* response_body = 
+    const char* response_body =
         "{"
         "\"status\":\"success\","
         "\"model_id\":\"%s\","
@@ -212,10 +648,7 @@ static void handle_model_infer(int client_fd, ModelManager* manager, const char*
     
     char full_response_body[1024];
     snprintf(full_response_body, sizeof(full_response_body), response_body, model_id);
-    
-    char response[2048];
-    snprintf(response, sizeof(response), HTTP_200_JSON, strlen(full_response_body), full_response_body);
-    send(client_fd, response, strlen(response), 0);
+    respond_json(conn, full_response_body);
     
     // 释放模型句柄
     model_manager_unload(manager, model);
@@ -223,91 +656,566 @@ static void handle_model_infer(int client_fd, ModelManager* manager, const char*
     LOG_DEBUG("处理推理请求: %s", model_id);
 }
 
-// 处理客户端连接
-static void handle_client(int client_fd, RestServer* server) {
-    char buffer[8192];
-    ssize_t bytes_read = recv(client_fd, buffer, sizeof(buffer) - 1, 0);
+// 路由处理（在工作线程中执行）
+static void handle_request(Connection* conn, RestServer* server) {
+    HttpRequest* request = &conn->request;
     
-    if (bytes_read <= 0) {
-        close(client_fd);
-        return;
-    }
-    
-    buffer[bytes_read] = '\0';
+    LOG_DEBUG("收到请求: %s %s", request->method, request->path);
     
-    HttpRequest request;
-    if (parse_http_request(buffer, &request) != 0) {
-        send(client_fd, HTTP_400, strlen(HTTP_400), 0);
-        close(client_fd);
-        return;
-    }
-    
-    LOG_DEBUG("收到请求: %s %s", request.method, request.path);
-    
-    // 路由处理
-    if (strcmp(request.method, "GET") == 0) {
-        if (strcmp(request.path, "/health") == 0) {
-            handle_health_check(client_fd);
-        } else if (strcmp(request.path, "/models") == 0) {
-            handle_models_list(client_fd, server->model_manager);
+    if (strcmp(request->method, "GET") == 0) {
+        if (strcmp(request->path, "/health") == 0) {
+            handle_health_check(conn);
+        } else if (strcmp(request->path, "/models") == 0) {
+            handle_models_list(conn, server->model_manager);
         } else {
-            send(client_fd, HTTP_404, strlen(HTTP_404), 0);
+            respond_raw(conn, HTTP_404);
         }
-    } else if (strcmp(request.method, "POST") == 0) {
-        if (strcmp(request.path, "/models") == 0) {
-            handle_model_load(client_fd, server->model_manager, request.body);
-        } else if (strncmp(request.path, "/models/", 8) == 0) {
-            char* model_id = request.path + 8;
+    } else if (strcmp(request->method, "POST") == 0) {
+        if (strcmp(request->path, "/models") == 0) {
+            handle_model_load(conn, server->model_manager, request->body);
+        } else if (strncmp(request->path, "/models/", 8) == 0) {
+            char* model_id = request->path + 8;
             char* infer_pos = strstr(model_id, "/infer");
             if (infer_pos) {
                 *infer_pos = '\0';  // 截断获取model_id
-                handle_model_infer(client_fd, server->model_manager, model_id, request.body);
+                handle_model_infer(conn, server->model_manager, model_id, request->body);
             } else {
-                send(client_fd, HTTP_404, strlen(HTTP_404), 0);
+                respond_raw(conn, HTTP_404);
             }
         } else {
-            send(client_fd, HTTP_404, strlen(HTTP_404), 0);
+            respond_raw(conn, HTTP_404);
         }
     } else {
-        send(client_fd, HTTP_400, strlen(HTTP_400), 0);
+        respond_raw(conn, HTTP_400);
     }
-    
-    close(client_fd);
 }
 
-// 服务器线程函数
-static void* server_thread_func(void* arg) {
+// 工作线程：从任务队列取出请求，生成响应后交回 reactor
+static void* worker_thread_func(void* arg) {
     RestServer* server = (RestServer*)arg;
     
-    LOG_INFO("REST API服务器开始监听 %s:%d", server->host, server->port);
+    for (;;) {
+        pthread_mutex_lock(&server->queue_mutex);
+        while (!server->queue_head && !server->workers_stop) {
+            pthread_cond_wait(&server->queue_cond, &server->queue_mutex);
+        }
+        if (server->workers_stop) {
+            pthread_mutex_unlock(&server->queue_mutex);
+            break;
+        }
+        
+        Connection* conn = server->queue_head;
+        server->queue_head = conn->next_job;
+        if (!server->queue_head) server->queue_tail = NULL;
+        pthread_mutex_unlock(&server->queue_mutex);
+        
+        handle_request(conn, server);
+        
+        Reactor* reactor = conn->reactor;
+        pthread_mutex_lock(&reactor->done_mutex);
+        conn->next_job = reactor->done;
+        reactor->done = conn;
+        pthread_mutex_unlock(&reactor->done_mutex);
+        
+        uint64_t one = 1;
+        if (write(reactor->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            LOG_WARN("唤醒reactor失败");
+        }
+    }
+    
+    return NULL;
+}
+
+static void unlink_connection(Connection* conn) {
+    Reactor* reactor = conn->reactor;
+    if (conn->prev) conn->prev->next = conn->next;
+    else reactor->connections = conn->next;
+    if (conn->next) conn->next->prev = conn->prev;
+    else reactor->connections_tail = conn->prev;
+    conn->prev = NULL;
+    conn->next = NULL;
+}
+
+static void append_connection(Connection* conn) {
+    Reactor* reactor = conn->reactor;
+    conn->prev = reactor->connections_tail;
+    if (reactor->connections_tail) reactor->connections_tail->next = conn;
+    else reactor->connections = conn;
+    reactor->connections_tail = conn;
+}
+
+// 记录读写进展：移到链表末尾，使链表保持按最近活动时间排序
+static void touch_connection(Connection* conn) {
+    conn->last_active_ms = conn->reactor->now_ms;
+    if (conn != conn->reactor->connections_tail) {
+        unlink_connection(conn);
+        append_connection(conn);
+    }
+}
+
+static void close_connection(Connection* conn) {
+    Reactor* reactor = conn->reactor;
+    
+    // 关闭 fd 会自动从 epoll 中移除
+    close(conn->fd);
+    
+    unlink_connection(conn);
+    reactor->connection_count--;
+    
+    buffer_pool_put(&reactor->pool, conn->in, conn->in_capacity);
+    free(conn->out);
+    free(conn);
+}
+
+// 注册或修改连接关注的事件，失败时关闭连接
+static int watch_connection(Connection* conn, uint32_t events) {
+    struct epoll_event event = { .events = events, .data.ptr = conn };
+    int op = conn->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(conn->reactor->epoll_fd, op, conn->fd, &event) != 0) {
+        LOG_ERROR("注册连接事件失败: %s", strerror(errno));
+        close_connection(conn);
+        return -1;
+    }
+    conn->registered = true;
+    return 0;
+}
+
+static void unwatch_connection(Connection* conn) {
+    if (conn->registered) {
+        epoll_ctl(conn->reactor->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+        conn->registered = false;
+    }
+}
+
+// 保证输入缓冲区容量不小于 size，扩容时换用缓冲池中更大规格的缓冲区
+static int reserve_input(Connection* conn, size_t size) {
+    if (conn->in_capacity >= size) return 0;
+    
+    BufferPool* pool = &conn->reactor->pool;
+    size_t capacity = 0;
+    char* in = buffer_pool_get(pool, size, &capacity);
+    if (!in) {
+        LOG_ERROR("分配请求缓冲区失败");
+        return -1;
+    }
+    if (conn->in_length > 0) {
+        memcpy(in, conn->in, conn->in_length);
+    }
+    buffer_pool_put(pool, conn->in, conn->in_capacity);
+    conn->in = in;
+    conn->in_capacity = capacity;
+    return 0;
+}
+
+static void dispatch_request(Connection* conn) {
+    RestServer* server = conn->reactor->server;
+    
+    // 处理期间不再关注该连接的事件
+    unwatch_connection(conn);
+    conn->state = CONN_PROCESSING;
+    conn->next_job = NULL;
     
-    while (server->running) {
-        struct sockaddr_in client_addr;
-        socklen_t client_len = sizeof(client_addr);
+    pthread_mutex_lock(&server->queue_mutex);
+    if (server->queue_tail) server->queue_tail->next_job = conn;
+    else server->queue_head = conn;
+    server->queue_tail = conn;
+    pthread_cond_signal(&server->queue_cond);
+    pthread_mutex_unlock(&server->queue_mutex);
+}
+
+static void fail_request(Connection* conn, const char* response);
+
+// 解析缓冲区中的数据，请求完整时交给工作线程；返回 false 表示连接已交出或关闭
+static bool process_input(Connection* conn) {
+    const char* error_response = NULL;
+    int parsed = parse_http_request(conn, conn->reactor->server->config.max_request_size, &error_response);
+    if (parsed < 0) {
+        fail_request(conn, error_response);
+        return false;
+    }
+    if (parsed > 0) {
+        dispatch_request(conn);
+        return false;
+    }
+    
+    // 请求头已收完但请求体还没开始发送时，告知客户端继续
+    if (conn->expect_continue && conn->in_length == conn->header_length) {
+        conn->expect_continue = false;
+        if (send(conn->fd, HTTP_100_CONTINUE, sizeof(HTTP_100_CONTINUE) - 1, MSG_NOSIGNAL) < 0 &&
+            errno != EAGAIN && errno != EWOULDBLOCK) {
+            close_connection(conn);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 响应发送完毕：保持连接时丢弃已处理的请求，继续处理缓冲区中流水线的下一个请求
+static void finish_response(Connection* conn) {
+    if (!conn->request.keep_alive) {
+        close_connection(conn);
+        return;
+    }
+    
+    size_t body_end = conn->header_length + conn->request.body_length;
+    if (body_end < conn->in_length) {
+        conn->in[body_end] = conn->saved_byte;
+    }
+    
+    size_t leftover = conn->in_length - conn->request_length;
+    if (leftover > 0) {
+        memmove(conn->in, conn->in + conn->request_length, leftover);
+    } else {
+        // 空闲连接不占用输入缓冲区
+        buffer_pool_put(&conn->reactor->pool, conn->in, conn->in_capacity);
+        conn->in = NULL;
+        conn->in_capacity = 0;
+    }
+    
+    conn->in_length = leftover;
+    conn->scanned = 0;
+    conn->header_length = 0;
+    conn->content_length = 0;
+    conn->chunked = false;
+    conn->request_length = 0;
+    memset(&conn->request, 0, sizeof(conn->request));
+    conn->out_length = 0;
+    conn->out_sent = 0;
+    conn->state = CONN_READING;
+    touch_connection(conn);
+    
+    if (leftover > 0 && !process_input(conn)) {
+        return;
+    }
+    watch_connection(conn, EPOLLIN | EPOLLRDHUP);
+}
+
+// 发送响应，全部发完后结束本次请求；返回 false 表示连接已关闭或转入下一个请求
+static bool flush_output(Connection* conn) {
+    size_t sent_before = conn->out_sent;
+    while (conn->out_sent < conn->out_length) {
+        ssize_t sent = send(conn->fd, conn->out + conn->out_sent, conn->out_length - conn->out_sent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn->out_sent += (size_t)sent;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // 等待可写
+            if (conn->out_sent > sent_before) {
+                touch_connection(conn);
+            }
+            if (!conn->registered && watch_connection(conn, EPOLLOUT) != 0) {
+                return false;
+            }
+            return true;
+        }
+        close_connection(conn);
+        return false;
+    }
+    
+    finish_response(conn);
+    return false;
+}
+
+// 请求无法解析时返回错误并关闭连接（无法确定下一个请求从哪里开始）
+static void fail_request(Connection* conn, const char* response) {
+    unwatch_connection(conn);
+    conn->state = CONN_WRITING;
+    conn->request.keep_alive = false;
+    respond_raw(conn, response);
+    if (conn->out_length == 0) {
+        close_connection(conn);
+        return;
+    }
+    flush_output(conn);
+}
+
+// 读取可用数据并尝试解析出完整请求
+static void handle_readable(Connection* conn) {
+    for (;;) {
+        // 空闲空间含请求体结尾 '\0' 的一个字节；已知请求体长度时只需容纳剩余部分
+        size_t wanted = READ_CHUNK_SIZE;
+        if (conn->header_length > 0 && !conn->chunked && conn->request_length > conn->in_length &&
+            conn->request_length - conn->in_length < wanted) {
+            wanted = conn->request_length - conn->in_length + 1;
+        }
+        if (conn->in_capacity - conn->in_length < wanted) {
+            // 按当前长度成倍扩容，大请求体的复制总量不超过其长度
+            size_t grow = conn->in_length > wanted ? conn->in_length : wanted;
+            if (reserve_input(conn, conn->in_length + grow) != 0) {
+                close_connection(conn);
+                return;
+            }
+        }
+        
+        ssize_t received = recv(conn->fd, conn->in + conn->in_length, conn->in_capacity - conn->in_length - 1, 0);
+        if (received > 0) {
+            conn->in_length += (size_t)received;
+            touch_connection(conn);
+            if (!process_input(conn)) {
+                return;
+            }
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // 空闲的保持连接不占用输入缓冲区
+            if (conn->in_length == 0 && conn->in) {
+                buffer_pool_put(&conn->reactor->pool, conn->in, conn->in_capacity);
+                conn->in = NULL;
+                conn->in_capacity = 0;
+            }
+            return;
+        }
         
-        int client_fd = accept(server->server_fd, (struct sockaddr*)&client_addr, &client_len);
-        if (client_fd < 0) {
-            if (server->running) {
-                LOG_ERROR("接受连接失败");
+        // 对端关闭或出错
+        close_connection(conn);
+        return;
+    }
+}
+
+static void accept_connections(Reactor* reactor) {
+    for (;;) {
+        int fd = accept4(reactor->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("接受连接失败: %s", strerror(errno));
             }
+            return;
+        }
+        
+        if (reactor->connection_count >= reactor->max_connections) {
+            LOG_WARN("连接数达到上限 %u，拒绝新连接", reactor->max_connections);
+            close(fd);
+            continue;
+        }
+        
+        int opt = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+        
+        Connection* conn = calloc(1, sizeof(Connection));
+        if (!conn) {
+            LOG_ERROR("分配连接失败");
+            close(fd);
             continue;
         }
+        conn->fd = fd;
+        conn->reactor = reactor;
+        conn->state = CONN_READING;
+        conn->last_active_ms = reactor->now_ms;
+        append_connection(conn);
+        reactor->connection_count++;
+        
+        watch_connection(conn, EPOLLIN | EPOLLRDHUP);
+    }
+}
+
+// 发送工作线程已完成的响应
+static void drain_completions(Reactor* reactor) {
+    uint64_t value;
+    while (read(reactor->event_fd, &value, sizeof(value)) > 0) {
+    }
+    
+    pthread_mutex_lock(&reactor->done_mutex);
+    Connection* conn = reactor->done;
+    reactor->done = NULL;
+    pthread_mutex_unlock(&reactor->done_mutex);
+    
+    while (conn) {
+        Connection* next = conn->next_job;
+        conn->state = CONN_WRITING;
+        touch_connection(conn);
+        if (conn->out_length == 0) {
+            conn->request.keep_alive = false;
+            respond_raw(conn, HTTP_500);
+        }
+        if (conn->out_length > 0) {
+            flush_output(conn);
+        } else {
+            close_connection(conn);
+        }
+        conn = next;
+    }
+}
+
+// 关闭读取或发送停滞超过空闲超时的连接（处理中的请求不计）
+static void close_idle_connections(Reactor* reactor) {
+    uint64_t timeout = reactor->server->config.idle_timeout_ms;
+    reactor->last_sweep_ms = reactor->now_ms;
+    
+    Connection* conn = reactor->connections;
+    while (conn && conn->last_active_ms + timeout <= reactor->now_ms) {
+        Connection* next = conn->next;
+        if (conn->state != CONN_PROCESSING) {
+            close_connection(conn);
+        }
+        conn = next;
+    }
+}
+
+// reactor 线程：非阻塞 I/O 事件循环
+static void* reactor_thread_func(void* arg) {
+    Reactor* reactor = (Reactor*)arg;
+    struct epoll_event events[MAX_EVENTS];
+    uint32_t idle_timeout = reactor->server->config.idle_timeout_ms;
+    int sweep_interval = idle_timeout < 1000 ? (int)idle_timeout : 1000;
+    
+    reactor->now_ms = monotonic_ms();
+    reactor->last_sweep_ms = reactor->now_ms;
+    while (!atomic_load(&reactor->server->stopping)) {
+        int count = epoll_wait(reactor->epoll_fd, events, MAX_EVENTS, reactor->connections ? sweep_interval : -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("epoll_wait失败: %s", strerror(errno));
+            break;
+        }
+        reactor->now_ms = monotonic_ms();
+        
+        for (int i = 0; i < count; i++) {
+            void* ptr = events[i].data.ptr;
+            if (ptr == &LISTEN_TAG) {
+                accept_connections(reactor);
+            } else if (ptr == &WAKE_TAG) {
+                drain_completions(reactor);
+            } else {
+                Connection* conn = (Connection*)ptr;
+                if (conn->state == CONN_READING) {
+                    handle_readable(conn);
+                } else if (conn->state == CONN_WRITING) {
+                    if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                        close_connection(conn);
+                    } else {
+                        flush_output(conn);
+                    }
+                }
+            }
+        }
         
-        // 简化实现：同步处理（生产环境应使用线程池）
-        handle_client(client_fd, server);
+        if (reactor->now_ms - reactor->last_sweep_ms >= (uint64_t)sweep_interval) {
+            close_idle_connections(reactor);
+        }
     }
     
-    LOG_INFO("REST API服务器线程退出");
+    LOG_DEBUG("REST API reactor线程退出");
     return NULL;
 }
 
+static int create_listen_socket(RestServer* server, bool reuse_port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("创建socket失败");
+        return -1;
+    }
+    
+    // 设置socket选项
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        LOG_WARN("设置SO_REUSEADDR失败");
+    }
+    if (reuse_port && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        LOG_ERROR("设置SO_REUSEPORT失败");
+        close(fd);
+        return -1;
+    }
+    
+    // 绑定地址
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(server->port);
+    if (inet_pton(AF_INET, server->host, &addr.sin_addr) != 1) {
+        addr.sin_addr.s_addr = INADDR_ANY;
+    }
+    
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        LOG_ERROR("绑定地址失败: %s:%d", server->host, server->port);
+        close(fd);
+        return -1;
+    }
+    
+    // 开始监听
+    if (listen(fd, SOMAXCONN) < 0) {
+        LOG_ERROR("开始监听失败");
+        close(fd);
+        return -1;
+    }
+    
+    // 端口为0时记下系统分配的端口，其余 reactor 绑定同一端口
+    if (server->port == 0) {
+        socklen_t length = sizeof(addr);
+        if (getsockname(fd, (struct sockaddr*)&addr, &length) == 0) {
+            server->port = ntohs(addr.sin_port);
+        }
+    }
+    
+    return fd;
+}
+
+static int reactor_init(Reactor* reactor, RestServer* server, uint32_t max_connections) {
+    reactor->max_connections = max_connections;
+    reactor->listen_fd = -1;
+    reactor->event_fd = -1;
+    reactor->epoll_fd = -1;
+    if (pthread_mutex_init(&reactor->done_mutex, NULL) != 0) {
+        return -1;
+    }
+    reactor->server = server;
+    
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor->epoll_fd < 0) {
+        LOG_ERROR("创建epoll失败");
+        return -1;
+    }
+    
+    reactor->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    reactor->listen_fd = create_listen_socket(server, server->reactor_count > 1);
+    if (reactor->event_fd < 0 || reactor->listen_fd < 0) {
+        return -1;
+    }
+    
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = &LISTEN_TAG };
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->listen_fd, &event) != 0) {
+        LOG_ERROR("注册监听socket失败");
+        return -1;
+    }
+    event.data.ptr = &WAKE_TAG;
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->event_fd, &event) != 0) {
+        LOG_ERROR("注册eventfd失败");
+        return -1;
+    }
+    return 0;
+}
+
+// 关闭 reactor 的所有连接和描述符（工作线程已退出后调用）
+static void reactor_cleanup(Reactor* reactor) {
+    if (!reactor->server) return;
+    
+    while (reactor->connections) {
+        close_connection(reactor->connections);
+    }
+    
+    if (reactor->listen_fd >= 0) close(reactor->listen_fd);
+    if (reactor->event_fd >= 0) close(reactor->event_fd);
+    if (reactor->epoll_fd >= 0) close(reactor->epoll_fd);
+    buffer_pool_clear(&reactor->pool);
+    pthread_mutex_destroy(&reactor->done_mutex);
+    memset(reactor, 0, sizeof(*reactor));
+}
+
 RestServer* rest_server_create(const char* host, uint16_t port, ModelManager* model_manager) {
+    return rest_server_create_with_config(host, port, model_manager, NULL);
+}
+
+RestServer* rest_server_create_with_config(const char* host, uint16_t port, ModelManager* model_manager,
+                                           const rest_server_config_t* config) {
     if (!host || !model_manager) {
         LOG_ERROR("REST服务器创建参数无效");
         return NULL;
     }
     
-    RestServer* server = malloc(sizeof(RestServer));
+    RestServer* server = calloc(1, sizeof(RestServer));
     if (!server) {
         LOG_ERROR("REST服务器内存分配失败");
         return NULL;
@@ -318,6 +1226,18 @@ RestServer* rest_server_create(const char* host, uint16_t port, ModelManager* mo
     server->running = false;
     server->model_manager = model_manager;
     
+    if (config) {
+        server->config = *config;
+    }
+    if (server->config.reactors == 0) server->config.reactors = 1;
+    if (server->config.workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        server->config.workers = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (server->config.max_connections == 0) server->config.max_connections = DEFAULT_MAX_CONNECTIONS;
+    if (server->config.max_request_size == 0) server->config.max_request_size = DEFAULT_MAX_REQUEST_SIZE;
+    if (server->config.idle_timeout_ms == 0) server->config.idle_timeout_ms = DEFAULT_IDLE_TIMEOUT_MS;
+    
     if (pthread_mutex_init(&server->mutex, NULL) != 0) {
         LOG_ERROR("REST服务器互斥锁初始化失败");
         free(server->host);
@@ -343,53 +1263,99 @@ void rest_server_destroy(RestServer* server) {
     LOG_INFO("REST API服务器销毁完成");
 }
 
-int rest_server_start(RestServer* server) {
-    if (!server || server->running) {
-        return -1;
+// 停止并回收已启动的线程和资源（启动失败时也用于清理）
+static void shutdown_threads(RestServer* server) {
+    // 先停工作线程：之后不会再有连接被交回 reactor
+    pthread_mutex_lock(&server->queue_mutex);
+    server->workers_stop = true;
+    pthread_cond_broadcast(&server->queue_cond);
+    pthread_mutex_unlock(&server->queue_mutex);
+    
+    for (uint32_t i = 0; i < server->worker_count; i++) {
+        pthread_join(server->workers[i], NULL);
     }
     
-    // 创建socket
-    server->server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server->server_fd < 0) {
-        LOG_ERROR("创建socket失败");
-        return -1;
+    atomic_store(&server->stopping, true);
+    for (uint32_t i = 0; i < server->reactor_count; i++) {
+        Reactor* reactor = &server->reactors[i];
+        if (reactor->started) {
+            uint64_t one = 1;
+            if (write(reactor->event_fd, &one, sizeof(one)) < 0) {
+                LOG_WARN("唤醒reactor失败");
+            }
+            pthread_join(reactor->thread, NULL);
+        }
     }
     
-    // 设置socket选项
-    int opt = 1;
-    if (setsockopt(server->server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        LOG_WARN("设置SO_REUSEADDR失败");
+    // 队列中的连接仍在各 reactor 的连接链表中，随 reactor 一起释放
+    for (uint32_t i = 0; i < server->reactor_count; i++) {
+        reactor_cleanup(&server->reactors[i]);
     }
     
-    // 绑定地址
-    struct sockaddr_in addr;
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
-    addr.sin_port = htons(server->port);
+    free(server->reactors);
+    free(server->workers);
+    server->reactors = NULL;
+    server->workers = NULL;
+    server->reactor_count = 0;
+    server->worker_count = 0;
+    server->queue_head = NULL;
+    server->queue_tail = NULL;
     
-    if (bind(server->server_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        LOG_ERROR("绑定地址失败: %s:%d", server->host, server->port);
-        close(server->server_fd);
+    pthread_cond_destroy(&server->queue_cond);
+    pthread_mutex_destroy(&server->queue_mutex);
+}
+
+int rest_server_start(RestServer* server) {
+    if (!server || server->running) {
         return -1;
     }
     
-    // 开始监听
-    if (listen(server->server_fd, 10) < 0) {
-        LOG_ERROR("开始监听失败");
-        close(server->server_fd);
+    uint32_t reactor_count = server->config.reactors;
+    uint32_t worker_count = server->config.workers;
+    
+    server->reactors = calloc(reactor_count, sizeof(Reactor));
+    server->workers = calloc(worker_count, sizeof(pthread_t));
+    if (!server->reactors || !server->workers) {
+        LOG_ERROR("REST服务器内存分配失败");
+        free(server->reactors);
+        free(server->workers);
+        server->reactors = NULL;
+        server->workers = NULL;
         return -1;
     }
     
-    // 启动服务器线程
-    server->running = true;
-    if (pthread_create(&server->server_thread, NULL, server_thread_func, server) != 0) {
-        LOG_ERROR("创建服务器线程失败");
-        server->running = false;
-        close(server->server_fd);
+    pthread_mutex_init(&server->queue_mutex, NULL);
+    pthread_cond_init(&server->queue_cond, NULL);
+    server->workers_stop = false;
+    atomic_store(&server->stopping, false);
+    server->reactor_count = reactor_count;
+    
+    uint32_t per_reactor = (server->config.max_connections + reactor_count - 1) / reactor_count;
+    bool ok = true;
+    for (uint32_t i = 0; i < reactor_count && ok; i++) {
+        ok = reactor_init(&server->reactors[i], server, per_reactor) == 0;
+    }
+    
+    // 启动工作线程和 reactor 线程
+    for (uint32_t i = 0; i < worker_count && ok; i++) {
+        ok = pthread_create(&server->workers[i], NULL, worker_thread_func, server) == 0;
+        if (ok) server->worker_count++;
+    }
+    for (uint32_t i = 0; i < reactor_count && ok; i++) {
+        Reactor* reactor = &server->reactors[i];
+        ok = pthread_create(&reactor->thread, NULL, reactor_thread_func, reactor) == 0;
+        reactor->started = ok;
+    }
+    
+    if (!ok) {
+        LOG_ERROR("启动REST服务器线程失败");
+        shutdown_threads(server);
         return -1;
     }
     
-    LOG_INFO("REST API服务器启动成功: http://%s:%d", server->host, server->port);
+    server->running = true;
+    LOG_INFO("REST API服务器启动成功: http://%s:%d（%u 个reactor，%u 个工作线程）",
+             server->host, server->port, reactor_count, worker_count);
     return 0;
 }
 
@@ -399,15 +1365,7 @@ int rest_server_stop(RestServer* server) {
     }
     
     server->running = false;
-    
-    // 关闭服务器socket
-    if (server->server_fd >= 0) {
-        close(server->server_fd);
-        server->server_fd = -1;
-    }
-    
-    // 等待服务器线程结束
-    pthread_join(server->server_thread, NULL);
+    shutdown_threads(server);
     
     LOG_INFO("REST API服务器停止");
     return 0;
@@ -415,4 +1373,8 @@ int rest_server_stop(RestServer* server) {
 
 bool rest_server_is_running(RestServer* server) {
     return server ? server->running : false;
-} 
\ No newline at end of file
+}
+
+uint16_t rest_server_get_port(RestServer* server) {
+    return server ? server->port : 0;
+}
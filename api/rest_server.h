@@ -14,16 +14,44 @@ extern "C" {
  */
 typedef struct RestServer RestServer;
 
+/**
+ * @brief REST API 服务器配置
+ * 
+ * 网络 I/O 由 reactor 线程以非阻塞 epoll 方式处理，请求解析完成后交给工作线程执行，
+ * 慢客户端和耗时的推理都不会阻塞其他连接。多个 reactor 时每个 reactor 使用独立的
+ * SO_REUSEPORT 监听 socket，由内核分配新连接。连接默认保持（keep-alive），支持请求流水线
+ * 和分块传输的请求体。
+ */
+typedef struct {
+    uint32_t reactors;              /**< reactor 线程数（0表示1） */
+    uint32_t workers;               /**< 工作线程数（0表示在线 CPU 数） */
+    uint32_t max_connections;       /**< 最大并发连接数（0表示10000），超出时新连接被直接关闭 */
+    size_t max_request_size;        /**< 单个请求（请求头加请求体）最大字节数（0表示64MB） */
+    uint32_t idle_timeout_ms;       /**< 连接空闲超时（毫秒，0表示60秒），读取请求或发送响应时超过该时间没有进展则关闭 */
+} rest_server_config_t;
+
 /**
  * @brief 创建REST API服务器
  * 
  * @param host 绑定的主机地址
- * @param port 监听端口
+ * @param port 监听端口（0表示由系统分配，启动后用 rest_server_get_port 查询）
  * @param model_manager 模型管理器
  * @return RestServer* 服务器指针，失败返回NULL
  */
 RestServer* rest_server_create(const char* host, uint16_t port, ModelManager* model_manager);
 
+/**
+ * @brief 按配置创建REST API服务器
+ * 
+ * @param host 绑定的主机地址
+ * @param port 监听端口（0表示由系统分配）
+ * @param model_manager 模型管理器
+ * @param config 服务器配置（NULL使用默认值）
+ * @return RestServer* 服务器指针，失败返回NULL
+ */
+RestServer* rest_server_create_with_config(const char* host, uint16_t port, ModelManager* model_manager,
+                                           const rest_server_config_t* config);
+
 /**
  * @brief 销毁REST API服务器
  * 
@@ -55,6 +83,14 @@ int rest_server_stop(RestServer* server);
  */
 bool rest_server_is_running(RestServer* server);
 
+/**
+ * @brief 获取监听端口
+ * 
+ * @param server 服务器指针
+ * @return uint16_t 监听端口（端口为0时返回系统分配的端口）
+ */
+uint16_t rest_server_get_port(RestServer* server);
+
 #ifdef __cplusplus
 }
 #endif
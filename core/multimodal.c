@@ -59,12 +59,19 @@ ModalityData* modality_data_create(ModalityType modality, DataFormat format,
     return modal_data;
 }
 
+// 释放模态拥有的数据和字符串（借用外部缓冲区的视图不释放）
+static void modality_data_release(ModalityData* modal) {
+    if (modal->borrowed) return;
+    
+    free(modal->data);
+    free(modal->metadata);
+    free(modal->source_id);
+}
+
 void modality_data_destroy(ModalityData* modal_data) {
     if (!modal_data) return;
     
-    free(modal_data->data);
-    free(modal_data->metadata);
-    free(modal_data->source_id);
+    modality_data_release(modal_data);
     free(modal_data);
 }
 
@@ -91,6 +98,113 @@ ModalityData* modality_data_copy(const ModalityData* src) {
     return copy;
 }
 
+#define ARENA_ALIGNMENT 64
+
+static size_t align_size(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// FNV-1a
+static uint32_t hash_source_id(const char* source_id) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)source_id; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+// 记录新追加模态的索引（同一模态或数据源只索引第一个）
+static void index_insert(MultiModalData* multi_data, uint32_t index) {
+    const ModalityData* modal = &multi_data->modalities[index];
+    
+    if ((uint32_t)modal->modality <= MODALITY_CUSTOM && multi_data->modality_index[modal->modality] == 0) {
+        multi_data->modality_index[modal->modality] = index + 1;
+    }
+    
+    if (multi_data->source_table && modal->source_id) {
+        uint32_t mask = multi_data->source_table_size - 1;
+        for (uint32_t slot = hash_source_id(modal->source_id) & mask;; slot = (slot + 1) & mask) {
+            uint32_t entry = multi_data->source_table[slot];
+            if (entry == 0) {
+                multi_data->source_table[slot] = index + 1;
+                break;
+            }
+            if (strcmp(multi_data->modalities[entry - 1].source_id, modal->source_id) == 0) {
+                break;
+            }
+        }
+    }
+}
+
+static void index_rebuild(MultiModalData* multi_data) {
+    memset(multi_data->modality_index, 0, sizeof(multi_data->modality_index));
+    if (multi_data->source_table) {
+        memset(multi_data->source_table, 0, multi_data->source_table_size * sizeof(uint32_t));
+    }
+    
+    for (uint32_t i = 0; i < multi_data->modality_count; i++) {
+        index_insert(multi_data, i);
+    }
+}
+
+// 从 arena 中分配（不足时返回NULL）
+static void* arena_alloc(MultiModalData* multi_data, size_t size, size_t alignment) {
+    size_t offset = align_size(multi_data->arena_used, alignment);
+    if (offset > multi_data->arena_size || size > multi_data->arena_size - offset) {
+        return NULL;
+    }
+    
+    multi_data->arena_used = offset + size;
+    return multi_data->arena + offset;
+}
+
+static char* arena_strdup(MultiModalData* multi_data, const char* str) {
+    size_t length = strlen(str) + 1;
+    char* copy = arena_alloc(multi_data, length, 1);
+    if (copy) {
+        memcpy(copy, str, length);
+    }
+    return copy;
+}
+
+static bool in_arena_block(const MultiModalData* multi_data, const void* ptr) {
+    const uint8_t* p = ptr;
+    const uint8_t* block = (const uint8_t*)multi_data;
+    return multi_data->arena && p >= block && p < multi_data->arena + multi_data->arena_size;
+}
+
+// 取得下一个空槽位，普通模式按需扩容，arena 模式容量固定
+static ModalityData* append_slot(MultiModalData* multi_data) {
+    if (multi_data->modality_count >= multi_data->capacity) {
+        if (multi_data->arena) {
+            LOG_ERROR("Arena bundle is full (capacity %u)", multi_data->capacity);
+            return NULL;
+        }
+        
+        uint32_t new_capacity = multi_data->capacity * 2;
+        ModalityData* new_modalities = realloc(multi_data->modalities, 
+                                              new_capacity * sizeof(ModalityData));
+        if (!new_modalities) {
+            LOG_ERROR("Failed to expand modalities array");
+            return NULL;
+        }
+        
+        multi_data->modalities = new_modalities;
+        multi_data->capacity = new_capacity;
+        
+        // 初始化新分配的内存
+        memset(&multi_data->modalities[multi_data->modality_count], 0, 
+               (new_capacity - multi_data->modality_count) * sizeof(ModalityData));
+    }
+    
+    return &multi_data->modalities[multi_data->modality_count];
+}
+
+static void commit_slot(MultiModalData* multi_data) {
+    index_insert(multi_data, multi_data->modality_count);
+    multi_data->modality_count++;
+}
+
 MultiModalData* multimodal_data_create(uint32_t capacity) {
     if (capacity == 0) capacity = 4;  // 默认容量
     
@@ -116,66 +230,176 @@ MultiModalData* multimodal_data_create(uint32_t capacity) {
     return multi_data;
 }
 
+MultiModalData* multimodal_data_create_arena(uint32_t capacity, size_t arena_size) {
+    if (capacity == 0) capacity = 4;  // 默认容量
+    
+    // 数据源哈希表负载不超过一半
+    uint32_t table_size = 2;
+    while (table_size < capacity * 2u) {
+        table_size *= 2;
+    }
+    
+    // 单块内存：容器 | 模态数组 | 数据源哈希表 | arena
+    size_t modalities_offset = align_size(sizeof(MultiModalData), _Alignof(ModalityData));
+    size_t table_offset = align_size(modalities_offset + (size_t)capacity * sizeof(ModalityData), sizeof(uint32_t));
+    size_t arena_offset = align_size(table_offset + (size_t)table_size * sizeof(uint32_t), ARENA_ALIGNMENT);
+    size_t total = align_size(arena_offset + arena_size, ARENA_ALIGNMENT);
+    
+    uint8_t* block = aligned_alloc(ARENA_ALIGNMENT, total);
+    if (!block) {
+        LOG_ERROR("Failed to allocate arena bundle (%zu bytes)", total);
+        return NULL;
+    }
+    memset(block, 0, arena_offset);
+    
+    MultiModalData* multi_data = (MultiModalData*)block;
+    multi_data->modalities = (ModalityData*)(block + modalities_offset);
+    multi_data->capacity = capacity;
+    multi_data->created_time = get_current_timestamp();
+    multi_data->source_table = (uint32_t*)(block + table_offset);
+    multi_data->source_table_size = table_size;
+    multi_data->arena = block + arena_offset;
+    multi_data->arena_size = arena_size;
+    
+    LOG_DEBUG("Created arena bundle: capacity=%u, arena=%zu bytes", capacity, arena_size);
+    
+    return multi_data;
+}
+
+size_t multimodal_data_arena_bytes(const ModalityData* modalities, uint32_t count) {
+    if (!modalities && count > 0) return 0;
+    
+    size_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (modalities[i].data_size > 0) {
+            total = align_size(total, ARENA_ALIGNMENT) + modalities[i].data_size;
+        }
+        if (modalities[i].metadata) total += strlen(modalities[i].metadata) + 1;
+        if (modalities[i].source_id) total += strlen(modalities[i].source_id) + 1;
+    }
+    return total;
+}
+
+void multimodal_data_clear(MultiModalData* multi_data) {
+    if (!multi_data) return;
+    
+    for (uint32_t i = 0; i < multi_data->modality_count; i++) {
+        modality_data_release(&multi_data->modalities[i]);
+    }
+    memset(multi_data->modalities, 0, multi_data->modality_count * sizeof(ModalityData));
+    
+    multi_data->modality_count = 0;
+    multi_data->arena_used = 0;
+    if (in_arena_block(multi_data, multi_data->session_id)) {
+        multi_data->session_id = NULL;
+    }
+    index_rebuild(multi_data);
+}
+
 void multimodal_data_destroy(MultiModalData* multi_data) {
     if (!multi_data) return;
     
     for (uint32_t i = 0; i < multi_data->modality_count; i++) {
-        ModalityData* modal = &multi_data->modalities[i];
-        free(modal->data);
-        free(modal->metadata);
-        free(modal->source_id);
+        modality_data_release(&multi_data->modalities[i]);
+    }
+    
+    if (!in_arena_block(multi_data, multi_data->session_id)) {
+        free(multi_data->session_id);
     }
     
-    free(multi_data->modalities);
-    free(multi_data->session_id);
+    // arena 模式下模态数组和数据都在容器所在的同一块内存中
+    if (!multi_data->arena) {
+        free(multi_data->modalities);
+    }
     free(multi_data);
 }
 
-int multimodal_data_add(MultiModalData* multi_data, const ModalityData* modal_data) {
-    if (!multi_data || !modal_data) return -1;
+int multimodal_data_set_session(MultiModalData* multi_data, const char* session_id) {
+    if (!multi_data) return -1;
     
-    // 检查是否需要扩容
-    if (multi_data->modality_count >= multi_data->capacity) {
-        uint32_t new_capacity = multi_data->capacity * 2;
-        ModalityData* new_modalities = realloc(multi_data->modalities, 
-                                              new_capacity * sizeof(ModalityData));
-        if (!new_modalities) {
-            LOG_ERROR("Failed to expand modalities array");
+    char* copy = NULL;
+    if (session_id) {
+        copy = multi_data->arena ? arena_strdup(multi_data, session_id) : strdup(session_id);
+        if (!copy) {
+            LOG_ERROR("Failed to store session id");
             return -1;
         }
-        
-        multi_data->modalities = new_modalities;
-        multi_data->capacity = new_capacity;
-        
-        // 初始化新分配的内存
-        memset(&multi_data->modalities[multi_data->modality_count], 0, 
-               (new_capacity - multi_data->modality_count) * sizeof(ModalityData));
     }
     
-    // 复制模态数据
-    ModalityData* dst = &multi_data->modalities[multi_data->modality_count];
+    if (!in_arena_block(multi_data, multi_data->session_id)) {
+        free(multi_data->session_id);
+    }
+    multi_data->session_id = copy;
+    return 0;
+}
+
+// arena 模式：数据和字符串复制到 arena，不单独分配
+static int arena_add(MultiModalData* multi_data, const ModalityData* modal_data, ModalityData* dst) {
+    size_t saved = multi_data->arena_used;
+    
     *dst = *modal_data;
+    dst->data = NULL;
+    dst->metadata = NULL;
+    dst->source_id = NULL;
     
-    // 深拷贝字符串字段
-    if (modal_data->metadata) {
-        dst->metadata = strdup(modal_data->metadata);
+    if (modal_data->data && modal_data->data_size > 0) {
+        dst->data = arena_alloc(multi_data, modal_data->data_size, ARENA_ALIGNMENT);
+        if (dst->data) memcpy(dst->data, modal_data->data, modal_data->data_size);
     }
-    
-    if (modal_data->source_id) {
-        dst->source_id = strdup(modal_data->source_id);
+    if (modal_data->metadata) dst->metadata = arena_strdup(multi_data, modal_data->metadata);
+    if (modal_data->source_id) dst->source_id = arena_strdup(multi_data, modal_data->source_id);
+    
+    if ((modal_data->data && modal_data->data_size > 0 && !dst->data) ||
+        (modal_data->metadata && !dst->metadata) || (modal_data->source_id && !dst->source_id)) {
+        LOG_ERROR("Arena bundle out of space (%zu of %zu bytes used)", saved, multi_data->arena_size);
+        multi_data->arena_used = saved;
+        memset(dst, 0, sizeof(*dst));
+        return -1;
     }
     
-    // 深拷贝数据
-    if (modal_data->data && modal_data->data_size > 0) {
-        dst->data = malloc(modal_data->data_size);
-        if (!dst->data) {
+    // 没有放入 arena 的空模态（例如预分配的输出槽位）之后可以由调用者挂上自己分配的数据
+    dst->borrowed = dst->data || dst->metadata || dst->source_id;
+    return 0;
+}
+
+int multimodal_data_add(MultiModalData* multi_data, const ModalityData* modal_data) {
+    if (!multi_data || !modal_data) return -1;
+    
+    ModalityData* dst = append_slot(multi_data);
+    if (!dst) return -1;
+    
+    if (multi_data->arena) {
+        if (arena_add(multi_data, modal_data, dst) != 0) return -1;
+    } else {
+        // 复制模态数据
+        *dst = *modal_data;
+        dst->borrowed = false;
+        dst->data = NULL;
+        dst->metadata = NULL;
+        dst->source_id = NULL;
+        
+        // 深拷贝字符串字段和数据
+        bool ok = true;
+        if (modal_data->metadata) {
+            ok = (dst->metadata = strdup(modal_data->metadata)) != NULL;
+        }
+        if (ok && modal_data->source_id) {
+            ok = (dst->source_id = strdup(modal_data->source_id)) != NULL;
+        }
+        if (ok && modal_data->data && modal_data->data_size > 0) {
+            ok = (dst->data = malloc(modal_data->data_size)) != NULL;
+            if (ok) memcpy(dst->data, modal_data->data, modal_data->data_size);
+        }
+        
+        if (!ok) {
             LOG_ERROR("Failed to copy modality data");
+            modality_data_release(dst);
+            memset(dst, 0, sizeof(*dst));
             return -1;
         }
-        memcpy(dst->data, modal_data->data, modal_data->data_size);
     }
     
-    multi_data->modality_count++;
+    commit_slot(multi_data);
     
     LOG_DEBUG("Added modality data: type=%s, count=%u", 
               modality_type_to_string(modal_data->modality), 
@@ -184,9 +408,28 @@ int multimodal_data_add(MultiModalData* multi_data, const ModalityData* modal_da
     return 0;
 }
 
+int multimodal_data_adopt(MultiModalData* multi_data, const ModalityData* modal_data) {
+    if (!multi_data || !modal_data) return -1;
+    
+    ModalityData* dst = append_slot(multi_data);
+    if (!dst) return -1;
+    
+    *dst = *modal_data;
+    dst->borrowed = true;
+    commit_slot(multi_data);
+    
+    return 0;
+}
+
 ModalityData* multimodal_data_get(const MultiModalData* multi_data, ModalityType modality) {
     if (!multi_data) return NULL;
     
+    if ((uint32_t)modality <= MODALITY_CUSTOM) {
+        uint32_t index = multi_data->modality_index[modality];
+        if (index == 0 || index > multi_data->modality_count) return NULL;
+        return &multi_data->modalities[index - 1];
+    }
+    
     for (uint32_t i = 0; i < multi_data->modality_count; i++) {
         if (multi_data->modalities[i].modality == modality) {
             return &multi_data->modalities[i];
@@ -196,33 +439,54 @@ ModalityData* multimodal_data_get(const MultiModalData* multi_data, ModalityType
     return NULL;
 }
 
-int multimodal_data_remove(MultiModalData* multi_data, ModalityType modality) {
-    if (!multi_data) return -1;
+ModalityData* multimodal_data_find_source(const MultiModalData* multi_data, const char* source_id) {
+    if (!multi_data || !source_id) return NULL;
+    
+    if (multi_data->source_table) {
+        uint32_t mask = multi_data->source_table_size - 1;
+        for (uint32_t slot = hash_source_id(source_id) & mask;; slot = (slot + 1) & mask) {
+            uint32_t entry = multi_data->source_table[slot];
+            if (entry == 0) return NULL;
+            if (strcmp(multi_data->modalities[entry - 1].source_id, source_id) == 0) {
+                return &multi_data->modalities[entry - 1];
+            }
+        }
+    }
     
     for (uint32_t i = 0; i < multi_data->modality_count; i++) {
-        if (multi_data->modalities[i].modality == modality) {
-            ModalityData* modal = &multi_data->modalities[i];
-            
-            // 释放内存
-            free(modal->data);
-            free(modal->metadata);
-            free(modal->source_id);
-            
-            // 移动后续元素
-            if (i < multi_data->modality_count - 1) {
-                memmove(&multi_data->modalities[i], 
-                       &multi_data->modalities[i + 1],
-                       (multi_data->modality_count - i - 1) * sizeof(ModalityData));
-            }
-            
-            multi_data->modality_count--;
-            
-            LOG_DEBUG("Removed modality data: type=%s", modality_type_to_string(modality));
-            return 0;
+        const char* id = multi_data->modalities[i].source_id;
+        if (id && strcmp(id, source_id) == 0) {
+            return &multi_data->modalities[i];
         }
     }
     
-    return -1;  // 未找到
+    return NULL;
+}
+
+int multimodal_data_remove(MultiModalData* multi_data, ModalityType modality) {
+    if (!multi_data) return -1;
+    
+    ModalityData* modal = multimodal_data_get(multi_data, modality);
+    if (!modal) return -1;  // 未找到
+    
+    uint32_t i = (uint32_t)(modal - multi_data->modalities);
+    
+    // 释放内存（arena 中的空间不回收，直到 multimodal_data_clear）
+    modality_data_release(modal);
+    
+    // 移动后续元素
+    if (i < multi_data->modality_count - 1) {
+        memmove(&multi_data->modalities[i], 
+               &multi_data->modalities[i + 1],
+               (multi_data->modality_count - i - 1) * sizeof(ModalityData));
+    }
+    
+    multi_data->modality_count--;
+    memset(&multi_data->modalities[multi_data->modality_count], 0, sizeof(ModalityData));
+    index_rebuild(multi_data);
+    
+    LOG_DEBUG("Removed modality data: type=%s", modality_type_to_string(modality));
+    return 0;
 }
 
 const char* modality_type_to_string(ModalityType modality) {
@@ -89,6 +89,7 @@ typedef struct {
     uint64_t timestamp;         /**< 时间戳 */
     uint32_t sequence_id;       /**< 序列ID */
     char* source_id;            /**< 数据源ID */
+    bool borrowed;              /**< 数据和字符串指向外部缓冲区（只读视图），销毁时不释放 */
 } modality_data_t;
 
 /**
@@ -101,6 +102,12 @@ typedef struct {
     char* session_id;           /**< 会话ID */
     uint64_t created_time;      /**< 创建时间 */
     void* user_data;            /**< 用户数据 */
+    uint32_t modality_index[MODALITY_CUSTOM + 1]; /**< 各模态第一次出现的位置+1（0表示不存在） */
+    uint8_t* arena;             /**< arena 起始地址（NULL表示普通模式） */
+    size_t arena_size;          /**< arena 大小 */
+    size_t arena_used;          /**< arena 已用字节数 */
+    uint32_t* source_table;     /**< 数据源ID哈希表（开放寻址，存位置+1，仅 arena 模式） */
+    uint32_t source_table_size; /**< 哈希表槽位数（2的幂） */
 } multimodal_data_t;
 
 /**
@@ -182,6 +189,28 @@ ModalityData* modality_data_copy(const ModalityData* src);
  */
 MultiModalData* multimodal_data_create(uint32_t capacity);
 
+/**
+ * @brief 创建 arena 模式的多模态数据容器
+ * 
+ * 容器、模态数组、数据源索引和 arena 在同一次分配中。multimodal_data_add 把数据和字符串
+ * 复制到 arena（数据按64字节对齐），容量和 arena 都不扩展，用完时添加失败。
+ * 用 multimodal_data_clear 重置后可以反复使用，不再分配内存。
+ * 
+ * @param capacity 最大模态数量
+ * @param arena_size arena 大小（字节），可用 multimodal_data_arena_bytes 计算
+ * @return MultiModalData* 多模态数据容器，失败返回NULL
+ */
+MultiModalData* multimodal_data_create_arena(uint32_t capacity, size_t arena_size);
+
+/**
+ * @brief 计算把一组模态复制进 arena 需要的字节数
+ * 
+ * @param modalities 模态数据数组
+ * @param count 模态数量
+ * @return size_t arena 字节数
+ */
+size_t multimodal_data_arena_bytes(const ModalityData* modalities, uint32_t count);
+
 /**
  * @brief 销毁多模态数据容器
  * 
@@ -189,6 +218,22 @@ MultiModalData* multimodal_data_create(uint32_t capacity);
  */
 void multimodal_data_destroy(MultiModalData* multi_data);
 
+/**
+ * @brief 清空多模态数据容器（保留已分配的内存，arena 从头复用）
+ * 
+ * @param multi_data 多模态数据容器
+ */
+void multimodal_data_clear(MultiModalData* multi_data);
+
+/**
+ * @brief 设置会话ID（复制一份，arena 模式下复制到 arena）
+ * 
+ * @param multi_data 多模态数据容器
+ * @param session_id 会话ID，NULL表示清除
+ * @return int 0成功，其他失败
+ */
+int multimodal_data_set_session(MultiModalData* multi_data, const char* session_id);
+
 /**
  * @brief 添加模态数据
  * 
@@ -198,6 +243,17 @@ void multimodal_data_destroy(MultiModalData* multi_data);
  */
 int multimodal_data_add(MultiModalData* multi_data, const ModalityData* modal_data);
 
+/**
+ * @brief 按引用添加模态数据（不复制）
+ * 
+ * 数据和字符串直接指向调用者的缓冲区（borrowed 为 true），缓冲区必须在容器使用期间保持有效。
+ * 
+ * @param multi_data 多模态数据容器
+ * @param modal_data 模态数据
+ * @return int 0成功，其他失败
+ */
+int multimodal_data_adopt(MultiModalData* multi_data, const ModalityData* modal_data);
+
 /**
  * @brief 获取模态数据
  * 
@@ -207,6 +263,15 @@ int multimodal_data_add(MultiModalData* multi_data, const ModalityData* modal_da
  */
 ModalityData* multimodal_data_get(const MultiModalData* multi_data, ModalityType modality);
 
+/**
+ * @brief 按数据源ID获取模态数据（arena 模式下为哈希查找）
+ * 
+ * @param multi_data 多模态数据容器
+ * @param source_id 数据源ID
+ * @return ModalityData* 模态数据，未找到返回NULL
+ */
+ModalityData* multimodal_data_find_source(const MultiModalData* multi_data, const char* source_id);
+
 /**
  * @brief 移除模态数据
  * 
@@ -377,18 +442,34 @@ size_t modality_data_get_size(const ModalityData* modal_data);
  */
 bool modality_data_validate(const ModalityData* modal_data);
 
+/**
+ * @brief 序列化格式
+ *
+ * 小端、基于偏移的二进制布局，可以直接在接收缓冲区或映射文件上读取：
+ * - 64 字节头：魔数、版本、记录大小、模态数量、总大小、创建时间、会话ID位置
+ * - 每个模态一条定长记录：类型、格式、形状、时间戳、序列ID以及数据和字符串的偏移、长度
+ * - 字符串（以'\0'结尾），随后是按 MULTIMODAL_SERIALIZE_ALIGNMENT 对齐的数据
+ *
+ * 所有偏移都相对于缓冲区起始位置；缓冲区本身按该值对齐时，反序列化得到的数据指针也对齐。
+ */
+#define MULTIMODAL_SERIALIZE_VERSION 1
+#define MULTIMODAL_SERIALIZE_ALIGNMENT 64
+
 /**
  * @brief 序列化模态数据
  * 
  * @param modal_data 模态数据
- * @param buffer 输出缓冲区
+ * @param buffer 输出缓冲区（NULL 时只计算所需大小）
  * @param buffer_size 缓冲区大小
  * @return int 序列化的字节数，失败返回-1
  */
 int modality_data_serialize(const ModalityData* modal_data, void* buffer, size_t buffer_size);
 
 /**
- * @brief 反序列化模态数据
+ * @brief 反序列化模态数据（零拷贝）
+ * 
+ * 数据、元数据和数据源ID直接指向 buffer（borrowed 为 true），buffer 必须在使用期间保持有效。
+ * 结果是只读视图，不要调用 modality_data_destroy；需要独立副本时使用 modality_data_copy。
  * 
  * @param buffer 输入缓冲区
  * @param buffer_size 缓冲区大小
@@ -398,7 +479,44 @@ int modality_data_serialize(const ModalityData* modal_data, void* buffer, size_t
 int modality_data_deserialize(const void* buffer, size_t buffer_size, ModalityData* modal_data);
 
 /**
- * @brief 模态数据压缩
+ * @brief 计算多模态数据的序列化大小
+ * 
+ * @param multi_data 多模态数据容器
+ * @return size_t 序列化所需字节数，失败返回0
+ */
+size_t multimodal_data_serialized_size(const MultiModalData* multi_data);
+
+/**
+ * @brief 序列化多模态数据
+ * 
+ * @param multi_data 多模态数据容器
+ * @param buffer 输出缓冲区
+ * @param buffer_size 缓冲区大小
+ * @param written 输出实际写入的字节数（可为NULL）
+ * @return int 0成功，其他失败
+ */
+int multimodal_data_serialize(const MultiModalData* multi_data, void* buffer, size_t buffer_size,
+                              size_t* written);
+
+/**
+ * @brief 反序列化多模态数据（零拷贝）
+ * 
+ * 容器、模态数组和会话ID在一次分配中（arena 模式），各模态的数据和字符串直接指向 buffer（borrowed 为 true），
+ * buffer 必须在容器销毁前保持有效。容器照常用 multimodal_data_destroy 释放。
+ * 
+ * @param buffer 输入缓冲区
+ * @param buffer_size 缓冲区大小
+ * @return MultiModalData* 多模态数据容器，失败返回NULL
+ */
+MultiModalData* multimodal_data_deserialize(const void* buffer, size_t buffer_size);
+
+/**
+ * @brief 模态数据无损压缩
+ * 
+ * 按模态和数据类型选择压缩选项（见 utils/tensor_codec.h）：音频、传感器和雷达的整数采样
+ * 做差分加字节重排，深度/热成像整数图、浮点数据和布尔掩码做位重排，其他多字节数据做字节重排。
+ * 输出保留原有的描述字段（模态、格式、形状、类型、时间戳等），data 为压缩帧，
+ * 数据和字符串由调用者用 free 释放。
  * 
  * @param modal_data 模态数据
  * @param compressed 压缩后的数据
@@ -409,6 +527,8 @@ int modality_data_compress(const ModalityData* modal_data, ModalityData* compres
 /**
  * @brief 模态数据解压缩
  * 
+ * 校验压缩帧，损坏的数据返回失败。输出的数据和字符串由调用者用 free 释放。
+ * 
  * @param compressed 压缩的数据
  * @param modal_data 解压缩后的数据
  * @return int 0成功，其他失败
@@ -0,0 +1,133 @@
+#include "core/multimodal.h"
+#include "utils/tensor_codec.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 按模态和数据类型选择压缩选项
+static void choose_codec_options(const ModalityData* modal, tensor_codec_options_t* options) {
+    size_t width = tensor_get_dtype_size(modal->data_type);
+    if (modal->data_type == TENSOR_TYPE_STRING || (width != 1 && width != 2 && width != 4 && width != 8) ||
+        modal->data_size % width != 0) {
+        width = 1;
+    }
+
+    options->element_size = (uint32_t)width;
+    options->shuffle = width > 1 ? TENSOR_CODEC_SHUFFLE_BYTE : TENSOR_CODEC_SHUFFLE_NONE;
+    options->delta = false;
+
+    bool integer = modal->data_type == TENSOR_TYPE_INT8 || modal->data_type == TENSOR_TYPE_UINT8 ||
+                   modal->data_type == TENSOR_TYPE_INT16 || modal->data_type == TENSOR_TYPE_INT32 ||
+                   modal->data_type == TENSOR_TYPE_INT64;
+    bool floating = modal->data_type == TENSOR_TYPE_FLOAT32 || modal->data_type == TENSOR_TYPE_FLOAT64 ||
+                    modal->data_type == TENSOR_TYPE_FLOAT16;
+
+    switch (modal->modality) {
+        case MODALITY_AUDIO:
+        case MODALITY_SENSOR:
+        case MODALITY_RADAR:
+            // 一维采样流相邻值接近，整数差分后高位字节几乎全为0
+            options->delta = integer && width > 1;
+            break;
+        case MODALITY_DEPTH:
+        case MODALITY_THERMAL:
+            // 图像按行展开，差分放大了噪声；位重排把缓慢变化的高位集中成长串
+            if (integer && width > 1) options->shuffle = TENSOR_CODEC_SHUFFLE_BIT;
+            break;
+        default:
+            break;
+    }
+
+    // 浮点数的符号和指数位变化很少，位重排优于字节重排；布尔掩码每字节只有1位有效
+    if ((floating && !options->delta) || modal->data_type == TENSOR_TYPE_BOOL) {
+        options->shuffle = TENSOR_CODEC_SHUFFLE_BIT;
+    }
+}
+
+// 复制描述字段，数据由调用者设置
+static int copy_descriptor(const ModalityData* src, ModalityData* dst) {
+    memset(dst, 0, sizeof(*dst));
+    dst->modality = src->modality;
+    dst->format = src->format;
+    dst->shape = src->shape;
+    dst->data_type = src->data_type;
+    dst->timestamp = src->timestamp;
+    dst->sequence_id = src->sequence_id;
+
+    if (src->metadata && !(dst->metadata = strdup(src->metadata))) return -1;
+    if (src->source_id && !(dst->source_id = strdup(src->source_id))) {
+        free(dst->metadata);
+        dst->metadata = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int modality_data_compress(const ModalityData* modal_data, ModalityData* compressed) {
+    if (!modal_data || !compressed || (!modal_data->data && modal_data->data_size > 0)) return -1;
+
+    tensor_codec_options_t options;
+    choose_codec_options(modal_data, &options);
+
+    size_t capacity = tensor_codec_compress_bound(modal_data->data_size);
+    uint8_t* frame = malloc(capacity);
+    if (!frame) {
+        LOG_ERROR("Failed to allocate compression buffer (%zu bytes)", capacity);
+        return -1;
+    }
+
+    size_t written = 0;
+    if (tensor_codec_compress(modal_data->data, modal_data->data_size, &options, frame, capacity, &written) != 0) {
+        free(frame);
+        return -1;
+    }
+
+    if (copy_descriptor(modal_data, compressed) != 0) {
+        free(frame);
+        return -1;
+    }
+
+    // 收缩到实际大小（失败时保留原缓冲区）
+    uint8_t* shrunk = realloc(frame, written);
+    compressed->data = shrunk ? shrunk : frame;
+    compressed->data_size = written;
+
+    LOG_DEBUG("Compressed %s data: %zu -> %zu bytes",
+              modality_type_to_string(modal_data->modality), modal_data->data_size, written);
+    return 0;
+}
+
+int modality_data_decompress(const ModalityData* compressed, ModalityData* modal_data) {
+    if (!compressed || !modal_data || !compressed->data) return -1;
+
+    size_t original = 0;
+    if (tensor_codec_get_original_size(compressed->data, compressed->data_size, &original) != 0) {
+        LOG_ERROR("Modality data is not compressed");
+        return -1;
+    }
+
+    uint8_t* data = malloc(original > 0 ? original : 1);
+    if (!data) {
+        LOG_ERROR("Failed to allocate decompression buffer (%zu bytes)", original);
+        return -1;
+    }
+
+    size_t written = 0;
+    if (tensor_codec_decompress(compressed->data, compressed->data_size, data, original, &written) != 0) {
+        free(data);
+        return -1;
+    }
+
+    if (copy_descriptor(compressed, modal_data) != 0) {
+        free(data);
+        return -1;
+    }
+
+    if (written == 0) {
+        free(data);
+        data = NULL;
+    }
+    modal_data->data = data;
+    modal_data->data_size = written;
+    return 0;
+}
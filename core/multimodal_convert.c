@@ -0,0 +1,392 @@
+#include "core/multimodal_convert.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define FORMAT_COUNT ((uint32_t)DATA_FORMAT_CUSTOM + 1)
+
+// 实测代价的滑动平均权重
+#define COST_SMOOTHING 0.125
+
+struct ModalityConverter {
+    ModalityConvertFunc convert_func;
+    void* context;
+};
+
+typedef struct {
+    modality_convert_edge_t edge;
+    double cost;                    /**< 当前代价（估计值或实测平均） */
+    double planned_cost;            /**< 上次触发重新规划时的代价 */
+    uint64_t calls;
+} graph_edge_t;
+
+typedef struct {
+    uint64_t epoch;                 /**< 规划时的图版本 */
+    modality_convert_plan_t plan;
+    uint32_t edges[MODALITY_CONVERT_MAX_STEPS];
+} cached_plan_t;
+
+struct modality_convert_graph_internal_t {
+    pthread_mutex_t mutex;
+    graph_edge_t* edges;
+    uint32_t edge_count;
+    uint32_t edge_capacity;
+    uint64_t epoch;                 /**< 注册新边或代价明显变化时递增，缓存的计划随之失效 */
+    cached_plan_t* plans[FORMAT_COUNT * FORMAT_COUNT];
+};
+
+ModalityConverter modality_converter_create(ModalityConvertFunc convert_func, void* context) {
+    if (!convert_func) {
+        LOG_ERROR("转换函数不能为空");
+        return NULL;
+    }
+
+    ModalityConverter converter = calloc(1, sizeof(*converter));
+    if (!converter) {
+        LOG_ERROR("分配模态转换器失败");
+        return NULL;
+    }
+
+    converter->convert_func = convert_func;
+    converter->context = context;
+    return converter;
+}
+
+void modality_converter_destroy(ModalityConverter converter) {
+    free(converter);
+}
+
+int modality_converter_convert(ModalityConverter converter, const ModalityData* input,
+                               DataFormat target_format, ModalityData* output) {
+    if (!converter || !input || !output) return -1;
+
+    return converter->convert_func(input, target_format, output, converter->context);
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static bool valid_format(data_format_e format) {
+    return (uint32_t)format < FORMAT_COUNT;
+}
+
+// 释放转换结果（借用的视图不释放）
+static void release_output(ModalityData* modal) {
+    if (!modal->borrowed) {
+        free(modal->data);
+        free(modal->metadata);
+        free(modal->source_id);
+    }
+    memset(modal, 0, sizeof(*modal));
+}
+
+static int copy_modality(const ModalityData* src, ModalityData* dst) {
+    *dst = *src;
+    dst->borrowed = false;
+    dst->data = NULL;
+    dst->metadata = NULL;
+    dst->source_id = NULL;
+
+    bool ok = true;
+    if (src->data && src->data_size > 0) {
+        ok = (dst->data = malloc(src->data_size)) != NULL;
+        if (ok) memcpy(dst->data, src->data, src->data_size);
+    }
+    if (ok && src->metadata) ok = (dst->metadata = strdup(src->metadata)) != NULL;
+    if (ok && src->source_id) ok = (dst->source_id = strdup(src->source_id)) != NULL;
+
+    if (!ok) {
+        LOG_ERROR("复制模态数据失败");
+        release_output(dst);
+        return -1;
+    }
+    return 0;
+}
+
+modality_convert_graph_t modality_convert_graph_create(void) {
+    modality_convert_graph_t graph = calloc(1, sizeof(*graph));
+    if (!graph) {
+        LOG_ERROR("分配格式转换图失败");
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&graph->mutex, NULL) != 0) {
+        LOG_ERROR("初始化格式转换图互斥锁失败");
+        free(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+void modality_convert_graph_destroy(modality_convert_graph_t graph) {
+    if (!graph) return;
+
+    for (uint32_t i = 0; i < FORMAT_COUNT * FORMAT_COUNT; i++) {
+        free(graph->plans[i]);
+    }
+    free(graph->edges);
+    pthread_mutex_destroy(&graph->mutex);
+    free(graph);
+}
+
+// 路径比较：代价小优先，其次步数少，再次普通边少（融合边优先）
+static bool path_better(double cost, uint32_t steps, uint32_t plain,
+                        double best_cost, uint32_t best_steps, uint32_t best_plain) {
+    double slack = 1e-9 * (cost > best_cost ? cost : best_cost);
+    if (cost < best_cost - slack) return true;
+    if (cost > best_cost + slack) return false;
+    if (steps != best_steps) return steps < best_steps;
+    return plain < best_plain;
+}
+
+// Dijkstra（格式数很少，直接 O(V^2)），调用时持有锁
+static int compute_plan(modality_convert_graph_t graph, data_format_e from, data_format_e to, cached_plan_t* out) {
+    double cost[FORMAT_COUNT];
+    uint32_t steps[FORMAT_COUNT];
+    uint32_t plain[FORMAT_COUNT];
+    int32_t via[FORMAT_COUNT];
+    bool done[FORMAT_COUNT];
+
+    for (uint32_t i = 0; i < FORMAT_COUNT; i++) {
+        cost[i] = -1.0;
+        steps[i] = 0;
+        plain[i] = 0;
+        via[i] = -1;
+        done[i] = false;
+    }
+    cost[from] = 0.0;
+
+    for (;;) {
+        int32_t current = -1;
+        for (uint32_t i = 0; i < FORMAT_COUNT; i++) {
+            if (done[i] || cost[i] < 0) continue;
+            if (current < 0 || path_better(cost[i], steps[i], plain[i], cost[current], steps[current], plain[current])) {
+                current = (int32_t)i;
+            }
+        }
+        if (current < 0 || (uint32_t)current == (uint32_t)to) break;
+        done[current] = true;
+
+        for (uint32_t e = 0; e < graph->edge_count; e++) {
+            const graph_edge_t* edge = &graph->edges[e];
+            if ((uint32_t)edge->edge.from != (uint32_t)current) continue;
+
+            uint32_t next = edge->edge.to;
+            if (done[next]) continue;
+
+            double next_cost = cost[current] + edge->cost;
+            uint32_t next_steps = steps[current] + 1;
+            uint32_t next_plain = plain[current] + (edge->edge.fused ? 0 : 1);
+            if (cost[next] < 0 || path_better(next_cost, next_steps, next_plain, cost[next], steps[next], plain[next])) {
+                cost[next] = next_cost;
+                steps[next] = next_steps;
+                plain[next] = next_plain;
+                via[next] = (int32_t)e;
+            }
+        }
+    }
+
+    if (cost[to] < 0) return -1;
+
+    // 从目标沿 via 回溯
+    modality_convert_plan_t* plan = &out->plan;
+    plan->step_count = steps[to];
+    plan->cost = cost[to];
+    plan->formats[plan->step_count] = to;
+    uint32_t format = to;
+    for (uint32_t i = plan->step_count; i > 0; i--) {
+        const graph_edge_t* edge = &graph->edges[via[format]];
+        out->edges[i - 1] = (uint32_t)via[format];
+        plan->fused[i - 1] = edge->edge.fused;
+        plan->formats[i - 1] = edge->edge.from;
+        format = edge->edge.from;
+    }
+    out->epoch = graph->epoch;
+    return 0;
+}
+
+int modality_convert_graph_register(modality_convert_graph_t graph, const modality_convert_edge_t* edge) {
+    if (!graph || !edge || !edge->converter || !valid_format(edge->from) || !valid_format(edge->to) ||
+        edge->from == edge->to || edge->cost < 0) {
+        LOG_ERROR("无效的转换边");
+        return -1;
+    }
+
+    pthread_mutex_lock(&graph->mutex);
+
+    if (graph->edge_count == graph->edge_capacity) {
+        uint32_t new_capacity = graph->edge_capacity ? graph->edge_capacity * 2 : 8;
+        graph_edge_t* new_edges = realloc(graph->edges, new_capacity * sizeof(graph_edge_t));
+        if (!new_edges) {
+            pthread_mutex_unlock(&graph->mutex);
+            LOG_ERROR("扩展转换边数组失败");
+            return -1;
+        }
+        graph->edges = new_edges;
+        graph->edge_capacity = new_capacity;
+    }
+
+    // 没有估计值的融合边取它所替代路径的当前代价，代价相同时融合边优先，实测后再决定去留
+    double cost = edge->cost > 0 ? edge->cost : MODALITY_CONVERT_DEFAULT_COST;
+    cached_plan_t existing;
+    if (edge->fused && edge->cost == 0 && compute_plan(graph, edge->from, edge->to, &existing) == 0 &&
+        existing.plan.cost < cost) {
+        cost = existing.plan.cost;
+    }
+
+    graph_edge_t* entry = &graph->edges[graph->edge_count++];
+    entry->edge = *edge;
+    entry->cost = cost;
+    entry->planned_cost = entry->cost;
+    entry->calls = 0;
+    graph->epoch++;
+
+    pthread_mutex_unlock(&graph->mutex);
+
+    LOG_DEBUG("注册格式转换: %s -> %s%s，代价 %.1f us", data_format_to_string(edge->from),
+              data_format_to_string(edge->to), edge->fused ? "（融合）" : "", entry->cost);
+    return 0;
+}
+
+// 取缓存的计划，过期时重新规划，调用时持有锁
+static const cached_plan_t* lookup_plan(modality_convert_graph_t graph, data_format_e from, data_format_e to) {
+    cached_plan_t** slot = &graph->plans[(uint32_t)from * FORMAT_COUNT + (uint32_t)to];
+    if (*slot && (*slot)->epoch == graph->epoch) {
+        return *slot;
+    }
+
+    if (!*slot) {
+        *slot = malloc(sizeof(cached_plan_t));
+        if (!*slot) {
+            LOG_ERROR("分配转换计划失败");
+            return NULL;
+        }
+    }
+
+    if (compute_plan(graph, from, to, *slot) != 0) {
+        free(*slot);
+        *slot = NULL;
+        return NULL;
+    }
+
+    LOG_DEBUG("规划格式转换 %s -> %s: %u 步，代价 %.1f us", data_format_to_string(from),
+              data_format_to_string(to), (*slot)->plan.step_count, (*slot)->plan.cost);
+    return *slot;
+}
+
+int modality_convert_graph_plan(modality_convert_graph_t graph, data_format_e from, data_format_e to,
+                                modality_convert_plan_t* plan) {
+    if (!graph || !plan || !valid_format(from) || !valid_format(to)) return -1;
+
+    pthread_mutex_lock(&graph->mutex);
+    const cached_plan_t* cached = lookup_plan(graph, from, to);
+    if (cached) *plan = cached->plan;
+    pthread_mutex_unlock(&graph->mutex);
+
+    if (!cached) {
+        LOG_ERROR("没有从 %s 到 %s 的转换路径", data_format_to_string(from), data_format_to_string(to));
+        return -1;
+    }
+    return 0;
+}
+
+// 记录一次实测耗时，偏离规划时的代价一倍以上时使缓存的计划失效
+static void record_cost(modality_convert_graph_t graph, uint32_t index, double elapsed) {
+    pthread_mutex_lock(&graph->mutex);
+
+    graph_edge_t* edge = &graph->edges[index];
+    edge->cost = edge->calls == 0 ? elapsed : edge->cost + (elapsed - edge->cost) * COST_SMOOTHING;
+    edge->calls++;
+
+    if (edge->cost > edge->planned_cost * 2.0 || edge->cost * 2.0 < edge->planned_cost) {
+        edge->planned_cost = edge->cost;
+        graph->epoch++;
+    }
+
+    pthread_mutex_unlock(&graph->mutex);
+}
+
+int modality_convert_graph_convert(modality_convert_graph_t graph, const ModalityData* input,
+                                   data_format_e target_format, ModalityData* output) {
+    if (!graph || !input || !output || !valid_format(input->format) || !valid_format(target_format)) {
+        LOG_ERROR("无效的格式转换参数");
+        return -1;
+    }
+
+    // 在锁内复制计划和转换器，转换在锁外执行
+    uint32_t step_count = 0;
+    uint32_t edges[MODALITY_CONVERT_MAX_STEPS];
+    modality_convert_edge_t steps[MODALITY_CONVERT_MAX_STEPS];
+
+    pthread_mutex_lock(&graph->mutex);
+    const cached_plan_t* cached = lookup_plan(graph, input->format, target_format);
+    if (cached) {
+        step_count = cached->plan.step_count;
+        for (uint32_t i = 0; i < step_count; i++) {
+            edges[i] = cached->edges[i];
+            steps[i] = graph->edges[edges[i]].edge;
+        }
+    }
+    pthread_mutex_unlock(&graph->mutex);
+
+    if (!cached) {
+        LOG_ERROR("没有从 %s 到 %s 的转换路径", data_format_to_string(input->format),
+                  data_format_to_string(target_format));
+        return -1;
+    }
+
+    if (step_count == 0) {
+        return copy_modality(input, output);
+    }
+
+    ModalityData current;
+    const ModalityData* source = input;
+    for (uint32_t i = 0; i < step_count; i++) {
+        ModalityData result;
+        memset(&result, 0, sizeof(result));
+
+        double start = now_us();
+        int ret = modality_converter_convert(steps[i].converter, source, steps[i].to, &result);
+        double elapsed = now_us() - start;
+
+        if (source != input) release_output(&current);
+        if (ret != 0) {
+            LOG_ERROR("格式转换 %s -> %s 失败", data_format_to_string(steps[i].from),
+                      data_format_to_string(steps[i].to));
+            release_output(&result);
+            return -1;
+        }
+
+        record_cost(graph, edges[i], elapsed);
+        result.format = steps[i].to;
+        current = result;
+        source = &current;
+    }
+
+    *output = current;
+    return 0;
+}
+
+int modality_convert_graph_get_cost(modality_convert_graph_t graph, data_format_e from, data_format_e to,
+                                    double* cost, uint64_t* calls) {
+    if (!graph || !cost) return -1;
+
+    int found = -1;
+    pthread_mutex_lock(&graph->mutex);
+    for (uint32_t i = 0; i < graph->edge_count; i++) {
+        const graph_edge_t* edge = &graph->edges[i];
+        if (edge->edge.from != from || edge->edge.to != to) continue;
+        if (found < 0 || edge->cost < *cost) {
+            *cost = edge->cost;
+            if (calls) *calls = edge->calls;
+            found = 0;
+        }
+    }
+    pthread_mutex_unlock(&graph->mutex);
+    return found;
+}
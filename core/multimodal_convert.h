@@ -0,0 +1,130 @@
+#ifndef MODYN_CORE_MULTIMODAL_CONVERT_H
+#define MODYN_CORE_MULTIMODAL_CONVERT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/multimodal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 格式转换图
+ *
+ * 把已注册的模态转换器看作 data_format_e 之间的有向边，按代价求最短路径，
+ * 自动串联多步转换（例如 JPEG→RGB→GRAY）。每条边的代价是单次转换耗时（微秒），
+ * 注册时给出估计值，执行时按实测耗时更新（指数滑动平均）。
+ * 路径按 (源格式, 目标格式) 缓存，注册新边或某条边的实测代价与规划时相差超过一倍时重新规划。
+ * 代价相同时步数少的路径优先，融合边（一步完成原本需要多步的转换）在代价相同时优先于普通边；
+ * 没有估计值的融合边以它所替代路径的当前代价为初值，因此注册后立即被选用，实测更慢时才退回原路径。
+ *
+ * 转换函数的输出必须拥有自己的数据（不能借用输入），中间结果在下一步之后释放。
+ * 所有接口线程安全；转换函数在锁外执行。
+ */
+
+/**
+ * @brief 一条路径最多的转换步数
+ */
+#define MODALITY_CONVERT_MAX_STEPS ((uint32_t)DATA_FORMAT_CUSTOM)
+
+/**
+ * @brief 未给出估计值的边的初始代价（微秒）
+ */
+#define MODALITY_CONVERT_DEFAULT_COST 100.0
+
+/**
+ * @brief 转换边
+ */
+typedef struct {
+    data_format_e from;             /**< 源格式 */
+    data_format_e to;               /**< 目标格式 */
+    ModalityConverter converter;    /**< 转换器（不转移所有权，图使用期间必须有效） */
+    double cost;                    /**< 初始代价估计（微秒，0表示使用默认值或融合边替代路径的代价） */
+    bool fused;                     /**< 是否为融合边 */
+} modality_convert_edge_t;
+
+/**
+ * @brief 转换计划
+ */
+typedef struct {
+    uint32_t step_count;            /**< 转换步数（源和目标相同时为0） */
+    data_format_e formats[MODALITY_CONVERT_MAX_STEPS + 1]; /**< 途经的格式（含源和目标） */
+    bool fused[MODALITY_CONVERT_MAX_STEPS];                /**< 每一步是否为融合边 */
+    double cost;                    /**< 规划时的总代价（微秒） */
+} modality_convert_plan_t;
+
+/**
+ * @brief 格式转换图句柄
+ */
+typedef struct modality_convert_graph_internal_t* modality_convert_graph_t;
+
+/**
+ * @brief 创建格式转换图
+ *
+ * @return modality_convert_graph_t 转换图实例，失败返回NULL
+ */
+modality_convert_graph_t modality_convert_graph_create(void);
+
+/**
+ * @brief 销毁格式转换图（不销毁注册的转换器）
+ *
+ * @param graph 转换图实例
+ */
+void modality_convert_graph_destroy(modality_convert_graph_t graph);
+
+/**
+ * @brief 注册转换边
+ *
+ * @param graph 转换图实例
+ * @param edge 转换边
+ * @return int 0成功，其他失败
+ */
+int modality_convert_graph_register(modality_convert_graph_t graph, const modality_convert_edge_t* edge);
+
+/**
+ * @brief 规划代价最小的转换路径（结果被缓存）
+ *
+ * @param graph 转换图实例
+ * @param from 源格式
+ * @param to 目标格式
+ * @param plan 输出转换计划
+ * @return int 0成功，其他失败（没有可达路径）
+ */
+int modality_convert_graph_plan(modality_convert_graph_t graph, data_format_e from, data_format_e to,
+                                modality_convert_plan_t* plan);
+
+/**
+ * @brief 按代价最小的路径转换数据
+ *
+ * 中间结果在下一步完成后立即释放。源和目标格式相同时复制输入。
+ *
+ * @param graph 转换图实例
+ * @param input 输入数据
+ * @param target_format 目标格式
+ * @param output 输出数据（数据和字符串由调用者释放）
+ * @return int 0成功，其他失败
+ */
+int modality_convert_graph_convert(modality_convert_graph_t graph, const ModalityData* input,
+                                   data_format_e target_format, ModalityData* output);
+
+/**
+ * @brief 查询一条边当前的代价
+ *
+ * 同一对格式注册了多条边时返回代价最小的一条。
+ *
+ * @param graph 转换图实例
+ * @param from 源格式
+ * @param to 目标格式
+ * @param cost 输出代价（微秒）
+ * @param calls 输出已执行次数（可为NULL）
+ * @return int 0成功，其他失败（没有这条边）
+ */
+int modality_convert_graph_get_cost(modality_convert_graph_t graph, data_format_e from, data_format_e to,
+                                    double* cost, uint64_t* calls);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_CORE_MULTIMODAL_CONVERT_H
@@ -0,0 +1,396 @@
+#include "core/multimodal.h"
+#include "utils/tensor_codec.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/*
+ * 头部（64 字节）：
+ *   0  magic "MMDB"   4  version u16   6  record_size u16   8  modality_count u32   12 保留
+ *   16 total_size u64                  24 created_time u64
+ *   32 session_offset u64              40 session_length u64                        48 保留
+ *
+ * 模态记录（128 字节）：
+ *   0  modality u32   4  format u32    8  data_type u32     12 ndim u32    16 dims[8] u32
+ *   48 timestamp u64                   56 sequence_id u32   60 保留
+ *   64 data_offset u64                 72 data_size u64
+ *   80 metadata_offset u64             88 metadata_length u64
+ *   96 source_offset u64               104 source_length u64                        112 保留
+ *
+ * 字符串偏移为0表示 NULL。
+ */
+
+static const uint8_t BUNDLE_MAGIC[4] = { 'M', 'M', 'D', 'B' };
+
+#define BUNDLE_HEADER_SIZE 64
+#define BUNDLE_RECORD_SIZE 128
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+// 数据按原样存储，读写双方都要求小端主机
+static bool host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static uint64_t align_up(uint64_t value) {
+    return (value + MULTIMODAL_SERIALIZE_ALIGNMENT - 1) & ~(uint64_t)(MULTIMODAL_SERIALIZE_ALIGNMENT - 1);
+}
+
+// 字符串占用的字节数（含结尾'\0'，NULL 不占空间）
+static uint64_t string_bytes(const char* str) {
+    return str ? strlen(str) + 1 : 0;
+}
+
+// 计算布局：字符串紧跟记录，数据从对齐位置开始依次排列
+static uint64_t bundle_size(const ModalityData* modalities, uint32_t count, const char* session_id) {
+    uint64_t offset = BUNDLE_HEADER_SIZE + (uint64_t)count * BUNDLE_RECORD_SIZE + string_bytes(session_id);
+    for (uint32_t i = 0; i < count; i++) {
+        offset += string_bytes(modalities[i].metadata) + string_bytes(modalities[i].source_id);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (modalities[i].data_size > 0) {
+            offset = align_up(offset) + modalities[i].data_size;
+        }
+    }
+    return offset;
+}
+
+static void write_string(uint8_t* base, uint64_t* cursor, const char* str, uint8_t* field) {
+    if (!str) {
+        put_u64(field, 0);
+        put_u64(field + 8, 0);
+        return;
+    }
+
+    uint64_t length = strlen(str);
+    memcpy(base + *cursor, str, length + 1);
+    put_u64(field, *cursor);
+    put_u64(field + 8, length);
+    *cursor += length + 1;
+}
+
+static int serialize_bundle(const ModalityData* modalities, uint32_t count, const char* session_id,
+                            uint64_t created_time, void* buffer, size_t buffer_size, size_t* written) {
+    if (!host_is_little_endian()) {
+        LOG_ERROR("Multimodal serialization requires a little-endian host");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (modalities[i].data_size > 0 && !modalities[i].data) {
+            LOG_ERROR("Modality %u has size %zu but no data", i, modalities[i].data_size);
+            return -1;
+        }
+        if (modalities[i].shape.ndim > TENSOR_MAX_DIMS) {
+            LOG_ERROR("Modality %u has invalid shape", i);
+            return -1;
+        }
+    }
+
+    uint64_t total = bundle_size(modalities, count, session_id);
+    if (total > buffer_size) {
+        LOG_ERROR("Serialization buffer too small: need %llu, have %zu",
+                  (unsigned long long)total, buffer_size);
+        return -1;
+    }
+
+    uint8_t* base = buffer;
+    memset(base, 0, BUNDLE_HEADER_SIZE + (size_t)count * BUNDLE_RECORD_SIZE);
+
+    uint64_t cursor = BUNDLE_HEADER_SIZE + (uint64_t)count * BUNDLE_RECORD_SIZE;
+    memcpy(base, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    put_u16(base + 4, MULTIMODAL_SERIALIZE_VERSION);
+    put_u16(base + 6, BUNDLE_RECORD_SIZE);
+    put_u32(base + 8, count);
+    put_u64(base + 16, total);
+    put_u64(base + 24, created_time);
+    write_string(base, &cursor, session_id, base + 32);
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t* record = base + BUNDLE_HEADER_SIZE + (size_t)i * BUNDLE_RECORD_SIZE;
+        write_string(base, &cursor, modalities[i].metadata, record + 80);
+        write_string(base, &cursor, modalities[i].source_id, record + 96);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const ModalityData* modal = &modalities[i];
+        uint8_t* record = base + BUNDLE_HEADER_SIZE + (size_t)i * BUNDLE_RECORD_SIZE;
+        put_u32(record + 0, (uint32_t)modal->modality);
+        put_u32(record + 4, (uint32_t)modal->format);
+        put_u32(record + 8, (uint32_t)modal->data_type);
+        put_u32(record + 12, modal->shape.ndim);
+        for (uint32_t d = 0; d < modal->shape.ndim; d++) {
+            put_u32(record + 16 + 4 * d, modal->shape.dims[d]);
+        }
+        put_u64(record + 48, modal->timestamp);
+        put_u32(record + 56, modal->sequence_id);
+
+        if (modal->data_size > 0) {
+            uint64_t offset = align_up(cursor);
+            memset(base + cursor, 0, (size_t)(offset - cursor));
+            memcpy(base + offset, modal->data, modal->data_size);
+            put_u64(record + 64, offset);
+            put_u64(record + 72, modal->data_size);
+            cursor = offset + modal->data_size;
+        }
+    }
+
+    if (written) *written = (size_t)total;
+    return 0;
+}
+
+// 校验字符串范围并返回指向缓冲区的指针
+static int read_string(const uint8_t* base, uint64_t total, const uint8_t* field, char** out) {
+    uint64_t offset = get_u64(field);
+    uint64_t length = get_u64(field + 8);
+    if (offset == 0) {
+        *out = NULL;
+        return length == 0 ? 0 : -1;
+    }
+
+    if (offset < BUNDLE_HEADER_SIZE || offset >= total || length >= total - offset ||
+        base[offset + length] != '\0' || memchr(base + offset, '\0', (size_t)length) != NULL) {
+        return -1;
+    }
+
+    *out = (char*)(base + offset);
+    return 0;
+}
+
+static int parse_header(const void* buffer, size_t buffer_size, uint32_t* count, uint64_t* total) {
+    if (!host_is_little_endian()) {
+        LOG_ERROR("Multimodal deserialization requires a little-endian host");
+        return -1;
+    }
+
+    const uint8_t* base = buffer;
+    if (!buffer || buffer_size < BUNDLE_HEADER_SIZE || memcmp(base, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0) {
+        LOG_ERROR("Not a serialized multimodal buffer");
+        return -1;
+    }
+
+    uint16_t version = get_u16(base + 4);
+    if (version != MULTIMODAL_SERIALIZE_VERSION || get_u16(base + 6) != BUNDLE_RECORD_SIZE) {
+        LOG_ERROR("Unsupported multimodal serialization version %u", version);
+        return -1;
+    }
+
+    *count = get_u32(base + 8);
+    *total = get_u64(base + 16);
+    if (*total > buffer_size || *total < BUNDLE_HEADER_SIZE ||
+        (uint64_t)*count > (*total - BUNDLE_HEADER_SIZE) / BUNDLE_RECORD_SIZE) {
+        LOG_ERROR("Serialized multimodal buffer is truncated or corrupt");
+        return -1;
+    }
+    return 0;
+}
+
+// 压缩容器格式的负载大小与形状无关
+static bool format_is_encoded(data_format_e format) {
+    switch (format) {
+        case DATA_FORMAT_JPEG: case DATA_FORMAT_PNG:
+        case DATA_FORMAT_WAV: case DATA_FORMAT_MP3: case DATA_FORMAT_AAC: case DATA_FORMAT_FLAC:
+        case DATA_FORMAT_H264: case DATA_FORMAT_H265: case DATA_FORMAT_VP8: case DATA_FORMAT_VP9:
+        case DATA_FORMAT_AV1:
+        case DATA_FORMAT_PLY: case DATA_FORMAT_PCD: case DATA_FORMAT_OBJ: case DATA_FORMAT_STL:
+        case DATA_FORMAT_CUSTOM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 形状乘以元素宽度的字节数，溢出时返回 -1
+static int shape_bytes(const TensorShape* shape, size_t width, uint64_t* bytes) {
+    uint64_t count = width;
+    for (uint32_t d = 0; d < shape->ndim; d++) {
+        if (shape->dims[d] != 0 && count > UINT64_MAX / shape->dims[d]) return -1;
+        count *= shape->dims[d];
+    }
+    *bytes = count;
+    return 0;
+}
+
+// 原始张量负载必须与形状一致；经 multimodal_compress 压缩的负载按原始大小校验
+static int check_payload_shape(const ModalityData* modal) {
+    size_t width = tensor_get_dtype_size(modal->data_type);
+    if (modal->shape.ndim == 0 || width == 0 || modal->data_type == TENSOR_TYPE_STRING ||
+        format_is_encoded(modal->format)) {
+        return 0;
+    }
+
+    uint64_t expected = 0;
+    if (shape_bytes(&modal->shape, width, &expected) != 0) return -1;
+
+    size_t original = 0;
+    if (modal->data_size > 0 &&
+        tensor_codec_get_original_size(modal->data, modal->data_size, &original) == 0 &&
+        original == expected) {
+        return 0;
+    }
+    return expected == modal->data_size ? 0 : -1;
+}
+
+static int parse_record(const uint8_t* base, uint64_t total, uint32_t count, uint32_t index, ModalityData* modal) {
+    const uint8_t* record = base + BUNDLE_HEADER_SIZE + (size_t)index * BUNDLE_RECORD_SIZE;
+    memset(modal, 0, sizeof(*modal));
+
+    modal->modality = (modality_type_e)get_u32(record + 0);
+    modal->format = (data_format_e)get_u32(record + 4);
+    modal->data_type = (TensorDataType)get_u32(record + 8);
+    modal->shape.ndim = get_u32(record + 12);
+    if ((uint32_t)modal->modality > MODALITY_CUSTOM || (uint32_t)modal->format > DATA_FORMAT_CUSTOM ||
+        (uint32_t)modal->data_type > TENSOR_TYPE_STRING || modal->shape.ndim > TENSOR_MAX_DIMS) {
+        return -1;
+    }
+    for (uint32_t d = 0; d < modal->shape.ndim; d++) {
+        modal->shape.dims[d] = get_u32(record + 16 + 4 * d);
+    }
+    modal->timestamp = get_u64(record + 48);
+    modal->sequence_id = get_u32(record + 56);
+
+    uint64_t offset = get_u64(record + 64);
+    uint64_t size = get_u64(record + 72);
+    if (size > 0) {
+        uint64_t payload_start = BUNDLE_HEADER_SIZE + (uint64_t)count * BUNDLE_RECORD_SIZE;
+        if (offset % MULTIMODAL_SERIALIZE_ALIGNMENT != 0 || offset < payload_start ||
+            offset > total || size > total - offset || size > SIZE_MAX) {
+            return -1;
+        }
+        modal->data = (void*)(base + offset);
+        modal->data_size = (size_t)size;
+    } else if (offset != 0) {
+        return -1;
+    }
+
+    if (read_string(base, total, record + 80, &modal->metadata) != 0 ||
+        read_string(base, total, record + 96, &modal->source_id) != 0) {
+        return -1;
+    }
+    if (check_payload_shape(modal) != 0) {
+        return -1;
+    }
+
+    modal->borrowed = true;
+    return 0;
+}
+
+int modality_data_serialize(const ModalityData* modal_data, void* buffer, size_t buffer_size) {
+    if (!modal_data) return -1;
+
+    uint64_t total = bundle_size(modal_data, 1, NULL);
+    if (total > INT_MAX) {
+        LOG_ERROR("Modality data too large to serialize: %llu bytes", (unsigned long long)total);
+        return -1;
+    }
+    if (!buffer) {
+        return (int)total;
+    }
+
+    size_t written = 0;
+    if (serialize_bundle(modal_data, 1, NULL, 0, buffer, buffer_size, &written) != 0) {
+        return -1;
+    }
+    return (int)written;
+}
+
+int modality_data_deserialize(const void* buffer, size_t buffer_size, ModalityData* modal_data) {
+    if (!modal_data) return -1;
+
+    uint32_t count = 0;
+    uint64_t total = 0;
+    if (parse_header(buffer, buffer_size, &count, &total) != 0) {
+        return -1;
+    }
+    if (count != 1) {
+        LOG_ERROR("Expected a single serialized modality, found %u", count);
+        return -1;
+    }
+
+    if (parse_record(buffer, total, count, 0, modal_data) != 0) {
+        LOG_ERROR("Serialized modality record is corrupt");
+        memset(modal_data, 0, sizeof(*modal_data));
+        return -1;
+    }
+    return 0;
+}
+
+size_t multimodal_data_serialized_size(const MultiModalData* multi_data) {
+    if (!multi_data) return 0;
+
+    uint64_t total = bundle_size(multi_data->modalities, multi_data->modality_count, multi_data->session_id);
+    return total > SIZE_MAX ? 0 : (size_t)total;
+}
+
+int multimodal_data_serialize(const MultiModalData* multi_data, void* buffer, size_t buffer_size,
+                              size_t* written) {
+    if (!multi_data || !buffer) return -1;
+
+    return serialize_bundle(multi_data->modalities, multi_data->modality_count, multi_data->session_id,
+                            multi_data->created_time, buffer, buffer_size, written);
+}
+
+MultiModalData* multimodal_data_deserialize(const void* buffer, size_t buffer_size) {
+    uint32_t count = 0;
+    uint64_t total = 0;
+    if (parse_header(buffer, buffer_size, &count, &total) != 0) {
+        return NULL;
+    }
+
+    const uint8_t* base = buffer;
+    char* session_id = NULL;
+    if (read_string(base, total, base + 32, &session_id) != 0) {
+        LOG_ERROR("Serialized session id is corrupt");
+        return NULL;
+    }
+
+    // 记录全部借用 buffer，只有会话ID复制到 arena，整个视图一次分配
+    MultiModalData* multi_data = multimodal_data_create_arena(count, session_id ? strlen(session_id) + 1 : 0);
+    if (!multi_data) return NULL;
+
+    for (uint32_t i = 0; i < count; i++) {
+        ModalityData modal;
+        if (parse_record(base, total, count, i, &modal) != 0) {
+            LOG_ERROR("Serialized modality record %u is corrupt", i);
+            multimodal_data_destroy(multi_data);
+            return NULL;
+        }
+        multimodal_data_adopt(multi_data, &modal);
+    }
+
+    if (multimodal_data_set_session(multi_data, session_id) != 0) {
+        multimodal_data_destroy(multi_data);
+        return NULL;
+    }
+    multi_data->created_time = get_u64(base + 24);
+    return multi_data;
+}
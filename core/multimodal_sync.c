@@ -0,0 +1,411 @@
+#include "core/multimodal_sync.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define SYNC_ALIGNMENT 64
+#define SYNC_DEFAULT_CAPACITY 16
+#define SYNC_MAX_CAPACITY (1u << 20)
+
+/*
+ * 每个源的环形缓冲区：head 只由生产者写，tail 只由消费者写，各占一条缓存行。
+ * 槽位 i 的样本描述在 slots[i]，数据和元数据在 buffer + i * stride，入队时复制，
+ * 出队（推进 tail）之后生产者才可能覆盖。
+ */
+typedef struct {
+    _Alignas(SYNC_ALIGNMENT) atomic_uint_fast64_t head;
+    _Alignas(SYNC_ALIGNMENT) atomic_uint_fast64_t tail;
+
+    // 生产者侧
+    _Alignas(SYNC_ALIGNMENT) uint64_t last_timestamp;
+    bool has_last;
+    atomic_uint_fast64_t pushed;
+    atomic_uint_fast64_t dropped_overflow;
+
+    // 消费者侧
+    _Alignas(SYNC_ALIGNMENT) uint64_t dropped_stale;
+    uint64_t matched;
+    uint64_t interpolated;
+    uint64_t max_error;
+    double error_sum;
+
+    // 只读配置
+    char* source_id;
+    modality_type_e modality;
+    uint32_t mask;
+    size_t stride;
+    size_t max_sample_size;
+    bool interpolate;
+    ModalityData* slots;
+    uint8_t* buffer;
+    float* scratch;
+} sync_ring_t;
+
+struct multimodal_sync_internal_t {
+    sync_ring_t* rings;
+    uint32_t count;
+    uint32_t reference;
+    uint64_t tolerance;
+    uint64_t max_latency;
+    ModalityData* choices;          /**< 本次对齐为每个源选中的样本 */
+    uint64_t* errors;               /**< 本次对齐各源的误差 */
+    MultiModalData* output;         /**< arena 模式的输出容器，每次 poll 清空复用 */
+    uint64_t bundles;
+    uint64_t unmatched;
+};
+
+static size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint64_t distance(uint64_t a, uint64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+static void ring_release(sync_ring_t* ring) {
+    free(ring->source_id);
+    free(ring->slots);
+    free(ring->buffer);
+    free(ring->scratch);
+}
+
+static int ring_init(sync_ring_t* ring, const multimodal_sync_source_t* source) {
+    uint32_t requested = source->capacity ? source->capacity : SYNC_DEFAULT_CAPACITY;
+    if (requested > SYNC_MAX_CAPACITY) {
+        LOG_ERROR("数据源 %s 的缓冲区容量过大: %u", source->source_id ? source->source_id : "(null)", requested);
+        return -1;
+    }
+
+    uint32_t capacity = 1;
+    while (capacity < requested) capacity <<= 1;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->pushed, 0);
+    atomic_init(&ring->dropped_overflow, 0);
+    ring->modality = source->modality;
+    ring->mask = capacity - 1;
+    ring->max_sample_size = source->max_sample_size;
+    ring->stride = align_up(source->max_sample_size, SYNC_ALIGNMENT);
+    ring->interpolate = source->interpolate;
+
+    if (ring->stride > SIZE_MAX / capacity) {
+        LOG_ERROR("数据源缓冲区大小溢出");
+        return -1;
+    }
+
+    ring->slots = calloc(capacity, sizeof(ModalityData));
+    ring->buffer = aligned_alloc(SYNC_ALIGNMENT, ring->stride * capacity);
+    if (ring->interpolate) {
+        ring->scratch = aligned_alloc(SYNC_ALIGNMENT, ring->stride);
+    }
+    if (source->source_id) {
+        ring->source_id = strdup(source->source_id);
+    }
+
+    if (!ring->slots || !ring->buffer || (ring->interpolate && !ring->scratch) ||
+        (source->source_id && !ring->source_id)) {
+        LOG_ERROR("分配数据源缓冲区失败");
+        return -1;
+    }
+    return 0;
+}
+
+multimodal_sync_t multimodal_sync_create(const multimodal_sync_source_t* sources, uint32_t count,
+                                         const multimodal_sync_config_t* config) {
+    if (!sources || count == 0 || !config) {
+        LOG_ERROR("无效的对齐器参数");
+        return NULL;
+    }
+    if (config->reference >= count) {
+        LOG_ERROR("参考源下标越界: %u（共 %u 个源）", config->reference, count);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (sources[i].max_sample_size == 0) {
+            LOG_ERROR("数据源 %u 未指定最大样本大小", i);
+            return NULL;
+        }
+    }
+
+    struct multimodal_sync_internal_t* sync = calloc(1, sizeof(*sync));
+    if (!sync) {
+        LOG_ERROR("分配对齐器失败");
+        return NULL;
+    }
+
+    sync->count = count;
+    sync->reference = config->reference;
+    sync->tolerance = config->tolerance;
+    sync->max_latency = config->max_latency ? config->max_latency : config->tolerance;
+
+    sync->rings = aligned_alloc(SYNC_ALIGNMENT, align_up(count * sizeof(sync_ring_t), SYNC_ALIGNMENT));
+    sync->choices = calloc(count, sizeof(ModalityData));
+    sync->errors = calloc(count, sizeof(uint64_t));
+    if (!sync->rings || !sync->choices || !sync->errors) {
+        LOG_ERROR("分配对齐器失败");
+        free(sync->rings);
+        free(sync->choices);
+        free(sync->errors);
+        free(sync);
+        return NULL;
+    }
+    memset(sync->rings, 0, count * sizeof(sync_ring_t));
+
+    // 输出容器的 arena 要容纳每个源一个最大样本（数据按64字节对齐）和数据源ID
+    size_t arena_size = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        arena_size += sources[i].max_sample_size + SYNC_ALIGNMENT;
+        if (sources[i].source_id) arena_size += strlen(sources[i].source_id) + 1;
+    }
+
+    bool ok = true;
+    for (uint32_t i = 0; i < count && ok; i++) {
+        ok = ring_init(&sync->rings[i], &sources[i]) == 0;
+    }
+    if (ok) {
+        sync->output = multimodal_data_create_arena(count, arena_size);
+        ok = sync->output != NULL;
+    }
+    if (!ok) {
+        multimodal_sync_destroy(sync);
+        return NULL;
+    }
+
+    LOG_DEBUG("创建多传感器对齐器: %u 个源，参考源 %u，容差 %llu", count, sync->reference,
+              (unsigned long long)sync->tolerance);
+    return sync;
+}
+
+void multimodal_sync_destroy(multimodal_sync_t sync) {
+    if (!sync) return;
+
+    for (uint32_t i = 0; i < sync->count; i++) {
+        ring_release(&sync->rings[i]);
+    }
+    multimodal_data_destroy(sync->output);
+    free(sync->rings);
+    free(sync->choices);
+    free(sync->errors);
+    free(sync);
+}
+
+int multimodal_sync_push(multimodal_sync_t sync, uint32_t source, const ModalityData* sample) {
+    if (!sync || source >= sync->count || !sample || (!sample->data && sample->data_size > 0)) {
+        LOG_ERROR("无效的样本参数");
+        return -1;
+    }
+
+    sync_ring_t* ring = &sync->rings[source];
+    size_t metadata_size = sample->metadata ? strlen(sample->metadata) + 1 : 0;
+
+    // 丢弃的样本只计数不记日志，过载时不刷屏
+    if (sample->data_size > ring->max_sample_size ||
+        metadata_size > ring->max_sample_size - sample->data_size ||
+        (ring->has_last && sample->timestamp < ring->last_timestamp)) {
+        atomic_fetch_add_explicit(&ring->dropped_overflow, 1, memory_order_relaxed);
+        return -1;
+    }
+
+    uint_fast64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint_fast64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail > ring->mask) {
+        atomic_fetch_add_explicit(&ring->dropped_overflow, 1, memory_order_relaxed);
+        return -1;
+    }
+
+    uint32_t index = (uint32_t)(head & ring->mask);
+    uint8_t* dst = ring->buffer + (size_t)index * ring->stride;
+    ModalityData* slot = &ring->slots[index];
+
+    *slot = *sample;
+    slot->modality = ring->modality;
+    slot->source_id = ring->source_id;
+    slot->borrowed = true;
+    slot->data = NULL;
+    slot->metadata = NULL;
+
+    if (sample->data_size > 0) {
+        memcpy(dst, sample->data, sample->data_size);
+        slot->data = dst;
+    }
+    if (sample->metadata) {
+        slot->metadata = (char*)dst + sample->data_size;
+        memcpy(slot->metadata, sample->metadata, metadata_size);
+    }
+
+    ring->last_timestamp = sample->timestamp;
+    ring->has_last = true;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    atomic_fetch_add_explicit(&ring->pushed, 1, memory_order_relaxed);
+    return 0;
+}
+
+// 消费者侧：可读样本数
+static uint32_t ring_count(sync_ring_t* ring) {
+    uint_fast64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint_fast64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return (uint32_t)(head - tail);
+}
+
+static const ModalityData* ring_at(sync_ring_t* ring, uint32_t offset) {
+    uint_fast64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    return &ring->slots[(tail + offset) & ring->mask];
+}
+
+static void ring_pop(sync_ring_t* ring) {
+    uint_fast64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+// 在 lo 和 hi 之间按时间线性插值，结果写入 scratch
+static bool interpolate_sample(sync_ring_t* ring, const ModalityData* lo, const ModalityData* hi,
+                               uint64_t timestamp, ModalityData* out) {
+    if (lo->data_type != TENSOR_TYPE_FLOAT32 || hi->data_type != TENSOR_TYPE_FLOAT32 ||
+        lo->data_size != hi->data_size || lo->data_size == 0 || lo->data_size % sizeof(float) != 0) {
+        return false;
+    }
+
+    float weight = (float)((double)(timestamp - lo->timestamp) / (double)(hi->timestamp - lo->timestamp));
+    const float* a = lo->data;
+    const float* b = hi->data;
+    size_t n = lo->data_size / sizeof(float);
+    for (size_t i = 0; i < n; i++) {
+        ring->scratch[i] = a[i] + (b[i] - a[i]) * weight;
+    }
+
+    *out = *lo;
+    out->data = ring->scratch;
+    out->timestamp = timestamp;
+    return true;
+}
+
+/*
+ * 为锚点时间 t 从一个源中选择样本。时间戳单调，所以只需看 t 前最后一个样本（lo）
+ * 和 t 后第一个样本（hi）；更早的样本对以后的锚点也不会更近，直接丢弃。
+ * 返回 0 选中，MULTIMODAL_SYNC_PENDING 需要等待更多数据，-1 没有容差内的样本。
+ */
+static int select_sample(struct multimodal_sync_internal_t* sync, uint32_t source, uint64_t t, bool expired) {
+    sync_ring_t* ring = &sync->rings[source];
+    uint32_t n = ring_count(ring);
+
+    while (n >= 2 && ring_at(ring, 1)->timestamp <= t) {
+        ring_pop(ring);
+        ring->dropped_stale++;
+        n--;
+    }
+    // 插值的源保留两倍容差内的前一个样本
+    uint64_t keep = ring->interpolate ? 2 * sync->tolerance : sync->tolerance;
+    while (n >= 1 && ring_at(ring, 0)->timestamp < t && t - ring_at(ring, 0)->timestamp > keep) {
+        ring_pop(ring);
+        ring->dropped_stale++;
+        n--;
+    }
+    if (n == 0) {
+        return expired ? -1 : MULTIMODAL_SYNC_PENDING;
+    }
+
+    const ModalityData* first = ring_at(ring, 0);
+    const ModalityData* lo = first->timestamp <= t ? first : NULL;
+    const ModalityData* hi = lo ? (n >= 2 ? ring_at(ring, 1) : NULL) : first;
+
+    // 还没有 t 之后的样本时，更近的样本可能还在路上
+    if (!hi && lo->timestamp != t && !expired) {
+        return MULTIMODAL_SYNC_PENDING;
+    }
+
+    ModalityData* choice = &sync->choices[source];
+    // 前后样本间隔不超过两倍容差时，较近的一个一定在容差内，插值结果可信
+    if (ring->interpolate && lo && hi && lo->timestamp < t && hi->timestamp - lo->timestamp <= 2 * sync->tolerance &&
+        interpolate_sample(ring, lo, hi, t, choice)) {
+        sync->errors[source] = 0;
+        ring->interpolated++;
+        return 0;
+    }
+
+    const ModalityData* best = lo;
+    if (!best || (hi && distance(hi->timestamp, t) < distance(lo->timestamp, t))) {
+        best = hi;
+    }
+    if (distance(best->timestamp, t) > sync->tolerance) {
+        return -1;
+    }
+
+    *choice = *best;
+    sync->errors[source] = distance(best->timestamp, t);
+    return 0;
+}
+
+int multimodal_sync_poll(multimodal_sync_t sync, MultiModalData** bundle) {
+    if (!sync || !bundle) return -1;
+    *bundle = NULL;
+
+    sync_ring_t* reference = &sync->rings[sync->reference];
+    for (;;) {
+        uint32_t n = ring_count(reference);
+        if (n == 0) return MULTIMODAL_SYNC_PENDING;
+
+        const ModalityData* anchor = ring_at(reference, 0);
+        uint64_t t = anchor->timestamp;
+        bool expired = ring_at(reference, n - 1)->timestamp - t >= sync->max_latency;
+
+        int result = 0;
+        for (uint32_t i = 0; i < sync->count && result == 0; i++) {
+            if (i == sync->reference) continue;
+            result = select_sample(sync, i, t, expired);
+        }
+        if (result == MULTIMODAL_SYNC_PENDING) return MULTIMODAL_SYNC_PENDING;
+        if (result != 0) {
+            // 某个源在容差内没有样本，放弃这个锚点
+            ring_pop(reference);
+            sync->unmatched++;
+            continue;
+        }
+
+        sync->choices[sync->reference] = *anchor;
+        sync->errors[sync->reference] = 0;
+
+        // 复制到输出容器后才释放参考源的槽位
+        multimodal_data_clear(sync->output);
+        for (uint32_t i = 0; i < sync->count; i++) {
+            if (multimodal_data_add(sync->output, &sync->choices[i]) != 0) {
+                LOG_ERROR("复制对齐样本失败");
+                return -1;
+            }
+
+            sync_ring_t* ring = &sync->rings[i];
+            ring->matched++;
+            ring->error_sum += (double)sync->errors[i];
+            if (sync->errors[i] > ring->max_error) ring->max_error = sync->errors[i];
+        }
+        ring_pop(reference);
+
+        sync->bundles++;
+        *bundle = sync->output;
+        return 0;
+    }
+}
+
+int multimodal_sync_get_stats(multimodal_sync_t sync, multimodal_sync_stats_t* stats) {
+    if (!sync || !stats) return -1;
+
+    stats->bundles = sync->bundles;
+    stats->unmatched = sync->unmatched;
+    return 0;
+}
+
+int multimodal_sync_get_source_stats(multimodal_sync_t sync, uint32_t source,
+                                     multimodal_sync_source_stats_t* stats) {
+    if (!sync || source >= sync->count || !stats) return -1;
+
+    const sync_ring_t* ring = &sync->rings[source];
+    stats->pushed = atomic_load_explicit(&ring->pushed, memory_order_relaxed);
+    stats->dropped_overflow = atomic_load_explicit(&ring->dropped_overflow, memory_order_relaxed);
+    stats->dropped_stale = ring->dropped_stale;
+    stats->matched = ring->matched;
+    stats->interpolated = ring->interpolated;
+    stats->max_error = ring->max_error;
+    stats->mean_error = ring->matched ? ring->error_sum / (double)ring->matched : 0.0;
+    return 0;
+}
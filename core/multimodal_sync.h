@@ -0,0 +1,140 @@
+#ifndef MODYN_CORE_MULTIMODAL_SYNC_H
+#define MODYN_CORE_MULTIMODAL_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "core/multimodal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 多传感器时间戳对齐
+ *
+ * 每个数据源一个单生产者单消费者的无锁环形缓冲区，槽位和数据缓冲区在创建时一次分配，
+ * 内存占用固定。以参考源（通常是最慢的传感器，例如相机）的每个样本为锚点，
+ * 在其他各源中选择时间戳最接近的样本，误差超过容差时丢弃该锚点；
+ * 设置了插值的源（FLOAT32 传感器数值）在锚点前后两个样本间隔不超过两倍容差时线性插值。
+ *
+ * 线程约定：每个数据源只能有一个线程调用 multimodal_sync_push，
+ * multimodal_sync_poll 和统计接口只能由一个消费线程调用。
+ * 所有时间戳使用同一单位（与 ModalityData::timestamp 一致），每个源内必须单调不减。
+ */
+
+/**
+ * @brief multimodal_sync_poll 的返回值：暂时没有可以输出的对齐结果
+ */
+#define MULTIMODAL_SYNC_PENDING 1
+
+/**
+ * @brief 数据源配置
+ */
+typedef struct {
+    const char* source_id;          /**< 数据源ID（复制，输出样本使用该ID） */
+    modality_type_e modality;       /**< 模态类型 */
+    uint32_t capacity;              /**< 环形缓冲区槽位数（向上取2的幂，0表示16） */
+    size_t max_sample_size;         /**< 单个样本最大字节数（数据加元数据字符串） */
+    bool interpolate;               /**< 对 FLOAT32 数据在前后两个样本之间线性插值 */
+} multimodal_sync_source_t;
+
+/**
+ * @brief 对齐配置
+ */
+typedef struct {
+    uint32_t reference;             /**< 参考源下标 */
+    uint64_t tolerance;             /**< 最大对齐误差 */
+    uint64_t max_latency;           /**< 参考源的新样本领先锚点超过该值时不再等待其他源（0表示等于 tolerance） */
+} multimodal_sync_config_t;
+
+/**
+ * @brief 单个数据源的统计
+ */
+typedef struct {
+    uint64_t pushed;                /**< 入队的样本数 */
+    uint64_t dropped_overflow;      /**< 缓冲区满、样本过大或时间戳倒退而丢弃的样本数 */
+    uint64_t dropped_stale;         /**< 过期未被使用而丢弃的样本数 */
+    uint64_t matched;               /**< 输出的样本数 */
+    uint64_t interpolated;          /**< 其中插值得到的样本数 */
+    uint64_t max_error;             /**< 最大对齐误差 */
+    double mean_error;              /**< 平均对齐误差（插值样本按0计） */
+} multimodal_sync_source_stats_t;
+
+/**
+ * @brief 总体统计
+ */
+typedef struct {
+    uint64_t bundles;               /**< 输出的对齐结果数 */
+    uint64_t unmatched;             /**< 因某个源没有容差内的样本而丢弃的锚点数 */
+} multimodal_sync_stats_t;
+
+/**
+ * @brief 对齐器句柄
+ */
+typedef struct multimodal_sync_internal_t* multimodal_sync_t;
+
+/**
+ * @brief 创建对齐器
+ *
+ * @param sources 数据源配置数组
+ * @param count 数据源数量
+ * @param config 对齐配置
+ * @return multimodal_sync_t 对齐器实例，失败返回NULL
+ */
+multimodal_sync_t multimodal_sync_create(const multimodal_sync_source_t* sources, uint32_t count,
+                                         const multimodal_sync_config_t* config);
+
+/**
+ * @brief 销毁对齐器
+ *
+ * @param sync 对齐器实例
+ */
+void multimodal_sync_destroy(multimodal_sync_t sync);
+
+/**
+ * @brief 写入一个样本（复制到环形缓冲区，不分配内存）
+ *
+ * @param sync 对齐器实例
+ * @param source 数据源下标
+ * @param sample 样本（模态、数据、形状、类型、元数据和时间戳）
+ * @return int 0成功，其他失败（缓冲区满、样本过大或时间戳倒退时丢弃并计数）
+ */
+int multimodal_sync_push(multimodal_sync_t sync, uint32_t source, const ModalityData* sample);
+
+/**
+ * @brief 取出下一个对齐结果
+ *
+ * 结果按数据源顺序包含每个源的一个样本，时间戳为各样本自己的时间戳（插值样本为锚点时间戳）。
+ *
+ * @param sync 对齐器实例
+ * @param bundle 输出对齐结果（归对齐器所有，下次调用 multimodal_sync_poll 前有效）
+ * @return int 0成功，MULTIMODAL_SYNC_PENDING 暂无结果，其他失败
+ */
+int multimodal_sync_poll(multimodal_sync_t sync, MultiModalData** bundle);
+
+/**
+ * @brief 获取总体统计
+ *
+ * @param sync 对齐器实例
+ * @param stats 输出统计
+ * @return int 0成功，其他失败
+ */
+int multimodal_sync_get_stats(multimodal_sync_t sync, multimodal_sync_stats_t* stats);
+
+/**
+ * @brief 获取数据源统计
+ *
+ * @param sync 对齐器实例
+ * @param source 数据源下标
+ * @param stats 输出统计
+ * @return int 0成功，其他失败
+ */
+int multimodal_sync_get_source_stats(multimodal_sync_t sync, uint32_t source,
+                                     multimodal_sync_source_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_CORE_MULTIMODAL_SYNC_H
@@ -0,0 +1,500 @@
+#include "core/tensor_file.h"
+#include "utils/logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const uint8_t TENSOR_FILE_MAGIC[8] = { 'M', 'D', 'Y', 'N', 'T', 'N', 'S', 'R' };
+
+#define TENSOR_FILE_HEADER_SIZE 64
+#define TENSOR_FILE_ENTRY_SIZE 80
+
+/*
+ * 文件头（64 字节）：
+ *   0  magic[8]      8  version u32     12 tensor_count u32
+ *   16 index_offset u64                 24 index_size u64
+ *   32 file_size u64                    40 保留（填0）
+ *
+ * 索引记录（80 字节）：
+ *   0  offset u64    8  size u64        16 dtype u32       20 format u32
+ *   24 ndim u32      28 dims[8] u32     60 name_offset u32 64 name_length u32
+ *   68 保留（填0）
+ *
+ * 名称表紧跟在全部记录之后，每个名称以 '\0' 结尾。
+ */
+
+typedef struct {
+    uint64_t offset;
+    uint64_t size;
+    tensor_data_type_e dtype;
+    tensor_format_e format;
+    tensor_shape_t shape;
+    uint32_t name_offset;
+    uint32_t name_length;
+} file_entry_t;
+
+struct tensor_file_writer_internal_t {
+    FILE* fp;
+    char* path;
+    char* temp_path;
+    uint64_t position;
+    file_entry_t* entries;
+    uint32_t count;
+    uint32_t capacity;
+    char* names;
+    size_t names_size;
+    size_t names_capacity;
+    bool failed;
+};
+
+struct tensor_file_internal_t {
+    uint8_t* base;
+    size_t map_size;
+    file_entry_t* entries;
+    uint32_t count;
+    const char* names;
+};
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+// 张量数据按原样存储，零拷贝读取要求主机为小端
+static bool host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static bool dtype_supported(tensor_data_type_e dtype) {
+    return dtype != TENSOR_TYPE_STRING && tensor_get_dtype_size(dtype) > 0;
+}
+
+// 按形状计算数据大小（与 tensor_get_element_count 一致，0维为空），溢出时返回 false
+static bool shape_bytes(tensor_data_type_e dtype, const tensor_shape_t* shape, uint64_t* bytes) {
+    uint64_t total = shape->ndim ? tensor_get_dtype_size(dtype) : 0;
+    for (uint32_t i = 0; i < shape->ndim; i++) {
+        if (shape->dims[i] != 0 && total > UINT64_MAX / shape->dims[i]) {
+            return false;
+        }
+        total *= shape->dims[i];
+    }
+    *bytes = total;
+    return true;
+}
+
+static int writer_write(tensor_file_writer_t writer, const void* data, size_t size) {
+    if (size > 0 && fwrite(data, 1, size, writer->fp) != size) {
+        LOG_ERROR("写入张量文件失败: %s", writer->temp_path);
+        writer->failed = true;
+        return -1;
+    }
+    writer->position += size;
+    return 0;
+}
+
+static int writer_pad(tensor_file_writer_t writer) {
+    static const uint8_t zeros[TENSOR_FILE_ALIGNMENT] = {0};
+    size_t pad = (size_t)((TENSOR_FILE_ALIGNMENT - writer->position % TENSOR_FILE_ALIGNMENT) % TENSOR_FILE_ALIGNMENT);
+    return writer_write(writer, zeros, pad);
+}
+
+static void writer_free(tensor_file_writer_t writer) {
+    free(writer->entries);
+    free(writer->names);
+    free(writer->temp_path);
+    free(writer->path);
+    free(writer);
+}
+
+tensor_file_writer_t tensor_file_writer_create(const char* path) {
+    if (!path) {
+        LOG_ERROR("张量文件路径为空");
+        return NULL;
+    }
+
+    tensor_file_writer_t writer = calloc(1, sizeof(*writer));
+    if (!writer) {
+        return NULL;
+    }
+
+    size_t length = strlen(path);
+    writer->path = strdup(path);
+    writer->temp_path = malloc(length + 5);
+    if (!writer->path || !writer->temp_path) {
+        writer_free(writer);
+        return NULL;
+    }
+    memcpy(writer->temp_path, path, length);
+    memcpy(writer->temp_path + length, ".tmp", 5);
+
+    writer->fp = fopen(writer->temp_path, "wb");
+    if (!writer->fp) {
+        LOG_ERROR("无法创建张量文件: %s", writer->temp_path);
+        writer_free(writer);
+        return NULL;
+    }
+
+    // 文件头在关闭时回填
+    uint8_t header[TENSOR_FILE_HEADER_SIZE] = {0};
+    if (writer_write(writer, header, sizeof(header)) != 0) {
+        fclose(writer->fp);
+        unlink(writer->temp_path);
+        writer_free(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+int tensor_file_writer_add(tensor_file_writer_t writer, const char* name, const tensor_t* tensor) {
+    if (!writer || !tensor || writer->failed) {
+        return -1;
+    }
+
+    if (!name) {
+        name = tensor->name;
+    }
+    if (!name || name[0] == '\0') {
+        LOG_ERROR("张量名称为空");
+        return -1;
+    }
+    for (uint32_t i = 0; i < writer->count; i++) {
+        if (strcmp(writer->names + writer->entries[i].name_offset, name) == 0) {
+            LOG_ERROR("张量名称重复: %s", name);
+            return -1;
+        }
+    }
+
+    if (!dtype_supported(tensor->dtype) || tensor->shape.ndim > TENSOR_MAX_DIMS) {
+        LOG_ERROR("张量 %s 的类型或维度不支持", name);
+        return -1;
+    }
+
+    uint64_t bytes = 0;
+    if (!shape_bytes(tensor->dtype, &tensor->shape, &bytes) || bytes != tensor->size ||
+        (bytes > 0 && !tensor->data)) {
+        LOG_ERROR("张量 %s 的数据大小与形状不符", name);
+        return -1;
+    }
+
+    size_t name_length = strlen(name);
+    if (writer->names_size + name_length + 1 > UINT32_MAX) {
+        LOG_ERROR("张量名称表过大");
+        return -1;
+    }
+
+    if (writer->count == writer->capacity) {
+        uint32_t capacity = writer->capacity ? writer->capacity * 2 : 16;
+        file_entry_t* entries = realloc(writer->entries, capacity * sizeof(file_entry_t));
+        if (!entries) {
+            return -1;
+        }
+        writer->entries = entries;
+        writer->capacity = capacity;
+    }
+    if (writer->names_size + name_length + 1 > writer->names_capacity) {
+        size_t capacity = writer->names_capacity ? writer->names_capacity * 2 : 256;
+        while (capacity < writer->names_size + name_length + 1) {
+            capacity *= 2;
+        }
+        char* names = realloc(writer->names, capacity);
+        if (!names) {
+            return -1;
+        }
+        writer->names = names;
+        writer->names_capacity = capacity;
+    }
+
+    if (writer_pad(writer) != 0) {
+        return -1;
+    }
+
+    file_entry_t* entry = &writer->entries[writer->count];
+    entry->offset = writer->position;
+    entry->size = bytes;
+    entry->dtype = tensor->dtype;
+    entry->format = tensor->format;
+    entry->shape = tensor->shape;
+    entry->name_offset = (uint32_t)writer->names_size;
+    entry->name_length = (uint32_t)name_length;
+
+    if (writer_write(writer, tensor->data, (size_t)bytes) != 0) {
+        return -1;
+    }
+
+    memcpy(writer->names + writer->names_size, name, name_length + 1);
+    writer->names_size += name_length + 1;
+    writer->count++;
+    return 0;
+}
+
+int tensor_file_writer_close(tensor_file_writer_t writer) {
+    if (!writer) {
+        return -1;
+    }
+
+    int ret = writer->failed ? -1 : writer_pad(writer);
+    uint64_t index_offset = writer->position;
+
+    for (uint32_t i = 0; ret == 0 && i < writer->count; i++) {
+        const file_entry_t* entry = &writer->entries[i];
+        uint8_t record[TENSOR_FILE_ENTRY_SIZE] = {0};
+        put_u64(record + 0, entry->offset);
+        put_u64(record + 8, entry->size);
+        put_u32(record + 16, (uint32_t)entry->dtype);
+        put_u32(record + 20, (uint32_t)entry->format);
+        put_u32(record + 24, entry->shape.ndim);
+        for (uint32_t d = 0; d < entry->shape.ndim; d++) {
+            put_u32(record + 28 + 4 * d, entry->shape.dims[d]);
+        }
+        put_u32(record + 60, entry->name_offset);
+        put_u32(record + 64, entry->name_length);
+        ret = writer_write(writer, record, sizeof(record));
+    }
+    if (ret == 0) {
+        ret = writer_write(writer, writer->names, writer->names_size);
+    }
+
+    if (ret == 0) {
+        uint8_t header[TENSOR_FILE_HEADER_SIZE] = {0};
+        memcpy(header, TENSOR_FILE_MAGIC, sizeof(TENSOR_FILE_MAGIC));
+        put_u32(header + 8, TENSOR_FILE_VERSION);
+        put_u32(header + 12, writer->count);
+        put_u64(header + 16, index_offset);
+        put_u64(header + 24, writer->position - index_offset);
+        put_u64(header + 32, writer->position);
+        if (fseek(writer->fp, 0, SEEK_SET) != 0 ||
+            fwrite(header, 1, sizeof(header), writer->fp) != sizeof(header) ||
+            fflush(writer->fp) != 0) {
+            LOG_ERROR("写入张量文件头失败: %s", writer->temp_path);
+            ret = -1;
+        }
+    }
+
+    if (fclose(writer->fp) != 0) {
+        ret = -1;
+    }
+    if (ret == 0 && rename(writer->temp_path, writer->path) != 0) {
+        LOG_ERROR("无法生成张量文件: %s", writer->path);
+        ret = -1;
+    }
+    if (ret != 0) {
+        unlink(writer->temp_path);
+    }
+
+    writer_free(writer);
+    return ret;
+}
+
+int tensor_file_save(const char* path, const tensor_t* tensors, uint32_t count) {
+    if (!tensors && count > 0) {
+        return -1;
+    }
+
+    tensor_file_writer_t writer = tensor_file_writer_create(path);
+    if (!writer) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (tensor_file_writer_add(writer, NULL, &tensors[i]) != 0) {
+            writer->failed = true;
+            break;
+        }
+    }
+
+    return tensor_file_writer_close(writer);
+}
+
+// 解析并校验索引，所有偏移都限制在映射范围内
+static int parse_index(tensor_file_t file, const char* path) {
+    const uint8_t* header = file->base;
+    if (memcmp(header, TENSOR_FILE_MAGIC, sizeof(TENSOR_FILE_MAGIC)) != 0) {
+        LOG_ERROR("不是张量文件: %s", path);
+        return -1;
+    }
+
+    uint32_t version = get_u32(header + 8);
+    if (version != TENSOR_FILE_VERSION) {
+        LOG_ERROR("不支持的张量文件版本 %u: %s", version, path);
+        return -1;
+    }
+
+    uint32_t count = get_u32(header + 12);
+    uint64_t index_offset = get_u64(header + 16);
+    uint64_t index_size = get_u64(header + 24);
+    uint64_t file_size = get_u64(header + 32);
+    uint64_t records = (uint64_t)count * TENSOR_FILE_ENTRY_SIZE;
+
+    if (file_size != file->map_size || index_offset < TENSOR_FILE_HEADER_SIZE ||
+        index_offset > file_size || index_size != file_size - index_offset || records > index_size) {
+        LOG_ERROR("张量文件索引损坏或文件不完整: %s", path);
+        return -1;
+    }
+
+    const uint8_t* index = file->base + index_offset;
+    const char* names = (const char*)(index + records);
+    uint64_t names_size = index_size - records;
+
+    file->entries = count ? calloc(count, sizeof(file_entry_t)) : NULL;
+    if (count && !file->entries) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* record = index + (size_t)i * TENSOR_FILE_ENTRY_SIZE;
+        file_entry_t* entry = &file->entries[i];
+        entry->offset = get_u64(record + 0);
+        entry->size = get_u64(record + 8);
+        entry->dtype = (tensor_data_type_e)get_u32(record + 16);
+        entry->format = (tensor_format_e)get_u32(record + 20);
+        entry->shape.ndim = get_u32(record + 24);
+        entry->name_offset = get_u32(record + 60);
+        entry->name_length = get_u32(record + 64);
+
+        uint64_t bytes = 0;
+        bool valid = entry->shape.ndim <= TENSOR_MAX_DIMS && dtype_supported(entry->dtype) &&
+                     entry->format <= TENSOR_FORMAT_N;
+        if (valid) {
+            for (uint32_t d = 0; d < entry->shape.ndim; d++) {
+                entry->shape.dims[d] = get_u32(record + 28 + 4 * d);
+            }
+            valid = shape_bytes(entry->dtype, &entry->shape, &bytes) && bytes == entry->size;
+        }
+        valid = valid && entry->offset % TENSOR_FILE_ALIGNMENT == 0 && entry->offset >= TENSOR_FILE_HEADER_SIZE &&
+                entry->offset <= index_offset && entry->size <= index_offset - entry->offset;
+        valid = valid && (uint64_t)entry->name_offset + entry->name_length < names_size &&
+                names[entry->name_offset + entry->name_length] == '\0' &&
+                memchr(names + entry->name_offset, '\0', entry->name_length) == NULL;
+        if (!valid) {
+            LOG_ERROR("张量文件第 %u 个索引记录无效: %s", i, path);
+            return -1;
+        }
+    }
+
+    file->count = count;
+    file->names = names;
+    return 0;
+}
+
+tensor_file_t tensor_file_open(const char* path) {
+    if (!path) {
+        return NULL;
+    }
+    if (!host_is_little_endian()) {
+        LOG_ERROR("张量文件仅支持小端主机");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("无法打开张量文件: %s", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < TENSOR_FILE_HEADER_SIZE) {
+        LOG_ERROR("张量文件过小: %s", path);
+        close(fd);
+        return NULL;
+    }
+
+    tensor_file_t file = calloc(1, sizeof(*file));
+    if (!file) {
+        close(fd);
+        return NULL;
+    }
+
+    file->map_size = (size_t)st.st_size;
+    void* base = mmap(NULL, file->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR("无法映射张量文件: %s", path);
+        free(file);
+        return NULL;
+    }
+    file->base = base;
+
+    if (parse_index(file, path) != 0) {
+        tensor_file_close(file);
+        return NULL;
+    }
+
+    return file;
+}
+
+void tensor_file_close(tensor_file_t file) {
+    if (!file) {
+        return;
+    }
+    if (file->base) {
+        munmap(file->base, file->map_size);
+    }
+    free(file->entries);
+    free(file);
+}
+
+uint32_t tensor_file_get_count(tensor_file_t file) {
+    return file ? file->count : 0;
+}
+
+int tensor_file_get_entry(tensor_file_t file, uint32_t index, tensor_file_entry_t* entry) {
+    if (!file || !entry || index >= file->count) {
+        return -1;
+    }
+
+    const file_entry_t* source = &file->entries[index];
+    entry->name = file->names + source->name_offset;
+    entry->dtype = source->dtype;
+    entry->format = source->format;
+    entry->shape = source->shape;
+    entry->offset = source->offset;
+    entry->size = source->size;
+    return 0;
+}
+
+int tensor_file_find(tensor_file_t file, const char* name) {
+    if (!file || !name) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < file->count; i++) {
+        if (strcmp(file->names + file->entries[i].name_offset, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int tensor_file_get_tensor(tensor_file_t file, uint32_t index, tensor_t* tensor) {
+    if (!file || !tensor || index >= file->count) {
+        return -1;
+    }
+
+    const file_entry_t* entry = &file->entries[index];
+    // 映射为只读，数据指针仅供读取
+    *tensor = tensor_from_data(file->names + entry->name_offset, entry->dtype, &entry->shape, entry->format,
+                               file->base + entry->offset, (size_t)entry->size, false);
+    tensor->memory_type = TENSOR_MEMORY_EXTERNAL;
+    return 0;
+}
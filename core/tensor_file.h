@@ -0,0 +1,154 @@
+#ifndef MODYN_CORE_TENSOR_FILE_H
+#define MODYN_CORE_TENSOR_FILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "core/tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 张量文件（多个命名张量的对齐存储，可内存映射）
+ *
+ * 布局（小端）：
+ * - 64 字节文件头：魔数、版本、张量数量、索引偏移和大小、文件大小
+ * - 各张量数据，起始偏移按 TENSOR_FILE_ALIGNMENT 对齐
+ * - 文件末尾的索引：每个张量一条定长记录（类型、格式、形状、数据偏移和大小、名称位置），随后是名称表
+ *
+ * 读取时整个文件只读映射，张量直接指向映射中的数据（TENSOR_MEMORY_EXTERNAL），不复制。
+ */
+
+/**
+ * @brief 张量数据对齐（字节）
+ */
+#define TENSOR_FILE_ALIGNMENT 64
+
+/**
+ * @brief 当前格式版本
+ */
+#define TENSOR_FILE_VERSION 1
+
+/**
+ * @brief 张量文件写入器句柄
+ */
+typedef struct tensor_file_writer_internal_t* tensor_file_writer_t;
+
+/**
+ * @brief 已映射的张量文件句柄
+ */
+typedef struct tensor_file_internal_t* tensor_file_t;
+
+/**
+ * @brief 张量文件中一个张量的描述
+ */
+typedef struct {
+    const char* name;               /**< 名称（指向映射内存，文件关闭前有效） */
+    tensor_data_type_e dtype;       /**< 数据类型 */
+    tensor_format_e format;         /**< 数据格式 */
+    tensor_shape_t shape;           /**< 形状 */
+    uint64_t offset;                /**< 数据在文件中的偏移 */
+    uint64_t size;                  /**< 数据大小（字节） */
+} tensor_file_entry_t;
+
+/**
+ * @brief 创建张量文件写入器
+ *
+ * 先写入 path 对应的临时文件，tensor_file_writer_close 成功后才替换目标文件。
+ *
+ * @param path 文件路径
+ * @return tensor_file_writer_t 写入器实例，失败返回NULL
+ */
+tensor_file_writer_t tensor_file_writer_create(const char* path);
+
+/**
+ * @brief 追加一个张量（数据立即写出）
+ *
+ * @param writer 写入器实例
+ * @param name 张量名称（NULL 时使用 tensor->name，文件内须唯一）
+ * @param tensor 张量（不支持字符串类型）
+ * @return int 0成功，其他失败
+ */
+int tensor_file_writer_add(tensor_file_writer_t writer, const char* name, const tensor_t* tensor);
+
+/**
+ * @brief 写入索引并关闭写入器（无论成功与否都会释放写入器）
+ *
+ * @param writer 写入器实例
+ * @return int 0成功，其他失败（失败时不会生成目标文件）
+ */
+int tensor_file_writer_close(tensor_file_writer_t writer);
+
+/**
+ * @brief 把一组张量保存为张量文件
+ *
+ * @param path 文件路径
+ * @param tensors 张量数组（使用各自的名称）
+ * @param count 张量数量
+ * @return int 0成功，其他失败
+ */
+int tensor_file_save(const char* path, const tensor_t* tensors, uint32_t count);
+
+/**
+ * @brief 打开并只读映射张量文件
+ *
+ * 打开时校验文件头、索引范围以及每个张量的对齐、形状和大小。
+ *
+ * @param path 文件路径
+ * @return tensor_file_t 文件实例，失败返回NULL
+ */
+tensor_file_t tensor_file_open(const char* path);
+
+/**
+ * @brief 关闭张量文件（之前取得的张量数据随之失效）
+ *
+ * @param file 文件实例
+ */
+void tensor_file_close(tensor_file_t file);
+
+/**
+ * @brief 获取张量数量
+ *
+ * @param file 文件实例
+ * @return uint32_t 张量数量
+ */
+uint32_t tensor_file_get_count(tensor_file_t file);
+
+/**
+ * @brief 获取张量描述
+ *
+ * @param file 文件实例
+ * @param index 张量下标
+ * @param entry 输出描述
+ * @return int 0成功，其他失败
+ */
+int tensor_file_get_entry(tensor_file_t file, uint32_t index, tensor_file_entry_t* entry);
+
+/**
+ * @brief 按名称查找张量下标
+ *
+ * @param file 文件实例
+ * @param name 张量名称
+ * @return int 张量下标，未找到返回-1
+ */
+int tensor_file_find(tensor_file_t file, const char* name);
+
+/**
+ * @brief 取得零拷贝张量
+ *
+ * 张量数据指向映射内存（owns_data 为 false），名称为副本，用完后用 tensor_free 释放名称。
+ *
+ * @param file 文件实例
+ * @param index 张量下标
+ * @param tensor 输出张量
+ * @return int 0成功，其他失败
+ */
+int tensor_file_get_tensor(tensor_file_t file, uint32_t index, tensor_t* tensor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_CORE_TENSOR_FILE_H
@@ -1,11 +1,16 @@
 #include#include "core/unified_pipeline.h"
 #include "core/inference_engine.h"
 #include "utils/logger.h"
+#include "utils/audio_utils.h"
+#include "utils/tokenizer.h"
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
 #include <sys/time.h>
 
+// 文本预处理输出的最大 token 数
+#define TEXT_PREPROCESS_MAX_TOKENS 512
+
 // ================================
 // Tensor Map 实现
 // ================================
@@ -654,20 +659,46 @@ int text_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, void
         return -1;
     }
     
-    // 创建token tensor（简化实现）
-    uint32_t token_dims[] = {1, 512}; // 假设最大512个token
+    // context 为分词器实例；文本可以是单个字符串或 UTF-8 字节序列
+    tokenizer_t tokenizer = (tokenizer_t)context;
+    if (!tokenizer || !text->data) {
+        LOG_ERROR("Text preprocessing requires a tokenizer");
+        return -1;
+    }
+    
+    const char* str = (const char*)text->data;
+    size_t length = text->size;
+    if (text->dtype == TENSOR_TYPE_STRING) {
+        str = *(const char* const*)text->data;
+        length = str ? strlen(str) : 0;
+    }
+    
+    uint32_t token_dims[] = {1, TEXT_PREPROCESS_MAX_TOKENS};
     tensor_shape_t token_shape = tensor_shape_create(token_dims, 2);
     tensor_t* tokens = malloc(sizeof(tensor_t));
+    if (!tokens) {
+        return -1;
+    }
     *tokens = tensor_create("tokens", TENSOR_TYPE_INT32, &token_shape, TENSOR_FORMAT_NC);
     
     tokens->data = malloc(tokens->size);
     tokens->owns_data = true;
+    if (!tokens->data) {
+        free(tokens);
+        return -1;
+    }
     
-    // 这里应该进行实际的文本预处理：分词、编码等
-    // 暂时填充虚拟token
     int32_t* token_data = (int32_t*)tokens->data;
-    for (uint32_t i = 0; i < 512; i++) {
-        token_data[i] = rand() % 30000; // 假设词汇表大小为30000
+    uint32_t count = 0;
+    if (tokenizer_encode(tokenizer, str, length, token_data, TEXT_PREPROCESS_MAX_TOKENS, &count) != 0) {
+        tensor_free(tokens);
+        free(tokens);
+        return -1;
+    }
+    
+    int32_t pad = tokenizer_get_pad_id(tokenizer);
+    for (uint32_t i = count; i < TEXT_PREPROCESS_MAX_TOKENS; i++) {
+        token_data[i] = pad;
     }
     
     tensor_map_set((tensor_map_t*)outputs, "tokens", tokens);
@@ -675,14 +706,53 @@ int text_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, void
     return 0;
 }
 
+// 默认的对数梅尔前端（16kHz，80 个梅尔频带），首次使用时创建
+static audio_frontend_t g_default_audio_frontend = NULL;
+static pthread_once_t g_default_audio_once = PTHREAD_ONCE_INIT;
+
+static void create_default_audio_frontend(void) {
+    audio_frontend_config_t config = audio_frontend_default_config(AUDIO_FEATURE_MEL);
+    g_default_audio_frontend = audio_frontend_create(&config);
+}
+
 int audio_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, void* context) {
     tensor_t* audio = tensor_map_get(inputs, "audio");
-    if (!audio) {
+    if (!audio || !audio->data || audio->dtype != TENSOR_TYPE_FLOAT32) {
+        return -1;
+    }
+    
+    // context 可传入自定义的音频前端，否则使用默认的对数梅尔谱
+    audio_frontend_t frontend = (audio_frontend_t)context;
+    if (!frontend) {
+        pthread_once(&g_default_audio_once, create_default_audio_frontend);
+        frontend = g_default_audio_frontend;
+    }
+    if (!frontend) {
+        return -1;
+    }
+    
+    size_t num_samples = audio->size / sizeof(float);
+    uint32_t num_frames = audio_frontend_get_frame_count(frontend, num_samples);
+    uint32_t dim = audio_frontend_get_feature_dim(frontend);
+    if (num_frames == 0) {
+        LOG_ERROR("Audio input of %zu samples is shorter than one frame", num_samples);
         return -1;
     }
     
-    // 创建特征tensor（简化实现）
-    uint32_t feature_dims[] = {1, 80, 100}; // 假设80个mel频段，100帧
+    float* frames = malloc(sizeof(float) * num_frames * dim);
+    if (!frames) {
+        return -1;
+    }
+    
+    uint32_t produced = 0;
+    if (audio_frontend_compute(frontend, (const float*)audio->data, num_samples, frames,
+                               num_frames, &produced) != 0) {
+        free(frames);
+        return -1;
+    }
+    
+    // 模型输入布局为 [1, 特征维度, 帧]
+    uint32_t feature_dims[] = {1, dim, num_frames};
     tensor_shape_t feature_shape = tensor_shape_create(feature_dims, 3);
     tensor_t* features = malloc(sizeof(tensor_t));
     *features = tensor_create("features", TENSOR_TYPE_FLOAT32, &feature_shape, TENSOR_FORMAT_NCHW);
@@ -690,12 +760,13 @@ int audio_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, voi
     features->data = malloc(features->size);
     features->owns_data = true;
     
-    // 这里应该进行实际的音频预处理：重采样、MFCC/Mel谱等
-    // 暂时填充虚拟特征
     float* feature_data = (float*)features->data;
-    for (uint32_t i = 0; i < 80 * 100; i++) {
-        feature_data[i] = (float)(rand() % 1000) / 1000.0f;
+    for (uint32_t t = 0; t < num_frames; t++) {
+        for (uint32_t d = 0; d < dim; d++) {
+            feature_data[(size_t)d * num_frames + t] = frames[(size_t)t * dim + d];
+        }
     }
+    free(frames);
     
     tensor_map_set((tensor_map_t*)outputs, "features", features);
     
@@ -765,11 +836,16 @@ int audio_postprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, vo
 }"core/unified_pipeline.h"
 #include "core/inference_engine.h"
 #include "utils/logger.h"
+#include "utils/audio_utils.h"
+#include "utils/tokenizer.h"
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
 #include <sys/time.h>
 
+// 文本预处理输出的最大 token 数
+#define TEXT_PREPROCESS_MAX_TOKENS 512
+
 // ================================
 // Tensor Map 实现
 // ================================
@@ -1683,20 +1759,46 @@ int text_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, void
         return -1;
     }
     
-    // 创建token tensor（简化实现）
-    uint32_t token_dims[] = {1, 512}; // 假设最大512个token
+    // context 为分词器实例；文本可以是单个字符串或 UTF-8 字节序列
+    tokenizer_t tokenizer = (tokenizer_t)context;
+    if (!tokenizer || !text->data) {
+        LOG_ERROR("Text preprocessing requires a tokenizer");
+        return -1;
+    }
+    
+    const char* str = (const char*)text->data;
+    size_t length = text->size;
+    if (text->dtype == TENSOR_TYPE_STRING) {
+        str = *(const char* const*)text->data;
+        length = str ? strlen(str) : 0;
+    }
+    
+    uint32_t token_dims[] = {1, TEXT_PREPROCESS_MAX_TOKENS};
     tensor_shape_t token_shape = tensor_shape_create(token_dims, 2);
     tensor_t* tokens = malloc(sizeof(tensor_t));
+    if (!tokens) {
+        return -1;
+    }
     *tokens = tensor_create("tokens", TENSOR_TYPE_INT32, &token_shape, TENSOR_FORMAT_NC);
     
     tokens->data = malloc(tokens->size);
     tokens->owns_data = true;
+    if (!tokens->data) {
+        free(tokens);
+        return -1;
+    }
     
-    // 这里应该进行实际的文本预处理：分词、编码等
-    // 暂时填充虚拟token
     int32_t* token_data = (int32_t*)tokens->data;
-    for (uint32_t i = 0; i < 512; i++) {
-        token_data[i] = rand() % 30000; // 假设词汇表大小为30000
+    uint32_t count = 0;
+    if (tokenizer_encode(tokenizer, str, length, token_data, TEXT_PREPROCESS_MAX_TOKENS, &count) != 0) {
+        tensor_free(tokens);
+        free(tokens);
+        return -1;
+    }
+    
+    int32_t pad = tokenizer_get_pad_id(tokenizer);
+    for (uint32_t i = count; i < TEXT_PREPROCESS_MAX_TOKENS; i++) {
+        token_data[i] = pad;
     }
     
     tensor_map_set((tensor_map_t*)outputs, "tokens", tokens);
@@ -1704,14 +1806,53 @@ int text_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, void
     return 0;
 }
 
+// 默认的对数梅尔前端（16kHz，80 个梅尔频带），首次使用时创建
+static audio_frontend_t g_default_audio_frontend = NULL;
+static pthread_once_t g_default_audio_once = PTHREAD_ONCE_INIT;
+
+static void create_default_audio_frontend(void) {
+    audio_frontend_config_t config = audio_frontend_default_config(AUDIO_FEATURE_MEL);
+    g_default_audio_frontend = audio_frontend_create(&config);
+}
+
 int audio_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, void* context) {
     tensor_t* audio = tensor_map_get(inputs, "audio");
-    if (!audio) {
+    if (!audio || !audio->data || audio->dtype != TENSOR_TYPE_FLOAT32) {
+        return -1;
+    }
+    
+    // context 可传入自定义的音频前端，否则使用默认的对数梅尔谱
+    audio_frontend_t frontend = (audio_frontend_t)context;
+    if (!frontend) {
+        pthread_once(&g_default_audio_once, create_default_audio_frontend);
+        frontend = g_default_audio_frontend;
+    }
+    if (!frontend) {
+        return -1;
+    }
+    
+    size_t num_samples = audio->size / sizeof(float);
+    uint32_t num_frames = audio_frontend_get_frame_count(frontend, num_samples);
+    uint32_t dim = audio_frontend_get_feature_dim(frontend);
+    if (num_frames == 0) {
+        LOG_ERROR("Audio input of %zu samples is shorter than one frame", num_samples);
         return -1;
     }
     
-    // 创建特征tensor（简化实现）
-    uint32_t feature_dims[] = {1, 80, 100}; // 假设80个mel频段，100帧
+    float* frames = malloc(sizeof(float) * num_frames * dim);
+    if (!frames) {
+        return -1;
+    }
+    
+    uint32_t produced = 0;
+    if (audio_frontend_compute(frontend, (const float*)audio->data, num_samples, frames,
+                               num_frames, &produced) != 0) {
+        free(frames);
+        return -1;
+    }
+    
+    // 模型输入布局为 [1, 特征维度, 帧]
+    uint32_t feature_dims[] = {1, dim, num_frames};
     tensor_shape_t feature_shape = tensor_shape_create(feature_dims, 3);
     tensor_t* features = malloc(sizeof(tensor_t));
     *features = tensor_create("features", TENSOR_TYPE_FLOAT32, &feature_shape, TENSOR_FORMAT_NCHW);
@@ -1719,12 +1860,13 @@ int audio_preprocess_func(const tensor_map_t* inputs, tensor_map_t* outputs, voi
     features->data = malloc(features->size);
     features->owns_data = true;
     
-    // 这里应该进行实际的音频预处理：重采样、MFCC/Mel谱等
-    // 暂时填充虚拟特征
     float* feature_data = (float*)features->data;
-    for (uint32_t i = 0; i < 80 * 100; i++) {
-        feature_data[i] = (float)(rand() % 1000) / 1000.0f;
+    for (uint32_t t = 0; t < num_frames; t++) {
+        for (uint32_t d = 0; d < dim; d++) {
+            feature_data[(size_t)d * num_frames + t] = frames[(size_t)t * dim + d];
+        }
     }
+    free(frames);
     
     tensor_map_set((tensor_map_t*)outputs, "features", features);
     
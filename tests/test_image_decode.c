@@ -0,0 +1,1029 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "core/tensor.h"
+#include "utils/image_decode.h"
+#include "utils/image_utils.h"
+#include "utils/image_loader.h"
+#include "utils/preprocessing.h"
+#include "core/memory_pool.h"
+#include "utils/logger.h"
+
+/**
+ * @brief 内置图像解码单元测试
+ *
+ * JPEG/PNG 样例由外部编码器按下面的像素公式生成，BMP 在测试中直接构造。
+ */
+
+// ==================== 样例数据 ====================
+
+// 21x13 YCbCr 4:2:0 基线
+static const uint8_t k_jpeg_baseline[] = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01,
+    0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03,
+    0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06, 0x07, 0x09,
+    0x07, 0x06, 0x06, 0x08, 0x0b, 0x08, 0x09, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x08, 0x0b, 0x0c,
+    0x0b, 0x0a, 0x0c, 0x09, 0x0a, 0x0a, 0x0a, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x05, 0x03, 0x03, 0x05, 0x0a, 0x07, 0x06, 0x07, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0xff, 0xc0, 0x00, 0x11,
+    0x08, 0x00, 0x0d, 0x00, 0x15, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff,
+    0xc4, 0x00, 0x16, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x07, 0x08, 0x00, 0xff, 0xc4, 0x00, 0x2a, 0x10, 0x00, 0x00, 0x02, 0x05,
+    0x0b, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x01, 0x02,
+    0x08, 0x12, 0x24, 0x04, 0x05, 0x07, 0x11, 0x14, 0x21, 0x22, 0x32, 0x42, 0x51, 0xa2, 0x25, 0x34,
+    0x43, 0x61, 0xa1, 0xff, 0xc4, 0x00, 0x15, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x08, 0xff, 0xc4, 0x00, 0x23, 0x11, 0x00,
+    0x01, 0x02, 0x05, 0x04, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+    0x01, 0x03, 0x00, 0x04, 0x05, 0x07, 0x11, 0x06, 0x12, 0x13, 0x21, 0x08, 0x22, 0x51, 0x71, 0xff,
+    0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0x8a, 0x49, 0x6c,
+    0xed, 0x92, 0x07, 0x6d, 0x21, 0x6c, 0x96, 0xce, 0xd7, 0x29, 0x03, 0xc4, 0x3f, 0x13, 0x28, 0xb4,
+    0xbb, 0x52, 0x89, 0x73, 0x6d, 0x08, 0x0b, 0x64, 0xba, 0x2d, 0x2f, 0x60, 0xc3, 0xc0, 0x54, 0xd2,
+    0x7a, 0x81, 0xce, 0xa0, 0x86, 0xde, 0x5d, 0x69, 0x9f, 0x4e, 0xd6, 0x27, 0x82, 0xfb, 0x3b, 0x41,
+    0x76, 0x1b, 0x69, 0x18, 0x57, 0xb3, 0xb4, 0xc4, 0x5d, 0x27, 0xc8, 0xe4, 0xdd, 0x2a, 0xd3, 0x68,
+    0x7b, 0xc8, 0x85, 0x1d, 0x75, 0xdf, 0x49, 0xaf, 0x37, 0xc1, 0x81, 0xf6, 0xa6, 0xf2, 0x6e, 0xd5,
+    0x68, 0xaa, 0xdb, 0xb4, 0x6a, 0xcd, 0x4b, 0x8a, 0x65, 0xad, 0xbb, 0xc3, 0x85, 0xf2, 0xc6, 0xe1,
+    0x13, 0x1f, 0x60, 0x68, 0x85, 0x72, 0x24, 0x2b, 0xd1, 0x2e, 0x33, 0x85, 0xef, 0x29, 0x15, 0xf5,
+    0x32, 0xe1, 0xd6, 0x26, 0x64, 0x1b, 0x71, 0xb1, 0x55, 0x15, 0x4f, 0xa9, 0xf9, 0xf6, 0x3f, 0xff,
+    0xd9,
+};
+
+// 21x13 YCbCr 4:2:0 渐进式 复位间隔
+static const uint8_t k_jpeg_progressive[] = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01,
+    0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03,
+    0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06, 0x07, 0x09,
+    0x07, 0x06, 0x06, 0x08, 0x0b, 0x08, 0x09, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x08, 0x0b, 0x0c,
+    0x0b, 0x0a, 0x0c, 0x09, 0x0a, 0x0a, 0x0a, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x05, 0x03, 0x03, 0x05, 0x0a, 0x07, 0x06, 0x07, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0xff, 0xc2, 0x00, 0x11,
+    0x08, 0x00, 0x0d, 0x00, 0x15, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff,
+    0xc4, 0x00, 0x16, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x06, 0x07, 0x00, 0xff, 0xc4, 0x00, 0x15, 0x01, 0x01, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x07, 0xff, 0xdd,
+    0x00, 0x04, 0x00, 0x02, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x10, 0x03, 0x10, 0x00,
+    0x00, 0x01, 0x8a, 0x2d, 0x7e, 0xba, 0xa6, 0x42, 0x77, 0xab, 0xf8, 0xf5, 0x7f, 0xff, 0xc4, 0x00,
+    0x1a, 0x10, 0x01, 0x00, 0x02, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0x00, 0x06, 0x02, 0x03, 0x05, 0x22, 0xff, 0xda, 0x00, 0x08, 0x01, 0x01, 0x00,
+    0x01, 0x05, 0x02, 0x15, 0x76, 0x0a, 0xbb, 0x3f, 0xff, 0xd0, 0x3d, 0x77, 0xc0, 0xf9, 0x67, 0x9f,
+    0xff, 0xd1, 0x17, 0x2c, 0xf3, 0x6e, 0x83, 0x8f, 0x0f, 0xff, 0xc4, 0x00, 0x1a, 0x11, 0x00, 0x01,
+    0x05, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    0x03, 0x04, 0x06, 0x21, 0x01, 0xff, 0xda, 0x00, 0x08, 0x01, 0x03, 0x01, 0x01, 0x3f, 0x01, 0xaf,
+    0x5a, 0xdc, 0xc5, 0x1a, 0xc3, 0x31, 0xc6, 0x04, 0x87, 0x98, 0xbf, 0xff, 0xc4, 0x00, 0x20, 0x11,
+    0x00, 0x01, 0x02, 0x06, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x02, 0x04, 0x00, 0x03, 0x05, 0x11, 0x12, 0x31, 0x06, 0x07, 0x21, 0x41, 0xff, 0xda, 0x00,
+    0x08, 0x01, 0x02, 0x01, 0x01, 0x3f, 0x01, 0x93, 0x50, 0x54, 0x54, 0xfb, 0x37, 0x8a, 0xd1, 0x5e,
+    0xa9, 0x9b, 0xc7, 0x38, 0xcc, 0x4d, 0xae, 0x30, 0x59, 0xd8, 0x04, 0x7a, 0x12, 0x46, 0x88, 0xfb,
+    0x1f, 0xff, 0xc4, 0x00, 0x1a, 0x10, 0x00, 0x02, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x02, 0x12, 0x10, 0x23, 0x61, 0xff, 0xda, 0x00,
+    0x08, 0x01, 0x01, 0x00, 0x06, 0x3f, 0x02, 0x41, 0x0f, 0xff, 0xd0, 0x4c, 0x7f, 0xff, 0xd1, 0x23,
+    0xaa, 0xd6, 0xe9, 0xff, 0xc4, 0x00, 0x1c, 0x10, 0x00, 0x02, 0x01, 0x05, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x11, 0x31, 0x51, 0xa1, 0xc1, 0xd1,
+    0xf1, 0xff, 0xda, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x3f, 0x21, 0xa1, 0xa9, 0x43, 0x53, 0xff,
+    0xd0, 0xf0, 0x45, 0xd6, 0x0f, 0xff, 0xd1, 0x49, 0x60, 0xbd, 0x02, 0xc8, 0x88, 0xe9, 0xff, 0xda,
+    0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x00, 0x00, 0x10, 0x63, 0x2f, 0xff, 0xc4,
+    0x00, 0x18, 0x11, 0x01, 0x00, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x00, 0x41, 0x51, 0x71, 0xff, 0xda, 0x00, 0x08, 0x01, 0x03, 0x01, 0x01,
+    0x3f, 0x10, 0xbb, 0x63, 0xb0, 0x51, 0xa7, 0x36, 0x7f, 0xff, 0xc4, 0x00, 0x19, 0x11, 0x00, 0x03,
+    0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x11,
+    0x21, 0x00, 0x31, 0x51, 0xff, 0xda, 0x00, 0x08, 0x01, 0x02, 0x01, 0x01, 0x3f, 0x10, 0x83, 0x78,
+    0xfe, 0xed, 0x74, 0x4c, 0x64, 0x42, 0x4d, 0x1a, 0xc6, 0xff, 0xc4, 0x00, 0x1c, 0x10, 0x00, 0x01,
+    0x04, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x11, 0x91, 0xa1, 0x21, 0x41, 0x61, 0xd1, 0xff, 0xda, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x3f,
+    0x10, 0xa6, 0x18, 0x49, 0xff, 0xd0, 0xa7, 0x0d, 0x17, 0xce, 0xa7, 0xff, 0xd1, 0x0d, 0x84, 0x71,
+    0x10, 0xaf, 0xe0, 0xff, 0xd9,
+};
+
+// 19x10 灰度 基线
+static const uint8_t k_jpeg_gray[] = {
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01,
+    0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03,
+    0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06, 0x07, 0x09,
+    0x07, 0x06, 0x06, 0x08, 0x0b, 0x08, 0x09, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x08, 0x0b, 0x0c,
+    0x0b, 0x0a, 0x0c, 0x09, 0x0a, 0x0a, 0x0a, 0xff, 0xc0, 0x00, 0x0b, 0x08, 0x00, 0x0a, 0x00, 0x13,
+    0x01, 0x01, 0x11, 0x00, 0xff, 0xc4, 0x00, 0x15, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x09, 0xff, 0xc4, 0x00, 0x26, 0x10,
+    0x00, 0x00, 0x03, 0x05, 0x08, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x03, 0x04, 0x01, 0x07, 0x08, 0x24, 0x25, 0x05, 0x15, 0x23, 0x33, 0x41, 0x42, 0x43, 0x51,
+    0x32, 0x52, 0x53, 0xff, 0xda, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3f, 0x00, 0x9f, 0x2e, 0x4a,
+    0x16, 0xf2, 0x69, 0xdd, 0x6c, 0x0c, 0x07, 0x25, 0x0b, 0x79, 0x34, 0xee, 0xb6, 0x04, 0x9d, 0x8f,
+    0x0b, 0x74, 0xc2, 0x69, 0xdb, 0x3d, 0x01, 0xb5, 0xc9, 0x22, 0x47, 0x83, 0x28, 0x56, 0x9c, 0x6c,
+    0x0c, 0x17, 0x24, 0x89, 0x1e, 0x0c, 0xa1, 0x5a, 0x71, 0xb0, 0x24, 0xec, 0x74, 0x48, 0xee, 0xc2,
+    0x65, 0x0a, 0xf0, 0xf9, 0xb0, 0x7f, 0xff, 0xd9,
+};
+
+// 7x5 RGBA 8 位 Adam7 隔行，逐行轮换 5 种过滤
+static const uint8_t k_png_rgba_interlaced[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x05, 0x08, 0x06, 0x00, 0x00, 0x01, 0xfe, 0x9d, 0xc6,
+    0x4e, 0x00, 0x00, 0x00, 0x77, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x6d, 0x8d, 0x21, 0x12, 0x03,
+    0x21, 0x10, 0x04, 0x9b, 0x54, 0xc5, 0x60, 0xce, 0x60, 0x62, 0xd0, 0xab, 0xa3, 0xf7, 0x11, 0xab,
+    0xef, 0x25, 0xbc, 0xe4, 0x34, 0x8f, 0xe0, 0x07, 0xe8, 0xd3, 0xc4, 0x9e, 0x26, 0x96, 0x58, 0x42,
+    0x7c, 0x44, 0xab, 0xe9, 0x9a, 0x06, 0x98, 0x24, 0x68, 0x90, 0x99, 0x29, 0x5b, 0x43, 0xa1, 0x17,
+    0xa8, 0x4e, 0xb3, 0xf4, 0x84, 0xbd, 0xc0, 0x98, 0x6a, 0xa1, 0x27, 0x93, 0x56, 0x4c, 0x2b, 0x11,
+    0xc6, 0x0e, 0xd7, 0x01, 0xa7, 0x8b, 0xe6, 0x87, 0x12, 0xde, 0x3f, 0x6e, 0x98, 0x5f, 0xfa, 0xda,
+    0xed, 0xb9, 0xae, 0x85, 0x19, 0xe5, 0x3e, 0x54, 0x7c, 0xdf, 0x65, 0xbb, 0x92, 0x84, 0x76, 0xc8,
+    0xe3, 0x2c, 0x12, 0xab, 0x5b, 0xd5, 0x19, 0xd9, 0x3e, 0xff, 0xf8, 0x02, 0xe6, 0xff, 0x2e, 0x4a,
+    0xca, 0x91, 0x76, 0x24, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+// 9x4 调色板 4 位，带 tRNS
+static const uint8_t k_png_palette[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04, 0x04, 0x03, 0x00, 0x00, 0x00, 0xae, 0x21, 0x08,
+    0xfd, 0x00, 0x00, 0x00, 0x30, 0x50, 0x4c, 0x54, 0x45, 0x00, 0xff, 0x00, 0x10, 0xef, 0x07, 0x20,
+    0xdf, 0x0e, 0x30, 0xcf, 0x15, 0x40, 0xbf, 0x1c, 0x50, 0xaf, 0x23, 0x60, 0x9f, 0x2a, 0x70, 0x8f,
+    0x31, 0x80, 0x7f, 0x38, 0x90, 0x6f, 0x3f, 0xa0, 0x5f, 0x46, 0xb0, 0x4f, 0x4d, 0xc0, 0x3f, 0x54,
+    0xd0, 0x2f, 0x5b, 0xe0, 0x1f, 0x62, 0xf0, 0x0f, 0x69, 0xa9, 0xe2, 0x1a, 0x29, 0x00, 0x00, 0x00,
+    0x10, 0x74, 0x52, 0x4e, 0x53, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa,
+    0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x76, 0x95, 0x01, 0x15, 0x00, 0x00, 0x00, 0x1e, 0x49, 0x44, 0x41,
+    0x54, 0x78, 0xda, 0x63, 0x60, 0x54, 0x76, 0x4d, 0x6f, 0x60, 0x34, 0x51, 0x52, 0x52, 0x12, 0x63,
+    0x32, 0x06, 0x02, 0x03, 0xe6, 0x74, 0x6d, 0x6d, 0x69, 0x0d, 0x00, 0x31, 0x9e, 0x04, 0x03, 0x23,
+    0xa8, 0xc2, 0x47, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+// 6x3 灰度 16 位
+static const uint8_t k_png_gray16[] = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x03, 0x10, 0x00, 0x00, 0x00, 0x00, 0xc5, 0xfa, 0xfd,
+    0x64, 0x00, 0x00, 0x00, 0x24, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x60, 0x50, 0x17,
+    0xf0, 0x53, 0x28, 0x35, 0x98, 0xe3, 0x70, 0x38, 0x80, 0x91, 0x7b, 0x87, 0xba, 0x00, 0x04, 0x6a,
+    0x08, 0x30, 0xf1, 0xec, 0x80, 0x41, 0xee, 0x1d, 0x00, 0xa4, 0x90, 0x09, 0xab, 0x9d, 0xa9, 0x8c,
+    0x4a, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+// JPEG 样例的像素公式
+static void jpeg_pattern(uint32_t x, uint32_t y, uint32_t channels, uint8_t* pixel) {
+    if (channels == 1) {
+        pixel[0] = (uint8_t)(x * 6 + y * 9 + 10);
+        return;
+    }
+    pixel[0] = (uint8_t)(x * 8 + 20);
+    pixel[1] = (uint8_t)(y * 12 + 30);
+    pixel[2] = (uint8_t)(128 + (x + y) * 4);
+}
+
+// 解码结果与公式的平均/最大误差
+static void jpeg_error(const Tensor* image, double* mean, int* max) {
+    uint32_t height = image->shape.dims[1];
+    uint32_t width = image->shape.dims[2];
+    uint32_t channels = image->shape.dims[3];
+    const uint8_t* data = (const uint8_t*)image->data;
+    double sum = 0.0;
+    *max = 0;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t expected[3];
+            jpeg_pattern(x, y, channels, expected);
+            for (uint32_t c = 0; c < channels; c++) {
+                int diff = abs((int)data[(y * width + x) * channels + c] - expected[c]);
+                sum += diff;
+                if (diff > *max) *max = diff;
+            }
+        }
+    }
+    *mean = sum / ((double)width * height * channels);
+}
+
+static void assert_shape(const Tensor* image, uint32_t height, uint32_t width, uint32_t channels) {
+    assert(image->dtype == TENSOR_TYPE_UINT8);
+    assert(image->format == TENSOR_FORMAT_NHWC);
+    assert(image->shape.ndim == 4);
+    assert(image->shape.dims[0] == 1);
+    assert(image->shape.dims[1] == height);
+    assert(image->shape.dims[2] == width);
+    assert(image->shape.dims[3] == channels);
+    assert(image->size == (size_t)height * width * channels);
+}
+
+static void write_le16(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void write_le32(uint8_t* p, uint32_t v) {
+    write_le16(p, v);
+    write_le16(p + 2, v >> 16);
+}
+
+static void write_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+// 构造 BMP：bpp 为 8（灰度调色板）、24 或 32（BITFIELDS 带透明），pixel 给出每个像素的 RGBA
+static uint8_t* make_bmp(uint32_t width, uint32_t height, uint32_t bpp, bool top_down, size_t* size,
+                         void (*pixel)(uint32_t x, uint32_t y, uint8_t* rgba)) {
+    uint32_t header_size = bpp == 32 ? 108 : 40;
+    uint32_t palette = bpp == 8 ? 256 * 4 : 0;
+    uint32_t stride = ((width * bpp + 31) / 32) * 4;
+    uint32_t offset = 14 + header_size + palette;
+    *size = offset + (size_t)stride * height;
+
+    uint8_t* data = calloc(*size, 1);
+    assert(data != NULL);
+    data[0] = 'B';
+    data[1] = 'M';
+    write_le32(data + 2, (uint32_t)*size);
+    write_le32(data + 10, offset);
+    write_le32(data + 14, header_size);
+    write_le32(data + 18, width);
+    write_le32(data + 22, top_down ? (uint32_t)-(int32_t)height : height);
+    write_le16(data + 26, 1);
+    write_le16(data + 28, bpp);
+    write_le32(data + 30, bpp == 32 ? 3 : 0);
+    if (bpp == 32) {
+        write_le32(data + 54, 0x00FF0000);
+        write_le32(data + 58, 0x0000FF00);
+        write_le32(data + 62, 0x000000FF);
+        write_le32(data + 66, 0xFF000000);
+    }
+    for (uint32_t i = 0; i < palette / 4; i++) {
+        data[14 + header_size + i * 4 + 0] = (uint8_t)i;
+        data[14 + header_size + i * 4 + 1] = (uint8_t)i;
+        data[14 + header_size + i * 4 + 2] = (uint8_t)i;
+    }
+
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t* row = data + offset + (size_t)stride * (top_down ? y : height - 1 - y);
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t rgba[4];
+            pixel(x, y, rgba);
+            if (bpp == 8) {
+                row[x] = rgba[0];
+            } else {
+                uint8_t* p = row + x * (bpp / 8);
+                p[0] = rgba[2];
+                p[1] = rgba[1];
+                p[2] = rgba[0];
+                if (bpp == 32) p[3] = rgba[3];
+            }
+        }
+    }
+    return data;
+}
+
+static void bmp_pattern(uint32_t x, uint32_t y, uint8_t* rgba) {
+    rgba[0] = (uint8_t)(x * 40 + y);
+    rgba[1] = (uint8_t)(y * 50 + 3);
+    rgba[2] = (uint8_t)(x * y * 7);
+    rgba[3] = (uint8_t)(200 - x * 10);
+}
+
+static float half_to_float(uint16_t h) {
+    uint32_t exponent = (h >> 10) & 0x1F;
+    uint32_t mantissa = h & 0x3FF;
+    float value;
+    if (exponent == 0) {
+        value = ldexpf((float)mantissa, -24);
+    } else if (exponent == 31) {
+        value = mantissa ? NAN : INFINITY;
+    } else {
+        value = ldexpf((float)(mantissa | 0x400), (int)exponent - 25);
+    }
+    return (h & 0x8000) ? -value : value;
+}
+
+static void bmp_gray_pattern(uint32_t x, uint32_t y, uint8_t* rgba) {
+    rgba[0] = rgba[1] = rgba[2] = (uint8_t)(x * 20 + y * 60);
+    rgba[3] = 255;
+}
+
+// ==================== 测试 ====================
+
+void test_probe(void) {
+    printf("测试文件头解析...\n");
+
+    image_header_t header;
+    assert(image_detect_format(k_jpeg_baseline, sizeof(k_jpeg_baseline)) == IMAGE_FORMAT_JPEG);
+    assert(image_probe_memory(k_jpeg_baseline, sizeof(k_jpeg_baseline), &header) == 0);
+    assert(header.format == IMAGE_FORMAT_JPEG);
+    assert(header.width == 21 && header.height == 13 && header.channels == 3);
+    assert(header.bit_depth == 8 && !header.progressive);
+
+    assert(image_probe_memory(k_jpeg_progressive, sizeof(k_jpeg_progressive), &header) == 0);
+    assert(header.width == 21 && header.height == 13 && header.progressive);
+
+    assert(image_probe_memory(k_jpeg_gray, sizeof(k_jpeg_gray), &header) == 0);
+    assert(header.width == 19 && header.height == 10 && header.channels == 1);
+
+    assert(image_probe_memory(k_png_rgba_interlaced, sizeof(k_png_rgba_interlaced), &header) == 0);
+    assert(header.format == IMAGE_FORMAT_PNG);
+    assert(header.width == 7 && header.height == 5 && header.channels == 4 && header.progressive);
+
+    // 调色板加 tRNS 输出 RGBA
+    assert(image_probe_memory(k_png_palette, sizeof(k_png_palette), &header) == 0);
+    assert(header.width == 9 && header.height == 4 && header.channels == 4 && header.bit_depth == 4);
+
+    assert(image_probe_memory(k_png_gray16, sizeof(k_png_gray16), &header) == 0);
+    assert(header.channels == 1 && header.bit_depth == 16);
+
+    size_t size = 0;
+    uint8_t* bmp = make_bmp(5, 3, 24, false, &size, bmp_pattern);
+    assert(image_probe_memory(bmp, size, &header) == 0);
+    assert(header.format == IMAGE_FORMAT_BMP);
+    assert(header.width == 5 && header.height == 3 && header.channels == 3);
+    free(bmp);
+
+    const uint8_t garbage[] = {'G', 'I', 'F', '8', '9', 'a', 0, 0};
+    assert(image_detect_format(garbage, sizeof(garbage)) == IMAGE_FORMAT_UNKNOWN);
+    assert(image_probe_memory(garbage, sizeof(garbage), &header) != 0);
+
+    // 文件头声明的像素数超过上限时，探测和解码都在分配缓冲区之前失败
+    logger_set_level(LOG_LEVEL_FATAL);
+    uint8_t png[sizeof(k_png_gray16)];
+    memcpy(png, k_png_gray16, sizeof(png));
+    write_be32(png + 16, 1u << 24);
+    write_be32(png + 20, 1u << 24);
+    Tensor huge = {0};
+    assert(image_probe_memory(png, sizeof(png), &header) != 0);
+    assert(image_decode_memory(png, sizeof(png), NULL, &huge) != 0 && huge.data == NULL);
+
+    uint8_t jpeg[sizeof(k_jpeg_baseline)];
+    memcpy(jpeg, k_jpeg_baseline, sizeof(jpeg));
+    for (size_t i = 0; i + 9 <= sizeof(jpeg); i++) {
+        if (jpeg[i] == 0xFF && jpeg[i + 1] == 0xC0) {
+            memset(jpeg + i + 5, 0xFF, 4);
+            break;
+        }
+    }
+    assert(image_probe_memory(jpeg, sizeof(jpeg), &header) != 0);
+    assert(image_decode_memory(jpeg, sizeof(jpeg), NULL, &huge) != 0 && huge.data == NULL);
+
+    bmp = make_bmp(5, 3, 24, false, &size, bmp_pattern);
+    write_le32(bmp + 18, 100000);
+    write_le32(bmp + 22, 100000);
+    assert(image_probe_memory(bmp, size, &header) != 0);
+    assert(image_decode_memory(bmp, size, NULL, &huge) != 0 && huge.data == NULL);
+    free(bmp);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    // BITFIELDS 掩码占满 32 位时按最高 8 位取值
+    bmp = make_bmp(3, 2, 32, false, &size, bmp_pattern);
+    write_le32(bmp + 54, 0xFFFFFFFF);
+    Tensor full_mask = {0};
+    assert(image_decode_memory(bmp, size, NULL, &full_mask) == 0);
+    assert_shape(&full_mask, 2, 3, 4);
+    tensor_free(&full_mask);
+    free(bmp);
+
+    printf("✅ 文件头解析测试通过\n");
+}
+
+void test_jpeg_decode(void) {
+    printf("测试 JPEG 解码...\n");
+
+    double mean;
+    int max;
+    Tensor baseline = {0};
+    assert(image_decode_memory(k_jpeg_baseline, sizeof(k_jpeg_baseline), NULL, &baseline) == 0);
+    assert_shape(&baseline, 13, 21, 3);
+    assert(baseline.owns_data);
+    jpeg_error(&baseline, &mean, &max);
+    printf("  基线 4:2:0：平均误差 %.2f，最大误差 %d\n", mean, max);
+    assert(mean < 4.0 && max < 24);
+
+    // 渐进式（含复位间隔）与基线编码同一幅图像
+    Tensor progressive = {0};
+    assert(image_decode_memory(k_jpeg_progressive, sizeof(k_jpeg_progressive), NULL, &progressive) == 0);
+    assert_shape(&progressive, 13, 21, 3);
+    jpeg_error(&progressive, &mean, &max);
+    printf("  渐进式：平均误差 %.2f，最大误差 %d\n", mean, max);
+    assert(mean < 4.0 && max < 24);
+
+    Tensor gray = {0};
+    assert(image_decode_memory(k_jpeg_gray, sizeof(k_jpeg_gray), NULL, &gray) == 0);
+    assert_shape(&gray, 10, 19, 1);
+    jpeg_error(&gray, &mean, &max);
+    printf("  灰度：平均误差 %.2f，最大误差 %d\n", mean, max);
+    assert(mean < 1.5 && max < 8);
+
+    // 灰度图按 RGB 输出时三通道相同
+    image_decode_options_t options = {0};
+    options.channels = 3;
+    Tensor gray_rgb = {0};
+    assert(image_decode_memory(k_jpeg_gray, sizeof(k_jpeg_gray), &options, &gray_rgb) == 0);
+    assert_shape(&gray_rgb, 10, 19, 3);
+    const uint8_t* g = (const uint8_t*)gray.data;
+    const uint8_t* rgb = (const uint8_t*)gray_rgb.data;
+    for (size_t i = 0; i < gray.size; i++) {
+        assert(rgb[i * 3] == g[i] && rgb[i * 3 + 1] == g[i] && rgb[i * 3 + 2] == g[i]);
+    }
+
+    tensor_free(&baseline);
+    tensor_free(&progressive);
+    tensor_free(&gray);
+    tensor_free(&gray_rgb);
+    printf("✅ JPEG 解码测试通过\n");
+}
+
+void test_jpeg_scaled_decode(void) {
+    printf("测试 JPEG DCT 域缩小解码...\n");
+
+    Tensor full = {0};
+    assert(image_decode_memory(k_jpeg_baseline, sizeof(k_jpeg_baseline), NULL, &full) == 0);
+    const uint8_t* reference = (const uint8_t*)full.data;
+
+    image_header_t header;
+    assert(image_probe_memory(k_jpeg_baseline, sizeof(k_jpeg_baseline), &header) == 0);
+
+    // 目标尺寸下限决定缩放比例：取不小于下限的最小输出
+    const uint32_t limits[][2] = {{11, 7}, {6, 4}, {1, 1}, {12, 1}};
+    const uint32_t expected[][3] = {{11, 7, 2}, {6, 4, 4}, {3, 2, 8}, {21, 13, 1}};
+    for (uint32_t t = 0; t < 4; t++) {
+        image_decode_options_t options = {0};
+        options.min_width = limits[t][0];
+        options.min_height = limits[t][1];
+
+        uint32_t width, height;
+        image_decode_output_size(&header, &options, &width, &height);
+        assert(width == expected[t][0] && height == expected[t][1]);
+
+        Tensor scaled = {0};
+        assert(image_decode_memory(k_jpeg_baseline, sizeof(k_jpeg_baseline), &options, &scaled) == 0);
+        assert_shape(&scaled, height, width, 3);
+
+        // 结果应接近全尺寸解码的区域平均（只比较完全位于图像内的区域，边缘块含编码器填充）
+        uint32_t scale = expected[t][2];
+        const uint8_t* data = (const uint8_t*)scaled.data;
+        double sum = 0.0;
+        uint32_t samples = 0;
+        for (uint32_t y = 0; (y + 1) * scale <= 13; y++) {
+            for (uint32_t x = 0; (x + 1) * scale <= 21; x++) {
+                for (uint32_t c = 0; c < 3; c++) {
+                    double acc = 0.0;
+                    for (uint32_t sy = y * scale; sy < (y + 1) * scale; sy++) {
+                        for (uint32_t sx = x * scale; sx < (x + 1) * scale; sx++) {
+                            acc += reference[(sy * 21 + sx) * 3 + c];
+                        }
+                    }
+                    sum += fabs(acc / (scale * scale) - data[(y * width + x) * 3 + c]);
+                    samples++;
+                }
+            }
+        }
+        double mean = sum / samples;
+        printf("  1/%u：%ux%u，与区域平均的平均误差 %.2f\n", scale, width, height, mean);
+        assert(mean < 3.0);
+        tensor_free(&scaled);
+    }
+
+    tensor_free(&full);
+    printf("✅ JPEG DCT 域缩小解码测试通过\n");
+}
+
+void test_png_decode(void) {
+    printf("测试 PNG 解码...\n");
+
+    Tensor rgba = {0};
+    assert(image_decode_memory(k_png_rgba_interlaced, sizeof(k_png_rgba_interlaced), NULL, &rgba) == 0);
+    assert_shape(&rgba, 5, 7, 4);
+    const uint8_t* p = (const uint8_t*)rgba.data;
+    for (uint32_t y = 0; y < 5; y++) {
+        for (uint32_t x = 0; x < 7; x++) {
+            const uint8_t* px = p + (y * 7 + x) * 4;
+            assert(px[0] == x * 30 && px[1] == y * 40 && px[2] == x * y * 5 && px[3] == 255 - x * 10);
+        }
+    }
+
+    Tensor palette = {0};
+    assert(image_decode_memory(k_png_palette, sizeof(k_png_palette), NULL, &palette) == 0);
+    assert_shape(&palette, 4, 9, 4);
+    p = (const uint8_t*)palette.data;
+    for (uint32_t y = 0; y < 4; y++) {
+        for (uint32_t x = 0; x < 9; x++) {
+            uint32_t i = (x + y * 3) % 16;
+            const uint8_t* px = p + (y * 9 + x) * 4;
+            assert(px[0] == i * 16 && px[1] == 255 - i * 16 && px[2] == i * 7 && px[3] == i * 17);
+        }
+    }
+
+    // 16 位取高字节
+    Tensor gray = {0};
+    assert(image_decode_memory(k_png_gray16, sizeof(k_png_gray16), NULL, &gray) == 0);
+    assert_shape(&gray, 3, 6, 1);
+    p = (const uint8_t*)gray.data;
+    for (uint32_t y = 0; y < 3; y++) {
+        for (uint32_t x = 0; x < 6; x++) {
+            assert(p[y * 6 + x] == (x * 10000 + y * 3000) >> 8);
+        }
+    }
+
+    // RGBA 转 RGB 丢弃透明通道
+    image_decode_options_t options = {0};
+    options.channels = 3;
+    Tensor rgb = {0};
+    assert(image_decode_memory(k_png_rgba_interlaced, sizeof(k_png_rgba_interlaced), &options, &rgb) == 0);
+    assert_shape(&rgb, 5, 7, 3);
+    for (uint32_t i = 0; i < 35; i++) {
+        assert(memcmp((const uint8_t*)rgb.data + i * 3, (const uint8_t*)rgba.data + i * 4, 3) == 0);
+    }
+
+    tensor_free(&rgba);
+    tensor_free(&palette);
+    tensor_free(&gray);
+    tensor_free(&rgb);
+    printf("✅ PNG 解码测试通过\n");
+}
+
+void test_bmp_decode(void) {
+    printf("测试 BMP 解码...\n");
+
+    // 24 位自下而上，每行有填充字节
+    size_t size = 0;
+    uint8_t* bmp = make_bmp(5, 3, 24, false, &size, bmp_pattern);
+    Tensor rgb = {0};
+    assert(image_decode_memory(bmp, size, NULL, &rgb) == 0);
+    assert_shape(&rgb, 3, 5, 3);
+    const uint8_t* p = (const uint8_t*)rgb.data;
+    for (uint32_t y = 0; y < 3; y++) {
+        for (uint32_t x = 0; x < 5; x++) {
+            uint8_t expected[4];
+            bmp_pattern(x, y, expected);
+            assert(memcmp(p + (y * 5 + x) * 3, expected, 3) == 0);
+        }
+    }
+    free(bmp);
+
+    // 32 位 BITFIELDS 带透明通道，自上而下
+    bmp = make_bmp(6, 4, 32, true, &size, bmp_pattern);
+    Tensor rgba = {0};
+    assert(image_decode_memory(bmp, size, NULL, &rgba) == 0);
+    assert_shape(&rgba, 4, 6, 4);
+    p = (const uint8_t*)rgba.data;
+    for (uint32_t y = 0; y < 4; y++) {
+        for (uint32_t x = 0; x < 6; x++) {
+            uint8_t expected[4];
+            bmp_pattern(x, y, expected);
+            assert(memcmp(p + (y * 6 + x) * 4, expected, 4) == 0);
+        }
+    }
+    free(bmp);
+
+    // 灰度调色板按单通道输出，请求 RGBA 时补不透明通道
+    bmp = make_bmp(3, 2, 8, false, &size, bmp_gray_pattern);
+    Tensor gray = {0};
+    assert(image_decode_memory(bmp, size, NULL, &gray) == 0);
+    assert_shape(&gray, 2, 3, 1);
+    image_decode_options_t options = {0};
+    options.channels = 4;
+    Tensor gray_rgba = {0};
+    assert(image_decode_memory(bmp, size, &options, &gray_rgba) == 0);
+    assert_shape(&gray_rgba, 2, 3, 4);
+    for (uint32_t y = 0; y < 2; y++) {
+        for (uint32_t x = 0; x < 3; x++) {
+            uint8_t value = (uint8_t)(x * 20 + y * 60);
+            const uint8_t* px = (const uint8_t*)gray_rgba.data + (y * 3 + x) * 4;
+            assert(((const uint8_t*)gray.data)[y * 3 + x] == value);
+            assert(px[0] == value && px[1] == value && px[2] == value && px[3] == 255);
+        }
+    }
+    free(bmp);
+
+    tensor_free(&rgb);
+    tensor_free(&rgba);
+    tensor_free(&gray);
+    tensor_free(&gray_rgba);
+    printf("✅ BMP 解码测试通过\n");
+}
+
+void test_decode_into_buffer(void) {
+    printf("测试解码到已有缓冲区与错误输入...\n");
+
+    // 容量不足时失败，足够时直接写入调用方缓冲区
+    uint8_t small[16];
+    Tensor output = {0};
+    output.data = small;
+    output.size = sizeof(small);
+    assert(image_decode_memory(k_png_gray16, sizeof(k_png_gray16), NULL, &output) != 0);
+    assert(output.data == small);
+
+    uint8_t buffer[64];
+    output.data = buffer;
+    output.size = sizeof(buffer);
+    assert(image_decode_memory(k_png_gray16, sizeof(k_png_gray16), NULL, &output) == 0);
+    assert(output.data == buffer && !output.owns_data);
+    assert_shape(&output, 3, 6, 1);
+
+    // 截断和损坏的数据不能越界（期间屏蔽预期的错误日志）
+    logger_set_level(LOG_LEVEL_FATAL);
+    const struct {
+        const uint8_t* data;
+        size_t size;
+    } samples[] = {
+        {k_jpeg_baseline, sizeof(k_jpeg_baseline)},
+        {k_jpeg_progressive, sizeof(k_jpeg_progressive)},
+        {k_png_rgba_interlaced, sizeof(k_png_rgba_interlaced)},
+        {k_png_palette, sizeof(k_png_palette)}
+    };
+    for (uint32_t s = 0; s < 4; s++) {
+        uint8_t* copy = malloc(samples[s].size);
+        assert(copy != NULL);
+        for (size_t cut = 0; cut < samples[s].size; cut += 37) {
+            Tensor t = {0};
+            if (image_decode_memory(samples[s].data, cut, NULL, &t) == 0) tensor_free(&t);
+        }
+        for (uint32_t trial = 0; trial < 64; trial++) {
+            memcpy(copy, samples[s].data, samples[s].size);
+            size_t pos = 20 + (trial * 7919u) % (samples[s].size - 20);
+            copy[pos] ^= (uint8_t)(trial * 37 + 1);
+            Tensor t = {0};
+            if (image_decode_memory(copy, samples[s].size, NULL, &t) == 0) tensor_free(&t);
+        }
+        free(copy);
+    }
+    logger_set_level(LOG_LEVEL_INFO);
+
+    printf("✅ 解码到已有缓冲区与错误输入测试通过\n");
+}
+
+void test_decode_to_tensor(void) {
+    printf("测试直接写入目标张量...\n");
+
+    // 与预处理管道（浮点缩放 -> 归一化 -> 转置）结果一致
+    const uint32_t w = 13, h = 9;
+    uint8_t pixels[13 * 9 * 3];
+    for (uint32_t i = 0; i < sizeof(pixels); i++) pixels[i] = (uint8_t)((i * 37 + (i / 39) * 11) & 0xFF);
+
+    uint32_t dims[] = {1, h, w, 3};
+    TensorShape shape = tensor_shape_create(dims, 4);
+    Tensor source = tensor_create("source", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NHWC);
+    source.data = malloc(source.size);
+    assert(source.data != NULL);
+    source.owns_data = true;
+    for (uint32_t i = 0; i < sizeof(pixels); i++) ((float*)source.data)[i] = pixels[i];
+
+    const float mean[] = {120.0f, 110.0f, 100.0f};
+    const float std[] = {60.0f, 55.0f, 50.0f};
+    preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+    assert(pipeline != NULL);
+    preprocess_params_t resize = {0};
+    resize.params.resize.width = 6;
+    resize.params.resize.height = 20;
+    resize.params.resize.method = INTERPOLATION_LINEAR;
+    preprocess_params_t normalize = {0};
+    normalize.params.normalize.channels = 3;
+    memcpy(normalize.params.normalize.mean, mean, sizeof(mean));
+    memcpy(normalize.params.normalize.std, std, sizeof(std));
+    preprocess_params_t transpose = {0};
+    uint32_t perm[] = {0, 3, 1, 2};
+    transpose.params.transpose.ndim = 4;
+    memcpy(transpose.params.transpose.perm, perm, sizeof(perm));
+    assert(preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_RESIZE, &resize)) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_NORMALIZE, &normalize)) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_TRANSPOSE, &transpose)) == 0);
+    Tensor expected = {0};
+    assert(preprocess_pipeline_execute(pipeline, &source, &expected) == 0);
+    preprocess_pipeline_destroy(pipeline);
+
+    image_tensor_layout_t layout = {0};
+    layout.width = 6;
+    layout.height = 20;
+    layout.format = TENSOR_FORMAT_NCHW;
+    layout.dtype = TENSOR_TYPE_FLOAT32;
+    memcpy(layout.mean, mean, sizeof(mean));
+    memcpy(layout.std, std, sizeof(std));
+    Tensor direct = {0};
+    assert(image_pixels_to_tensor(pixels, w, h, 3, 0, &layout, &direct) == 0);
+    assert(direct.dtype == TENSOR_TYPE_FLOAT32 && direct.format == TENSOR_FORMAT_NCHW);
+    assert(direct.shape.dims[1] == 3 && direct.shape.dims[2] == 20 && direct.shape.dims[3] == 6);
+    assert(direct.size == expected.size);
+    for (uint32_t i = 0; i < 3 * 20 * 6; i++) {
+        assert(fabsf(((float*)direct.data)[i] - ((float*)expected.data)[i]) < 1e-4f);
+    }
+
+    // FP16 与 FP32 结果在半精度舍入误差内一致
+    layout.dtype = TENSOR_TYPE_FLOAT16;
+    Tensor half = {0};
+    assert(image_pixels_to_tensor(pixels, w, h, 3, 0, &layout, &half) == 0);
+    assert(half.dtype == TENSOR_TYPE_FLOAT16 && half.size == 3 * 20 * 6 * 2);
+    for (uint32_t i = 0; i < 3 * 20 * 6; i++) {
+        float a = half_to_float(((uint16_t*)half.data)[i]);
+        float b = ((float*)direct.data)[i];
+        assert(fabsf(a - b) <= fabsf(b) * 1e-3f + 1e-4f);
+    }
+    tensor_free(&half);
+    tensor_free(&direct);
+    tensor_free(&expected);
+    tensor_free(&source);
+
+    // 原尺寸 UINT8 NHWC 输出与输入逐字节相同（按行跨度读取）
+    uint8_t padded[9 * 40];
+    for (uint32_t y = 0; y < h; y++) memcpy(padded + y * 40, pixels + y * w * 3, w * 3);
+    image_tensor_layout_t raw = {0};
+    raw.format = TENSOR_FORMAT_NHWC;
+    raw.dtype = TENSOR_TYPE_UINT8;
+    raw.mean[0] = 100.0f;
+    Tensor copy = {0};
+    assert(image_pixels_to_tensor(padded, w, h, 3, 40, &raw, &copy) == 0);
+    assert(copy.size == sizeof(pixels) && memcmp(copy.data, pixels, sizeof(pixels)) == 0);
+    tensor_free(&copy);
+
+    // JPEG 直接输出与先解码（同一 DCT 缩放）再写入的结果一致
+    image_tensor_layout_t jpeg = {0};
+    jpeg.width = 7;
+    jpeg.height = 5;
+    jpeg.channels = 1;
+    jpeg.format = TENSOR_FORMAT_NCHW;
+    jpeg.scale = 1.0f / 255.0f;
+    image_decode_options_t options = {1, 7, 5};
+    Tensor decoded = {0};
+    assert(image_decode_memory(k_jpeg_baseline, sizeof(k_jpeg_baseline), &options, &decoded) == 0);
+    assert_shape(&decoded, 7, 11, 1);
+    Tensor reference = {0};
+    assert(image_pixels_to_tensor((const uint8_t*)decoded.data, 11, 7, 1, 0, &jpeg, &reference) == 0);
+    Tensor streamed = {0};
+    assert(image_decode_memory_to_tensor(k_jpeg_baseline, sizeof(k_jpeg_baseline), &jpeg, &streamed) == 0);
+    assert(streamed.size == 7 * 5 * sizeof(float));
+    assert(memcmp(streamed.data, reference.data, streamed.size) == 0);
+    tensor_free(&reference);
+    tensor_free(&decoded);
+
+    // 形状计算与已分配缓冲区的容量检查
+    TensorShape expected_shape;
+    size_t bytes = 0;
+    assert(image_tensor_layout_shape(&jpeg, NULL, &expected_shape, &bytes) == 0);
+    assert(bytes == streamed.size && expected_shape.dims[1] == 1 && expected_shape.dims[2] == 5);
+    image_header_t header = {0};
+    assert(image_tensor_layout_shape(&raw, NULL, NULL, &bytes) != 0);
+    assert(image_probe_memory(k_png_palette, sizeof(k_png_palette), &header) == 0);
+    assert(image_tensor_layout_shape(&raw, &header, NULL, &bytes) == 0 && bytes == 9 * 4 * 4);
+
+    logger_set_level(LOG_LEVEL_FATAL);
+    Tensor small = {0};
+    uint8_t buffer[64];
+    small.data = buffer;
+    small.size = sizeof(buffer);
+    jpeg.dtype = TENSOR_TYPE_FLOAT32;
+    assert(image_decode_memory_to_tensor(k_jpeg_baseline, sizeof(k_jpeg_baseline), &jpeg, &small) != 0);
+    jpeg.dtype = TENSOR_TYPE_INT32;
+    assert(image_decode_memory_to_tensor(k_jpeg_baseline, sizeof(k_jpeg_baseline), &jpeg, &small) != 0);
+    Tensor truncated = {0};
+    jpeg.dtype = TENSOR_TYPE_UINT8;
+    assert(image_decode_memory_to_tensor(k_png_gray16, 40, &jpeg, &truncated) != 0);
+    assert(truncated.data == NULL);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    jpeg.dtype = TENSOR_TYPE_UINT8;
+    assert(image_decode_memory_to_tensor(k_jpeg_baseline, sizeof(k_jpeg_baseline), &jpeg, &small) == 0);
+    assert(small.data == buffer && small.size == 7 * 5 && small.dtype == TENSOR_TYPE_UINT8);
+    for (uint32_t i = 0; i < 7 * 5; i++) {
+        assert(abs((int)buffer[i] - (int)lroundf(((float*)streamed.data)[i] * 255.0f)) <= 1);
+    }
+    tensor_free(&streamed);
+
+    printf("✅ 直接写入目标张量测试通过\n");
+}
+
+void test_image_utils_builtin(void) {
+    printf("测试图像工具内置解码...\n");
+
+    // SOF 之前插入超过探测窗口的 APP 段，文件头解析需要继续读取
+    const char* path = "test_image_decode_tmp.jpg";
+    FILE* file = fopen(path, "wb");
+    assert(file != NULL);
+    fwrite(k_jpeg_baseline, 1, 2, file);
+    uint8_t* app = calloc(40000, 1);
+    assert(app != NULL);
+    for (int i = 0; i < 2; i++) {
+        const uint8_t marker[4] = {0xFF, 0xE1, 40000 >> 8, 40000 & 0xFF};
+        fwrite(marker, 1, 4, file);
+        fwrite(app, 1, 40000 - 2, file);
+    }
+    fwrite(k_jpeg_baseline + 2, 1, sizeof(k_jpeg_baseline) - 2, file);
+    fclose(file);
+    free(app);
+
+    image_header_t header;
+    assert(image_probe_file(path, &header) == 0);
+    assert(header.width == 21 && header.height == 13);
+
+    ImageInfo info = image_utils_get_info(path);
+    assert(info.valid);
+    assert(info.width == 21 && info.height == 13 && info.channels == 3);
+
+    ImageProcessConfig config = image_utils_create_config(8, 6, 3, TENSOR_FORMAT_NCHW, true);
+    Tensor tensor = image_utils_load_tensor(path, &config);
+    assert(tensor.data != NULL);
+    assert(tensor.dtype == TENSOR_TYPE_FLOAT32);
+    assert(tensor.shape.ndim == 4);
+    assert(tensor.shape.dims[0] == 1 && tensor.shape.dims[1] == 3);
+    assert(tensor.shape.dims[2] == 6 && tensor.shape.dims[3] == 8);
+
+    // 红色通道沿宽度递增，绿色通道沿高度递增
+    const float* data = (const float*)tensor.data;
+    for (uint32_t i = 0; i < 3 * 6 * 8; i++) assert(data[i] >= 0.0f && data[i] <= 1.0f);
+    assert(data[7] > data[0]);
+    assert(data[48 + 5 * 8] > data[48]);
+
+    // 写入批量张量中的一个样本，以及从内存池分配
+    float batch[2 * 3 * 6 * 8];
+    memset(batch, 0, sizeof(batch));
+    Tensor slot = {0};
+    slot.data = batch + 3 * 6 * 8;
+    slot.size = sizeof(float) * 3 * 6 * 8;
+    assert(image_utils_load_into(path, &config, &slot, NULL) == 0);
+    assert(slot.data == batch + 3 * 6 * 8 && !slot.owns_data);
+    assert(memcmp(slot.data, tensor.data, slot.size) == 0);
+    assert(batch[0] == 0.0f && batch[3 * 6 * 8 - 1] == 0.0f);
+    tensor_free(&tensor);
+
+    memory_pool_config_t pool_config = {
+        .type = MEMORY_POOL_CPU,
+        .initial_size = 65536,
+        .max_size = 65536,
+        .grow_size = 4096,
+        .alignment = 64,
+        .strategy = MEMORY_ALLOC_FIRST_FIT
+    };
+    memory_pool_t pool = memory_pool_create(&pool_config);
+    assert(pool != NULL);
+    ImageProcessConfig pooled = image_utils_create_config(8, 6, 3, TENSOR_FORMAT_NHWC, true);
+    pooled.dtype = TENSOR_TYPE_FLOAT16;
+    pooled.memory_pool = pool;
+    Tensor from_pool = {0};
+    memory_handle_t handle = NULL;
+    assert(image_utils_load_into(path, &pooled, &from_pool, &handle) == 0);
+    assert(handle != NULL && from_pool.data == memory_handle_get_ptr(handle) && !from_pool.owns_data);
+    assert(from_pool.dtype == TENSOR_TYPE_FLOAT16 && from_pool.size == 6 * 8 * 3 * 2);
+    assert(from_pool.format == TENSOR_FORMAT_NHWC && from_pool.shape.dims[3] == 3);
+    for (uint32_t y = 0; y < 6; y++) {
+        for (uint32_t x = 0; x < 8; x++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                float a = half_to_float(((uint16_t*)from_pool.data)[(y * 8 + x) * 3 + c]);
+                float b = batch[3 * 6 * 8 + c * 48 + y * 8 + x];
+                assert(fabsf(a - b) < 1e-3f);
+            }
+        }
+    }
+    assert(memory_pool_free(pool, handle) == 0);
+    memory_pool_destroy(pool);
+
+    remove(path);
+    printf("✅ 图像工具内置解码测试通过\n");
+}
+
+void test_image_loader(void) {
+    printf("测试批量图像加载器...\n");
+
+    // 8 个路径：不同尺寸的 BMP、JPEG、损坏文件和不存在的文件
+    const uint32_t count = 8;
+    char names[8][64];
+    const char* paths[8];
+    for (uint32_t i = 0; i < count; i++) {
+        snprintf(names[i], sizeof(names[i]), "test_image_loader_%u.img", i);
+        paths[i] = names[i];
+        if (i == 7) continue;
+        FILE* file = fopen(names[i], "wb");
+        assert(file != NULL);
+        if (i == 2) {
+            fwrite(k_jpeg_baseline, 1, sizeof(k_jpeg_baseline), file);
+        } else if (i == 5) {
+            fwrite(k_png_palette, 1, 20, file);
+        } else {
+            size_t size = 0;
+            uint8_t* bmp = make_bmp(5 + i, 3 + i % 3, 24, i & 1, &size, bmp_pattern);
+            fwrite(bmp, 1, size, file);
+            free(bmp);
+        }
+        fclose(file);
+    }
+
+    image_loader_config_t config = {0};
+    config.process = image_utils_create_config(6, 4, 3, TENSOR_FORMAT_NCHW, true);
+    config.process.dtype = TENSOR_TYPE_FLOAT32;
+    config.batch_size = 3;
+    config.num_workers = 3;
+    config.prefetch_batches = 2;
+    config.ordered = true;
+
+    // 逐张加载的结果作为参考
+    const size_t sample = 3 * 4 * 6 * sizeof(float);
+    uint8_t* expected = calloc(count, sample);
+    assert(expected != NULL);
+    logger_set_level(LOG_LEVEL_FATAL);
+    for (uint32_t i = 0; i < count; i++) {
+        Tensor slot = {0};
+        slot.data = expected + sample * i;
+        slot.size = sample;
+        assert((image_utils_load_into(paths[i], &config.process, &slot, NULL) == 0) == (i != 5 && i != 7));
+        if (i == 5 || i == 7) memset(slot.data, 0, sample);
+    }
+
+    for (int ordered = 1; ordered >= 0; ordered--) {
+        config.ordered = ordered != 0;
+        image_loader_t loader = image_loader_create(paths, count, &config);
+        assert(loader != NULL);
+        assert(image_loader_get_batch_count(loader) == 3);
+
+        bool seen[8] = {false};
+        uint32_t batches = 0;
+        image_batch_t batch;
+        int ret;
+        while ((ret = image_loader_next(loader, &batch)) == 0) {
+            if (config.ordered) assert(batch.batch_index == batches);
+            assert(batch.count == (batch.batch_index == 2 ? 2u : 3u));
+            assert(batch.tensor.shape.ndim == 4 && batch.tensor.shape.dims[0] == batch.count);
+            assert(batch.tensor.shape.dims[1] == 3 && batch.tensor.shape.dims[2] == 4);
+            assert(batch.tensor.size == sample * batch.count);
+            uint32_t failed = 0;
+            for (uint32_t j = 0; j < batch.count; j++) {
+                uint32_t index = batch.indices[j];
+                assert(index == batch.batch_index * 3 + j && !seen[index]);
+                seen[index] = true;
+                assert(batch.valid[j] == (index != 5 && index != 7));
+                failed += !batch.valid[j];
+                assert(memcmp((uint8_t*)batch.tensor.data + sample * j, expected + sample * index, sample) == 0);
+            }
+            assert(failed == batch.failed);
+            image_loader_release(loader, &batch);
+            assert(batch.tensor.data == NULL);
+            batches++;
+        }
+        assert(ret == IMAGE_LOADER_END && batches == 3);
+        assert(image_loader_next(loader, &batch) == IMAGE_LOADER_END);
+        for (uint32_t i = 0; i < count; i++) assert(seen[i]);
+
+        image_loader_stats_t stats;
+        assert(image_loader_get_stats(loader, &stats) == 0);
+        assert(stats.images_loaded == 6 && stats.images_failed == 2 && stats.batches == 3);
+        image_loader_destroy(loader);
+    }
+
+    // 按顺序返回时不归还批次会占满窗口
+    config.ordered = true;
+    image_loader_t loader = image_loader_create(paths, count, &config);
+    assert(loader != NULL);
+    image_batch_t first, second, third;
+    assert(image_loader_next(loader, &first) == 0 && image_loader_next(loader, &second) == 0);
+    assert(image_loader_next(loader, &third) < 0);
+    image_loader_release(loader, &first);
+    assert(image_loader_next(loader, &third) == 0 && third.batch_index == 2);
+    image_loader_release(loader, &second);
+    image_loader_release(loader, &third);
+    image_loader_destroy(loader);
+
+    // 未取完时直接销毁，以及从内存池分配批次缓冲区
+    memory_pool_config_t pool_config = {
+        .type = MEMORY_POOL_CPU,
+        .initial_size = 65536,
+        .max_size = 65536,
+        .grow_size = 4096,
+        .alignment = 64,
+        .strategy = MEMORY_ALLOC_FIRST_FIT
+    };
+    memory_pool_t pool = memory_pool_create(&pool_config);
+    assert(pool != NULL);
+    config.process.memory_pool = pool;
+    config.num_workers = 0;
+    loader = image_loader_create(paths, count, &config);
+    assert(loader != NULL);
+    assert(image_loader_next(loader, &first) == 0);
+    assert(memcmp(first.tensor.data, expected, sample * 3) == 0);
+    memory_pool_stats_t pool_stats;
+    assert(memory_pool_get_stats(pool, &pool_stats) == 0 && pool_stats.active_blocks == 2);
+    image_loader_destroy(loader);
+    assert(memory_pool_get_stats(pool, &pool_stats) == 0 && pool_stats.active_blocks == 0);
+    memory_pool_destroy(pool);
+
+    // 参数检查
+    config.process.memory_pool = NULL;
+    config.process.target_channels = 0;
+    assert(image_loader_create(paths, count, &config) == NULL);
+    config.process.target_channels = 3;
+    config.batch_size = 0;
+    assert(image_loader_create(paths, count, &config) == NULL);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    free(expected);
+    for (uint32_t i = 0; i < count - 1; i++) remove(names[i]);
+    printf("✅ 批量图像加载器测试通过\n");
+}
+
+int main(void) {
+    // 初始化日志系统
+    logger_init(LOG_LEVEL_INFO, NULL);
+    logger_set_console_output(true);
+
+    printf("=== 图像解码单元测试 ===\n");
+
+    test_probe();
+    test_jpeg_decode();
+    test_jpeg_scaled_decode();
+    test_png_decode();
+    test_bmp_decode();
+    test_decode_into_buffer();
+    test_decode_to_tensor();
+    test_image_utils_builtin();
+    test_image_loader();
+
+    printf("🎉 所有图像解码测试通过！\n");
+    return 0;
+}
@@ -0,0 +1,786 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "core/multimodal.h"
+#include "core/multimodal_sync.h"
+#include "core/multimodal_convert.h"
+#include "utils/tensor_codec.h"
+#include "utils/logger.h"
+
+/**
+ * @brief 多模态数据单元测试
+ */
+
+// 构造包含图像、音频和空文本的多模态容器
+static MultiModalData* create_sample_bundle(float* image, int16_t* audio) {
+    MultiModalData* bundle = multimodal_data_create(2);
+    assert(bundle != NULL);
+    bundle->session_id = strdup("session-42");
+
+    uint32_t image_dims[] = {3, 4, 5};
+    ModalityData modal;
+    memset(&modal, 0, sizeof(modal));
+    modal.modality = MODALITY_IMAGE;
+    modal.format = DATA_FORMAT_RGB;
+    modal.data = image;
+    modal.data_size = 3 * 4 * 5 * sizeof(float);
+    modal.shape = tensor_shape_create(image_dims, 3);
+    modal.data_type = TENSOR_TYPE_FLOAT32;
+    modal.metadata = "{\"camera\":\"front\"}";
+    modal.source_id = "cam0";
+    modal.timestamp = 1000;
+    modal.sequence_id = 1;
+    assert(multimodal_data_add(bundle, &modal) == 0);
+
+    uint32_t audio_dims[] = {37};
+    memset(&modal, 0, sizeof(modal));
+    modal.modality = MODALITY_AUDIO;
+    modal.format = DATA_FORMAT_PCM;
+    modal.data = audio;
+    modal.data_size = 37 * sizeof(int16_t);
+    modal.shape = tensor_shape_create(audio_dims, 1);
+    modal.data_type = TENSOR_TYPE_INT16;
+    modal.source_id = "mic0";
+    modal.timestamp = 1003;
+    modal.sequence_id = 2;
+    assert(multimodal_data_add(bundle, &modal) == 0);
+
+    memset(&modal, 0, sizeof(modal));
+    modal.modality = MODALITY_TEXT;
+    modal.format = DATA_FORMAT_UTF8;
+    modal.metadata = "";
+    assert(multimodal_data_add(bundle, &modal) == 0);
+
+    return bundle;
+}
+
+static void assert_modality_equal(const ModalityData* a, const ModalityData* b) {
+    assert(a->modality == b->modality);
+    assert(a->format == b->format);
+    assert(a->data_type == b->data_type);
+    assert(tensor_shape_equal(&a->shape, &b->shape));
+    assert(a->timestamp == b->timestamp);
+    assert(a->sequence_id == b->sequence_id);
+    assert(a->data_size == b->data_size);
+    assert(a->data_size == 0 || memcmp(a->data, b->data, a->data_size) == 0);
+    assert((a->metadata == NULL) == (b->metadata == NULL));
+    assert(!a->metadata || strcmp(a->metadata, b->metadata) == 0);
+    assert((a->source_id == NULL) == (b->source_id == NULL));
+    assert(!a->source_id || strcmp(a->source_id, b->source_id) == 0);
+}
+
+// 测试 arena 模式容器
+void test_multimodal_arena(void) {
+    printf("测试多模态 arena 容器...\n");
+
+    float image[3 * 4 * 5];
+    int16_t audio[37];
+    for (int i = 0; i < 60; i++) image[i] = (float)i * 0.5f;
+    for (int i = 0; i < 37; i++) audio[i] = (int16_t)(i * 7 - 100);
+
+    // 用普通容器构造参考数据，按它计算 arena 大小
+    MultiModalData* reference = create_sample_bundle(image, audio);
+    size_t arena_size = multimodal_data_arena_bytes(reference->modalities, reference->modality_count);
+    assert(arena_size >= sizeof(image) + sizeof(audio));
+
+    MultiModalData* bundle = multimodal_data_create_arena(reference->modality_count,
+                                                          arena_size + sizeof("session-arena"));
+    assert(bundle != NULL);
+
+    // 反复填充和清空，不再分配内存
+    for (int round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < reference->modality_count; i++) {
+            assert(multimodal_data_add(bundle, &reference->modalities[i]) == 0);
+        }
+        assert(bundle->modality_count == reference->modality_count);
+        assert(bundle->arena_used <= arena_size);
+
+        for (uint32_t i = 0; i < bundle->modality_count; i++) {
+            const ModalityData* modal = &bundle->modalities[i];
+            assert_modality_equal(modal, &reference->modalities[i]);
+            assert(modal->borrowed);
+            if (modal->data_size > 0) {
+                assert(modal->data >= (void*)bundle->arena && modal->data < (void*)(bundle->arena + arena_size));
+                assert(((uintptr_t)modal->data % 64) == 0);
+            }
+        }
+
+        // 按模态和数据源直接查找
+        assert(multimodal_data_get(bundle, MODALITY_IMAGE) == &bundle->modalities[0]);
+        assert(multimodal_data_get(bundle, MODALITY_AUDIO) == &bundle->modalities[1]);
+        assert(multimodal_data_get(bundle, MODALITY_TEXT) == &bundle->modalities[2]);
+        assert(multimodal_data_get(bundle, MODALITY_LIDAR) == NULL);
+        assert(multimodal_data_find_source(bundle, "cam0") == &bundle->modalities[0]);
+        assert(multimodal_data_find_source(bundle, "mic0") == &bundle->modalities[1]);
+        assert(multimodal_data_find_source(bundle, "imu0") == NULL);
+
+        assert(multimodal_data_set_session(bundle, "session-arena") == 0);
+        multimodal_data_clear(bundle);
+        assert(bundle->modality_count == 0 && bundle->arena_used == 0);
+        assert(bundle->session_id == NULL);
+        assert(multimodal_data_get(bundle, MODALITY_IMAGE) == NULL);
+        assert(multimodal_data_find_source(bundle, "cam0") == NULL);
+    }
+
+    // 容量或 arena 用完时添加失败，已有数据不受影响
+    logger_set_level(LOG_LEVEL_FATAL);
+    MultiModalData* small = multimodal_data_create_arena(2, sizeof(image) + 64);
+    assert(multimodal_data_add(small, &reference->modalities[0]) == 0);
+    size_t used = small->arena_used;
+    assert(multimodal_data_add(small, &reference->modalities[1]) != 0);
+    assert(small->modality_count == 1 && small->arena_used == used);
+    assert(multimodal_data_adopt(small, &reference->modalities[1]) == 0);
+    assert(multimodal_data_adopt(small, &reference->modalities[2]) != 0);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    // 按引用添加的模态直接指向调用者数据
+    ModalityData* adopted = multimodal_data_get(small, MODALITY_AUDIO);
+    assert(adopted->data == reference->modalities[1].data && adopted->borrowed);
+    assert(multimodal_data_find_source(small, "mic0") == adopted);
+
+    // 移除后索引重建
+    assert(multimodal_data_remove(small, MODALITY_IMAGE) == 0);
+    assert(multimodal_data_get(small, MODALITY_IMAGE) == NULL);
+    assert(multimodal_data_get(small, MODALITY_AUDIO) == &small->modalities[0]);
+    assert(multimodal_data_find_source(small, "mic0") == &small->modalities[0]);
+    assert(multimodal_data_find_source(small, "cam0") == NULL);
+    multimodal_data_destroy(small);
+
+    // 普通模式同样支持按引用添加和索引查找
+    MultiModalData* plain = multimodal_data_create(1);
+    for (uint32_t i = 0; i < reference->modality_count; i++) {
+        assert(multimodal_data_adopt(plain, &reference->modalities[i]) == 0);
+    }
+    assert(multimodal_data_get(plain, MODALITY_TEXT) == &plain->modalities[2]);
+    assert(multimodal_data_find_source(plain, "mic0") == &plain->modalities[1]);
+    assert(multimodal_data_remove(plain, MODALITY_IMAGE) == 0);
+    assert(multimodal_data_get(plain, MODALITY_TEXT) == &plain->modalities[1]);
+    multimodal_data_destroy(plain);
+
+    multimodal_data_destroy(bundle);
+    multimodal_data_destroy(reference);
+    printf("✅ 多模态 arena 容器测试通过\n");
+}
+
+// 构造对齐测试用的样本
+static ModalityData sync_sample(uint64_t timestamp, const float* values, uint32_t count) {
+    ModalityData modal;
+    memset(&modal, 0, sizeof(modal));
+    modal.data = (void*)values;
+    modal.data_size = count * sizeof(float);
+    modal.data_type = TENSOR_TYPE_FLOAT32;
+    modal.timestamp = timestamp;
+    return modal;
+}
+
+// 测试多传感器时间戳对齐
+void test_multimodal_sync(void) {
+    printf("测试多传感器时间戳对齐...\n");
+
+    multimodal_sync_source_t sources[] = {
+        { "cam0", MODALITY_IMAGE, 8, 64, false },
+        { "lidar0", MODALITY_LIDAR, 32, 64, false },
+        { "imu0", MODALITY_SENSOR, 32, 64, true },
+    };
+    multimodal_sync_config_t config = { 0, 4, 0 };
+    multimodal_sync_t sync = multimodal_sync_create(sources, 3, &config);
+    assert(sync != NULL);
+
+    MultiModalData* bundle = NULL;
+    assert(multimodal_sync_poll(sync, &bundle) == MULTIMODAL_SYNC_PENDING);
+
+    // 相机每33个单位一帧，激光雷达每10个单位一帧，IMU 每8个单位一个读数（值等于时间戳）
+    float frame[4] = {1, 2, 3, 4};
+    for (uint64_t t = 0; t <= 200; t++) {
+        if (t % 33 == 0) {
+            ModalityData modal = sync_sample(t, frame, 4);
+            assert(multimodal_sync_push(sync, 0, &modal) == 0);
+        }
+        if (t % 10 == 0) {
+            ModalityData modal = sync_sample(t, frame, 2);
+            modal.metadata = "{\"scan\":1}";
+            assert(multimodal_sync_push(sync, 1, &modal) == 0);
+        }
+        if (t % 8 == 0) {
+            float value[2] = {(float)t, (float)t * 2.0f};
+            ModalityData modal = sync_sample(t, value, 2);
+            assert(multimodal_sync_push(sync, 2, &modal) == 0);
+        }
+    }
+
+    // 锚点 0、33、66、99、132、165、198：激光雷达误差分别为 0、3、4、1、2、5（丢弃）、2
+    const uint64_t expected_anchor[] = {0, 33, 66, 99, 132, 198};
+    const uint64_t expected_lidar[] = {0, 30, 70, 100, 130, 200};
+    uint32_t emitted = 0;
+    while (multimodal_sync_poll(sync, &bundle) == 0) {
+        assert(emitted < 6);
+        assert(bundle->modality_count == 3);
+
+        ModalityData* camera = multimodal_data_get(bundle, MODALITY_IMAGE);
+        ModalityData* lidar = multimodal_data_find_source(bundle, "lidar0");
+        ModalityData* imu = multimodal_data_get(bundle, MODALITY_SENSOR);
+        assert(camera->timestamp == expected_anchor[emitted]);
+        assert(memcmp(camera->data, frame, sizeof(frame)) == 0);
+        assert(lidar->timestamp == expected_lidar[emitted]);
+        assert(strcmp(lidar->metadata, "{\"scan\":1}") == 0);
+
+        // IMU 插值到锚点时间
+        const float* value = imu->data;
+        assert(imu->timestamp == camera->timestamp);
+        assert(value[0] == (float)camera->timestamp && value[1] == (float)camera->timestamp * 2.0f);
+        emitted++;
+    }
+    assert(emitted == 6);
+
+    // 激光雷达还没有锚点之后的帧时等待，参考源前进超过 max_latency 后用已有的帧
+    ModalityData modal = sync_sample(230, frame, 2);
+    assert(multimodal_sync_push(sync, 1, &modal) == 0);
+    modal = sync_sample(232, frame, 2);
+    assert(multimodal_sync_push(sync, 2, &modal) == 0);
+    modal = sync_sample(231, frame, 4);
+    assert(multimodal_sync_push(sync, 0, &modal) == 0);
+    assert(multimodal_sync_poll(sync, &bundle) == MULTIMODAL_SYNC_PENDING);
+    modal = sync_sample(240, frame, 4);
+    assert(multimodal_sync_push(sync, 0, &modal) == 0);
+    assert(multimodal_sync_poll(sync, &bundle) == 0);
+    assert(multimodal_data_get(bundle, MODALITY_IMAGE)->timestamp == 231);
+    assert(multimodal_data_get(bundle, MODALITY_LIDAR)->timestamp == 230);
+    assert(multimodal_data_get(bundle, MODALITY_SENSOR)->timestamp == 232);
+    assert(multimodal_sync_poll(sync, &bundle) == MULTIMODAL_SYNC_PENDING);
+
+    multimodal_sync_stats_t stats;
+    multimodal_sync_source_stats_t lidar_stats, imu_stats;
+    assert(multimodal_sync_get_stats(sync, &stats) == 0);
+    assert(multimodal_sync_get_source_stats(sync, 1, &lidar_stats) == 0);
+    assert(multimodal_sync_get_source_stats(sync, 2, &imu_stats) == 0);
+    assert(stats.bundles == 7 && stats.unmatched == 1);
+    assert(lidar_stats.pushed == 22 && lidar_stats.matched == 7);
+    assert(lidar_stats.max_error == 4 && lidar_stats.mean_error == 13.0 / 7.0);
+    assert(lidar_stats.dropped_overflow == 0 && lidar_stats.dropped_stale > 0);
+    assert(imu_stats.interpolated == 5 && imu_stats.matched == 7);
+
+    // 缓冲区满、样本过大和时间戳倒退都被丢弃并计数
+    ModalityData big = sync_sample(300, frame, 4);
+    big.metadata = "0123456789012345678901234567890123456789012345678901";
+    assert(multimodal_sync_push(sync, 0, &big) != 0);
+    ModalityData old = sync_sample(1, frame, 1);
+    assert(multimodal_sync_push(sync, 0, &old) != 0);
+    for (uint64_t t = 300; t < 310; t++) {
+        ModalityData modal = sync_sample(t, frame, 1);
+        assert(multimodal_sync_push(sync, 0, &modal) == (t < 307 ? 0 : -1));
+    }
+    multimodal_sync_source_stats_t camera_stats;
+    assert(multimodal_sync_get_source_stats(sync, 0, &camera_stats) == 0);
+    assert(camera_stats.dropped_overflow == 5);
+    multimodal_sync_destroy(sync);
+
+    // 无效配置
+    logger_set_level(LOG_LEVEL_FATAL);
+    config.reference = 3;
+    assert(multimodal_sync_create(sources, 3, &config) == NULL);
+    config.reference = 0;
+    sources[1].max_sample_size = 0;
+    assert(multimodal_sync_create(sources, 3, &config) == NULL);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    printf("✅ 多传感器时间戳对齐测试通过\n");
+}
+
+typedef struct {
+    multimodal_sync_t sync;
+    uint32_t source;
+    uint64_t period;
+    uint64_t end;
+} sync_producer_t;
+
+static void* sync_producer_func(void* arg) {
+    sync_producer_t* producer = arg;
+    float value[8] = {0};
+    for (uint64_t t = 0; t < producer->end; t += producer->period) {
+        value[0] = (float)t;
+        ModalityData modal = sync_sample(t, value, 8);
+        // 缓冲区满时重试，测试中不丢样本
+        while (multimodal_sync_push(producer->sync, producer->source, &modal) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// 测试生产者和消费者并发运行
+void test_multimodal_sync_concurrent(void) {
+    printf("测试多传感器并发对齐...\n");
+
+    multimodal_sync_source_t sources[] = {
+        { "cam0", MODALITY_IMAGE, 4, 32, false },
+        { "lidar0", MODALITY_LIDAR, 8, 32, false },
+    };
+    multimodal_sync_config_t config = { 0, 3, 50 };
+    multimodal_sync_t sync = multimodal_sync_create(sources, 2, &config);
+    assert(sync != NULL);
+
+    sync_producer_t producers[] = {
+        { sync, 0, 10, 20000 },
+        { sync, 1, 4, 20010 },
+    };
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        assert(pthread_create(&threads[i], NULL, sync_producer_func, &producers[i]) == 0);
+    }
+
+    uint32_t emitted = 0;
+    uint64_t last = 0;
+    while (emitted < 2000) {
+        MultiModalData* bundle = NULL;
+        int result = multimodal_sync_poll(sync, &bundle);
+        assert(result == 0 || result == MULTIMODAL_SYNC_PENDING);
+        if (result != 0) {
+            sched_yield();
+            continue;
+        }
+
+        const ModalityData* camera = &bundle->modalities[0];
+        const ModalityData* lidar = &bundle->modalities[1];
+        assert(camera->timestamp == emitted * 10 && (emitted == 0 || camera->timestamp > last));
+        assert(((const float*)camera->data)[0] == (float)camera->timestamp);
+        assert(((const float*)lidar->data)[0] == (float)lidar->timestamp);
+        uint64_t error = camera->timestamp > lidar->timestamp ? camera->timestamp - lidar->timestamp
+                                                              : lidar->timestamp - camera->timestamp;
+        assert(error <= 2);
+        last = camera->timestamp;
+        emitted++;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    multimodal_sync_stats_t stats;
+    assert(multimodal_sync_get_stats(sync, &stats) == 0);
+    assert(stats.bundles == 2000 && stats.unmatched == 0);
+    multimodal_sync_destroy(sync);
+
+    printf("✅ 多传感器并发对齐测试通过\n");
+}
+
+// 测试用转换函数：每个字节加上 context 中的偏移，并可选地忙等一段时间模拟耗时
+typedef struct {
+    int add;
+    int multiply;
+    double spin_us;
+    bool fail;
+} convert_step_t;
+
+static int test_convert_func(const ModalityData* input, DataFormat target_format, ModalityData* output,
+                             void* context) {
+    const convert_step_t* step = context;
+    if (step->fail) return -1;
+
+    if (step->spin_us > 0) {
+        struct timespec start, now;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        do {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+        } while ((now.tv_sec - start.tv_sec) * 1e6 + (now.tv_nsec - start.tv_nsec) / 1e3 < step->spin_us);
+    }
+
+    uint8_t* data = malloc(input->data_size);
+    if (!data) return -1;
+    const uint8_t* src = input->data;
+    for (size_t i = 0; i < input->data_size; i++) {
+        data[i] = (uint8_t)((src[i] + step->add) * step->multiply);
+    }
+
+    *output = *input;
+    output->borrowed = false;
+    output->format = target_format;
+    output->data = data;
+    output->metadata = NULL;
+    output->source_id = input->source_id ? strdup(input->source_id) : NULL;
+    return 0;
+}
+
+// 测试格式转换路径规划
+void test_multimodal_convert(void) {
+    printf("测试格式转换路径规划...\n");
+
+    convert_step_t decode = {1, 1, 0, false};
+    convert_step_t gray = {0, 2, 0, false};
+    convert_step_t fused = {1, 2, 20000, false};
+    convert_step_t broken = {0, 1, 0, true};
+    ModalityConverter decode_converter = modality_converter_create(test_convert_func, &decode);
+    ModalityConverter gray_converter = modality_converter_create(test_convert_func, &gray);
+    ModalityConverter fused_converter = modality_converter_create(test_convert_func, &fused);
+    ModalityConverter broken_converter = modality_converter_create(test_convert_func, &broken);
+    assert(decode_converter && gray_converter && fused_converter && broken_converter);
+
+    modality_convert_graph_t graph = modality_convert_graph_create();
+    assert(graph != NULL);
+
+    modality_convert_edge_t edge = { DATA_FORMAT_JPEG, DATA_FORMAT_RGB, decode_converter, 0, false };
+    assert(modality_convert_graph_register(graph, &edge) == 0);
+    edge = (modality_convert_edge_t){ DATA_FORMAT_RGB, DATA_FORMAT_GRAY, gray_converter, 0, false };
+    assert(modality_convert_graph_register(graph, &edge) == 0);
+
+    // 两步路径
+    modality_convert_plan_t plan;
+    assert(modality_convert_graph_plan(graph, DATA_FORMAT_JPEG, DATA_FORMAT_GRAY, &plan) == 0);
+    assert(plan.step_count == 2);
+    assert(plan.formats[0] == DATA_FORMAT_JPEG && plan.formats[1] == DATA_FORMAT_RGB && plan.formats[2] == DATA_FORMAT_GRAY);
+    assert(plan.cost == 2 * MODALITY_CONVERT_DEFAULT_COST);
+
+    uint8_t pixels[] = {0, 1, 2, 3, 100};
+    ModalityData input;
+    memset(&input, 0, sizeof(input));
+    input.modality = MODALITY_IMAGE;
+    input.format = DATA_FORMAT_JPEG;
+    input.data = pixels;
+    input.data_size = sizeof(pixels);
+    input.source_id = "cam0";
+
+    ModalityData output;
+    assert(modality_convert_graph_convert(graph, &input, DATA_FORMAT_GRAY, &output) == 0);
+    assert(output.format == DATA_FORMAT_GRAY && output.data_size == sizeof(pixels));
+    for (size_t i = 0; i < sizeof(pixels); i++) {
+        assert(((uint8_t*)output.data)[i] == (uint8_t)((pixels[i] + 1) * 2));
+    }
+    assert(strcmp(output.source_id, "cam0") == 0);
+    free(output.data);
+    free(output.source_id);
+
+    // 执行后代价变为实测值
+    double cost = 0;
+    uint64_t calls = 0;
+    assert(modality_convert_graph_get_cost(graph, DATA_FORMAT_JPEG, DATA_FORMAT_RGB, &cost, &calls) == 0);
+    assert(calls == 1 && cost < MODALITY_CONVERT_DEFAULT_COST);
+
+    // 注册融合边后优先使用（未实测时取两步路径的代价）
+    edge = (modality_convert_edge_t){ DATA_FORMAT_JPEG, DATA_FORMAT_GRAY, fused_converter, 0, true };
+    assert(modality_convert_graph_register(graph, &edge) == 0);
+    edge = (modality_convert_edge_t){ DATA_FORMAT_RGB, DATA_FORMAT_GRAY, gray_converter, 0, false };
+    assert(modality_convert_graph_plan(graph, DATA_FORMAT_JPEG, DATA_FORMAT_GRAY, &plan) == 0);
+    assert(plan.step_count == 1 && plan.fused[0]);
+
+    // 融合边实测很慢，重新规划回到两步路径
+    assert(modality_convert_graph_convert(graph, &input, DATA_FORMAT_GRAY, &output) == 0);
+    assert(((uint8_t*)output.data)[4] == (uint8_t)((100 + 1) * 2));
+    free(output.data);
+    free(output.source_id);
+    assert(modality_convert_graph_get_cost(graph, DATA_FORMAT_JPEG, DATA_FORMAT_GRAY, &cost, NULL) == 0);
+    assert(cost >= 20000);
+    assert(modality_convert_graph_plan(graph, DATA_FORMAT_JPEG, DATA_FORMAT_GRAY, &plan) == 0);
+    assert(plan.step_count == 2 && !plan.fused[0] && !plan.fused[1]);
+
+    // 源和目标相同时复制
+    assert(modality_convert_graph_convert(graph, &input, DATA_FORMAT_JPEG, &output) == 0);
+    assert(output.data != input.data && memcmp(output.data, pixels, sizeof(pixels)) == 0);
+    free(output.data);
+    free(output.source_id);
+
+    // 不可达和转换失败
+    logger_set_level(LOG_LEVEL_FATAL);
+    assert(modality_convert_graph_plan(graph, DATA_FORMAT_GRAY, DATA_FORMAT_JPEG, &plan) != 0);
+    assert(modality_convert_graph_convert(graph, &input, DATA_FORMAT_PNG, &output) != 0);
+    edge = (modality_convert_edge_t){ DATA_FORMAT_GRAY, DATA_FORMAT_PNG, broken_converter, 0, false };
+    assert(modality_convert_graph_register(graph, &edge) == 0);
+    assert(modality_convert_graph_convert(graph, &input, DATA_FORMAT_PNG, &output) != 0);
+    edge.to = DATA_FORMAT_GRAY;
+    assert(modality_convert_graph_register(graph, &edge) != 0);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    modality_convert_graph_destroy(graph);
+    modality_converter_destroy(decode_converter);
+    modality_converter_destroy(gray_converter);
+    modality_converter_destroy(fused_converter);
+    modality_converter_destroy(broken_converter);
+
+    printf("✅ 格式转换路径规划测试通过\n");
+}
+
+// 测试多模态容器零拷贝序列化
+void test_multimodal_serialize(void) {
+    printf("测试多模态数据序列化...\n");
+
+    float image[3 * 4 * 5];
+    int16_t audio[37];
+    for (int i = 0; i < 60; i++) image[i] = (float)i * 0.25f;
+    for (int i = 0; i < 37; i++) audio[i] = (int16_t)(i * 100 - 1800);
+
+    MultiModalData* bundle = create_sample_bundle(image, audio);
+    size_t size = multimodal_data_serialized_size(bundle);
+    assert(size > 0);
+
+    uint8_t* buffer = aligned_alloc(MULTIMODAL_SERIALIZE_ALIGNMENT,
+                                    (size + MULTIMODAL_SERIALIZE_ALIGNMENT - 1) & ~(size_t)(MULTIMODAL_SERIALIZE_ALIGNMENT - 1));
+    assert(buffer != NULL);
+    size_t written = 0;
+    assert(multimodal_data_serialize(bundle, buffer, size, &written) == 0);
+    assert(written == size);
+
+    MultiModalData* view = multimodal_data_deserialize(buffer, size);
+    assert(view != NULL);
+    assert(view->modality_count == bundle->modality_count);
+    assert(strcmp(view->session_id, "session-42") == 0);
+    assert(view->created_time == bundle->created_time);
+
+    for (uint32_t i = 0; i < view->modality_count; i++) {
+        const ModalityData* modal = &view->modalities[i];
+        assert_modality_equal(modal, &bundle->modalities[i]);
+        assert(modal->borrowed);
+
+        // 数据和字符串直接指向缓冲区，且数据对齐
+        if (modal->data_size > 0) {
+            assert((const uint8_t*)modal->data >= buffer && (const uint8_t*)modal->data < buffer + size);
+            assert(((uintptr_t)modal->data % MULTIMODAL_SERIALIZE_ALIGNMENT) == 0);
+        } else {
+            assert(modal->data == NULL);
+        }
+    }
+
+    // 视图可以复制成独立容器
+    MultiModalData* owned = multimodal_data_create(0);
+    assert(multimodal_data_add(owned, multimodal_data_get(view, MODALITY_AUDIO)) == 0);
+    assert(!owned->modalities[0].borrowed);
+    assert(owned->modalities[0].data != multimodal_data_get(view, MODALITY_AUDIO)->data);
+
+    multimodal_data_destroy(view);
+    multimodal_data_destroy(owned);
+
+    // 缓冲区不足、截断和损坏的数据都应该被拒绝
+    logger_set_level(LOG_LEVEL_FATAL);
+    assert(multimodal_data_serialize(bundle, buffer, size - 1, NULL) != 0);
+    assert(multimodal_data_deserialize(buffer, size - 1) == NULL);
+
+    uint8_t* corrupt = malloc(size);
+    memcpy(corrupt, buffer, size);
+    corrupt[0] = 'X';
+    assert(multimodal_data_deserialize(corrupt, size) == NULL);
+
+    // 把第一条记录的数据偏移指向缓冲区之外
+    memcpy(corrupt, buffer, size);
+    uint64_t bad_offset = (uint64_t)size + MULTIMODAL_SERIALIZE_ALIGNMENT;
+    memcpy(corrupt + 64 + 64, &bad_offset, sizeof(bad_offset));
+    assert(multimodal_data_deserialize(corrupt, size) == NULL);
+
+    // 形状声明的字节数与负载大小不一致
+    memcpy(corrupt, buffer, size);
+    uint32_t big_dims[] = {1, 400, 400};
+    memcpy(corrupt + 64 + 16, big_dims, sizeof(big_dims));
+    assert(multimodal_data_deserialize(corrupt, size) == NULL);
+
+    // 形状乘积溢出
+    memcpy(corrupt, buffer, size);
+    uint32_t overflow_dims[] = {8, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu};
+    uint32_t overflow_ndim = 4;
+    memcpy(corrupt + 64 + 12, &overflow_ndim, sizeof(overflow_ndim));
+    memcpy(corrupt + 64 + 16, overflow_dims, sizeof(overflow_dims));
+    assert(multimodal_data_deserialize(corrupt, size) == NULL);
+
+    // 未知的模态、格式和数据类型
+    for (uint32_t field = 0; field < 3; field++) {
+        memcpy(corrupt, buffer, size);
+        uint32_t bad_enum = 0x7FFFFFFFu;
+        memcpy(corrupt + 64 + 4 * field, &bad_enum, sizeof(bad_enum));
+        assert(multimodal_data_deserialize(corrupt, size) == NULL);
+    }
+    free(corrupt);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    free(buffer);
+    multimodal_data_destroy(bundle);
+
+    printf("✅ 多模态数据序列化测试通过\n");
+}
+
+// 测试单个模态序列化
+void test_modality_serialize(void) {
+    printf("测试单个模态序列化...\n");
+
+    uint8_t pixels[48];
+    for (int i = 0; i < 48; i++) pixels[i] = (uint8_t)(i * 5);
+
+    ModalityData* modal = modality_data_create(MODALITY_IMAGE, DATA_FORMAT_GRAY, pixels, sizeof(pixels));
+    assert(modal != NULL);
+    uint32_t dims[] = {6, 8};
+    modal->shape = tensor_shape_create(dims, 2);
+    modal->source_id = strdup("ir0");
+
+    int size = modality_data_serialize(modal, NULL, 0);
+    assert(size > 0);
+    void* buffer = malloc((size_t)size);
+    assert(modality_data_serialize(modal, buffer, (size_t)size) == size);
+
+    ModalityData view;
+    assert(modality_data_deserialize(buffer, (size_t)size, &view) == 0);
+    assert_modality_equal(&view, modal);
+    assert(view.borrowed);
+
+    // 借用的数据不归副本所有
+    ModalityData* copy = modality_data_copy(&view);
+    assert(copy != NULL && !copy->borrowed);
+    assert_modality_equal(copy, modal);
+    modality_data_destroy(copy);
+
+    free(buffer);
+    modality_data_destroy(modal);
+
+    printf("✅ 单个模态序列化测试通过\n");
+}
+
+// 压缩后解压并与原数据比较
+static size_t codec_roundtrip(const void* data, size_t size, const tensor_codec_options_t* options) {
+    size_t capacity = tensor_codec_compress_bound(size);
+    uint8_t* packed = malloc(capacity);
+    uint8_t* unpacked = malloc(size + 1);
+    size_t written = 0;
+    size_t restored = 0;
+    assert(tensor_codec_compress(data, size, options, packed, capacity, &written) == 0);
+    assert(written <= capacity);
+    assert(tensor_codec_decompress(packed, written, unpacked, size, &restored) == 0);
+    assert(restored == size);
+    assert(size == 0 || memcmp(unpacked, data, size) == 0);
+    free(packed);
+    free(unpacked);
+    return written;
+}
+
+// 测试张量无损压缩：各种选项和边界大小都能还原，重排和差分提高压缩率
+void test_tensor_codec(void) {
+    printf("测试张量无损压缩...\n");
+
+    // 跨越多个块，末尾不足一个元素
+    size_t count = TENSOR_CODEC_BLOCK_SIZE / 2 + 1001;
+    size_t size = count * sizeof(int16_t) + 3;
+    uint8_t* raw = malloc(size);
+    int16_t sample = 0;
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        sample = (int16_t)(sample + (int)((seed >> 16) % 7) - 3);
+        memcpy(raw + 2 * i, &sample, 2);
+    }
+    raw[size - 3] = 1;
+    raw[size - 2] = 2;
+    raw[size - 1] = 3;
+
+    size_t sizes[] = {0, 1, 7, 8, 15, 16, 17, 63, 64, 127, 1000, 4096, size};
+    uint32_t widths[] = {1, 2, 4, 8};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (uint32_t w = 0; w < 4; w++) {
+            for (int shuffle = TENSOR_CODEC_SHUFFLE_NONE; shuffle <= TENSOR_CODEC_SHUFFLE_BIT; shuffle++) {
+                for (int delta = 0; delta < 2; delta++) {
+                    tensor_codec_options_t options = { widths[w], (tensor_codec_shuffle_e)shuffle, delta != 0 };
+                    codec_roundtrip(raw, sizes[s], &options);
+                }
+            }
+        }
+    }
+
+    // 缓慢变化的采样：差分加字节重排明显优于直接压缩
+    tensor_codec_options_t plain = { 2, TENSOR_CODEC_SHUFFLE_NONE, false };
+    tensor_codec_options_t tuned = { 2, TENSOR_CODEC_SHUFFLE_BYTE, true };
+    size_t plain_size = codec_roundtrip(raw, size, &plain);
+    size_t tuned_size = codec_roundtrip(raw, size, &tuned);
+    printf("采样数据: 原始 %zu, 直接压缩 %zu, 差分+重排 %zu\n", size, plain_size, tuned_size);
+    assert(tuned_size < plain_size);
+    assert(tuned_size < size * 3 / 4);
+
+    // 不可压缩的数据按原样存储，开销有界
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245u + 12345u;
+        raw[i] = (uint8_t)(seed >> 24);
+    }
+    assert(codec_roundtrip(raw, size, &plain) <= tensor_codec_compress_bound(size));
+
+    // 损坏或截断的帧必须被拒绝，不能越界
+    memset(raw, 0, size);
+    size_t capacity = tensor_codec_compress_bound(size);
+    uint8_t* packed = malloc(capacity);
+    uint8_t* out = malloc(size);
+    size_t written = 0;
+    size_t restored = 0;
+    assert(tensor_codec_compress(raw, size, &tuned, packed, capacity, &written) == 0);
+    logger_set_level(LOG_LEVEL_FATAL);
+    assert(tensor_codec_decompress(packed, written - 1, out, size, &restored) != 0);
+    assert(tensor_codec_decompress(packed, written, out, size - 1, &restored) != 0);
+    for (size_t i = 24; i < written; i += 7) {
+        uint8_t saved = packed[i];
+        packed[i] ^= 0x5A;
+        // 可能恰好仍是合法的流，只要求不崩溃且输出不越界
+        tensor_codec_decompress(packed, written, out, size, &restored);
+        packed[i] = saved;
+    }
+    logger_set_level(LOG_LEVEL_INFO);
+    free(packed);
+    free(out);
+    free(raw);
+
+    printf("✅ 张量无损压缩测试通过\n");
+}
+
+// 测试模态数据压缩：描述字段保留，数据无损还原
+void test_modality_compress(void) {
+    printf("测试模态数据压缩...\n");
+
+    int16_t audio[4000];
+    for (int i = 0; i < 4000; i++) audio[i] = (int16_t)((i % 200) * 40 - 4000);
+
+    ModalityData* modal = modality_data_create(MODALITY_AUDIO, DATA_FORMAT_PCM, audio, sizeof(audio));
+    assert(modal != NULL);
+    uint32_t dims[] = {1, 4000};
+    modal->shape = tensor_shape_create(dims, 2);
+    modal->data_type = TENSOR_TYPE_INT16;
+    modal->source_id = strdup("mic0");
+    modal->sequence_id = 9;
+
+    ModalityData compressed;
+    assert(modality_data_compress(modal, &compressed) == 0);
+    assert(compressed.data_size < modal->data_size / 4);
+    assert(compressed.modality == MODALITY_AUDIO && compressed.sequence_id == 9);
+    assert(strcmp(compressed.source_id, "mic0") == 0);
+
+    ModalityData restored;
+    assert(modality_data_decompress(&compressed, &restored) == 0);
+    assert_modality_equal(&restored, modal);
+
+    // 未压缩的数据不能当作压缩帧解压
+    logger_set_level(LOG_LEVEL_FATAL);
+    ModalityData invalid;
+    assert(modality_data_decompress(modal, &invalid) != 0);
+    logger_set_level(LOG_LEVEL_INFO);
+
+    free(compressed.data);
+    free(compressed.source_id);
+    free(restored.data);
+    free(restored.source_id);
+    modality_data_destroy(modal);
+
+    printf("✅ 模态数据压缩测试通过\n");
+}
+
+int main(void) {
+    // 初始化日志系统
+    logger_init(LOG_LEVEL_INFO, NULL);
+    logger_set_console_output(true);
+
+    printf("=== 多模态数据单元测试 ===\n");
+
+    test_multimodal_arena();
+    test_multimodal_sync();
+    test_multimodal_sync_concurrent();
+    test_multimodal_convert();
+    test_multimodal_serialize();
+    test_modality_serialize();
+    test_tensor_codec();
+    test_modality_compress();
+
+    printf("\n🎉 所有多模态数据测试通过！\n");
+
+    logger_cleanup();
+    return 0;
+}
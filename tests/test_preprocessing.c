@@ -0,0 +1,1895 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "core/tensor.h"
+#include "utils/preprocessing.h"
+#include "utils/audio_utils.h"
+#include "utils/tokenizer.h"
+#include "utils/pointcloud_utils.h"
+#include "utils/logger.h"
+
+/**
+ * @brief 预处理单元测试
+ */
+
+#ifdef MODYN_TEST_COUNT_ALLOCS
+#include <stdatomic.h>
+
+// 链接时以 --wrap 包装堆分配函数，统计包括线程池工作线程在内的分配次数
+static atomic_ulong g_alloc_count;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+int __real_posix_memalign(void** ptr, size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    atomic_fetch_add(&g_alloc_count, 1);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    atomic_fetch_add(&g_alloc_count, 1);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    atomic_fetch_add(&g_alloc_count, 1);
+    return __real_realloc(ptr, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size) {
+    atomic_fetch_add(&g_alloc_count, 1);
+    return __real_aligned_alloc(alignment, size);
+}
+
+int __wrap_posix_memalign(void** ptr, size_t alignment, size_t size) {
+    atomic_fetch_add(&g_alloc_count, 1);
+    return __real_posix_memalign(ptr, alignment, size);
+}
+
+// 预热执行一次后，重复执行不应再分配堆内存（输出缓冲区沿用预热时的分配）
+static void assert_execute_without_allocs(preprocess_pipeline_t pipeline, const Tensor* input) {
+    Tensor output = {0};
+    assert(preprocess_pipeline_execute(pipeline, input, &output) == 0);
+
+    unsigned long before = atomic_load(&g_alloc_count);
+    for (int run = 0; run < 10; run++) {
+        assert(preprocess_pipeline_execute(pipeline, input, &output) == 0);
+    }
+    assert(atomic_load(&g_alloc_count) == before);
+    tensor_free(&output);
+}
+#endif
+
+// 创建随机填充的 UINT8 NHWC 图像
+static Tensor make_u8_image(uint32_t n, uint32_t h, uint32_t w, uint32_t c) {
+    uint32_t dims[] = {n, h, w, c};
+    TensorShape shape = tensor_shape_create(dims, 4);
+    Tensor tensor = tensor_create("image", TENSOR_TYPE_UINT8, &shape, TENSOR_FORMAT_NHWC);
+
+    tensor.data = malloc(tensor.size);
+    tensor.owns_data = true;
+    assert(tensor.data != NULL);
+
+    uint8_t* data = (uint8_t*)tensor.data;
+    for (size_t i = 0; i < tensor.size; i++) {
+        data[i] = (uint8_t)((i * 37 + (i / 7) * 11) & 0xFF);
+    }
+
+    return tensor;
+}
+
+static preprocess_op_t make_crop(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    preprocess_params_t params = {0};
+    params.params.crop.x = x;
+    params.params.crop.y = y;
+    params.params.crop.width = w;
+    params.params.crop.height = h;
+    return preprocess_op_create(PREPROCESS_CROP, &params);
+}
+
+static preprocess_op_t make_resize(uint32_t w, uint32_t h, interpolation_method_e method) {
+    preprocess_params_t params = {0};
+    params.params.resize.width = w;
+    params.params.resize.height = h;
+    params.params.resize.method = method;
+    return preprocess_op_create(PREPROCESS_RESIZE, &params);
+}
+
+static preprocess_op_t make_normalize(void) {
+    preprocess_params_t params = {0};
+    params.params.normalize.channels = 3;
+    params.params.normalize.mean[0] = 123.675f;
+    params.params.normalize.mean[1] = 116.28f;
+    params.params.normalize.mean[2] = 103.53f;
+    params.params.normalize.std[0] = 58.395f;
+    params.params.normalize.std[1] = 57.12f;
+    params.params.normalize.std[2] = 57.375f;
+    return preprocess_op_create(PREPROCESS_NORMALIZE, &params);
+}
+
+static preprocess_op_t make_to_nchw(void) {
+    preprocess_params_t params = {0};
+    uint32_t perm[] = {0, 3, 1, 2};
+    params.params.transpose.ndim = 4;
+    memcpy(params.params.transpose.perm, perm, sizeof(perm));
+    return preprocess_op_create(PREPROCESS_TRANSPOSE, &params);
+}
+
+static preprocess_op_t make_flip(bool horizontal, bool vertical) {
+    preprocess_params_t params = {0};
+    params.params.flip.horizontal = horizontal;
+    params.params.flip.vertical = vertical;
+    return preprocess_op_create(PREPROCESS_FLIP, &params);
+}
+
+static preprocess_op_t make_cast(TensorDataType dtype) {
+    preprocess_params_t params = {0};
+    params.params.cast.dtype = dtype;
+    return preprocess_op_create(PREPROCESS_CAST, &params);
+}
+
+// 比较两个输出张量
+static void assert_tensors_close(const Tensor* a, const Tensor* b, float tolerance) {
+    assert(a->dtype == b->dtype);
+    assert(a->format == b->format);
+    assert(tensor_shape_equal(&a->shape, &b->shape));
+    assert(a->size == b->size);
+
+    uint32_t count = tensor_get_element_count(a);
+    if (a->dtype == TENSOR_TYPE_FLOAT32) {
+        const float* pa = (const float*)a->data;
+        const float* pb = (const float*)b->data;
+        for (uint32_t i = 0; i < count; i++) {
+            assert(fabsf(pa[i] - pb[i]) <= tolerance);
+        }
+    } else {
+        assert(memcmp(a->data, b->data, a->size) == 0);
+    }
+}
+
+// 测试融合执行与逐操作执行结果一致
+void test_fused_pipeline_matches_per_op(void) {
+    printf("测试融合管道与逐操作执行一致...\n");
+
+    Tensor image = make_u8_image(1, 64, 80, 3);
+
+    preprocess_pipeline_t fused = preprocess_pipeline_create();
+    preprocess_pipeline_t plain = preprocess_pipeline_create();
+    assert(fused && plain);
+
+    preprocess_pipeline_t pipelines[] = {fused, plain};
+    for (int i = 0; i < 2; i++) {
+        assert(preprocess_pipeline_add_op(pipelines[i], make_crop(4, 6, 60, 50)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(32, 24, INTERPOLATION_LINEAR)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_normalize()) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_to_nchw()) == 0);
+    }
+    assert(preprocess_pipeline_set_fusion(plain, false) == 0);
+
+    Tensor out_fused = {0};
+    Tensor out_plain = {0};
+    assert(preprocess_pipeline_execute(fused, &image, &out_fused) == 0);
+    assert(preprocess_pipeline_execute(plain, &image, &out_plain) == 0);
+
+    assert(out_fused.dtype == TENSOR_TYPE_FLOAT32);
+    assert(out_fused.format == TENSOR_FORMAT_NCHW);
+    assert(out_fused.shape.ndim == 4);
+    assert(out_fused.shape.dims[1] == 3);
+    assert(out_fused.shape.dims[2] == 24);
+    assert(out_fused.shape.dims[3] == 32);
+    assert_tensors_close(&out_fused, &out_plain, 1e-4f);
+
+    preprocess_fusion_stats_t stats;
+    assert(preprocess_pipeline_get_fusion_stats(fused, &stats) == 0);
+    assert(stats.fused_groups == 1);
+    assert(stats.fused_ops == 4);
+    assert(stats.fallback_ops == 0);
+    assert(stats.executions == 1);
+    assert(stats.fused_bytes < stats.unfused_bytes);
+
+    assert(preprocess_pipeline_get_fusion_stats(plain, &stats) == 0);
+    assert(stats.fused_groups == 0);
+    assert(stats.fallback_ops == 4);
+
+    tensor_free(&out_fused);
+    tensor_free(&out_plain);
+    preprocess_pipeline_destroy(fused);
+    preprocess_pipeline_destroy(plain);
+    tensor_free(&image);
+
+    printf("✅ 融合管道一致性测试通过\n");
+}
+
+// 测试不可融合操作回退为逐操作执行
+void test_fusion_fallback(void) {
+    printf("测试不可融合操作回退...\n");
+
+    Tensor image = make_u8_image(2, 40, 30, 3);
+
+    preprocess_pipeline_t fused = preprocess_pipeline_create();
+    preprocess_pipeline_t plain = preprocess_pipeline_create();
+
+    preprocess_pipeline_t pipelines[] = {fused, plain};
+    for (int i = 0; i < 2; i++) {
+        // 整型线性缩放、三次插值（不可融合）、翻转 + 转回 UINT8
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(25, 33, INTERPOLATION_LINEAR)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_flip(true, false)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(20, 16, INTERPOLATION_CUBIC)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_crop(2, 1, 16, 12)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_flip(false, true)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_cast(TENSOR_TYPE_FLOAT32)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_cast(TENSOR_TYPE_UINT8)) == 0);
+    }
+    assert(preprocess_pipeline_set_fusion(plain, false) == 0);
+
+    Tensor out_fused = {0};
+    Tensor out_plain = {0};
+    assert(preprocess_pipeline_execute(fused, &image, &out_fused) == 0);
+    assert(preprocess_pipeline_execute(plain, &image, &out_plain) == 0);
+    assert(out_fused.dtype == TENSOR_TYPE_UINT8);
+    assert_tensors_close(&out_fused, &out_plain, 0.0f);
+
+    preprocess_fusion_stats_t stats;
+    assert(preprocess_pipeline_get_fusion_stats(fused, &stats) == 0);
+    assert(stats.fused_groups == 2);
+    assert(stats.fused_ops == 6);
+    assert(stats.fallback_ops == 1);
+
+    tensor_free(&out_fused);
+    tensor_free(&out_plain);
+    preprocess_pipeline_destroy(fused);
+    preprocess_pipeline_destroy(plain);
+    tensor_free(&image);
+
+    printf("✅ 回退执行测试通过\n");
+}
+
+// 测试分块并行执行与串行结果一致
+void test_parallel_pipeline_matches_serial(void) {
+    printf("测试分块并行执行...\n");
+    
+    Tensor image = make_u8_image(1, 720, 1280, 3);
+    
+    preprocess_pipeline_t parallel = preprocess_pipeline_create();
+    preprocess_pipeline_t serial = preprocess_pipeline_create();
+    
+    preprocess_pipeline_t pipelines[] = {parallel, serial};
+    for (int i = 0; i < 2; i++) {
+        // 未融合的逐操作路径和融合路径都需要覆盖
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(640, 360, INTERPOLATION_LINEAR)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(600, 340, INTERPOLATION_CUBIC)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_crop(10, 20, 512, 300)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_normalize()) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_to_nchw()) == 0);
+    }
+    assert(preprocess_pipeline_set_parallel(parallel, 4) == 0);
+    assert(preprocess_pipeline_set_parallel(serial, 0) != 0);
+    
+    for (int fusion = 0; fusion <= 1; fusion++) {
+        assert(preprocess_pipeline_set_fusion(parallel, fusion != 0) == 0);
+        assert(preprocess_pipeline_set_fusion(serial, fusion != 0) == 0);
+        
+        Tensor out_parallel = {0};
+        Tensor out_serial = {0};
+        assert(preprocess_pipeline_execute(parallel, &image, &out_parallel) == 0);
+        assert(preprocess_pipeline_execute(serial, &image, &out_serial) == 0);
+        assert(out_parallel.shape.dims[2] == 300 && out_parallel.shape.dims[3] == 512);
+        assert_tensors_close(&out_parallel, &out_serial, 0.0f);
+        
+        tensor_free(&out_parallel);
+        tensor_free(&out_serial);
+    }
+    
+    preprocess_pipeline_destroy(parallel);
+    preprocess_pipeline_destroy(serial);
+    tensor_free(&image);
+    
+    printf("✅ 分块并行执行测试通过\n");
+}
+
+// 测试批量执行写入连续批量张量
+void test_batch_execute(void) {
+    printf("测试批量执行...\n");
+    
+    const uint32_t batch = 5;
+    Tensor images[5];
+    for (uint32_t i = 0; i < batch; i++) {
+        // 最后一个样本尺寸不同，覆盖非一致输入的串行路径
+        images[i] = i == batch - 1 ? make_u8_image(1, 90, 70, 3) : make_u8_image(1, 120, 160, 3);
+        uint8_t* data = (uint8_t*)images[i].data;
+        for (size_t j = 0; j < images[i].size; j++) {
+            data[j] = (uint8_t)(data[j] + i * 13);
+        }
+    }
+    
+    preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+    assert(preprocess_pipeline_add_op(pipeline, make_resize(64, 48, INTERPOLATION_LINEAR)) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, make_normalize()) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, make_to_nchw()) == 0);
+    assert(preprocess_pipeline_set_parallel(pipeline, 3) == 0);
+    
+    for (uint32_t count = batch - 1; count <= batch; count++) {
+        Tensor out = {0};
+        assert(preprocess_pipeline_execute_batch(pipeline, images, &out, count) == 0);
+        assert(out.format == TENSOR_FORMAT_NCHW);
+        assert(out.shape.ndim == 4);
+        assert(out.shape.dims[0] == count && out.shape.dims[1] == 3);
+        assert(out.shape.dims[2] == 48 && out.shape.dims[3] == 64);
+        
+        // 每个切片与单独执行结果一致
+        size_t item_bytes = out.size / count;
+        for (uint32_t i = 0; i < count; i++) {
+            Tensor single = {0};
+            assert(preprocess_pipeline_execute(pipeline, &images[i], &single) == 0);
+            assert(single.size == item_bytes);
+            assert(memcmp((uint8_t*)out.data + i * item_bytes, single.data, item_bytes) == 0);
+            tensor_free(&single);
+        }
+        
+        tensor_free(&out);
+    }
+    
+    // 输出形状不一致的批量应失败
+    preprocess_pipeline_t flip_only = preprocess_pipeline_create();
+    assert(preprocess_pipeline_add_op(flip_only, make_flip(true, false)) == 0);
+    Tensor out = {0};
+    assert(preprocess_pipeline_execute_batch(flip_only, images, &out, batch) != 0);
+    tensor_free(&out);
+    
+    preprocess_pipeline_destroy(flip_only);
+    preprocess_pipeline_destroy(pipeline);
+    for (uint32_t i = 0; i < batch; i++) {
+        tensor_free(&images[i]);
+    }
+    
+    printf("✅ 批量执行测试通过\n");
+}
+
+// 测试中间结果复用乒乓缓冲区
+void test_scratch_reuse(void) {
+    printf("测试中间缓冲区复用...\n");
+    
+    Tensor image = make_u8_image(1, 64, 80, 3);
+    
+    preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+    assert(preprocess_pipeline_add_op(pipeline, make_crop(4, 6, 60, 50)) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, make_resize(32, 24, INTERPOLATION_LINEAR)) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, make_flip(true, true)) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, make_normalize()) == 0);
+    assert(preprocess_pipeline_add_op(pipeline, make_to_nchw()) == 0);
+    assert(preprocess_pipeline_set_fusion(pipeline, false) == 0);
+    
+    Tensor first = {0};
+    assert(preprocess_pipeline_execute(pipeline, &image, &first) == 0);
+    
+    preprocess_fusion_stats_t stats;
+    assert(preprocess_pipeline_get_fusion_stats(pipeline, &stats) == 0);
+    uint64_t warmup_allocs = stats.scratch_allocs;
+    assert(warmup_allocs > 0 && warmup_allocs <= 4);
+    
+    // 输入形状不变时不再分配中间缓冲区
+    for (int i = 0; i < 3; i++) {
+        Tensor out = {0};
+        assert(preprocess_pipeline_execute(pipeline, &image, &out) == 0);
+        assert_tensors_close(&out, &first, 0.0f);
+        tensor_free(&out);
+    }
+    assert(preprocess_pipeline_get_fusion_stats(pipeline, &stats) == 0);
+    assert(stats.scratch_allocs == warmup_allocs);
+    assert(stats.executions == 4);
+    
+    tensor_free(&first);
+    preprocess_pipeline_destroy(pipeline);
+    tensor_free(&image);
+    
+    printf("✅ 中间缓冲区复用测试通过\n");
+}
+
+static preprocess_op_t make_photometric(preprocess_type_e type, float value) {
+    preprocess_params_t params = {0};
+    switch (type) {
+        case PREPROCESS_BRIGHTNESS: params.params.brightness.factor = value; break;
+        case PREPROCESS_CONTRAST: params.params.contrast.factor = value; break;
+        case PREPROCESS_GAMMA: params.params.gamma.gamma = value; break;
+        default: break;
+    }
+    return preprocess_op_create(type, &params);
+}
+
+// 测试查找表操作组合与逐操作结果一致
+void test_lut_composition(void) {
+    printf("测试查找表组合...\n");
+    
+    // 像素值集中在 [60, 124)，便于检验直方图均衡化的拉伸效果
+    Tensor image = make_u8_image(2, 30, 40, 3);
+    uint8_t* pixels = (uint8_t*)image.data;
+    for (size_t i = 0; i < image.size; i++) {
+        pixels[i] = (uint8_t)(60 + pixels[i] % 64);
+    }
+    
+    preprocess_pipeline_t fused = preprocess_pipeline_create();
+    preprocess_pipeline_t plain = preprocess_pipeline_create();
+    
+    preprocess_pipeline_t pipelines[] = {fused, plain};
+    for (int i = 0; i < 2; i++) {
+        preprocess_op_t brightness = make_photometric(PREPROCESS_BRIGHTNESS, 1.3f);
+        assert(preprocess_op_set_cache(brightness, true) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], brightness) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_photometric(PREPROCESS_CONTRAST, 1.5f)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_photometric(PREPROCESS_HISTOGRAM_EQ, 0.0f)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_photometric(PREPROCESS_GAMMA, 0.8f)) == 0);
+    }
+    assert(preprocess_pipeline_set_fusion(plain, false) == 0);
+    
+    for (int run = 0; run < 2; run++) {
+        Tensor out_fused = {0};
+        Tensor out_plain = {0};
+        assert(preprocess_pipeline_execute(fused, &image, &out_fused) == 0);
+        assert(preprocess_pipeline_execute(plain, &image, &out_plain) == 0);
+        assert(out_fused.dtype == TENSOR_TYPE_UINT8);
+        assert_tensors_close(&out_fused, &out_plain, 0.0f);
+        
+        // 均衡化后每个通道应覆盖接近完整的取值范围
+        const uint8_t* out = (const uint8_t*)out_fused.data;
+        uint8_t lo = 255, hi = 0;
+        for (size_t i = 0; i < out_fused.size; i += 3) {
+            if (out[i] < lo) lo = out[i];
+            if (out[i] > hi) hi = out[i];
+        }
+        assert(lo < 16 && hi > 240);
+        
+        tensor_free(&out_fused);
+        tensor_free(&out_plain);
+    }
+    
+    preprocess_fusion_stats_t stats;
+    assert(preprocess_pipeline_get_fusion_stats(fused, &stats) == 0);
+    assert(stats.fused_groups == 1 && stats.fused_ops == 4);
+    assert(stats.fused_bytes < stats.unfused_bytes);
+    
+    // 非 UINT8 输入不支持
+    preprocess_op_t gamma = make_photometric(PREPROCESS_GAMMA, 2.2f);
+    preprocess_op_t to_float = make_cast(TENSOR_TYPE_FLOAT32);
+    Tensor as_float = {0};
+    assert(preprocess_op_execute(to_float, &image, &as_float) == 0);
+    Tensor rejected = {0};
+    assert(preprocess_op_execute(gamma, &as_float, &rejected) != 0);
+    tensor_free(&rejected);
+    tensor_free(&as_float);
+    preprocess_op_destroy(gamma);
+    preprocess_op_destroy(to_float);
+    assert(make_photometric(PREPROCESS_GAMMA, 0.0f) == NULL);
+    
+    preprocess_pipeline_destroy(fused);
+    preprocess_pipeline_destroy(plain);
+    tensor_free(&image);
+    
+    printf("✅ 查找表组合测试通过\n");
+}
+
+// 生成 16kHz 正弦波加少量噪声
+static Tensor make_tone(uint32_t rows, uint32_t samples, float freq) {
+    uint32_t dims[] = {rows, samples};
+    TensorShape shape = tensor_shape_create(dims, 2);
+    Tensor tone = tensor_create("audio", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NC);
+    
+    tone.data = malloc(tone.size);
+    tone.owns_data = true;
+    assert(tone.data != NULL);
+    
+    float* data = (float*)tone.data;
+    for (uint32_t r = 0; r < rows; r++) {
+        for (uint32_t i = 0; i < samples; i++) {
+            float noise = (rand() % 1000 - 500) / 50000.0f;
+            data[(size_t)r * samples + i] = 0.5f * sinf(6.2831853f * freq * (r + 1) * i / 16000.0f) + noise;
+        }
+    }
+    return tone;
+}
+
+// 测试音频特征：频谱峰值位置、并行与串行一致、流式输入与整段计算一致
+void test_audio_features(void) {
+    printf("测试音频特征...\n");
+    
+    Tensor tone = make_tone(2, 16000, 1000.0f);
+    
+    // 幅度谱峰值应落在 1kHz / 2kHz 对应的频点
+    preprocess_params_t params = {0};
+    params.params.fft.n_fft = 512;
+    params.params.fft.hop_length = 160;
+    params.params.fft.win_length = 400;
+    preprocess_op_t fft = preprocess_op_create(PREPROCESS_FFT, &params);
+    assert(fft != NULL);
+    
+    Tensor spectrum = {0};
+    assert(preprocess_op_execute(fft, &tone, &spectrum) == 0);
+    assert(spectrum.shape.ndim == 3 && spectrum.shape.dims[0] == 2);
+    assert(spectrum.shape.dims[1] == 1 + (16000 - 512) / 160 && spectrum.shape.dims[2] == 257);
+    for (uint32_t r = 0; r < 2; r++) {
+        const float* frame = (const float*)spectrum.data + (size_t)r * spectrum.shape.dims[1] * 257;
+        uint32_t peak = 0;
+        for (uint32_t k = 1; k < 257; k++) {
+            if (frame[k] > frame[peak]) peak = k;
+        }
+        assert(peak == 32 * (r + 1));
+    }
+    
+    // MFCC 在管道中按帧并行，结果与串行一致
+    memset(&params, 0, sizeof(params));
+    params.params.mfcc.n_mfcc = 13;
+    params.params.mfcc.n_fft = 400;
+    params.params.mfcc.hop_length = 160;
+    preprocess_pipeline_t serial = preprocess_pipeline_create();
+    preprocess_pipeline_t parallel = preprocess_pipeline_create();
+    assert(preprocess_pipeline_add_op(serial, preprocess_op_create(PREPROCESS_MFCC, &params)) == 0);
+    assert(preprocess_pipeline_add_op(parallel, preprocess_op_create(PREPROCESS_MFCC, &params)) == 0);
+    assert(preprocess_pipeline_set_parallel(parallel, 4) == 0);
+    
+    Tensor mfcc_serial = {0};
+    Tensor mfcc_parallel = {0};
+    assert(preprocess_pipeline_execute(serial, &tone, &mfcc_serial) == 0);
+    assert(preprocess_pipeline_execute(parallel, &tone, &mfcc_parallel) == 0);
+    assert(mfcc_serial.dtype == TENSOR_TYPE_FLOAT32 && mfcc_serial.shape.dims[2] == 13);
+    assert_tensors_close(&mfcc_serial, &mfcc_parallel, 0.0f);
+    
+    // 流式：不规则分块输入的结果与整段计算一致
+    audio_frontend_config_t config = audio_frontend_default_config(AUDIO_FEATURE_MEL);
+    audio_frontend_t batch = audio_frontend_create(&config);
+    audio_frontend_t stream = audio_frontend_create(&config);
+    assert(batch != NULL && stream != NULL);
+    assert(audio_frontend_get_feature_dim(stream) == 80);
+    
+    const float* samples = (const float*)tone.data;
+    uint32_t total = audio_frontend_get_frame_count(batch, 16000);
+    float* expected = malloc(sizeof(float) * total * 80);
+    float* actual = malloc(sizeof(float) * total * 80);
+    uint32_t frames = 0;
+    assert(audio_frontend_compute(batch, samples, 16000, expected, total, &frames) == 0 && frames == total);
+    
+    uint32_t produced = 0;
+    size_t offset = 0;
+    const size_t chunks[] = {7, 400, 1, 159, 1024, 333};
+    for (int i = 0; offset < 16000; i = (i + 1) % 6) {
+        size_t chunk = chunks[i] < 16000 - offset ? chunks[i] : 16000 - offset;
+        assert(audio_frontend_push(stream, samples + offset, chunk, actual + (size_t)produced * 80,
+                                   total - produced, &frames) == 0);
+        produced += frames;
+        offset += chunk;
+    }
+    assert(produced == total);
+    for (size_t i = 0; i < (size_t)total * 80; i++) {
+        assert(fabsf(actual[i] - expected[i]) < 1e-3f);
+    }
+    
+    // 重置后重新开始分帧
+    audio_frontend_reset(stream);
+    assert(audio_frontend_push(stream, samples, 399, actual, total, &frames) == 0 && frames == 0);
+    
+    // n_fft/2 含 7 因子时拒绝创建
+    config.n_fft = 448;
+    config.win_length = 0;
+    assert(audio_frontend_create(&config) == NULL);
+    
+    free(expected);
+    free(actual);
+    audio_frontend_destroy(batch);
+    audio_frontend_destroy(stream);
+    tensor_free(&mfcc_serial);
+    tensor_free(&mfcc_parallel);
+    preprocess_pipeline_destroy(serial);
+    preprocess_pipeline_destroy(parallel);
+    tensor_free(&spectrum);
+    preprocess_op_destroy(fft);
+    tensor_free(&tone);
+    
+    printf("✅ 音频特征测试通过\n");
+}
+
+// 测试重采样：正弦波幅相保持、分块流式与整段一致
+void test_resample(void) {
+    printf("测试重采样...\n");
+    
+    // 48kHz 正弦波降到 16kHz，两行频率不同
+    uint32_t dims[] = {2, 4800};
+    TensorShape shape = tensor_shape_create(dims, 2);
+    Tensor input = tensor_create("audio", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NC);
+    input.data = malloc(input.size);
+    input.owns_data = true;
+    assert(input.data != NULL);
+    
+    float* samples = (float*)input.data;
+    for (uint32_t r = 0; r < 2; r++) {
+        for (uint32_t i = 0; i < 4800; i++) {
+            samples[r * 4800 + i] = sinf(6.2831853f * 440.0f * (r + 1) * i / 48000.0f);
+        }
+    }
+    
+    preprocess_params_t params = {0};
+    params.params.resample.sample_rate = 48000;
+    params.params.resample.target_rate = 16000;
+    preprocess_op_t resample = preprocess_op_create(PREPROCESS_RESAMPLE, &params);
+    assert(resample != NULL);
+    
+    Tensor output = {0};
+    assert(preprocess_op_execute(resample, &input, &output) == 0);
+    assert(output.dtype == TENSOR_TYPE_FLOAT32);
+    assert(output.shape.ndim == 2 && output.shape.dims[0] == 2 && output.shape.dims[1] == 1600);
+    
+    // 远离两端的输出与理想正弦波一致
+    const float* resampled = (const float*)output.data;
+    for (uint32_t r = 0; r < 2; r++) {
+        for (uint32_t n = 100; n < 1500; n++) {
+            float expected = sinf(6.2831853f * 440.0f * (r + 1) * n / 16000.0f);
+            assert(fabsf(resampled[r * 1600 + n] - expected) < 1e-3f);
+        }
+    }
+    
+    // 44.1kHz -> 16kHz：不规则分块流式输入与整段结果一致
+    audio_resampler_t resampler = audio_resampler_create(44100, 16000);
+    assert(resampler != NULL);
+    size_t length = audio_resampler_get_output_length(resampler, 4800);
+    assert(length == (4800 * 160 + 440) / 441);
+    
+    float* expected = malloc(sizeof(float) * length);
+    float* actual = malloc(sizeof(float) * length);
+    size_t count = 0;
+    assert(audio_resampler_convert(resampler, samples, 4800, expected, length, &count) == 0 && count == length);
+    
+    size_t produced = 0;
+    size_t offset = 0;
+    const size_t chunks[] = {1, 441, 37, 160, 1000};
+    for (int i = 0; offset < 4800; i = (i + 1) % 5) {
+        size_t chunk = chunks[i] < 4800 - offset ? chunks[i] : 4800 - offset;
+        assert(audio_resampler_process(resampler, samples + offset, chunk, actual + produced,
+                                       length - produced, &count) == 0);
+        produced += count;
+        offset += chunk;
+    }
+    assert(produced < length);
+    assert(audio_resampler_flush(resampler, actual + produced, length - produced, &count) == 0);
+    produced += count;
+    assert(produced == length);
+    for (size_t i = 0; i < length; i++) {
+        assert(fabsf(actual[i] - expected[i]) < 1e-5f);
+    }
+    
+    free(expected);
+    free(actual);
+    audio_resampler_destroy(resampler);
+    tensor_free(&output);
+    preprocess_op_destroy(resample);
+    tensor_free(&input);
+    
+    params.params.resample.target_rate = 0;
+    assert(preprocess_op_create(PREPROCESS_RESAMPLE, &params) == NULL);
+    
+    printf("✅ 重采样测试通过\n");
+}
+
+// 保存分词器后按 mutate 修改映像再加载，返回加载结果是否被拒绝
+// 映像开头是 11 个 32 位字段和 8 字节前缀，其后依次为 Trie 单元（12 字节）和合并表（16 字节）
+static bool tokenizer_load_rejects(tokenizer_t tokenizer, void (*mutate)(uint32_t* words, uint32_t* trie, uint32_t* merges)) {
+    const char* path = "test_tokenizer_corrupt.bin";
+    assert(tokenizer_save(tokenizer, path) == 0);
+    
+    FILE* fp = fopen(path, "rb");
+    assert(fp != NULL);
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint32_t* words = malloc((size_t)size);
+    assert(words != NULL && fread(words, 1, (size_t)size, fp) == (size_t)size);
+    fclose(fp);
+    
+    uint32_t* trie = words + 13;
+    uint32_t* merges = trie + words[8] * 3;
+    mutate(words, trie, merges);
+    
+    fp = fopen(path, "wb");
+    assert(fp != NULL && fwrite(words, 1, (size_t)size, fp) == (size_t)size);
+    fclose(fp);
+    free(words);
+    
+    logger_set_level(LOG_LEVEL_FATAL);
+    tokenizer_t loaded = tokenizer_load(path);
+    logger_set_level(LOG_LEVEL_INFO);
+    remove(path);
+    tokenizer_destroy(loaded);
+    return loaded == NULL;
+}
+
+// 合并表所有槽都被占用（探测不会终止）
+static void fill_merge_slots(uint32_t* words, uint32_t* trie, uint32_t* merges) {
+    (void)trie;
+    for (uint32_t i = 0; i < words[9]; i++) {
+        merges[i * 4 + 0] = 2;
+        merges[i * 4 + 1] = 2 + i % 6;
+        merges[i * 4 + 2] = i;
+        merges[i * 4 + 3] = 5;
+    }
+}
+
+static void corrupt_merged_id(uint32_t* words, uint32_t* trie, uint32_t* merges) {
+    (void)trie;
+    for (uint32_t i = 0; i < words[9]; i++) {
+        if (merges[i * 4] != UINT32_MAX) merges[i * 4 + 3] = words[5];
+    }
+}
+
+static void corrupt_trie_value(uint32_t* words, uint32_t* trie, uint32_t* merges) {
+    (void)merges;
+    trie[words[8] * 3 - 1] = words[5] + 7;
+}
+
+static void corrupt_unk_id(uint32_t* words, uint32_t* trie, uint32_t* merges) {
+    (void)trie;
+    (void)merges;
+    words[6] = words[5];
+}
+
+static void corrupt_type(uint32_t* words, uint32_t* trie, uint32_t* merges) {
+    (void)trie;
+    (void)merges;
+    words[2] = 7;
+}
+
+// 单词长度上限超过编码时栈上数组的容量
+static void corrupt_max_word_chars(uint32_t* words, uint32_t* trie, uint32_t* merges) {
+    (void)trie;
+    (void)merges;
+    words[4] = 100000;
+}
+
+static void keep_image(uint32_t* words, uint32_t* trie, uint32_t* merges) {
+    (void)words;
+    (void)trie;
+    (void)merges;
+}
+
+// 测试分词：WordPiece 最长匹配、BPE 合并顺序、映射加载与批量补齐
+void test_tokenize(void) {
+    printf("测试分词...\n");
+    
+    const char* vocab[] = {"[PAD]", "[UNK]", "un", "##aff", "##able", "aff", "the", "中", "文", ","};
+    tokenizer_config_t config = tokenizer_default_config(TOKENIZER_WORDPIECE);
+    tokenizer_t wordpiece = tokenizer_create(&config, vocab, 10, NULL, 0);
+    assert(wordpiece != NULL);
+    assert(tokenizer_get_vocab_size(wordpiece) == 10 && tokenizer_get_pad_id(wordpiece) == 0);
+    assert(tokenizer_token_to_id(wordpiece, "##able") == 4 && tokenizer_token_to_id(wordpiece, "##") == -1);
+    
+    // 大小写归一、子词切分、未知词、标点和汉字单独成词
+    const char* text = "UnAffable the xyz,中文";
+    const int32_t expected[] = {2, 3, 4, 6, 1, 9, 7, 8};
+    int32_t ids[16];
+    uint32_t count = 0;
+    assert(tokenizer_encode(wordpiece, text, strlen(text), ids, 16, &count) == 0);
+    assert(count == 8 && memcmp(ids, expected, sizeof(expected)) == 0);
+    
+    // 超出容量时截断
+    assert(tokenizer_encode(wordpiece, text, strlen(text), ids, 3, &count) == 0 && count == 3);
+    
+    // 保存后以映射方式加载，结果一致
+    const char* path = "test_tokenizer.bin";
+    assert(tokenizer_save(wordpiece, path) == 0);
+    tokenizer_t mapped = tokenizer_load(path);
+    assert(mapped != NULL);
+    assert(tokenizer_encode(mapped, text, strlen(text), ids, 16, &count) == 0);
+    assert(count == 8 && memcmp(ids, expected, sizeof(expected)) == 0);
+    assert(strcmp(tokenizer_id_to_token(mapped, 3), "##aff") == 0);
+    tokenizer_destroy(mapped);
+    remove(path);
+    
+    // BPE 按规则优先级合并："b c" 先于 "a b"
+    const char* bpe_vocab[] = {"<pad>", "<unk>", "a", "b", "c", "ab", "bc", "abc"};
+    const char* merges[] = {"b c", "a b", "a bc"};
+    config = tokenizer_default_config(TOKENIZER_BPE);
+    tokenizer_t bpe = tokenizer_create(&config, bpe_vocab, 8, merges, 3);
+    assert(bpe != NULL);
+    const char* bpe_text = "abc abcab";
+    assert(tokenizer_encode(bpe, bpe_text, strlen(bpe_text), ids, 16, &count) == 0);
+    assert(count == 3 && ids[0] == 7 && ids[1] == 7 && ids[2] == 5);
+    
+    // 损坏的映像在加载时被拒绝，而不是在分词时越界或死循环
+    assert(!tokenizer_load_rejects(bpe, keep_image));
+    assert(tokenizer_load_rejects(bpe, fill_merge_slots));
+    assert(tokenizer_load_rejects(bpe, corrupt_merged_id));
+    assert(tokenizer_load_rejects(bpe, corrupt_trie_value));
+    assert(tokenizer_load_rejects(bpe, corrupt_unk_id));
+    assert(tokenizer_load_rejects(bpe, corrupt_type));
+    assert(tokenizer_load_rejects(bpe, corrupt_max_word_chars));
+    
+    // 分词操作：每条文本输出 max_length 个 id，不足部分补齐
+    const char* texts[] = {"abc", "ab ab ab ab ab", ""};
+    uint32_t dims[] = {3};
+    TensorShape shape = tensor_shape_create(dims, 1);
+    Tensor input = tensor_create("text", TENSOR_TYPE_STRING, &shape, TENSOR_FORMAT_N);
+    input.data = (void*)texts;
+    input.owns_data = false;
+    
+    preprocess_params_t params = {0};
+    params.params.tokenize.tokenizer = bpe;
+    params.params.tokenize.max_length = 4;
+    preprocess_op_t tokenize = preprocess_op_create(PREPROCESS_TOKENIZE, &params);
+    assert(tokenize != NULL);
+    
+    Tensor output = {0};
+    assert(preprocess_op_execute(tokenize, &input, &output) == 0);
+    assert(output.dtype == TENSOR_TYPE_INT32);
+    assert(output.shape.ndim == 2 && output.shape.dims[0] == 3 && output.shape.dims[1] == 4);
+    const int32_t expected_batch[] = {7, 0, 0, 0, 5, 5, 5, 5, 0, 0, 0, 0};
+    assert(memcmp(output.data, expected_batch, sizeof(expected_batch)) == 0);
+    
+    tensor_free(&output);
+    preprocess_op_destroy(tokenize);
+    tensor_free(&input);
+    tokenizer_destroy(bpe);
+    tokenizer_destroy(wordpiece);
+    
+    params.params.tokenize.tokenizer = NULL;
+    assert(preprocess_op_create(PREPROCESS_TOKENIZE, &params) == NULL);
+    
+    printf("✅ 分词测试通过\n");
+}
+
+static Tensor make_points(uint32_t count, uint32_t channels) {
+    uint32_t dims[] = {count, channels};
+    TensorShape shape = tensor_shape_create(dims, 2);
+    Tensor points = tensor_create("points", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NC);
+    points.data = malloc(points.size);
+    points.owns_data = true;
+    assert(points.data != NULL);
+    return points;
+}
+
+// 测试点云：k-d 树查询与暴力搜索一致、体素降采样、离群点去除和法向量
+void test_pointcloud(void) {
+    printf("测试点云处理...\n");
+    
+    const uint32_t count = 10000;
+    Tensor cloud = make_points(count, 4);
+    float* pts = (float*)cloud.data;
+    for (uint32_t i = 0; i < count * 4; i++) {
+        pts[i] = (float)rand() / RAND_MAX * 10.0f;
+    }
+    
+    kdtree_t serial = kdtree_build(pts, count, 4, 1);
+    kdtree_t parallel = kdtree_build(pts, count, 4, 4);
+    assert(serial && parallel && kdtree_get_count(parallel) == count);
+    
+    for (uint32_t q = 0; q < 50; q++) {
+        const float* query = pts + (rand() % count) * 4;
+        uint32_t a[8], b[8];
+        float da[8];
+        assert(kdtree_knn(serial, query, 8, a, da) == 8);
+        assert(kdtree_knn(parallel, query, 8, b, NULL) == 8);
+        assert(da[0] == 0.0f);
+        
+        // 第 8 近的距离与暴力搜索一致，半径查询计数一致
+        uint32_t closer = 0;
+        uint32_t within = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            const float* p = pts + i * 4;
+            float d = (p[0] - query[0]) * (p[0] - query[0]) + (p[1] - query[1]) * (p[1] - query[1]) +
+                      (p[2] - query[2]) * (p[2] - query[2]);
+            if (d < da[7]) closer++;
+            if (d <= 1.0f) within++;
+        }
+        assert(closer <= 7);
+        for (uint32_t i = 1; i < 8; i++) {
+            assert(da[i] >= da[i - 1]);
+        }
+        assert(memcmp(a, b, sizeof(a)) == 0 || da[7] == da[6]);
+        assert(kdtree_radius(parallel, query, 1.0f, NULL, NULL, 0) == within);
+    }
+    kdtree_destroy(serial);
+    kdtree_destroy(parallel);
+    
+    // 两个体素内各两个点：输出各通道的均值
+    const float grid[] = {0.0f, 0.0f, 0.0f, 1.0f,    0.5f, 0.5f, 0.5f, 3.0f,
+                          2.25f, 0.0f, 0.0f, 5.0f,   2.75f, 0.0f, 0.0f, 7.0f};
+    float reduced[16];
+    uint32_t kept = 0;
+    assert(pointcloud_voxel_downsample(grid, 4, 4, 1.0f, reduced, &kept) == 0 && kept == 2);
+    assert(reduced[0] == 0.25f && reduced[2] == 0.25f && reduced[3] == 2.0f);
+    assert(reduced[4] == 2.5f && reduced[5] == 0.0f && reduced[7] == 6.0f);
+    
+    preprocess_params_t params = {0};
+    params.params.downsample.target_points = 200;
+    preprocess_op_t downsample = preprocess_op_create(PREPROCESS_DOWNSAMPLE, &params);
+    assert(downsample != NULL);
+    Tensor output = {0};
+    assert(preprocess_op_execute(downsample, &cloud, &output) == 0);
+    assert(output.shape.dims[0] > 20 && output.shape.dims[0] <= 200 && output.shape.dims[1] == 4);
+    tensor_free(&output);
+    preprocess_op_destroy(downsample);
+    
+    // z = 1 平面上的网格加上 5 个远离平面的离群点
+    Tensor plane = make_points(405, 3);
+    float* pp = (float*)plane.data;
+    for (uint32_t i = 0; i < 400; i++) {
+        pp[i * 3 + 0] = (float)(i % 20) * 0.1f;
+        pp[i * 3 + 1] = (float)(i / 20) * 0.1f;
+        pp[i * 3 + 2] = 1.0f;
+    }
+    for (uint32_t i = 400; i < 405; i++) {
+        pp[i * 3 + 0] = (float)(i - 400) * 3.0f + 5.0f;
+        pp[i * 3 + 1] = 8.0f;
+        pp[i * 3 + 2] = 6.0f;
+    }
+    
+    memset(&params, 0, sizeof(params));
+    params.params.outlier_removal.k = 8;
+    params.params.outlier_removal.std_ratio = 1.0f;
+    preprocess_op_t outlier = preprocess_op_create(PREPROCESS_OUTLIER_REMOVAL, &params);
+    assert(outlier != NULL);
+    assert(preprocess_op_execute(outlier, &plane, &output) == 0);
+    assert(output.shape.dims[0] == 400 && output.shape.dims[1] == 3);
+    for (uint32_t i = 0; i < 400; i++) {
+        assert(((const float*)output.data)[i * 3 + 2] == 1.0f);
+    }
+    tensor_free(&output);
+    preprocess_op_destroy(outlier);
+    
+    // 平面内点的法向量垂直于平面并朝向原点
+    memset(&params, 0, sizeof(params));
+    params.params.normal_estimation.k = 10;
+    preprocess_op_t normals = preprocess_op_create(PREPROCESS_NORMAL_ESTIMATION, &params);
+    assert(normals != NULL);
+    assert(preprocess_op_execute(normals, &plane, &output) == 0);
+    assert(output.shape.dims[0] == 405 && output.shape.dims[1] == 6);
+    const float* with_normals = (const float*)output.data;
+    for (uint32_t i = 0; i < 400; i++) {
+        assert(with_normals[i * 6 + 2] == 1.0f);
+        assert(fabsf(with_normals[i * 6 + 3]) < 1e-4f && fabsf(with_normals[i * 6 + 4]) < 1e-4f);
+        assert(fabsf(with_normals[i * 6 + 5] + 1.0f) < 1e-4f);
+    }
+    tensor_free(&output);
+    preprocess_op_destroy(normals);
+    
+    params.params.normal_estimation.k = 2;
+    assert(preprocess_op_create(PREPROCESS_NORMAL_ESTIMATION, &params) == NULL);
+    
+    tensor_free(&plane);
+    tensor_free(&cloud);
+    
+    printf("✅ 点云处理测试通过\n");
+}
+
+// 测试输出形状推断
+void test_output_shape_inference(void) {
+    printf("测试输出形状推断...\n");
+
+    uint32_t dims[] = {1, 480, 640, 3};
+    TensorShape in_shape = tensor_shape_create(dims, 4);
+    TensorShape out_shape;
+
+    preprocess_op_t crop = make_crop(10, 20, 300, 200);
+    assert(preprocess_op_get_output_shape(crop, &in_shape, &out_shape) == 0);
+    assert(out_shape.dims[1] == 200 && out_shape.dims[2] == 300 && out_shape.dims[3] == 3);
+
+    preprocess_op_t transpose = make_to_nchw();
+    assert(preprocess_op_get_output_shape(transpose, &in_shape, &out_shape) == 0);
+    assert(out_shape.dims[1] == 3 && out_shape.dims[2] == 480 && out_shape.dims[3] == 640);
+
+    preprocess_op_t bad_crop = make_crop(600, 0, 100, 100);
+    assert(preprocess_op_get_output_shape(bad_crop, &in_shape, &out_shape) != 0);
+
+    preprocess_op_destroy(crop);
+    preprocess_op_destroy(transpose);
+    preprocess_op_destroy(bad_crop);
+
+    printf("✅ 输出形状推断测试通过\n");
+}
+
+// 测试静态缓冲区计划：按计划执行与动态执行结果一致且不再分配中间缓冲区
+void test_static_plan(void) {
+    printf("测试静态缓冲区计划...\n");
+
+    Tensor image = make_u8_image(2, 40, 30, 3);
+
+    preprocess_pipeline_t planned = preprocess_pipeline_create();
+    preprocess_pipeline_t dynamic = preprocess_pipeline_create();
+    preprocess_pipeline_t pipelines[] = {planned, dynamic};
+    for (int i = 0; i < 2; i++) {
+        // 融合组 + 不可融合的三次插值 + 融合组
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(25, 33, INTERPOLATION_LINEAR)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_flip(true, false)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(20, 16, INTERPOLATION_CUBIC)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_crop(2, 1, 16, 12)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_normalize()) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_to_nchw()) == 0);
+    }
+
+    preprocess_plan_info_t info;
+    assert(preprocess_pipeline_get_plan_info(planned, &info) != 0);
+
+    preprocess_plan_config_t config = {0};
+    config.input_shape = image.shape;
+    config.input_dtype = image.dtype;
+    config.input_format = image.format;
+    assert(preprocess_pipeline_plan(planned, &config) == 0);
+    assert(preprocess_pipeline_get_plan_info(planned, &info) == 0);
+    assert(info.output_dtype == TENSOR_TYPE_FLOAT32);
+    assert(info.output_format == TENSOR_FORMAT_NCHW);
+    assert(info.output_shape.ndim == 4 && info.output_shape.dims[2] == 12 && info.output_shape.dims[3] == 16);
+    assert(info.intermediate_count == 2);
+    assert(info.scratch_bytes > 0 && info.total_bytes == info.scratch_bytes);
+
+    Tensor expected = {0};
+    assert(preprocess_pipeline_execute(dynamic, &image, &expected) == 0);
+
+    Tensor output = {0};
+    for (int run = 0; run < 2; run++) {
+        assert(preprocess_pipeline_execute(planned, &image, &output) == 0);
+        assert_tensors_close(&output, &expected, 1e-4f);
+    }
+
+    preprocess_fusion_stats_t stats;
+    assert(preprocess_pipeline_get_fusion_stats(planned, &stats) == 0);
+    assert(stats.scratch_allocs == 0);
+    assert(stats.executions == 2);
+    assert(preprocess_pipeline_get_plan_info(planned, &info) == 0);
+    assert(info.planned_executions == 2);
+    tensor_free(&output);
+
+    // 形状不符时回退为动态执行，计划保留
+    Tensor other = make_u8_image(1, 40, 30, 3);
+    Tensor other_out = {0};
+    assert(preprocess_pipeline_execute(planned, &other, &other_out) == 0);
+    assert(other_out.shape.dims[0] == 1);
+    assert(preprocess_pipeline_get_plan_info(planned, &info) == 0);
+    assert(info.planned_executions == 2);
+    tensor_free(&other_out);
+    tensor_free(&other);
+
+    // 输出也从内存池中的计划缓冲区分配
+    memory_pool_config_t pool_config = {
+        .type = MEMORY_POOL_CPU,
+        .initial_size = 1 << 20,
+        .max_size = 1 << 20,
+        .grow_size = 1 << 16,
+        .alignment = 64,
+        .strategy = MEMORY_ALLOC_FIRST_FIT,
+        .enable_tracking = false,
+        .enable_debug = false,
+        .external_memory = NULL,
+        .external_size = 0
+    };
+    memory_pool_t pool = memory_pool_create(&pool_config);
+    assert(pool != NULL);
+    config.memory_pool = pool;
+    config.bind_output = true;
+    assert(preprocess_pipeline_set_parallel(planned, 4) == 0);
+    assert(preprocess_pipeline_plan(planned, &config) == 0);
+    assert(preprocess_pipeline_get_plan_info(planned, &info) == 0);
+    assert(info.total_bytes >= info.scratch_bytes + info.output_bytes);
+
+#ifdef MODYN_TEST_COUNT_ALLOCS
+    // 融合组的逐线程行缓冲区在计划时预留，按计划执行从第一次起就不再分配内存
+    unsigned long allocs = atomic_load(&g_alloc_count);
+#endif
+    Tensor bound = {0};
+    assert(preprocess_pipeline_execute(planned, &image, &bound) == 0);
+    assert(!bound.owns_data);
+    assert_tensors_close(&bound, &expected, 1e-4f);
+    void* first = bound.data;
+    for (int run = 0; run < 10; run++) {
+        assert(preprocess_pipeline_execute(planned, &image, &bound) == 0);
+        assert(bound.data == first);
+    }
+#ifdef MODYN_TEST_COUNT_ALLOCS
+    assert(atomic_load(&g_alloc_count) == allocs);
+#endif
+
+    preprocess_pipeline_clear_plan(planned);
+    assert(preprocess_pipeline_get_plan_info(planned, &info) != 0);
+    memory_pool_destroy(pool);
+
+    // 输出形状依赖数据的操作无法计划
+    preprocess_pipeline_t cloud = preprocess_pipeline_create();
+    preprocess_params_t params = {0};
+    params.params.downsample.voxel_size = 0.5f;
+    assert(preprocess_pipeline_add_op(cloud, preprocess_op_create(PREPROCESS_DOWNSAMPLE, &params)) == 0);
+    preprocess_plan_config_t cloud_config = {0};
+    cloud_config.input_shape.ndim = 2;
+    cloud_config.input_shape.dims[0] = 100;
+    cloud_config.input_shape.dims[1] = 3;
+    cloud_config.input_dtype = TENSOR_TYPE_FLOAT32;
+    cloud_config.input_format = TENSOR_FORMAT_NC;
+    assert(preprocess_pipeline_plan(cloud, &cloud_config) != 0);
+    preprocess_pipeline_destroy(cloud);
+
+    tensor_free(&expected);
+    preprocess_pipeline_destroy(planned);
+    preprocess_pipeline_destroy(dynamic);
+    tensor_free(&image);
+
+    printf("✅ 静态缓冲区计划测试通过\n");
+}
+
+static preprocess_op_t make_quantize(TensorDataType dtype, uint32_t channels, const float* scale,
+                                     const int32_t* zero_point) {
+    preprocess_params_t params = {0};
+    params.params.quantize.dtype = dtype;
+    params.params.quantize.channels = channels;
+    for (uint32_t c = 0; c < channels; c++) {
+        params.params.quantize.scale[c] = scale[c];
+        params.params.quantize.zero_point[c] = zero_point[c];
+    }
+    return preprocess_op_create(PREPROCESS_QUANTIZE, &params);
+}
+
+// 测试量化/反量化及其与归一化的融合
+void test_quantize(void) {
+    printf("测试量化与反量化...\n");
+
+    // 逐通道量化：覆盖饱和、非16倍数的长度和 NaN
+    uint32_t dims[] = {1, 7, 9, 3};
+    TensorShape shape = tensor_shape_create(dims, 4);
+    Tensor values = tensor_create("values", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NHWC);
+    values.data = malloc(values.size);
+    values.owns_data = true;
+    float* v = (float*)values.data;
+    uint32_t count = tensor_get_element_count(&values);
+    for (uint32_t i = 0; i < count; i++) {
+        v[i] = ((float)((i * 7919) % 1000) - 500.0f) / 97.0f;
+    }
+    v[5] = NAN;
+
+    const float scale[3] = {0.02f, 0.05f, 0.1f};
+    const int32_t zero_point[3] = {-3, 0, 10};
+    TensorDataType types[2] = {TENSOR_TYPE_INT8, TENSOR_TYPE_UINT8};
+    for (int t = 0; t < 2; t++) {
+        int32_t zp[3] = {zero_point[0], zero_point[1], zero_point[2]};
+        if (types[t] == TENSOR_TYPE_UINT8) {
+            zp[0] = 128; zp[1] = 100; zp[2] = 0;
+        }
+        float lo = types[t] == TENSOR_TYPE_INT8 ? -128.0f : 0.0f;
+        float hi = types[t] == TENSOR_TYPE_INT8 ? 127.0f : 255.0f;
+
+        preprocess_op_t quantize = make_quantize(types[t], 3, scale, zp);
+        assert(quantize != NULL);
+        Tensor q = {0};
+        assert(preprocess_op_execute(quantize, &values, &q) == 0);
+        assert(q.dtype == types[t] && tensor_shape_equal(&q.shape, &values.shape));
+
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t c = i % 3;
+            float expected = isnan(v[i]) ? lo : nearbyintf(fminf(fmaxf(v[i] * (1.0f / scale[c]) + zp[c], lo), hi));
+            float actual = types[t] == TENSOR_TYPE_INT8 ? ((int8_t*)q.data)[i] : ((uint8_t*)q.data)[i];
+            assert(actual == expected);
+        }
+
+        // 反量化后在未饱和处误差不超过半个量化步长
+        preprocess_params_t params = {0};
+        params.params.quantize.channels = 3;
+        memcpy(params.params.quantize.scale, scale, sizeof(scale));
+        memcpy(params.params.quantize.zero_point, zp, sizeof(zp));
+        preprocess_op_t dequantize = preprocess_op_create(PREPROCESS_DEQUANTIZE, &params);
+        assert(dequantize != NULL);
+        Tensor r = {0};
+        assert(preprocess_op_execute(dequantize, &q, &r) == 0);
+        assert(r.dtype == TENSOR_TYPE_FLOAT32);
+        const float* rv = (const float*)r.data;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t c = i % 3;
+            float raw = types[t] == TENSOR_TYPE_INT8 ? ((int8_t*)q.data)[i] : ((uint8_t*)q.data)[i];
+            assert(fabsf(rv[i] - (raw - zp[c]) * scale[c]) <= 1e-5f);
+            if (!isnan(v[i]) && raw > lo && raw < hi) {
+                assert(fabsf(rv[i] - v[i]) <= scale[c] * 0.5f + 1e-5f);
+            }
+        }
+
+        tensor_free(&q);
+        tensor_free(&r);
+        preprocess_op_destroy(quantize);
+        preprocess_op_destroy(dequantize);
+    }
+    tensor_free(&values);
+
+    // UINT8 图像经 归一化 -> 量化 -> NCHW 融合为一次遍历
+    Tensor image = make_u8_image(2, 30, 41, 3);
+    preprocess_pipeline_t fused = preprocess_pipeline_create();
+    preprocess_pipeline_t plain = preprocess_pipeline_create();
+    preprocess_pipeline_t pipelines[] = {fused, plain};
+    const float input_scale[1] = {0.0187f};
+    const int32_t input_zero_point[1] = {-2};
+    for (int i = 0; i < 2; i++) {
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(32, 24, INTERPOLATION_LINEAR)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_normalize()) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i],
+                                          make_quantize(TENSOR_TYPE_INT8, 1, input_scale, input_zero_point)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_to_nchw()) == 0);
+    }
+    assert(preprocess_pipeline_set_fusion(plain, false) == 0);
+
+    Tensor out_fused = {0};
+    Tensor out_plain = {0};
+    assert(preprocess_pipeline_execute(fused, &image, &out_fused) == 0);
+    assert(preprocess_pipeline_execute(plain, &image, &out_plain) == 0);
+    assert(out_fused.dtype == TENSOR_TYPE_INT8 && out_fused.format == TENSOR_FORMAT_NCHW);
+    assert(tensor_shape_equal(&out_fused.shape, &out_plain.shape));
+
+    // 复合仿射与逐步计算的舍入差异至多一个量化步长
+    const int8_t* a = (const int8_t*)out_fused.data;
+    const int8_t* b = (const int8_t*)out_plain.data;
+    for (size_t i = 0; i < out_fused.size; i++) {
+        assert(abs(a[i] - b[i]) <= 1);
+    }
+
+    preprocess_fusion_stats_t stats;
+    assert(preprocess_pipeline_get_fusion_stats(fused, &stats) == 0);
+    assert(stats.fused_groups == 1 && stats.fused_ops == 4 && stats.fallback_ops == 0);
+
+    tensor_free(&out_fused);
+    tensor_free(&out_plain);
+    preprocess_pipeline_destroy(fused);
+    preprocess_pipeline_destroy(plain);
+    tensor_free(&image);
+
+    // 从模型规格获取量化参数
+    model_io_spec_t spec = {0};
+    spec.data_type = TENSOR_TYPE_INT8;
+    spec.scale = 0.0187f;
+    spec.zero_point = -2;
+    preprocess_params_t params;
+    assert(preprocess_quantize_params_from_spec(&spec, PREPROCESS_QUANTIZE, &params) == 0);
+    assert(params.params.quantize.channels == 1 && params.params.quantize.dtype == TENSOR_TYPE_INT8);
+    assert(params.params.quantize.scale[0] == spec.scale && params.params.quantize.zero_point[0] == -2);
+    spec.data_type = TENSOR_TYPE_FLOAT32;
+    assert(preprocess_quantize_params_from_spec(&spec, PREPROCESS_QUANTIZE, &params) != 0);
+
+    printf("✅ 量化与反量化测试通过\n");
+}
+
+static preprocess_op_t make_color_convert(color_format_e src, color_format_e dst, color_standard_e standard) {
+    preprocess_params_t params = {0};
+    params.params.color_convert.src_format = src;
+    params.params.color_convert.dst_format = dst;
+    params.params.color_convert.standard = standard;
+    return preprocess_op_create(PREPROCESS_COLOR_CONVERT, &params);
+}
+
+// 按格式打包 YUV 帧：亮度逐像素，色度按 2x2（YUYV 为 2x1）块取左上角样本
+static Tensor make_yuv_frame(color_format_e format, uint32_t n, uint32_t h, uint32_t w) {
+    uint32_t dims[4];
+    uint32_t ndim = 0;
+    if (format == COLOR_FORMAT_YUYV) {
+        dims[ndim++] = n; dims[ndim++] = h; dims[ndim++] = w; dims[ndim++] = 2;
+    } else {
+        dims[ndim++] = n; dims[ndim++] = h * 3 / 2; dims[ndim++] = w;
+    }
+    TensorShape shape = tensor_shape_create(dims, ndim);
+    Tensor frame = tensor_create("frame", TENSOR_TYPE_UINT8, &shape, TENSOR_FORMAT_NHWC);
+    frame.data = calloc(1, frame.size);
+    frame.owns_data = true;
+
+    uint8_t* base = (uint8_t*)frame.data;
+    size_t frame_bytes = frame.size / n;
+    for (uint32_t b = 0; b < n; b++) {
+        uint8_t* f = base + b * frame_bytes;
+        for (uint32_t y = 0; y < h; y++) {
+            for (uint32_t x = 0; x < w; x++) {
+                uint8_t luma = (uint8_t)((x * 7 + y * 13 + b * 29) % 256);
+                uint8_t u = (uint8_t)(((x / 2) * 23 + (y / 2) * 5 + b) % 256);
+                uint8_t v = (uint8_t)(((x / 2) * 11 + (y / 2) * 31 + 3 * b) % 256);
+                switch (format) {
+                    case COLOR_FORMAT_YUYV:
+                        f[(y * w + x) * 2] = luma;
+                        f[(y * w + x) * 2 + 1] = (x % 2 == 0) ? u : v;
+                        break;
+                    case COLOR_FORMAT_NV12:
+                    case COLOR_FORMAT_NV21:
+                        f[y * w + x] = luma;
+                        if (x % 2 == 0 && y % 2 == 0) {
+                            uint8_t* uv = f + h * w + (y / 2) * w + x;
+                            uv[format == COLOR_FORMAT_NV12 ? 0 : 1] = u;
+                            uv[format == COLOR_FORMAT_NV12 ? 1 : 0] = v;
+                        }
+                        break;
+                    default:
+                        f[y * w + x] = luma;
+                        if (x % 2 == 0 && y % 2 == 0) {
+                            f[h * w + (y / 2) * (w / 2) + x / 2] = u;
+                            f[h * w + h * w / 4 + (y / 2) * (w / 2) + x / 2] = v;
+                        }
+                        break;
+                }
+            }
+        }
+    }
+    return frame;
+}
+
+// 测试 YUV 到 RGB/BGR 的转换及其与缩放、归一化的融合
+void test_color_convert(void) {
+    printf("测试颜色空间转换...\n");
+
+    const uint32_t n = 2, h = 10, w = 38;
+    color_format_e formats[] = {COLOR_FORMAT_NV12, COLOR_FORMAT_NV21, COLOR_FORMAT_I420, COLOR_FORMAT_YUYV};
+    Tensor reference = {0};
+
+    for (int f = 0; f < 4; f++) {
+        Tensor frame = make_yuv_frame(formats[f], n, h, w);
+        preprocess_op_t to_rgb = make_color_convert(formats[f], COLOR_FORMAT_RGB, COLOR_STANDARD_BT601);
+        assert(to_rgb != NULL);
+        Tensor rgb = {0};
+        assert(preprocess_op_execute(to_rgb, &frame, &rgb) == 0);
+        assert(rgb.dtype == TENSOR_TYPE_UINT8 && rgb.format == TENSOR_FORMAT_NHWC);
+        assert(rgb.shape.ndim == 4 && rgb.shape.dims[0] == n && rgb.shape.dims[1] == h &&
+               rgb.shape.dims[2] == w && rgb.shape.dims[3] == 3);
+
+        if (formats[f] != COLOR_FORMAT_YUYV) {
+            // 4:2:0 的三种打包方式结果完全一致，并与浮点 BT.601 公式相差不超过1
+            if (!reference.data) {
+                reference = rgb;
+                rgb.data = NULL;
+                const uint8_t* px = (const uint8_t*)reference.data;
+                const uint8_t* src = (const uint8_t*)frame.data;
+                for (uint32_t b = 0; b < n; b++) {
+                    for (uint32_t y = 0; y < h; y++) {
+                        for (uint32_t x = 0; x < w; x++) {
+                            const uint8_t* fr = src + b * (h * 3 / 2) * w;
+                            float yy = 1.164383f * (fr[y * w + x] - 16.0f);
+                            float u = fr[h * w + (y / 2) * w + (x / 2) * 2] - 128.0f;
+                            float v = fr[h * w + (y / 2) * w + (x / 2) * 2 + 1] - 128.0f;
+                            float expected[3] = {yy + 1.596027f * v, yy - 0.391762f * u - 0.812968f * v,
+                                                 yy + 2.017232f * u};
+                            const uint8_t* p = px + (((size_t)b * h + y) * w + x) * 3;
+                            for (int c = 0; c < 3; c++) {
+                                float e = fminf(fmaxf(expected[c], 0.0f), 255.0f);
+                                assert(fabsf(p[c] - e) <= 1.0f);
+                            }
+                        }
+                    }
+                }
+            } else {
+                assert(memcmp(rgb.data, reference.data, rgb.size) == 0);
+            }
+        }
+
+        // BGR 为 RGB 交换 R、B
+        preprocess_op_t to_bgr = make_color_convert(formats[f], COLOR_FORMAT_BGR, COLOR_STANDARD_BT709);
+        preprocess_op_t to_rgb709 = make_color_convert(formats[f], COLOR_FORMAT_RGB, COLOR_STANDARD_BT709);
+        Tensor bgr = {0};
+        Tensor rgb709 = {0};
+        assert(preprocess_op_execute(to_bgr, &frame, &bgr) == 0);
+        assert(preprocess_op_execute(to_rgb709, &frame, &rgb709) == 0);
+        const uint8_t* pb = (const uint8_t*)bgr.data;
+        const uint8_t* pr = (const uint8_t*)rgb709.data;
+        for (size_t i = 0; i < bgr.size; i += 3) {
+            assert(pb[i] == pr[i + 2] && pb[i + 1] == pr[i + 1] && pb[i + 2] == pr[i]);
+        }
+
+        tensor_free(&rgb);
+        tensor_free(&bgr);
+        tensor_free(&rgb709);
+        preprocess_op_destroy(to_rgb);
+        preprocess_op_destroy(to_bgr);
+        preprocess_op_destroy(to_rgb709);
+        tensor_free(&frame);
+    }
+    tensor_free(&reference);
+
+    // 奇数宽度或行数不是 3 的倍数的 4:2:0 帧无法解析
+    preprocess_op_t nv12 = make_color_convert(COLOR_FORMAT_NV12, COLOR_FORMAT_RGB, COLOR_STANDARD_BT601);
+    uint32_t bad_dims[] = {16, 15};
+    TensorShape bad_shape = tensor_shape_create(bad_dims, 2);
+    TensorShape out_shape;
+    assert(preprocess_op_get_output_shape(nv12, &bad_shape, &out_shape) != 0);
+    preprocess_op_destroy(nv12);
+
+    // NV12 帧 -> RGB -> 缩放 -> 归一化 -> NCHW 融合为一次遍历
+    Tensor frame = make_yuv_frame(COLOR_FORMAT_NV12, 1, 48, 64);
+    preprocess_pipeline_t fused = preprocess_pipeline_create();
+    preprocess_pipeline_t plain = preprocess_pipeline_create();
+    preprocess_pipeline_t pipelines[] = {fused, plain};
+    for (int i = 0; i < 2; i++) {
+        assert(preprocess_pipeline_add_op(pipelines[i], make_color_convert(COLOR_FORMAT_NV12, COLOR_FORMAT_RGB,
+                                                                           COLOR_STANDARD_BT601)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_resize(20, 15, INTERPOLATION_LINEAR)) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_normalize()) == 0);
+        assert(preprocess_pipeline_add_op(pipelines[i], make_to_nchw()) == 0);
+    }
+    assert(preprocess_pipeline_set_fusion(plain, false) == 0);
+
+    Tensor out_fused = {0};
+    Tensor out_plain = {0};
+    assert(preprocess_pipeline_execute(fused, &frame, &out_fused) == 0);
+    assert(preprocess_pipeline_execute(plain, &frame, &out_plain) == 0);
+    assert(out_fused.format == TENSOR_FORMAT_NCHW && out_fused.shape.dims[1] == 3);
+    assert_tensors_close(&out_fused, &out_plain, 1e-4f);
+
+    preprocess_fusion_stats_t stats;
+    assert(preprocess_pipeline_get_fusion_stats(fused, &stats) == 0);
+    assert(stats.fused_groups == 1 && stats.fused_ops == 4);
+
+    tensor_free(&out_fused);
+    tensor_free(&out_plain);
+    preprocess_pipeline_destroy(fused);
+    preprocess_pipeline_destroy(plain);
+    tensor_free(&frame);
+
+    printf("✅ 颜色空间转换测试通过\n");
+}
+
+// 按复制边界读取 NHWC 浮点图像的一个元素
+static float clamped_pixel(const float* img, int h, int w, int c, int y, int x, int ch) {
+    y = y < 0 ? 0 : (y >= h ? h - 1 : y);
+    x = x < 0 ? 0 : (x >= w ? w - 1 : x);
+    return img[((size_t)y * w + x) * c + ch];
+}
+
+// 测试模糊、锐化、边缘检测和形态学滤波
+void test_filters(void) {
+    printf("测试邻域滤波...\n");
+
+    const int h = 37, w = 29, c = 3;
+    Tensor image = make_u8_image(1, h, w, c);
+    preprocess_op_t to_float = make_cast(TENSOR_TYPE_FLOAT32);
+    Tensor fimage = {0};
+    assert(preprocess_op_execute(to_float, &image, &fimage) == 0);
+    const float* src = (const float*)fimage.data;
+    float* expected = malloc(fimage.size);
+    assert(expected != NULL);
+
+    // 高斯模糊：与直接二维卷积比较
+    preprocess_params_t params = {0};
+    params.params.blur.kernel_size = 7;
+    params.params.blur.sigma = 1.3f;
+    preprocess_op_t gauss = preprocess_op_create(PREPROCESS_BLUR, &params);
+    assert(gauss != NULL);
+    float taps[7];
+    float tap_sum = 0.0f;
+    for (int i = 0; i < 7; i++) {
+        taps[i] = expf(-(float)((i - 3) * (i - 3)) / (2.0f * 1.3f * 1.3f));
+        tap_sum += taps[i];
+    }
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            for (int ch = 0; ch < c; ch++) {
+                float sum = 0.0f;
+                for (int i = 0; i < 7; i++) {
+                    for (int j = 0; j < 7; j++) {
+                        sum += taps[i] * taps[j] * clamped_pixel(src, h, w, c, y + i - 3, x + j - 3, ch);
+                    }
+                }
+                expected[((size_t)y * w + x) * c + ch] = sum / (tap_sum * tap_sum);
+            }
+        }
+    }
+    Tensor out = {0};
+    assert(preprocess_op_execute(gauss, &fimage, &out) == 0);
+    assert(out.dtype == TENSOR_TYPE_FLOAT32 && out.shape.dims[1] == (uint32_t)h && out.shape.dims[2] == (uint32_t)w);
+    for (size_t i = 0; i < fimage.size / sizeof(float); i++) {
+        assert(fabsf(((float*)out.data)[i] - expected[i]) < 1e-3f);
+    }
+    tensor_free(&out);
+
+    // NCHW 布局按平面滤波，结果与 NHWC 一致
+    preprocess_op_t to_nchw = make_to_nchw();
+    Tensor planar = {0};
+    assert(preprocess_op_execute(to_nchw, &fimage, &planar) == 0);
+    assert(preprocess_op_execute(gauss, &planar, &out) == 0);
+    assert(out.format == TENSOR_FORMAT_NCHW);
+    for (int ch = 0; ch < c; ch++) {
+        for (int i = 0; i < h * w; i++) {
+            assert(fabsf(((float*)out.data)[(size_t)ch * h * w + i] - expected[(size_t)i * c + ch]) < 1e-3f);
+        }
+    }
+    tensor_free(&out);
+    tensor_free(&planar);
+
+    // 均值滤波：UINT8 与直接求平均相差不超过1（取整），大核浮点结果精确
+    uint32_t box_sizes[] = {5, 31};
+    for (int k = 0; k < 2; k++) {
+        int r = (int)box_sizes[k] / 2;
+        memset(&params, 0, sizeof(params));
+        params.params.blur.kernel_size = box_sizes[k];
+        params.params.blur.box = true;
+        preprocess_op_t box = preprocess_op_create(PREPROCESS_BLUR, &params);
+        assert(box != NULL);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                for (int ch = 0; ch < c; ch++) {
+                    float sum = 0.0f;
+                    for (int i = -r; i <= r; i++) {
+                        for (int j = -r; j <= r; j++) {
+                            sum += clamped_pixel(src, h, w, c, y + i, x + j, ch);
+                        }
+                    }
+                    expected[((size_t)y * w + x) * c + ch] = sum / (float)((2 * r + 1) * (2 * r + 1));
+                }
+            }
+        }
+        Tensor box_u8 = {0};
+        Tensor box_f32 = {0};
+        assert(preprocess_op_execute(box, &image, &box_u8) == 0);
+        assert(preprocess_op_execute(box, &fimage, &box_f32) == 0);
+        assert(box_u8.dtype == TENSOR_TYPE_UINT8);
+        for (size_t i = 0; i < image.size; i++) {
+            assert(fabsf(((uint8_t*)box_u8.data)[i] - expected[i]) <= 0.5f + 1e-3f);
+            assert(fabsf(((float*)box_f32.data)[i] - expected[i]) < 1e-3f);
+        }
+        tensor_free(&box_u8);
+        tensor_free(&box_f32);
+        preprocess_op_destroy(box);
+    }
+
+    // Sobel 梯度幅值
+    memset(&params, 0, sizeof(params));
+    preprocess_op_t edge = preprocess_op_create(PREPROCESS_EDGE_DETECT, &params);
+    assert(edge != NULL);
+    assert(preprocess_op_execute(edge, &fimage, &out) == 0);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            for (int ch = 0; ch < c; ch++) {
+                float gx = 0.0f, gy = 0.0f;
+                for (int i = -1; i <= 1; i++) {
+                    float weight = i == 0 ? 2.0f : 1.0f;
+                    gx += weight * (clamped_pixel(src, h, w, c, y + i, x + 1, ch) -
+                                    clamped_pixel(src, h, w, c, y + i, x - 1, ch));
+                    gy += weight * (clamped_pixel(src, h, w, c, y + 1, x + i, ch) -
+                                    clamped_pixel(src, h, w, c, y - 1, x + i, ch));
+                }
+                float magnitude = sqrtf(gx * gx + gy * gy);
+                assert(fabsf(((float*)out.data)[((size_t)y * w + x) * c + ch] - magnitude) < 1e-2f);
+            }
+        }
+    }
+    tensor_free(&out);
+
+    // 强度为0的锐化保持输入不变
+    memset(&params, 0, sizeof(params));
+    params.params.sharpen.sigma = 1.0f;
+    params.params.sharpen.amount = 0.0f;
+    preprocess_op_t sharpen = preprocess_op_create(PREPROCESS_SHARPEN, &params);
+    assert(sharpen != NULL);
+    assert(preprocess_op_execute(sharpen, &image, &out) == 0);
+    assert(memcmp(out.data, image.data, image.size) == 0);
+    tensor_free(&out);
+
+    // 腐蚀、膨胀与直接求窗口极值完全一致，开运算等于先腐蚀后膨胀
+    const int kw = 5, kh = 3;
+    morphology_op_e morph_ops[] = {MORPHOLOGY_ERODE, MORPHOLOGY_DILATE, MORPHOLOGY_OPEN};
+    Tensor eroded = {0};
+    for (int m = 0; m < 3; m++) {
+        memset(&params, 0, sizeof(params));
+        params.params.morphology.op = morph_ops[m];
+        params.params.morphology.kernel_width = kw;
+        params.params.morphology.kernel_height = kh;
+        preprocess_op_t morph = preprocess_op_create(PREPROCESS_MORPHOLOGY, &params);
+        assert(morph != NULL);
+        assert(preprocess_op_execute(morph, &image, &out) == 0);
+
+        if (morph_ops[m] == MORPHOLOGY_OPEN) {
+            // 对腐蚀结果求膨胀作为参考
+            Tensor feroded = {0};
+            assert(preprocess_op_execute(to_float, &eroded, &feroded) == 0);
+            memcpy(expected, feroded.data, feroded.size);
+            tensor_free(&feroded);
+        } else {
+            memcpy(expected, src, fimage.size);
+        }
+        float* reference = malloc(fimage.size);
+        assert(reference != NULL);
+        bool dilate = morph_ops[m] != MORPHOLOGY_ERODE;
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                for (int ch = 0; ch < c; ch++) {
+                    float v = clamped_pixel(expected, h, w, c, y, x, ch);
+                    for (int i = -kh / 2; i <= kh / 2; i++) {
+                        for (int j = -kw / 2; j <= kw / 2; j++) {
+                            float p = clamped_pixel(expected, h, w, c, y + i, x + j, ch);
+                            v = dilate ? fmaxf(v, p) : fminf(v, p);
+                        }
+                    }
+                    reference[((size_t)y * w + x) * c + ch] = v;
+                }
+            }
+        }
+        for (size_t i = 0; i < image.size; i++) {
+            assert(((uint8_t*)out.data)[i] == (uint8_t)reference[i]);
+        }
+        free(reference);
+
+        if (morph_ops[m] == MORPHOLOGY_ERODE) {
+            eroded = out;
+            out.data = NULL;
+        }
+        tensor_free(&out);
+        preprocess_op_destroy(morph);
+    }
+    tensor_free(&eroded);
+
+    // 偶数核大小无效
+    memset(&params, 0, sizeof(params));
+    params.params.morphology.kernel_width = 4;
+    params.params.morphology.kernel_height = 3;
+    assert(preprocess_op_create(PREPROCESS_MORPHOLOGY, &params) == NULL);
+    memset(&params, 0, sizeof(params));
+    params.params.blur.box = true;
+    params.params.blur.kernel_size = 6;
+    assert(preprocess_op_create(PREPROCESS_BLUR, &params) == NULL);
+
+    // 多线程分块结果与单线程一致
+    Tensor large = make_u8_image(2, 240, 320, 3);
+    preprocess_pipeline_t serial = preprocess_pipeline_create();
+    preprocess_pipeline_t parallel = preprocess_pipeline_create();
+    preprocess_pipeline_t pipelines[] = {serial, parallel};
+    for (int i = 0; i < 2; i++) {
+        memset(&params, 0, sizeof(params));
+        params.params.blur.kernel_size = 9;
+        assert(preprocess_pipeline_add_op(pipelines[i], preprocess_op_create(PREPROCESS_BLUR, &params)) == 0);
+        memset(&params, 0, sizeof(params));
+        params.params.morphology.op = MORPHOLOGY_CLOSE;
+        params.params.morphology.kernel_width = 7;
+        params.params.morphology.kernel_height = 9;
+        assert(preprocess_pipeline_add_op(pipelines[i], preprocess_op_create(PREPROCESS_MORPHOLOGY, &params)) == 0);
+    }
+    assert(preprocess_pipeline_set_parallel(serial, 1) == 0);
+    assert(preprocess_pipeline_set_parallel(parallel, 4) == 0);
+    Tensor out_serial = {0};
+    Tensor out_parallel = {0};
+    assert(preprocess_pipeline_execute(serial, &large, &out_serial) == 0);
+    assert(preprocess_pipeline_execute(parallel, &large, &out_parallel) == 0);
+    assert(memcmp(out_serial.data, out_parallel.data, out_serial.size) == 0);
+    tensor_free(&out_serial);
+    tensor_free(&out_parallel);
+    preprocess_pipeline_destroy(serial);
+    preprocess_pipeline_destroy(parallel);
+    tensor_free(&large);
+
+    preprocess_op_destroy(gauss);
+    preprocess_op_destroy(edge);
+    preprocess_op_destroy(sharpen);
+    preprocess_op_destroy(to_nchw);
+    preprocess_op_destroy(to_float);
+    free(expected);
+    tensor_free(&fimage);
+    tensor_free(&image);
+
+    printf("✅ 邻域滤波测试通过\n");
+}
+
+// 测试内核工作区复用：查找表、颜色转换、滤波、量化和音频特征重复执行时不再分配内存
+void test_kernel_workspace(void) {
+#ifndef MODYN_TEST_COUNT_ALLOCS
+    printf("跳过内核工作区测试（未启用分配计数）\n");
+#else
+    printf("测试内核工作区复用...\n");
+
+    Tensor frame = make_yuv_frame(COLOR_FORMAT_NV12, 2, 96, 128);
+    float scale[] = {0.5f, 0.25f, 0.125f};
+    int32_t zero_point[] = {-3, 0, 7};
+
+    Tensor pcm = make_tone(2, 16000, 1000.0f);
+    Tensor pcm16 = tensor_create("pcm", TENSOR_TYPE_INT16, &pcm.shape, TENSOR_FORMAT_NC);
+    pcm16.data = malloc(pcm16.size);
+    pcm16.owns_data = true;
+    for (size_t i = 0; i < tensor_get_element_count(&pcm); i++) {
+        ((int16_t*)pcm16.data)[i] = (int16_t)(((const float*)pcm.data)[i] * 32767.0f);
+    }
+
+    uint32_t threads[] = {1, 4};
+    for (int t = 0; t < 2; t++) {
+        // 逐操作执行：逐帧逐通道的均衡化表、逐线程的颜色转换行和滤波行缓冲区、开运算的中间结果
+        preprocess_pipeline_t image = preprocess_pipeline_create();
+        assert(preprocess_pipeline_set_fusion(image, false) == 0);
+        assert(preprocess_pipeline_set_parallel(image, threads[t]) == 0);
+        assert(preprocess_pipeline_add_op(image, make_color_convert(COLOR_FORMAT_NV12, COLOR_FORMAT_RGB,
+                                                                    COLOR_STANDARD_BT601)) == 0);
+        assert(preprocess_pipeline_add_op(image, make_photometric(PREPROCESS_HISTOGRAM_EQ, 0.0f)) == 0);
+        assert(preprocess_pipeline_add_op(image, make_photometric(PREPROCESS_GAMMA, 0.8f)) == 0);
+
+        preprocess_params_t params = {0};
+        params.params.morphology.op = MORPHOLOGY_OPEN;
+        params.params.morphology.kernel_width = 5;
+        params.params.morphology.kernel_height = 3;
+        assert(preprocess_pipeline_add_op(image, preprocess_op_create(PREPROCESS_MORPHOLOGY, &params)) == 0);
+        memset(&params, 0, sizeof(params));
+        params.params.blur.kernel_size = 5;
+        params.params.blur.sigma = 1.0f;
+        assert(preprocess_pipeline_add_op(image, preprocess_op_create(PREPROCESS_BLUR, &params)) == 0);
+        assert(preprocess_pipeline_add_op(image, make_quantize(TENSOR_TYPE_INT8, 3, scale, zero_point)) == 0);
+        assert_execute_without_allocs(image, &frame);
+        preprocess_pipeline_destroy(image);
+
+        // 融合组：颜色转换的源行缓存和浮点行缓冲区按工作线程取自工作区
+        preprocess_pipeline_t fused = preprocess_pipeline_create();
+        assert(preprocess_pipeline_set_parallel(fused, threads[t]) == 0);
+        assert(preprocess_pipeline_add_op(fused, make_color_convert(COLOR_FORMAT_NV12, COLOR_FORMAT_RGB,
+                                                                    COLOR_STANDARD_BT601)) == 0);
+        assert(preprocess_pipeline_add_op(fused, make_resize(160, 120, INTERPOLATION_LINEAR)) == 0);
+        assert(preprocess_pipeline_add_op(fused, make_normalize()) == 0);
+        assert(preprocess_pipeline_add_op(fused, make_to_nchw()) == 0);
+        assert_execute_without_allocs(fused, &frame);
+        preprocess_fusion_stats_t stats;
+        assert(preprocess_pipeline_get_fusion_stats(fused, &stats) == 0);
+        assert(stats.fused_groups == 1);
+        preprocess_pipeline_destroy(fused);
+
+        // 16 位 PCM 转换为浮点采样，每个线程一份 FFT 工作区
+        preprocess_pipeline_t audio = preprocess_pipeline_create();
+        assert(preprocess_pipeline_set_parallel(audio, threads[t]) == 0);
+        memset(&params, 0, sizeof(params));
+        params.params.fft.n_fft = 512;
+        params.params.fft.hop_length = 160;
+        params.params.fft.win_length = 400;
+        assert(preprocess_pipeline_add_op(audio, preprocess_op_create(PREPROCESS_FFT, &params)) == 0);
+        assert_execute_without_allocs(audio, &pcm16);
+        preprocess_pipeline_destroy(audio);
+    }
+
+    tensor_free(&pcm16);
+    tensor_free(&pcm);
+    tensor_free(&frame);
+
+    printf("✅ 内核工作区复用测试通过\n");
+#endif
+}
+
+// 将张量作为模态追加到多模态容器（容器复制数据）
+static void add_modality(MultiModalData* bundle, modality_type_e modality, const Tensor* tensor) {
+    ModalityData modal;
+    memset(&modal, 0, sizeof(modal));
+    modal.modality = modality;
+    modal.format = DATA_FORMAT_CUSTOM;
+    modal.data = tensor->data;
+    modal.data_size = tensor->size;
+    modal.shape = tensor->shape;
+    modal.data_type = tensor->dtype;
+    modal.sequence_id = 7;
+    assert(multimodal_data_add(bundle, &modal) == 0);
+}
+
+// 测试多模态并发预处理：结果与单独执行一致，预分配的输出原地写入
+void test_multimodal_execute(void) {
+    printf("测试多模态并发预处理...\n");
+
+    Tensor image = make_u8_image(1, 64, 48, 3);
+    Tensor audio = make_tone(1, 16000, 440.0f);
+    Tensor cloud = make_points(2000, 3);
+    float* pts = (float*)cloud.data;
+    for (uint32_t i = 0; i < 2000 * 3; i++) {
+        pts[i] = (float)rand() / RAND_MAX;
+    }
+
+    preprocess_pipeline_t image_pipeline = preprocess_pipeline_create();
+    assert(preprocess_pipeline_add_op(image_pipeline, make_resize(32, 24, INTERPOLATION_LINEAR)) == 0);
+    assert(preprocess_pipeline_add_op(image_pipeline, make_normalize()) == 0);
+    assert(preprocess_pipeline_add_op(image_pipeline, make_to_nchw()) == 0);
+
+    preprocess_params_t params = {0};
+    params.params.resample.sample_rate = 16000;
+    params.params.resample.target_rate = 8000;
+    preprocess_pipeline_t audio_pipeline = preprocess_pipeline_create();
+    assert(preprocess_pipeline_add_op(audio_pipeline, preprocess_op_create(PREPROCESS_RESAMPLE, &params)) == 0);
+
+    memset(&params, 0, sizeof(params));
+    params.params.normal_estimation.k = 8;
+    preprocess_pipeline_t cloud_pipeline = preprocess_pipeline_create();
+    assert(preprocess_pipeline_add_op(cloud_pipeline,
+                                      preprocess_op_create(PREPROCESS_NORMAL_ESTIMATION, &params)) == 0);
+
+    // 参考结果：各管道单独执行
+    Tensor expected[3] = {{0}};
+    assert(preprocess_pipeline_execute(image_pipeline, &image, &expected[0]) == 0);
+    assert(preprocess_pipeline_execute(audio_pipeline, &audio, &expected[1]) == 0);
+    assert(preprocess_pipeline_execute(cloud_pipeline, &cloud, &expected[2]) == 0);
+
+    MultiModalData* input = multimodal_data_create(4);
+    add_modality(input, MODALITY_IMAGE, &image);
+    add_modality(input, MODALITY_AUDIO, &audio);
+    add_modality(input, MODALITY_POINT_CLOUD, &cloud);
+    add_modality(input, MODALITY_TEXT, &audio);  // 没有对应管道，不写入输出
+
+    preprocess_modality_pipeline_t map[] = {
+        {MODALITY_IMAGE, image_pipeline},
+        {MODALITY_AUDIO, audio_pipeline},
+        {MODALITY_POINT_CLOUD, cloud_pipeline},
+    };
+    modality_type_e order[] = {MODALITY_IMAGE, MODALITY_AUDIO, MODALITY_POINT_CLOUD};
+
+    MultiModalData* output = multimodal_data_create(1);
+    assert(preprocess_multimodal_execute_pipelines(map, 3, input, output, 0) == 0);
+    assert(output->modality_count == 3);
+    assert(multimodal_data_get(output, MODALITY_TEXT) == NULL);
+    for (int i = 0; i < 3; i++) {
+        ModalityData* result = multimodal_data_get(output, order[i]);
+        assert(result != NULL && result->sequence_id == 7);
+        assert(result->data_type == expected[i].dtype && result->data_size == expected[i].size);
+        assert(tensor_shape_equal(&result->shape, &expected[i].shape));
+        assert(memcmp(result->data, expected[i].data, expected[i].size) == 0);
+    }
+
+    // 预分配输出后再次执行不再分配，结果写入原有缓冲区
+    MultiModalData* prepared = multimodal_data_create(4);
+    assert(preprocess_multimodal_prepare_output(map, 3, input, prepared) == 0);
+    assert(prepared->modality_count == 3);
+    void* buffers[3];
+    for (int i = 0; i < 3; i++) {
+        ModalityData* slot = multimodal_data_get(prepared, order[i]);
+        assert(slot != NULL && slot->data != NULL && slot->data_size == expected[i].size);
+        buffers[i] = slot->data;
+    }
+    for (int round = 0; round < 2; round++) {
+        assert(preprocess_multimodal_execute_pipelines(map, 3, input, prepared, 2) == 0);
+        for (int i = 0; i < 3; i++) {
+            ModalityData* slot = multimodal_data_get(prepared, order[i]);
+            assert(slot->data == buffers[i]);
+            assert(memcmp(slot->data, expected[i].data, expected[i].size) == 0);
+        }
+    }
+
+    // 同一管道处理多个同类模态：按出现顺序对应输出
+    Tensor second = make_u8_image(1, 40, 40, 3);
+    MultiModalData* images = multimodal_data_create(2);
+    add_modality(images, MODALITY_IMAGE, &image);
+    add_modality(images, MODALITY_IMAGE, &second);
+    MultiModalData* image_out = multimodal_data_create(2);
+    assert(preprocess_multimodal_execute(image_pipeline, images, image_out) == 0);
+    assert(image_out->modality_count == 2);
+    assert(memcmp(image_out->modalities[0].data, expected[0].data, expected[0].size) == 0);
+    Tensor second_expected = {0};
+    assert(preprocess_pipeline_execute(image_pipeline, &second, &second_expected) == 0);
+    assert(memcmp(image_out->modalities[1].data, second_expected.data, second_expected.size) == 0);
+
+    // 输入与输出不能是同一个容器
+    assert(preprocess_multimodal_execute_pipelines(map, 3, input, input, 0) != 0);
+
+    tensor_free(&second_expected);
+    multimodal_data_destroy(image_out);
+    multimodal_data_destroy(images);
+    tensor_free(&second);
+    multimodal_data_destroy(prepared);
+    multimodal_data_destroy(output);
+    multimodal_data_destroy(input);
+    for (int i = 0; i < 3; i++) {
+        tensor_free(&expected[i]);
+    }
+    preprocess_pipeline_destroy(image_pipeline);
+    preprocess_pipeline_destroy(audio_pipeline);
+    preprocess_pipeline_destroy(cloud_pipeline);
+    tensor_free(&cloud);
+    tensor_free(&audio);
+    tensor_free(&image);
+
+    printf("✅ 多模态并发预处理测试通过\n");
+}
+
+int main(void) {
+    // 初始化日志系统
+    logger_init(LOG_LEVEL_INFO, NULL);
+    logger_set_console_output(true);
+
+    printf("=== 预处理单元测试 ===\n");
+
+    test_fused_pipeline_matches_per_op();
+    test_fusion_fallback();
+    test_parallel_pipeline_matches_serial();
+    test_batch_execute();
+    test_scratch_reuse();
+    test_lut_composition();
+    test_audio_features();
+    test_resample();
+    test_tokenize();
+    test_pointcloud();
+    test_output_shape_inference();
+    test_static_plan();
+    test_quantize();
+    test_color_convert();
+    test_filters();
+    test_kernel_workspace();
+    test_multimodal_execute();
+
+    printf("\n🎉 所有预处理测试通过！\n");
+
+    logger_cleanup();
+    return 0;
+}
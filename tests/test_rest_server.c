@@ -0,0 +1,389 @@
+#define _GNU_SOURCE  // memmem
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "api/rest_server.h"
+#include "core/model_manager.h"
+#include "utils/logger.h"
+
+/**
+ * @brief REST 服务器 HTTP 解析单元测试
+ *
+ * 服务器监听系统分配的端口，测试通过真实 socket 发送原始请求并检查响应。
+ */
+
+#define RESPONSE_BUFFER_SIZE 65536
+
+static uint16_t g_port;
+
+// 客户端连接，缓存流水线响应中尚未读取的数据
+typedef struct {
+    int fd;
+    char buffer[RESPONSE_BUFFER_SIZE];
+    size_t length;
+} client_t;
+
+// 解析后的响应
+typedef struct {
+    int status;
+    bool keep_alive;
+    char body[4096];
+    size_t body_length;
+} response_t;
+
+static void client_open(client_t* client) {
+    client->fd = socket(AF_INET, SOCK_STREAM, 0);
+    assert(client->fd >= 0);
+    client->length = 0;
+
+    struct timeval timeout = {3, 0};
+    setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(g_port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(client->fd, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+}
+
+static void client_close(client_t* client) {
+    close(client->fd);
+    client->fd = -1;
+}
+
+static void client_send(client_t* client, const char* data) {
+    size_t length = strlen(data);
+    size_t sent = 0;
+    while (sent < length) {
+        ssize_t n = send(client->fd, data + sent, length - sent, MSG_NOSIGNAL);
+        assert(n > 0);
+        sent += (size_t)n;
+    }
+}
+
+// 读取数据追加到缓冲区，对端关闭或超时返回 false
+static bool client_fill(client_t* client) {
+    assert(client->length < sizeof(client->buffer));
+    ssize_t n = recv(client->fd, client->buffer + client->length, sizeof(client->buffer) - client->length, 0);
+    if (n <= 0) return false;
+    client->length += (size_t)n;
+    return true;
+}
+
+// 读取一个完整响应，多余数据留给下一个响应
+static void client_read_response(client_t* client, response_t* response) {
+    char* header_end = NULL;
+    while (!(header_end = memmem(client->buffer, client->length, "\r\n\r\n", 4))) {
+        assert(client_fill(client));
+    }
+    size_t header_length = (size_t)(header_end - client->buffer) + 4;
+
+    char header[4096];
+    assert(header_length < sizeof(header));
+    memcpy(header, client->buffer, header_length);
+    header[header_length] = '\0';
+
+    memset(response, 0, sizeof(*response));
+    assert(sscanf(header, "HTTP/1.1 %d", &response->status) == 1);
+    response->keep_alive = strstr(header, "Connection: keep-alive\r\n") != NULL;
+    if (!response->keep_alive) {
+        assert(strstr(header, "Connection: close\r\n") != NULL);
+    }
+
+    size_t content_length = 0;
+    const char* field = strstr(header, "Content-Length: ");
+    if (field) content_length = strtoul(field + 16, NULL, 10);
+    assert(content_length < sizeof(response->body));
+
+    while (client->length < header_length + content_length) {
+        assert(client_fill(client));
+    }
+    memcpy(response->body, client->buffer + header_length, content_length);
+    response->body[content_length] = '\0';
+    response->body_length = content_length;
+
+    size_t consumed = header_length + content_length;
+    memmove(client->buffer, client->buffer + consumed, client->length - consumed);
+    client->length -= consumed;
+}
+
+// 服务器已关闭连接（读到 EOF）
+static bool client_is_closed(client_t* client) {
+    char byte;
+    return client->length == 0 && recv(client->fd, &byte, 1, 0) == 0;
+}
+
+// 服务器仍保持连接（短暂等待内既无数据也未关闭）
+static bool client_is_open(client_t* client) {
+    struct timeval timeout = {0, 200000};
+    setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char byte;
+    ssize_t n = recv(client->fd, &byte, 1, 0);
+    bool open = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+
+    timeout.tv_sec = 3;
+    timeout.tv_usec = 0;
+    setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return open;
+}
+
+// 发送单个请求，期望返回给定状态码并关闭连接
+static void expect_error_and_close(const char* request, int status) {
+    client_t client;
+    client_open(&client);
+    client_send(&client, request);
+
+    response_t response;
+    client_read_response(&client, &response);
+    assert(response.status == status);
+    assert(!response.keep_alive);
+    assert(client_is_closed(&client));
+    client_close(&client);
+}
+
+void test_split_request(void) {
+    printf("测试分段到达的请求...\n");
+
+    client_t client;
+    client_open(&client);
+
+    // 请求行、请求头和空行分多次到达，边界落在标记中间
+    const char* parts[] = {"GE", "T /hea", "lth HTTP/1.1\r", "\nHost: x\r\n\r", "\n"};
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        client_send(&client, parts[i]);
+        usleep(20000);
+    }
+
+    response_t response;
+    client_read_response(&client, &response);
+    assert(response.status == 200);
+    assert(response.keep_alive);
+    assert(strstr(response.body, "healthy") != NULL);
+
+    // 同一连接继续发送带请求体的请求，请求体分段到达
+    const char* body = "{\"model_path\":\"missing.bin\",\"model_id\":\"split\"}";
+    char header[256];
+    snprintf(header, sizeof(header), "POST /models HTTP/1.1\r\nContent-Length: %zu\r\n\r\n", strlen(body));
+    client_send(&client, header);
+    usleep(20000);
+    char first[16];
+    snprintf(first, sizeof(first), "%.10s", body);
+    client_send(&client, first);
+    usleep(20000);
+    client_send(&client, body + 10);
+
+    client_read_response(&client, &response);
+    assert(response.status == 200);
+    assert(response.keep_alive);
+
+    client_close(&client);
+    printf("✅ 分段请求测试通过\n");
+}
+
+void test_pipelined_requests(void) {
+    printf("测试流水线请求...\n");
+
+    client_t client;
+    client_open(&client);
+
+    // 一次发送多个请求，响应按顺序返回
+    const char* body = "{\"model_path\":\"missing.bin\",\"model_id\":\"pipe\"}";
+    char requests[1024];
+    snprintf(requests, sizeof(requests),
+             "GET /health HTTP/1.1\r\n\r\n"
+             "GET /nope HTTP/1.1\r\n\r\n"
+             "POST /models HTTP/1.1\r\nContent-Length: %zu\r\n\r\n%s"
+             "POST /models HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"
+             "GET /models HTTP/1.1\r\n\r\n",
+             strlen(body), body);
+    client_send(&client, requests);
+
+    const int expected[] = {200, 404, 200, 400, 200};
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        response_t response;
+        client_read_response(&client, &response);
+        assert(response.status == expected[i]);
+        assert(response.keep_alive);
+    }
+    assert(client.length == 0);
+    assert(client_is_open(&client));
+
+    client_close(&client);
+    printf("✅ 流水线请求测试通过\n");
+}
+
+void test_chunked_body(void) {
+    printf("测试分块请求体...\n");
+
+    client_t client;
+    client_open(&client);
+
+    // 分块边界切开 JSON 键名，分块带扩展参数，结尾带尾部字段，后接流水线请求
+    client_send(&client,
+                "POST /models HTTP/1.1\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "5\r\n{\"mod\r\n");
+    usleep(20000);
+    client_send(&client,
+                "25;ext=1\r\nel_path\":\"missing.bin\",\"model_id\":\"ch\r\n"
+                "2 ; name=\"v\"\r\n\"}\r\n"
+                "0\r\n"
+                "Trailer-Field: v\r\n"
+                "\r\n"
+                "GET /health HTTP/1.1\r\n\r\n");
+
+    response_t response;
+    client_read_response(&client, &response);
+    assert(response.status == 200);
+    assert(response.keep_alive);
+    assert(strstr(response.body, "\"ch\"") != NULL);
+
+    client_read_response(&client, &response);
+    assert(response.status == 200);
+    assert(strstr(response.body, "healthy") != NULL);
+
+    // 大小行分段到达
+    client_send(&client, "POST /models HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n");
+    usleep(20000);
+    client_send(&client, "2");
+    usleep(20000);
+    client_send(&client, "\r\n{}\r\n0\r\n\r\n");
+    client_read_response(&client, &response);
+    assert(response.status == 400);
+    assert(response.keep_alive);
+
+    client_close(&client);
+    printf("✅ 分块请求体测试通过\n");
+}
+
+void test_malformed_requests(void) {
+    printf("测试非法请求...\n");
+
+    logger_set_level(LOG_LEVEL_FATAL);
+
+    // 非法的分块大小
+    expect_error_and_close("POST /models HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n{}\r\n0\r\n\r\n", 400);
+    // 超出 unsigned long long 范围的分块大小
+    expect_error_and_close("POST /models HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "fffffffffffffffffff\r\n{}\r\n0\r\n\r\n", 400);
+    // 超过请求大小上限的分块大小
+    expect_error_and_close("POST /models HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "ffffffffffffffff\r\n{}\r\n0\r\n\r\n", 413);
+    expect_error_and_close("POST /models HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "200000\r\n{}\r\n", 413);
+    // 分块数据后缺少 CRLF
+    expect_error_and_close("POST /models HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n2\r\n{}xx\r\n0\r\n\r\n", 400);
+
+    // 同时给出 Content-Length 和 Transfer-Encoding
+    expect_error_and_close("POST /models HTTP/1.1\r\nContent-Length: 2\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "2\r\n{}\r\n0\r\n\r\n", 400);
+    expect_error_and_close("POST /models HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 2\r\n\r\n"
+                           "2\r\n{}\r\n0\r\n\r\n", 400);
+    // 不一致的重复 Content-Length
+    expect_error_and_close("POST /models HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 3\r\n\r\n{}x", 400);
+    expect_error_and_close("POST /models HTTP/1.1\r\nContent-Length: 2x\r\n\r\n{}", 400);
+    // 超过请求大小上限的 Content-Length
+    expect_error_and_close("POST /models HTTP/1.1\r\nContent-Length: 99999999999\r\n\r\n", 413);
+    // 不支持的传输编码
+    expect_error_and_close("POST /models HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n", 501);
+
+    logger_set_level(LOG_LEVEL_INFO);
+
+    printf("✅ 非法请求测试通过\n");
+}
+
+void test_connection_close(void) {
+    printf("测试连接关闭...\n");
+
+    response_t response;
+    client_t client;
+
+    // HTTP/1.0 默认响应后关闭
+    client_open(&client);
+    client_send(&client, "GET /health HTTP/1.0\r\n\r\n");
+    client_read_response(&client, &response);
+    assert(response.status == 200);
+    assert(!response.keep_alive);
+    assert(client_is_closed(&client));
+    client_close(&client);
+
+    // HTTP/1.0 显式 keep-alive 时保持连接
+    client_open(&client);
+    client_send(&client, "GET /health HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+    client_read_response(&client, &response);
+    assert(response.status == 200);
+    assert(response.keep_alive);
+    assert(client_is_open(&client));
+    client_send(&client, "GET /health HTTP/1.0\r\n\r\n");
+    client_read_response(&client, &response);
+    assert(!response.keep_alive);
+    assert(client_is_closed(&client));
+    client_close(&client);
+
+    // HTTP/1.1 Connection: close，之后的流水线请求不再处理
+    client_open(&client);
+    client_send(&client,
+                "GET /health HTTP/1.1\r\n\r\n"
+                "GET /health HTTP/1.1\r\nConnection: close\r\n\r\n"
+                "GET /health HTTP/1.1\r\n\r\n");
+    client_read_response(&client, &response);
+    assert(response.keep_alive);
+    client_read_response(&client, &response);
+    assert(response.status == 200);
+    assert(!response.keep_alive);
+    assert(client_is_closed(&client));
+    client_close(&client);
+
+    printf("✅ 连接关闭测试通过\n");
+}
+
+int main(void) {
+    // 初始化日志系统
+    logger_init(LOG_LEVEL_INFO, NULL);
+    logger_set_console_output(true);
+
+    printf("=== REST 服务器单元测试 ===\n");
+
+    model_manager_t* manager = model_manager_create();
+    assert(manager != NULL);
+
+    rest_server_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.reactors = 1;
+    config.workers = 2;
+    config.max_request_size = 1024 * 1024;
+    config.idle_timeout_ms = 5000;
+
+    RestServer* server = rest_server_create_with_config("127.0.0.1", 0, manager, &config);
+    assert(server != NULL);
+    assert(rest_server_start(server) == 0);
+    g_port = rest_server_get_port(server);
+    assert(g_port != 0);
+
+    test_split_request();
+    test_pipelined_requests();
+    test_chunked_body();
+    test_malformed_requests();
+    test_connection_close();
+
+    rest_server_stop(server);
+    rest_server_destroy(server);
+    model_manager_destroy(manager);
+
+    printf("\n🎉 所有 REST 服务器测试通过！\n");
+
+    logger_cleanup();
+    return 0;
+}
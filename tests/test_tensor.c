@@ -3,7 +3,10 @@
 #include <string.h>
 #include <assert.h>
 #include <math.h>
+#include <stdint.h>
+#include <unistd.h>
 #include "core/tensor.h"
+#include "core/tensor_file.h"
 #include "utils/logger.h"
 
 /**
@@ -286,6 +289,81 @@ void test_tensor_boundary_conditions(void) {
     printf("✅ 张量边界条件测试通过\n");
 }
 
+// 测试张量文件读写
+void test_tensor_file(void) {
+    printf("测试张量文件读写...\n");
+    
+    const char* path = "/tmp/modyn_test_tensor_file.bin";
+    
+    float values[2 * 3 * 5];
+    for (int i = 0; i < 30; i++) {
+        values[i] = (float)i * 0.5f;
+    }
+    uint8_t labels[7] = {1, 2, 3, 4, 5, 6, 7};
+    
+    uint32_t dims1[] = {2, 3, 5};
+    uint32_t dims2[] = {7};
+    TensorShape shape1 = tensor_shape_create(dims1, 3);
+    TensorShape shape2 = tensor_shape_create(dims2, 1);
+    Tensor tensors[2];
+    tensors[0] = tensor_from_data("images", TENSOR_TYPE_FLOAT32, &shape1, TENSOR_FORMAT_NCHW,
+                                  values, sizeof(values), false);
+    tensors[1] = tensor_from_data("labels", TENSOR_TYPE_UINT8, &shape2, TENSOR_FORMAT_N,
+                                  labels, sizeof(labels), false);
+    
+    assert(tensor_file_save(path, tensors, 2) == 0);
+    
+    tensor_file_t file = tensor_file_open(path);
+    assert(file != NULL);
+    assert(tensor_file_get_count(file) == 2);
+    assert(tensor_file_find(file, "labels") == 1);
+    assert(tensor_file_find(file, "missing") == -1);
+    
+    // 零拷贝视图：数据对齐且指向映射内存
+    for (uint32_t i = 0; i < 2; i++) {
+        tensor_file_entry_t entry;
+        assert(tensor_file_get_entry(file, i, &entry) == 0);
+        assert(entry.offset % TENSOR_FILE_ALIGNMENT == 0);
+        
+        Tensor view;
+        assert(tensor_file_get_tensor(file, i, &view) == 0);
+        assert(strcmp(view.name, tensors[i].name) == 0);
+        assert(view.dtype == tensors[i].dtype);
+        assert(view.format == tensors[i].format);
+        assert(tensor_shape_equal(&view.shape, &tensors[i].shape));
+        assert(view.memory_type == TENSOR_MEMORY_EXTERNAL);
+        assert(view.owns_data == false);
+        assert(((uintptr_t)view.data % TENSOR_FILE_ALIGNMENT) == 0);
+        assert(view.size == tensors[i].size);
+        assert(memcmp(view.data, tensors[i].data, view.size) == 0);
+        tensor_free(&view);
+    }
+    tensor_file_close(file);
+    
+    // 名称重复、截断的文件都应该被拒绝
+    logger_set_level(LOG_LEVEL_FATAL);
+    tensor_file_writer_t writer = tensor_file_writer_create(path);
+    assert(writer != NULL);
+    assert(tensor_file_writer_add(writer, NULL, &tensors[0]) == 0);
+    assert(tensor_file_writer_add(writer, "images", &tensors[1]) != 0);
+    assert(tensor_file_writer_close(writer) == 0);
+    
+    FILE* fp = fopen(path, "rb");
+    assert(fp != NULL);
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp);
+    fclose(fp);
+    assert(truncate(path, file_size - 8) == 0);
+    assert(tensor_file_open(path) == NULL);
+    logger_set_level(LOG_LEVEL_INFO);
+    
+    remove(path);
+    tensor_free(&tensors[0]);
+    tensor_free(&tensors[1]);
+    
+    printf("✅ 张量文件读写测试通过\n");
+}
+
 int main(void) {
     // 初始化日志系统
     logger_init(LOG_LEVEL_INFO, NULL);
@@ -301,6 +379,7 @@ int main(void) {
     test_tensor_from_data();
     test_tensor_format_conversion();
     test_tensor_boundary_conditions();
+    test_tensor_file();
     
     printf("\n🎉 所有张量测试通过！\n");
     
@@ -0,0 +1,1606 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "core/tensor.h"
+#include "utils/preprocessing.h"
+#include "utils/image_decode.h"
+#include "utils/image_loader.h"
+#include "utils/audio_utils.h"
+#include "utils/tokenizer.h"
+#include "utils/pointcloud_utils.h"
+#include "utils/tensor_codec.h"
+#include "utils/logger.h"
+
+/**
+ * @brief Modyn 预处理性能测试工具
+ */
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t iterations;
+    uint32_t threads;
+    const char* suite;
+    const char* image_dir;
+} PreprocessBenchConfig;
+
+typedef int (*bench_suite_func_t)(const PreprocessBenchConfig* config);
+
+typedef struct {
+    const char* name;
+    const char* description;
+    bench_suite_func_t func;
+} BenchSuite;
+
+// 获取当前时间（毫秒）
+static double get_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+// 创建测试用 UINT8 NHWC 图像
+static Tensor create_test_image(uint32_t width, uint32_t height) {
+    uint32_t dims[] = {1, height, width, 3};
+    tensor_shape_t shape = tensor_shape_create(dims, 4);
+    Tensor image = tensor_create("bench_image", TENSOR_TYPE_UINT8, &shape, TENSOR_FORMAT_NHWC);
+
+    image.data = malloc(image.size);
+    if (!image.data) {
+        return image;
+    }
+    image.owns_data = true;
+
+    uint8_t* data = (uint8_t*)image.data;
+    for (size_t i = 0; i < image.size; i++) {
+        data[i] = (uint8_t)(rand() & 0xFF);
+    }
+
+    return image;
+}
+
+// 构建典型的分类模型输入管道：裁剪 -> 缩放 -> 归一化 -> NHWC转NCHW
+static preprocess_pipeline_t create_classification_pipeline(uint32_t width, uint32_t height) {
+    preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+    if (!pipeline) return NULL;
+
+    preprocess_params_t crop = {0};
+    uint32_t side = width < height ? width : height;
+    crop.params.crop.x = (width - side) / 2;
+    crop.params.crop.y = (height - side) / 2;
+    crop.params.crop.width = side;
+    crop.params.crop.height = side;
+
+    preprocess_params_t resize = {0};
+    resize.params.resize.width = 224;
+    resize.params.resize.height = 224;
+    resize.params.resize.method = INTERPOLATION_LINEAR;
+
+    preprocess_params_t normalize = {0};
+    normalize.params.normalize.channels = 3;
+    float mean[] = {123.675f, 116.28f, 103.53f};
+    float std[] = {58.395f, 57.12f, 57.375f};
+    memcpy(normalize.params.normalize.mean, mean, sizeof(mean));
+    memcpy(normalize.params.normalize.std, std, sizeof(std));
+
+    preprocess_params_t transpose = {0};
+    uint32_t perm[] = {0, 3, 1, 2};
+    transpose.params.transpose.ndim = 4;
+    memcpy(transpose.params.transpose.perm, perm, sizeof(perm));
+
+    preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_CROP, &crop));
+    preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_RESIZE, &resize));
+    preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_NORMALIZE, &normalize));
+    preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_TRANSPOSE, &transpose));
+
+    return pipeline;
+}
+
+// 融合与逐操作执行对比
+static int bench_fusion(const PreprocessBenchConfig* config) {
+    Tensor image = create_test_image(config->width, config->height);
+    if (!image.data) return -1;
+
+    printf("\n=== 融合预处理 (%ux%u -> 3x224x224, %u 次) ===\n",
+           config->width, config->height, config->iterations);
+    printf("%-10s %12s %16s %16s\n", "模式", "平均(ms)", "流量/次(MB)", "逐操作流量(MB)");
+
+    for (int fused = 0; fused <= 1; fused++) {
+        preprocess_pipeline_t pipeline = create_classification_pipeline(config->width, config->height);
+        if (!pipeline) {
+            tensor_free(&image);
+            return -1;
+        }
+        preprocess_pipeline_set_fusion(pipeline, fused != 0);
+
+        double avg_ms = 0.0;
+        if (preprocess_pipeline_benchmark(pipeline, &image, config->iterations, &avg_ms) != 0) {
+            LOG_ERROR("预处理管道执行失败");
+            preprocess_pipeline_destroy(pipeline);
+            tensor_free(&image);
+            return -1;
+        }
+
+        preprocess_fusion_stats_t stats;
+        preprocess_pipeline_get_fusion_stats(pipeline, &stats);
+        double runs = stats.executions ? (double)stats.executions : 1.0;
+        printf("%-10s %12.3f %16.2f %16.2f\n", fused ? "fused" : "per-op", avg_ms,
+               stats.fused_bytes / runs / (1024.0 * 1024.0),
+               stats.unfused_bytes / runs / (1024.0 * 1024.0));
+
+        if (fused && stats.unfused_bytes > 0) {
+            printf("融合组: %u, 融合操作: %u, 回退操作: %u, 节省内存流量: %.1f%%\n",
+                   stats.fused_groups, stats.fused_ops, stats.fallback_ops,
+                   100.0 * (1.0 - (double)stats.fused_bytes / stats.unfused_bytes));
+        }
+
+        preprocess_pipeline_destroy(pipeline);
+    }
+
+    tensor_free(&image);
+    return 0;
+}
+
+// 静态缓冲区计划：动态执行与按计划执行对比（含逐操作执行以放大中间结果开销）
+static int bench_plan(const PreprocessBenchConfig* config) {
+    Tensor image = create_test_image(config->width, config->height);
+    if (!image.data) return -1;
+
+    printf("\n=== 静态缓冲区计划 (%ux%u -> 3x224x224, %u 次) ===\n",
+           config->width, config->height, config->iterations);
+    printf("%-10s %-8s %12s %14s %14s\n", "模式", "执行", "平均(ms)", "中间分配次数", "计划内存(KB)");
+
+    for (int fused = 1; fused >= 0; fused--) {
+        for (int planned = 0; planned <= 1; planned++) {
+            preprocess_pipeline_t pipeline = create_classification_pipeline(config->width, config->height);
+            if (!pipeline) {
+                tensor_free(&image);
+                return -1;
+            }
+            preprocess_pipeline_set_fusion(pipeline, fused != 0);
+
+            preprocess_plan_info_t info = {0};
+            if (planned) {
+                preprocess_plan_config_t plan_config = {0};
+                plan_config.input_shape = image.shape;
+                plan_config.input_dtype = image.dtype;
+                plan_config.input_format = image.format;
+                plan_config.bind_output = true;
+                if (preprocess_pipeline_plan(pipeline, &plan_config) != 0 ||
+                    preprocess_pipeline_get_plan_info(pipeline, &info) != 0) {
+                    LOG_ERROR("预处理管道计划失败");
+                    preprocess_pipeline_destroy(pipeline);
+                    tensor_free(&image);
+                    return -1;
+                }
+            }
+
+            double avg_ms = 0.0;
+            int ret = preprocess_pipeline_benchmark(pipeline, &image, config->iterations, &avg_ms);
+            preprocess_fusion_stats_t stats;
+            preprocess_pipeline_get_fusion_stats(pipeline, &stats);
+            preprocess_pipeline_destroy(pipeline);
+            if (ret != 0) {
+                LOG_ERROR("预处理管道执行失败");
+                tensor_free(&image);
+                return -1;
+            }
+
+            printf("%-10s %-8s %12.3f %14llu %14.1f\n", fused ? "fused" : "per-op",
+                   planned ? "planned" : "dynamic", avg_ms, (unsigned long long)stats.scratch_allocs,
+                   info.total_bytes / 1024.0);
+        }
+    }
+
+    tensor_free(&image);
+    return 0;
+}
+
+// 分块并行扩展性：线程数从1倍增到 --threads
+static int bench_parallel(const PreprocessBenchConfig* config) {
+    Tensor image = create_test_image(config->width, config->height);
+    if (!image.data) return -1;
+
+    printf("\n=== 分块并行 (%ux%u, %u 次) ===\n", config->width, config->height, config->iterations);
+    printf("%-8s %14s %14s %10s\n", "线程", "融合(ms)", "逐操作(ms)", "加速比");
+
+    double base_fused = 0.0;
+    for (uint32_t threads = 1; threads <= config->threads; threads *= 2) {
+        double avg_ms[2] = {0.0, 0.0};
+
+        for (int fused = 1; fused >= 0; fused--) {
+            preprocess_pipeline_t pipeline = create_classification_pipeline(config->width, config->height);
+            if (!pipeline || preprocess_pipeline_set_parallel(pipeline, threads) != 0) {
+                preprocess_pipeline_destroy(pipeline);
+                tensor_free(&image);
+                return -1;
+            }
+            preprocess_pipeline_set_fusion(pipeline, fused != 0);
+
+            int ret = preprocess_pipeline_benchmark(pipeline, &image, config->iterations, &avg_ms[fused]);
+            preprocess_pipeline_destroy(pipeline);
+            if (ret != 0) {
+                LOG_ERROR("预处理管道执行失败");
+                tensor_free(&image);
+                return -1;
+            }
+        }
+
+        if (threads == 1) base_fused = avg_ms[1];
+        printf("%-8u %14.3f %14.3f %9.2fx\n", threads, avg_ms[1], avg_ms[0],
+               avg_ms[1] > 0.0 ? base_fused / avg_ms[1] : 0.0);
+    }
+
+    tensor_free(&image);
+    return 0;
+}
+
+// 批量预处理吞吐：批量大小 1~64，结果写入连续批量张量
+static int bench_batch(const PreprocessBenchConfig* config) {
+    const uint32_t max_batch = 64;
+    Tensor* images = calloc(max_batch, sizeof(Tensor));
+    if (!images) return -1;
+
+    int result = 0;
+    for (uint32_t i = 0; i < max_batch && result == 0; i++) {
+        images[i] = create_test_image(config->width, config->height);
+        if (!images[i].data) result = -1;
+    }
+
+    preprocess_pipeline_t pipeline = NULL;
+    if (result == 0) {
+        pipeline = create_classification_pipeline(config->width, config->height);
+        if (!pipeline || preprocess_pipeline_set_parallel(pipeline, config->threads) != 0) {
+            result = -1;
+        }
+    }
+
+    if (result == 0) {
+        printf("\n=== 批量预处理 (%ux%u -> Nx3x224x224, %u 线程) ===\n",
+               config->width, config->height, config->threads);
+        printf("%-8s %14s %14s\n", "批量", "每批(ms)", "吞吐(张/秒)");
+    }
+
+    for (uint32_t batch = 1; batch <= max_batch && result == 0; batch *= 2) {
+        Tensor output = {0};
+        double start = get_time_ms();
+        for (uint32_t iter = 0; iter < config->iterations; iter++) {
+            if (preprocess_pipeline_execute_batch(pipeline, images, &output, batch) != 0) {
+                LOG_ERROR("批量预处理失败 (batch=%u)", batch);
+                result = -1;
+                break;
+            }
+        }
+        double avg_ms = (get_time_ms() - start) / config->iterations;
+        tensor_free(&output);
+
+        if (result == 0) {
+            printf("%-8u %14.3f %14.1f\n", batch, avg_ms, avg_ms > 0.0 ? batch * 1000.0 / avg_ms : 0.0);
+        }
+    }
+
+    preprocess_pipeline_destroy(pipeline);
+    for (uint32_t i = 0; i < max_batch; i++) {
+        tensor_free(&images[i]);
+    }
+    free(images);
+    return result;
+}
+
+// 查找表组合：亮度 -> 对比度 -> 伽马，组合为一张表与逐操作对比
+static int bench_lut(const PreprocessBenchConfig* config) {
+    Tensor image = create_test_image(config->width, config->height);
+    if (!image.data) return -1;
+
+    printf("\n=== 查找表光度调整 (%ux%u UINT8, %u 次) ===\n",
+           config->width, config->height, config->iterations);
+    printf("%-10s %12s %14s\n", "模式", "平均(ms)", "吞吐(MB/s)");
+
+    int result = 0;
+    for (int fused = 0; fused <= 1 && result == 0; fused++) {
+        preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+        if (!pipeline) {
+            result = -1;
+            break;
+        }
+
+        preprocess_params_t params = {0};
+        params.params.brightness.factor = 1.2f;
+        preprocess_op_t brightness = preprocess_op_create(PREPROCESS_BRIGHTNESS, &params);
+        params.params.contrast.factor = 1.1f;
+        preprocess_op_t contrast = preprocess_op_create(PREPROCESS_CONTRAST, &params);
+        params.params.gamma.gamma = 0.8f;
+        preprocess_op_t gamma = preprocess_op_create(PREPROCESS_GAMMA, &params);
+
+        preprocess_op_set_cache(brightness, true);
+        preprocess_op_set_cache(contrast, true);
+        preprocess_op_set_cache(gamma, true);
+        preprocess_pipeline_add_op(pipeline, brightness);
+        preprocess_pipeline_add_op(pipeline, contrast);
+        preprocess_pipeline_add_op(pipeline, gamma);
+        preprocess_pipeline_set_fusion(pipeline, fused != 0);
+        preprocess_pipeline_set_parallel(pipeline, config->threads);
+
+        double avg_ms = 0.0;
+        if (preprocess_pipeline_benchmark(pipeline, &image, config->iterations, &avg_ms) != 0) {
+            LOG_ERROR("查找表管道执行失败");
+            result = -1;
+        } else {
+            printf("%-10s %12.3f %14.1f\n", fused ? "composed" : "per-op", avg_ms,
+                   avg_ms > 0.0 ? image.size / (1024.0 * 1024.0) / (avg_ms / 1000.0) : 0.0);
+        }
+
+        preprocess_pipeline_destroy(pipeline);
+    }
+
+    tensor_free(&image);
+    return result;
+}
+
+// INT8 量化：分类管道末尾追加量化（融合与逐操作），以及单独的浮点量化/反量化吞吐
+static int bench_quant(const PreprocessBenchConfig* config) {
+    Tensor image = create_test_image(config->width, config->height);
+    if (!image.data) return -1;
+
+    printf("\n=== INT8 量化 (%ux%u -> 3x224x224 INT8, %u 次) ===\n",
+           config->width, config->height, config->iterations);
+    printf("%-12s %12s %14s\n", "模式", "平均(ms)", "吞吐(MB/s)");
+
+    preprocess_params_t quantize = {0};
+    quantize.params.quantize.dtype = TENSOR_TYPE_INT8;
+    quantize.params.quantize.channels = 1;
+    quantize.params.quantize.scale[0] = 0.0187f;
+    quantize.params.quantize.zero_point[0] = -2;
+
+    int result = 0;
+    for (int fused = 0; fused <= 1 && result == 0; fused++) {
+        preprocess_pipeline_t pipeline = create_classification_pipeline(config->width, config->height);
+        // 量化插在归一化之后、转置之前
+        if (!pipeline || preprocess_pipeline_get_op_count(pipeline) != 4) {
+            result = -1;
+        } else {
+            preprocess_params_t transpose = {0};
+            uint32_t perm[] = {0, 3, 1, 2};
+            transpose.params.transpose.ndim = 4;
+            memcpy(transpose.params.transpose.perm, perm, sizeof(perm));
+            preprocess_pipeline_remove_op(pipeline, 3);
+            preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_QUANTIZE, &quantize));
+            preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_TRANSPOSE, &transpose));
+            preprocess_pipeline_set_fusion(pipeline, fused != 0);
+        }
+
+        double avg_ms = 0.0;
+        if (result == 0 && preprocess_pipeline_benchmark(pipeline, &image, config->iterations, &avg_ms) != 0) {
+            LOG_ERROR("预处理管道执行失败");
+            result = -1;
+        }
+        if (result == 0) {
+            printf("%-12s %12.3f %14.1f\n", fused ? "fused" : "per-op", avg_ms,
+                   image.size / (avg_ms / 1000.0) / (1024.0 * 1024.0));
+        }
+        preprocess_pipeline_destroy(pipeline);
+    }
+
+    // 单独的量化/反量化内核：浮点图像 <-> INT8
+    uint32_t dims[] = {1, 3, 224, 224};
+    tensor_shape_t shape = tensor_shape_create(dims, 4);
+    Tensor values = tensor_create("bench_values", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NCHW);
+    values.data = malloc(values.size);
+    values.owns_data = values.data != NULL;
+    if (result == 0 && values.data) {
+        float* v = (float*)values.data;
+        for (size_t i = 0; i < values.size / sizeof(float); i++) {
+            v[i] = (float)rand() / RAND_MAX * 4.0f - 2.0f;
+        }
+
+        preprocess_op_t quant_op = preprocess_op_create(PREPROCESS_QUANTIZE, &quantize);
+        preprocess_params_t dequantize = quantize;
+        preprocess_op_t dequant_op = preprocess_op_create(PREPROCESS_DEQUANTIZE, &dequantize);
+        Tensor q = {0};
+        double quant_ms = 0.0, dequant_ms = 0.0;
+        if (!quant_op || !dequant_op || preprocess_op_execute(quant_op, &values, &q) != 0 ||
+            preprocess_op_benchmark(quant_op, &values, config->iterations, &quant_ms) != 0 ||
+            preprocess_op_benchmark(dequant_op, &q, config->iterations, &dequant_ms) != 0) {
+            LOG_ERROR("量化内核执行失败");
+            result = -1;
+        } else {
+            double elements = values.size / sizeof(float);
+            printf("%-12s %12.3f %14.1f\n", "quantize", quant_ms, elements / (quant_ms / 1000.0) / 1e6);
+            printf("%-12s %12.3f %14.1f\n", "dequantize", dequant_ms, elements / (dequant_ms / 1000.0) / 1e6);
+            printf("（量化内核吞吐单位为百万元素/秒）\n");
+        }
+        tensor_free(&q);
+        preprocess_op_destroy(quant_op);
+        preprocess_op_destroy(dequant_op);
+    }
+
+    tensor_free(&values);
+    tensor_free(&image);
+    return result;
+}
+
+// 相机帧接入：NV12/I420 单独转换，以及 NV12 -> 224x224 NCHW 浮点张量的融合与逐操作对比
+static int bench_color(const PreprocessBenchConfig* config) {
+    uint32_t width = config->width & ~1u;
+    uint32_t height = config->height & ~1u;
+    uint32_t dims[] = {1, height * 3 / 2, width};
+    tensor_shape_t shape = tensor_shape_create(dims, 3);
+    Tensor frame = tensor_create("bench_frame", TENSOR_TYPE_UINT8, &shape, TENSOR_FORMAT_NHWC);
+    frame.data = malloc(frame.size);
+    if (!frame.data) return -1;
+    frame.owns_data = true;
+    uint8_t* bytes = (uint8_t*)frame.data;
+    for (size_t i = 0; i < frame.size; i++) {
+        bytes[i] = (uint8_t)(rand() % 256);
+    }
+
+    printf("\n=== YUV 颜色转换 (%ux%u, %u 次) ===\n", width, height, config->iterations);
+    printf("%-12s %12s %14s\n", "模式", "平均(ms)", "吞吐(MP/s)");
+
+    int result = 0;
+    color_format_e formats[] = {COLOR_FORMAT_NV12, COLOR_FORMAT_I420};
+    const char* names[] = {"nv12->rgb", "i420->rgb"};
+    for (int i = 0; i < 2 && result == 0; i++) {
+        preprocess_params_t color = {0};
+        color.params.color_convert.src_format = formats[i];
+        color.params.color_convert.dst_format = COLOR_FORMAT_RGB;
+        color.params.color_convert.standard = COLOR_STANDARD_BT601;
+        preprocess_op_t op = preprocess_op_create(PREPROCESS_COLOR_CONVERT, &color);
+        double avg_ms = 0.0;
+        if (!op || preprocess_op_benchmark(op, &frame, config->iterations, &avg_ms) != 0) {
+            LOG_ERROR("颜色转换执行失败");
+            result = -1;
+        } else {
+            printf("%-12s %12.3f %14.1f\n", names[i], avg_ms,
+                   (double)width * height / (avg_ms / 1000.0) / 1e6);
+        }
+        preprocess_op_destroy(op);
+    }
+
+    for (int fused = 0; fused <= 1 && result == 0; fused++) {
+        preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+        if (!pipeline) {
+            result = -1;
+            break;
+        }
+
+        preprocess_params_t color = {0};
+        color.params.color_convert.src_format = COLOR_FORMAT_NV12;
+        color.params.color_convert.dst_format = COLOR_FORMAT_RGB;
+        color.params.color_convert.standard = COLOR_STANDARD_BT601;
+
+        preprocess_params_t resize = {0};
+        resize.params.resize.width = 224;
+        resize.params.resize.height = 224;
+        resize.params.resize.method = INTERPOLATION_LINEAR;
+
+        preprocess_params_t normalize = {0};
+        normalize.params.normalize.channels = 3;
+        float mean[] = {123.675f, 116.28f, 103.53f};
+        float std[] = {58.395f, 57.12f, 57.375f};
+        memcpy(normalize.params.normalize.mean, mean, sizeof(mean));
+        memcpy(normalize.params.normalize.std, std, sizeof(std));
+
+        preprocess_params_t transpose = {0};
+        uint32_t perm[] = {0, 3, 1, 2};
+        transpose.params.transpose.ndim = 4;
+        memcpy(transpose.params.transpose.perm, perm, sizeof(perm));
+
+        preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_COLOR_CONVERT, &color));
+        preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_RESIZE, &resize));
+        preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_NORMALIZE, &normalize));
+        preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_TRANSPOSE, &transpose));
+        preprocess_pipeline_set_fusion(pipeline, fused != 0);
+
+        double avg_ms = 0.0;
+        if (preprocess_pipeline_get_op_count(pipeline) != 4 ||
+            preprocess_pipeline_benchmark(pipeline, &frame, config->iterations, &avg_ms) != 0) {
+            LOG_ERROR("预处理管道执行失败");
+            result = -1;
+        } else {
+            printf("%-12s %12.3f %14.1f\n", fused ? "fused" : "per-op", avg_ms,
+                   (double)width * height / (avg_ms / 1000.0) / 1e6);
+        }
+        preprocess_pipeline_destroy(pipeline);
+    }
+
+    tensor_free(&frame);
+    return result;
+}
+
+// 邻域滤波：不同核大小下的高斯、均值、形态学耗时（后两者应与核大小无关）
+static int bench_filter(const PreprocessBenchConfig* config) {
+    Tensor image = create_test_image(config->width, config->height);
+    if (!image.data) return -1;
+
+    printf("\n=== 邻域滤波 (%ux%u UINT8, %u 次) ===\n", config->width, config->height, config->iterations);
+    printf("%-12s %6s %12s %14s\n", "操作", "核", "平均(ms)", "吞吐(MP/s)");
+
+    const uint32_t sizes[] = {3, 15, 31};
+    const char* names[] = {"gaussian", "box", "dilate"};
+    int result = 0;
+    for (int kind = 0; kind < 3 && result == 0; kind++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && result == 0; s++) {
+            preprocess_params_t params = {0};
+            preprocess_type_e type = PREPROCESS_BLUR;
+            if (kind == 2) {
+                type = PREPROCESS_MORPHOLOGY;
+                params.params.morphology.op = MORPHOLOGY_DILATE;
+                params.params.morphology.kernel_width = sizes[s];
+                params.params.morphology.kernel_height = sizes[s];
+            } else {
+                params.params.blur.kernel_size = sizes[s];
+                params.params.blur.box = kind == 1;
+            }
+
+            preprocess_op_t op = preprocess_op_create(type, &params);
+            double avg_ms = 0.0;
+            if (!op || preprocess_op_benchmark(op, &image, config->iterations, &avg_ms) != 0) {
+                LOG_ERROR("滤波执行失败");
+                result = -1;
+            } else {
+                printf("%-12s %6u %12.3f %14.1f\n", names[kind], sizes[s], avg_ms,
+                       (double)config->width * config->height / (avg_ms / 1000.0) / 1e6);
+            }
+            preprocess_op_destroy(op);
+        }
+    }
+
+    tensor_free(&image);
+    return result;
+}
+
+// 音频前端：10 秒 16kHz 信号的整段计算与 10ms 分块流式计算，按实时率报告
+static int bench_audio(const PreprocessBenchConfig* config) {
+    const uint32_t sample_rate = 16000;
+    const size_t num_samples = (size_t)sample_rate * 10;
+    const size_t chunk = sample_rate / 100;
+
+    float* samples = malloc(sizeof(float) * num_samples);
+    if (!samples) return -1;
+    for (size_t i = 0; i < num_samples; i++) {
+        samples[i] = (float)(rand() % 65536 - 32768) / 32768.0f;
+    }
+
+    printf("\n=== 音频前端 (10s @ 16kHz, n_fft=400, hop=160, %u 次) ===\n", config->iterations);
+    printf("%-10s %-10s %12s %10s\n", "特征", "模式", "平均(ms)", "实时率");
+
+    const audio_feature_e features[] = {AUDIO_FEATURE_POWER, AUDIO_FEATURE_MEL, AUDIO_FEATURE_MFCC};
+    const char* names[] = {"power", "log-mel", "mfcc"};
+    int result = 0;
+
+    for (int f = 0; f < 3 && result == 0; f++) {
+        audio_frontend_config_t fe_config = audio_frontend_default_config(features[f]);
+        audio_frontend_t frontend = audio_frontend_create(&fe_config);
+        if (!frontend) {
+            result = -1;
+            break;
+        }
+
+        uint32_t frames = audio_frontend_get_frame_count(frontend, num_samples);
+        float* out = malloc(sizeof(float) * frames * audio_frontend_get_feature_dim(frontend));
+        if (!out) {
+            audio_frontend_destroy(frontend);
+            result = -1;
+            break;
+        }
+
+        for (int streaming = 0; streaming <= 1 && result == 0; streaming++) {
+            double start = get_time_ms();
+            for (uint32_t it = 0; it < config->iterations && result == 0; it++) {
+                uint32_t produced = 0;
+                if (!streaming) {
+                    result = audio_frontend_compute(frontend, samples, num_samples, out, frames, &produced);
+                    continue;
+                }
+                audio_frontend_reset(frontend);
+                for (size_t offset = 0; offset < num_samples && result == 0; offset += chunk) {
+                    uint32_t count = 0;
+                    float* dst = out + (size_t)produced * audio_frontend_get_feature_dim(frontend);
+                    result = audio_frontend_push(frontend, samples + offset, chunk, dst, frames - produced, &count);
+                    produced += count;
+                }
+            }
+            double avg_ms = (get_time_ms() - start) / config->iterations;
+
+            if (result != 0) {
+                LOG_ERROR("音频前端执行失败");
+            } else {
+                printf("%-10s %-10s %12.3f %10.4f\n", names[f], streaming ? "stream" : "batch",
+                       avg_ms, avg_ms / 10000.0);
+            }
+        }
+
+        free(out);
+        audio_frontend_destroy(frontend);
+    }
+
+    free(samples);
+    return result;
+}
+
+// 重采样：10 秒信号在单核上整段与 10ms 分块流式重采样，按实时率报告
+static int bench_resample(const PreprocessBenchConfig* config) {
+    const uint32_t ratios[][2] = {{48000, 16000}, {44100, 16000}, {48000, 24000}, {16000, 24000}};
+    const uint32_t ratio_count = sizeof(ratios) / sizeof(ratios[0]);
+
+    printf("\n=== 多相重采样 (10s 单声道, 单线程, %u 次) ===\n", config->iterations);
+    printf("%-16s %-10s %12s %10s\n", "采样率", "模式", "平均(ms)", "实时率");
+
+    int result = 0;
+    for (uint32_t r = 0; r < ratio_count && result == 0; r++) {
+        uint32_t in_rate = ratios[r][0];
+        size_t num_samples = (size_t)in_rate * 10;
+        size_t chunk = in_rate / 100;
+
+        audio_resampler_t resampler = audio_resampler_create(in_rate, ratios[r][1]);
+        size_t length = audio_resampler_get_output_length(resampler, num_samples);
+        float* input = malloc(sizeof(float) * num_samples);
+        float* output = malloc(sizeof(float) * length);
+        if (!resampler || !input || !output) {
+            audio_resampler_destroy(resampler);
+            free(input);
+            free(output);
+            return -1;
+        }
+        for (size_t i = 0; i < num_samples; i++) {
+            input[i] = (float)(rand() % 65536 - 32768) / 32768.0f;
+        }
+
+        char label[32];
+        snprintf(label, sizeof(label), "%u->%u", in_rate, ratios[r][1]);
+
+        for (int streaming = 0; streaming <= 1 && result == 0; streaming++) {
+            double start = get_time_ms();
+            for (uint32_t it = 0; it < config->iterations && result == 0; it++) {
+                size_t produced = 0;
+                if (!streaming) {
+                    result = audio_resampler_convert(resampler, input, num_samples, output, length, &produced);
+                    continue;
+                }
+                audio_resampler_reset(resampler);
+                for (size_t offset = 0; offset < num_samples && result == 0; offset += chunk) {
+                    size_t count = 0;
+                    result = audio_resampler_process(resampler, input + offset, chunk, output + produced,
+                                                     length - produced, &count);
+                    produced += count;
+                }
+                size_t count = 0;
+                if (result == 0) {
+                    result = audio_resampler_flush(resampler, output + produced, length - produced, &count);
+                }
+            }
+            double avg_ms = (get_time_ms() - start) / config->iterations;
+
+            if (result != 0) {
+                LOG_ERROR("重采样执行失败");
+            } else {
+                printf("%-16s %-10s %12.3f %10.4f\n", label, streaming ? "stream" : "batch",
+                       avg_ms, avg_ms / 10000.0);
+            }
+        }
+
+        audio_resampler_destroy(resampler);
+        free(input);
+        free(output);
+    }
+
+    return result;
+}
+
+// 合成词表：单字母、辅音+元音音节、两音节组合（WordPiece 另含 ## 续接形式）
+#define TOKENIZE_CONSONANTS "bcdfghjklmnprstvwz"
+#define TOKENIZE_VOWELS "aeiou"
+
+static int bench_tokenize(const PreprocessBenchConfig* config) {
+    const char* consonants = TOKENIZE_CONSONANTS;
+    const char* vowels = TOKENIZE_VOWELS;
+    const uint32_t nc = (uint32_t)strlen(consonants);
+    const uint32_t nv = (uint32_t)strlen(vowels);
+    const uint32_t syllables = nc * nv;
+    const uint32_t text_count = 16384;
+    const uint32_t words_per_text = 48;
+    const uint32_t max_length = 256;
+
+    // 每个 token 最长 "##" + 4 字符
+    const uint32_t max_tokens = 3 + 26 + 2 * (syllables + syllables * syllables);
+    char* pool = malloc((size_t)max_tokens * 8);
+    const char** vocab = malloc(sizeof(char*) * max_tokens);
+    const char** merges = malloc(sizeof(char*) * max_tokens);
+    char* merge_pool = malloc((size_t)max_tokens * 12);
+    char** texts = malloc(sizeof(char*) * text_count);
+    int32_t* ids = malloc(sizeof(int32_t) * text_count * max_length);
+    uint32_t* lengths = malloc(sizeof(uint32_t) * text_count);
+    if (!pool || !vocab || !merges || !merge_pool || !texts || !ids || !lengths) {
+        free(pool);
+        free(vocab);
+        free(merges);
+        free(merge_pool);
+        free(texts);
+        free(ids);
+        free(lengths);
+        return -1;
+    }
+
+    // 语料：1~4 个音节的随机单词，词间空格，偶尔带标点
+    size_t corpus_bytes = 0;
+    for (uint32_t t = 0; t < text_count; t++) {
+        char* text = malloc(words_per_text * 10 + 1);
+        size_t len = 0;
+        for (uint32_t w = 0; w < words_per_text; w++) {
+            uint32_t parts = 1 + rand() % 4;
+            for (uint32_t p = 0; p < parts; p++) {
+                text[len++] = consonants[rand() % nc];
+                text[len++] = vowels[rand() % nv];
+            }
+            text[len++] = rand() % 16 == 0 ? ',' : ' ';
+        }
+        text[len] = '\0';
+        texts[t] = text;
+        corpus_bytes += len;
+    }
+
+    printf("\n=== 分词吞吐 (%u 条文本, %.1f MB, %u 次) ===\n", text_count, corpus_bytes / 1048576.0,
+           config->iterations);
+    printf("%-12s %8s %12s %14s %10s\n", "算法", "线程", "平均(ms)", "token/s", "MB/s");
+
+    int result = 0;
+    for (int type = TOKENIZER_WORDPIECE; type <= TOKENIZER_BPE && result == 0; type++) {
+        uint32_t count = 0;
+        uint32_t merge_count = 0;
+        char* cursor = pool;
+        char* merge_cursor = merge_pool;
+
+        vocab[count++] = type == TOKENIZER_WORDPIECE ? "[PAD]" : "<pad>";
+        vocab[count++] = type == TOKENIZER_WORDPIECE ? "[UNK]" : "<unk>";
+        vocab[count++] = ",";
+        for (char c = 'a'; c <= 'z'; c++) {
+            cursor[0] = c;
+            cursor[1] = '\0';
+            vocab[count++] = cursor;
+            cursor += 2;
+        }
+
+        for (uint32_t prefixed = 0; prefixed <= (type == TOKENIZER_WORDPIECE ? 1u : 0u); prefixed++) {
+            for (uint32_t a = 0; a < syllables; a++) {
+                for (uint32_t b = 0; b <= syllables; b++) {
+                    // b == syllables 表示单音节
+                    int n = sprintf(cursor, "%s%c%c", prefixed ? "##" : "", consonants[a / nv], vowels[a % nv]);
+                    if (b < syllables) {
+                        n += sprintf(cursor + n, "%c%c", consonants[b / nv], vowels[b % nv]);
+                    }
+                    vocab[count++] = cursor;
+                    cursor += n + 1;
+                }
+            }
+        }
+
+        // BPE 合并规则：先合成音节，再合成两音节组合
+        if (type == TOKENIZER_BPE) {
+            for (uint32_t a = 0; a < syllables; a++) {
+                merges[merge_count++] = merge_cursor;
+                merge_cursor += sprintf(merge_cursor, "%c %c", consonants[a / nv], vowels[a % nv]) + 1;
+            }
+            for (uint32_t a = 0; a < syllables; a++) {
+                for (uint32_t b = 0; b < syllables; b++) {
+                    merges[merge_count++] = merge_cursor;
+                    merge_cursor += sprintf(merge_cursor, "%c%c %c%c", consonants[a / nv], vowels[a % nv],
+                                            consonants[b / nv], vowels[b % nv]) + 1;
+                }
+            }
+        }
+
+        tokenizer_config_t tok_config = tokenizer_default_config((tokenizer_type_e)type);
+        double build_start = get_time_ms();
+        tokenizer_t tokenizer = tokenizer_create(&tok_config, vocab, count, merges, merge_count);
+        double build_ms = get_time_ms() - build_start;
+        if (!tokenizer) {
+            result = -1;
+            break;
+        }
+
+        const char* name = type == TOKENIZER_WORDPIECE ? "wordpiece" : "bpe";
+        printf("%-12s 词表 %u，合并规则 %u，编译 %.1f ms\n", name, count, merge_count, build_ms);
+
+        uint32_t thread_counts[] = {1, config->threads};
+        for (int t = 0; t < 2 && result == 0; t++) {
+            if (t == 1 && config->threads <= 1) break;
+
+            double start = get_time_ms();
+            for (uint32_t it = 0; it < config->iterations && result == 0; it++) {
+                result = tokenizer_encode_batch(tokenizer, (const char* const*)texts, text_count, ids,
+                                                max_length, lengths, thread_counts[t]);
+            }
+            double avg_ms = (get_time_ms() - start) / config->iterations;
+
+            uint64_t tokens = 0;
+            for (uint32_t i = 0; i < text_count; i++) {
+                tokens += lengths[i];
+            }
+
+            if (result != 0) {
+                LOG_ERROR("分词执行失败");
+            } else {
+                printf("%-12s %8u %12.3f %14.0f %10.1f\n", name, thread_counts[t], avg_ms,
+                       tokens / (avg_ms / 1000.0), corpus_bytes / 1048576.0 / (avg_ms / 1000.0));
+            }
+        }
+
+        tokenizer_destroy(tokenizer);
+    }
+
+    for (uint32_t t = 0; t < text_count; t++) {
+        free(texts[t]);
+    }
+    free(pool);
+    free(vocab);
+    free(merges);
+    free(merge_pool);
+    free(texts);
+    free(ids);
+    free(lengths);
+    return result;
+}
+
+// 单个点云操作在给定线程数下的平均耗时
+static int bench_pointcloud_op(preprocess_type_e type, const preprocess_params_t* params, const Tensor* cloud,
+                               uint32_t threads, uint32_t iterations, double* avg_ms, uint32_t* out_points) {
+    preprocess_op_t op = preprocess_op_create(type, params);
+    preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+    if (!op || !pipeline || preprocess_pipeline_add_op(pipeline, op) != 0 ||
+        preprocess_pipeline_set_parallel(pipeline, threads) != 0) {
+        preprocess_pipeline_destroy(pipeline);
+        return -1;
+    }
+
+    Tensor output = {0};
+    int ret = preprocess_pipeline_execute(pipeline, cloud, &output);
+    if (ret == 0) {
+        *out_points = output.shape.dims[0];
+        ret = preprocess_pipeline_benchmark(pipeline, cloud, iterations, avg_ms);
+    }
+
+    tensor_free(&output);
+    preprocess_pipeline_destroy(pipeline);
+    return ret;
+}
+
+// 点云处理：k-d 树构建与查询、体素降采样、离群点去除、法向量估计
+static int bench_pointcloud(const PreprocessBenchConfig* config) {
+    const uint32_t count = 131072;
+    const uint32_t iterations = config->iterations < 10 ? config->iterations : 10;
+
+    // 模拟激光雷达帧：地面、两面墙和少量散点，通道为 x、y、z、强度
+    uint32_t dims[] = {count, 4};
+    TensorShape shape = tensor_shape_create(dims, 2);
+    Tensor cloud = tensor_create("points", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NC);
+    cloud.data = malloc(cloud.size);
+    cloud.owns_data = true;
+    if (!cloud.data) return -1;
+
+    float* pts = (float*)cloud.data;
+    for (uint32_t i = 0; i < count; i++) {
+        float u = (float)rand() / RAND_MAX * 40.0f - 20.0f;
+        float v = (float)rand() / RAND_MAX * 40.0f - 20.0f;
+        float noise = ((float)rand() / RAND_MAX - 0.5f) * 0.02f;
+        float* p = pts + (size_t)i * 4;
+        switch (i % 8) {
+            case 0: p[0] = 20.0f + noise; p[1] = u; p[2] = fabsf(v) * 0.1f - 1.7f; break;
+            case 1: p[0] = u; p[1] = -20.0f + noise; p[2] = fabsf(v) * 0.1f - 1.7f; break;
+            case 2: p[0] = u * 2.0f; p[1] = v * 2.0f; p[2] = u; break;
+            default: p[0] = u; p[1] = v; p[2] = -1.7f + noise; break;
+        }
+        p[3] = (float)rand() / RAND_MAX;
+    }
+
+    printf("\n=== 点云处理 (%u 点, %u 次) ===\n", count, iterations);
+    printf("%-8s %12s %12s %12s %12s %12s\n", "线程", "建树(ms)", "16-NN(ms)", "体素(ms)", "离群点(ms)", "法向量(ms)");
+
+    int result = 0;
+    uint32_t voxel_points = 0;
+    uint32_t inliers = 0;
+    for (uint32_t threads = 1; threads <= config->threads && result == 0; threads *= 2) {
+        // 建树
+        double start = get_time_ms();
+        for (uint32_t it = 0; it < iterations; it++) {
+            kdtree_destroy(kdtree_build(pts, count, 4, threads));
+        }
+        double build_ms = (get_time_ms() - start) / iterations;
+
+        // 单线程逐点查询 16 个近邻
+        kdtree_t tree = kdtree_build(pts, count, 4, threads);
+        if (!tree) {
+            result = -1;
+            break;
+        }
+        uint32_t neighbors[16];
+        start = get_time_ms();
+        for (uint32_t i = 0; i < count; i++) {
+            kdtree_knn(tree, pts + (size_t)i * 4, 16, neighbors, NULL);
+        }
+        double knn_ms = get_time_ms() - start;
+        kdtree_destroy(tree);
+
+        double voxel_ms = 0.0;
+        double outlier_ms = 0.0;
+        double normal_ms = 0.0;
+        uint32_t out_points = 0;
+
+        preprocess_params_t params = {0};
+        params.params.downsample.voxel_size = 0.2f;
+        result = bench_pointcloud_op(PREPROCESS_DOWNSAMPLE, &params, &cloud, threads, iterations,
+                                     &voxel_ms, &voxel_points);
+
+        memset(&params, 0, sizeof(params));
+        params.params.outlier_removal.k = 16;
+        params.params.outlier_removal.std_ratio = 2.0f;
+        if (result == 0) {
+            result = bench_pointcloud_op(PREPROCESS_OUTLIER_REMOVAL, &params, &cloud, threads, iterations,
+                                         &outlier_ms, &inliers);
+        }
+
+        memset(&params, 0, sizeof(params));
+        params.params.normal_estimation.k = 16;
+        if (result == 0) {
+            result = bench_pointcloud_op(PREPROCESS_NORMAL_ESTIMATION, &params, &cloud, threads, iterations,
+                                         &normal_ms, &out_points);
+        }
+
+        if (result != 0) {
+            LOG_ERROR("点云处理失败");
+        } else {
+            printf("%-8u %12.2f %12.2f %12.2f %12.2f %12.2f\n", threads, build_ms, knn_ms, voxel_ms,
+                   outlier_ms, normal_ms);
+        }
+    }
+
+    if (result == 0) {
+        printf("体素 0.2m 后 %u 点，去除离群点后 %u 点\n", voxel_points, inliers);
+    }
+
+    tensor_free(&cloud);
+    return result;
+}
+
+// 多模态样本：相机帧、1 秒音频和激光雷达帧逐模态串行与并发执行对比
+static int bench_multimodal(const PreprocessBenchConfig* config) {
+    Tensor image = create_test_image(config->width, config->height);
+    if (!image.data) return -1;
+
+    uint32_t audio_dims[] = {1, 48000};
+    TensorShape audio_shape = tensor_shape_create(audio_dims, 2);
+    Tensor audio = tensor_create("bench_audio", TENSOR_TYPE_FLOAT32, &audio_shape, TENSOR_FORMAT_NC);
+    uint32_t cloud_dims[] = {32768, 3};
+    TensorShape cloud_shape = tensor_shape_create(cloud_dims, 2);
+    Tensor cloud = tensor_create("bench_cloud", TENSOR_TYPE_FLOAT32, &cloud_shape, TENSOR_FORMAT_NC);
+    audio.data = malloc(audio.size);
+    audio.owns_data = audio.data != NULL;
+    cloud.data = malloc(cloud.size);
+    cloud.owns_data = cloud.data != NULL;
+
+    int result = audio.data && cloud.data ? 0 : -1;
+    MultiModalData* input = multimodal_data_create(3);
+    MultiModalData* output = multimodal_data_create(3);
+    preprocess_pipeline_t image_pipeline = create_classification_pipeline(config->width, config->height);
+    preprocess_pipeline_t audio_pipeline = preprocess_pipeline_create();
+    preprocess_pipeline_t cloud_pipeline = preprocess_pipeline_create();
+    if (!input || !output || !image_pipeline || !audio_pipeline || !cloud_pipeline) result = -1;
+
+    if (result == 0) {
+        for (size_t i = 0; i < audio.size / sizeof(float); i++) {
+            ((float*)audio.data)[i] = sinf(6.2831853f * 440.0f * i / 48000.0f);
+        }
+        for (size_t i = 0; i < cloud.size / sizeof(float); i++) {
+            ((float*)cloud.data)[i] = (float)rand() / RAND_MAX * 10.0f;
+        }
+
+        preprocess_params_t resample = {0};
+        resample.params.resample.sample_rate = 48000;
+        resample.params.resample.target_rate = 16000;
+        preprocess_params_t mfcc = {0};
+        mfcc.params.mfcc.n_mfcc = 13;
+        mfcc.params.mfcc.n_fft = 400;
+        mfcc.params.mfcc.hop_length = 160;
+        preprocess_pipeline_add_op(audio_pipeline, preprocess_op_create(PREPROCESS_RESAMPLE, &resample));
+        preprocess_pipeline_add_op(audio_pipeline, preprocess_op_create(PREPROCESS_MFCC, &mfcc));
+
+        preprocess_params_t normals = {0};
+        normals.params.normal_estimation.k = 16;
+        preprocess_pipeline_add_op(cloud_pipeline, preprocess_op_create(PREPROCESS_NORMAL_ESTIMATION, &normals));
+
+        const Tensor* tensors[] = {&image, &audio, &cloud};
+        modality_type_e modalities[] = {MODALITY_IMAGE, MODALITY_AUDIO, MODALITY_LIDAR};
+        for (int i = 0; i < 3; i++) {
+            ModalityData modal = {0};
+            modal.modality = modalities[i];
+            modal.format = DATA_FORMAT_CUSTOM;
+            modal.data = tensors[i]->data;
+            modal.data_size = tensors[i]->size;
+            modal.shape = tensors[i]->shape;
+            modal.data_type = tensors[i]->dtype;
+            if (multimodal_data_add(input, &modal) != 0) result = -1;
+        }
+    }
+
+    preprocess_modality_pipeline_t map[] = {
+        {MODALITY_IMAGE, image_pipeline},
+        {MODALITY_AUDIO, audio_pipeline},
+        {MODALITY_LIDAR, cloud_pipeline},
+    };
+    if (result == 0 && preprocess_multimodal_prepare_output(map, 3, input, output) != 0) {
+        result = -1;
+    }
+
+    printf("\n=== 多模态样本 (相机 %ux%u + 1s 音频 + 32768 点, %u 次) ===\n",
+           config->width, config->height, config->iterations);
+    printf("%-12s %12s\n", "模式", "平均(ms)");
+
+    // 先单独计时各模态，再对比串行与并发执行整个样本
+    const char* names[] = {"image", "audio", "lidar"};
+    const Tensor* tensors[] = {&image, &audio, &cloud};
+    for (int i = 0; i < 3 && result == 0; i++) {
+        double avg_ms = 0.0;
+        if (preprocess_pipeline_benchmark(map[i].pipeline, tensors[i], config->iterations, &avg_ms) != 0) {
+            result = -1;
+        } else {
+            printf("%-12s %12.3f\n", names[i], avg_ms);
+        }
+    }
+    for (uint32_t threads = 1; threads <= 3 && result == 0; threads += 2) {
+        double start = get_time_ms();
+        for (uint32_t it = 0; it < config->iterations && result == 0; it++) {
+            result = preprocess_multimodal_execute_pipelines(map, 3, input, output, threads);
+        }
+        if (result == 0) {
+            printf("%-12s %12.3f\n", threads == 1 ? "serial" : "concurrent",
+                   (get_time_ms() - start) / config->iterations);
+        }
+    }
+    if (result != 0) LOG_ERROR("多模态预处理执行失败");
+
+    preprocess_pipeline_destroy(image_pipeline);
+    preprocess_pipeline_destroy(audio_pipeline);
+    preprocess_pipeline_destroy(cloud_pipeline);
+    multimodal_data_destroy(input);
+    multimodal_data_destroy(output);
+    tensor_free(&cloud);
+    tensor_free(&audio);
+    tensor_free(&image);
+    return result;
+}
+
+// 图像加载基准输入：编码后的文件内容
+typedef struct {
+    uint8_t* data;
+    size_t size;
+} bench_file_t;
+
+#define DECODE_MAX_FILES 64
+
+static bool has_jpeg_extension(const char* name) {
+    const char* dot = strrchr(name, '.');
+    if (!dot) return false;
+    char ext[8] = {0};
+    for (size_t i = 0; i < sizeof(ext) - 1 && dot[i + 1]; i++) {
+        ext[i] = (char)tolower((unsigned char)dot[i + 1]);
+    }
+    return strcmp(ext, "jpg") == 0 || strcmp(ext, "jpeg") == 0;
+}
+
+// 列出目录下的 JPEG 文件路径（最多 max_count 个，路径由调用者释放）
+static uint32_t list_jpeg_dir(const char* dir_path, char** paths, uint32_t max_count) {
+    DIR* dir = opendir(dir_path);
+    if (!dir) {
+        LOG_ERROR("无法打开图像目录: %s", dir_path);
+        return 0;
+    }
+
+    uint32_t count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL && count < max_count) {
+        if (!has_jpeg_extension(entry->d_name)) continue;
+        size_t length = strlen(dir_path) + strlen(entry->d_name) + 2;
+        paths[count] = malloc(length);
+        if (!paths[count]) break;
+        snprintf(paths[count], length, "%s/%s", dir_path, entry->d_name);
+        count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+// 读取目录下的 JPEG 文件（最多 DECODE_MAX_FILES 个）
+static uint32_t load_jpeg_dir(const char* dir_path, bench_file_t* files) {
+    char* paths[DECODE_MAX_FILES];
+    uint32_t found = list_jpeg_dir(dir_path, paths, DECODE_MAX_FILES);
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < found; i++) {
+        FILE* file = fopen(paths[i], "rb");
+        free(paths[i]);
+        if (!file) continue;
+        fseek(file, 0, SEEK_END);
+        long length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        uint8_t* data = length > 0 ? malloc((size_t)length) : NULL;
+        if (data && fread(data, 1, (size_t)length, file) == (size_t)length) {
+            files[count].data = data;
+            files[count].size = (size_t)length;
+            count++;
+        } else {
+            free(data);
+        }
+        fclose(file);
+    }
+    return count;
+}
+
+// 生成 24 位 BMP（未指定 JPEG 目录时使用）
+static bench_file_t create_test_bmp(uint32_t width, uint32_t height) {
+    bench_file_t file = {0};
+    size_t stride = ((size_t)width * 3 + 3) & ~(size_t)3;
+    size_t size = 54 + stride * height;
+    uint8_t* data = calloc(1, size);
+    if (!data) return file;
+
+    uint32_t fields[][2] = {{2, (uint32_t)size}, {10, 54}, {14, 40}, {18, width}, {22, height}};
+    data[0] = 'B';
+    data[1] = 'M';
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        uint32_t v = fields[i][1];
+        uint8_t* p = data + fields[i][0];
+        p[0] = (uint8_t)v;
+        p[1] = (uint8_t)(v >> 8);
+        p[2] = (uint8_t)(v >> 16);
+        p[3] = (uint8_t)(v >> 24);
+    }
+    data[26] = 1;
+    data[28] = 24;
+
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t* row = data + 54 + stride * y;
+        for (uint32_t x = 0; x < width * 3; x++) {
+            row[x] = (uint8_t)((x + y) ^ (rand() & 0x0F));
+        }
+    }
+
+    file.data = data;
+    file.size = size;
+    return file;
+}
+
+// 批量图像加载：解码为 UINT8 后经管道缩放/归一化/转置（原路径），与逐行直接写入目标张量对比
+static int bench_decode(const PreprocessBenchConfig* config) {
+    bench_file_t files[DECODE_MAX_FILES];
+    memset(files, 0, sizeof(files));
+    uint32_t count = 0;
+    const char* source = "jpeg";
+    if (config->image_dir) {
+        count = load_jpeg_dir(config->image_dir, files);
+        if (count == 0) {
+            printf("❌ 目录中没有 JPEG 文件: %s\n", config->image_dir);
+            return -1;
+        }
+    } else {
+        // 没有 JPEG 目录时使用无压缩 BMP，只比较缩放、归一化和布局部分
+        source = "bmp";
+        for (count = 0; count < 8; count++) {
+            files[count] = create_test_bmp(config->width, config->height);
+            if (!files[count].data) break;
+        }
+    }
+
+    const float mean[] = {123.675f, 116.28f, 103.53f};
+    const float std[] = {58.395f, 57.12f, 57.375f};
+
+    // 原路径：UINT8 NHWC 解码结果 -> 缩放 -> 归一化 -> NHWC转NCHW
+    preprocess_pipeline_t pipeline = preprocess_pipeline_create();
+    if (!pipeline) return -1;
+    preprocess_params_t resize = {0};
+    resize.params.resize.width = 224;
+    resize.params.resize.height = 224;
+    resize.params.resize.method = INTERPOLATION_LINEAR;
+    preprocess_params_t normalize = {0};
+    normalize.params.normalize.channels = 3;
+    memcpy(normalize.params.normalize.mean, mean, sizeof(mean));
+    memcpy(normalize.params.normalize.std, std, sizeof(std));
+    preprocess_params_t transpose = {0};
+    uint32_t perm[] = {0, 3, 1, 2};
+    transpose.params.transpose.ndim = 4;
+    memcpy(transpose.params.transpose.perm, perm, sizeof(perm));
+    preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_RESIZE, &resize));
+    preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_NORMALIZE, &normalize));
+    preprocess_pipeline_add_op(pipeline, preprocess_op_create(PREPROCESS_TRANSPOSE, &transpose));
+
+    printf("\n=== 批量图像加载 (%u 个 %s -> 224x224, %u 轮) ===\n", count, source, config->iterations);
+    printf("%-16s %14s %14s\n", "模式", "每张(ms)", "吞吐(张/秒)");
+
+    const struct {
+        const char* name;
+        TensorFormat format;
+        TensorDataType dtype;
+    } modes[] = {
+        {"decode+pipeline", TENSOR_FORMAT_NCHW, TENSOR_TYPE_FLOAT32},
+        {"direct-f32", TENSOR_FORMAT_NCHW, TENSOR_TYPE_FLOAT32},
+        {"direct-f16", TENSOR_FORMAT_NCHW, TENSOR_TYPE_FLOAT16},
+        {"direct-u8", TENSOR_FORMAT_NHWC, TENSOR_TYPE_UINT8},
+    };
+
+    int result = 0;
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]) && result == 0; m++) {
+        image_tensor_layout_t layout = {0};
+        layout.width = 224;
+        layout.height = 224;
+        layout.channels = 3;
+        layout.format = modes[m].format;
+        layout.dtype = modes[m].dtype;
+        memcpy(layout.mean, mean, sizeof(mean));
+        memcpy(layout.std, std, sizeof(std));
+        image_decode_options_t options = {3, 224, 224};
+
+        double start = get_time_ms();
+        for (uint32_t it = 0; it < config->iterations && result == 0; it++) {
+            for (uint32_t i = 0; i < count && result == 0; i++) {
+                Tensor output = {0};
+                if (m == 0) {
+                    Tensor decoded = {0};
+                    result = image_decode_memory(files[i].data, files[i].size, &options, &decoded);
+                    if (result == 0) result = preprocess_pipeline_execute(pipeline, &decoded, &output);
+                    tensor_free(&decoded);
+                } else {
+                    result = image_decode_memory_to_tensor(files[i].data, files[i].size, &layout, &output);
+                }
+                tensor_free(&output);
+            }
+        }
+        double avg_ms = (get_time_ms() - start) / ((double)config->iterations * count);
+
+        if (result != 0) {
+            LOG_ERROR("图像加载失败 (%s)", modes[m].name);
+        } else {
+            printf("%-16s %14.3f %14.1f\n", modes[m].name, avg_ms, avg_ms > 0.0 ? 1000.0 / avg_ms : 0.0);
+        }
+    }
+
+    preprocess_pipeline_destroy(pipeline);
+    for (uint32_t i = 0; i < count; i++) {
+        free(files[i].data);
+    }
+    return result;
+}
+
+// 预取批量加载：逐张同步加载与后台工作线程预取对比，可选每批模拟推理耗时
+static int bench_loader(const PreprocessBenchConfig* config) {
+    const uint32_t batch_size = 8;
+    char* paths[DECODE_MAX_FILES];
+    uint32_t count = 0;
+    char temp_dir[] = "/tmp/modyn_loader_XXXXXX";
+    bool generated = false;
+
+    if (config->image_dir) {
+        count = list_jpeg_dir(config->image_dir, paths, DECODE_MAX_FILES);
+    } else if (mkdtemp(temp_dir)) {
+        // 没有 JPEG 目录时在临时目录生成 BMP
+        generated = true;
+        for (count = 0; count < 32; count++) {
+            size_t length = sizeof(temp_dir) + 16;
+            paths[count] = malloc(length);
+            if (!paths[count]) break;
+            snprintf(paths[count], length, "%s/%u.bmp", temp_dir, count);
+
+            bench_file_t bmp = create_test_bmp(config->width, config->height);
+            FILE* file = bmp.data ? fopen(paths[count], "wb") : NULL;
+            bool ok = file && fwrite(bmp.data, 1, bmp.size, file) == bmp.size;
+            if (file) fclose(file);
+            free(bmp.data);
+            if (!ok) {
+                free(paths[count]);
+                break;
+            }
+        }
+    }
+    if (count == 0) {
+        printf("❌ 没有可用的测试图像\n");
+        return -1;
+    }
+
+    ImageProcessConfig process = image_utils_create_config(224, 224, 3, TENSOR_FORMAT_NCHW, true);
+    uint32_t dims[] = {batch_size, 3, 224, 224};
+    TensorShape shape = tensor_shape_create(dims, 4);
+    Tensor serial = tensor_create("bench_batch", TENSOR_TYPE_FLOAT32, &shape, TENSOR_FORMAT_NCHW);
+    serial.data = malloc(serial.size);
+    if (!serial.data) return -1;
+    serial.owns_data = true;
+    size_t sample = serial.size / batch_size;
+
+    printf("\n=== 预取批量加载 (%u 个 %s -> %ux3x224x224, %u 轮) ===\n", count,
+           generated ? "bmp" : "jpeg", batch_size, config->iterations);
+    printf("%-10s %-8s %14s %14s %12s\n", "模式", "推理(ms)", "每批(ms)", "吞吐(张/秒)", "等待占比");
+
+    int result = 0;
+    const uint32_t infer_ms[] = {0, 20};
+    for (uint32_t k = 0; k < 2 && result == 0; k++) {
+        for (uint32_t workers = 0; workers <= config->threads && result == 0; workers = workers ? workers * 2 : 1) {
+            double wait_ms = 0.0;
+            uint32_t batches = 0;
+            double start = get_time_ms();
+            for (uint32_t it = 0; it < config->iterations && result == 0; it++) {
+                if (workers == 0) {
+                    // 原方式：调用线程逐张加载后再执行推理
+                    for (uint32_t i = 0; i < count; i += batch_size) {
+                        double load_start = get_time_ms();
+                        for (uint32_t j = 0; j < batch_size && i + j < count; j++) {
+                            Tensor slot = {0};
+                            slot.data = (uint8_t*)serial.data + sample * j;
+                            slot.size = sample;
+                            image_utils_load_into(paths[i + j], &process, &slot, NULL);
+                        }
+                        wait_ms += get_time_ms() - load_start;
+                        if (infer_ms[k]) usleep(infer_ms[k] * 1000);
+                        batches++;
+                    }
+                    continue;
+                }
+
+                image_loader_config_t loader_config = {0};
+                loader_config.process = process;
+                loader_config.batch_size = batch_size;
+                loader_config.num_workers = workers;
+                loader_config.prefetch_batches = 2;
+                loader_config.ordered = true;
+                image_loader_t loader = image_loader_create((const char* const*)paths, count, &loader_config);
+                if (!loader) {
+                    result = -1;
+                    break;
+                }
+                image_batch_t batch;
+                while (image_loader_next(loader, &batch) == 0) {
+                    if (infer_ms[k]) usleep(infer_ms[k] * 1000);
+                    image_loader_release(loader, &batch);
+                    batches++;
+                }
+                image_loader_stats_t stats;
+                image_loader_get_stats(loader, &stats);
+                wait_ms += stats.wait_ms;
+                image_loader_destroy(loader);
+            }
+            double total_ms = get_time_ms() - start;
+
+            if (result != 0) {
+                LOG_ERROR("批量加载失败");
+            } else {
+                char mode[16];
+                snprintf(mode, sizeof(mode), workers ? "prefetch-%u" : "serial", workers);
+                double images = (double)count * config->iterations;
+                printf("%-10s %-8u %14.3f %14.1f %11.1f%%\n", mode, infer_ms[k], total_ms / batches,
+                       images * 1000.0 / total_ms, 100.0 * wait_ms / total_ms);
+            }
+        }
+    }
+
+    tensor_free(&serial);
+    for (uint32_t i = 0; i < count; i++) {
+        if (generated) remove(paths[i]);
+        free(paths[i]);
+    }
+    if (generated) rmdir(temp_dir);
+    return result;
+}
+
+// 压缩并解压一组数据，打印压缩率与吞吐
+static int bench_codec_case(const char* name, const void* data, size_t size, const tensor_codec_options_t* options,
+                            uint32_t iterations) {
+    static const char* shuffle_names[] = {"-", "byte", "bit"};
+    size_t capacity = tensor_codec_compress_bound(size);
+    uint8_t* packed = malloc(capacity);
+    uint8_t* restored = malloc(size);
+    size_t written = 0;
+    size_t restored_size = 0;
+    int result = packed && restored ? 0 : -1;
+
+    double start = get_time_ms();
+    for (uint32_t i = 0; i < iterations && result == 0; i++) {
+        result = tensor_codec_compress(data, size, options, packed, capacity, &written);
+    }
+    double compress_ms = get_time_ms() - start;
+
+    start = get_time_ms();
+    for (uint32_t i = 0; i < iterations && result == 0; i++) {
+        result = tensor_codec_decompress(packed, written, restored, size, &restored_size);
+    }
+    double decompress_ms = get_time_ms() - start;
+
+    if (result == 0 && memcmp(restored, data, size) != 0) {
+        LOG_ERROR("%s 解压结果与原数据不一致", name);
+        result = -1;
+    }
+    if (result == 0) {
+        double gb = (double)size * iterations / 1e9;
+        printf("%-10s %-6s %-5s %8.2f %12.2f %12.2f\n", name, shuffle_names[options->shuffle],
+               options->delta ? "yes" : "no", (double)size / written,
+               gb / (compress_ms / 1000.0), gb / (decompress_ms / 1000.0));
+    }
+
+    free(packed);
+    free(restored);
+    return result;
+}
+
+static int bench_codec(const PreprocessBenchConfig* config) {
+    const size_t count = 1u << 21;
+    uint32_t iterations = config->iterations < 20 ? config->iterations : 20;
+    int16_t* audio = malloc(count * sizeof(int16_t));
+    float* points = malloc(count * sizeof(float));
+    uint16_t* depth = malloc(count * sizeof(uint16_t));
+    uint8_t* mask = malloc(count);
+    int result = audio && points && depth && mask ? 0 : -1;
+
+    // 合成数据：带噪声的正弦音频、扫描线点云坐标、平滑深度图、稀疏掩码
+    uint32_t seed = 1;
+    for (size_t i = 0; i < count && result == 0; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t noise = seed >> 16;
+        audio[i] = (int16_t)(8000.0 * sin((double)i * 0.01) + (double)(noise % 32) - 16.0);
+        points[i] = (float)((i % 3 == 2) ? -1.7 + (noise % 8) * 0.001 : ((i / 3) % 2048) * 0.05 + (noise % 16) * 0.0005);
+        depth[i] = (uint16_t)(1500 + (i % config->width) / 4 + (i / config->width) / 8 + noise % 4);
+        mask[i] = (noise % 10) == 0;
+    }
+
+    printf("\n=== 张量无损压缩 (每组 %zu 个元素, %u 次) ===\n", count, iterations);
+    printf("%-10s %-6s %-5s %8s %12s %12s\n", "数据", "重排", "差分", "压缩率", "压缩GB/s", "解压GB/s");
+
+    struct {
+        const char* name;
+        const void* data;
+        size_t size;
+        uint32_t width;
+    } cases[] = {
+        {"audio", audio, count * sizeof(int16_t), 2},
+        {"points", points, count * sizeof(float), 4},
+        {"depth", depth, count * sizeof(uint16_t), 2},
+        {"mask", mask, count, 1},
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]) && result == 0; c++) {
+        for (int variant = 0; variant < 4 && result == 0; variant++) {
+            tensor_codec_options_t options = { cases[c].width, TENSOR_CODEC_SHUFFLE_NONE, false };
+            if (variant == 1) options.shuffle = TENSOR_CODEC_SHUFFLE_BYTE;
+            if (variant == 2) options.shuffle = TENSOR_CODEC_SHUFFLE_BIT;
+            if (variant == 3) {
+                options.shuffle = TENSOR_CODEC_SHUFFLE_BYTE;
+                options.delta = true;
+            }
+            result = bench_codec_case(cases[c].name, cases[c].data, cases[c].size, &options, iterations);
+        }
+    }
+
+    free(audio);
+    free(points);
+    free(depth);
+    free(mask);
+    return result;
+}
+
+static const BenchSuite g_suites[] = {
+    {"fusion", "融合内核与逐操作执行对比", bench_fusion},
+    {"plan", "静态缓冲区计划与动态执行对比", bench_plan},
+    {"parallel", "分块并行线程扩展性", bench_parallel},
+    {"batch", "批量预处理吞吐（批量 1~64）", bench_batch},
+    {"lut", "亮度/对比度/伽马查找表组合", bench_lut},
+    {"quant", "归一化+INT8量化融合与量化内核吞吐", bench_quant},
+    {"color", "NV12/I420 转 RGB 及转换+缩放+归一化融合", bench_color},
+    {"filter", "高斯/均值/形态学滤波随核大小的耗时", bench_filter},
+    {"audio", "STFT/梅尔谱/MFCC 整段与流式计算", bench_audio},
+    {"resample", "多相 FIR 重采样实时率", bench_resample},
+    {"tokenize", "WordPiece/BPE 批量分词吞吐", bench_tokenize},
+    {"pointcloud", "k-d 树、体素降采样、离群点与法向量", bench_pointcloud},
+    {"multimodal", "相机+音频+激光雷达样本串行与并发执行", bench_multimodal},
+    {"decode", "批量图像解码直接写入张量与解码+管道对比", bench_decode},
+    {"loader", "预取批量加载与逐张同步加载对比", bench_loader},
+    {"codec", "张量无损压缩（重排/差分/LZ）压缩率与吞吐", bench_codec},
+};
+
+#define SUITE_COUNT (sizeof(g_suites) / sizeof(g_suites[0]))
+
+// 打印使用说明
+static void print_usage(const char* program_name) {
+    printf("Modyn 预处理性能测试工具\n");
+    printf("\n");
+    printf("用法: %s [选项]\n", program_name);
+    printf("\n");
+    printf("选项:\n");
+    printf("  -s, --suite <名称>      测试项 (默认: all)\n");
+    printf("  -W, --width <像素>      输入图像宽度 (默认: 1920)\n");
+    printf("  -H, --height <像素>     输入图像高度 (默认: 1080)\n");
+    printf("  -i, --iterations <数量> 迭代次数 (默认: 50)\n");
+    printf("  -t, --threads <数量>    最大线程数 (默认: 8)\n");
+    printf("  -d, --images <目录>     decode/loader 测试使用的 JPEG 目录 (默认: 生成 BMP)\n");
+    printf("  -h, --help              显示帮助信息\n");
+    printf("\n");
+    printf("测试项:\n");
+    for (size_t i = 0; i < SUITE_COUNT; i++) {
+        printf("  %-12s %s\n", g_suites[i].name, g_suites[i].description);
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    PreprocessBenchConfig config = {0};
+    config.width = 1920;
+    config.height = 1080;
+    config.iterations = 50;
+    config.threads = 8;
+    config.suite = "all";
+
+    static struct option long_options[] = {
+        {"suite", required_argument, 0, 's'},
+        {"width", required_argument, 0, 'W'},
+        {"height", required_argument, 0, 'H'},
+        {"iterations", required_argument, 0, 'i'},
+        {"threads", required_argument, 0, 't'},
+        {"images", required_argument, 0, 'd'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "s:W:H:i:t:d:h", long_options, NULL)) != -1) {
+        switch (c) {
+            case 's':
+                config.suite = optarg;
+                break;
+            case 'W':
+                config.width = (uint32_t)atoi(optarg);
+                break;
+            case 'H':
+                config.height = (uint32_t)atoi(optarg);
+                break;
+            case 'i':
+                config.iterations = (uint32_t)atoi(optarg);
+                break;
+            case 't':
+                config.threads = (uint32_t)atoi(optarg);
+                break;
+            case 'd':
+                config.image_dir = optarg;
+                break;
+            case 'h':
+            default:
+                print_usage(argv[0]);
+                return 0;
+        }
+    }
+
+    if (config.width == 0 || config.height == 0 || config.iterations == 0 || config.threads == 0) {
+        printf("❌ 图像尺寸、迭代次数和线程数必须大于0\n");
+        return 1;
+    }
+
+    logger_init(LOG_LEVEL_WARN, NULL);
+    logger_set_console_output(true);
+
+    int result = 0;
+    bool matched = false;
+    for (size_t i = 0; i < SUITE_COUNT; i++) {
+        if (strcmp(config.suite, "all") == 0 || strcmp(config.suite, g_suites[i].name) == 0) {
+            matched = true;
+            if (g_suites[i].func(&config) != 0) {
+                result = 1;
+            }
+        }
+    }
+
+    if (!matched) {
+        printf("❌ 未知测试项: %s\n", config.suite);
+        print_usage(argv[0]);
+        result = 1;
+    }
+
+    logger_cleanup();
+    return result;
+}
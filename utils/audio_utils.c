@@ -0,0 +1,1126 @@
+#include "utils/audio_utils.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// 对数谱的下限，避免 log(0)
+#define AUDIO_LOG_FLOOR 1e-10f
+
+// FFT 分解的最大级数
+#define AUDIO_MAX_STAGES 32
+
+// 频域计算每次处理一组帧，每个 SIMD 通道对应一帧，
+// 因此所有蝶形运算都是整向量操作，不需要跨通道重排
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON))
+typedef float audio_vec_t __attribute__((vector_size(16)));
+#define AUDIO_LANES 4
+#define VEC_LANE(v, l) ((v)[l])
+#else
+typedef float audio_vec_t;
+#define AUDIO_LANES 1
+#define VEC_LANE(v, l) (v)
+#endif
+
+/**
+ * @brief 标量复数（旋转因子）
+ */
+typedef struct {
+    float r;
+    float i;
+} audio_complex_t;
+
+/**
+ * @brief 向量复数：每个通道是不同帧的同一频点
+ */
+typedef struct {
+    audio_vec_t r;
+    audio_vec_t i;
+} audio_cvec_t;
+
+/**
+ * @brief 按配置预计算的表，相同配置的前端共享
+ */
+typedef struct audio_plan_t {
+    audio_frontend_config_t config;
+    uint32_t refs;
+    uint32_t n_bins;                /**< 频点数 n_fft/2+1 */
+    uint32_t ncfft;                 /**< 复数 FFT 点数 n_fft/2 */
+    uint32_t stages[2 * AUDIO_MAX_STAGES]; /**< 每级的基 p 和子序列长度 m */
+    float* window;                  /**< 补零到 n_fft 的窗函数 */
+    audio_complex_t* twiddles;      /**< 复数 FFT 旋转因子 */
+    audio_complex_t* super_twiddles; /**< 实数 FFT 后处理旋转因子 */
+    uint32_t* mel_start;            /**< 每个滤波器的首个非零频点 */
+    uint32_t* mel_length;           /**< 每个滤波器的非零频点数 */
+    uint32_t* mel_offset;           /**< 每个滤波器权重在 mel_weights 中的偏移 */
+    float* mel_weights;             /**< 滤波器非零权重 */
+    float* dct;                     /**< 正交 DCT-II 矩阵 [n_mfcc, n_mels] */
+    size_t work_vectors;            /**< 一组帧所需的工作区向量数 */
+    struct audio_plan_t* next;
+} audio_plan_t;
+
+/**
+ * @brief 音频前端内部结构
+ */
+struct audio_frontend_internal_t {
+    audio_frontend_config_t config;
+    audio_plan_t* plan;
+    uint32_t dim;
+    audio_vec_t* work;              /**< 流式计算的工作区 */
+    float* pending;                 /**< 尚未完全消费的采样 */
+    size_t pending_count;
+    size_t pending_capacity;
+    size_t skip;                    /**< 帧移大于帧长时需要丢弃的后续采样 */
+};
+
+static audio_plan_t* g_plans = NULL;
+static pthread_mutex_t g_plan_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+audio_frontend_config_t audio_frontend_default_config(audio_feature_e feature) {
+    audio_frontend_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.feature = feature;
+    config.sample_rate = 16000;
+    config.n_fft = 400;
+    config.win_length = 400;
+    config.hop_length = 160;
+    config.window = AUDIO_WINDOW_HANN;
+    config.n_mels = 80;
+    config.f_min = 0.0f;
+    config.f_max = 0.0f;
+    config.n_mfcc = 13;
+    config.log_scale = true;
+    return config;
+}
+
+// 将复数 FFT 长度分解为基 4、2、3、5 的级，无法分解时返回-1
+static int factorize(uint32_t n, uint32_t* stages) {
+    uint32_t p = 4;
+    uint32_t count = 0;
+
+    while (n > 1) {
+        while (n % p != 0) {
+            switch (p) {
+                case 4: p = 2; break;
+                case 2: p = 3; break;
+                case 3: p = 5; break;
+                default: return -1;
+            }
+        }
+        if (count == AUDIO_MAX_STAGES) return -1;
+        n /= p;
+        stages[2 * count] = p;
+        stages[2 * count + 1] = n;
+        count++;
+    }
+    return 0;
+}
+
+static bool feature_uses_fft(audio_feature_e feature) {
+    return feature != AUDIO_FEATURE_FRAMES;
+}
+
+static bool feature_uses_mel(audio_feature_e feature) {
+    return feature == AUDIO_FEATURE_MEL || feature == AUDIO_FEATURE_MFCC;
+}
+
+// 补全默认值并检查配置
+static int normalize_config(const audio_frontend_config_t* in, audio_frontend_config_t* out) {
+    *out = *in;
+    if (out->win_length == 0) out->win_length = out->n_fft;
+    if (out->f_max <= 0.0f) out->f_max = out->sample_rate / 2.0f;
+
+    if (out->n_fft == 0 || out->hop_length == 0 || out->sample_rate == 0) {
+        LOG_ERROR("Audio frontend requires non-zero n_fft, hop_length and sample_rate");
+        return -1;
+    }
+    if (out->win_length > out->n_fft) {
+        LOG_ERROR("Window length %u exceeds n_fft %u", out->win_length, out->n_fft);
+        return -1;
+    }
+    if (out->feature > AUDIO_FEATURE_MFCC || out->window > AUDIO_WINDOW_RECTANGULAR) {
+        LOG_ERROR("Unsupported audio feature or window type");
+        return -1;
+    }
+
+    if (feature_uses_fft(out->feature)) {
+        uint32_t stages[2 * AUDIO_MAX_STAGES];
+        if (out->n_fft < 4 || out->n_fft % 2 != 0 || factorize(out->n_fft / 2, stages) != 0) {
+            LOG_ERROR("n_fft %u must be even with n_fft/2 composed of factors 2, 3 and 5", out->n_fft);
+            return -1;
+        }
+    }
+
+    if (feature_uses_mel(out->feature)) {
+        if (out->n_mels == 0 || out->f_min < 0.0f || out->f_min >= out->f_max ||
+            out->f_max > out->sample_rate / 2.0f) {
+            LOG_ERROR("Invalid mel filterbank configuration");
+            return -1;
+        }
+    }
+
+    if (out->feature == AUDIO_FEATURE_MFCC && (out->n_mfcc == 0 || out->n_mfcc > out->n_mels)) {
+        LOG_ERROR("n_mfcc must be in [1, n_mels]");
+        return -1;
+    }
+
+    return 0;
+}
+
+// 比较影响预计算表的配置项
+static bool config_equal(const audio_frontend_config_t* a, const audio_frontend_config_t* b) {
+    return a->feature == b->feature && a->sample_rate == b->sample_rate && a->n_fft == b->n_fft &&
+           a->win_length == b->win_length && a->window == b->window && a->n_mels == b->n_mels &&
+           a->f_min == b->f_min && a->f_max == b->f_max && a->n_mfcc == b->n_mfcc;
+}
+
+static uint32_t feature_dim(const audio_frontend_config_t* config) {
+    switch (config->feature) {
+        case AUDIO_FEATURE_FRAMES: return config->n_fft;
+        case AUDIO_FEATURE_MAGNITUDE:
+        case AUDIO_FEATURE_POWER: return config->n_fft / 2 + 1;
+        case AUDIO_FEATURE_MEL: return config->n_mels;
+        case AUDIO_FEATURE_MFCC: return config->n_mfcc;
+        default: return 0;
+    }
+}
+
+static void build_window(const audio_frontend_config_t* config, float* window) {
+    uint32_t n = config->win_length;
+    uint32_t offset = (config->n_fft - n) / 2;
+
+    memset(window, 0, sizeof(float) * config->n_fft);
+    for (uint32_t i = 0; i < n; i++) {
+        double phase = 2.0 * M_PI * i / n;
+        double w;
+        switch (config->window) {
+            case AUDIO_WINDOW_HANN: w = 0.5 - 0.5 * cos(phase); break;
+            case AUDIO_WINDOW_HAMMING: w = 0.54 - 0.46 * cos(phase); break;
+            default: w = 1.0; break;
+        }
+        window[offset + i] = (float)w;
+    }
+}
+
+// Slaney 梅尔刻度：1kHz 以下线性，以上对数
+static double hz_to_mel(double hz) {
+    const double f_sp = 200.0 / 3.0;
+    const double min_log_hz = 1000.0;
+    const double min_log_mel = min_log_hz / f_sp;
+    const double logstep = log(6.4) / 27.0;
+
+    if (hz >= min_log_hz) return min_log_mel + log(hz / min_log_hz) / logstep;
+    return hz / f_sp;
+}
+
+static double mel_to_hz(double mel) {
+    const double f_sp = 200.0 / 3.0;
+    const double min_log_hz = 1000.0;
+    const double min_log_mel = min_log_hz / f_sp;
+    const double logstep = log(6.4) / 27.0;
+
+    if (mel >= min_log_mel) return min_log_hz * exp(logstep * (mel - min_log_mel));
+    return mel * f_sp;
+}
+
+// 构建稀疏三角滤波器组，只保存每个滤波器的非零区间
+static int build_mel_filters(audio_plan_t* plan) {
+    const audio_frontend_config_t* c = &plan->config;
+    uint32_t n_mels = c->n_mels;
+
+    double* edges = malloc(sizeof(double) * (n_mels + 2));
+    float* dense = malloc(sizeof(float) * plan->n_bins);
+    plan->mel_start = calloc(n_mels, sizeof(uint32_t));
+    plan->mel_length = calloc(n_mels, sizeof(uint32_t));
+    plan->mel_offset = calloc(n_mels, sizeof(uint32_t));
+    plan->mel_weights = malloc(sizeof(float) * (size_t)n_mels * plan->n_bins);
+    if (!edges || !dense || !plan->mel_start || !plan->mel_length || !plan->mel_offset || !plan->mel_weights) {
+        free(edges);
+        free(dense);
+        return -1;
+    }
+
+    double mel_lo = hz_to_mel(c->f_min);
+    double mel_hi = hz_to_mel(c->f_max);
+    for (uint32_t i = 0; i < n_mels + 2; i++) {
+        edges[i] = mel_to_hz(mel_lo + (mel_hi - mel_lo) * i / (n_mels + 1));
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t m = 0; m < n_mels; m++) {
+        double lower_width = edges[m + 1] - edges[m];
+        double upper_width = edges[m + 2] - edges[m + 1];
+        double enorm = 2.0 / (edges[m + 2] - edges[m]);
+        int first = -1;
+        int last = -1;
+
+        for (uint32_t k = 0; k < plan->n_bins; k++) {
+            double freq = (double)k * c->sample_rate / c->n_fft;
+            double lower = (freq - edges[m]) / lower_width;
+            double upper = (edges[m + 2] - freq) / upper_width;
+            double w = lower < upper ? lower : upper;
+            dense[k] = w > 0.0 ? (float)(w * enorm) : 0.0f;
+            if (dense[k] != 0.0f) {
+                if (first < 0) first = (int)k;
+                last = (int)k;
+            }
+        }
+
+        plan->mel_offset[m] = offset;
+        if (first >= 0) {
+            plan->mel_start[m] = (uint32_t)first;
+            plan->mel_length[m] = (uint32_t)(last - first + 1);
+            memcpy(plan->mel_weights + offset, dense + first, sizeof(float) * plan->mel_length[m]);
+            offset += plan->mel_length[m];
+        }
+    }
+
+    free(edges);
+    free(dense);
+    return 0;
+}
+
+static int build_dct(audio_plan_t* plan) {
+    uint32_t n_mels = plan->config.n_mels;
+    uint32_t n_mfcc = plan->config.n_mfcc;
+
+    plan->dct = malloc(sizeof(float) * (size_t)n_mfcc * n_mels);
+    if (!plan->dct) return -1;
+
+    for (uint32_t k = 0; k < n_mfcc; k++) {
+        double scale = k == 0 ? sqrt(1.0 / n_mels) : sqrt(2.0 / n_mels);
+        for (uint32_t m = 0; m < n_mels; m++) {
+            plan->dct[k * n_mels + m] = (float)(scale * cos(M_PI * k * (2.0 * m + 1.0) / (2.0 * n_mels)));
+        }
+    }
+    return 0;
+}
+
+static void free_plan(audio_plan_t* plan) {
+    if (!plan) return;
+    free(plan->window);
+    free(plan->twiddles);
+    free(plan->super_twiddles);
+    free(plan->mel_start);
+    free(plan->mel_length);
+    free(plan->mel_offset);
+    free(plan->mel_weights);
+    free(plan->dct);
+    free(plan);
+}
+
+static audio_plan_t* build_plan(const audio_frontend_config_t* config) {
+    audio_plan_t* plan = calloc(1, sizeof(audio_plan_t));
+    if (!plan) return NULL;
+
+    plan->config = *config;
+    plan->n_bins = config->n_fft / 2 + 1;
+    plan->ncfft = config->n_fft / 2;
+    plan->window = malloc(sizeof(float) * config->n_fft);
+    if (!plan->window) goto fail;
+    build_window(config, plan->window);
+
+    // 工作区：加窗帧（同时作为 FFT 输入）之外，频域特征还需要频谱、功率谱、梅尔谱和倒谱
+    plan->work_vectors = config->n_fft;
+
+    if (feature_uses_fft(config->feature)) {
+        uint32_t n = plan->ncfft;
+        plan->twiddles = malloc(sizeof(audio_complex_t) * n);
+        plan->super_twiddles = malloc(sizeof(audio_complex_t) * (n / 2 + 1));
+        if (!plan->twiddles || !plan->super_twiddles) goto fail;
+
+        factorize(n, plan->stages);
+        for (uint32_t i = 0; i < n; i++) {
+            double phase = -2.0 * M_PI * i / n;
+            plan->twiddles[i].r = (float)cos(phase);
+            plan->twiddles[i].i = (float)sin(phase);
+        }
+        for (uint32_t i = 0; i < n / 2 + 1; i++) {
+            double phase = -M_PI * ((double)(i + 1) / n + 0.5);
+            plan->super_twiddles[i].r = (float)cos(phase);
+            plan->super_twiddles[i].i = (float)sin(phase);
+        }
+        plan->work_vectors += config->n_fft + plan->n_bins;
+    }
+
+    if (feature_uses_mel(config->feature)) {
+        if (build_mel_filters(plan) != 0) goto fail;
+        plan->work_vectors += config->n_mels;
+    }
+
+    if (config->feature == AUDIO_FEATURE_MFCC) {
+        if (build_dct(plan) != 0) goto fail;
+        plan->work_vectors += config->n_mfcc;
+    }
+
+    return plan;
+
+fail:
+    LOG_ERROR("Failed to allocate audio frontend tables");
+    free_plan(plan);
+    return NULL;
+}
+
+static audio_plan_t* acquire_plan(const audio_frontend_config_t* config) {
+    pthread_mutex_lock(&g_plan_mutex);
+
+    audio_plan_t* plan = g_plans;
+    while (plan && !config_equal(&plan->config, config)) {
+        plan = plan->next;
+    }
+
+    if (!plan) {
+        plan = build_plan(config);
+        if (plan) {
+            plan->next = g_plans;
+            g_plans = plan;
+            LOG_DEBUG("Built audio frontend tables: n_fft=%u, n_mels=%u", config->n_fft, config->n_mels);
+        }
+    }
+    if (plan) plan->refs++;
+
+    pthread_mutex_unlock(&g_plan_mutex);
+    return plan;
+}
+
+static void release_plan(audio_plan_t* plan) {
+    pthread_mutex_lock(&g_plan_mutex);
+    if (--plan->refs == 0) {
+        audio_plan_t** link = &g_plans;
+        while (*link != plan) {
+            link = &(*link)->next;
+        }
+        *link = plan->next;
+        free_plan(plan);
+    }
+    pthread_mutex_unlock(&g_plan_mutex);
+}
+
+static audio_vec_t* alloc_work(const audio_plan_t* plan) {
+    size_t bytes = plan->work_vectors * sizeof(audio_vec_t);
+    return aligned_alloc(16, (bytes + 15) & ~(size_t)15);
+}
+
+static inline audio_cvec_t cmul(audio_cvec_t a, audio_complex_t t) {
+    audio_cvec_t r;
+    r.r = a.r * t.r - a.i * t.i;
+    r.i = a.r * t.i + a.i * t.r;
+    return r;
+}
+
+static inline audio_cvec_t cadd(audio_cvec_t a, audio_cvec_t b) {
+    audio_cvec_t r = { a.r + b.r, a.i + b.i };
+    return r;
+}
+
+static inline audio_cvec_t csub(audio_cvec_t a, audio_cvec_t b) {
+    audio_cvec_t r = { a.r - b.r, a.i - b.i };
+    return r;
+}
+
+static void butterfly2(audio_cvec_t* out, size_t fstride, const audio_complex_t* tw, uint32_t m) {
+    audio_cvec_t* out2 = out + m;
+    for (uint32_t k = 0; k < m; k++) {
+        audio_cvec_t t = cmul(out2[k], tw[k * fstride]);
+        out2[k] = csub(out[k], t);
+        out[k] = cadd(out[k], t);
+    }
+}
+
+static void butterfly3(audio_cvec_t* out, size_t fstride, const audio_complex_t* tw, uint32_t m) {
+    float epi3 = tw[fstride * m].i;
+
+    for (uint32_t k = 0; k < m; k++) {
+        audio_cvec_t s1 = cmul(out[k + m], tw[k * fstride]);
+        audio_cvec_t s2 = cmul(out[k + 2 * m], tw[2 * k * fstride]);
+        audio_cvec_t s3 = cadd(s1, s2);
+        audio_cvec_t s0 = csub(s1, s2);
+
+        audio_cvec_t a;
+        a.r = out[k].r - s3.r * 0.5f;
+        a.i = out[k].i - s3.i * 0.5f;
+        s0.r = s0.r * epi3;
+        s0.i = s0.i * epi3;
+
+        out[k] = cadd(out[k], s3);
+        out[k + 2 * m].r = a.r + s0.i;
+        out[k + 2 * m].i = a.i - s0.r;
+        out[k + m].r = a.r - s0.i;
+        out[k + m].i = a.i + s0.r;
+    }
+}
+
+static void butterfly4(audio_cvec_t* out, size_t fstride, const audio_complex_t* tw, uint32_t m) {
+    for (uint32_t k = 0; k < m; k++) {
+        audio_cvec_t s0 = cmul(out[k + m], tw[k * fstride]);
+        audio_cvec_t s1 = cmul(out[k + 2 * m], tw[2 * k * fstride]);
+        audio_cvec_t s2 = cmul(out[k + 3 * m], tw[3 * k * fstride]);
+        audio_cvec_t s5 = csub(out[k], s1);
+        audio_cvec_t s3 = cadd(s0, s2);
+        audio_cvec_t s4 = csub(s0, s2);
+        audio_cvec_t f0 = cadd(out[k], s1);
+
+        out[k + 2 * m] = csub(f0, s3);
+        out[k] = cadd(f0, s3);
+        out[k + m].r = s5.r + s4.i;
+        out[k + m].i = s5.i - s4.r;
+        out[k + 3 * m].r = s5.r - s4.i;
+        out[k + 3 * m].i = s5.i + s4.r;
+    }
+}
+
+static void butterfly5(audio_cvec_t* out, size_t fstride, const audio_complex_t* tw, uint32_t m) {
+    audio_complex_t ya = tw[fstride * m];
+    audio_complex_t yb = tw[fstride * 2 * m];
+
+    for (uint32_t u = 0; u < m; u++) {
+        audio_cvec_t s0 = out[u];
+        audio_cvec_t s1 = cmul(out[u + m], tw[u * fstride]);
+        audio_cvec_t s2 = cmul(out[u + 2 * m], tw[2 * u * fstride]);
+        audio_cvec_t s3 = cmul(out[u + 3 * m], tw[3 * u * fstride]);
+        audio_cvec_t s4 = cmul(out[u + 4 * m], tw[4 * u * fstride]);
+
+        audio_cvec_t s7 = cadd(s1, s4);
+        audio_cvec_t s10 = csub(s1, s4);
+        audio_cvec_t s8 = cadd(s2, s3);
+        audio_cvec_t s9 = csub(s2, s3);
+
+        out[u].r = s0.r + s7.r + s8.r;
+        out[u].i = s0.i + s7.i + s8.i;
+
+        audio_cvec_t s5, s6, s11, s12;
+        s5.r = s0.r + s7.r * ya.r + s8.r * yb.r;
+        s5.i = s0.i + s7.i * ya.r + s8.i * yb.r;
+        s6.r = s10.i * ya.i + s9.i * yb.i;
+        s6.i = -(s10.r * ya.i) - s9.r * yb.i;
+        out[u + m] = csub(s5, s6);
+        out[u + 4 * m] = cadd(s5, s6);
+
+        s11.r = s0.r + s7.r * yb.r + s8.r * ya.r;
+        s11.i = s0.i + s7.i * yb.r + s8.i * ya.r;
+        s12.r = s9.i * ya.i - s10.i * yb.i;
+        s12.i = s10.r * yb.i - s9.r * ya.i;
+        out[u + 2 * m] = cadd(s11, s12);
+        out[u + 3 * m] = csub(s11, s12);
+    }
+}
+
+// 混合基按时间抽取的复数 FFT（递归展开各级，叶子处按步长取输入）
+static void fft_work(const audio_plan_t* plan, audio_cvec_t* out, const audio_cvec_t* in, size_t fstride,
+                     const uint32_t* stage) {
+    uint32_t p = stage[0];
+    uint32_t m = stage[1];
+
+    if (m == 1) {
+        for (uint32_t j = 0; j < p; j++) {
+            out[j] = in[j * fstride];
+        }
+    } else {
+        for (uint32_t j = 0; j < p; j++) {
+            fft_work(plan, out + j * m, in + j * fstride, fstride * p, stage + 2);
+        }
+    }
+
+    switch (p) {
+        case 2: butterfly2(out, fstride, plan->twiddles, m); break;
+        case 3: butterfly3(out, fstride, plan->twiddles, m); break;
+        case 4: butterfly4(out, fstride, plan->twiddles, m); break;
+        case 5: butterfly5(out, fstride, plan->twiddles, m); break;
+        default: break;
+    }
+}
+
+// 实数 FFT：n_fft 点实信号视为 n_fft/2 点复信号做 FFT，再用 super_twiddles 拆分出各频点的功率
+static void rfft_power(const audio_plan_t* plan, const audio_vec_t* frames, audio_cvec_t* spectrum,
+                       audio_vec_t* power) {
+    uint32_t n = plan->ncfft;
+
+    // 相邻的两个实数采样恰好构成一个向量复数
+    fft_work(plan, spectrum, (const audio_cvec_t*)frames, 1, plan->stages);
+
+    audio_vec_t dc = spectrum[0].r + spectrum[0].i;
+    audio_vec_t nyquist = spectrum[0].r - spectrum[0].i;
+    power[0] = dc * dc;
+    power[n] = nyquist * nyquist;
+
+    for (uint32_t k = 1; k <= n / 2; k++) {
+        audio_cvec_t fpk = spectrum[k];
+        audio_cvec_t fpnk = { spectrum[n - k].r, -spectrum[n - k].i };
+        audio_cvec_t f1k = cadd(fpk, fpnk);
+        audio_cvec_t f2k = csub(fpk, fpnk);
+        audio_cvec_t tw = cmul(f2k, plan->super_twiddles[k - 1]);
+
+        audio_vec_t xr = (f1k.r + tw.r) * 0.5f;
+        audio_vec_t xi = (f1k.i + tw.i) * 0.5f;
+        power[k] = xr * xr + xi * xi;
+
+        xr = (f1k.r - tw.r) * 0.5f;
+        xi = (tw.i - f1k.i) * 0.5f;
+        power[n - k] = xr * xr + xi * xi;
+    }
+}
+
+static inline audio_vec_t vec_sqrt(audio_vec_t v) {
+#if AUDIO_LANES == 4 && defined(__SSE2__)
+    return (audio_vec_t)_mm_sqrt_ps((__m128)v);
+#elif AUDIO_LANES == 4 && defined(__ARM_NEON) && defined(__aarch64__)
+    return (audio_vec_t)vsqrtq_f32((float32x4_t)v);
+#else
+    for (int l = 0; l < AUDIO_LANES; l++) {
+        VEC_LANE(v, l) = sqrtf(VEC_LANE(v, l));
+    }
+    return v;
+#endif
+}
+
+static inline audio_vec_t vec_to_db(audio_vec_t v) {
+    for (int l = 0; l < AUDIO_LANES; l++) {
+        float x = VEC_LANE(v, l);
+        VEC_LANE(v, l) = 10.0f * log10f(x > AUDIO_LOG_FLOOR ? x : AUDIO_LOG_FLOOR);
+    }
+    return v;
+}
+
+// 计算一组帧（最多 AUDIO_LANES 帧）的特征，frames[l] 指向第 l 帧的首个采样
+static void process_group(const audio_plan_t* plan, audio_vec_t* work, const float* const* frames,
+                          uint32_t count, float* out, uint32_t dim) {
+    const audio_frontend_config_t* c = &plan->config;
+    uint32_t n_fft = c->n_fft;
+    audio_vec_t* windowed = work;
+
+    // 按帧转置为通道交错，同时乘窗
+    for (uint32_t n = 0; n < n_fft; n++) {
+        audio_vec_t v = (audio_vec_t){0};
+        for (uint32_t l = 0; l < count; l++) {
+            VEC_LANE(v, l) = frames[l][n];
+        }
+        windowed[n] = v * plan->window[n];
+    }
+
+    const audio_vec_t* feature = windowed;
+
+    if (feature_uses_fft(c->feature)) {
+        audio_cvec_t* spectrum = (audio_cvec_t*)(work + n_fft);
+        audio_vec_t* power = work + 2 * n_fft;
+        rfft_power(plan, windowed, spectrum, power);
+        feature = power;
+
+        if (c->feature == AUDIO_FEATURE_MAGNITUDE) {
+            for (uint32_t k = 0; k < plan->n_bins; k++) {
+                power[k] = vec_sqrt(power[k]);
+            }
+        } else if (c->feature == AUDIO_FEATURE_POWER && c->log_scale) {
+            for (uint32_t k = 0; k < plan->n_bins; k++) {
+                power[k] = vec_to_db(power[k]);
+            }
+        }
+
+        if (feature_uses_mel(c->feature)) {
+            audio_vec_t* mel = power + plan->n_bins;
+            for (uint32_t m = 0; m < c->n_mels; m++) {
+                const audio_vec_t* p = power + plan->mel_start[m];
+                const float* w = plan->mel_weights + plan->mel_offset[m];
+                audio_vec_t acc = (audio_vec_t){0};
+                for (uint32_t j = 0; j < plan->mel_length[m]; j++) {
+                    acc += p[j] * w[j];
+                }
+                mel[m] = acc;
+            }
+            feature = mel;
+
+            if (c->feature == AUDIO_FEATURE_MFCC || c->log_scale) {
+                for (uint32_t m = 0; m < c->n_mels; m++) {
+                    mel[m] = vec_to_db(mel[m]);
+                }
+            }
+
+            if (c->feature == AUDIO_FEATURE_MFCC) {
+                audio_vec_t* mfcc = mel + c->n_mels;
+                for (uint32_t k = 0; k < c->n_mfcc; k++) {
+                    const float* row = plan->dct + (size_t)k * c->n_mels;
+                    audio_vec_t acc = (audio_vec_t){0};
+                    for (uint32_t m = 0; m < c->n_mels; m++) {
+                        acc += mel[m] * row[m];
+                    }
+                    mfcc[k] = acc;
+                }
+                feature = mfcc;
+            }
+        }
+    }
+
+    // 转置回 [帧, 维度]
+    for (uint32_t l = 0; l < count; l++) {
+        float* row = out + (size_t)l * dim;
+        for (uint32_t d = 0; d < dim; d++) {
+            row[d] = VEC_LANE(feature[d], l);
+        }
+    }
+}
+
+// 从连续信号中计算 count 帧，第 i 帧起始于 samples + i * hop_length
+static void process_frames(const audio_plan_t* plan, audio_vec_t* work, const float* samples,
+                           uint32_t count, float* out, uint32_t dim) {
+    const float* frames[AUDIO_LANES];
+
+    for (uint32_t f = 0; f < count; f += AUDIO_LANES) {
+        uint32_t group = count - f < AUDIO_LANES ? count - f : AUDIO_LANES;
+        for (uint32_t l = 0; l < group; l++) {
+            frames[l] = samples + (size_t)(f + l) * plan->config.hop_length;
+        }
+        process_group(plan, work, frames, group, out + (size_t)f * dim, dim);
+    }
+}
+
+audio_frontend_t audio_frontend_create(const audio_frontend_config_t* config) {
+    if (!config) return NULL;
+
+    audio_frontend_config_t normalized;
+    if (normalize_config(config, &normalized) != 0) return NULL;
+
+    audio_frontend_t frontend = calloc(1, sizeof(struct audio_frontend_internal_t));
+    if (!frontend) {
+        LOG_ERROR("Failed to allocate audio frontend");
+        return NULL;
+    }
+
+    frontend->config = normalized;
+    frontend->dim = feature_dim(&normalized);
+    frontend->plan = acquire_plan(&normalized);
+    if (!frontend->plan) {
+        free(frontend);
+        return NULL;
+    }
+
+    frontend->work = alloc_work(frontend->plan);
+    if (!frontend->work) {
+        LOG_ERROR("Failed to allocate audio frontend workspace");
+        audio_frontend_destroy(frontend);
+        return NULL;
+    }
+
+    LOG_DEBUG("Created audio frontend: feature=%d, dim=%u", normalized.feature, frontend->dim);
+    return frontend;
+}
+
+void audio_frontend_destroy(audio_frontend_t frontend) {
+    if (!frontend) return;
+
+    if (frontend->plan) release_plan(frontend->plan);
+    free(frontend->work);
+    free(frontend->pending);
+    free(frontend);
+}
+
+const audio_frontend_config_t* audio_frontend_get_config(audio_frontend_t frontend) {
+    return frontend ? &frontend->config : NULL;
+}
+
+uint32_t audio_frontend_get_feature_dim(audio_frontend_t frontend) {
+    return frontend ? frontend->dim : 0;
+}
+
+uint32_t audio_frontend_get_frame_count(audio_frontend_t frontend, size_t num_samples) {
+    if (!frontend || num_samples < frontend->config.n_fft) return 0;
+    return (uint32_t)(1 + (num_samples - frontend->config.n_fft) / frontend->config.hop_length);
+}
+
+size_t audio_frontend_get_work_size(audio_frontend_t frontend) {
+    if (!frontend) return 0;
+
+    size_t bytes = frontend->plan->work_vectors * sizeof(audio_vec_t);
+    return (bytes + 15) & ~(size_t)15;
+}
+
+int audio_frontend_compute_with_work(audio_frontend_t frontend, const float* samples, size_t num_samples,
+                                     float* features, uint32_t max_frames, uint32_t* num_frames, void* work) {
+    if (!frontend || (!samples && num_samples > 0) || !num_frames) return -1;
+
+    uint32_t frames = audio_frontend_get_frame_count(frontend, num_samples);
+    if (frames > max_frames || (frames > 0 && (!features || !work))) {
+        LOG_ERROR("Feature buffer holds %u frames, %u required", max_frames, frames);
+        return -1;
+    }
+
+    *num_frames = frames;
+    if (frames == 0) return 0;
+
+    process_frames(frontend->plan, (audio_vec_t*)work, samples, frames, features, frontend->dim);
+    return 0;
+}
+
+int audio_frontend_compute(audio_frontend_t frontend, const float* samples, size_t num_samples,
+                           float* features, uint32_t max_frames, uint32_t* num_frames) {
+    if (!frontend || (!samples && num_samples > 0) || !num_frames) return -1;
+
+    uint32_t frames = audio_frontend_get_frame_count(frontend, num_samples);
+    if (frames > max_frames || (frames > 0 && !features)) {
+        LOG_ERROR("Feature buffer holds %u frames, %u required", max_frames, frames);
+        return -1;
+    }
+
+    *num_frames = frames;
+    if (frames == 0) return 0;
+
+    // 独立的工作区使一次性计算不依赖流式状态，可以并发调用
+    audio_vec_t* work = alloc_work(frontend->plan);
+    if (!work) {
+        LOG_ERROR("Failed to allocate audio frontend workspace");
+        return -1;
+    }
+
+    int ret = audio_frontend_compute_with_work(frontend, samples, num_samples, features, max_frames, num_frames,
+                                               work);
+    free(work);
+    return ret;
+}
+
+int audio_frontend_push(audio_frontend_t frontend, const float* samples, size_t num_samples,
+                        float* features, uint32_t max_frames, uint32_t* num_frames) {
+    if (!frontend || (!samples && num_samples > 0) || !num_frames) return -1;
+    if (max_frames > 0 && !features) return -1;
+
+    // 上一次帧移越过了缓冲区末尾，先丢弃对应的新采样
+    if (frontend->skip > 0) {
+        size_t drop = frontend->skip < num_samples ? frontend->skip : num_samples;
+        samples += drop;
+        num_samples -= drop;
+        frontend->skip -= drop;
+    }
+
+    size_t needed = frontend->pending_count + num_samples;
+    if (needed > frontend->pending_capacity) {
+        float* grown = realloc(frontend->pending, sizeof(float) * needed);
+        if (!grown) {
+            LOG_ERROR("Failed to grow audio stream buffer");
+            return -1;
+        }
+        frontend->pending = grown;
+        frontend->pending_capacity = needed;
+    }
+    if (num_samples > 0) {
+        memcpy(frontend->pending + frontend->pending_count, samples, sizeof(float) * num_samples);
+        frontend->pending_count += num_samples;
+    }
+
+    uint32_t frames = audio_frontend_get_frame_count(frontend, frontend->pending_count);
+    if (frames > max_frames) frames = max_frames;
+
+    process_frames(frontend->plan, frontend->work, frontend->pending, frames, features, frontend->dim);
+
+    // 只保留下一帧起点之后的采样，重叠部分留给后续帧
+    size_t consumed = (size_t)frames * frontend->config.hop_length;
+    if (consumed >= frontend->pending_count) {
+        frontend->skip += consumed - frontend->pending_count;
+        frontend->pending_count = 0;
+    } else if (consumed > 0) {
+        frontend->pending_count -= consumed;
+        memmove(frontend->pending, frontend->pending + consumed, sizeof(float) * frontend->pending_count);
+    }
+
+    *num_frames = frames;
+    return 0;
+}
+
+void audio_frontend_reset(audio_frontend_t frontend) {
+    if (!frontend) return;
+    frontend->pending_count = 0;
+    frontend->skip = 0;
+}
+
+// 重采样滤波器每侧的过零点数，以及 Kaiser 窗参数（阻带约 -80dB）
+#define RESAMPLER_ZERO_CROSSINGS 16
+#define RESAMPLER_KAISER_BETA 8.0
+// 截止频率相对奈奎斯特频率的比例，为过渡带留出余量
+#define RESAMPLER_ROLLOFF 0.95
+
+/**
+ * @brief 重采样器内部结构
+ */
+struct audio_resampler_internal_t {
+    uint32_t in_rate;
+    uint32_t out_rate;
+    uint32_t up;                    /**< 约分后的插值因子 L */
+    uint32_t down;                  /**< 约分后的抽取因子 M */
+    uint32_t half;                  /**< 每侧抽头数 K，每相共 2K 个抽头 */
+    uint32_t stride;                /**< 每相抽头数补齐到向量宽度 */
+    audio_vec_t* bank;              /**< [L, stride] 多相滤波器组 */
+    float* buffer;                  /**< 流式输入缓冲 */
+    size_t buffer_count;
+    size_t buffer_capacity;
+    int64_t buffer_base;            /**< buffer[0] 对应的输入采样序号 */
+    uint64_t next_output;           /**< 下一个输出采样序号 */
+    uint64_t input_total;           /**< 已输入的采样总数 */
+};
+
+static uint32_t gcd_u32(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// 第一类零阶修正贝塞尔函数（级数展开）
+static double bessel_i0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+// 构建多相滤波器组：第 p 相的第 j 个抽头作用于输入 i-K+1+j，输出时刻为 i+p/L
+static int build_resampler_bank(audio_resampler_t r) {
+    double cutoff = (r->up < r->down ? (double)r->up / r->down : 1.0) * RESAMPLER_ROLLOFF;
+    r->half = (uint32_t)ceil(RESAMPLER_ZERO_CROSSINGS / cutoff);
+    uint32_t taps = 2 * r->half;
+    uint32_t lanes = sizeof(audio_vec_t) / sizeof(float);
+    r->stride = (taps + lanes - 1) / lanes * lanes;
+
+    size_t bytes = (size_t)r->up * r->stride * sizeof(float);
+    r->bank = aligned_alloc(16, (bytes + 15) & ~(size_t)15);
+    if (!r->bank) return -1;
+
+    float* bank = (float*)r->bank;
+    double norm = bessel_i0(RESAMPLER_KAISER_BETA);
+    for (uint32_t p = 0; p < r->up; p++) {
+        float* h = bank + (size_t)p * r->stride;
+        double sum = 0.0;
+        for (uint32_t j = 0; j < r->stride; j++) {
+            if (j >= taps) {
+                h[j] = 0.0f;
+                continue;
+            }
+            double d = (double)j - (r->half - 1) - (double)p / r->up;
+            double x = d / r->half;
+            double window = fabs(x) < 1.0 ? bessel_i0(RESAMPLER_KAISER_BETA * sqrt(1.0 - x * x)) / norm : 0.0;
+            double arg = M_PI * cutoff * d;
+            double sinc = fabs(arg) < 1e-12 ? 1.0 : sin(arg) / arg;
+            double value = cutoff * sinc * window;
+            h[j] = (float)value;
+            sum += value;
+        }
+        // 每相单独归一化，保证直流增益为1
+        for (uint32_t j = 0; j < taps; j++) {
+            h[j] = (float)(h[j] / sum);
+        }
+    }
+    return 0;
+}
+
+// 向量化点积：x 不要求对齐，滤波器按向量对齐
+static inline float resample_dot(const float* x, const audio_vec_t* h, uint32_t vectors) {
+    audio_vec_t acc0 = (audio_vec_t){0};
+    audio_vec_t acc1 = (audio_vec_t){0};
+    uint32_t v = 0;
+
+    // 两路累加隐藏乘加延迟
+    for (; v + 2 <= vectors; v += 2) {
+        audio_vec_t x0, x1;
+        memcpy(&x0, x + v * sizeof(audio_vec_t) / sizeof(float), sizeof(audio_vec_t));
+        memcpy(&x1, x + (v + 1) * sizeof(audio_vec_t) / sizeof(float), sizeof(audio_vec_t));
+        acc0 += x0 * h[v];
+        acc1 += x1 * h[v + 1];
+    }
+    for (; v < vectors; v++) {
+        audio_vec_t x0;
+        memcpy(&x0, x + v * sizeof(audio_vec_t) / sizeof(float), sizeof(audio_vec_t));
+        acc0 += x0 * h[v];
+    }
+
+    acc0 += acc1;
+    float sum = 0.0f;
+    for (int l = 0; l < AUDIO_LANES; l++) {
+        sum += VEC_LANE(acc0, l);
+    }
+    return sum;
+}
+
+// 靠近信号两端的输出：越界输入按零处理
+static float resample_edge(audio_resampler_t r, const float* input, size_t num_samples, int64_t first,
+                           uint32_t phase) {
+    const float* h = (const float*)r->bank + (size_t)phase * r->stride;
+    float sum = 0.0f;
+    for (uint32_t j = 0; j < 2 * r->half; j++) {
+        int64_t index = first + j;
+        if (index >= 0 && index < (int64_t)num_samples) {
+            sum += input[index] * h[j];
+        }
+    }
+    return sum;
+}
+
+audio_resampler_t audio_resampler_create(uint32_t in_rate, uint32_t out_rate) {
+    if (in_rate == 0 || out_rate == 0) {
+        LOG_ERROR("Resampler requires non-zero sample rates");
+        return NULL;
+    }
+
+    audio_resampler_t r = calloc(1, sizeof(struct audio_resampler_internal_t));
+    if (!r) {
+        LOG_ERROR("Failed to allocate resampler");
+        return NULL;
+    }
+
+    uint32_t g = gcd_u32(in_rate, out_rate);
+    r->in_rate = in_rate;
+    r->out_rate = out_rate;
+    r->up = out_rate / g;
+    r->down = in_rate / g;
+
+    if (build_resampler_bank(r) != 0) {
+        LOG_ERROR("Failed to allocate resampler filter bank");
+        free(r);
+        return NULL;
+    }
+
+    audio_resampler_reset(r);
+    LOG_DEBUG("Created resampler %u -> %u Hz: L=%u, M=%u, taps=%u", in_rate, out_rate, r->up, r->down,
+              2 * r->half);
+    return r;
+}
+
+void audio_resampler_destroy(audio_resampler_t resampler) {
+    if (!resampler) return;
+    free(resampler->bank);
+    free(resampler->buffer);
+    free(resampler);
+}
+
+size_t audio_resampler_get_output_length(audio_resampler_t resampler, size_t num_samples) {
+    if (!resampler) return 0;
+    return (size_t)(((uint64_t)num_samples * resampler->up + resampler->down - 1) / resampler->down);
+}
+
+int audio_resampler_convert(audio_resampler_t resampler, const float* input, size_t num_samples,
+                            float* output, size_t max_output, size_t* output_count) {
+    if (!resampler || (!input && num_samples > 0) || !output_count) return -1;
+
+    size_t count = audio_resampler_get_output_length(resampler, num_samples);
+    if (count > max_output || (count > 0 && !output)) {
+        LOG_ERROR("Resampler output holds %zu samples, %zu required", max_output, count);
+        return -1;
+    }
+
+    audio_resampler_t r = resampler;
+    uint32_t vectors = r->stride / (sizeof(audio_vec_t) / sizeof(float));
+    for (size_t n = 0; n < count; n++) {
+        uint64_t pos = (uint64_t)n * r->down;
+        int64_t first = (int64_t)(pos / r->up) - (r->half - 1);
+        uint32_t phase = (uint32_t)(pos % r->up);
+
+        // 补齐的抽头系数为0，但读取范围仍需落在输入之内
+        if (first >= 0 && first + (int64_t)r->stride <= (int64_t)num_samples) {
+            output[n] = resample_dot(input + first, r->bank + (size_t)phase * vectors, vectors);
+        } else {
+            output[n] = resample_edge(r, input, num_samples, first, phase);
+        }
+    }
+
+    *output_count = count;
+    return 0;
+}
+
+// 向流式缓冲追加采样（input 为NULL时追加零）
+static int resampler_append(audio_resampler_t r, const float* input, size_t num_samples) {
+    size_t needed = r->buffer_count + num_samples;
+    if (needed > r->buffer_capacity) {
+        float* grown = realloc(r->buffer, sizeof(float) * needed);
+        if (!grown) {
+            LOG_ERROR("Failed to grow resampler buffer");
+            return -1;
+        }
+        r->buffer = grown;
+        r->buffer_capacity = needed;
+    }
+
+    if (input) {
+        memcpy(r->buffer + r->buffer_count, input, sizeof(float) * num_samples);
+    } else {
+        memset(r->buffer + r->buffer_count, 0, sizeof(float) * num_samples);
+    }
+    r->buffer_count += num_samples;
+    return 0;
+}
+
+// 输出缓冲中已具备完整窗口的采样；limit 为输出时刻必须小于的输入序号（流结束时使用）
+static size_t resampler_drain(audio_resampler_t r, float* output, size_t max_output, uint64_t limit) {
+    uint32_t vectors = r->stride / (sizeof(audio_vec_t) / sizeof(float));
+    size_t produced = 0;
+
+    while (produced < max_output) {
+        uint64_t pos = r->next_output * r->down;
+        uint64_t center = pos / r->up;
+        if (center >= limit) break;
+
+        int64_t first = (int64_t)center - (r->half - 1);
+        int64_t offset = first - r->buffer_base;
+        if (offset + (int64_t)r->stride > (int64_t)r->buffer_count) break;
+
+        uint32_t phase = (uint32_t)(pos % r->up);
+        output[produced++] = resample_dot(r->buffer + offset, r->bank + (size_t)phase * vectors, vectors);
+        r->next_output++;
+    }
+
+    // 丢弃下一个输出不再需要的采样
+    int64_t keep = (int64_t)(r->next_output * r->down / r->up) - (r->half - 1) - r->buffer_base;
+    if (keep > 0) {
+        size_t drop = (size_t)keep < r->buffer_count ? (size_t)keep : r->buffer_count;
+        r->buffer_count -= drop;
+        r->buffer_base += (int64_t)drop;
+        memmove(r->buffer, r->buffer + drop, sizeof(float) * r->buffer_count);
+    }
+
+    return produced;
+}
+
+int audio_resampler_process(audio_resampler_t resampler, const float* input, size_t num_samples,
+                            float* output, size_t max_output, size_t* output_count) {
+    if (!resampler || (!input && num_samples > 0) || !output_count) return -1;
+    if (max_output > 0 && !output) return -1;
+
+    if (num_samples > 0 && resampler_append(resampler, input, num_samples) != 0) return -1;
+    resampler->input_total += num_samples;
+
+    *output_count = resampler_drain(resampler, output, max_output, UINT64_MAX);
+    return 0;
+}
+
+int audio_resampler_flush(audio_resampler_t resampler, float* output, size_t max_output,
+                          size_t* output_count) {
+    if (!resampler || !output_count) return -1;
+    if (max_output > 0 && !output) return -1;
+
+    // 补零使末尾的输出具备完整窗口（重复调用时多补的零不影响结果）
+    if (resampler_append(resampler, NULL, resampler->stride) != 0) return -1;
+
+    *output_count = resampler_drain(resampler, output, max_output, resampler->input_total);
+    return 0;
+}
+
+void audio_resampler_reset(audio_resampler_t resampler) {
+    if (!resampler) return;
+
+    // 信号起点之前按零处理：缓冲预置 K-1 个零
+    resampler->buffer_count = 0;
+    resampler->buffer_base = -(int64_t)(resampler->half - 1);
+    resampler->next_output = 0;
+    resampler->input_total = 0;
+    resampler_append(resampler, NULL, resampler->half - 1);
+}
@@ -0,0 +1,266 @@
+#ifndef MODYN_UTILS_AUDIO_UTILS_H
+#define MODYN_UTILS_AUDIO_UTILS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 分析窗类型
+ */
+typedef enum {
+    AUDIO_WINDOW_HANN = 0,          /**< 周期 Hann 窗 */
+    AUDIO_WINDOW_HAMMING,           /**< 周期 Hamming 窗 */
+    AUDIO_WINDOW_RECTANGULAR        /**< 矩形窗 */
+} audio_window_e;
+
+/**
+ * @brief 前端输出的特征类型
+ */
+typedef enum {
+    AUDIO_FEATURE_FRAMES = 0,       /**< 加窗后的帧（维度 n_fft） */
+    AUDIO_FEATURE_MAGNITUDE,        /**< STFT 幅度谱（维度 n_fft/2+1） */
+    AUDIO_FEATURE_POWER,            /**< STFT 功率谱（维度 n_fft/2+1） */
+    AUDIO_FEATURE_MEL,              /**< 梅尔功率谱（维度 n_mels） */
+    AUDIO_FEATURE_MFCC              /**< 梅尔倒谱系数（维度 n_mfcc） */
+} audio_feature_e;
+
+/**
+ * @brief 音频前端配置
+ *
+ * 帧长为 n_fft，不做中心填充：长度为 L 的信号产生 1 + (L - n_fft) / hop_length 帧。
+ * 窗长小于 n_fft 时窗函数居中补零。梅尔滤波器组使用 Slaney 刻度与面积归一化，
+ * MFCC 为对数梅尔谱（dB）的正交 DCT-II。
+ */
+typedef struct {
+    audio_feature_e feature;        /**< 特征类型 */
+    uint32_t sample_rate;           /**< 采样率 */
+    uint32_t n_fft;                 /**< FFT点数（频域特征要求为偶数且 n_fft/2 只含 2、3、5 因子） */
+    uint32_t win_length;            /**< 窗长（0表示等于 n_fft） */
+    uint32_t hop_length;            /**< 帧移 */
+    audio_window_e window;          /**< 窗类型 */
+    uint32_t n_mels;                /**< 梅尔频带数 */
+    float f_min;                    /**< 梅尔滤波器最低频率 */
+    float f_max;                    /**< 梅尔滤波器最高频率（0表示奈奎斯特频率） */
+    uint32_t n_mfcc;                /**< MFCC系数数量 */
+    bool log_scale;                 /**< 功率谱和梅尔谱是否转换为 dB */
+} audio_frontend_config_t;
+
+/**
+ * @brief 音频前端句柄
+ */
+typedef struct audio_frontend_internal_t* audio_frontend_t;
+
+/**
+ * @brief 获取默认配置（16kHz，25ms 窗，10ms 帧移，80 个梅尔频带）
+ *
+ * @param feature 特征类型
+ * @return audio_frontend_config_t 默认配置
+ */
+audio_frontend_config_t audio_frontend_default_config(audio_feature_e feature);
+
+/**
+ * @brief 创建音频前端
+ *
+ * 旋转因子、窗函数、梅尔滤波器组和 DCT 矩阵按配置只计算一次，
+ * 相同配置的前端共享同一组表。
+ *
+ * @param config 配置
+ * @return audio_frontend_t 前端实例，配置无效时返回NULL
+ */
+audio_frontend_t audio_frontend_create(const audio_frontend_config_t* config);
+
+/**
+ * @brief 销毁音频前端
+ *
+ * @param frontend 前端实例
+ */
+void audio_frontend_destroy(audio_frontend_t frontend);
+
+/**
+ * @brief 获取配置
+ *
+ * @param frontend 前端实例
+ * @return const audio_frontend_config_t* 配置（空句柄返回NULL）
+ */
+const audio_frontend_config_t* audio_frontend_get_config(audio_frontend_t frontend);
+
+/**
+ * @brief 获取每帧特征维度
+ *
+ * @param frontend 前端实例
+ * @return uint32_t 特征维度
+ */
+uint32_t audio_frontend_get_feature_dim(audio_frontend_t frontend);
+
+/**
+ * @brief 计算给定长度信号的帧数
+ *
+ * @param frontend 前端实例
+ * @param num_samples 采样点数
+ * @return uint32_t 帧数（信号短于一帧时为0）
+ */
+uint32_t audio_frontend_get_frame_count(audio_frontend_t frontend, size_t num_samples);
+
+/**
+ * @brief 一次性计算整段信号的特征
+ *
+ * 不修改流式状态，可在多个线程中对同一前端并发调用。
+ *
+ * @param frontend 前端实例
+ * @param samples 单声道采样
+ * @param num_samples 采样点数
+ * @param features 输出特征，按 [帧, 维度] 行主序排列
+ * @param max_frames 输出缓冲区可容纳的帧数
+ * @param num_frames 输出实际帧数
+ * @return int 0成功，其他失败
+ */
+int audio_frontend_compute(audio_frontend_t frontend, const float* samples, size_t num_samples,
+                           float* features, uint32_t max_frames, uint32_t* num_frames);
+
+/**
+ * @brief 获取一次性计算所需工作区的字节数
+ *
+ * @param frontend 前端实例
+ * @return size_t 工作区字节数（失败返回0）
+ */
+size_t audio_frontend_get_work_size(audio_frontend_t frontend);
+
+/**
+ * @brief 使用调用方提供的工作区一次性计算整段信号的特征
+ *
+ * 与 audio_frontend_compute 相同，但不分配内存；并发调用时每个线程使用各自的工作区。
+ *
+ * @param frontend 前端实例
+ * @param samples 单声道采样
+ * @param num_samples 采样点数
+ * @param features 输出特征，按 [帧, 维度] 行主序排列
+ * @param max_frames 输出缓冲区可容纳的帧数
+ * @param num_frames 输出实际帧数
+ * @param work 工作区（不少于 audio_frontend_get_work_size 字节，16 字节对齐）
+ * @return int 0成功，其他失败
+ */
+int audio_frontend_compute_with_work(audio_frontend_t frontend, const float* samples, size_t num_samples,
+                                     float* features, uint32_t max_frames, uint32_t* num_frames, void* work);
+
+/**
+ * @brief 流式输入一段采样并输出新完成的帧
+ *
+ * 跨块的重叠采样保存在前端内部，逐块输入的结果与整段计算一致。
+ * 输出缓冲区不足时多余的帧保留到下一次调用（可传入 0 个采样取出）。
+ *
+ * @param frontend 前端实例
+ * @param samples 新到达的采样（num_samples 为0时可为NULL）
+ * @param num_samples 采样点数
+ * @param features 输出特征，按 [帧, 维度] 行主序排列
+ * @param max_frames 输出缓冲区可容纳的帧数
+ * @param num_frames 输出实际帧数
+ * @return int 0成功，其他失败
+ */
+int audio_frontend_push(audio_frontend_t frontend, const float* samples, size_t num_samples,
+                        float* features, uint32_t max_frames, uint32_t* num_frames);
+
+/**
+ * @brief 清空流式状态
+ *
+ * @param frontend 前端实例
+ */
+void audio_frontend_reset(audio_frontend_t frontend);
+
+/**
+ * @brief 重采样器句柄
+ */
+typedef struct audio_resampler_internal_t* audio_resampler_t;
+
+/**
+ * @brief 创建多相 FIR 重采样器
+ *
+ * 采样率之比约分为 L/M 后预计算 L 组 Kaiser 窗 sinc 滤波器，
+ * 输出第 n 个采样对应输入时刻 n*M/L，信号两端按零延拓。
+ *
+ * @param in_rate 输入采样率
+ * @param out_rate 输出采样率
+ * @return audio_resampler_t 重采样器实例
+ */
+audio_resampler_t audio_resampler_create(uint32_t in_rate, uint32_t out_rate);
+
+/**
+ * @brief 销毁重采样器
+ *
+ * @param resampler 重采样器实例
+ */
+void audio_resampler_destroy(audio_resampler_t resampler);
+
+/**
+ * @brief 计算整段信号重采样后的长度（ceil(num_samples * L / M)）
+ *
+ * @param resampler 重采样器实例
+ * @param num_samples 输入采样点数
+ * @return size_t 输出采样点数
+ */
+size_t audio_resampler_get_output_length(audio_resampler_t resampler, size_t num_samples);
+
+/**
+ * @brief 一次性重采样整段信号
+ *
+ * 不修改流式状态，可在多个线程中对同一重采样器并发调用。
+ *
+ * @param resampler 重采样器实例
+ * @param input 输入采样
+ * @param num_samples 输入采样点数
+ * @param output 输出缓冲区
+ * @param max_output 输出缓冲区容量（不小于 audio_resampler_get_output_length）
+ * @param output_count 输出实际采样点数
+ * @return int 0成功，其他失败
+ */
+int audio_resampler_convert(audio_resampler_t resampler, const float* input, size_t num_samples,
+                            float* output, size_t max_output, size_t* output_count);
+
+/**
+ * @brief 流式输入一段采样并输出已具备完整滤波窗口的采样
+ *
+ * 滤波器需要约半个窗长的后续输入，因此输出相对输入有固定延迟；
+ * 输出缓冲区不足时剩余采样保留到下一次调用。
+ *
+ * @param resampler 重采样器实例
+ * @param input 新到达的采样（num_samples 为0时可为NULL）
+ * @param num_samples 采样点数
+ * @param output 输出缓冲区
+ * @param max_output 输出缓冲区容量
+ * @param output_count 输出实际采样点数
+ * @return int 0成功，其他失败
+ */
+int audio_resampler_process(audio_resampler_t resampler, const float* input, size_t num_samples,
+                            float* output, size_t max_output, size_t* output_count);
+
+/**
+ * @brief 结束流式输入，输出剩余采样
+ *
+ * 流结束后按零延拓补齐滤波窗口，输出总数与整段重采样一致。
+ * 之后需调用 audio_resampler_reset 才能开始新的流。
+ *
+ * @param resampler 重采样器实例
+ * @param output 输出缓冲区
+ * @param max_output 输出缓冲区容量
+ * @param output_count 输出实际采样点数
+ * @return int 0成功，其他失败
+ */
+int audio_resampler_flush(audio_resampler_t resampler, float* output, size_t max_output,
+                          size_t* output_count);
+
+/**
+ * @brief 清空流式状态
+ *
+ * @param resampler 重采样器实例
+ */
+void audio_resampler_reset(audio_resampler_t resampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_AUDIO_UTILS_H
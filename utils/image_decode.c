@@ -0,0 +1,491 @@
+#include "utils/image_decode_internal.h"
+#include "utils/logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 图像解码入口：格式识别、BMP 解码、通道转换和文件读取
+ */
+
+// 文件头探测时先读取的字节数，JPEG 的 SOF 更靠后时再读取整个文件
+#define IMAGE_PROBE_BYTES 65536
+
+image_format_e image_detect_format(const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    if (!p) return IMAGE_FORMAT_UNKNOWN;
+    if (size >= 3 && p[0] == 0xFF && p[1] == 0xD8 && p[2] == 0xFF) return IMAGE_FORMAT_JPEG;
+    if (size >= 8 && memcmp(p, "\x89PNG\r\n\x1a\n", 8) == 0) return IMAGE_FORMAT_PNG;
+    if (size >= 2 && p[0] == 'B' && p[1] == 'M') return IMAGE_FORMAT_BMP;
+    return IMAGE_FORMAT_UNKNOWN;
+}
+
+// 像素总数超过上限的图像在分配任何缓冲区之前拒绝，避免很小的文件声明巨大的尺寸
+static int check_image_size(const image_header_t* header) {
+    uint64_t pixels = (uint64_t)header->width * header->height;
+    if (pixels > IMAGE_DECODE_MAX_PIXELS) {
+        LOG_ERROR("图像尺寸过大: %ux%u（上限 %llu 像素）", header->width, header->height,
+                  (unsigned long long)IMAGE_DECODE_MAX_PIXELS);
+        return -1;
+    }
+    return 0;
+}
+
+int image_probe_memory(const void* data, size_t size, image_header_t* header) {
+    if (!data || !header) return -1;
+    int ret;
+    switch (image_detect_format(data, size)) {
+        case IMAGE_FORMAT_JPEG:
+            ret = image_jpeg_probe((const uint8_t*)data, size, header);
+            break;
+        case IMAGE_FORMAT_PNG:
+            ret = image_png_probe((const uint8_t*)data, size, header);
+            break;
+        case IMAGE_FORMAT_BMP:
+            ret = image_bmp_probe((const uint8_t*)data, size, header);
+            break;
+        default:
+            return -1;
+    }
+    if (ret != 0) return -1;
+    return check_image_size(header);
+}
+
+void image_decode_output_size(const image_header_t* header, const image_decode_options_t* options,
+                              uint32_t* width, uint32_t* height) {
+    uint32_t scale = 1;
+    if (header->format == IMAGE_FORMAT_JPEG && options) {
+        scale = image_jpeg_select_scale(header->width, header->height, options->min_width, options->min_height);
+    }
+    *width = (header->width + scale - 1) / scale;
+    *height = (header->height + scale - 1) / scale;
+}
+
+// ==================== 通道转换与张量输出 ====================
+
+/**
+ * @brief 把解码器的原始通道转换为请求的通道，逐行写入张量
+ */
+typedef struct {
+    Tensor* output;
+    uint32_t channels;              /**< 输出通道数（0 表示原始通道） */
+    uint32_t src_channels;
+    uint32_t width;
+    uint32_t height;
+    uint8_t* data;
+} tensor_sink_t;
+
+void image_convert_channels(const uint8_t* src, uint32_t src_channels, uint8_t* dst, uint32_t dst_channels,
+                            uint32_t width) {
+    if (src_channels == dst_channels) {
+        memcpy(dst, src, (size_t)width * dst_channels);
+        return;
+    }
+    for (uint32_t x = 0; x < width; x++) {
+        const uint8_t* s = src + (size_t)x * src_channels;
+        uint8_t* d = dst + (size_t)x * dst_channels;
+        uint8_t gray = s[0];
+        uint8_t alpha = 255;
+        if (src_channels >= 3) gray = (uint8_t)((77 * s[0] + 150 * s[1] + 29 * s[2] + 128) >> 8);
+        if (src_channels == 2) alpha = s[1];
+        if (src_channels == 4) alpha = s[3];
+
+        if (dst_channels == 1) {
+            d[0] = gray;
+        } else if (src_channels >= 3) {
+            d[0] = s[0];
+            d[1] = s[1];
+            d[2] = s[2];
+            if (dst_channels == 4) d[3] = alpha;
+        } else {
+            d[0] = d[1] = d[2] = s[0];
+            if (dst_channels == 4) d[3] = alpha;
+        }
+    }
+}
+
+static int tensor_sink_begin(void* context, uint32_t width, uint32_t height, uint32_t channels) {
+    tensor_sink_t* sink = (tensor_sink_t*)context;
+    Tensor* output = sink->output;
+    if (sink->channels == 0) sink->channels = channels;
+    sink->src_channels = channels;
+    sink->width = width;
+    sink->height = height;
+
+    size_t size = (size_t)width * height * sink->channels;
+    if (output->data) {
+        if (output->size < size) {
+            LOG_ERROR("输出缓冲区不足（需要 %zu 字节，实际 %zu 字节）", size, output->size);
+            return -1;
+        }
+    } else {
+        output->data = malloc(size);
+        if (!output->data) {
+            LOG_ERROR("图像缓冲区分配失败（%zu 字节）", size);
+            return -1;
+        }
+        output->owns_data = true;
+        output->memory_type = TENSOR_MEMORY_CPU;
+    }
+    output->size = size;
+    output->dtype = TENSOR_TYPE_UINT8;
+    output->format = TENSOR_FORMAT_NHWC;
+    output->shape.ndim = 4;
+    output->shape.dims[0] = 1;
+    output->shape.dims[1] = height;
+    output->shape.dims[2] = width;
+    output->shape.dims[3] = sink->channels;
+    sink->data = (uint8_t*)output->data;
+    return 0;
+}
+
+static int tensor_sink_row(void* context, uint32_t y, const uint8_t* row) {
+    tensor_sink_t* sink = (tensor_sink_t*)context;
+    if (y >= sink->height) return -1;
+    uint8_t* dst = sink->data + (size_t)y * sink->width * sink->channels;
+    image_convert_channels(row, sink->src_channels, dst, sink->channels, sink->width);
+    return 0;
+}
+
+int image_decode_to_sink(const uint8_t* data, size_t size, uint32_t min_width, uint32_t min_height,
+                         const image_sink_t* sink) {
+    image_format_e format = image_detect_format(data, size);
+    if (format == IMAGE_FORMAT_UNKNOWN) {
+        LOG_ERROR("无法识别的图像格式");
+        return -1;
+    }
+
+    // 解码器按文件头声明的尺寸分配缓冲区，先检查尺寸
+    image_header_t header;
+    if (image_probe_memory(data, size, &header) != 0) {
+        return -1;
+    }
+
+    switch (format) {
+        case IMAGE_FORMAT_JPEG: {
+            uint32_t scale = 1;
+            if (min_width || min_height) {
+                scale = image_jpeg_select_scale(header.width, header.height, min_width, min_height);
+            }
+            return image_jpeg_decode(data, size, scale, sink);
+        }
+        case IMAGE_FORMAT_PNG:
+            return image_png_decode(data, size, sink);
+        case IMAGE_FORMAT_BMP:
+            return image_bmp_decode(data, size, sink);
+        default:
+            LOG_ERROR("无法识别的图像格式");
+            return -1;
+    }
+}
+
+int image_decode_memory(const void* data, size_t size, const image_decode_options_t* options, Tensor* output) {
+    if (!data || !output) return -1;
+    uint32_t channels = options ? options->channels : 0;
+    if (channels != 0 && channels != 1 && channels != 3 && channels != 4) {
+        LOG_ERROR("不支持的输出通道数: %u", channels);
+        return -1;
+    }
+
+    bool allocated = output->data == NULL;
+    tensor_sink_t state = {
+        .output = output,
+        .channels = channels
+    };
+    image_sink_t sink = {
+        .begin = tensor_sink_begin,
+        .row = tensor_sink_row,
+        .context = &state
+    };
+
+    int ret = image_decode_to_sink((const uint8_t*)data, size, options ? options->min_width : 0,
+                                   options ? options->min_height : 0, &sink);
+
+    if (ret != 0 && allocated && output->data) {
+        free(output->data);
+        output->data = NULL;
+        output->size = 0;
+        output->owns_data = false;
+    }
+    return ret;
+}
+
+// ==================== 文件读取 ====================
+
+uint8_t* image_read_file(const char* path, size_t limit, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LOG_ERROR("无法打开图像文件: %s", path);
+        return NULL;
+    }
+
+    uint8_t* data = NULL;
+    size_t length = 0;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long end = ftell(file);
+        if (end >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+            length = (size_t)end;
+            if (limit && length > limit) length = limit;
+            data = malloc(length ? length : 1);
+            if (data && fread(data, 1, length, file) != length) {
+                free(data);
+                data = NULL;
+            }
+        }
+    }
+    fclose(file);
+
+    if (!data) {
+        LOG_ERROR("读取图像文件失败: %s", path);
+        return NULL;
+    }
+    *size = length;
+    return data;
+}
+
+int image_probe_file(const char* path, image_header_t* header) {
+    if (!path || !header) return -1;
+    size_t size = 0;
+    uint8_t* data = image_read_file(path, IMAGE_PROBE_BYTES, &size);
+    if (!data) return -1;
+
+    int ret;
+    switch (image_detect_format(data, size)) {
+        case IMAGE_FORMAT_JPEG:
+            ret = image_jpeg_probe(data, size, header);
+            if (ret == IMAGE_PROBE_NEED_MORE && size == IMAGE_PROBE_BYTES) {
+                free(data);
+                data = image_read_file(path, 0, &size);
+                ret = data ? image_jpeg_probe(data, size, header) : -1;
+            }
+            break;
+        case IMAGE_FORMAT_PNG:
+            ret = image_png_probe(data, size, header);
+            break;
+        case IMAGE_FORMAT_BMP:
+            ret = image_bmp_probe(data, size, header);
+            break;
+        default:
+            ret = -1;
+            break;
+    }
+    free(data);
+
+    if (ret != 0) {
+        LOG_ERROR("无法解析图像文件头: %s", path);
+        return -1;
+    }
+    return check_image_size(header);
+}
+
+int image_decode_file(const char* path, const image_decode_options_t* options, Tensor* output) {
+    if (!path || !output) return -1;
+    size_t size = 0;
+    uint8_t* data = image_read_file(path, 0, &size);
+    if (!data) return -1;
+
+    int ret = image_decode_memory(data, size, options, output);
+    free(data);
+    if (ret != 0) LOG_ERROR("图像解码失败: %s", path);
+    return ret;
+}
+
+// ==================== BMP ====================
+
+/**
+ * @brief BMP 头信息
+ */
+typedef struct {
+    uint32_t offset;                /**< 像素数据偏移 */
+    uint32_t header_size;
+    int32_t width;
+    int32_t height;                 /**< 负值表示自上而下存储 */
+    uint32_t bpp;
+    uint32_t compression;
+    uint32_t palette_size;
+    uint32_t masks[4];              /**< R/G/B/A 位掩码 */
+} bmp_info_t;
+
+#define BMP_RGB 0
+#define BMP_BITFIELDS 3
+#define BMP_ALPHA_BITFIELDS 6
+
+static int bmp_parse(const uint8_t* data, size_t size, bmp_info_t* info) {
+    if (size < 26) return -1;
+    memset(info, 0, sizeof(*info));
+    info->offset = image_read_le32(data + 10);
+    info->header_size = image_read_le32(data + 14);
+
+    if (info->header_size == 12) {
+        // OS/2 BITMAPCOREHEADER
+        info->width = (int32_t)image_read_le16(data + 18);
+        info->height = (int32_t)image_read_le16(data + 20);
+        info->bpp = image_read_le16(data + 24);
+    } else {
+        if (info->header_size < 40 || size < 14 + 40) return -1;
+        info->width = (int32_t)image_read_le32(data + 18);
+        info->height = (int32_t)image_read_le32(data + 22);
+        info->bpp = image_read_le16(data + 28);
+        info->compression = image_read_le32(data + 30);
+        info->palette_size = image_read_le32(data + 46);
+    }
+    if (info->width <= 0 || info->height == 0 || info->height == INT32_MIN) return -1;
+
+    if (info->compression == BMP_BITFIELDS || info->compression == BMP_ALPHA_BITFIELDS) {
+        // 掩码在 V2 以上的信息头内，或紧跟 40 字节信息头之后
+        size_t mask_count = info->compression == BMP_ALPHA_BITFIELDS || info->header_size >= 56 ? 4 : 3;
+        if (size < 14 + 40 + mask_count * 4) return -1;
+        for (size_t i = 0; i < mask_count; i++) info->masks[i] = image_read_le32(data + 54 + i * 4);
+    } else if (info->compression == BMP_RGB) {
+        if (info->bpp == 16) {
+            info->masks[0] = 0x7C00;
+            info->masks[1] = 0x03E0;
+            info->masks[2] = 0x001F;
+        } else if (info->bpp == 32) {
+            info->masks[0] = 0x00FF0000;
+            info->masks[1] = 0x0000FF00;
+            info->masks[2] = 0x000000FF;
+        }
+    } else {
+        LOG_ERROR("不支持压缩的 BMP（压缩方式 %u）", info->compression);
+        return -1;
+    }
+
+    if (info->bpp != 1 && info->bpp != 4 && info->bpp != 8 && info->bpp != 16 &&
+        info->bpp != 24 && info->bpp != 32) {
+        LOG_ERROR("不支持 %u 位的 BMP", info->bpp);
+        return -1;
+    }
+    if (info->bpp <= 8 && info->palette_size == 0) info->palette_size = 1u << info->bpp;
+    return 0;
+}
+
+// 调色板图像：BMP 常用全灰调色板保存灰度图，此时按单通道输出
+static bool bmp_palette_is_gray(const uint8_t* palette, uint32_t count, uint32_t entry) {
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* e = palette + (size_t)i * entry;
+        if (e[0] != e[1] || e[1] != e[2]) return false;
+    }
+    return true;
+}
+
+static uint32_t bmp_channels(const bmp_info_t* info, const uint8_t* data, size_t size) {
+    if (info->bpp <= 8) {
+        uint32_t entry = info->header_size == 12 ? 3 : 4;
+        size_t palette_offset = 14 + info->header_size;
+        if (palette_offset + (size_t)info->palette_size * entry <= size &&
+            bmp_palette_is_gray(data + palette_offset, info->palette_size, entry)) {
+            return 1;
+        }
+        return 3;
+    }
+    return info->masks[3] ? 4 : 3;
+}
+
+int image_bmp_probe(const uint8_t* data, size_t size, image_header_t* header) {
+    bmp_info_t info;
+    if (bmp_parse(data, size, &info) != 0) return -1;
+    memset(header, 0, sizeof(*header));
+    header->format = IMAGE_FORMAT_BMP;
+    header->width = (uint32_t)info.width;
+    header->height = (uint32_t)(info.height < 0 ? -info.height : info.height);
+    header->channels = bmp_channels(&info, data, size);
+    header->bit_depth = 8;
+    return 0;
+}
+
+/**
+ * @brief 位掩码字段：右移量和位宽
+ */
+typedef struct {
+    uint32_t mask;
+    uint32_t shift;
+    uint32_t bits;
+} bmp_field_t;
+
+static void bmp_field_init(bmp_field_t* field, uint32_t mask) {
+    memset(field, 0, sizeof(*field));
+    if (mask == 0) return;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        field->shift++;
+    }
+    field->mask = mask;
+    // 掩码可以占满 32 位，不能逐位右移到 32
+    field->bits = 32 - (uint32_t)__builtin_clz(mask);
+}
+
+// 提取字段并扩展到 8 位，没有掩码的通道为 255
+static inline uint8_t bmp_field(uint32_t value, const bmp_field_t* field) {
+    if (field->mask == 0) return 255;
+    uint32_t v = (value >> field->shift) & field->mask;
+    if (field->bits >= 8) return (uint8_t)(v >> (field->bits - 8));
+    return (uint8_t)((v * 255 + (field->mask >> 1)) / field->mask);
+}
+
+int image_bmp_decode(const uint8_t* data, size_t size, const image_sink_t* sink) {
+    bmp_info_t info;
+    if (bmp_parse(data, size, &info) != 0) {
+        LOG_ERROR("BMP 文件头无效");
+        return -1;
+    }
+
+    uint32_t width = (uint32_t)info.width;
+    bool top_down = info.height < 0;
+    uint32_t height = (uint32_t)(top_down ? -info.height : info.height);
+    uint32_t channels = bmp_channels(&info, data, size);
+    size_t stride = (((size_t)width * info.bpp + 31) / 32) * 4;
+    if (info.offset > size || (size - info.offset) / stride < height) {
+        LOG_ERROR("BMP 像素数据不完整");
+        return -1;
+    }
+
+    uint32_t entry = info.header_size == 12 ? 3 : 4;
+    size_t palette_offset = 14 + info.header_size;
+    if (info.compression == BMP_BITFIELDS && info.header_size == 40) palette_offset += 12;
+    if (info.bpp <= 8 && palette_offset + (size_t)info.palette_size * entry > size) {
+        LOG_ERROR("BMP 调色板不完整");
+        return -1;
+    }
+    const uint8_t* palette = data + palette_offset;
+    bmp_field_t fields[4];
+    for (uint32_t i = 0; i < 4; i++) bmp_field_init(&fields[i], info.masks[i]);
+
+    uint8_t* row = malloc((size_t)width * channels);
+    if (!row) return -1;
+    int ret = sink->begin(sink->context, width, height, channels);
+
+    for (uint32_t y = 0; y < height && ret == 0; y++) {
+        const uint8_t* src = data + info.offset + stride * (top_down ? y : height - 1 - y);
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t* d = row + (size_t)x * channels;
+            if (info.bpp <= 8) {
+                uint32_t bit = x * info.bpp;
+                uint32_t index = (src[bit >> 3] >> (8 - info.bpp - (bit & 7))) & ((1u << info.bpp) - 1);
+                if (index >= info.palette_size) index = 0;
+                const uint8_t* e = palette + (size_t)index * entry;
+                if (channels == 1) {
+                    d[0] = e[0];
+                } else {
+                    d[0] = e[2];
+                    d[1] = e[1];
+                    d[2] = e[0];
+                }
+            } else if (info.bpp == 24) {
+                d[0] = src[x * 3 + 2];
+                d[1] = src[x * 3 + 1];
+                d[2] = src[x * 3 + 0];
+            } else {
+                uint32_t value = info.bpp == 16 ? image_read_le16(src + x * 2) : image_read_le32(src + x * 4);
+                d[0] = bmp_field(value, &fields[0]);
+                d[1] = bmp_field(value, &fields[1]);
+                d[2] = bmp_field(value, &fields[2]);
+                if (channels == 4) d[3] = bmp_field(value, &fields[3]);
+            }
+        }
+        ret = sink->row(sink->context, y, row);
+    }
+
+    free(row);
+    return ret;
+}
@@ -0,0 +1,200 @@
+#ifndef MODYN_UTILS_IMAGE_DECODE_H
+#define MODYN_UTILS_IMAGE_DECODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "core/tensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 内置图像解码（JPEG/PNG/BMP，不依赖第三方库）
+ *
+ * 输出为 UINT8 NHWC 张量 [1, H, W, C]，通道顺序为 RGB(A)。
+ * - JPEG：基线与渐进式 Huffman 编码，8 位精度，灰度或三分量；色度按最近邻上采样
+ * - PNG：全部颜色类型和位深（16 位降为 8 位），支持 Adam7 隔行和 tRNS 透明
+ * - BMP：1/4/8 位调色板、16/24/32 位（含 BITFIELDS），不支持 RLE 压缩
+ */
+
+/**
+ * @brief 可解码图像的最大像素数（宽×高，约 1.34 亿），超过时探测和解码都返回失败
+ */
+#define IMAGE_DECODE_MAX_PIXELS (1ull << 27)
+
+/**
+ * @brief 图像文件格式
+ */
+typedef enum {
+    IMAGE_FORMAT_UNKNOWN = 0,       /**< 未知格式 */
+    IMAGE_FORMAT_JPEG,              /**< JPEG */
+    IMAGE_FORMAT_PNG,               /**< PNG */
+    IMAGE_FORMAT_BMP                /**< BMP */
+} image_format_e;
+
+/**
+ * @brief 图像头信息（只解析文件头，不解码像素）
+ */
+typedef struct {
+    image_format_e format;          /**< 文件格式 */
+    uint32_t width;                 /**< 宽度 */
+    uint32_t height;                /**< 高度 */
+    uint32_t channels;              /**< 解码后的原始通道数（灰度1、灰度+透明2、彩色3、彩色+透明4） */
+    uint32_t bit_depth;             /**< 每通道位数 */
+    bool progressive;               /**< JPEG 渐进式或 PNG 隔行 */
+} image_header_t;
+
+/**
+ * @brief 解码选项
+ */
+typedef struct {
+    uint32_t channels;              /**< 输出通道数（0表示原始通道数，可为1、3、4） */
+    uint32_t min_width;             /**< 输出宽度下限（0表示不限制） */
+    uint32_t min_height;            /**< 输出高度下限（0表示不限制） */
+} image_decode_options_t;
+
+/**
+ * @brief 直接写入目标张量的布局
+ *
+ * 浮点输出为 (pixel * scale - mean[c]) / std[c]；UINT8 输出缩放后的像素值，不做归一化。
+ */
+typedef struct {
+    uint32_t width;                 /**< 输出宽度（0表示解码宽度） */
+    uint32_t height;                /**< 输出高度（0表示解码高度） */
+    uint32_t channels;              /**< 输出通道数（0表示原始通道数，可为1、3、4） */
+    TensorFormat format;            /**< 输出布局（NCHW 或 NHWC） */
+    TensorDataType dtype;           /**< 输出类型（FLOAT32、FLOAT16 或 UINT8，UNKNOWN 视为 FLOAT32） */
+    float scale;                    /**< 像素缩放系数（0表示1） */
+    float mean[4];                  /**< 各通道均值（缩放后减去） */
+    float std[4];                   /**< 各通道标准差（0表示1） */
+} image_tensor_layout_t;
+
+/**
+ * @brief 根据文件头识别图像格式
+ *
+ * @param data 文件数据（至少前8字节）
+ * @param size 数据大小
+ * @return image_format_e 图像格式
+ */
+image_format_e image_detect_format(const void* data, size_t size);
+
+/**
+ * @brief 解析内存中图像的头信息
+ *
+ * @param data 文件数据
+ * @param size 数据大小
+ * @param header 输出头信息
+ * @return int 0成功，其他失败（包括像素数超过 IMAGE_DECODE_MAX_PIXELS）
+ */
+int image_probe_memory(const void* data, size_t size, image_header_t* header);
+
+/**
+ * @brief 读取图像文件的头信息
+ *
+ * 只读取文件开头（JPEG 的 SOF 位于较大的 EXIF 段之后时继续读取），不解码像素。
+ *
+ * @param path 文件路径
+ * @param header 输出头信息
+ * @return int 0成功，其他失败
+ */
+int image_probe_file(const char* path, image_header_t* header);
+
+/**
+ * @brief 计算按选项解码后的输出尺寸
+ *
+ * JPEG 在 DCT 域按 1/2、1/4、1/8 缩小：选择使输出不小于 min_width x min_height 的最小尺寸，
+ * 每个 8x8 块直接反变换为 4x4、2x2、1x1 的块平均值。其他格式按原尺寸输出。
+ *
+ * @param header 头信息
+ * @param options 解码选项（NULL表示原尺寸）
+ * @param width 输出宽度
+ * @param height 输出高度
+ */
+void image_decode_output_size(const image_header_t* header, const image_decode_options_t* options,
+                              uint32_t* width, uint32_t* height);
+
+/**
+ * @brief 解码内存中的图像
+ *
+ * 输出张量未分配时按解码尺寸分配，已分配时检查容量后直接写入。
+ *
+ * @param data 文件数据
+ * @param size 数据大小
+ * @param options 解码选项（NULL表示原尺寸、原始通道）
+ * @param output 输出 UINT8 NHWC 张量
+ * @return int 0成功，其他失败
+ */
+int image_decode_memory(const void* data, size_t size, const image_decode_options_t* options, Tensor* output);
+
+/**
+ * @brief 解码图像文件
+ *
+ * @param path 文件路径
+ * @param options 解码选项（NULL表示原尺寸、原始通道）
+ * @param output 输出 UINT8 NHWC 张量
+ * @return int 0成功，其他失败
+ */
+int image_decode_file(const char* path, const image_decode_options_t* options, Tensor* output);
+
+/**
+ * @brief 计算按布局输出的张量形状和字节数
+ *
+ * 布局的宽、高、通道数都已指定时 header 可以为 NULL。
+ *
+ * @param layout 目标布局
+ * @param header 头信息（用于补全未指定的尺寸和通道数）
+ * @param shape 输出形状（可为NULL）
+ * @param bytes 输出字节数（可为NULL）
+ * @return int 0成功，其他失败
+ */
+int image_tensor_layout_shape(const image_tensor_layout_t* layout, const image_header_t* header,
+                              TensorShape* shape, size_t* bytes);
+
+/**
+ * @brief 解码内存中的图像并直接写入目标布局
+ *
+ * 解码器每输出一行即完成通道转换、双线性缩放、归一化和类型转换，写入最终位置，
+ * 不产生整幅的中间图像。JPEG 先在 DCT 域缩小到不小于目标尺寸。
+ * 输出张量未分配时按布局分配，已分配时检查容量后直接写入。
+ *
+ * @param data 文件数据
+ * @param size 数据大小
+ * @param layout 目标布局
+ * @param output 输出张量
+ * @return int 0成功，其他失败
+ */
+int image_decode_memory_to_tensor(const void* data, size_t size, const image_tensor_layout_t* layout,
+                                  Tensor* output);
+
+/**
+ * @brief 解码图像文件并直接写入目标布局
+ *
+ * @param path 文件路径
+ * @param layout 目标布局
+ * @param output 输出张量
+ * @return int 0成功，其他失败
+ */
+int image_decode_file_to_tensor(const char* path, const image_tensor_layout_t* layout, Tensor* output);
+
+/**
+ * @brief 把交错 UINT8 像素逐行写入目标布局（用于其他来源的已解码图像）
+ *
+ * @param pixels 像素数据
+ * @param width 宽度
+ * @param height 高度
+ * @param channels 通道数（1~4）
+ * @param stride 行跨度（字节，0表示紧密排列）
+ * @param layout 目标布局
+ * @param output 输出张量
+ * @return int 0成功，其他失败
+ */
+int image_pixels_to_tensor(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels,
+                           size_t stride, const image_tensor_layout_t* layout, Tensor* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_IMAGE_DECODE_H
@@ -0,0 +1,88 @@
+#ifndef MODYN_UTILS_IMAGE_DECODE_INTERNAL_H
+#define MODYN_UTILS_IMAGE_DECODE_INTERNAL_H
+
+/**
+ * @brief 图像解码模块内部定义
+ *
+ * 各格式解码器逐行输出原始通道的 UINT8 像素，由 image_decode.c 统一做通道转换并写入目标。
+ */
+
+#include "utils/image_decode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 探测结果：数据不足以到达尺寸信息（例如 JPEG 的 SOF 位于大段 EXIF 之后）
+ */
+#define IMAGE_PROBE_NEED_MORE 1
+
+/**
+ * @brief 解码行输出
+ */
+typedef struct {
+    /** 尺寸确定后调用一次，channels 为原始通道数 */
+    int (*begin)(void* context, uint32_t width, uint32_t height, uint32_t channels);
+    /** 输出第 y 行（交错 UINT8），y 从 0 开始严格递增 */
+    int (*row)(void* context, uint32_t y, const uint8_t* row);
+    void* context;
+} image_sink_t;
+
+/**
+ * @brief 读取大端 16/32 位整数
+ */
+static inline uint32_t image_read_be16(const uint8_t* p) { return ((uint32_t)p[0] << 8) | p[1]; }
+static inline uint32_t image_read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+static inline uint32_t image_read_le16(const uint8_t* p) { return p[0] | ((uint32_t)p[1] << 8); }
+static inline uint32_t image_read_le32(const uint8_t* p) {
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief JPEG 头解析与解码（scale 为 1、2、4、8）
+ */
+int image_jpeg_probe(const uint8_t* data, size_t size, image_header_t* header);
+int image_jpeg_decode(const uint8_t* data, size_t size, uint32_t scale, const image_sink_t* sink);
+
+/**
+ * @brief PNG 头解析与解码
+ */
+int image_png_probe(const uint8_t* data, size_t size, image_header_t* header);
+int image_png_decode(const uint8_t* data, size_t size, const image_sink_t* sink);
+
+/**
+ * @brief BMP 头解析与解码
+ */
+int image_bmp_probe(const uint8_t* data, size_t size, image_header_t* header);
+int image_bmp_decode(const uint8_t* data, size_t size, const image_sink_t* sink);
+
+/**
+ * @brief 按解码选项选择 JPEG 的 DCT 缩放分母
+ */
+uint32_t image_jpeg_select_scale(uint32_t width, uint32_t height, uint32_t min_width, uint32_t min_height);
+
+/**
+ * @brief 识别格式并解码到行输出（JPEG 按最小尺寸选择 DCT 缩放）
+ */
+int image_decode_to_sink(const uint8_t* data, size_t size, uint32_t min_width, uint32_t min_height,
+                         const image_sink_t* sink);
+
+/**
+ * @brief 单行通道转换（RGB 转灰度使用 BT.601 亮度权重，透明通道丢弃或补 255）
+ */
+void image_convert_channels(const uint8_t* src, uint32_t src_channels, uint8_t* dst, uint32_t dst_channels,
+                            uint32_t width);
+
+/**
+ * @brief 读取文件（limit 为 0 表示读取整个文件），返回的缓冲区由调用者释放
+ */
+uint8_t* image_read_file(const char* path, size_t limit, size_t* size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_IMAGE_DECODE_INTERNAL_H
@@ -0,0 +1,1087 @@
+#include "utils/image_decode_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * @brief JPEG 解码（基线与渐进式 Huffman，8 位精度，灰度或三分量）
+ *
+ * 第一个扫描包含全部分量的基线图像按 MCU 行流式解码：每解完一行 MCU 立即做反 DCT、
+ * 色度上采样和颜色转换并输出，内存只与图像宽度有关。渐进式和多扫描图像先保存全部量化系数，
+ * 在 EOI 处逐行 MCU 输出。
+ *
+ * 缩放在 DCT 域完成：1/2、1/4、1/8 时每个 8x8 块直接反变换为 4x4、2x2、1x1 个像素。
+ * 反变换矩阵由 8 点余弦基在每组 2x2/4x4/8x8 像素上的均值构成，结果等于全尺寸解码后
+ * 做区域平均缩小，而计算量只有全尺寸反变换的一部分（1/8 时只需 DC 系数）。
+ * 下采样的色度分量按自身的缩放比例反变换（例如 4:2:0 在 1/2 时色度块输出 8x8），
+ * 输出时不再需要上采样。
+ */
+
+#define JPEG_MAX_COMPONENTS 3
+#define HUFF_FAST_BITS 9
+#define HUFF_NO_FAST 0xFFFF
+
+// 之字形序号到自然序号，末尾的填充防止损坏数据越界
+static const uint8_t k_zigzag[64 + 16] = {
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+};
+
+// AAN 反变换的输入缩放因子：k=0 为 1，其余为 cos(k*pi/16)*sqrt(2)
+static const float k_aan_scale[8] = {
+    1.0f, 1.387039845f, 1.306562965f, 1.175875602f,
+    1.0f, 0.785694958f, 0.541196100f, 0.275899379f
+};
+
+/**
+ * @brief 规范 Huffman 表：短码查表，长码按各长度的最大码值比较
+ */
+typedef struct {
+    uint16_t fast[1 << HUFF_FAST_BITS];    /**< 前 HUFF_FAST_BITS 位对应的符号序号 */
+    int16_t fast_ac[1 << HUFF_FAST_BITS];  /**< AC 表：(值 << 8) | (游程 << 4) | 总位数，0 表示需要完整解码 */
+    uint16_t code[256];
+    uint8_t values[256];
+    uint8_t size[257];
+    uint32_t maxcode[18];                   /**< 长度 l 的码左对齐到16位后的上界 */
+    int delta[17];                          /**< 码值到符号序号的偏移 */
+    bool defined;
+} jpeg_huffman_t;
+
+/**
+ * @brief 熵编码数据位读取器（处理 0xFF00 填充，遇到标记后补零）
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint64_t buffer;                        /**< 左对齐的待读位 */
+    int count;
+    uint8_t marker;                         /**< 遇到的标记，0 表示没有 */
+} jpeg_bits_t;
+
+typedef struct {
+    uint8_t id;
+    uint8_t h, v;                           /**< 采样因子 */
+    uint8_t hshift, vshift;                 /**< 输出时的上采样倍数（对数） */
+    uint8_t block_w, block_h;               /**< 每个块反变换输出的像素数 */
+    uint8_t tq;                             /**< 量化表 */
+    uint8_t td, ta;                         /**< 当前扫描的 DC/AC Huffman 表 */
+    int dc_pred;
+    uint32_t blocks_x, blocks_y;            /**< 按 MCU 对齐的块数 */
+    uint32_t comp_blocks_x, comp_blocks_y;  /**< 分量实际覆盖的块数（非交错扫描） */
+    int16_t* coeffs;                        /**< 缓存模式下的量化系数 */
+    uint8_t* plane;                         /**< 一行 MCU 的反变换结果 */
+    uint32_t plane_stride;
+} jpeg_component_t;
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    jpeg_bits_t bits;
+
+    uint16_t quant[4][64];                  /**< 自然序量化表 */
+    bool quant_defined[4];
+    float dequant[4][64];                   /**< 反量化系数 */
+    float dequant_aan[4][64];               /**< 含 AAN 缩放和 1/8 的反量化系数 */
+    jpeg_huffman_t dc[4];
+    jpeg_huffman_t ac[4];
+
+    jpeg_component_t comp[JPEG_MAX_COMPONENTS];
+    uint32_t ncomp;
+    uint32_t width, height;
+    uint32_t hmax, vmax;
+    uint32_t mcus_x, mcus_y;
+    bool frame_seen;
+    bool progressive;
+    bool buffered;                          /**< 保存系数、EOI 时输出 */
+    bool streamed;                          /**< 已流式输出全部像素 */
+    bool scan_seen;
+    uint32_t restart_interval;
+    int adobe_transform;                    /**< Adobe APP14 颜色变换标志，-1 表示没有 */
+
+    uint32_t scan_comp[JPEG_MAX_COMPONENTS];
+    uint32_t scan_ncomp;
+    uint32_t spec_start, spec_end;
+    uint32_t succ_high, succ_low;
+    uint32_t eob_run;
+
+    uint32_t scale;                         /**< 缩放分母 */
+    uint32_t n;                             /**< 每块输出 n x n 个像素 */
+    uint32_t out_width, out_height;
+    float idct_table[4][8 * 8];             /**< 输出 1/2/4/8 个像素时的反变换矩阵 */
+    bool rgb;                               /**< 三分量不做 YCbCr 变换 */
+    int32_t cr_r[256], cb_b[256], cr_g[256], cb_g[256];
+    uint8_t* row;
+    const image_sink_t* sink;
+} jpeg_decoder_t;
+
+// ==================== 熵解码 ====================
+
+static void bits_init(jpeg_bits_t* bits, const uint8_t* data, size_t size, size_t pos) {
+    bits->data = data;
+    bits->size = size;
+    bits->pos = pos;
+    bits->buffer = 0;
+    bits->count = 0;
+    bits->marker = 0;
+}
+
+static void bits_fill(jpeg_bits_t* bits) {
+    while (bits->count <= 56) {
+        uint64_t byte = 0;
+        if (!bits->marker && bits->pos < bits->size) {
+            byte = bits->data[bits->pos];
+            if (byte == 0xFF) {
+                uint8_t next = bits->pos + 1 < bits->size ? bits->data[bits->pos + 1] : 0xD9;
+                if (next == 0x00) {
+                    bits->pos += 2;
+                } else {
+                    // 标记不属于熵编码数据，之后补零
+                    bits->marker = next;
+                    byte = 0;
+                }
+            } else {
+                bits->pos++;
+            }
+        }
+        bits->buffer |= byte << (56 - bits->count);
+        bits->count += 8;
+    }
+}
+
+static inline uint32_t bits_get(jpeg_bits_t* bits, uint32_t n) {
+    if (n == 0) return 0;
+    if (bits->count < (int)n) bits_fill(bits);
+    uint32_t value = (uint32_t)(bits->buffer >> (64 - n));
+    bits->buffer <<= n;
+    bits->count -= (int)n;
+    return value;
+}
+
+static inline uint32_t bits_get1(jpeg_bits_t* bits) {
+    if (bits->count < 1) bits_fill(bits);
+    uint32_t value = (uint32_t)(bits->buffer >> 63);
+    bits->buffer <<= 1;
+    bits->count--;
+    return value;
+}
+
+// 读取 s 位并按 JPEG 规则扩展为有符号数
+static inline int bits_extend(jpeg_bits_t* bits, uint32_t s) {
+    if (s == 0) return 0;
+    int value = (int)bits_get(bits, s);
+    if (value < (1 << (s - 1))) value += (int)(~0u << s) + 1;
+    return value;
+}
+
+static int huffman_build(jpeg_huffman_t* table, const uint8_t counts[16], const uint8_t* values, uint32_t total) {
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        for (uint32_t j = 0; j < counts[i]; j++) table->size[k++] = (uint8_t)(i + 1);
+    }
+    table->size[k] = 0;
+    memcpy(table->values, values, total);
+
+    uint32_t code = 0;
+    k = 0;
+    for (uint32_t len = 1; len <= 16; len++) {
+        table->delta[len] = (int)k - (int)code;
+        while (table->size[k] == len) table->code[k++] = (uint16_t)code++;
+        if (code > (1u << len)) return -1;
+        table->maxcode[len] = code << (16 - len);
+        code <<= 1;
+    }
+    table->maxcode[17] = 0xFFFFFFFFu;
+
+    for (uint32_t i = 0; i < (1u << HUFF_FAST_BITS); i++) table->fast[i] = HUFF_NO_FAST;
+    for (uint32_t i = 0; i < k; i++) {
+        uint32_t len = table->size[i];
+        if (len > HUFF_FAST_BITS) continue;
+        uint32_t first = (uint32_t)table->code[i] << (HUFF_FAST_BITS - len);
+        uint32_t span = 1u << (HUFF_FAST_BITS - len);
+        for (uint32_t j = 0; j < span; j++) table->fast[first + j] = (uint16_t)i;
+    }
+    table->defined = true;
+    return 0;
+}
+
+// AC 快速表：码长与附加位总数不超过 HUFF_FAST_BITS 时一次查表得到游程和系数值
+static void huffman_build_fast_ac(jpeg_huffman_t* table) {
+    for (uint32_t i = 0; i < (1u << HUFF_FAST_BITS); i++) {
+        table->fast_ac[i] = 0;
+        uint32_t index = table->fast[i];
+        if (index == HUFF_NO_FAST) continue;
+        uint32_t rs = table->values[index];
+        uint32_t run = rs >> 4;
+        uint32_t size = rs & 15;
+        uint32_t len = table->size[index];
+        if (size == 0 || len + size > HUFF_FAST_BITS) continue;
+
+        int value = (int)((i << len) & ((1u << HUFF_FAST_BITS) - 1)) >> (HUFF_FAST_BITS - size);
+        if (value < (1 << (size - 1))) value += (int)(~0u << size) + 1;
+        if (value >= -128 && value <= 127) {
+            table->fast_ac[i] = (int16_t)(value * 256 + (int)(run * 16 + len + size));
+        }
+    }
+}
+
+static inline int huffman_decode(jpeg_bits_t* bits, const jpeg_huffman_t* table) {
+    if (bits->count < 16) bits_fill(bits);
+    uint32_t index = table->fast[bits->buffer >> (64 - HUFF_FAST_BITS)];
+    if (index != HUFF_NO_FAST) {
+        uint32_t len = table->size[index];
+        bits->buffer <<= len;
+        bits->count -= (int)len;
+        return table->values[index];
+    }
+
+    uint32_t peek = (uint32_t)(bits->buffer >> 48);
+    uint32_t len = HUFF_FAST_BITS + 1;
+    while (peek >= table->maxcode[len]) len++;
+    if (len > 16) return -1;
+    int symbol = (int)(bits->buffer >> (64 - len)) + table->delta[len];
+    if (symbol < 0 || symbol > 255) return -1;
+    bits->buffer <<= len;
+    bits->count -= (int)len;
+    return table->values[symbol];
+}
+
+// 基线块：系数按自然序写入 block（未反量化）
+static int decode_block_baseline(jpeg_decoder_t* dec, jpeg_component_t* comp, int16_t* block) {
+    jpeg_bits_t* bits = &dec->bits;
+    int t = huffman_decode(bits, &dec->dc[comp->td]);
+    if (t < 0 || t > 11) return -1;
+    comp->dc_pred += bits_extend(bits, (uint32_t)t);
+    block[0] = (int16_t)comp->dc_pred;
+
+    const jpeg_huffman_t* ac = &dec->ac[comp->ta];
+    for (uint32_t k = 1; k < 64;) {
+        if (bits->count < 16) bits_fill(bits);
+        int fast = ac->fast_ac[bits->buffer >> (64 - HUFF_FAST_BITS)];
+        if (fast) {
+            uint32_t consumed = (uint32_t)fast & 15;
+            k += ((uint32_t)fast >> 4) & 15;
+            bits->buffer <<= consumed;
+            bits->count -= (int)consumed;
+            if (k > 63) return -1;
+            block[k_zigzag[k++]] = (int16_t)(fast >> 8);
+            continue;
+        }
+
+        int rs = huffman_decode(bits, ac);
+        if (rs < 0) return -1;
+        uint32_t r = (uint32_t)rs >> 4;
+        uint32_t s = (uint32_t)rs & 15;
+        if (s == 0) {
+            if (r != 15) break;
+            k += 16;
+            continue;
+        }
+        k += r;
+        if (k > 63) return -1;
+        block[k_zigzag[k]] = (int16_t)bits_extend(bits, s);
+        k++;
+    }
+    return 0;
+}
+
+static int decode_block_prog_dc(jpeg_decoder_t* dec, jpeg_component_t* comp, int16_t* block) {
+    jpeg_bits_t* bits = &dec->bits;
+    if (dec->succ_high == 0) {
+        int t = huffman_decode(bits, &dec->dc[comp->td]);
+        if (t < 0 || t > 11) return -1;
+        comp->dc_pred += bits_extend(bits, (uint32_t)t);
+        block[0] = (int16_t)(comp->dc_pred * (1 << dec->succ_low));
+    } else if (bits_get1(bits)) {
+        block[0] = (int16_t)(block[0] | (1 << dec->succ_low));
+    }
+    return 0;
+}
+
+static inline void refine_coeff(jpeg_bits_t* bits, int16_t* coef, int bit) {
+    if (bits_get1(bits) && (*coef & bit) == 0) {
+        *coef = (int16_t)(*coef > 0 ? *coef + bit : *coef - bit);
+    }
+}
+
+static int decode_block_prog_ac(jpeg_decoder_t* dec, jpeg_component_t* comp, int16_t* block) {
+    jpeg_bits_t* bits = &dec->bits;
+    const jpeg_huffman_t* ac = &dec->ac[comp->ta];
+    uint32_t k = dec->spec_start;
+    uint32_t end = dec->spec_end;
+
+    if (dec->succ_high == 0) {
+        if (dec->eob_run > 0) {
+            dec->eob_run--;
+            return 0;
+        }
+        while (k <= end) {
+            int rs = huffman_decode(bits, ac);
+            if (rs < 0) return -1;
+            uint32_t r = (uint32_t)rs >> 4;
+            uint32_t s = (uint32_t)rs & 15;
+            if (s == 0) {
+                if (r < 15) {
+                    dec->eob_run = (1u << r) - 1 + bits_get(bits, r);
+                    break;
+                }
+                k += 16;
+                continue;
+            }
+            k += r;
+            if (k > 63) return -1;
+            block[k_zigzag[k++]] = (int16_t)(bits_extend(bits, s) * (1 << dec->succ_low));
+        }
+        return 0;
+    }
+
+    // 细化扫描：已非零的系数各读一位修正，零系数按游程放置新的 ±1
+    int bit = 1 << dec->succ_low;
+    if (dec->eob_run > 0) {
+        dec->eob_run--;
+        for (; k <= end; k++) {
+            int16_t* coef = &block[k_zigzag[k]];
+            if (*coef != 0) refine_coeff(bits, coef, bit);
+        }
+        return 0;
+    }
+
+    while (k <= end) {
+        int rs = huffman_decode(bits, ac);
+        if (rs < 0) return -1;
+        int r = rs >> 4;
+        int s = rs & 15;
+        int value = 0;
+        if (s == 0) {
+            if (r < 15) {
+                dec->eob_run = (1u << r) - 1 + bits_get(bits, (uint32_t)r);
+                r = 64;
+            }
+        } else {
+            if (s != 1) return -1;
+            value = bits_get1(bits) ? bit : -bit;
+        }
+
+        while (k <= end) {
+            int16_t* coef = &block[k_zigzag[k++]];
+            if (*coef != 0) {
+                refine_coeff(bits, coef, bit);
+            } else {
+                if (r == 0) {
+                    *coef = (int16_t)value;
+                    break;
+                }
+                r--;
+            }
+        }
+    }
+    return 0;
+}
+
+// ==================== 反变换与输出 ====================
+
+// 按当前量化表准备反量化系数：AAN 路径并入输入缩放和最终的 1/8
+static void prepare_dequant(jpeg_decoder_t* dec) {
+    for (uint32_t t = 0; t < 4; t++) {
+        if (!dec->quant_defined[t]) continue;
+        for (uint32_t i = 0; i < 64; i++) {
+            float q = (float)dec->quant[t][i];
+            dec->dequant[t][i] = q;
+            dec->dequant_aan[t][i] = q * k_aan_scale[i >> 3] * k_aan_scale[i & 7] * 0.125f;
+        }
+    }
+}
+
+static inline uint8_t clamp_sample(float value) {
+    // 加 128 偏移后四舍五入
+    int v = (int)lrintf(value + 128.0f);
+    return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// 8 点 AAN 浮点反 DCT（先列后行）
+static void idct_8x8(const int16_t* coef, const float* dequant, uint8_t* out, uint32_t stride) {
+    float ws[64];
+    for (uint32_t col = 0; col < 8; col++) {
+        const int16_t* in = coef + col;
+        const float* q = dequant + col;
+        if (in[8] == 0 && in[16] == 0 && in[24] == 0 && in[32] == 0 &&
+            in[40] == 0 && in[48] == 0 && in[56] == 0) {
+            float dc = in[0] * q[0];
+            for (uint32_t row = 0; row < 8; row++) ws[row * 8 + col] = dc;
+            continue;
+        }
+
+        float tmp0 = in[0] * q[0];
+        float tmp1 = in[16] * q[16];
+        float tmp2 = in[32] * q[32];
+        float tmp3 = in[48] * q[48];
+        float tmp10 = tmp0 + tmp2;
+        float tmp11 = tmp0 - tmp2;
+        float tmp13 = tmp1 + tmp3;
+        float tmp12 = (tmp1 - tmp3) * 1.414213562f - tmp13;
+        tmp0 = tmp10 + tmp13;
+        tmp3 = tmp10 - tmp13;
+        tmp1 = tmp11 + tmp12;
+        tmp2 = tmp11 - tmp12;
+
+        float tmp4 = in[8] * q[8];
+        float tmp5 = in[24] * q[24];
+        float tmp6 = in[40] * q[40];
+        float tmp7 = in[56] * q[56];
+        float z13 = tmp6 + tmp5;
+        float z10 = tmp6 - tmp5;
+        float z11 = tmp4 + tmp7;
+        float z12 = tmp4 - tmp7;
+        tmp7 = z11 + z13;
+        tmp11 = (z11 - z13) * 1.414213562f;
+        float z5 = (z10 + z12) * 1.847759065f;
+        tmp10 = z12 * 1.082392200f - z5;
+        tmp12 = z10 * -2.613125930f + z5;
+        tmp6 = tmp12 - tmp7;
+        tmp5 = tmp11 - tmp6;
+        tmp4 = tmp10 + tmp5;
+
+        ws[0 * 8 + col] = tmp0 + tmp7;
+        ws[7 * 8 + col] = tmp0 - tmp7;
+        ws[1 * 8 + col] = tmp1 + tmp6;
+        ws[6 * 8 + col] = tmp1 - tmp6;
+        ws[2 * 8 + col] = tmp2 + tmp5;
+        ws[5 * 8 + col] = tmp2 - tmp5;
+        ws[4 * 8 + col] = tmp3 + tmp4;
+        ws[3 * 8 + col] = tmp3 - tmp4;
+    }
+
+    for (uint32_t row = 0; row < 8; row++) {
+        const float* w = ws + row * 8;
+        uint8_t* o = out + (size_t)row * stride;
+
+        float tmp10 = w[0] + w[4];
+        float tmp11 = w[0] - w[4];
+        float tmp13 = w[2] + w[6];
+        float tmp12 = (w[2] - w[6]) * 1.414213562f - tmp13;
+        float tmp0 = tmp10 + tmp13;
+        float tmp3 = tmp10 - tmp13;
+        float tmp1 = tmp11 + tmp12;
+        float tmp2 = tmp11 - tmp12;
+
+        float z13 = w[5] + w[3];
+        float z10 = w[5] - w[3];
+        float z11 = w[1] + w[7];
+        float z12 = w[1] - w[7];
+        float tmp7 = z11 + z13;
+        tmp11 = (z11 - z13) * 1.414213562f;
+        float z5 = (z10 + z12) * 1.847759065f;
+        tmp10 = z12 * 1.082392200f - z5;
+        tmp12 = z10 * -2.613125930f + z5;
+        float tmp6 = tmp12 - tmp7;
+        float tmp5 = tmp11 - tmp6;
+        float tmp4 = tmp10 + tmp5;
+
+        o[0] = clamp_sample(tmp0 + tmp7);
+        o[7] = clamp_sample(tmp0 - tmp7);
+        o[1] = clamp_sample(tmp1 + tmp6);
+        o[6] = clamp_sample(tmp1 - tmp6);
+        o[2] = clamp_sample(tmp2 + tmp5);
+        o[5] = clamp_sample(tmp2 - tmp5);
+        o[4] = clamp_sample(tmp3 + tmp4);
+        o[3] = clamp_sample(tmp3 - tmp4);
+    }
+}
+
+static inline uint32_t size_index(uint32_t size) {
+    return size == 1 ? 0 : (size == 2 ? 1 : (size == 4 ? 2 : 3));
+}
+
+// 缩小反变换：先按行把 8 个系数投影为 width 个像素，再按列投影为 height 行，全零系数行跳过
+static void idct_reduced(const jpeg_decoder_t* dec, const int16_t* coef, const float* dequant,
+                         uint32_t width, uint32_t height, uint8_t* out, uint32_t stride) {
+    const float* table_x = dec->idct_table[size_index(width)];
+    const float* table_y = dec->idct_table[size_index(height)];
+    float ws[8 * 8];
+    uint32_t rows[8];
+    uint32_t row_count = 0;
+
+    for (uint32_t v = 0; v < 8; v++) {
+        const int16_t* in = coef + v * 8;
+        uint32_t last = 8;
+        while (last > 0 && in[last - 1] == 0) last--;
+        if (last == 0) continue;
+
+        float f[8];
+        for (uint32_t u = 0; u < last; u++) f[u] = in[u] * dequant[v * 8 + u];
+        for (uint32_t x = 0; x < width; x++) {
+            const float* t = table_x + x * 8;
+            float sum = 0.0f;
+            for (uint32_t u = 0; u < last; u++) sum += t[u] * f[u];
+            ws[v * 8 + x] = sum;
+        }
+        rows[row_count++] = v;
+    }
+
+    for (uint32_t y = 0; y < height; y++) {
+        const float* t = table_y + y * 8;
+        uint8_t* o = out + (size_t)y * stride;
+        for (uint32_t x = 0; x < width; x++) {
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < row_count; i++) sum += t[rows[i]] * ws[rows[i] * 8 + x];
+            o[x] = clamp_sample(sum);
+        }
+    }
+}
+
+static inline void idct_block(const jpeg_decoder_t* dec, const jpeg_component_t* comp, const int16_t* coef,
+                              uint32_t bx, uint32_t by) {
+    uint8_t* out = comp->plane + (size_t)by * comp->block_h * comp->plane_stride + (size_t)bx * comp->block_w;
+    if (comp->block_w == 8 && comp->block_h == 8) {
+        idct_8x8(coef, dec->dequant_aan[comp->tq], out, comp->plane_stride);
+    } else {
+        idct_reduced(dec, coef, dec->dequant[comp->tq], comp->block_w, comp->block_h, out, comp->plane_stride);
+    }
+}
+
+// 一行 MCU 的分量平面转换为输出行：色度按最近邻上采样，YCbCr 转 RGB
+static int emit_mcu_row(jpeg_decoder_t* dec, uint32_t mcu_y) {
+    uint32_t rows = dec->vmax * dec->n;
+    uint32_t y0 = mcu_y * rows;
+    uint32_t width = dec->out_width;
+
+    for (uint32_t r = 0; r < rows && y0 + r < dec->out_height; r++) {
+        if (dec->ncomp == 1) {
+            const jpeg_component_t* c = &dec->comp[0];
+            if (dec->sink->row(dec->sink->context, y0 + r, c->plane + (size_t)r * c->plane_stride) != 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        const jpeg_component_t* c0 = &dec->comp[0];
+        const jpeg_component_t* c1 = &dec->comp[1];
+        const jpeg_component_t* c2 = &dec->comp[2];
+        const uint8_t* p0 = c0->plane + (size_t)(r >> c0->vshift) * c0->plane_stride;
+        const uint8_t* p1 = c1->plane + (size_t)(r >> c1->vshift) * c1->plane_stride;
+        const uint8_t* p2 = c2->plane + (size_t)(r >> c2->vshift) * c2->plane_stride;
+        uint32_t s0 = c0->hshift, s1 = c1->hshift, s2 = c2->hshift;
+        uint8_t* out = dec->row;
+
+        if (dec->rgb) {
+            for (uint32_t x = 0; x < width; x++) {
+                out[x * 3 + 0] = p0[x >> s0];
+                out[x * 3 + 1] = p1[x >> s1];
+                out[x * 3 + 2] = p2[x >> s2];
+            }
+        } else {
+            for (uint32_t x = 0; x < width; x++) {
+                int y = p0[x >> s0];
+                int cb = p1[x >> s1];
+                int cr = p2[x >> s2];
+                int red = y + dec->cr_r[cr];
+                int green = y + ((dec->cb_g[cb] + dec->cr_g[cr]) >> 16);
+                int blue = y + dec->cb_b[cb];
+                out[x * 3 + 0] = (uint8_t)(red < 0 ? 0 : (red > 255 ? 255 : red));
+                out[x * 3 + 1] = (uint8_t)(green < 0 ? 0 : (green > 255 ? 255 : green));
+                out[x * 3 + 2] = (uint8_t)(blue < 0 ? 0 : (blue > 255 ? 255 : blue));
+            }
+        }
+        if (dec->sink->row(dec->sink->context, y0 + r, out) != 0) return -1;
+    }
+    return 0;
+}
+
+// 缓存模式：全部扫描结束后逐行 MCU 反变换并输出
+static int render_buffered(jpeg_decoder_t* dec) {
+    prepare_dequant(dec);
+    for (uint32_t my = 0; my < dec->mcus_y; my++) {
+        for (uint32_t ci = 0; ci < dec->ncomp; ci++) {
+            jpeg_component_t* comp = &dec->comp[ci];
+            for (uint32_t by = 0; by < comp->v; by++) {
+                const int16_t* row = comp->coeffs + ((size_t)(my * comp->v + by) * comp->blocks_x) * 64;
+                for (uint32_t bx = 0; bx < comp->blocks_x; bx++) {
+                    idct_block(dec, comp, row + (size_t)bx * 64, bx, by);
+                }
+            }
+        }
+        if (emit_mcu_row(dec, my) != 0) return -1;
+    }
+    return 0;
+}
+
+// ==================== 段解析 ====================
+
+static int parse_dqt(jpeg_decoder_t* dec, const uint8_t* p, uint32_t len) {
+    while (len > 0) {
+        uint32_t precision = p[0] >> 4;
+        uint32_t table = p[0] & 15;
+        uint32_t bytes = 1 + 64 * (precision ? 2 : 1);
+        if (table > 3 || precision > 1 || len < bytes) return -1;
+        for (uint32_t i = 0; i < 64; i++) {
+            uint32_t value = precision ? image_read_be16(p + 1 + i * 2) : p[1 + i];
+            dec->quant[table][k_zigzag[i]] = (uint16_t)value;
+        }
+        dec->quant_defined[table] = true;
+        p += bytes;
+        len -= bytes;
+    }
+    return 0;
+}
+
+static int parse_dht(jpeg_decoder_t* dec, const uint8_t* p, uint32_t len) {
+    while (len > 0) {
+        if (len < 17) return -1;
+        uint32_t cls = p[0] >> 4;
+        uint32_t index = p[0] & 15;
+        if (cls > 1 || index > 3) return -1;
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < 16; i++) total += p[1 + i];
+        if (total > 256 || len < 17 + total) return -1;
+        jpeg_huffman_t* table = cls ? &dec->ac[index] : &dec->dc[index];
+        if (huffman_build(table, p + 1, p + 17, total) != 0) return -1;
+        if (cls) huffman_build_fast_ac(table);
+        p += 17 + total;
+        len -= 17 + total;
+    }
+    return 0;
+}
+
+static int parse_sof(jpeg_decoder_t* dec, const uint8_t* p, uint32_t len, image_header_t* header) {
+    if (len < 6) return -1;
+    uint32_t precision = p[0];
+    uint32_t height = image_read_be16(p + 1);
+    uint32_t width = image_read_be16(p + 3);
+    uint32_t ncomp = p[5];
+    if (len < 6 + ncomp * 3) return -1;
+
+    if (header) {
+        header->width = width;
+        header->height = height;
+        header->channels = ncomp;
+        header->bit_depth = precision;
+    }
+    if (!dec) return 0;
+
+    if (precision != 8) {
+        LOG_ERROR("不支持 %u 位精度的 JPEG", precision);
+        return -1;
+    }
+    if (width == 0 || height == 0) {
+        LOG_ERROR("JPEG 尺寸无效（%ux%u）", width, height);
+        return -1;
+    }
+    if (ncomp != 1 && ncomp != 3) {
+        LOG_ERROR("不支持 %u 分量的 JPEG", ncomp);
+        return -1;
+    }
+
+    dec->width = width;
+    dec->height = height;
+    dec->ncomp = ncomp;
+    dec->hmax = 1;
+    dec->vmax = 1;
+    for (uint32_t i = 0; i < ncomp; i++) {
+        jpeg_component_t* comp = &dec->comp[i];
+        comp->id = p[6 + i * 3];
+        comp->h = p[7 + i * 3] >> 4;
+        comp->v = p[7 + i * 3] & 15;
+        comp->tq = p[8 + i * 3];
+        if (comp->h < 1 || comp->h > 4 || comp->v < 1 || comp->v > 4 || comp->tq > 3) return -1;
+        // 单分量图像的 MCU 总是一个块
+        if (ncomp == 1) comp->h = comp->v = 1;
+        if (comp->h > dec->hmax) dec->hmax = comp->h;
+        if (comp->v > dec->vmax) dec->vmax = comp->v;
+    }
+
+    for (uint32_t i = 0; i < ncomp; i++) {
+        jpeg_component_t* comp = &dec->comp[i];
+        uint32_t hs = dec->hmax / comp->h;
+        uint32_t vs = dec->vmax / comp->v;
+        if (dec->hmax % comp->h || dec->vmax % comp->v || (hs & (hs - 1)) || (vs & (vs - 1))) {
+            LOG_ERROR("不支持的 JPEG 采样因子");
+            return -1;
+        }
+        // 每个块覆盖 n*hs x n*vs 个输出像素，超过 8 的部分在输出时上采样
+        uint32_t span_w = dec->n * hs;
+        uint32_t span_h = dec->n * vs;
+        comp->block_w = (uint8_t)(span_w > 8 ? 8 : span_w);
+        comp->block_h = (uint8_t)(span_h > 8 ? 8 : span_h);
+        uint32_t up_w = span_w / comp->block_w;
+        uint32_t up_h = span_h / comp->block_h;
+        comp->hshift = (uint8_t)(up_w == 4 ? 2 : up_w - 1);
+        comp->vshift = (uint8_t)(up_h == 4 ? 2 : up_h - 1);
+    }
+
+    dec->mcus_x = (width + dec->hmax * 8 - 1) / (dec->hmax * 8);
+    dec->mcus_y = (height + dec->vmax * 8 - 1) / (dec->vmax * 8);
+    dec->out_width = (width + dec->scale - 1) / dec->scale;
+    dec->out_height = (height + dec->scale - 1) / dec->scale;
+
+    for (uint32_t i = 0; i < ncomp; i++) {
+        jpeg_component_t* comp = &dec->comp[i];
+        comp->blocks_x = dec->mcus_x * comp->h;
+        comp->blocks_y = dec->mcus_y * comp->v;
+        uint32_t comp_width = (width * comp->h + dec->hmax - 1) / dec->hmax;
+        uint32_t comp_height = (height * comp->v + dec->vmax - 1) / dec->vmax;
+        comp->comp_blocks_x = (comp_width + 7) / 8;
+        comp->comp_blocks_y = (comp_height + 7) / 8;
+        comp->plane_stride = comp->blocks_x * comp->block_w;
+        comp->plane = malloc((size_t)comp->plane_stride * comp->v * comp->block_h);
+        if (!comp->plane) return -1;
+    }
+    dec->row = malloc((size_t)dec->out_width * ncomp);
+    if (!dec->row) return -1;
+
+    dec->frame_seen = true;
+    return dec->sink->begin(dec->sink->context, dec->out_width, dec->out_height, ncomp);
+}
+
+static int ensure_coeffs(jpeg_decoder_t* dec) {
+    for (uint32_t i = 0; i < dec->ncomp; i++) {
+        jpeg_component_t* comp = &dec->comp[i];
+        if (comp->coeffs) continue;
+        comp->coeffs = calloc((size_t)comp->blocks_x * comp->blocks_y * 64, sizeof(int16_t));
+        if (!comp->coeffs) {
+            LOG_ERROR("JPEG 系数缓冲区分配失败");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int parse_sos(jpeg_decoder_t* dec, const uint8_t* p, uint32_t len) {
+    if (len < 1) return -1;
+    uint32_t ns = p[0];
+    if (ns < 1 || ns > dec->ncomp || len < 4 + ns * 2) return -1;
+    for (uint32_t i = 0; i < ns; i++) {
+        uint32_t id = p[1 + i * 2];
+        uint32_t tables = p[2 + i * 2];
+        uint32_t index = dec->ncomp;
+        for (uint32_t c = 0; c < dec->ncomp; c++) {
+            if (dec->comp[c].id == id) index = c;
+        }
+        if (index == dec->ncomp) return -1;
+        dec->comp[index].td = (uint8_t)(tables >> 4);
+        dec->comp[index].ta = (uint8_t)(tables & 15);
+        if (dec->comp[index].td > 3 || dec->comp[index].ta > 3) return -1;
+        dec->scan_comp[i] = index;
+    }
+    dec->scan_ncomp = ns;
+    const uint8_t* q = p + 1 + ns * 2;
+    dec->spec_start = q[0];
+    dec->spec_end = q[1];
+    dec->succ_high = q[2] >> 4;
+    dec->succ_low = q[2] & 15;
+
+    if (dec->progressive) {
+        if (dec->spec_start > 63 || dec->spec_end > 63 || dec->spec_start > dec->spec_end ||
+            dec->succ_high > 13 || dec->succ_low > 13) {
+            return -1;
+        }
+        if (dec->spec_start == 0 && dec->spec_end != 0) return -1;
+        if (dec->spec_start > 0 && ns != 1) return -1;
+    } else {
+        dec->spec_start = 0;
+        dec->spec_end = 63;
+    }
+
+    for (uint32_t i = 0; i < ns; i++) {
+        const jpeg_component_t* comp = &dec->comp[dec->scan_comp[i]];
+        bool dc_needed = dec->spec_start == 0 && dec->succ_high == 0;
+        bool ac_needed = dec->spec_end > 0;
+        if ((dc_needed && !dec->dc[comp->td].defined) || (ac_needed && !dec->ac[comp->ta].defined)) {
+            LOG_ERROR("JPEG 扫描引用了未定义的 Huffman 表");
+            return -1;
+        }
+        if (!dec->quant_defined[comp->tq]) {
+            LOG_ERROR("JPEG 分量引用了未定义的量化表");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// 复位间隔结束：丢弃剩余位，跳过 RSTn 标记
+static void handle_restart(jpeg_decoder_t* dec) {
+    jpeg_bits_t* bits = &dec->bits;
+    if (!bits->marker) {
+        while (bits->pos + 1 < bits->size &&
+               !(bits->data[bits->pos] == 0xFF && bits->data[bits->pos + 1] >= 0xD0 &&
+                 bits->data[bits->pos + 1] <= 0xD7)) {
+            bits->pos++;
+        }
+        if (bits->pos + 1 < bits->size) bits->marker = bits->data[bits->pos + 1];
+    }
+    if (bits->marker >= 0xD0 && bits->marker <= 0xD7) bits->pos += 2;
+    bits->buffer = 0;
+    bits->count = 0;
+    bits->marker = 0;
+    for (uint32_t i = 0; i < dec->ncomp; i++) dec->comp[i].dc_pred = 0;
+    dec->eob_run = 0;
+}
+
+static inline int decode_block(jpeg_decoder_t* dec, jpeg_component_t* comp, uint32_t bx, uint32_t by) {
+    if (!dec->buffered) {
+        int16_t block[64];
+        memset(block, 0, sizeof(block));
+        if (decode_block_baseline(dec, comp, block) != 0) return -1;
+        idct_block(dec, comp, block, bx, by % comp->v);
+        return 0;
+    }
+
+    int16_t* block = comp->coeffs + ((size_t)by * comp->blocks_x + bx) * 64;
+    if (!dec->progressive) return decode_block_baseline(dec, comp, block);
+    if (dec->spec_start == 0) return decode_block_prog_dc(dec, comp, block);
+    return decode_block_prog_ac(dec, comp, block);
+}
+
+static int decode_scan(jpeg_decoder_t* dec, size_t pos, size_t* end) {
+    bits_init(&dec->bits, dec->data, dec->size, pos);
+    for (uint32_t i = 0; i < dec->ncomp; i++) dec->comp[i].dc_pred = 0;
+    dec->eob_run = 0;
+
+    uint32_t todo = dec->restart_interval;
+    int ret = 0;
+
+    if (dec->scan_ncomp == 1) {
+        // 非交错扫描：每个块是一个 MCU
+        jpeg_component_t* comp = &dec->comp[dec->scan_comp[0]];
+        for (uint32_t by = 0; by < comp->comp_blocks_y && ret == 0; by++) {
+            for (uint32_t bx = 0; bx < comp->comp_blocks_x && ret == 0; bx++) {
+                ret = decode_block(dec, comp, bx, by);
+                if (dec->restart_interval && --todo == 0) {
+                    handle_restart(dec);
+                    todo = dec->restart_interval;
+                }
+            }
+            // 只有单分量图像会流式解码非交错扫描，此时一行块就是一行 MCU
+            if (ret == 0 && !dec->buffered) ret = emit_mcu_row(dec, by);
+        }
+    } else {
+        for (uint32_t my = 0; my < dec->mcus_y && ret == 0; my++) {
+            for (uint32_t mx = 0; mx < dec->mcus_x && ret == 0; mx++) {
+                for (uint32_t i = 0; i < dec->scan_ncomp && ret == 0; i++) {
+                    jpeg_component_t* comp = &dec->comp[dec->scan_comp[i]];
+                    for (uint32_t by = 0; by < comp->v && ret == 0; by++) {
+                        for (uint32_t bx = 0; bx < comp->h && ret == 0; bx++) {
+                            ret = decode_block(dec, comp, mx * comp->h + bx, my * comp->v + by);
+                        }
+                    }
+                }
+                if (dec->restart_interval && --todo == 0) {
+                    handle_restart(dec);
+                    todo = dec->restart_interval;
+                }
+            }
+            if (ret == 0 && !dec->buffered) ret = emit_mcu_row(dec, my);
+        }
+    }
+
+    if (ret != 0) {
+        LOG_ERROR("JPEG 熵编码数据损坏");
+        return -1;
+    }
+    *end = dec->bits.pos;
+    return 0;
+}
+
+// 从 pos 开始查找下一个标记，返回标记码并把 pos 移到段内容（长度字段）处
+static int next_marker(const uint8_t* data, size_t size, size_t* pos) {
+    size_t p = *pos;
+    for (;;) {
+        while (p < size && data[p] != 0xFF) p++;
+        while (p < size && data[p] == 0xFF) p++;
+        if (p >= size) return -1;
+        uint8_t code = data[p++];
+        // 熵编码数据中的填充和复位标记不是段
+        if (code == 0x00 || (code >= 0xD0 && code <= 0xD7)) continue;
+        *pos = p;
+        return code;
+    }
+}
+
+static bool is_sof(int marker) {
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+int image_jpeg_probe(const uint8_t* data, size_t size, image_header_t* header) {
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) return -1;
+    size_t pos = 2;
+    for (;;) {
+        int marker = next_marker(data, size, &pos);
+        if (marker < 0) return IMAGE_PROBE_NEED_MORE;
+        if (marker == 0xD9) return -1;
+        if (marker == 0xD8 || marker == 0x01) continue;
+        if (pos + 2 > size) return IMAGE_PROBE_NEED_MORE;
+        uint32_t len = image_read_be16(data + pos);
+        if (len < 2) return -1;
+        if (is_sof(marker)) {
+            if (pos + len > size) return IMAGE_PROBE_NEED_MORE;
+            memset(header, 0, sizeof(*header));
+            header->format = IMAGE_FORMAT_JPEG;
+            header->progressive = marker == 0xC2 || marker == 0xC6 || marker == 0xCA || marker == 0xCE;
+            return parse_sof(NULL, data + pos + 2, len - 2, header);
+        }
+        pos += len;
+    }
+}
+
+uint32_t image_jpeg_select_scale(uint32_t width, uint32_t height, uint32_t min_width, uint32_t min_height) {
+    for (uint32_t scale = 8; scale > 1; scale >>= 1) {
+        uint32_t w = (width + scale - 1) / scale;
+        uint32_t h = (height + scale - 1) / scale;
+        if (w >= min_width && h >= min_height) return scale;
+    }
+    return 1;
+}
+
+static void init_tables(jpeg_decoder_t* dec) {
+    dec->n = 8 / dec->scale;
+    // 输出 m 个像素时，第 x 个像素取 8 点余弦基在对应 8/m 个像素上的均值
+    const double pi = 3.14159265358979323846;
+    for (uint32_t index = 0; index < 4; index++) {
+        uint32_t m = 1u << index;
+        uint32_t group = 8 / m;
+        for (uint32_t x = 0; x < m; x++) {
+            for (uint32_t u = 0; u < 8; u++) {
+                double c = u == 0 ? sqrt(0.5) : 1.0;
+                double sum = 0.0;
+                for (uint32_t j = x * group; j < (x + 1) * group; j++) sum += cos((2 * j + 1) * u * pi / 16.0);
+                dec->idct_table[index][x * 8 + u] = (float)(c * sum / group / 2.0);
+            }
+        }
+    }
+    // JFIF 全范围 BT.601，16 位定点
+    for (int i = 0; i < 256; i++) {
+        int x = i - 128;
+        dec->cr_r[i] = (int32_t)lrint(1.40200 * x);
+        dec->cb_b[i] = (int32_t)lrint(1.77200 * x);
+        dec->cr_g[i] = (int32_t)lrint(-0.71414 * 65536.0 * x);
+        dec->cb_g[i] = (int32_t)lrint(-0.34414 * 65536.0 * x) + 32768;
+    }
+}
+
+int image_jpeg_decode(const uint8_t* data, size_t size, uint32_t scale, const image_sink_t* sink) {
+    if (!data || !sink || size < 4 || data[0] != 0xFF || data[1] != 0xD8) return -1;
+    if (scale != 1 && scale != 2 && scale != 4 && scale != 8) return -1;
+
+    jpeg_decoder_t* dec = calloc(1, sizeof(jpeg_decoder_t));
+    if (!dec) {
+        LOG_ERROR("JPEG 解码器分配失败");
+        return -1;
+    }
+    dec->data = data;
+    dec->size = size;
+    dec->sink = sink;
+    dec->scale = scale;
+    dec->adobe_transform = -1;
+    init_tables(dec);
+
+    int ret = 0;
+    size_t pos = 2;
+    bool done = false;
+    while (!done && ret == 0) {
+        int marker = next_marker(data, size, &pos);
+        if (marker < 0 || marker == 0xD9) {
+            // 缺少 EOI 的截断文件按已有数据输出
+            if (marker < 0 && !dec->scan_seen) {
+                LOG_ERROR("JPEG 数据不完整");
+                ret = -1;
+            }
+            done = true;
+            break;
+        }
+        if (marker == 0xD8 || marker == 0x01) continue;
+        if (pos + 2 > size) {
+            ret = -1;
+            break;
+        }
+        uint32_t len = image_read_be16(data + pos);
+        if (len < 2 || pos + len > size) {
+            LOG_ERROR("JPEG 段长度无效");
+            ret = -1;
+            break;
+        }
+        const uint8_t* payload = data + pos + 2;
+        uint32_t payload_len = len - 2;
+        pos += len;
+
+        switch (marker) {
+            case 0xDB:
+                ret = parse_dqt(dec, payload, payload_len);
+                break;
+            case 0xC4:
+                ret = parse_dht(dec, payload, payload_len);
+                break;
+            case 0xDD:
+                if (payload_len < 2) {
+                    ret = -1;
+                } else {
+                    dec->restart_interval = image_read_be16(payload);
+                }
+                break;
+            case 0xEE:
+                if (payload_len >= 12 && memcmp(payload, "Adobe", 5) == 0) dec->adobe_transform = payload[11];
+                break;
+            case 0xC0:
+            case 0xC1:
+            case 0xC2:
+                if (dec->frame_seen) {
+                    ret = -1;
+                    break;
+                }
+                dec->progressive = marker == 0xC2;
+                ret = parse_sof(dec, payload, payload_len, NULL);
+                break;
+            case 0xDA: {
+                if (!dec->frame_seen || dec->streamed) {
+                    LOG_ERROR("JPEG 扫描位置无效");
+                    ret = -1;
+                    break;
+                }
+                ret = parse_sos(dec, payload, payload_len);
+                if (ret != 0) break;
+                if (!dec->scan_seen) {
+                    // 第一个扫描包含全部分量的基线图像直接流式输出，否则缓存系数
+                    dec->buffered = dec->progressive || dec->scan_ncomp != dec->ncomp;
+                    dec->rgb = dec->ncomp == 3 &&
+                               (dec->adobe_transform == 0 ||
+                                (dec->adobe_transform < 0 && dec->comp[0].id == 'R' &&
+                                 dec->comp[1].id == 'G' && dec->comp[2].id == 'B'));
+                    if (dec->buffered) {
+                        ret = ensure_coeffs(dec);
+                    } else {
+                        prepare_dequant(dec);
+                    }
+                    if (ret != 0) break;
+                }
+                dec->scan_seen = true;
+                size_t end = pos;
+                ret = decode_scan(dec, pos, &end);
+                pos = end;
+                if (!dec->buffered) dec->streamed = true;
+                break;
+            }
+            default:
+                if (is_sof(marker)) {
+                    LOG_ERROR("不支持的 JPEG 编码方式（SOF%d）", marker - 0xC0);
+                    ret = -1;
+                }
+                break;
+        }
+    }
+
+    if (ret == 0 && !dec->scan_seen) {
+        LOG_ERROR("JPEG 没有图像数据");
+        ret = -1;
+    }
+    if (ret == 0 && dec->buffered) ret = render_buffered(dec);
+
+    for (uint32_t i = 0; i < JPEG_MAX_COMPONENTS; i++) {
+        free(dec->comp[i].coeffs);
+        free(dec->comp[i].plane);
+    }
+    free(dec->row);
+    free(dec);
+    return ret;
+}
@@ -0,0 +1,625 @@
+#include "utils/image_decode_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief PNG 解码（含 zlib/deflate 解压）
+ *
+ * IDAT 数据拼接后一次解压到过滤后的扫描行缓冲区，逐行反过滤、展开为 8 位原始通道后输出。
+ * 隔行图像的 7 个子图先合成到整幅图像再输出。不校验 CRC 和 Adler-32。
+ */
+
+#define PNG_COLOR_GRAY 0
+#define PNG_COLOR_RGB 2
+#define PNG_COLOR_PALETTE 3
+#define PNG_COLOR_GRAY_ALPHA 4
+#define PNG_COLOR_RGBA 6
+
+// ==================== inflate ====================
+
+#define INFLATE_FAST_BITS 9
+#define INFLATE_MAX_BITS 15
+
+/**
+ * @brief deflate 规范 Huffman 表：短码查表，长码按长度逐位比较
+ */
+typedef struct {
+    uint16_t fast[1 << INFLATE_FAST_BITS];  /**< (码长 << 9) | 符号，0 表示需要慢速路径 */
+    uint16_t count[INFLATE_MAX_BITS + 1];   /**< 各码长的符号数 */
+    uint16_t symbol[288];                   /**< 按码值排序的符号 */
+} inflate_huffman_t;
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint64_t buffer;                        /**< 低位先出 */
+    uint32_t count;
+    size_t overrun;                         /**< 数据结束后补入的零字节数 */
+} inflate_bits_t;
+
+typedef struct {
+    inflate_bits_t bits;
+    uint8_t* out;
+    size_t out_size;
+    size_t out_pos;
+    inflate_huffman_t lit;
+    inflate_huffman_t dist;
+} inflate_state_t;
+
+static const uint16_t k_length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t k_length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t k_dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t k_dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static inline void inflate_fill(inflate_bits_t* bits) {
+    while (bits->count <= 56) {
+        uint64_t byte = 0;
+        if (bits->pos < bits->size) {
+            byte = bits->data[bits->pos++];
+        } else {
+            bits->overrun++;
+        }
+        bits->buffer |= byte << bits->count;
+        bits->count += 8;
+    }
+}
+
+static inline uint32_t inflate_get(inflate_bits_t* bits, uint32_t n) {
+    if (n == 0) return 0;
+    if (bits->count < n) inflate_fill(bits);
+    uint32_t value = (uint32_t)(bits->buffer & ((1ull << n) - 1));
+    bits->buffer >>= n;
+    bits->count -= n;
+    return value;
+}
+
+static int inflate_build(inflate_huffman_t* table, const uint8_t* lengths, uint32_t count) {
+    memset(table->count, 0, sizeof(table->count));
+    for (uint32_t i = 0; i < count; i++) table->count[lengths[i]]++;
+    table->count[0] = 0;
+
+    // 码长超额（过度订阅）的表无效，不完整的表允许（只有一个距离码时常见）
+    int left = 1;
+    for (uint32_t len = 1; len <= INFLATE_MAX_BITS; len++) {
+        left <<= 1;
+        left -= table->count[len];
+        if (left < 0) return -1;
+    }
+
+    uint16_t offsets[INFLATE_MAX_BITS + 1];
+    uint16_t next_code[INFLATE_MAX_BITS + 1];
+    offsets[1] = 0;
+    next_code[1] = 0;
+    for (uint32_t len = 1; len < INFLATE_MAX_BITS; len++) {
+        offsets[len + 1] = (uint16_t)(offsets[len] + table->count[len]);
+        next_code[len + 1] = (uint16_t)((next_code[len] + table->count[len]) << 1);
+    }
+
+    memset(table->fast, 0, sizeof(table->fast));
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t len = lengths[i];
+        if (len == 0) continue;
+        table->symbol[offsets[len]++] = (uint16_t)i;
+
+        uint32_t code = next_code[len]++;
+        if (len > INFLATE_FAST_BITS) continue;
+        // deflate 的码按高位先写入低位先出的位流，查表时需要反转
+        uint32_t reversed = 0;
+        for (uint32_t b = 0; b < len; b++) reversed |= ((code >> b) & 1) << (len - 1 - b);
+        for (uint32_t j = reversed; j < (1u << INFLATE_FAST_BITS); j += 1u << len) {
+            table->fast[j] = (uint16_t)((len << 9) | i);
+        }
+    }
+    return 0;
+}
+
+static inline int inflate_decode(inflate_bits_t* bits, const inflate_huffman_t* table) {
+    if (bits->count < INFLATE_MAX_BITS) inflate_fill(bits);
+    uint32_t entry = table->fast[bits->buffer & ((1u << INFLATE_FAST_BITS) - 1)];
+    if (entry) {
+        uint32_t len = entry >> 9;
+        bits->buffer >>= len;
+        bits->count -= len;
+        return (int)(entry & 511);
+    }
+
+    // 慢速路径：逐位构造码值
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (uint32_t len = 1; len <= INFLATE_MAX_BITS; len++) {
+        code |= (int)((bits->buffer >> (len - 1)) & 1);
+        int count = table->count[len];
+        if (code - count < first) {
+            bits->buffer >>= len;
+            bits->count -= len;
+            return table->symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static int inflate_stored(inflate_state_t* state) {
+    inflate_bits_t* bits = &state->bits;
+    // 丢弃到字节边界，缓冲区中剩余的整字节退回
+    inflate_get(bits, bits->count & 7);
+    size_t buffered = bits->count / 8;
+    if (bits->overrun > buffered) return -1;
+    bits->pos -= buffered - bits->overrun;
+    bits->buffer = 0;
+    bits->count = 0;
+    bits->overrun = 0;
+
+    if (bits->pos + 4 > bits->size) return -1;
+    uint32_t len = image_read_le16(bits->data + bits->pos);
+    uint32_t nlen = image_read_le16(bits->data + bits->pos + 2);
+    if ((len ^ 0xFFFF) != nlen) return -1;
+    bits->pos += 4;
+    if (bits->pos + len > bits->size || state->out_pos + len > state->out_size) return -1;
+    memcpy(state->out + state->out_pos, bits->data + bits->pos, len);
+    bits->pos += len;
+    state->out_pos += len;
+    return 0;
+}
+
+static int inflate_codes(inflate_state_t* state) {
+    inflate_bits_t* bits = &state->bits;
+    uint8_t* out = state->out;
+    for (;;) {
+        int symbol = inflate_decode(bits, &state->lit);
+        if (symbol < 0 || bits->overrun > 8) return -1;
+        if (symbol < 256) {
+            if (state->out_pos >= state->out_size) return -1;
+            out[state->out_pos++] = (uint8_t)symbol;
+            continue;
+        }
+        if (symbol == 256) return 0;
+
+        symbol -= 257;
+        if (symbol >= 29) return -1;
+        uint32_t length = k_length_base[symbol] + inflate_get(bits, k_length_extra[symbol]);
+        int dist_symbol = inflate_decode(bits, &state->dist);
+        if (dist_symbol < 0 || dist_symbol >= 30) return -1;
+        size_t distance = k_dist_base[dist_symbol] + inflate_get(bits, k_dist_extra[dist_symbol]);
+        if (distance > state->out_pos || state->out_pos + length > state->out_size) return -1;
+
+        uint8_t* dst = out + state->out_pos;
+        const uint8_t* src = dst - distance;
+        if (distance >= length) {
+            memcpy(dst, src, length);
+        } else {
+            for (uint32_t i = 0; i < length; i++) dst[i] = src[i];
+        }
+        state->out_pos += length;
+    }
+}
+
+static int inflate_fixed(inflate_state_t* state) {
+    uint8_t lengths[288 + 30];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    memset(lengths + 288, 5, 30);
+    if (inflate_build(&state->lit, lengths, 288) != 0) return -1;
+    if (inflate_build(&state->dist, lengths + 288, 30) != 0) return -1;
+    return inflate_codes(state);
+}
+
+static int inflate_dynamic(inflate_state_t* state) {
+    static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    inflate_bits_t* bits = &state->bits;
+    uint32_t nlen = inflate_get(bits, 5) + 257;
+    uint32_t ndist = inflate_get(bits, 5) + 1;
+    uint32_t ncode = inflate_get(bits, 4) + 4;
+    if (nlen > 286 || ndist > 30) return -1;
+
+    uint8_t lengths[288 + 32];
+    memset(lengths, 0, sizeof(lengths));
+    for (uint32_t i = 0; i < ncode; i++) lengths[order[i]] = (uint8_t)inflate_get(bits, 3);
+    inflate_huffman_t code_table;
+    if (inflate_build(&code_table, lengths, 19) != 0) return -1;
+
+    memset(lengths, 0, sizeof(lengths));
+    uint32_t index = 0;
+    while (index < nlen + ndist) {
+        int symbol = inflate_decode(bits, &code_table);
+        if (symbol < 0 || bits->overrun > 8) return -1;
+        if (symbol < 16) {
+            lengths[index++] = (uint8_t)symbol;
+            continue;
+        }
+        uint8_t value = 0;
+        uint32_t repeat;
+        if (symbol == 16) {
+            if (index == 0) return -1;
+            value = lengths[index - 1];
+            repeat = 3 + inflate_get(bits, 2);
+        } else if (symbol == 17) {
+            repeat = 3 + inflate_get(bits, 3);
+        } else {
+            repeat = 11 + inflate_get(bits, 7);
+        }
+        if (index + repeat > nlen + ndist) return -1;
+        while (repeat--) lengths[index++] = value;
+    }
+    if (lengths[256] == 0) return -1;
+
+    if (inflate_build(&state->lit, lengths, nlen) != 0) return -1;
+    if (inflate_build(&state->dist, lengths + nlen, ndist) != 0) return -1;
+    return inflate_codes(state);
+}
+
+// 解压 zlib 流到 out，要求输出恰好填满
+static int zlib_inflate(const uint8_t* data, size_t size, uint8_t* out, size_t out_size) {
+    if (size < 2) return -1;
+    uint32_t cmf = data[0];
+    uint32_t flg = data[1];
+    if ((cmf & 15) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) return -1;
+
+    inflate_state_t* state = malloc(sizeof(inflate_state_t));
+    if (!state) return -1;
+    memset(&state->bits, 0, sizeof(state->bits));
+    state->bits.data = data;
+    state->bits.size = size;
+    state->bits.pos = 2;
+    state->out = out;
+    state->out_size = out_size;
+    state->out_pos = 0;
+
+    int ret = 0;
+    uint32_t final = 0;
+    while (!final && ret == 0) {
+        final = inflate_get(&state->bits, 1);
+        uint32_t type = inflate_get(&state->bits, 2);
+        if (type == 0) {
+            ret = inflate_stored(state);
+        } else if (type == 1) {
+            ret = inflate_fixed(state);
+        } else if (type == 2) {
+            ret = inflate_dynamic(state);
+        } else {
+            ret = -1;
+        }
+        if (state->bits.overrun > 8) ret = -1;
+    }
+    if (ret == 0 && state->out_pos != out_size) ret = -1;
+    free(state);
+    return ret;
+}
+
+// ==================== PNG ====================
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t bit_depth;
+    uint32_t color_type;
+    uint32_t interlace;
+    uint32_t samples;               /**< 每像素的样本数 */
+    uint32_t channels;              /**< 输出的 8 位通道数 */
+    uint8_t palette[256][4];
+    uint32_t palette_size;
+    bool has_trns;
+    uint16_t trns[3];               /**< 灰度/RGB 的透明色 */
+} png_info_t;
+
+static int png_parse_ihdr(const uint8_t* data, size_t size, png_info_t* info) {
+    if (size < 33 || memcmp(data, "\x89PNG\r\n\x1a\n", 8) != 0) return -1;
+    if (image_read_be32(data + 8) != 13 || memcmp(data + 12, "IHDR", 4) != 0) return -1;
+    const uint8_t* p = data + 16;
+    memset(info, 0, sizeof(*info));
+    info->width = image_read_be32(p);
+    info->height = image_read_be32(p + 4);
+    info->bit_depth = p[8];
+    info->color_type = p[9];
+    info->interlace = p[12];
+    if (info->width == 0 || info->height == 0 || info->width > (1u << 24) || info->height > (1u << 24)) return -1;
+    if (p[10] != 0 || p[11] != 0 || info->interlace > 1) return -1;
+
+    uint32_t depth = info->bit_depth;
+    switch (info->color_type) {
+        case PNG_COLOR_GRAY:
+            info->samples = 1;
+            if (depth != 1 && depth != 2 && depth != 4 && depth != 8 && depth != 16) return -1;
+            break;
+        case PNG_COLOR_PALETTE:
+            info->samples = 1;
+            if (depth != 1 && depth != 2 && depth != 4 && depth != 8) return -1;
+            break;
+        case PNG_COLOR_RGB:
+            info->samples = 3;
+            if (depth != 8 && depth != 16) return -1;
+            break;
+        case PNG_COLOR_GRAY_ALPHA:
+            info->samples = 2;
+            if (depth != 8 && depth != 16) return -1;
+            break;
+        case PNG_COLOR_RGBA:
+            info->samples = 4;
+            if (depth != 8 && depth != 16) return -1;
+            break;
+        default:
+            return -1;
+    }
+    info->channels = info->color_type == PNG_COLOR_PALETTE ? 3 : info->samples;
+    return 0;
+}
+
+int image_png_probe(const uint8_t* data, size_t size, image_header_t* header) {
+    png_info_t info;
+    if (png_parse_ihdr(data, size, &info) != 0) return -1;
+    memset(header, 0, sizeof(*header));
+    header->format = IMAGE_FORMAT_PNG;
+    header->width = info.width;
+    header->height = info.height;
+    header->channels = info.channels;
+    header->bit_depth = info.bit_depth;
+    header->progressive = info.interlace != 0;
+
+    // tRNS 位于 IDAT 之前，存在时输出增加透明通道
+    size_t pos = 8;
+    while (pos + 8 <= size) {
+        uint32_t len = image_read_be32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        if (memcmp(type, "IDAT", 4) == 0 || memcmp(type, "IEND", 4) == 0) break;
+        if (memcmp(type, "tRNS", 4) == 0 && (info.channels == 1 || info.channels == 3)) header->channels++;
+        if (len > size - pos - 12) break;
+        pos += 12 + (size_t)len;
+    }
+    return 0;
+}
+
+static inline uint32_t paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return (uint32_t)a;
+    return (uint32_t)(pb <= pc ? b : c);
+}
+
+// 反过滤一行：prior 为上一行（第一行为全零）
+static int png_unfilter(uint8_t filter, uint8_t* row, const uint8_t* prior, size_t length, size_t bpp) {
+    switch (filter) {
+        case 0:
+            break;
+        case 1:
+            for (size_t i = bpp; i < length; i++) row[i] = (uint8_t)(row[i] + row[i - bpp]);
+            break;
+        case 2:
+            for (size_t i = 0; i < length; i++) row[i] = (uint8_t)(row[i] + prior[i]);
+            break;
+        case 3:
+            for (size_t i = 0; i < bpp; i++) row[i] = (uint8_t)(row[i] + (prior[i] >> 1));
+            for (size_t i = bpp; i < length; i++) {
+                row[i] = (uint8_t)(row[i] + ((row[i - bpp] + prior[i]) >> 1));
+            }
+            break;
+        case 4:
+            for (size_t i = 0; i < bpp; i++) row[i] = (uint8_t)(row[i] + prior[i]);
+            for (size_t i = bpp; i < length; i++) {
+                row[i] = (uint8_t)(row[i] + paeth(row[i - bpp], prior[i], prior[i - bpp]));
+            }
+            break;
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+static inline uint32_t png_sample(const uint8_t* row, uint32_t index, uint32_t depth) {
+    if (depth == 8) return row[index];
+    if (depth == 16) return image_read_be16(row + index * 2);
+    uint32_t bit = index * depth;
+    return (row[bit >> 3] >> (8 - depth - (bit & 7))) & ((1u << depth) - 1);
+}
+
+// 反过滤后的一行展开为 8 位原始通道（调色板查表、低位深放大、16 位取高字节、tRNS 转透明通道）
+static void png_expand_row(const png_info_t* info, const uint8_t* row, uint32_t width, uint8_t* out) {
+    uint32_t depth = info->bit_depth;
+    uint32_t channels = info->channels;
+
+    if (info->color_type == PNG_COLOR_PALETTE) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t index = png_sample(row, x, depth);
+            const uint8_t* entry = info->palette[index < info->palette_size ? index : 0];
+            memcpy(out + (size_t)x * channels, entry, channels);
+        }
+        return;
+    }
+
+    uint32_t samples = info->samples;
+    uint32_t scale = depth < 8 ? 255 / ((1u << depth) - 1) : 1;
+    for (uint32_t x = 0; x < width; x++) {
+        uint8_t* d = out + (size_t)x * channels;
+        bool transparent = info->has_trns;
+        for (uint32_t s = 0; s < samples; s++) {
+            uint32_t value = png_sample(row, x * samples + s, depth);
+            if (transparent && value != info->trns[s]) transparent = false;
+            if (depth == 16) {
+                d[s] = (uint8_t)(value >> 8);
+            } else {
+                d[s] = (uint8_t)(value * scale);
+            }
+        }
+        if (info->has_trns) d[samples] = transparent ? 0 : 255;
+    }
+}
+
+static size_t png_row_bytes(const png_info_t* info, uint32_t width) {
+    return ((size_t)width * info->samples * info->bit_depth + 7) / 8;
+}
+
+static int png_parse_chunks(const uint8_t* data, size_t size, png_info_t* info, uint8_t** idat, size_t* idat_size) {
+    // 先统计 IDAT 总长度，再一次性拼接
+    size_t total = 0;
+    size_t pos = 8;
+    while (pos + 12 <= size) {
+        uint32_t len = image_read_be32(data + pos);
+        if (len > size - pos - 12) return -1;
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* payload = data + pos + 8;
+        if (memcmp(type, "IEND", 4) == 0) break;
+
+        if (memcmp(type, "IDAT", 4) == 0) {
+            total += len;
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            if (len % 3 != 0 || len / 3 > 256) return -1;
+            info->palette_size = len / 3;
+            for (uint32_t i = 0; i < info->palette_size; i++) {
+                info->palette[i][0] = payload[i * 3];
+                info->palette[i][1] = payload[i * 3 + 1];
+                info->palette[i][2] = payload[i * 3 + 2];
+                info->palette[i][3] = 255;
+            }
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            if (info->color_type == PNG_COLOR_PALETTE) {
+                for (uint32_t i = 0; i < len && i < 256; i++) info->palette[i][3] = payload[i];
+                info->has_trns = true;
+            } else if (info->color_type == PNG_COLOR_GRAY && len >= 2) {
+                info->trns[0] = (uint16_t)image_read_be16(payload);
+                info->has_trns = true;
+            } else if (info->color_type == PNG_COLOR_RGB && len >= 6) {
+                for (uint32_t i = 0; i < 3; i++) info->trns[i] = (uint16_t)image_read_be16(payload + i * 2);
+                info->has_trns = true;
+            }
+        }
+        pos += 12 + (size_t)len;
+    }
+
+    if (info->color_type == PNG_COLOR_PALETTE && info->palette_size == 0) {
+        LOG_ERROR("PNG 缺少调色板");
+        return -1;
+    }
+    if (info->has_trns) info->channels++;
+    if (total == 0) {
+        LOG_ERROR("PNG 没有图像数据");
+        return -1;
+    }
+
+    uint8_t* buffer = malloc(total);
+    if (!buffer) return -1;
+    size_t offset = 0;
+    pos = 8;
+    while (pos + 12 <= size && offset < total) {
+        uint32_t len = image_read_be32(data + pos);
+        if (memcmp(data + pos + 4, "IDAT", 4) == 0) {
+            memcpy(buffer + offset, data + pos + 8, len);
+            offset += len;
+        }
+        pos += 12 + (size_t)len;
+    }
+    *idat = buffer;
+    *idat_size = total;
+    return 0;
+}
+
+int image_png_decode(const uint8_t* data, size_t size, const image_sink_t* sink) {
+    png_info_t info;
+    if (png_parse_ihdr(data, size, &info) != 0) {
+        LOG_ERROR("PNG 文件头无效");
+        return -1;
+    }
+
+    uint8_t* idat = NULL;
+    size_t idat_size = 0;
+    if (png_parse_chunks(data, size, &info, &idat, &idat_size) != 0) {
+        LOG_ERROR("PNG 数据块无效");
+        return -1;
+    }
+
+    static const uint32_t adam7[7][4] = {
+        {0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}
+    };
+    uint32_t passes = info.interlace ? 7 : 1;
+    uint32_t pass_width[7], pass_height[7];
+    size_t raw_size = 0;
+    for (uint32_t p = 0; p < passes; p++) {
+        if (info.interlace) {
+            pass_width[p] = info.width > adam7[p][0] ? (info.width - adam7[p][0] + adam7[p][2] - 1) / adam7[p][2] : 0;
+            pass_height[p] = info.height > adam7[p][1] ? (info.height - adam7[p][1] + adam7[p][3] - 1) / adam7[p][3] : 0;
+        } else {
+            pass_width[p] = info.width;
+            pass_height[p] = info.height;
+        }
+        if (pass_width[p] && pass_height[p]) raw_size += (png_row_bytes(&info, pass_width[p]) + 1) * pass_height[p];
+    }
+
+    uint8_t* raw = malloc(raw_size);
+    size_t row_bytes = png_row_bytes(&info, info.width);
+    uint8_t* prior = calloc(row_bytes + 1, 1);
+    uint8_t* line = malloc((size_t)info.width * info.channels);
+    uint8_t* image = NULL;
+    int ret = raw && prior && line ? 0 : -1;
+    if (ret == 0 && zlib_inflate(idat, idat_size, raw, raw_size) != 0) {
+        LOG_ERROR("PNG 压缩数据损坏");
+        ret = -1;
+    }
+    free(idat);
+
+    if (ret == 0 && info.interlace) {
+        image = malloc((size_t)info.width * info.height * info.channels);
+        if (!image) ret = -1;
+    }
+    if (ret == 0) ret = sink->begin(sink->context, info.width, info.height, info.channels);
+
+    size_t bpp = (info.samples * info.bit_depth + 7) / 8;
+    uint8_t* src = raw;
+    for (uint32_t p = 0; p < passes && ret == 0; p++) {
+        if (pass_width[p] == 0 || pass_height[p] == 0) continue;
+        size_t length = png_row_bytes(&info, pass_width[p]);
+        memset(prior, 0, length);
+        for (uint32_t y = 0; y < pass_height[p] && ret == 0; y++) {
+            uint8_t* row = src + 1;
+            if (png_unfilter(src[0], row, prior, length, bpp) != 0) {
+                LOG_ERROR("PNG 过滤类型无效: %u", src[0]);
+                ret = -1;
+                break;
+            }
+
+            if (!info.interlace) {
+                png_expand_row(&info, row, info.width, line);
+                ret = sink->row(sink->context, y, line);
+            } else {
+                // 子图像素散布到整幅图像
+                png_expand_row(&info, row, pass_width[p], line);
+                uint8_t* dst = image + ((size_t)(adam7[p][1] + y * adam7[p][3]) * info.width) * info.channels;
+                for (uint32_t x = 0; x < pass_width[p]; x++) {
+                    memcpy(dst + (size_t)(adam7[p][0] + x * adam7[p][2]) * info.channels,
+                           line + (size_t)x * info.channels, info.channels);
+                }
+            }
+            memcpy(prior, row, length);
+            src += length + 1;
+        }
+    }
+
+    if (ret == 0 && info.interlace) {
+        for (uint32_t y = 0; y < info.height && ret == 0; y++) {
+            ret = sink->row(sink->context, y, image + (size_t)y * info.width * info.channels);
+        }
+    }
+
+    free(raw);
+    free(prior);
+    free(line);
+    free(image);
+    return ret;
+}
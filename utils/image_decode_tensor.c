@@ -0,0 +1,378 @@
+#include "utils/image_decode_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 解码结果直接写入目标张量
+ *
+ * 每个到达的源行先做通道转换和水平缩放，存入按行号奇偶交替的两行浮点缓冲；
+ * 某个输出行依赖的两行源数据到齐后立即垂直插值、归一化并按目标类型和布局写出。
+ * 缩放映射与预处理 RESIZE 的双线性插值一致（像素中心对齐）。
+ */
+
+/**
+ * @brief 逐行写出状态
+ */
+typedef struct {
+    const image_tensor_layout_t* layout;
+    Tensor* output;
+    bool allocated;                 /**< 输出缓冲区由本次调用分配 */
+    uint32_t src_width;
+    uint32_t src_height;
+    uint32_t src_channels;
+    uint32_t width;                 /**< 输出尺寸 */
+    uint32_t height;
+    uint32_t channels;
+    TensorDataType dtype;
+    bool resize_x;
+    uint32_t* x0;                   /**< 水平映射：两个源列及权重 */
+    uint32_t* x1;
+    float* wx;
+    uint32_t* y0;                   /**< 垂直映射：两个源行及权重 */
+    uint32_t* y1;
+    float* wy;
+    uint8_t* needed;                /**< 源行是否被某个输出行引用 */
+    uint8_t* pixels;                /**< 通道转换后的一行 */
+    float* rows[2];                 /**< 水平缩放后的源行，按源行号奇偶存放 */
+    uint32_t next_row;              /**< 下一个待写出的输出行 */
+    int64_t last_row;               /**< 最近到达的源行 */
+    float scale[4];
+    float bias[4];
+} tensor_writer_t;
+
+// IEEE 754 单精度转半精度，就近舍入到偶数；非规格化结果借助浮点加法完成舍入
+static inline uint16_t float_to_half(float value) {
+    const uint32_t infinity = 255u << 23;
+    const uint32_t half_overflow = (127u + 16) << 23;
+    const uint32_t denormal_limit = 113u << 23;
+    const uint32_t magic_bits = ((127u - 15) + (23 - 10) + 1) << 23;
+    float magic;
+    memcpy(&magic, &magic_bits, sizeof(magic));
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint16_t half;
+    if (bits >= half_overflow) {
+        // 溢出为无穷大，NaN 保持为 NaN
+        half = bits > infinity ? 0x7E00 : 0x7C00;
+    } else if (bits < denormal_limit) {
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        f += magic;
+        memcpy(&bits, &f, sizeof(bits));
+        half = (uint16_t)(bits - magic_bits);
+    } else {
+        uint32_t odd = (bits >> 13) & 1;
+        bits += ((uint32_t)(15 - 127) << 23) + 0xFFF + odd;
+        half = (uint16_t)(bits >> 13);
+    }
+    return (uint16_t)(half | (sign >> 16));
+}
+
+static bool layout_valid(const image_tensor_layout_t* layout) {
+    if (layout->format != TENSOR_FORMAT_NCHW && layout->format != TENSOR_FORMAT_NHWC) {
+        LOG_ERROR("图像张量只支持 NCHW 或 NHWC 布局");
+        return false;
+    }
+    if (layout->dtype != TENSOR_TYPE_UNKNOWN && layout->dtype != TENSOR_TYPE_FLOAT32 &&
+        layout->dtype != TENSOR_TYPE_FLOAT16 && layout->dtype != TENSOR_TYPE_UINT8) {
+        LOG_ERROR("图像张量只支持 FLOAT32、FLOAT16 或 UINT8 输出");
+        return false;
+    }
+    uint32_t channels = layout->channels;
+    if (channels != 0 && channels != 1 && channels != 3 && channels != 4) {
+        LOG_ERROR("不支持的输出通道数: %u", channels);
+        return false;
+    }
+    return true;
+}
+
+int image_tensor_layout_shape(const image_tensor_layout_t* layout, const image_header_t* header,
+                              TensorShape* shape, size_t* bytes) {
+    if (!layout || !layout_valid(layout)) return -1;
+    uint32_t width = layout->width ? layout->width : (header ? header->width : 0);
+    uint32_t height = layout->height ? layout->height : (header ? header->height : 0);
+    uint32_t channels = layout->channels ? layout->channels : (header ? header->channels : 0);
+    if (width == 0 || height == 0 || channels == 0) return -1;
+
+    TensorDataType dtype = layout->dtype == TENSOR_TYPE_UNKNOWN ? TENSOR_TYPE_FLOAT32 : layout->dtype;
+    if (shape) {
+        uint32_t nchw[] = {1, channels, height, width};
+        uint32_t nhwc[] = {1, height, width, channels};
+        *shape = tensor_shape_create(layout->format == TENSOR_FORMAT_NCHW ? nchw : nhwc, 4);
+    }
+    if (bytes) *bytes = (size_t)width * height * channels * tensor_get_dtype_size(dtype);
+    return 0;
+}
+
+// 一个轴上输出坐标到两个源坐标的映射
+static void build_axis(uint32_t out_len, uint32_t src_len, uint32_t* i0, uint32_t* i1, float* w) {
+    float scale = (float)src_len / out_len;
+    for (uint32_t i = 0; i < out_len; i++) {
+        if (out_len == src_len) {
+            i0[i] = i1[i] = i;
+            w[i] = 0.0f;
+            continue;
+        }
+        float f = (i + 0.5f) * scale - 0.5f;
+        if (f < 0.0f) f = 0.0f;
+        uint32_t a = (uint32_t)f;
+        if (a > src_len - 1) a = src_len - 1;
+        i0[i] = a;
+        i1[i] = a + 1 < src_len ? a + 1 : src_len - 1;
+        w[i] = f - a;
+    }
+}
+
+static void writer_release(tensor_writer_t* writer) {
+    free(writer->x0);
+    free(writer->x1);
+    free(writer->wx);
+    free(writer->y0);
+    free(writer->y1);
+    free(writer->wy);
+    free(writer->needed);
+    free(writer->pixels);
+    free(writer->rows[0]);
+    free(writer->rows[1]);
+}
+
+static int writer_begin(void* context, uint32_t width, uint32_t height, uint32_t channels) {
+    tensor_writer_t* writer = (tensor_writer_t*)context;
+    const image_tensor_layout_t* layout = writer->layout;
+    Tensor* output = writer->output;
+
+    image_header_t header = {0};
+    header.width = width;
+    header.height = height;
+    header.channels = channels;
+    TensorShape shape;
+    size_t size;
+    if (image_tensor_layout_shape(layout, &header, &shape, &size) != 0) return -1;
+
+    writer->src_width = width;
+    writer->src_height = height;
+    writer->src_channels = channels;
+    writer->width = layout->width ? layout->width : width;
+    writer->height = layout->height ? layout->height : height;
+    writer->channels = layout->channels ? layout->channels : channels;
+    writer->dtype = layout->dtype == TENSOR_TYPE_UNKNOWN ? TENSOR_TYPE_FLOAT32 : layout->dtype;
+    writer->resize_x = writer->width != width;
+    writer->last_row = -1;
+
+    // (pixel * scale - mean) / std 改写为 pixel * scale' + bias
+    float scale = layout->scale != 0.0f ? layout->scale : 1.0f;
+    for (uint32_t c = 0; c < 4; c++) {
+        if (writer->dtype == TENSOR_TYPE_UINT8) {
+            writer->scale[c] = 1.0f;
+            writer->bias[c] = 0.0f;
+            continue;
+        }
+        float std = layout->std[c] != 0.0f ? layout->std[c] : 1.0f;
+        writer->scale[c] = scale / std;
+        writer->bias[c] = -layout->mean[c] / std;
+    }
+
+    size_t row_floats = (size_t)writer->width * writer->channels;
+    writer->x0 = malloc(writer->width * sizeof(uint32_t));
+    writer->x1 = malloc(writer->width * sizeof(uint32_t));
+    writer->wx = malloc(writer->width * sizeof(float));
+    writer->y0 = malloc(writer->height * sizeof(uint32_t));
+    writer->y1 = malloc(writer->height * sizeof(uint32_t));
+    writer->wy = malloc(writer->height * sizeof(float));
+    writer->needed = calloc(height, 1);
+    writer->pixels = malloc((size_t)width * writer->channels);
+    writer->rows[0] = malloc(row_floats * sizeof(float));
+    writer->rows[1] = malloc(row_floats * sizeof(float));
+    if (!writer->x0 || !writer->x1 || !writer->wx || !writer->y0 || !writer->y1 || !writer->wy ||
+        !writer->needed || !writer->pixels || !writer->rows[0] || !writer->rows[1]) {
+        LOG_ERROR("图像行缓冲区分配失败");
+        return -1;
+    }
+
+    build_axis(writer->width, width, writer->x0, writer->x1, writer->wx);
+    build_axis(writer->height, height, writer->y0, writer->y1, writer->wy);
+    for (uint32_t y = 0; y < writer->height; y++) {
+        writer->needed[writer->y0[y]] = 1;
+        writer->needed[writer->y1[y]] = 1;
+    }
+
+    if (output->data) {
+        if (output->size < size) {
+            LOG_ERROR("输出缓冲区不足（需要 %zu 字节，实际 %zu 字节）", size, output->size);
+            return -1;
+        }
+    } else {
+        output->data = malloc(size);
+        if (!output->data) {
+            LOG_ERROR("图像张量分配失败（%zu 字节）", size);
+            return -1;
+        }
+        output->owns_data = true;
+        output->memory_type = TENSOR_MEMORY_CPU;
+        writer->allocated = true;
+    }
+    output->size = size;
+    output->shape = shape;
+    output->dtype = writer->dtype;
+    output->format = layout->format;
+    return 0;
+}
+
+// 垂直插值并写出第 y 个输出行
+static void writer_emit(tensor_writer_t* writer, uint32_t y) {
+    const float* top = writer->rows[writer->y0[y] & 1];
+    const float* bottom = writer->rows[writer->y1[y] & 1];
+    float t = writer->wy[y];
+    uint32_t width = writer->width;
+    uint32_t channels = writer->channels;
+    bool nchw = writer->output->format == TENSOR_FORMAT_NCHW;
+    size_t plane = (size_t)writer->height * width;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        // NCHW 每个通道写连续的一段，NHWC 按通道数跨步写
+        size_t base = nchw ? c * plane + (size_t)y * width : (size_t)y * width * channels + c;
+        size_t step = nchw ? 1 : channels;
+        float scale = writer->scale[c];
+        float bias = writer->bias[c];
+        const float* a = top + c;
+        const float* b = bottom + c;
+
+        switch (writer->dtype) {
+            case TENSOR_TYPE_FLOAT32: {
+                float* dst = (float*)writer->output->data + base;
+                for (uint32_t x = 0; x < width; x++) {
+                    size_t i = (size_t)x * channels;
+                    float v = a[i] + (b[i] - a[i]) * t;
+                    dst[x * step] = v * scale + bias;
+                }
+                break;
+            }
+            case TENSOR_TYPE_FLOAT16: {
+                uint16_t* dst = (uint16_t*)writer->output->data + base;
+                for (uint32_t x = 0; x < width; x++) {
+                    size_t i = (size_t)x * channels;
+                    float v = a[i] + (b[i] - a[i]) * t;
+                    dst[x * step] = float_to_half(v * scale + bias);
+                }
+                break;
+            }
+            default: {
+                uint8_t* dst = (uint8_t*)writer->output->data + base;
+                for (uint32_t x = 0; x < width; x++) {
+                    size_t i = (size_t)x * channels;
+                    float v = a[i] + (b[i] - a[i]) * t + 0.5f;
+                    dst[x * step] = v <= 0.0f ? 0 : v >= 255.0f ? 255 : (uint8_t)v;
+                }
+                break;
+            }
+        }
+    }
+}
+
+static int writer_row(void* context, uint32_t y, const uint8_t* row) {
+    tensor_writer_t* writer = (tensor_writer_t*)context;
+    if (y >= writer->src_height || (int64_t)y <= writer->last_row) return -1;
+    writer->last_row = y;
+    if (!writer->needed[y]) return 0;
+
+    uint32_t channels = writer->channels;
+    const uint8_t* pixels = row;
+    if (writer->src_channels != channels) {
+        image_convert_channels(row, writer->src_channels, writer->pixels, channels, writer->src_width);
+        pixels = writer->pixels;
+    }
+
+    // 水平缩放到输出宽度
+    float* dst = writer->rows[y & 1];
+    if (!writer->resize_x) {
+        size_t count = (size_t)writer->width * channels;
+        for (size_t i = 0; i < count; i++) dst[i] = pixels[i];
+    } else {
+        for (uint32_t x = 0; x < writer->width; x++) {
+            const uint8_t* p0 = pixels + (size_t)writer->x0[x] * channels;
+            const uint8_t* p1 = pixels + (size_t)writer->x1[x] * channels;
+            float w = writer->wx[x];
+            float* d = dst + (size_t)x * channels;
+            for (uint32_t c = 0; c < channels; c++) {
+                d[c] = p0[c] + (float)(p1[c] - p0[c]) * w;
+            }
+        }
+    }
+
+    // 相邻输出行的源行最多相差 1，第二个源行到达时两行都在缓冲中
+    while (writer->next_row < writer->height && writer->y1[writer->next_row] <= y) {
+        writer_emit(writer, writer->next_row++);
+    }
+    return 0;
+}
+
+// 检查输出是否写满，失败时释放本次分配的输出
+static int writer_finish(tensor_writer_t* writer, int ret) {
+    if (ret == 0 && (writer->height == 0 || writer->next_row < writer->height)) {
+        LOG_ERROR("图像数据不完整（输出 %u/%u 行）", writer->next_row, writer->height);
+        ret = -1;
+    }
+    if (ret != 0 && writer->allocated) {
+        free(writer->output->data);
+        writer->output->data = NULL;
+        writer->output->size = 0;
+        writer->output->owns_data = false;
+    }
+    writer_release(writer);
+    return ret;
+}
+
+int image_decode_memory_to_tensor(const void* data, size_t size, const image_tensor_layout_t* layout,
+                                  Tensor* output) {
+    if (!data || !layout || !output || !layout_valid(layout)) return -1;
+
+    tensor_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.layout = layout;
+    writer.output = output;
+    image_sink_t sink = {
+        .begin = writer_begin,
+        .row = writer_row,
+        .context = &writer
+    };
+
+    int ret = image_decode_to_sink((const uint8_t*)data, size, layout->width, layout->height, &sink);
+    return writer_finish(&writer, ret);
+}
+
+int image_decode_file_to_tensor(const char* path, const image_tensor_layout_t* layout, Tensor* output) {
+    if (!path || !layout || !output) return -1;
+    size_t size = 0;
+    uint8_t* data = image_read_file(path, 0, &size);
+    if (!data) return -1;
+
+    int ret = image_decode_memory_to_tensor(data, size, layout, output);
+    free(data);
+    if (ret != 0) LOG_ERROR("图像解码失败: %s", path);
+    return ret;
+}
+
+int image_pixels_to_tensor(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels,
+                           size_t stride, const image_tensor_layout_t* layout, Tensor* output) {
+    if (!pixels || !layout || !output || width == 0 || height == 0 || channels == 0 || channels > 4) {
+        return -1;
+    }
+    if (!layout_valid(layout)) return -1;
+    if (stride == 0) stride = (size_t)width * channels;
+
+    tensor_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.layout = layout;
+    writer.output = output;
+
+    int ret = writer_begin(&writer, width, height, channels);
+    for (uint32_t y = 0; y < height && ret == 0; y++) {
+        ret = writer_row(&writer, y, pixels + stride * y);
+    }
+    return writer_finish(&writer, ret);
+}
@@ -0,0 +1,375 @@
+#include "utils/image_loader.h"
+#include "utils/image_decode.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief 批量图像加载器实现
+ *
+ * 第 b 个批次固定使用第 b % window 个缓冲区。工作线程按路径顺序领取图像，
+ * 只有目标缓冲区空闲或正在装填同一批次时才能领取，因此预取量不超过窗口大小。
+ */
+
+#define IMAGE_LOADER_MAX_WORKERS 64
+
+/**
+ * @brief 批次缓冲区状态
+ */
+typedef enum {
+    SLOT_FREE = 0,                  /**< 空闲 */
+    SLOT_LOADING,                   /**< 正在装填 */
+    SLOT_READY,                     /**< 装填完成，等待取出 */
+    SLOT_IN_USE                     /**< 已交给调用者 */
+} slot_state_e;
+
+/**
+ * @brief 批次缓冲区
+ */
+typedef struct {
+    void* data;
+    memory_handle_t handle;         /**< 从内存池分配时的句柄 */
+    slot_state_e state;
+    uint32_t batch;                 /**< 当前装填或持有的批次 */
+    uint32_t pending;               /**< 尚未完成的样本数 */
+    uint32_t failed;
+    uint32_t* indices;
+    bool* valid;
+} loader_slot_t;
+
+/**
+ * @brief 加载器内部结构
+ */
+struct image_loader_internal_t {
+    char** paths;
+    uint32_t count;
+    image_loader_config_t config;
+    ImageProcessConfig process;     /**< 工作线程使用的单张配置（不使用内存池） */
+    uint32_t batch_size;
+    uint32_t batch_count;
+    uint32_t window;
+    TensorShape sample_shape;
+    size_t sample_bytes;
+    loader_slot_t* slots;
+
+    pthread_t workers[IMAGE_LOADER_MAX_WORKERS];
+    uint32_t worker_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond;       /**< 工作线程等待可领取的图像 */
+    pthread_cond_t ready_cond;      /**< 调用者等待批次就绪 */
+    bool shutdown;
+
+    uint32_t next_image;            /**< 下一个待领取的图像 */
+    uint32_t next_batch;            /**< 按顺序返回时下一个批次 */
+    uint32_t returned;              /**< 已返回的批次数 */
+    image_loader_stats_t stats;
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static uint32_t batch_length(const image_loader_t loader, uint32_t batch) {
+    uint32_t begin = batch * loader->batch_size;
+    uint32_t end = begin + loader->batch_size;
+    return (end > loader->count ? loader->count : end) - begin;
+}
+
+// 领取下一张图像（调用方持有锁），没有可领取的图像时返回 false
+static bool claim_image(image_loader_t loader, uint32_t* image) {
+    if (loader->next_image >= loader->count) return false;
+
+    uint32_t batch = loader->next_image / loader->batch_size;
+    loader_slot_t* slot = &loader->slots[batch % loader->window];
+    if (slot->state == SLOT_FREE) {
+        slot->state = SLOT_LOADING;
+        slot->batch = batch;
+        slot->pending = batch_length(loader, batch);
+        slot->failed = 0;
+    } else if (slot->state != SLOT_LOADING || slot->batch != batch) {
+        return false;
+    }
+
+    *image = loader->next_image++;
+    return true;
+}
+
+static void* worker_thread(void* arg) {
+    image_loader_t loader = (image_loader_t)arg;
+
+    pthread_mutex_lock(&loader->mutex);
+    while (true) {
+        uint32_t image = 0;
+        bool claimed = false;
+        while (!loader->shutdown && loader->next_image < loader->count &&
+               !(claimed = claim_image(loader, &image))) {
+            pthread_cond_wait(&loader->work_cond, &loader->mutex);
+        }
+        if (!claimed) break;
+
+        uint32_t batch = image / loader->batch_size;
+        uint32_t position = image % loader->batch_size;
+        loader_slot_t* slot = &loader->slots[batch % loader->window];
+        pthread_mutex_unlock(&loader->mutex);
+
+        // 直接解码到批量张量中该样本的位置
+        Tensor sample = {0};
+        sample.data = (uint8_t*)slot->data + loader->sample_bytes * position;
+        sample.size = loader->sample_bytes;
+        double start = now_ms();
+        bool ok = image_utils_load_into(loader->paths[image], &loader->process, &sample, NULL) == 0;
+        if (!ok) memset(sample.data, 0, loader->sample_bytes);
+        double elapsed = now_ms() - start;
+
+        pthread_mutex_lock(&loader->mutex);
+        slot->indices[position] = image;
+        slot->valid[position] = ok;
+        loader->stats.load_ms += elapsed;
+        if (ok) {
+            loader->stats.images_loaded++;
+        } else {
+            slot->failed++;
+            loader->stats.images_failed++;
+        }
+        if (--slot->pending == 0) {
+            slot->state = SLOT_READY;
+            pthread_cond_broadcast(&loader->ready_cond);
+        }
+    }
+    pthread_mutex_unlock(&loader->mutex);
+    return NULL;
+}
+
+static void free_slots(image_loader_t loader) {
+    if (!loader->slots) return;
+    for (uint32_t i = 0; i < loader->window; i++) {
+        loader_slot_t* slot = &loader->slots[i];
+        if (slot->handle) {
+            memory_pool_free(loader->config.process.memory_pool, slot->handle);
+        } else {
+            free(slot->data);
+        }
+        free(slot->indices);
+        free(slot->valid);
+    }
+    free(loader->slots);
+    loader->slots = NULL;
+}
+
+static int alloc_slots(image_loader_t loader) {
+    loader->slots = calloc(loader->window, sizeof(loader_slot_t));
+    if (!loader->slots) return -1;
+
+    memory_pool_t pool = loader->config.process.memory_pool;
+    size_t bytes = loader->sample_bytes * loader->batch_size;
+    for (uint32_t i = 0; i < loader->window; i++) {
+        loader_slot_t* slot = &loader->slots[i];
+        if (pool) {
+            slot->handle = memory_pool_alloc(pool, bytes, 64, "image_batch");
+            slot->data = slot->handle ? memory_handle_get_ptr(slot->handle) : NULL;
+        } else {
+            slot->data = malloc(bytes);
+        }
+        slot->indices = calloc(loader->batch_size, sizeof(uint32_t));
+        slot->valid = calloc(loader->batch_size, sizeof(bool));
+        if (!slot->data || !slot->indices || !slot->valid) {
+            LOG_ERROR("批次缓冲区分配失败（%zu 字节）", bytes);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+image_loader_t image_loader_create(const char* const* paths, uint32_t count, const image_loader_config_t* config) {
+    if (!paths || count == 0 || !config || config->batch_size == 0) {
+        LOG_ERROR("批量加载参数无效");
+        return NULL;
+    }
+
+    const ImageProcessConfig* process = &config->process;
+    if (process->target_width == 0 || process->target_height == 0 ||
+        (process->target_channels != 1 && process->target_channels != 3 && process->target_channels != 4)) {
+        LOG_ERROR("批量加载需要指定目标宽、高和通道数（1、3、4）");
+        return NULL;
+    }
+
+    image_tensor_layout_t layout = {0};
+    layout.width = process->target_width;
+    layout.height = process->target_height;
+    layout.channels = process->target_channels;
+    layout.format = process->format;
+    layout.dtype = process->dtype;
+
+    image_loader_t loader = calloc(1, sizeof(struct image_loader_internal_t));
+    if (!loader) return NULL;
+    if (image_tensor_layout_shape(&layout, NULL, &loader->sample_shape, &loader->sample_bytes) != 0) {
+        free(loader);
+        return NULL;
+    }
+
+    loader->config = *config;
+    loader->process = *process;
+    loader->process.memory_pool = NULL;
+    loader->count = count;
+    loader->batch_size = config->batch_size;
+    loader->batch_count = (count + config->batch_size - 1) / config->batch_size;
+    loader->window = config->prefetch_batches ? config->prefetch_batches : 2;
+    if (loader->window > loader->batch_count) loader->window = loader->batch_count;
+
+    pthread_mutex_init(&loader->mutex, NULL);
+    pthread_cond_init(&loader->work_cond, NULL);
+    pthread_cond_init(&loader->ready_cond, NULL);
+
+    loader->paths = calloc(count, sizeof(char*));
+    bool ok = loader->paths != NULL;
+    for (uint32_t i = 0; ok && i < count; i++) {
+        loader->paths[i] = paths[i] ? strdup(paths[i]) : NULL;
+        ok = loader->paths[i] != NULL;
+    }
+    if (!ok || alloc_slots(loader) != 0) {
+        LOG_ERROR("批量加载器创建失败");
+        image_loader_destroy(loader);
+        return NULL;
+    }
+
+    uint32_t workers = config->num_workers;
+    if (workers == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (uint32_t)online : 1;
+    }
+    if (workers > IMAGE_LOADER_MAX_WORKERS) workers = IMAGE_LOADER_MAX_WORKERS;
+    if (workers > count) workers = count;
+    for (uint32_t i = 0; i < workers; i++) {
+        if (pthread_create(&loader->workers[i], NULL, worker_thread, loader) != 0) {
+            LOG_ERROR("加载线程创建失败");
+            image_loader_destroy(loader);
+            return NULL;
+        }
+        loader->worker_count++;
+    }
+
+    LOG_DEBUG("批量加载器: %u 张图像, %u 个批次, 预取窗口 %u, %u 个工作线程",
+              count, loader->batch_count, loader->window, loader->worker_count);
+    return loader;
+}
+
+void image_loader_destroy(image_loader_t loader) {
+    if (!loader) return;
+
+    pthread_mutex_lock(&loader->mutex);
+    loader->shutdown = true;
+    pthread_cond_broadcast(&loader->work_cond);
+    pthread_mutex_unlock(&loader->mutex);
+    for (uint32_t i = 0; i < loader->worker_count; i++) {
+        pthread_join(loader->workers[i], NULL);
+    }
+
+    free_slots(loader);
+    if (loader->paths) {
+        for (uint32_t i = 0; i < loader->count; i++) free(loader->paths[i]);
+        free(loader->paths);
+    }
+    pthread_cond_destroy(&loader->ready_cond);
+    pthread_cond_destroy(&loader->work_cond);
+    pthread_mutex_destroy(&loader->mutex);
+    free(loader);
+}
+
+// 查找可返回的批次（调用方持有锁），返回 -1 表示尚未就绪，-2 表示缓冲区都被占用而无法继续
+static int find_ready(image_loader_t loader) {
+    if (loader->config.ordered) {
+        loader_slot_t* slot = &loader->slots[loader->next_batch % loader->window];
+        if (slot->state == SLOT_READY && slot->batch == loader->next_batch) {
+            return (int)(loader->next_batch % loader->window);
+        }
+        return slot->state == SLOT_IN_USE ? -2 : -1;
+    }
+
+    int found = -1;
+    bool all_in_use = true;
+    for (uint32_t i = 0; i < loader->window; i++) {
+        loader_slot_t* slot = &loader->slots[i];
+        if (slot->state != SLOT_IN_USE) all_in_use = false;
+        if (slot->state == SLOT_READY && (found < 0 || slot->batch < loader->slots[found].batch)) {
+            found = (int)i;
+        }
+    }
+    return found >= 0 ? found : (all_in_use ? -2 : -1);
+}
+
+int image_loader_next(image_loader_t loader, image_batch_t* batch) {
+    if (!loader || !batch) return -1;
+    memset(batch, 0, sizeof(*batch));
+
+    pthread_mutex_lock(&loader->mutex);
+    if (loader->returned >= loader->batch_count) {
+        pthread_mutex_unlock(&loader->mutex);
+        return IMAGE_LOADER_END;
+    }
+
+    double start = now_ms();
+    int index;
+    while ((index = find_ready(loader)) == -1) {
+        pthread_cond_wait(&loader->ready_cond, &loader->mutex);
+    }
+    if (index < 0) {
+        pthread_mutex_unlock(&loader->mutex);
+        LOG_ERROR("批次缓冲区都未归还，无法继续预取");
+        return -1;
+    }
+
+    loader_slot_t* slot = &loader->slots[index];
+    slot->state = SLOT_IN_USE;
+    loader->returned++;
+    if (loader->config.ordered) loader->next_batch++;
+    loader->stats.batches++;
+    loader->stats.wait_ms += now_ms() - start;
+
+    uint32_t count = batch_length(loader, slot->batch);
+    batch->tensor.dtype = loader->process.dtype == TENSOR_TYPE_UNKNOWN ? TENSOR_TYPE_FLOAT32 : loader->process.dtype;
+    batch->tensor.format = loader->process.format;
+    batch->tensor.shape = loader->sample_shape;
+    batch->tensor.shape.dims[0] = count;
+    batch->tensor.memory_type = TENSOR_MEMORY_CPU;
+    batch->tensor.data = slot->data;
+    batch->tensor.size = loader->sample_bytes * count;
+    batch->tensor.owns_data = false;
+    batch->batch_index = slot->batch;
+    batch->count = count;
+    batch->indices = slot->indices;
+    batch->valid = slot->valid;
+    batch->failed = slot->failed;
+    batch->slot = (uint32_t)index;
+    pthread_mutex_unlock(&loader->mutex);
+    return 0;
+}
+
+void image_loader_release(image_loader_t loader, image_batch_t* batch) {
+    if (!loader || !batch || !batch->tensor.data || batch->slot >= loader->window) return;
+
+    pthread_mutex_lock(&loader->mutex);
+    loader_slot_t* slot = &loader->slots[batch->slot];
+    if (slot->state == SLOT_IN_USE && slot->batch == batch->batch_index) {
+        slot->state = SLOT_FREE;
+        pthread_cond_broadcast(&loader->work_cond);
+    }
+    pthread_mutex_unlock(&loader->mutex);
+    memset(batch, 0, sizeof(*batch));
+}
+
+uint32_t image_loader_get_batch_count(image_loader_t loader) {
+    return loader ? loader->batch_count : 0;
+}
+
+int image_loader_get_stats(image_loader_t loader, image_loader_stats_t* stats) {
+    if (!loader || !stats) return -1;
+    pthread_mutex_lock(&loader->mutex);
+    *stats = loader->stats;
+    pthread_mutex_unlock(&loader->mutex);
+    return 0;
+}
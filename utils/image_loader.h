@@ -0,0 +1,123 @@
+#ifndef MODYN_UTILS_IMAGE_LOADER_H
+#define MODYN_UTILS_IMAGE_LOADER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/tensor.h"
+#include "utils/image_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 批量图像加载器
+ *
+ * 按路径列表把图像解码成批量张量 [N, C, H, W] 或 [N, H, W, C]。工作线程在后台读取文件并解码，
+ * 每个样本直接写入批量张量中的对应位置；最多预取 prefetch_batches 个批次，
+ * 使磁盘读取、解码与推理重叠，同时限制内存占用。
+ */
+
+/**
+ * @brief image_loader_next 的返回值：所有批次都已取出
+ */
+#define IMAGE_LOADER_END 1
+
+/**
+ * @brief 批量加载配置
+ */
+typedef struct {
+    ImageProcessConfig process;     /**< 单张图像的处理配置（宽、高、通道数必须指定） */
+    uint32_t batch_size;            /**< 批量大小（最后一批可能不足） */
+    uint32_t num_workers;           /**< 工作线程数（0表示在线 CPU 数） */
+    uint32_t prefetch_batches;      /**< 预取窗口（批次数，0表示2） */
+    bool ordered;                   /**< true 按路径顺序返回批次，false 按完成顺序返回 */
+} image_loader_config_t;
+
+/**
+ * @brief 一个已加载的批次
+ */
+typedef struct {
+    Tensor tensor;                  /**< 批量张量（数据归加载器所有，释放前有效） */
+    uint32_t batch_index;           /**< 批次序号 */
+    uint32_t count;                 /**< 样本数量（与 tensor 第一维相同） */
+    const uint32_t* indices;        /**< 每个样本在路径列表中的下标 */
+    const bool* valid;              /**< 每个样本是否加载成功（失败的样本填0） */
+    uint32_t failed;                /**< 加载失败的样本数 */
+    uint32_t slot;                  /**< 内部缓冲区编号 */
+} image_batch_t;
+
+/**
+ * @brief 加载统计
+ */
+typedef struct {
+    uint64_t images_loaded;         /**< 成功加载的图像数 */
+    uint64_t images_failed;         /**< 加载失败的图像数 */
+    uint64_t batches;               /**< 已返回的批次数 */
+    double load_ms;                 /**< 工作线程读取和解码的累计耗时 */
+    double wait_ms;                 /**< 调用者在 image_loader_next 中等待的累计耗时 */
+} image_loader_stats_t;
+
+/**
+ * @brief 批量加载器句柄
+ */
+typedef struct image_loader_internal_t* image_loader_t;
+
+/**
+ * @brief 创建批量加载器并立即开始预取
+ *
+ * @param paths 图像路径列表（加载器内部复制）
+ * @param count 路径数量
+ * @param config 加载配置
+ * @return image_loader_t 加载器实例，失败返回NULL
+ */
+image_loader_t image_loader_create(const char* const* paths, uint32_t count, const image_loader_config_t* config);
+
+/**
+ * @brief 销毁加载器（等待工作线程退出，未释放的批次随之失效）
+ *
+ * @param loader 加载器实例
+ */
+void image_loader_destroy(image_loader_t loader);
+
+/**
+ * @brief 获取下一个批次（阻塞直到有批次就绪）
+ *
+ * 批次使用完后必须调用 image_loader_release 归还，其缓冲区才能用于后续预取。
+ *
+ * @param loader 加载器实例
+ * @param batch 输出批次
+ * @return int 0成功，IMAGE_LOADER_END 表示没有更多批次，负数表示失败
+ */
+int image_loader_next(image_loader_t loader, image_batch_t* batch);
+
+/**
+ * @brief 归还批次缓冲区
+ *
+ * @param loader 加载器实例
+ * @param batch 由 image_loader_next 返回的批次
+ */
+void image_loader_release(image_loader_t loader, image_batch_t* batch);
+
+/**
+ * @brief 获取批次总数
+ *
+ * @param loader 加载器实例
+ * @return uint32_t 批次总数
+ */
+uint32_t image_loader_get_batch_count(image_loader_t loader);
+
+/**
+ * @brief 获取加载统计
+ *
+ * @param loader 加载器实例
+ * @param stats 输出统计
+ * @return int 0成功，其他失败
+ */
+int image_loader_get_stats(image_loader_t loader, image_loader_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_IMAGE_LOADER_H
@@ -1,4 +1,5 @@
 #include "utils/image_utils.h"
+#include "utils/image_decode.h"
 #include "utils/logger.h"
 #include <stdlib.h>
 #include <string.h>
@@ -59,143 +60,148 @@ ImageInfo image_utils_get_info(const char* image_path) {
     LOG_DEBUG("图像信息: %s - %dx%d, %d通道, %zu字节", 
               image_path, info.width, info.height, info.channels, info.size);
 #else
-    // 简化实现：根据文件扩展名猜测
-    const char* ext = strrchr(image_path, '.');
-    if (ext && (strcmp(ext, ".jpg") == 0 || strcmp(ext, ".png") == 0 || 
-                strcmp(ext, ".bmp") == 0 || strcmp(ext, ".jpeg") == 0)) {
-        // 设置默认值
-        info.width = 224;
-        info.height = 224;
-        info.channels = 3;
-        info.dtype = IMAGE_DTYPE_UINT8;
-        info.size = 224 * 224 * 3;
-        info.valid = true;
-        
-        LOG_WARN("使用虚拟图像信息（未启用OpenCV）: %s", image_path);
-    } else {
+    // 内置解码器只解析文件头，不解码像素
+    image_header_t header;
+    if (image_probe_file(image_path, &header) != 0) {
         LOG_ERROR("不支持的图像格式: %s", image_path);
+        return info;
     }
+    
+    info.width = header.width;
+    info.height = header.height;
+    info.channels = header.channels;
+    info.dtype = IMAGE_DTYPE_UINT8;
+    info.size = (size_t)header.width * header.height * header.channels;
+    info.valid = true;
+    
+    LOG_DEBUG("图像信息: %s - %dx%d, %d通道, %zu字节", 
+              image_path, info.width, info.height, info.channels, info.size);
 #endif
     
     return info;
 }
 
-Tensor image_utils_load_tensor(const char* image_path, const ImageProcessConfig* config) {
-    Tensor tensor = {0};
-    
-    if (!image_path || !config) {
-        LOG_ERROR("图像加载参数无效");
-        return tensor;
+// 处理配置转换为解码器的目标布局
+static void make_layout(const ImageProcessConfig* config, image_tensor_layout_t* layout) {
+    memset(layout, 0, sizeof(*layout));
+    layout->width = config->target_width;
+    layout->height = config->target_height;
+    if (config->target_channels == 1 || config->target_channels == 3 || config->target_channels == 4) {
+        layout->channels = config->target_channels;
+    }
+    layout->format = config->format;
+    layout->dtype = config->dtype;
+    layout->scale = config->normalize ? 1.0f / 255.0f : 1.0f;
+    memcpy(layout->mean, config->mean, sizeof(layout->mean));
+    memcpy(layout->std, config->std, sizeof(layout->std));
+}
+
+// 从内存池分配输出缓冲区（目标尺寸未完整指定时先解析文件头）
+static int alloc_from_pool(const char* image_path, const ImageProcessConfig* config,
+                           const image_tensor_layout_t* layout, Tensor* output, memory_handle_t* handle) {
+    image_header_t header = {0};
+    if ((layout->width == 0 || layout->height == 0 || layout->channels == 0) &&
+        image_probe_file(image_path, &header) != 0) {
+        return -1;
     }
     
-#ifdef MODYN_ENABLE_OPENCV
-    Mat image = imread(image_path);
-    if (image.empty()) {
-        LOG_ERROR("无法加载图像: %s", image_path);
-        return tensor;
+    size_t size = 0;
+    if (image_tensor_layout_shape(layout, &header, NULL, &size) != 0) {
+        LOG_ERROR("无效的图像张量布局: %s", image_path);
+        return -1;
     }
     
-    // 调整大小
-    if (config->target_width > 0 && config->target_height > 0) {
-        Mat resized;
-        resize(image, resized, Size(config->target_width, config->target_height));
-        image = resized;
+    *handle = memory_pool_alloc(config->memory_pool, size, 64, "image_tensor");
+    if (!*handle) {
+        LOG_ERROR("内存池分配图像张量失败（%zu 字节）", size);
+        return -1;
+    }
+    output->data = memory_handle_get_ptr(*handle);
+    output->size = size;
+    output->owns_data = false;
+    return 0;
+}
+
+int image_utils_load_into(const char* image_path, const ImageProcessConfig* config, Tensor* output,
+                          memory_handle_t* handle) {
+    if (!image_path || !config || !output) {
+        LOG_ERROR("图像加载参数无效");
+        return -1;
     }
     
-    // 颜色空间转换
-    if (config->target_channels == 1 && image.channels() == 3) {
-        Mat gray;
-        cvtColor(image, gray, COLOR_BGR2GRAY);
-        image = gray;
-    } else if (config->target_channels == 3 && image.channels() == 1) {
-        Mat color;
-        cvtColor(image, color, COLOR_GRAY2BGR);
-        image = color;
+    image_tensor_layout_t layout;
+    make_layout(config, &layout);
+    
+    bool pooled = false;
+    if (!output->data && config->memory_pool) {
+        if (!handle) {
+            LOG_ERROR("从内存池分配时需要提供句柄输出");
+            return -1;
+        }
+        if (alloc_from_pool(image_path, config, &layout, output, handle) != 0) return -1;
+        pooled = true;
     }
     
-    // 数据类型转换
-    Mat float_image;
-    if (config->normalize) {
-        image.convertTo(float_image, CV_32F, 1.0/255.0);
+    int ret;
+#ifdef MODYN_ENABLE_OPENCV
+    Mat image = imread(image_path);
+    if (image.empty()) {
+        LOG_ERROR("无法加载图像: %s", image_path);
+        ret = -1;
     } else {
-        image.convertTo(float_image, CV_32F);
+        // 通道转换保持 OpenCV 的 BGR 顺序，其余步骤逐行写入目标张量
+        if (config->target_channels == 1 && image.channels() == 3) {
+            Mat gray;
+            cvtColor(image, gray, COLOR_BGR2GRAY);
+            image = gray;
+        } else if (config->target_channels == 3 && image.channels() == 1) {
+            Mat color;
+            cvtColor(image, color, COLOR_GRAY2BGR);
+            image = color;
+        }
+        layout.channels = image.channels();
+        ret = image_pixels_to_tensor(image.data, image.cols, image.rows, image.channels(), image.step,
+                                     &layout, output);
     }
+#else
+    // 内置解码器：JPEG 先在 DCT 域缩小到不小于目标尺寸
+    ret = image_decode_file_to_tensor(image_path, &layout, output);
+#endif
     
-    // 创建张量
-    uint32_t dims[4];
-    uint32_t ndim;
-    
-    if (config->format == TENSOR_FORMAT_NCHW) {
-        dims[0] = 1;  // batch
-        dims[1] = float_image.channels();  // channels
-        dims[2] = float_image.rows;        // height
-        dims[3] = float_image.cols;        // width
-        ndim = 4;
-    } else {  // NHWC
-        dims[0] = 1;  // batch
-        dims[1] = float_image.rows;        // height
-        dims[2] = float_image.cols;        // width
-        dims[3] = float_image.channels();  // channels
-        ndim = 4;
+    if (ret != 0) {
+        if (pooled) {
+            memory_pool_free(config->memory_pool, *handle);
+            *handle = NULL;
+            output->data = NULL;
+            output->size = 0;
+        }
+        LOG_ERROR("无法加载图像: %s", image_path);
+        return -1;
     }
     
-    TensorShape shape = tensor_shape_create(dims, ndim);
-    tensor = tensor_create("image_tensor", TENSOR_TYPE_FLOAT32, &shape, config->format);
+    LOG_DEBUG("图像直接写入张量: %s -> [%u, %u, %u, %u]", image_path,
+              output->shape.dims[0], output->shape.dims[1], output->shape.dims[2], output->shape.dims[3]);
+    return 0;
+}
+
+Tensor image_utils_load_tensor(const char* image_path, const ImageProcessConfig* config) {
+    Tensor tensor = {0};
     
-    // 分配内存
-    tensor.data = malloc(tensor.size);
-    if (!tensor.data) {
-        LOG_ERROR("张量内存分配失败");
+    if (!image_path || !config) {
+        LOG_ERROR("图像加载参数无效");
         return tensor;
     }
-    tensor.owns_data = true;
-    
-    // 复制数据
-    float* tensor_data = (float*)tensor.data;
-    
-    if (config->format == TENSOR_FORMAT_NCHW) {
-        // 转换为NCHW格式
-        for (int c = 0; c < float_image.channels(); c++) {
-            for (int h = 0; h < float_image.rows; h++) {
-                for (int w = 0; w < float_image.cols; w++) {
-                    int tensor_idx = c * float_image.rows * float_image.cols + h * float_image.cols + w;
-                    
-                    if (float_image.channels() == 1) {
-                        tensor_data[tensor_idx] = float_image.at<float>(h, w);
-                    } else {
-                        Vec3f pixel = float_image.at<Vec3f>(h, w);
-                        tensor_data[tensor_idx] = pixel[c];
-                    }
-                }
-            }
-        }
-    } else {
-        // NHWC格式，直接复制
-        memcpy(tensor_data, float_image.data, tensor.size);
-    }
     
-    LOG_INFO("图像转张量成功: %s -> [%d, %d, %d, %d]", 
-             image_path, dims[0], dims[1], dims[2], dims[3]);
-             
-#else
-    // 简化实现：创建虚拟张量
-    uint32_t dims[] = {1, config->target_channels, config->target_height, config->target_width};
-    TensorShape shape = tensor_shape_create(dims, 4);
-    tensor = tensor_create("dummy_image", TENSOR_TYPE_FLOAT32, &shape, config->format);
-    
-    tensor.data = malloc(tensor.size);
-    if (tensor.data) {
-        tensor.owns_data = true;
-        // 填充随机数据
-        float* data = (float*)tensor.data;
-        for (uint32_t i = 0; i < tensor_get_element_count(&tensor); i++) {
-            data[i] = (float)(rand() % 256) / 255.0f;
-        }
+    // 返回值无法携带内存池句柄，这里总是直接分配
+    ImageProcessConfig direct = *config;
+    direct.memory_pool = NULL;
+    if (image_utils_load_into(image_path, &direct, &tensor, NULL) != 0) {
+        memset(&tensor, 0, sizeof(tensor));
+        return tensor;
     }
     
-    LOG_WARN("使用虚拟图像数据（未启用OpenCV）: %s", image_path);
-#endif
-    
+    LOG_INFO("图像转张量成功: %s -> [%u, %u, %u, %u]", image_path,
+             tensor.shape.dims[0], tensor.shape.dims[1], tensor.shape.dims[2], tensor.shape.dims[3]);
     return tensor;
 }
 
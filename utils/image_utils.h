@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "core/tensor.h"
+#include "core/memory_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,10 +43,12 @@ typedef struct {
     uint32_t target_height;     /**< 目标高度 */
     uint32_t target_channels;   /**< 目标通道数 */
     TensorFormat format;        /**< 张量格式 */
-    bool normalize;             /**< 是否归一化 */
+    bool normalize;             /**< 是否归一化到 [0, 1] */
     bool keep_aspect_ratio;     /**< 是否保持宽高比 */
-    float mean[4];              /**< 均值 */
-    float std[4];               /**< 标准差 */
+    float mean[4];              /**< 均值（归一化后减去） */
+    float std[4];               /**< 标准差（0表示不除） */
+    TensorDataType dtype;       /**< 输出类型（FLOAT32、FLOAT16 或 UINT8，UNKNOWN 视为 FLOAT32） */
+    memory_pool_t memory_pool;  /**< 输出缓冲区来源（image_utils_load_into 与批量加载器使用，NULL表示直接分配） */
 } image_process_config_t;
 
 // 为了向后兼容，保留旧的类型别名
@@ -70,6 +73,23 @@ ImageInfo image_utils_get_info(const char* image_path);
  */
 Tensor image_utils_load_tensor(const char* image_path, const ImageProcessConfig* config);
 
+/**
+ * @brief 加载图像并直接写入目标张量
+ *
+ * 解码、缩放、归一化和布局转换逐行完成，直接写入最终位置。
+ * output->data 已设置时写入调用者的缓冲区（例如批量张量中的一个样本）；
+ * 否则配置了内存池时从内存池分配（通过 handle 返回，由调用者用 memory_pool_free 释放），
+ * 未配置时用 malloc 分配并由张量持有。
+ * 
+ * @param image_path 图像文件路径
+ * @param config 处理配置
+ * @param output 输出张量
+ * @param handle 内存池分配的句柄（未使用内存池时可为NULL）
+ * @return int 0表示成功，负数表示失败
+ */
+int image_utils_load_into(const char* image_path, const ImageProcessConfig* config, Tensor* output,
+                          memory_handle_t* handle);
+
 /**
  * @brief 保存张量为图像
  * 
@@ -0,0 +1,682 @@
+#include "utils/pointcloud_utils.h"
+#include "utils/thread_pool.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// 叶子最多容纳的点数
+#define KDTREE_LEAF_SIZE 16
+
+// 查询时显式栈的深度上限（中位数切分的树深度约为 log2(n / 叶子大小)）
+#define KDTREE_MAX_DEPTH 64
+
+// 少于该点数时串行构建
+#define KDTREE_PARALLEL_MIN_POINTS 8192
+
+// 体素坐标每轴位数（三轴打包为 64 位键）
+#define VOXEL_AXIS_BITS 21
+#define VOXEL_AXIS_MAX ((1u << VOXEL_AXIS_BITS) - 1)
+#define VOXEL_EMPTY UINT64_MAX
+
+/**
+ * @brief k-d 树节点；左子节点紧跟在父节点之后，右子节点下标记录在 right 中
+ */
+typedef struct {
+    float split;                    /**< 切分值 */
+    uint32_t dim;                   /**< 切分轴，叶子为 3 */
+    uint32_t begin;                 /**< 点区间起始 */
+    uint32_t end;                   /**< 点区间结束 */
+    uint32_t right;                 /**< 右子节点下标 */
+} kdtree_node_t;
+
+/**
+ * @brief k-d 树内部结构
+ */
+struct kdtree_internal_t {
+    uint32_t count;
+    float* coords[3];               /**< 按叶子顺序排列的 x、y、z */
+    uint32_t* index;                /**< 重排后每个位置对应的原始下标 */
+    kdtree_node_t* nodes;
+    uint32_t node_count;
+};
+
+/**
+ * @brief 待并行构建的子树
+ */
+typedef struct {
+    uint32_t node;
+    uint32_t begin;
+    uint32_t end;
+} kdtree_subtree_t;
+
+/**
+ * @brief 并行构建上下文
+ */
+typedef struct {
+    struct kdtree_internal_t* tree;
+    const kdtree_subtree_t* subtrees;
+} kdtree_build_job_t;
+
+/**
+ * @brief k 近邻候选（最大堆，堆顶为当前第 k 近）
+ */
+typedef struct {
+    float dist;
+    uint32_t index;
+} knn_entry_t;
+
+// 区间 [0, n) 的节点数，与构建时的切分方式一致
+static uint32_t kdtree_subtree_nodes(uint32_t n) {
+    if (n <= KDTREE_LEAF_SIZE) return 1;
+    return 1 + kdtree_subtree_nodes(n / 2) + kdtree_subtree_nodes(n - n / 2);
+}
+
+static inline void kdtree_swap(struct kdtree_internal_t* tree, uint32_t a, uint32_t b) {
+    for (int d = 0; d < 3; d++) {
+        float t = tree->coords[d][a];
+        tree->coords[d][a] = tree->coords[d][b];
+        tree->coords[d][b] = t;
+    }
+    uint32_t t = tree->index[a];
+    tree->index[a] = tree->index[b];
+    tree->index[b] = t;
+}
+
+// 快速选择：使 [begin, end) 中第 nth 个位置为该轴的中位数，左侧不大于、右侧不小于它
+static void kdtree_select(struct kdtree_internal_t* tree, uint32_t dim, uint32_t begin, uint32_t end,
+                          uint32_t nth) {
+    const float* key = tree->coords[dim];
+
+    while (end - begin > 1) {
+        // 三数取中作为枢轴
+        uint32_t mid = begin + (end - begin) / 2;
+        if (key[mid] < key[begin]) kdtree_swap(tree, mid, begin);
+        if (key[end - 1] < key[begin]) kdtree_swap(tree, end - 1, begin);
+        if (key[end - 1] < key[mid]) kdtree_swap(tree, end - 1, mid);
+        float pivot = key[mid];
+
+        uint32_t i = begin;
+        uint32_t j = end - 1;
+        while (i <= j) {
+            while (key[i] < pivot) i++;
+            while (key[j] > pivot) j--;
+            if (i <= j) {
+                kdtree_swap(tree, i, j);
+                i++;
+                if (j == 0) break;
+                j--;
+            }
+        }
+
+        // [begin, j] <= pivot <= [i, end)
+        if (nth <= j) {
+            end = j + 1;
+        } else if (nth >= i) {
+            begin = i;
+        } else {
+            return;
+        }
+    }
+}
+
+// 构建以 node 为根、覆盖 [begin, end) 的子树；split_depth 层以下的子树记入 subtrees 留待并行构建
+static void kdtree_build_range(struct kdtree_internal_t* tree, uint32_t node, uint32_t begin, uint32_t end,
+                               uint32_t depth, uint32_t split_depth, kdtree_subtree_t* subtrees,
+                               uint32_t* subtree_count) {
+    if (subtrees && depth == split_depth) {
+        kdtree_subtree_t* s = &subtrees[(*subtree_count)++];
+        s->node = node;
+        s->begin = begin;
+        s->end = end;
+        return;
+    }
+
+    kdtree_node_t* n = &tree->nodes[node];
+    n->begin = begin;
+    n->end = end;
+
+    uint32_t count = end - begin;
+    if (count <= KDTREE_LEAF_SIZE) {
+        n->dim = 3;
+        n->split = 0.0f;
+        n->right = 0;
+        return;
+    }
+
+    // 选择跨度最大的轴
+    uint32_t dim = 0;
+    float best_spread = -1.0f;
+    for (uint32_t d = 0; d < 3; d++) {
+        const float* c = tree->coords[d];
+        float lo = c[begin];
+        float hi = c[begin];
+        for (uint32_t i = begin + 1; i < end; i++) {
+            if (c[i] < lo) lo = c[i];
+            if (c[i] > hi) hi = c[i];
+        }
+        if (hi - lo > best_spread) {
+            best_spread = hi - lo;
+            dim = d;
+        }
+    }
+
+    uint32_t mid = begin + count / 2;
+    kdtree_select(tree, dim, begin, end, mid);
+
+    n->dim = dim;
+    n->split = tree->coords[dim][mid];
+    n->right = node + 1 + kdtree_subtree_nodes(count / 2);
+
+    uint32_t right = n->right;
+    kdtree_build_range(tree, node + 1, begin, mid, depth + 1, split_depth, subtrees, subtree_count);
+    kdtree_build_range(tree, right, mid, end, depth + 1, split_depth, subtrees, subtree_count);
+}
+
+static void kdtree_build_task(void* context, uint32_t index) {
+    const kdtree_build_job_t* job = (const kdtree_build_job_t*)context;
+    const kdtree_subtree_t* s = &job->subtrees[index];
+    kdtree_build_range(job->tree, s->node, s->begin, s->end, 0, 0, NULL, NULL);
+}
+
+kdtree_t kdtree_build(const float* points, uint32_t count, uint32_t stride, uint32_t num_threads) {
+    if (!points || count == 0 || stride < 3) return NULL;
+
+    struct kdtree_internal_t* tree = calloc(1, sizeof(struct kdtree_internal_t));
+    if (!tree) return NULL;
+
+    tree->count = count;
+    tree->node_count = kdtree_subtree_nodes(count);
+    tree->nodes = malloc(sizeof(kdtree_node_t) * tree->node_count);
+    tree->index = malloc(sizeof(uint32_t) * count);
+    for (int d = 0; d < 3; d++) {
+        tree->coords[d] = malloc(sizeof(float) * count);
+    }
+    if (!tree->nodes || !tree->index || !tree->coords[0] || !tree->coords[1] || !tree->coords[2]) {
+        LOG_ERROR("Failed to allocate k-d tree for %u points", count);
+        kdtree_destroy(tree);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const float* p = points + (size_t)i * stride;
+        tree->coords[0][i] = p[0];
+        tree->coords[1][i] = p[1];
+        tree->coords[2][i] = p[2];
+        tree->index[i] = i;
+    }
+
+    // 上层串行切分到约 4 倍线程数的子树，再并行构建各子树
+    uint32_t split_depth = 0;
+    if (num_threads > 1 && count >= KDTREE_PARALLEL_MIN_POINTS) {
+        while ((1u << split_depth) < num_threads * 4 &&
+               (count >> (split_depth + 1)) > KDTREE_LEAF_SIZE) {
+            split_depth++;
+        }
+    }
+
+    if (split_depth == 0) {
+        kdtree_build_range(tree, 0, 0, count, 0, 0, NULL, NULL);
+        return tree;
+    }
+
+    kdtree_subtree_t* subtrees = malloc(sizeof(kdtree_subtree_t) << split_depth);
+    if (!subtrees) {
+        kdtree_build_range(tree, 0, 0, count, 0, 0, NULL, NULL);
+        return tree;
+    }
+
+    uint32_t subtree_count = 0;
+    kdtree_build_range(tree, 0, 0, count, 0, split_depth, subtrees, &subtree_count);
+
+    kdtree_build_job_t job = { tree, subtrees };
+    thread_pool_t pool = thread_pool_get_shared();
+    thread_pool_reserve(pool, num_threads - 1);
+    thread_pool_parallel_for(pool, subtree_count, num_threads, kdtree_build_task, &job);
+
+    free(subtrees);
+    return tree;
+}
+
+void kdtree_destroy(kdtree_t tree) {
+    if (!tree) return;
+
+    free(tree->nodes);
+    free(tree->index);
+    for (int d = 0; d < 3; d++) {
+        free(tree->coords[d]);
+    }
+    free(tree);
+}
+
+uint32_t kdtree_get_count(kdtree_t tree) {
+    return tree ? tree->count : 0;
+}
+
+static void knn_sift_down(knn_entry_t* heap, uint32_t size, uint32_t i) {
+    knn_entry_t item = heap[i];
+    while (true) {
+        uint32_t child = 2 * i + 1;
+        if (child >= size) break;
+        if (child + 1 < size && heap[child + 1].dist > heap[child].dist) child++;
+        if (heap[child].dist <= item.dist) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = item;
+}
+
+static void knn_push(knn_entry_t* heap, uint32_t* size, uint32_t k, float dist, uint32_t index) {
+    if (*size < k) {
+        uint32_t i = (*size)++;
+        while (i > 0) {
+            uint32_t parent = (i - 1) / 2;
+            if (heap[parent].dist >= dist) break;
+            heap[i] = heap[parent];
+            i = parent;
+        }
+        heap[i].dist = dist;
+        heap[i].index = index;
+    } else if (dist < heap[0].dist) {
+        heap[0].dist = dist;
+        heap[0].index = index;
+        knn_sift_down(heap, *size, 0);
+    }
+}
+
+uint32_t kdtree_knn(kdtree_t tree, const float query[3], uint32_t k, uint32_t* indices, float* distances_sq) {
+    if (!tree || !query || !indices || k == 0) return 0;
+    if (k > tree->count) k = tree->count;
+
+    knn_entry_t stack_heap[64];
+    knn_entry_t* heap = k <= 64 ? stack_heap : malloc(sizeof(knn_entry_t) * k);
+    if (!heap) return 0;
+
+    const float qx = query[0];
+    const float qy = query[1];
+    const float qz = query[2];
+    const float* xs = tree->coords[0];
+    const float* ys = tree->coords[1];
+    const float* zs = tree->coords[2];
+
+    uint32_t size = 0;
+    uint32_t stack[KDTREE_MAX_DEPTH];
+    float stack_bound[KDTREE_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top] = 0;
+    stack_bound[top++] = 0.0f;
+
+    while (top > 0) {
+        top--;
+        uint32_t node = stack[top];
+        if (size == k && stack_bound[top] >= heap[0].dist) continue;
+
+        // 沿近侧子树下降，远侧子树以切分面距离为下界压栈
+        const kdtree_node_t* n = &tree->nodes[node];
+        while (n->dim < 3) {
+            float diff = query[n->dim] - n->split;
+            uint32_t near = diff < 0.0f ? node + 1 : n->right;
+            uint32_t far = diff < 0.0f ? n->right : node + 1;
+            float bound = diff * diff;
+            if ((size < k || bound < heap[0].dist) && top < KDTREE_MAX_DEPTH) {
+                stack[top] = far;
+                stack_bound[top++] = bound;
+            }
+            node = near;
+            n = &tree->nodes[node];
+        }
+
+        for (uint32_t i = n->begin; i < n->end; i++) {
+            float dx = xs[i] - qx;
+            float dy = ys[i] - qy;
+            float dz = zs[i] - qz;
+            float d = dx * dx + dy * dy + dz * dz;
+            if (size < k || d < heap[0].dist) {
+                knn_push(heap, &size, k, d, tree->index[i]);
+            }
+        }
+    }
+
+    // 逐个弹出堆顶，得到升序结果
+    uint32_t found = size;
+    while (size > 0) {
+        knn_entry_t item = heap[0];
+        heap[0] = heap[--size];
+        knn_sift_down(heap, size, 0);
+        indices[size] = item.index;
+        if (distances_sq) distances_sq[size] = item.dist;
+    }
+
+    if (heap != stack_heap) free(heap);
+    return found;
+}
+
+uint32_t kdtree_radius(kdtree_t tree, const float query[3], float radius, uint32_t* indices,
+                       float* distances_sq, uint32_t max_results) {
+    if (!tree || !query || radius < 0.0f) return 0;
+
+    const float r2 = radius * radius;
+    const float* xs = tree->coords[0];
+    const float* ys = tree->coords[1];
+    const float* zs = tree->coords[2];
+
+    uint32_t found = 0;
+    uint32_t stack[KDTREE_MAX_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        uint32_t node = stack[--top];
+        const kdtree_node_t* n = &tree->nodes[node];
+
+        while (n->dim < 3) {
+            float diff = query[n->dim] - n->split;
+            uint32_t near = diff < 0.0f ? node + 1 : n->right;
+            uint32_t far = diff < 0.0f ? n->right : node + 1;
+            if (diff * diff <= r2 && top < KDTREE_MAX_DEPTH) {
+                stack[top++] = far;
+            }
+            node = near;
+            n = &tree->nodes[node];
+        }
+
+        for (uint32_t i = n->begin; i < n->end; i++) {
+            float dx = xs[i] - query[0];
+            float dy = ys[i] - query[1];
+            float dz = zs[i] - query[2];
+            float d = dx * dx + dy * dy + dz * dz;
+            if (d <= r2) {
+                if (found < max_results && indices) {
+                    indices[found] = tree->index[i];
+                    if (distances_sq) distances_sq[found] = d;
+                }
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
+
+// ================================
+// 体素网格
+// ================================
+
+static inline uint64_t voxel_hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+// 计算包围盒最小角，并检查体素坐标能否用 21 位表示
+static int voxel_origin(const float* points, uint32_t count, uint32_t stride, float voxel_size,
+                        float origin[3]) {
+    float hi[3];
+    for (int d = 0; d < 3; d++) {
+        origin[d] = points[d];
+        hi[d] = points[d];
+    }
+    for (uint32_t i = 1; i < count; i++) {
+        const float* p = points + (size_t)i * stride;
+        for (int d = 0; d < 3; d++) {
+            if (p[d] < origin[d]) origin[d] = p[d];
+            if (p[d] > hi[d]) hi[d] = p[d];
+        }
+    }
+
+    for (int d = 0; d < 3; d++) {
+        if (!isfinite(origin[d]) || !isfinite(hi[d]) || (hi[d] - origin[d]) / voxel_size >= VOXEL_AXIS_MAX) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static inline uint64_t voxel_key(const float* p, const float origin[3], float inv_size) {
+    uint64_t ix = (uint64_t)((p[0] - origin[0]) * inv_size);
+    uint64_t iy = (uint64_t)((p[1] - origin[1]) * inv_size);
+    uint64_t iz = (uint64_t)((p[2] - origin[2]) * inv_size);
+    return ix | (iy << VOXEL_AXIS_BITS) | (iz << (2 * VOXEL_AXIS_BITS));
+}
+
+/**
+ * @brief 体素哈希表：键为打包的体素坐标，值为体素在输出中的序号
+ */
+typedef struct {
+    uint64_t* keys;
+    uint32_t* slots;
+    uint32_t mask;
+} voxel_table_t;
+
+static int voxel_table_init(voxel_table_t* table, uint32_t count) {
+    uint32_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+
+    table->keys = malloc(sizeof(uint64_t) * capacity);
+    table->slots = malloc(sizeof(uint32_t) * capacity);
+    table->mask = capacity - 1;
+    if (!table->keys || !table->slots) {
+        free(table->keys);
+        free(table->slots);
+        return -1;
+    }
+    memset(table->keys, 0xFF, sizeof(uint64_t) * capacity);
+    return 0;
+}
+
+// 查找体素，不存在时以 next_slot 插入；返回体素序号
+static inline uint32_t voxel_table_find(voxel_table_t* table, uint64_t key, uint32_t next_slot) {
+    uint32_t i = (uint32_t)voxel_hash(key) & table->mask;
+    while (table->keys[i] != VOXEL_EMPTY) {
+        if (table->keys[i] == key) return table->slots[i];
+        i = (i + 1) & table->mask;
+    }
+    table->keys[i] = key;
+    table->slots[i] = next_slot;
+    return next_slot;
+}
+
+static void voxel_table_free(voxel_table_t* table) {
+    free(table->keys);
+    free(table->slots);
+}
+
+int pointcloud_voxel_downsample(const float* points, uint32_t count, uint32_t stride, float voxel_size,
+                                float* output, uint32_t* output_count) {
+    if (!points || !output || !output_count || stride < 3 || !(voxel_size > 0.0f)) return -1;
+
+    *output_count = 0;
+    if (count == 0) return 0;
+
+    float origin[3];
+    if (voxel_origin(points, count, stride, voxel_size, origin) != 0) {
+        LOG_ERROR("Voxel size %g is too small for the point cloud extent", voxel_size);
+        return -1;
+    }
+
+    voxel_table_t table;
+    uint32_t* members = calloc(count, sizeof(uint32_t));
+    if (!members || voxel_table_init(&table, count) != 0) {
+        free(members);
+        return -1;
+    }
+
+    // 直接在输出缓冲区中累加各体素的和，最后除以点数
+    const float inv_size = 1.0f / voxel_size;
+    uint32_t voxels = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const float* p = points + (size_t)i * stride;
+        uint32_t slot = voxel_table_find(&table, voxel_key(p, origin, inv_size), voxels);
+        float* acc = output + (size_t)slot * stride;
+        if (slot == voxels) {
+            memcpy(acc, p, sizeof(float) * stride);
+            voxels++;
+        } else {
+            for (uint32_t c = 0; c < stride; c++) {
+                acc[c] += p[c];
+            }
+        }
+        members[slot]++;
+    }
+
+    for (uint32_t v = 0; v < voxels; v++) {
+        if (members[v] == 1) continue;
+        float inv = 1.0f / (float)members[v];
+        float* acc = output + (size_t)v * stride;
+        for (uint32_t c = 0; c < stride; c++) {
+            acc[c] *= inv;
+        }
+    }
+
+    voxel_table_free(&table);
+    free(members);
+    *output_count = voxels;
+    return 0;
+}
+
+// 统计给定体素边长下的非空体素数，超过 limit 时提前返回
+static uint32_t voxel_count(const float* points, uint32_t count, uint32_t stride, float voxel_size,
+                            voxel_table_t* table, uint32_t limit) {
+    float origin[3];
+    if (voxel_origin(points, count, stride, voxel_size, origin) != 0) return UINT32_MAX;
+
+    memset(table->keys, 0xFF, sizeof(uint64_t) * ((size_t)table->mask + 1));
+    const float inv_size = 1.0f / voxel_size;
+    uint32_t voxels = 0;
+    for (uint32_t i = 0; i < count && voxels <= limit; i++) {
+        if (voxel_table_find(table, voxel_key(points + (size_t)i * stride, origin, inv_size), voxels) == voxels) {
+            voxels++;
+        }
+    }
+    return voxels;
+}
+
+float pointcloud_voxel_size_for_target(const float* points, uint32_t count, uint32_t stride,
+                                       uint32_t target_points) {
+    if (!points || count == 0 || stride < 3 || target_points == 0) return 0.0f;
+
+    float lo[3];
+    float hi[3];
+    for (int d = 0; d < 3; d++) {
+        lo[d] = hi[d] = points[d];
+    }
+    for (uint32_t i = 1; i < count; i++) {
+        const float* p = points + (size_t)i * stride;
+        for (int d = 0; d < 3; d++) {
+            if (p[d] < lo[d]) lo[d] = p[d];
+            if (p[d] > hi[d]) hi[d] = p[d];
+        }
+    }
+    float extent = fmaxf(hi[0] - lo[0], fmaxf(hi[1] - lo[1], hi[2] - lo[2]));
+    if (!isfinite(extent)) return 0.0f;
+
+    // 边长略大于包围盒时只有一个体素
+    float upper = extent > 0.0f ? extent * 1.001f : 1.0f;
+    if (target_points >= count) return upper / (VOXEL_AXIS_MAX / 2);
+
+    voxel_table_t table;
+    if (voxel_table_init(&table, count) != 0) return 0.0f;
+
+    // 先按体积估计一个下界，再在 [lower, upper] 上二分
+    float lower = extent / cbrtf((float)target_points) * 0.5f;
+    while (lower > extent * 1e-5f &&
+           voxel_count(points, count, stride, lower, &table, target_points) <= target_points) {
+        upper = lower;
+        lower *= 0.5f;
+    }
+
+    for (int iter = 0; iter < 16 && upper - lower > upper * 1e-3f; iter++) {
+        float mid = 0.5f * (lower + upper);
+        if (voxel_count(points, count, stride, mid, &table, target_points) <= target_points) {
+            upper = mid;
+        } else {
+            lower = mid;
+        }
+    }
+
+    voxel_table_free(&table);
+    return upper;
+}
+
+// ================================
+// 法向量
+// ================================
+
+void pointcloud_estimate_normal(const float* points, uint32_t stride, const uint32_t* neighbors,
+                                uint32_t count, const float viewpoint[3], float normal[3]) {
+    normal[0] = normal[1] = normal[2] = 0.0f;
+    if (count < 3) return;
+
+    double mean[3] = {0.0, 0.0, 0.0};
+    for (uint32_t i = 0; i < count; i++) {
+        const float* p = points + (size_t)neighbors[i] * stride;
+        mean[0] += p[0];
+        mean[1] += p[1];
+        mean[2] += p[2];
+    }
+    for (int d = 0; d < 3; d++) {
+        mean[d] /= count;
+    }
+
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const float* p = points + (size_t)neighbors[i] * stride;
+        double x = p[0] - mean[0];
+        double y = p[1] - mean[1];
+        double z = p[2] - mean[2];
+        a00 += x * x;
+        a01 += x * y;
+        a02 += x * z;
+        a11 += y * y;
+        a12 += y * z;
+        a22 += z * z;
+    }
+
+    // 对称 3x3 矩阵特征值的解析解，取最小特征值
+    double q = (a00 + a11 + a22) / 3.0;
+    double p1 = a01 * a01 + a02 * a02 + a12 * a12;
+    double p2 = (a00 - q) * (a00 - q) + (a11 - q) * (a11 - q) + (a22 - q) * (a22 - q) + 2.0 * p1;
+    if (p2 <= 0.0) return;
+
+    double p = sqrt(p2 / 6.0);
+    double b00 = (a00 - q) / p, b11 = (a11 - q) / p, b22 = (a22 - q) / p;
+    double b01 = a01 / p, b02 = a02 / p, b12 = a12 / p;
+    double r = 0.5 * (b00 * (b11 * b22 - b12 * b12) - b01 * (b01 * b22 - b12 * b02) +
+                      b02 * (b01 * b12 - b11 * b02));
+    r = r < -1.0 ? -1.0 : (r > 1.0 ? 1.0 : r);
+    double lambda = q + 2.0 * p * cos(acos(r) / 3.0 + 2.0943951023931957);
+
+    // 特征向量与 (A - λI) 的各行正交，取两行叉积中模最大者
+    double rows[3][3] = {
+        {a00 - lambda, a01, a02},
+        {a01, a11 - lambda, a12},
+        {a02, a12, a22 - lambda}
+    };
+    double best[3] = {0.0, 0.0, 0.0};
+    double best_norm = 0.0;
+    for (int i = 0; i < 3; i++) {
+        const double* u = rows[i];
+        const double* v = rows[(i + 1) % 3];
+        double c[3] = {
+            u[1] * v[2] - u[2] * v[1],
+            u[2] * v[0] - u[0] * v[2],
+            u[0] * v[1] - u[1] * v[0]
+        };
+        double norm = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+        if (norm > best_norm) {
+            best_norm = norm;
+            memcpy(best, c, sizeof(best));
+        }
+    }
+    if (best_norm <= 1e-30) return;
+
+    double inv = 1.0 / sqrt(best_norm);
+    double dot = (viewpoint[0] - mean[0]) * best[0] + (viewpoint[1] - mean[1]) * best[1] +
+                 (viewpoint[2] - mean[2]) * best[2];
+    if (dot < 0.0) inv = -inv;
+
+    normal[0] = (float)(best[0] * inv);
+    normal[1] = (float)(best[1] * inv);
+    normal[2] = (float)(best[2] * inv);
+}
@@ -0,0 +1,125 @@
+#ifndef MODYN_UTILS_POINTCLOUD_UTILS_H
+#define MODYN_UTILS_POINTCLOUD_UTILS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief k-d 树句柄
+ */
+typedef struct kdtree_internal_t* kdtree_t;
+
+/**
+ * @brief 构建 k-d 树
+ *
+ * 点坐标按树的叶子顺序重排为 x/y/z 三个连续数组（SoA），叶子内的点在内存中相邻。
+ * 每层按跨度最大的轴取中位数切分；点数足够多时上层切分完成后各子树在共享线程池上并行构建。
+ *
+ * @param points 点数据，每个点 stride 个 float，前三个为 x、y、z
+ * @param count 点数
+ * @param stride 每个点的 float 数（不小于3）
+ * @param num_threads 最大并行度
+ * @return kdtree_t k-d 树实例
+ */
+kdtree_t kdtree_build(const float* points, uint32_t count, uint32_t stride, uint32_t num_threads);
+
+/**
+ * @brief 销毁 k-d 树
+ *
+ * @param tree k-d 树实例
+ */
+void kdtree_destroy(kdtree_t tree);
+
+/**
+ * @brief 获取点数
+ *
+ * @param tree k-d 树实例
+ * @return uint32_t 点数
+ */
+uint32_t kdtree_get_count(kdtree_t tree);
+
+/**
+ * @brief k 近邻查询
+ *
+ * 只读访问，可在多个线程中并发查询。
+ *
+ * @param tree k-d 树实例
+ * @param query 查询点 x、y、z
+ * @param k 邻居数
+ * @param indices 输出邻居在原始点数组中的下标，按距离升序
+ * @param distances_sq 输出对应的距离平方（可为NULL）
+ * @return uint32_t 实际邻居数（min(k, 点数)）
+ */
+uint32_t kdtree_knn(kdtree_t tree, const float query[3], uint32_t k, uint32_t* indices, float* distances_sq);
+
+/**
+ * @brief 半径查询
+ *
+ * 只读访问，可在多个线程中并发查询。结果不排序。
+ *
+ * @param tree k-d 树实例
+ * @param query 查询点 x、y、z
+ * @param radius 搜索半径
+ * @param indices 输出邻居在原始点数组中的下标
+ * @param distances_sq 输出对应的距离平方（可为NULL）
+ * @param max_results 输出缓冲区容量
+ * @return uint32_t 半径内的点数（可能超过 max_results，超出部分不写出）
+ */
+uint32_t kdtree_radius(kdtree_t tree, const float query[3], float radius, uint32_t* indices,
+                       float* distances_sq, uint32_t max_results);
+
+/**
+ * @brief 体素网格降采样
+ *
+ * 以点云包围盒最小角为原点划分边长为 voxel_size 的体素，
+ * 每个非空体素输出其中所有点的均值（包括 x、y、z 之外的通道），按体素首次出现的顺序排列。
+ *
+ * @param points 点数据，每个点 stride 个 float
+ * @param count 点数
+ * @param stride 每个点的 float 数（不小于3）
+ * @param voxel_size 体素边长
+ * @param output 输出点数据（容量不小于 count * stride）
+ * @param output_count 输出点数
+ * @return int 0成功，其他失败
+ */
+int pointcloud_voxel_downsample(const float* points, uint32_t count, uint32_t stride, float voxel_size,
+                                float* output, uint32_t* output_count);
+
+/**
+ * @brief 求使体素降采样结果不超过 target_points 个点的最小体素边长（二分搜索）
+ *
+ * @param points 点数据，每个点 stride 个 float
+ * @param count 点数
+ * @param stride 每个点的 float 数（不小于3）
+ * @param target_points 目标点数
+ * @return float 体素边长，失败返回0
+ */
+float pointcloud_voxel_size_for_target(const float* points, uint32_t count, uint32_t stride,
+                                       uint32_t target_points);
+
+/**
+ * @brief 由邻居点的协方差估计法向量
+ *
+ * 法向量为协方差矩阵最小特征值对应的单位特征向量，朝向 viewpoint 一侧。
+ * 邻居少于3个或退化时输出零向量。
+ *
+ * @param points 点数据，每个点 stride 个 float
+ * @param stride 每个点的 float 数（不小于3）
+ * @param neighbors 邻居下标
+ * @param count 邻居数
+ * @param viewpoint 视点 x、y、z
+ * @param normal 输出法向量
+ */
+void pointcloud_estimate_normal(const float* points, uint32_t stride, const uint32_t* neighbors,
+                                uint32_t count, const float viewpoint[3], float normal[3]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_POINTCLOUD_UTILS_H
@@ -1,44 +1,315 @@
 #include "utils/preprocessing.h"
+#include "utils/preprocessing_internal.h"
 #include "utils/logger.h"
+#include "utils/thread_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <pthread.h>
-
-/**
- * @brief 预处理操作内部结构
- */
-struct PreprocessOp {
-    preprocess_params_t params;
-    custom_preprocess_func_t custom_func;
-    void* context;
-    bool enable_cache;
-    pthread_mutex_t mutex;
-};
-
-/**
- * @brief 预处理管道内部结构
- */
-struct PreprocessPipeline {
-    preprocess_op_t* ops;
-    uint32_t op_count;
-    uint32_t capacity;
-    uint32_t num_threads;
-    pthread_mutex_t mutex;
-};
+#include <sys/time.h>
 
 // 全局预处理函数注册表
 static custom_preprocess_func_t g_preprocess_funcs[PREPROCESS_CUSTOM + 1] = {0};
 static pthread_mutex_t g_registry_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 // 前向声明
-static int normalize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params);
-static int resize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params);
+static int normalize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                             uint32_t num_threads);
+static int resize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                          uint32_t num_threads);
 static int rotate_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params);
-static int flip_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params);
+static int flip_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                        uint32_t num_threads);
 static int pad_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params);
-static int crop_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params);
+static int crop_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                        uint32_t num_threads);
+static int transpose_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params);
+static int cast_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                        uint32_t num_threads);
+static bool op_has_builtin_kernel(preprocess_type_e type);
+static int prepare_op_output(preprocess_op_t op, const Tensor* input, Tensor* output);
+static void release_segments(preprocess_pipeline_t pipeline);
+
+// ================================
+// 内部工具函数
+// ================================
+
+int preprocess_image_dims_from_shape(const TensorShape* shape, TensorFormat format,
+                                     preprocess_image_dims_t* dims) {
+    if (!shape || !dims) return -1;
+    
+    memset(dims, 0, sizeof(*dims));
+    dims->nchw = (format == TENSOR_FORMAT_NCHW);
+    
+    const uint32_t* d = shape->dims;
+    if (shape->ndim == 4) {
+        dims->has_batch = true;
+        dims->n = d[0];
+        if (dims->nchw) {
+            dims->c = d[1]; dims->h = d[2]; dims->w = d[3];
+        } else {
+            dims->h = d[1]; dims->w = d[2]; dims->c = d[3];
+        }
+    } else if (shape->ndim == 3) {
+        dims->has_batch = false;
+        dims->n = 1;
+        if (dims->nchw) {
+            dims->c = d[0]; dims->h = d[1]; dims->w = d[2];
+        } else {
+            dims->h = d[0]; dims->w = d[1]; dims->c = d[2];
+        }
+    } else {
+        return -1;
+    }
+    
+    if (dims->n == 0 || dims->h == 0 || dims->w == 0 || dims->c == 0) return -1;
+    
+    return 0;
+}
+
+TensorShape preprocess_image_dims_to_shape(const preprocess_image_dims_t* dims) {
+    TensorShape shape = {0};
+    uint32_t i = 0;
+    
+    if (dims->has_batch) shape.dims[i++] = dims->n;
+    if (dims->nchw) {
+        shape.dims[i++] = dims->c;
+        shape.dims[i++] = dims->h;
+        shape.dims[i++] = dims->w;
+    } else {
+        shape.dims[i++] = dims->h;
+        shape.dims[i++] = dims->w;
+        shape.dims[i++] = dims->c;
+    }
+    shape.ndim = i;
+    
+    return shape;
+}
+
+size_t preprocess_shape_bytes(const TensorShape* shape, TensorDataType dtype) {
+    if (!shape || shape->ndim == 0) return 0;
+    
+    size_t count = 1;
+    for (uint32_t i = 0; i < shape->ndim; i++) {
+        count *= shape->dims[i];
+    }
+    return count * tensor_get_dtype_size(dtype);
+}
+
+int preprocess_prepare_output(Tensor* output, const TensorShape* shape, TensorDataType dtype,
+                              TensorFormat format) {
+    if (!output || !shape) return -1;
+    
+    size_t bytes = preprocess_shape_bytes(shape, dtype);
+    if (bytes == 0) return -1;
+    
+    if (output->data) {
+        // 调用方提供了缓冲区，只检查容量
+        if (output->size < bytes) {
+            LOG_ERROR("Output buffer too small: %zu < %zu", output->size, bytes);
+            return -1;
+        }
+    } else {
+        output->data = malloc(bytes);
+        if (!output->data) {
+            LOG_ERROR("Failed to allocate output buffer (%zu bytes)", bytes);
+            return -1;
+        }
+        output->owns_data = true;
+        output->memory_type = TENSOR_MEMORY_CPU;
+    }
+    
+    output->shape = *shape;
+    output->dtype = dtype;
+    output->format = format;
+    output->size = bytes;
+    if (output->ref_count == 0) output->ref_count = 1;
+    
+    return 0;
+}
+
+// 工作区按缓存行对齐，逐线程的切分互不共享缓存行
+#define WORKSPACE_ALIGNMENT 64
+
+size_t preprocess_workspace_stride(size_t bytes) {
+    return (bytes + WORKSPACE_ALIGNMENT - 1) & ~(size_t)(WORKSPACE_ALIGNMENT - 1);
+}
+
+void* preprocess_workspace_reserve(preprocess_workspace_t* workspace, size_t bytes) {
+    if (bytes == 0) bytes = 1;
+    
+    if (workspace && workspace->size >= bytes) {
+        return workspace->data;
+    }
+    
+    void* data = NULL;
+    if (posix_memalign(&data, WORKSPACE_ALIGNMENT, preprocess_workspace_stride(bytes)) != 0) {
+        LOG_ERROR("Failed to allocate kernel workspace (%zu bytes)", bytes);
+        return NULL;
+    }
+    
+    if (workspace) {
+        free(workspace->data);
+        workspace->data = data;
+        workspace->size = preprocess_workspace_stride(bytes);
+    }
+    return data;
+}
+
+void preprocess_workspace_release(preprocess_workspace_t* workspace, void* data) {
+    if (!workspace) free(data);
+}
+
+void preprocess_workspace_free(preprocess_workspace_t* workspace) {
+    if (!workspace) return;
+    
+    free(workspace->data);
+    workspace->data = NULL;
+    workspace->size = 0;
+}
+
+float preprocess_load_element(const void* data, TensorDataType dtype, size_t index) {
+    switch (dtype) {
+        case TENSOR_TYPE_FLOAT32: return ((const float*)data)[index];
+        case TENSOR_TYPE_FLOAT64: return (float)((const double*)data)[index];
+        case TENSOR_TYPE_INT32:   return (float)((const int32_t*)data)[index];
+        case TENSOR_TYPE_INT64:   return (float)((const int64_t*)data)[index];
+        case TENSOR_TYPE_INT16:   return (float)((const int16_t*)data)[index];
+        case TENSOR_TYPE_INT8:    return (float)((const int8_t*)data)[index];
+        case TENSOR_TYPE_UINT8:   return (float)((const uint8_t*)data)[index];
+        case TENSOR_TYPE_BOOL:    return ((const uint8_t*)data)[index] ? 1.0f : 0.0f;
+        default:                  return 0.0f;
+    }
+}
+
+// 四舍五入并饱和到 [lo, hi]
+static inline float round_clamp(float value, float lo, float hi) {
+    value = floorf(value + 0.5f);
+    if (value < lo) return lo;
+    if (value > hi) return hi;
+    return value;
+}
+
+void preprocess_store_element(void* data, TensorDataType dtype, size_t index, float value) {
+    switch (dtype) {
+        case TENSOR_TYPE_FLOAT32: ((float*)data)[index] = value; break;
+        case TENSOR_TYPE_FLOAT64: ((double*)data)[index] = value; break;
+        case TENSOR_TYPE_INT32:   ((int32_t*)data)[index] = (int32_t)round_clamp(value, -2147483648.0f, 2147483520.0f); break;
+        case TENSOR_TYPE_INT64:   ((int64_t*)data)[index] = (int64_t)floorf(value + 0.5f); break;
+        case TENSOR_TYPE_INT16:   ((int16_t*)data)[index] = (int16_t)round_clamp(value, -32768.0f, 32767.0f); break;
+        case TENSOR_TYPE_INT8:    ((int8_t*)data)[index] = (int8_t)round_clamp(value, -128.0f, 127.0f); break;
+        case TENSOR_TYPE_UINT8:   ((uint8_t*)data)[index] = (uint8_t)round_clamp(value, 0.0f, 255.0f); break;
+        case TENSOR_TYPE_BOOL:    ((uint8_t*)data)[index] = value != 0.0f; break;
+        default: break;
+    }
+}
+
+TensorDataType preprocess_op_output_dtype(preprocess_op_t op, TensorDataType input_dtype) {
+    if (!op) return input_dtype;
+    
+    switch (op->params.type) {
+        case PREPROCESS_NORMALIZE:
+            return TENSOR_TYPE_FLOAT32;
+        case PREPROCESS_CAST:
+            return op->params.params.cast.dtype;
+        case PREPROCESS_RESAMPLE:
+        case PREPROCESS_WINDOWING:
+        case PREPROCESS_FFT:
+        case PREPROCESS_SPECTROGRAM:
+        case PREPROCESS_MFCC:
+            return TENSOR_TYPE_FLOAT32;
+        case PREPROCESS_TOKENIZE:
+            return TENSOR_TYPE_INT32;
+        case PREPROCESS_COLOR_CONVERT:
+            return TENSOR_TYPE_UINT8;
+        case PREPROCESS_QUANTIZE:
+            return op->params.params.quantize.dtype;
+        case PREPROCESS_DEQUANTIZE:
+            return TENSOR_TYPE_FLOAT32;
+        default:
+            return input_dtype;
+    }
+}
+
+// 判断转置是否为 NHWC<->NCHW（或 HWC<->CHW）的布局切换
+static bool transpose_is_layout_swap(const preprocess_params_t* params, bool* to_nchw) {
+    const uint32_t* p = params->params.transpose.perm;
+    
+    if (params->params.transpose.ndim == 4) {
+        if (p[0] == 0 && p[1] == 3 && p[2] == 1 && p[3] == 2) { *to_nchw = true; return true; }
+        if (p[0] == 0 && p[1] == 2 && p[2] == 3 && p[3] == 1) { *to_nchw = false; return true; }
+    } else if (params->params.transpose.ndim == 3) {
+        if (p[0] == 2 && p[1] == 0 && p[2] == 1) { *to_nchw = true; return true; }
+        if (p[0] == 1 && p[1] == 2 && p[2] == 0) { *to_nchw = false; return true; }
+    }
+    
+    return false;
+}
+
+TensorFormat preprocess_op_output_format(preprocess_op_t op, const TensorShape* input_shape,
+                                         TensorFormat input_format) {
+    if (op && (preprocess_audio_is_op(op->params.type) || op->params.type == PREPROCESS_TOKENIZE)) {
+        return TENSOR_FORMAT_NC;
+    }
+    if (op && op->params.type == PREPROCESS_COLOR_CONVERT) {
+        return TENSOR_FORMAT_NHWC;
+    }
+    if (!op || op->params.type != PREPROCESS_TRANSPOSE) return input_format;
+    
+    bool to_nchw = false;
+    if (input_shape && input_shape->ndim == op->params.params.transpose.ndim &&
+        transpose_is_layout_swap(&op->params, &to_nchw)) {
+        return to_nchw ? TENSOR_FORMAT_NCHW : TENSOR_FORMAT_NHWC;
+    }
+    
+    return input_format;
+}
+
+static bool op_has_builtin_kernel(preprocess_type_e type) {
+    switch (type) {
+        case PREPROCESS_NORMALIZE:
+        case PREPROCESS_RESIZE:
+        case PREPROCESS_FLIP:
+        case PREPROCESS_CROP:
+        case PREPROCESS_TRANSPOSE:
+        case PREPROCESS_CAST:
+        case PREPROCESS_BRIGHTNESS:
+        case PREPROCESS_CONTRAST:
+        case PREPROCESS_GAMMA:
+        case PREPROCESS_HISTOGRAM_EQ:
+        case PREPROCESS_RESAMPLE:
+        case PREPROCESS_WINDOWING:
+        case PREPROCESS_FFT:
+        case PREPROCESS_SPECTROGRAM:
+        case PREPROCESS_MFCC:
+        case PREPROCESS_TOKENIZE:
+        case PREPROCESS_NORMAL_ESTIMATION:
+        case PREPROCESS_QUANTIZE:
+        case PREPROCESS_DEQUANTIZE:
+        case PREPROCESS_COLOR_CONVERT:
+        case PREPROCESS_BLUR:
+        case PREPROCESS_SHARPEN:
+        case PREPROCESS_EDGE_DETECT:
+        case PREPROCESS_MORPHOLOGY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static int prepare_op_output(preprocess_op_t op, const Tensor* input, Tensor* output) {
+    TensorShape out_shape;
+    if (preprocess_op_infer_shape(op, &input->shape, input->format, &out_shape) != 0) {
+        return -1;
+    }
+    
+    TensorFormat format = preprocess_op_output_format(op, &input->shape, input->format);
+    TensorDataType dtype = preprocess_op_output_dtype(op, input->dtype);
+    
+    return preprocess_prepare_output(output, &out_shape, dtype, format);
+}
+
 
 preprocess_op_t preprocess_op_create(preprocess_type_e type, const preprocess_params_t* params) {
     if (!params || !preprocess_validate_params(type, params)) {
@@ -53,6 +324,7 @@ preprocess_op_t preprocess_op_create(preprocess_type_e type, const preprocess_pa
     }
     
     op->params = *params;
+    op->params.type = type;
     op->enable_cache = false;
     
     if (pthread_mutex_init(&op->mutex, NULL) != 0) {
@@ -69,26 +341,27 @@ preprocess_op_t preprocess_op_create(preprocess_type_e type, const preprocess_pa
 void preprocess_op_destroy(preprocess_op_t op) {
     if (!op) return;
     
+    audio_frontend_destroy(op->audio);
+    audio_resampler_destroy(op->resampler);
     pthread_mutex_destroy(&op->mutex);
     free(op);
     LOG_DEBUG("Destroyed preprocessing operation");
 }
 
-int preprocess_op_execute(preprocess_op_t op, const Tensor* input, Tensor* output) {
-    if (!op || !input || !output) return -1;
-    
-    pthread_mutex_lock(&op->mutex);
-    
+// 按操作类型分派内核；内置内核的输出缓冲区须已按推断的形状准备好
+// 内置内核只读取参数，可并发执行；自定义函数的上下文由操作锁保护
+// workspace 为内核临时内存，并发执行时各自使用不同的工作区
+static int op_run(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                  preprocess_workspace_t* workspace) {
     int ret = 0;
     
-    // 根据操作类型执行相应的处理
     switch (op->params.type) {
         case PREPROCESS_NORMALIZE:
-            ret = normalize_execute(input, output, &op->params);
+            ret = normalize_execute(input, output, &op->params, num_threads);
             break;
             
         case PREPROCESS_RESIZE:
-            ret = resize_execute(input, output, &op->params);
+            ret = resize_execute(input, output, &op->params, num_threads);
             break;
             
         case PREPROCESS_ROTATE:
@@ -96,7 +369,7 @@ int preprocess_op_execute(preprocess_op_t op, const Tensor* input, Tensor* outpu
             break;
             
         case PREPROCESS_FLIP:
-            ret = flip_execute(input, output, &op->params);
+            ret = flip_execute(input, output, &op->params, num_threads);
             break;
             
         case PREPROCESS_PAD:
@@ -104,12 +377,66 @@ int preprocess_op_execute(preprocess_op_t op, const Tensor* input, Tensor* outpu
             break;
             
         case PREPROCESS_CROP:
-            ret = crop_execute(input, output, &op->params);
+            ret = crop_execute(input, output, &op->params, num_threads);
+            break;
+            
+        case PREPROCESS_TRANSPOSE:
+            ret = transpose_execute(input, output, &op->params);
+            break;
+            
+        case PREPROCESS_CAST:
+            ret = cast_execute(input, output, &op->params, num_threads);
+            break;
+            
+        case PREPROCESS_BRIGHTNESS:
+        case PREPROCESS_CONTRAST:
+        case PREPROCESS_GAMMA:
+        case PREPROCESS_HISTOGRAM_EQ:
+            ret = preprocess_lut_execute(&op, 1, input, output, num_threads, workspace);
+            break;
+            
+        case PREPROCESS_RESAMPLE:
+            ret = preprocess_resample_execute(op, input, output, num_threads, workspace);
+            break;
+            
+        case PREPROCESS_WINDOWING:
+        case PREPROCESS_FFT:
+        case PREPROCESS_SPECTROGRAM:
+        case PREPROCESS_MFCC:
+            ret = preprocess_audio_execute(op, input, output, num_threads, workspace);
+            break;
+            
+        case PREPROCESS_TOKENIZE:
+            ret = preprocess_tokenize_execute(op, input, output, num_threads);
+            break;
+            
+        case PREPROCESS_QUANTIZE:
+        case PREPROCESS_DEQUANTIZE:
+            ret = preprocess_quant_execute(op, input, output, num_threads, workspace);
+            break;
+            
+        case PREPROCESS_COLOR_CONVERT:
+            ret = preprocess_color_execute(op, input, output, num_threads, workspace);
+            break;
+            
+        case PREPROCESS_BLUR:
+        case PREPROCESS_SHARPEN:
+        case PREPROCESS_EDGE_DETECT:
+        case PREPROCESS_MORPHOLOGY:
+            ret = preprocess_filter_execute(op, input, output, num_threads, workspace);
+            break;
+            
+        case PREPROCESS_DOWNSAMPLE:
+        case PREPROCESS_OUTLIER_REMOVAL:
+        case PREPROCESS_NORMAL_ESTIMATION:
+            ret = preprocess_pointcloud_execute(op, input, output, num_threads);
             break;
             
         case PREPROCESS_CUSTOM:
             if (op->custom_func) {
+                pthread_mutex_lock(&op->mutex);
                 ret = op->custom_func(input, output, &op->params.params.custom, op->context);
+                pthread_mutex_unlock(&op->mutex);
             } else {
                 LOG_ERROR("Custom preprocessing function not set");
                 ret = -1;
@@ -120,7 +447,9 @@ int preprocess_op_execute(preprocess_op_t op, const Tensor* input, Tensor* outpu
             // 检查全局注册的函数
             pthread_mutex_lock(&g_registry_mutex);
             if (g_preprocess_funcs[op->params.type]) {
+                pthread_mutex_lock(&op->mutex);
                 ret = g_preprocess_funcs[op->params.type](input, output, &op->params.params.custom, op->context);
+                pthread_mutex_unlock(&op->mutex);
             } else {
                 LOG_ERROR("Unsupported preprocessing operation: %s", preprocess_type_to_string(op->params.type));
                 ret = -1;
@@ -129,8 +458,6 @@ int preprocess_op_execute(preprocess_op_t op, const Tensor* input, Tensor* outpu
             break;
     }
     
-    pthread_mutex_unlock(&op->mutex);
-    
     if (ret == 0) {
         LOG_DEBUG("Successfully executed preprocessing operation: %s", 
                   preprocess_type_to_string(op->params.type));
@@ -142,6 +469,28 @@ int preprocess_op_execute(preprocess_op_t op, const Tensor* input, Tensor* outpu
     return ret;
 }
 
+// 执行单个操作，内置内核按行分块在共享线程池上并行
+static int op_execute(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                      preprocess_workspace_t* workspace) {
+    if (!op || !input || !output) return -1;
+    
+    // 内置内核统一在这里准备输出缓冲区
+    if (op_has_builtin_kernel(op->params.type)) {
+        int ret = prepare_op_output(op, input, output);
+        if (ret != 0) {
+            LOG_ERROR("Failed to prepare output for operation: %s",
+                      preprocess_type_to_string(op->params.type));
+            return ret;
+        }
+    }
+    
+    return op_run(op, input, output, num_threads, workspace);
+}
+
+int preprocess_op_execute(preprocess_op_t op, const Tensor* input, Tensor* output) {
+    return op_execute(op, input, output, 1, NULL);
+}
+
 preprocess_pipeline_t preprocess_pipeline_create(void) {
     preprocess_pipeline_t pipeline = calloc(1, sizeof(struct PreprocessPipeline));
     if (!pipeline) {
@@ -159,6 +508,8 @@ preprocess_pipeline_t preprocess_pipeline_create(void) {
     
     pipeline->op_count = 0;
     pipeline->num_threads = 1;
+    pipeline->enable_fusion = true;
+    pipeline->compiled = false;
     
     if (pthread_mutex_init(&pipeline->mutex, NULL) != 0) {
         LOG_ERROR("Failed to initialize pipeline mutex");
@@ -166,6 +517,13 @@ preprocess_pipeline_t preprocess_pipeline_create(void) {
         free(pipeline);
         return NULL;
     }
+    if (pthread_mutex_init(&pipeline->scratch_mutex, NULL) != 0) {
+        LOG_ERROR("Failed to initialize pipeline scratch mutex");
+        pthread_mutex_destroy(&pipeline->mutex);
+        free(pipeline->ops);
+        free(pipeline);
+        return NULL;
+    }
     
     LOG_DEBUG("Created preprocessing pipeline");
     
@@ -181,6 +539,18 @@ void preprocess_pipeline_destroy(preprocess_pipeline_t pipeline) {
     }
     
     free(pipeline->ops);
+    release_segments(pipeline);
+    
+    while (pipeline->free_scratch) {
+        preprocess_scratch_t* scratch = pipeline->free_scratch;
+        pipeline->free_scratch = scratch->link;
+        free(scratch->data[0]);
+        free(scratch->data[1]);
+        preprocess_workspace_free(&scratch->workspace);
+        free(scratch);
+    }
+    
+    pthread_mutex_destroy(&pipeline->scratch_mutex);
     pthread_mutex_destroy(&pipeline->mutex);
     free(pipeline);
     
@@ -208,103 +578,1005 @@ int preprocess_pipeline_add_op(preprocess_pipeline_t pipeline, preprocess_op_t o
     
     pipeline->ops[pipeline->op_count] = op;
     pipeline->op_count++;
+    pipeline->compiled = false;
+    
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    LOG_DEBUG("Added operation to pipeline, count: %u", pipeline->op_count);
+    
+    return 0;
+}
+
+int preprocess_pipeline_remove_op(preprocess_pipeline_t pipeline, uint32_t index) {
+    if (!pipeline || index >= pipeline->op_count) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    
+    // 销毁要移除的操作
+    preprocess_op_destroy(pipeline->ops[index]);
+    
+    // 移动后续操作
+    if (index < pipeline->op_count - 1) {
+        memmove(&pipeline->ops[index], &pipeline->ops[index + 1],
+                (pipeline->op_count - index - 1) * sizeof(preprocess_op_t));
+    }
+    
+    pipeline->op_count--;
+    pipeline->compiled = false;
+    
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    LOG_DEBUG("Removed operation from pipeline, count: %u", pipeline->op_count);
+    
+    return 0;
+}
+
+// 释放静态缓冲区计划；计划依赖段划分，段重建时一并失效
+static void release_plan(preprocess_pipeline_t pipeline) {
+    preprocess_plan_t* plan = pipeline->plan;
+    if (!plan) return;
+    
+    for (uint32_t i = 0; i < plan->step_count; i++) {
+        preprocess_fusion_unbind(&plan->steps[i].binding);
+    }
+    if (plan->handle) {
+        memory_pool_free(plan->config.memory_pool, plan->handle);
+    } else {
+        free(plan->arena);
+    }
+    preprocess_workspace_free(&plan->workspace);
+    free(plan->steps);
+    free(plan);
+    pipeline->plan = NULL;
+}
+
+static void release_segments(preprocess_pipeline_t pipeline) {
+    release_plan(pipeline);
+    for (uint32_t i = 0; i < pipeline->segment_count; i++) {
+        preprocess_fusion_unbind(&pipeline->segments[i].binding);
+    }
+    free(pipeline->segments);
+    pipeline->segments = NULL;
+    pipeline->segment_count = 0;
+}
+
+// 将操作序列划分为融合组和回退操作，调用方需持有管道锁
+static int compile_locked(preprocess_pipeline_t pipeline) {
+    release_segments(pipeline);
+    memset(&pipeline->fusion_stats, 0, sizeof(pipeline->fusion_stats));
+    
+    if (pipeline->op_count == 0) {
+        pipeline->compiled = true;
+        return 0;
+    }
+    
+    pipeline->segments = calloc(pipeline->op_count, sizeof(preprocess_segment_t));
+    if (!pipeline->segments) {
+        LOG_ERROR("Failed to allocate pipeline segments");
+        return -1;
+    }
+    
+    uint32_t i = 0;
+    while (i < pipeline->op_count) {
+        preprocess_segment_t* seg = &pipeline->segments[pipeline->segment_count++];
+        seg->first_op = i;
+        seg->op_count = 0;
+        
+        // 连续的查找表操作组合为一张表
+        if (pipeline->enable_fusion) {
+            while (i + seg->op_count < pipeline->op_count &&
+                   preprocess_lut_is_op(pipeline->ops[i + seg->op_count]->params.type)) {
+                seg->op_count++;
+            }
+            if (seg->op_count >= 2) {
+                seg->lut = true;
+                pipeline->fusion_stats.fused_groups++;
+                pipeline->fusion_stats.fused_ops += seg->op_count;
+                i += seg->op_count;
+                continue;
+            }
+            seg->op_count = 0;
+        }
+        
+        if (pipeline->enable_fusion) {
+            while (i + seg->op_count < pipeline->op_count &&
+                   preprocess_fusion_accepts(&seg->kernel, seg->op_count,
+                                             pipeline->ops[i + seg->op_count])) {
+                preprocess_fusion_append(&seg->kernel, pipeline->ops[i + seg->op_count]);
+                seg->op_count++;
+            }
+        }
+        
+        // 单个操作没有融合收益，按原操作执行
+        if (seg->op_count >= 2) {
+            seg->fused = true;
+            pipeline->fusion_stats.fused_groups++;
+            pipeline->fusion_stats.fused_ops += seg->op_count;
+        } else {
+            memset(&seg->kernel, 0, sizeof(seg->kernel));
+            seg->op_count = 1;
+            seg->fused = false;
+            pipeline->fusion_stats.fallback_ops++;
+        }
+        
+        i += seg->op_count;
+    }
+    
+    pipeline->compiled = true;
+    
+    LOG_DEBUG("Compiled preprocessing pipeline: %u ops -> %u segments (%u fused groups)",
+              pipeline->op_count, pipeline->segment_count, pipeline->fusion_stats.fused_groups);
+    
+    return 0;
+}
+
+int preprocess_pipeline_compile(preprocess_pipeline_t pipeline) {
+    if (!pipeline) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    int ret = compile_locked(pipeline);
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return ret;
+}
+
+int preprocess_pipeline_set_fusion(preprocess_pipeline_t pipeline, bool enable) {
+    if (!pipeline) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    if (pipeline->enable_fusion != enable) {
+        pipeline->enable_fusion = enable;
+        pipeline->compiled = false;
+    }
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return 0;
+}
+
+int preprocess_pipeline_get_fusion_stats(preprocess_pipeline_t pipeline, preprocess_fusion_stats_t* stats) {
+    if (!pipeline || !stats) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    if (!pipeline->compiled) {
+        compile_locked(pipeline);
+    }
+    *stats = pipeline->fusion_stats;
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return 0;
+}
+
+// 取一组乒乓缓冲区，空闲链表为空时新建
+static preprocess_scratch_t* acquire_scratch(preprocess_pipeline_t pipeline) {
+    pthread_mutex_lock(&pipeline->scratch_mutex);
+    preprocess_scratch_t* scratch = pipeline->free_scratch;
+    if (scratch) {
+        pipeline->free_scratch = scratch->link;
+    }
+    pthread_mutex_unlock(&pipeline->scratch_mutex);
+    
+    if (!scratch) {
+        scratch = calloc(1, sizeof(preprocess_scratch_t));
+        if (!scratch) {
+            LOG_ERROR("Failed to allocate scratch buffers");
+        }
+    }
+    
+    return scratch;
+}
+
+static void release_scratch(preprocess_pipeline_t pipeline, preprocess_scratch_t* scratch) {
+    if (!scratch) return;
+    
+    pthread_mutex_lock(&pipeline->scratch_mutex);
+    scratch->link = pipeline->free_scratch;
+    pipeline->free_scratch = scratch;
+    pthread_mutex_unlock(&pipeline->scratch_mutex);
+}
+
+// 为即将写出的中间结果分配乒乓缓冲区；bytes 为0表示无法推断，由操作自行分配
+static int scratch_claim(preprocess_scratch_t* scratch, size_t bytes, Tensor* tensor,
+                         preprocess_fusion_stats_t* stats) {
+    uint32_t slot = scratch->next;
+    scratch->next ^= 1;
+    scratch->pending = slot;
+    
+    memset(tensor, 0, sizeof(Tensor));
+    if (bytes == 0) return 0;
+    
+    if (bytes > scratch->size[slot]) {
+        free(scratch->data[slot]);
+        scratch->data[slot] = malloc(bytes);
+        if (!scratch->data[slot]) {
+            scratch->size[slot] = 0;
+            LOG_ERROR("Failed to allocate scratch buffer (%zu bytes)", bytes);
+            return -1;
+        }
+        scratch->size[slot] = bytes;
+        stats->scratch_allocs++;
+    }
+    
+    tensor->data = scratch->data[slot];
+    tensor->size = scratch->size[slot];
+    tensor->memory_type = TENSOR_MEMORY_CPU;
+    tensor->owns_data = false;
+    return 0;
+}
+
+// 操作自行分配了中间结果时，由乒乓缓冲区接管该内存
+static void scratch_adopt(preprocess_scratch_t* scratch, Tensor* tensor, preprocess_fusion_stats_t* stats) {
+    if (!tensor->owns_data) return;
+    
+    uint32_t slot = scratch->pending;
+    free(scratch->data[slot]);
+    scratch->data[slot] = tensor->data;
+    scratch->size[slot] = tensor->size;
+    tensor->owns_data = false;
+    stats->scratch_allocs++;
+}
+
+// 推断操作输出字节数（自定义操作返回0）
+static size_t op_output_bytes(preprocess_op_t op, const Tensor* input) {
+    if (!op_has_builtin_kernel(op->params.type)) return 0;
+    
+    TensorShape shape;
+    if (preprocess_op_infer_shape(op, &input->shape, input->format, &shape) != 0) return 0;
+    return preprocess_shape_bytes(&shape, preprocess_op_output_dtype(op, input->dtype));
+}
+
+// 逐操作执行 ops[first, first+count)，中间结果写入乒乓缓冲区
+// to_scratch 表示最后一个操作的输出同样是中间结果
+static int run_ops(preprocess_pipeline_t pipeline, uint32_t first, uint32_t count,
+                   const Tensor* input, Tensor* output, uint32_t num_threads,
+                   preprocess_scratch_t* scratch, bool to_scratch, preprocess_fusion_stats_t* stats,
+                   uint64_t* traffic) {
+    Tensor current = *input;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        preprocess_op_t op = pipeline->ops[first + i];
+        bool last = (i == count - 1);
+        Tensor next = {0};
+        Tensor* dst = last ? output : &next;
+        bool scratch_dst = !last || to_scratch;
+        
+        if (scratch_dst && scratch_claim(scratch, op_output_bytes(op, &current), dst, stats) != 0) {
+            return -1;
+        }
+        
+        int ret = op_execute(op, &current, dst, num_threads, &scratch->workspace);
+        if (scratch_dst) {
+            scratch_adopt(scratch, dst, stats);
+        }
+        
+        if (ret != 0) {
+            LOG_ERROR("Failed to execute operation %u in pipeline", first + i);
+            return ret;
+        }
+        
+        *traffic += preprocess_shape_bytes(&current.shape, current.dtype) +
+                    preprocess_shape_bytes(&dst->shape, dst->dtype);
+        current = *dst;
+    }
+    
+    return 0;
+}
+
+// 计算逐操作执行一个融合组时的内存流量
+static uint64_t segment_unfused_traffic(preprocess_pipeline_t pipeline, const preprocess_segment_t* seg,
+                                        const Tensor* input) {
+    TensorShape shape = input->shape;
+    TensorFormat format = input->format;
+    TensorDataType dtype = input->dtype;
+    uint64_t traffic = 0;
+    
+    for (uint32_t i = 0; i < seg->op_count; i++) {
+        preprocess_op_t op = pipeline->ops[seg->first_op + i];
+        TensorShape next_shape;
+        if (preprocess_op_infer_shape(op, &shape, format, &next_shape) != 0) {
+            return 0;
+        }
+        TensorDataType next_dtype = preprocess_op_output_dtype(op, dtype);
+        traffic += preprocess_shape_bytes(&shape, dtype) + preprocess_shape_bytes(&next_shape, next_dtype);
+        format = preprocess_op_output_format(op, &shape, format);
+        shape = next_shape;
+        dtype = next_dtype;
+    }
+    
+    return traffic;
+}
+
+/**
+ * @brief 融合内核区间上下文
+ */
+typedef struct {
+    const preprocess_fused_binding_t* binding;
+    const Tensor* input;
+    Tensor* output;
+    uint8_t* work;                  /**< 每个工作槽一份行缓冲区 */
+    size_t work_stride;             /**< 相邻工作槽的间距 */
+} fused_rows_job_t;
+
+static void fused_rows_range(void* context, uint32_t slot, size_t begin, size_t end) {
+    const fused_rows_job_t* job = (const fused_rows_job_t*)context;
+    preprocess_fusion_run_rows(job->binding, job->input, job->output, (uint32_t)begin, (uint32_t)end,
+                               job->work + slot * job->work_stride);
+}
+
+// 融合组按 num_threads 并行时全部工作槽的行缓冲区字节数
+static size_t fused_work_bytes(const preprocess_fused_binding_t* binding, uint32_t num_threads) {
+    return preprocess_workspace_stride(binding->work_bytes) * preprocess_parallel_slots(num_threads);
+}
+
+// 在工作区中为融合组的每个工作槽取一份行缓冲区后逐行执行
+static int run_fused_rows(const preprocess_fused_binding_t* binding, const Tensor* input, Tensor* output,
+                          size_t rows, size_t bytes_per_row, uint32_t num_threads,
+                          preprocess_workspace_t* workspace) {
+    fused_rows_job_t job = {binding, input, output, NULL, preprocess_workspace_stride(binding->work_bytes)};
+    job.work = preprocess_workspace_reserve(workspace, fused_work_bytes(binding, num_threads));
+    if (!job.work) return -1;
+    
+    preprocess_parallel_for_slots(num_threads, rows, bytes_per_row, fused_rows_range, &job);
+    return 0;
+}
+
+// 执行一个段；stats 为统计累加目标（批量并行时为每个样本的局部统计）
+static int run_segment(preprocess_pipeline_t pipeline, preprocess_segment_t* seg,
+                       const Tensor* input, Tensor* output, uint32_t num_threads,
+                       preprocess_scratch_t* scratch, bool to_scratch,
+                       preprocess_fusion_stats_t* stats) {
+    uint64_t traffic = 0;
+    
+    if (seg->lut && input->dtype == TENSOR_TYPE_UINT8) {
+        size_t bytes = preprocess_shape_bytes(&input->shape, input->dtype);
+        if (to_scratch && scratch_claim(scratch, bytes, output, stats) != 0) {
+            return -1;
+        }
+        
+        int ret = preprocess_prepare_output(output, &input->shape, input->dtype, input->format);
+        if (ret != 0) return ret;
+        
+        ret = preprocess_lut_execute(&pipeline->ops[seg->first_op], seg->op_count, input, output, num_threads,
+                                     &scratch->workspace);
+        if (ret != 0) return ret;
+        
+        // 均衡化需要额外读一遍输入统计直方图
+        uint64_t histogram_reads = 0;
+        for (uint32_t i = 0; i < seg->op_count; i++) {
+            if (pipeline->ops[seg->first_op + i]->params.type == PREPROCESS_HISTOGRAM_EQ) {
+                histogram_reads += bytes;
+            }
+        }
+        stats->fused_bytes += 2 * bytes + (histogram_reads ? bytes : 0);
+        stats->unfused_bytes += 2 * bytes * seg->op_count + histogram_reads;
+        return 0;
+    }
+    
+    if (seg->fused) {
+        // 输入形状变化时重新绑定（预计算坐标表）
+        if (!seg->bound || seg->bound_dtype != input->dtype || seg->bound_format != input->format ||
+            !tensor_shape_equal(&seg->bound_shape, &input->shape)) {
+            preprocess_fusion_unbind(&seg->binding);
+            seg->bind_failed = preprocess_fusion_bind(&seg->kernel, input, &seg->binding) != 0;
+            if (!seg->bind_failed) {
+                seg->binding.unfused_bytes = segment_unfused_traffic(pipeline, seg, input);
+            }
+            seg->bound = true;
+            seg->bound_shape = input->shape;
+            seg->bound_dtype = input->dtype;
+            seg->bound_format = input->format;
+        }
+        
+        if (!seg->bind_failed) {
+            const preprocess_fused_binding_t* b = &seg->binding;
+            TensorShape out_shape = preprocess_image_dims_to_shape(&b->out);
+            TensorFormat out_format = b->out.nchw ? TENSOR_FORMAT_NCHW : TENSOR_FORMAT_NHWC;
+            
+            if (to_scratch &&
+                scratch_claim(scratch, preprocess_shape_bytes(&out_shape, b->out_dtype), output, stats) != 0) {
+                return -1;
+            }
+            
+            int ret = preprocess_prepare_output(output, &out_shape, b->out_dtype, out_format);
+            if (ret != 0) return ret;
+            
+            size_t bytes_per_row = (preprocess_shape_bytes(&input->shape, input->dtype) / (b->in.n * b->in.h) +
+                                    preprocess_shape_bytes(&out_shape, b->out_dtype) / (b->out.n * b->out.h));
+            ret = run_fused_rows(b, input, output, (size_t)b->out.n * b->out.h, bytes_per_row, num_threads,
+                                 &scratch->workspace);
+            if (ret != 0) return ret;
+            
+            stats->fused_bytes += b->fused_bytes;
+            stats->unfused_bytes += b->unfused_bytes;
+            return 0;
+        }
+        
+        LOG_DEBUG("Fused group at op %u cannot handle this input, falling back", seg->first_op);
+    }
+    
+    int ret = run_ops(pipeline, seg->first_op, seg->op_count, input, output, num_threads,
+                      scratch, to_scratch, stats, &traffic);
+    if (ret == 0) {
+        stats->fused_bytes += traffic;
+        stats->unfused_bytes += traffic;
+    }
+    
+    return ret;
+}
+
+// 依次执行所有段（调用方持有管道锁且管道已编译），中间结果在乒乓缓冲区间交替
+static int run_segments(preprocess_pipeline_t pipeline, const Tensor* input, Tensor* output,
+                        uint32_t num_threads, preprocess_fusion_stats_t* stats) {
+    if (pipeline->segment_count == 0) {
+        // 没有操作，直接复制输入到输出
+        size_t data_size = preprocess_shape_bytes(&input->shape, input->dtype);
+        int ret = preprocess_prepare_output(output, &input->shape, input->dtype, input->format);
+        if (ret != 0) return ret;
+        
+        memcpy(output->data, input->data, data_size);
+        return 0;
+    }
+    
+    preprocess_scratch_t* scratch = acquire_scratch(pipeline);
+    if (!scratch) return -1;
+    scratch->next = 0;
+    
+    Tensor current = *input;
+    int ret = 0;
+    
+    for (uint32_t i = 0; i < pipeline->segment_count; i++) {
+        bool last = (i == pipeline->segment_count - 1);
+        Tensor next = {0};
+        Tensor* dst = last ? output : &next;
+        
+        ret = run_segment(pipeline, &pipeline->segments[i], &current, dst, num_threads,
+                          scratch, !last, stats);
+        if (ret != 0) break;
+        
+        current = next;
+    }
+    
+    release_scratch(pipeline, scratch);
+    return ret;
+}
+
+// ================================
+// 静态缓冲区计划
+// ================================
+
+// 缓冲区区域按缓存行对齐
+#define PLAN_ALIGNMENT 64
+
+static size_t plan_align(size_t bytes) {
+    return (bytes + PLAN_ALIGNMENT - 1) & ~(size_t)(PLAN_ALIGNMENT - 1);
+}
+
+// 单个操作作为一步：要求内置内核且输出可静态推断
+static int plan_op_step(preprocess_pipeline_t pipeline, uint32_t index, const Tensor* input,
+                        preprocess_plan_step_t* step) {
+    preprocess_op_t op = pipeline->ops[index];
+    if (!op_has_builtin_kernel(op->params.type) ||
+        preprocess_op_infer_shape(op, &input->shape, input->format, &step->shape) != 0) {
+        LOG_ERROR("Operation %u (%s) has no statically inferable output", index,
+                  preprocess_type_to_string(op->params.type));
+        return -1;
+    }
+    
+    step->kind = PREPROCESS_PLAN_OP;
+    step->first_op = index;
+    step->op_count = 1;
+    step->dtype = preprocess_op_output_dtype(op, input->dtype);
+    step->format = preprocess_op_output_format(op, &input->shape, input->format);
+    step->bytes = preprocess_shape_bytes(&step->shape, step->dtype);
+    step->fused_bytes = preprocess_shape_bytes(&input->shape, input->dtype) + step->bytes;
+    step->unfused_bytes = step->fused_bytes;
+    return step->bytes > 0 ? 0 : -1;
+}
+
+// 沿段推断每一步的输出；无法融合的融合组拆为逐操作的步骤
+static int plan_steps(preprocess_pipeline_t pipeline, preprocess_plan_t* plan) {
+    Tensor current = {0};
+    current.shape = plan->config.input_shape;
+    current.dtype = plan->config.input_dtype;
+    current.format = plan->config.input_format;
+    
+    for (uint32_t i = 0; i < pipeline->segment_count; i++) {
+        preprocess_segment_t* seg = &pipeline->segments[i];
+        
+        if (seg->lut) {
+            if (current.dtype != TENSOR_TYPE_UINT8) {
+                LOG_ERROR("Lookup-table group at op %u requires UINT8 input", seg->first_op);
+                return -1;
+            }
+            preprocess_plan_step_t* step = &plan->steps[plan->step_count++];
+            size_t bytes = preprocess_shape_bytes(&current.shape, current.dtype);
+            uint64_t histogram_reads = 0;
+            for (uint32_t k = 0; k < seg->op_count; k++) {
+                if (pipeline->ops[seg->first_op + k]->params.type == PREPROCESS_HISTOGRAM_EQ) {
+                    histogram_reads += bytes;
+                }
+            }
+            step->kind = PREPROCESS_PLAN_LUT;
+            step->first_op = seg->first_op;
+            step->op_count = seg->op_count;
+            step->shape = current.shape;
+            step->dtype = current.dtype;
+            step->format = current.format;
+            step->bytes = bytes;
+            step->fused_bytes = 2 * bytes + (histogram_reads ? bytes : 0);
+            step->unfused_bytes = 2 * bytes * seg->op_count + histogram_reads;
+        } else if (seg->fused &&
+                   preprocess_fusion_bind(&seg->kernel, &current, &plan->steps[plan->step_count].binding) == 0) {
+            preprocess_plan_step_t* step = &plan->steps[plan->step_count++];
+            const preprocess_fused_binding_t* b = &step->binding;
+            step->kind = PREPROCESS_PLAN_FUSED;
+            step->first_op = seg->first_op;
+            step->op_count = seg->op_count;
+            step->shape = preprocess_image_dims_to_shape(&b->out);
+            step->dtype = b->out_dtype;
+            step->format = b->out.nchw ? TENSOR_FORMAT_NCHW : TENSOR_FORMAT_NHWC;
+            step->bytes = preprocess_shape_bytes(&step->shape, step->dtype);
+            step->rows = (size_t)b->out.n * b->out.h;
+            step->bytes_per_row = preprocess_shape_bytes(&current.shape, current.dtype) / (b->in.n * b->in.h) +
+                                  step->bytes / step->rows;
+            step->fused_bytes = b->fused_bytes;
+            step->unfused_bytes = segment_unfused_traffic(pipeline, seg, &current);
+        } else {
+            for (uint32_t k = 0; k < seg->op_count; k++) {
+                preprocess_plan_step_t* step = &plan->steps[plan->step_count];
+                if (plan_op_step(pipeline, seg->first_op + k, &current, step) != 0) return -1;
+                plan->step_count++;
+                current.shape = step->shape;
+                current.dtype = step->dtype;
+                current.format = step->format;
+            }
+            continue;
+        }
+        
+        const preprocess_plan_step_t* last = &plan->steps[plan->step_count - 1];
+        current.shape = last->shape;
+        current.dtype = last->dtype;
+        current.format = last->format;
+    }
+    
+    return 0;
+}
+
+// 中间结果交替放在两块区域，区域大小取各自承载的最大中间结果；绑定的输出放在最后
+static int plan_layout(preprocess_plan_t* plan) {
+    size_t slot_bytes[2] = {0, 0};
+    for (uint32_t i = 0; i + 1 < plan->step_count; i++) {
+        size_t bytes = plan_align(plan->steps[i].bytes);
+        if (bytes > slot_bytes[i % 2]) slot_bytes[i % 2] = bytes;
+    }
+    for (uint32_t i = 0; i + 1 < plan->step_count; i++) {
+        plan->steps[i].offset = (i % 2) ? slot_bytes[0] : 0;
+    }
+    
+    plan->scratch_bytes = slot_bytes[0] + slot_bytes[1];
+    plan->arena_bytes = plan->scratch_bytes;
+    
+    preprocess_plan_step_t* last = &plan->steps[plan->step_count - 1];
+    if (plan->config.bind_output) {
+        last->offset = plan->arena_bytes;
+        plan->arena_bytes += plan_align(last->bytes);
+    } else {
+        last->offset = SIZE_MAX;
+    }
+    
+    if (plan->arena_bytes == 0) return 0;
+    
+    if (plan->config.memory_pool) {
+        plan->handle = memory_pool_alloc(plan->config.memory_pool, plan->arena_bytes, PLAN_ALIGNMENT,
+                                         "preprocess_plan");
+        plan->arena = plan->handle ? memory_handle_get_ptr(plan->handle) : NULL;
+    } else if (posix_memalign((void**)&plan->arena, PLAN_ALIGNMENT, plan->arena_bytes) != 0) {
+        plan->arena = NULL;
+    }
+    
+    if (!plan->arena) {
+        LOG_ERROR("Failed to allocate %zu bytes for pipeline plan", plan->arena_bytes);
+        return -1;
+    }
+    return 0;
+}
+
+// 按当前并行度预留融合组的逐线程行缓冲区，按计划执行时不再分配
+static int plan_workspace(preprocess_pipeline_t pipeline, preprocess_plan_t* plan) {
+    size_t bytes = 0;
+    for (uint32_t i = 0; i < plan->step_count; i++) {
+        if (plan->steps[i].kind != PREPROCESS_PLAN_FUSED) continue;
+        size_t step_bytes = fused_work_bytes(&plan->steps[i].binding, pipeline->num_threads);
+        if (step_bytes > bytes) bytes = step_bytes;
+    }
+    
+    if (bytes == 0) return 0;
+    return preprocess_workspace_reserve(&plan->workspace, bytes) ? 0 : -1;
+}
+
+static int plan_locked(preprocess_pipeline_t pipeline, const preprocess_plan_config_t* config) {
+    if (pipeline->op_count == 0) {
+        LOG_ERROR("Cannot plan an empty pipeline");
+        return -1;
+    }
+    
+    preprocess_plan_t* plan = calloc(1, sizeof(preprocess_plan_t));
+    if (!plan) return -1;
+    plan->config = *config;
+    plan->steps = calloc(pipeline->op_count, sizeof(preprocess_plan_step_t));
+    pipeline->plan = plan;
+    
+    if (!plan->steps || plan_steps(pipeline, plan) != 0 || plan_layout(plan) != 0 ||
+        plan_workspace(pipeline, plan) != 0) {
+        release_plan(pipeline);
+        return -1;
+    }
+    
+    LOG_DEBUG("Planned preprocessing pipeline: %u steps, %zu scratch bytes, %zu total bytes",
+              plan->step_count, plan->scratch_bytes, plan->arena_bytes);
+    return 0;
+}
+
+// 将张量指向计划缓冲区中的区域（不拥有内存）
+static void plan_bind_tensor(const preprocess_plan_t* plan, const preprocess_plan_step_t* step, Tensor* tensor) {
+    tensor->data = plan->arena + step->offset;
+    tensor->size = step->bytes;
+    tensor->shape = step->shape;
+    tensor->dtype = step->dtype;
+    tensor->format = step->format;
+    tensor->memory_type = TENSOR_MEMORY_CPU;
+    tensor->owns_data = false;
+    if (tensor->ref_count == 0) tensor->ref_count = 1;
+}
+
+static bool plan_matches(const preprocess_plan_t* plan, const Tensor* input) {
+    return input->dtype == plan->config.input_dtype && input->format == plan->config.input_format &&
+           tensor_shape_equal(&input->shape, &plan->config.input_shape);
+}
+
+// 按计划执行：形状、绑定和缓冲区均已确定，直接调用内核
+static int run_plan(preprocess_pipeline_t pipeline, const Tensor* input, Tensor* output,
+                    uint32_t num_threads, preprocess_fusion_stats_t* stats) {
+    preprocess_plan_t* plan = pipeline->plan;
+    Tensor current = *input;
+    
+    for (uint32_t i = 0; i < plan->step_count; i++) {
+        const preprocess_plan_step_t* step = &plan->steps[i];
+        Tensor next = {0};
+        Tensor* dst = &next;
+        
+        if (i == plan->step_count - 1) {
+            dst = output;
+            if (step->offset == SIZE_MAX) {
+                if (preprocess_prepare_output(output, &step->shape, step->dtype, step->format) != 0) return -1;
+            } else {
+                plan_bind_tensor(plan, step, output);
+            }
+        } else {
+            plan_bind_tensor(plan, step, &next);
+        }
+        
+        int ret = 0;
+        switch (step->kind) {
+            case PREPROCESS_PLAN_LUT:
+                ret = preprocess_lut_execute(&pipeline->ops[step->first_op], step->op_count, &current, dst,
+                                             num_threads, &plan->workspace);
+                break;
+                
+            case PREPROCESS_PLAN_FUSED:
+                ret = run_fused_rows(&step->binding, &current, dst, step->rows, step->bytes_per_row, num_threads,
+                                     &plan->workspace);
+                break;
+            
+            default:
+                ret = op_run(pipeline->ops[step->first_op], &current, dst, num_threads, &plan->workspace);
+                break;
+        }
+        if (ret != 0) {
+            LOG_ERROR("Failed to execute planned step %u", i);
+            return ret;
+        }
+        
+        stats->fused_bytes += step->fused_bytes;
+        stats->unfused_bytes += step->unfused_bytes;
+        current = *dst;
+    }
+    
+    return 0;
+}
+
+int preprocess_pipeline_plan(preprocess_pipeline_t pipeline, const preprocess_plan_config_t* config) {
+    if (!pipeline || !config) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    
+    int ret = 0;
+    if (!pipeline->compiled) {
+        ret = compile_locked(pipeline);
+    }
+    if (ret == 0) {
+        release_plan(pipeline);
+        ret = plan_locked(pipeline, config);
+    }
     
     pthread_mutex_unlock(&pipeline->mutex);
     
-    LOG_DEBUG("Added operation to pipeline, count: %u", pipeline->op_count);
+    return ret;
+}
+
+int preprocess_pipeline_get_plan_info(preprocess_pipeline_t pipeline, preprocess_plan_info_t* info) {
+    if (!pipeline || !info) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    
+    const preprocess_plan_t* plan = pipeline->plan;
+    if (!plan) {
+        pthread_mutex_unlock(&pipeline->mutex);
+        return -1;
+    }
+    
+    const preprocess_plan_step_t* last = &plan->steps[plan->step_count - 1];
+    memset(info, 0, sizeof(*info));
+    info->output_shape = last->shape;
+    info->output_dtype = last->dtype;
+    info->output_format = last->format;
+    info->output_bytes = last->bytes;
+    info->intermediate_count = plan->step_count - 1;
+    info->scratch_bytes = plan->scratch_bytes;
+    info->total_bytes = plan->arena_bytes;
+    info->planned_executions = plan->executions;
+    
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return 0;
+}
+
+void preprocess_pipeline_clear_plan(preprocess_pipeline_t pipeline) {
+    if (!pipeline) return;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    release_plan(pipeline);
+    pthread_mutex_unlock(&pipeline->mutex);
+}
+
+int preprocess_pipeline_execute(preprocess_pipeline_t pipeline, const Tensor* input, Tensor* output) {
+    if (!pipeline || !input || !output) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    
+    if (!pipeline->compiled && compile_locked(pipeline) != 0) {
+        pthread_mutex_unlock(&pipeline->mutex);
+        return -1;
+    }
+    
+    int ret;
+    if (pipeline->plan && plan_matches(pipeline->plan, input)) {
+        ret = run_plan(pipeline, input, output, pipeline->num_threads, &pipeline->fusion_stats);
+        if (ret == 0) pipeline->plan->executions++;
+    } else {
+        ret = run_segments(pipeline, input, output, pipeline->num_threads, &pipeline->fusion_stats);
+    }
+    if (ret == 0) {
+        pipeline->fusion_stats.executions++;
+    }
+    
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return ret;
+}
+
+// 沿操作链推断管道输出（自定义操作无法推断时返回-1）
+static int infer_pipeline_output(preprocess_pipeline_t pipeline, const Tensor* input, TensorShape* shape,
+                                 TensorDataType* dtype, TensorFormat* format) {
+    TensorShape cur_shape = input->shape;
+    TensorDataType cur_dtype = input->dtype;
+    TensorFormat cur_format = input->format;
+    
+    for (uint32_t i = 0; i < pipeline->op_count; i++) {
+        preprocess_op_t op = pipeline->ops[i];
+        if (!op_has_builtin_kernel(op->params.type)) return -1;
+    
+        TensorShape next_shape;
+        if (preprocess_op_infer_shape(op, &cur_shape, cur_format, &next_shape) != 0) return -1;
+        cur_dtype = preprocess_op_output_dtype(op, cur_dtype);
+        cur_format = preprocess_op_output_format(op, &cur_shape, cur_format);
+        cur_shape = next_shape;
+    }
+    
+    *shape = cur_shape;
+    *dtype = cur_dtype;
+    *format = cur_format;
+    return 0;
+}
+
+int preprocess_pipeline_infer_output(preprocess_pipeline_t pipeline, const Tensor* input, TensorShape* shape,
+                                     TensorDataType* dtype, TensorFormat* format) {
+    if (!pipeline || !input || !shape || !dtype || !format) return -1;
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    int ret = infer_pipeline_output(pipeline, input, shape, dtype, format);
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    return ret;
+}
+
+// 由单个样本的输出形状构造批量形状：[1,...] 替换批量维，其余在前面增加批量维
+static int make_batch_shape(const TensorShape* item, uint32_t batch_size, TensorShape* batch) {
+    if (item->ndim == 4 && item->dims[0] == 1) {
+        *batch = *item;
+        batch->dims[0] = batch_size;
+        return 0;
+    }
+    
+    if (item->ndim == 0 || item->ndim >= TENSOR_MAX_DIMS) return -1;
+    
+    batch->ndim = item->ndim + 1;
+    batch->dims[0] = batch_size;
+    for (uint32_t i = 0; i < item->ndim; i++) {
+        batch->dims[i + 1] = item->dims[i];
+    }
+    return 0;
+}
+
+/**
+ * @brief 批量执行上下文
+ */
+typedef struct {
+    preprocess_pipeline_t pipeline;
+    const Tensor* inputs;
+    Tensor* output;
+    TensorShape item_shape;
+    TensorDataType item_dtype;
+    TensorFormat item_format;
+    size_t item_bytes;
+    uint32_t first_index;           /**< 并发执行的起始样本 */
+    uint32_t item_threads;          /**< 每个样本内部的分块并行度 */
+    preprocess_fusion_stats_t* stats; /**< 每个样本的局部统计 */
+    int* results;                   /**< 每个样本的执行结果 */
+} batch_job_t;
+
+// 在批量张量中为第 index 个样本构造不拥有内存的视图
+static Tensor batch_item_view(const batch_job_t* job, uint32_t index) {
+    Tensor view = {0};
+    view.dtype = job->item_dtype;
+    view.shape = job->item_shape;
+    view.format = job->item_format;
+    view.memory_type = job->output->memory_type;
+    view.data = (uint8_t*)job->output->data + (size_t)index * job->item_bytes;
+    view.size = job->item_bytes;
+    view.owns_data = false;
+    return view;
+}
+
+static void batch_item_task(void* context, uint32_t index) {
+    batch_job_t* job = (batch_job_t*)context;
+    Tensor view = batch_item_view(job, index);
+    
+    int ret = run_segments(job->pipeline, &job->inputs[index], &view, job->item_threads,
+                           &job->stats[index]);
     
-    return 0;
+    // 样本输出形状必须与批量切片一致，防止写出的数据错位
+    if (ret == 0 && (!tensor_shape_equal(&view.shape, &job->item_shape) || view.dtype != job->item_dtype)) {
+        LOG_ERROR("Batch item %u produced a mismatched output", index);
+        ret = -1;
+    }
+    job->results[index] = ret;
 }
 
-int preprocess_pipeline_remove_op(preprocess_pipeline_t pipeline, uint32_t index) {
-    if (!pipeline || index >= pipeline->op_count) return -1;
+static void batch_parallel_task(void* context, uint32_t index) {
+    batch_job_t* job = (batch_job_t*)context;
+    batch_item_task(job, job->first_index + index);
+}
+
+int preprocess_pipeline_execute_batch(preprocess_pipeline_t pipeline, const Tensor* inputs,
+                                      Tensor* output, uint32_t batch_size) {
+    if (!pipeline || !inputs || !output || batch_size == 0) return -1;
     
     pthread_mutex_lock(&pipeline->mutex);
     
-    // 销毁要移除的操作
-    preprocess_op_destroy(pipeline->ops[index]);
+    if (!pipeline->compiled && compile_locked(pipeline) != 0) {
+        pthread_mutex_unlock(&pipeline->mutex);
+        return -1;
+    }
     
-    // 移动后续操作
-    if (index < pipeline->op_count - 1) {
-        memmove(&pipeline->ops[index], &pipeline->ops[index + 1],
-                (pipeline->op_count - index - 1) * sizeof(preprocess_op_t));
+    batch_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.pipeline = pipeline;
+    job.inputs = inputs;
+    job.output = output;
+    job.stats = calloc(batch_size, sizeof(preprocess_fusion_stats_t));
+    job.results = calloc(batch_size, sizeof(int));
+    if (!job.stats || !job.results) {
+        LOG_ERROR("Failed to allocate batch state");
+        free(job.stats);
+        free(job.results);
+        pthread_mutex_unlock(&pipeline->mutex);
+        return -1;
     }
     
-    pipeline->op_count--;
+    int ret = 0;
+    Tensor first = {0};
+    bool first_done = false;
     
-    pthread_mutex_unlock(&pipeline->mutex);
+    // 确定单个样本的输出；无法静态推断时先执行第一个样本
+    if (infer_pipeline_output(pipeline, &inputs[0], &job.item_shape, &job.item_dtype,
+                              &job.item_format) != 0) {
+        ret = run_segments(pipeline, &inputs[0], &first, pipeline->num_threads, &job.stats[0]);
+        if (ret == 0) {
+            job.item_shape = first.shape;
+            job.item_dtype = first.dtype;
+            job.item_format = first.format;
+            first_done = true;
+        }
+    }
     
-    LOG_DEBUG("Removed operation from pipeline, count: %u", pipeline->op_count);
+    TensorShape batch_shape;
+    if (ret == 0 && make_batch_shape(&job.item_shape, batch_size, &batch_shape) != 0) {
+        LOG_ERROR("Cannot build batch shape from %u-D item output", job.item_shape.ndim);
+        ret = -1;
+    }
     
-    return 0;
-}
-
-int preprocess_pipeline_execute(preprocess_pipeline_t pipeline, const Tensor* input, Tensor* output) {
-    if (!pipeline || !input || !output) return -1;
+    if (ret == 0) {
+        job.item_bytes = preprocess_shape_bytes(&job.item_shape, job.item_dtype);
+        ret = preprocess_prepare_output(output, &batch_shape, job.item_dtype, job.item_format);
+    }
     
-    if (pipeline->op_count == 0) {
-        // 没有操作，直接复制输入到输出
-        output->shape = input->shape;
-        output->dtype = input->dtype;
-        
-        size_t total_elements = 1;
-        for (uint32_t i = 0; i < input->shape.ndim; i++) {
-            total_elements *= input->shape.dims[i];
-        }
-        
-        size_t element_size = 1;
-        switch (input->dtype) {
-            case TENSOR_TYPE_FLOAT32: case TENSOR_TYPE_INT32: element_size = 4; break;
-            case TENSOR_TYPE_FLOAT64: case TENSOR_TYPE_INT64: element_size = 8; break;
-            case TENSOR_TYPE_FLOAT16: case TENSOR_TYPE_INT16: element_size = 2; break;
-            default: element_size = 1; break;
-        }
-        
-        size_t data_size = total_elements * element_size;
-        output->data = malloc(data_size);
-        if (!output->data) return -1;
-        
-        memcpy(output->data, input->data, data_size);
-        return 0;
+    if (ret == 0 && first_done) {
+        memcpy(output->data, first.data, job.item_bytes);
     }
+    if (first.owns_data) free(first.data);
     
-    // 为中间结果分配缓冲区
-    Tensor* buffers = malloc((pipeline->op_count + 1) * sizeof(Tensor));
-    if (!buffers) {
-        LOG_ERROR("Failed to allocate intermediate buffers");
-        return -1;
+    // 第一个样本串行执行，同时完成各融合段对该输入形状的绑定
+    uint32_t start = first_done ? 1 : 0;
+    if (ret == 0 && start == 0) {
+        job.item_threads = pipeline->num_threads;
+        batch_item_task(&job, 0);
+        ret = job.results[0];
+        start = 1;
     }
     
-    // 第一个缓冲区是输入
-    buffers[0] = *input;
+    // 输入形状一致时绑定不会再变化，其余样本可并发执行
+    bool uniform = true;
+    for (uint32_t i = 1; i < batch_size && uniform; i++) {
+        uniform = inputs[i].dtype == inputs[0].dtype && inputs[i].format == inputs[0].format &&
+                  tensor_shape_equal(&inputs[i].shape, &inputs[0].shape);
+    }
     
-    // 执行每个操作
-    int ret = 0;
-    for (uint32_t i = 0; i < pipeline->op_count; i++) {
-        const Tensor* op_input = &buffers[i];
-        Tensor* op_output = &buffers[i + 1];
-        
-        ret = preprocess_op_execute(pipeline->ops[i], op_input, op_output);
-        if (ret != 0) {
-            LOG_ERROR("Failed to execute operation %u in pipeline", i);
-            break;
+    if (ret == 0 && start < batch_size) {
+        uint32_t remaining = batch_size - start;
+        uint32_t threads = pipeline->num_threads;
+    
+        if (uniform && threads > 1 && remaining > 1) {
+            // 样本间并行为主，样本数不足时把剩余线程用于样本内分块
+            job.item_threads = threads > remaining ? threads / remaining : 1;
+            job.first_index = start;
+            thread_pool_parallel_for(thread_pool_get_shared(), remaining, threads, batch_parallel_task, &job);
+        } else {
+            job.item_threads = threads;
+            for (uint32_t i = start; i < batch_size; i++) {
+                batch_item_task(&job, i);
+            }
         }
-    }
     
-    if (ret == 0) {
-        // 复制最终结果到输出
-        *output = buffers[pipeline->op_count];
+        for (uint32_t i = start; i < batch_size && ret == 0; i++) {
+            ret = job.results[i];
+        }
     }
     
-    // 释放中间缓冲区（除了第一个和最后一个）
-    for (uint32_t i = 1; i < pipeline->op_count; i++) {
-        if (buffers[i].data && buffers[i].data != input->data) {
-            free(buffers[i].data);
+    if (ret == 0) {
+        for (uint32_t i = 0; i < batch_size; i++) {
+            pipeline->fusion_stats.fused_bytes += job.stats[i].fused_bytes;
+            pipeline->fusion_stats.unfused_bytes += job.stats[i].unfused_bytes;
+            pipeline->fusion_stats.scratch_allocs += job.stats[i].scratch_allocs;
         }
+        pipeline->fusion_stats.executions += batch_size;
+    } else {
+        LOG_ERROR("Batch preprocessing failed");
     }
     
-    free(buffers);
+    pthread_mutex_unlock(&pipeline->mutex);
     
+    free(job.stats);
+    free(job.results);
     return ret;
 }
 
@@ -485,6 +1757,83 @@ bool preprocess_validate_params(preprocess_type_e type, const preprocess_params_
             return params->params.crop.width > 0 && 
                    params->params.crop.height > 0;
                    
+        case PREPROCESS_TRANSPOSE: {
+            uint32_t ndim = params->params.transpose.ndim;
+            if (ndim == 0 || ndim > TENSOR_MAX_DIMS) return false;
+            uint32_t seen = 0;
+            for (uint32_t i = 0; i < ndim; i++) {
+                uint32_t axis = params->params.transpose.perm[i];
+                if (axis >= ndim || (seen & (1u << axis))) return false;
+                seen |= 1u << axis;
+            }
+            return true;
+        }
+            
+        case PREPROCESS_CAST:
+            return params->params.cast.dtype != TENSOR_TYPE_UNKNOWN &&
+                   params->params.cast.dtype != TENSOR_TYPE_STRING &&
+                   params->params.cast.dtype != TENSOR_TYPE_FLOAT16;
+                   
+        case PREPROCESS_BRIGHTNESS:
+            return params->params.brightness.factor >= 0.0f;
+            
+        case PREPROCESS_CONTRAST:
+            return params->params.contrast.factor >= 0.0f;
+            
+        case PREPROCESS_GAMMA:
+            return params->params.gamma.gamma > 0.0f;
+            
+        case PREPROCESS_RESAMPLE:
+            return params->params.resample.sample_rate > 0 &&
+                   params->params.resample.target_rate > 0;
+            
+        case PREPROCESS_WINDOWING:
+            return params->params.windowing.window_size > 0 &&
+                   params->params.windowing.hop_size > 0;
+            
+        case PREPROCESS_FFT:
+            return params->params.fft.n_fft > 0 && params->params.fft.hop_length > 0 &&
+                   params->params.fft.win_length <= params->params.fft.n_fft;
+            
+        case PREPROCESS_SPECTROGRAM:
+            return params->params.spectrogram.n_fft > 0 && params->params.spectrogram.hop_length > 0 &&
+                   params->params.spectrogram.win_length <= params->params.spectrogram.n_fft;
+            
+        case PREPROCESS_MFCC:
+            return params->params.mfcc.n_mfcc > 0 && params->params.mfcc.n_fft > 0 &&
+                   params->params.mfcc.hop_length > 0 &&
+                   (params->params.mfcc.n_mels == 0 || params->params.mfcc.n_mfcc <= params->params.mfcc.n_mels);
+            
+        case PREPROCESS_TOKENIZE:
+            return params->params.tokenize.tokenizer != NULL && params->params.tokenize.max_length > 0;
+            
+        case PREPROCESS_DOWNSAMPLE:
+            return params->params.downsample.voxel_size > 0.0f || params->params.downsample.target_points > 0;
+            
+        case PREPROCESS_OUTLIER_REMOVAL:
+            return params->params.outlier_removal.k > 0 && params->params.outlier_removal.std_ratio >= 0.0f;
+            
+        case PREPROCESS_NORMAL_ESTIMATION:
+            // k 为0时使用默认邻居数；平面拟合至少需要3个点
+            return (params->params.normal_estimation.k == 0 || params->params.normal_estimation.k >= 3) &&
+                   params->params.normal_estimation.radius >= 0.0f;
+            
+        case PREPROCESS_QUANTIZE:
+        case PREPROCESS_DEQUANTIZE:
+            return preprocess_quant_params_valid(type, params);
+            
+        case PREPROCESS_COLOR_CONVERT:
+            return params->params.color_convert.src_format <= COLOR_FORMAT_YUYV &&
+                   (params->params.color_convert.dst_format == COLOR_FORMAT_RGB ||
+                    params->params.color_convert.dst_format == COLOR_FORMAT_BGR) &&
+                   params->params.color_convert.standard <= COLOR_STANDARD_BT709;
+            
+        case PREPROCESS_BLUR:
+        case PREPROCESS_SHARPEN:
+        case PREPROCESS_EDGE_DETECT:
+        case PREPROCESS_MORPHOLOGY:
+            return preprocess_filter_params_valid(type, params);
+            
         case PREPROCESS_CUSTOM:
             return params->params.custom.custom_data != NULL;
             
@@ -493,76 +1842,386 @@ bool preprocess_validate_params(preprocess_type_e type, const preprocess_params_
     }
 }
 
+int preprocess_op_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                              TensorFormat input_format, TensorShape* output_shape) {
+    if (!op || !input_shape || !output_shape) return -1;
+    
+    const preprocess_params_t* params = &op->params;
+    preprocess_image_dims_t dims;
+    
+    switch (params->type) {
+        case PREPROCESS_RESIZE:
+            if (preprocess_image_dims_from_shape(input_shape, input_format, &dims) != 0) return -1;
+            dims.w = params->params.resize.width;
+            dims.h = params->params.resize.height;
+            *output_shape = preprocess_image_dims_to_shape(&dims);
+            return 0;
+            
+        case PREPROCESS_CROP:
+            if (preprocess_image_dims_from_shape(input_shape, input_format, &dims) != 0) return -1;
+            if (params->params.crop.x + params->params.crop.width > dims.w ||
+                params->params.crop.y + params->params.crop.height > dims.h) {
+                LOG_ERROR("Crop window exceeds image bounds");
+                return -1;
+            }
+            dims.w = params->params.crop.width;
+            dims.h = params->params.crop.height;
+            *output_shape = preprocess_image_dims_to_shape(&dims);
+            return 0;
+            
+        case PREPROCESS_PAD:
+            if (preprocess_image_dims_from_shape(input_shape, input_format, &dims) != 0) return -1;
+            dims.w += params->params.pad.left + params->params.pad.right;
+            dims.h += params->params.pad.top + params->params.pad.bottom;
+            *output_shape = preprocess_image_dims_to_shape(&dims);
+            return 0;
+            
+        case PREPROCESS_TRANSPOSE:
+            if (input_shape->ndim != params->params.transpose.ndim) return -1;
+            output_shape->ndim = input_shape->ndim;
+            for (uint32_t i = 0; i < input_shape->ndim; i++) {
+                output_shape->dims[i] = input_shape->dims[params->params.transpose.perm[i]];
+            }
+            return 0;
+            
+        case PREPROCESS_NORMALIZE:
+        case PREPROCESS_STANDARDIZE:
+        case PREPROCESS_CAST:
+        case PREPROCESS_FLIP:
+        case PREPROCESS_ROTATE:
+        case PREPROCESS_BRIGHTNESS:
+        case PREPROCESS_CONTRAST:
+        case PREPROCESS_GAMMA:
+        case PREPROCESS_HISTOGRAM_EQ:
+        case PREPROCESS_QUANTIZE:
+        case PREPROCESS_DEQUANTIZE:
+        case PREPROCESS_BLUR:
+        case PREPROCESS_SHARPEN:
+        case PREPROCESS_EDGE_DETECT:
+        case PREPROCESS_MORPHOLOGY:
+            *output_shape = *input_shape;
+            return 0;
+            
+        case PREPROCESS_RESAMPLE:
+            return preprocess_resample_infer_shape(op, input_shape, output_shape);
+            
+        case PREPROCESS_WINDOWING:
+        case PREPROCESS_FFT:
+        case PREPROCESS_SPECTROGRAM:
+        case PREPROCESS_MFCC:
+            return preprocess_audio_infer_shape(op, input_shape, output_shape);
+            
+        case PREPROCESS_TOKENIZE:
+            return preprocess_tokenize_infer_shape(op, input_shape, output_shape);
+            
+        case PREPROCESS_NORMAL_ESTIMATION:
+            return preprocess_normal_estimation_infer_shape(input_shape, output_shape);
+            
+        case PREPROCESS_COLOR_CONVERT:
+            if (preprocess_color_setup(params, input_shape, NULL, &dims) != 0) {
+                LOG_ERROR("Input shape does not match the color conversion source format");
+                return -1;
+            }
+            *output_shape = preprocess_image_dims_to_shape(&dims);
+            return 0;
+            
+        default:
+            // 自定义和注册的操作无法静态推断
+            return -1;
+    }
+}
+
+int preprocess_op_get_output_shape(preprocess_op_t op, const TensorShape* input_shape, 
+                                  TensorShape* output_shape) {
+    return preprocess_op_infer_shape(op, input_shape, TENSOR_FORMAT_NHWC, output_shape);
+}
+
+// 获取当前时间（毫秒）
+static double get_time_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+int preprocess_op_benchmark(preprocess_op_t op, const Tensor* input, uint32_t iterations, 
+                           double* avg_time) {
+    if (!op || !input || !avg_time || iterations == 0) return -1;
+    
+    double total = 0.0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        Tensor output = {0};
+        double start = get_time_ms();
+        int ret = preprocess_op_execute(op, input, &output);
+        total += get_time_ms() - start;
+        if (output.owns_data) free(output.data);
+        if (ret != 0) return ret;
+    }
+    
+    *avg_time = total / iterations;
+    return 0;
+}
+
+int preprocess_pipeline_benchmark(preprocess_pipeline_t pipeline, const Tensor* input, 
+                                 uint32_t iterations, double* avg_time) {
+    if (!pipeline || !input || !avg_time || iterations == 0) return -1;
+    
+    double total = 0.0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        Tensor output = {0};
+        double start = get_time_ms();
+        int ret = preprocess_pipeline_execute(pipeline, input, &output);
+        total += get_time_ms() - start;
+        if (output.owns_data) free(output.data);
+        if (ret != 0) return ret;
+    }
+    
+    *avg_time = total / iterations;
+    return 0;
+}
+
+int preprocess_op_set_cache(preprocess_op_t op, bool enable) {
+    if (!op) return -1;
+    
+    pthread_mutex_lock(&op->mutex);
+    op->enable_cache = enable;
+    if (!enable) {
+        op->lut_valid = false;
+    }
+    pthread_mutex_unlock(&op->mutex);
+    
+    return 0;
+}
+
+int preprocess_pipeline_set_parallel(preprocess_pipeline_t pipeline, uint32_t num_threads) {
+    if (!pipeline || num_threads == 0) return -1;
+    
+    if (num_threads > THREAD_POOL_MAX_WORKERS + 1) {
+        num_threads = THREAD_POOL_MAX_WORKERS + 1;
+    }
+    
+    // 共享线程池按需扩容，调用线程本身也参与执行
+    if (num_threads > 1) {
+        thread_pool_t pool = thread_pool_get_shared();
+        if (!pool || thread_pool_reserve(pool, num_threads - 1) != 0) {
+            LOG_ERROR("Failed to reserve %u preprocessing workers", num_threads - 1);
+            return -1;
+        }
+    }
+    
+    pthread_mutex_lock(&pipeline->mutex);
+    pipeline->num_threads = num_threads;
+    pthread_mutex_unlock(&pipeline->mutex);
+    
+    LOG_DEBUG("Preprocessing pipeline parallelism set to %u threads", num_threads);
+    return 0;
+}
+
 // 具体的预处理操作实现
 
-static int normalize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params) {
+// 图像元素偏移：布局无关地定位 (n, y, x, c)
+static inline size_t image_offset(const preprocess_image_dims_t* d, uint32_t n, uint32_t y,
+                                  uint32_t x, uint32_t c) {
+    if (d->nchw) {
+        return (((size_t)n * d->c + c) * d->h + y) * d->w + x;
+    }
+    return (((size_t)n * d->h + y) * d->w + x) * d->c + c;
+}
+
+/**
+ * @brief 归一化区间上下文
+ */
+typedef struct {
+    const Tensor* input;
+    float* output;
+    float scale[4];
+    float bias[4];
+    uint32_t channels;
+    uint32_t period;            /**< 交错布局的通道周期 */
+    size_t plane;               /**< 平面布局的通道平面大小（0表示交错布局） */
+    uint32_t planes;            /**< 平面布局的通道数 */
+} normalize_job_t;
+
+static void normalize_range(void* context, size_t begin, size_t end) {
+    const normalize_job_t* job = (const normalize_job_t*)context;
+    float* output_data = job->output;
+    
+    if (job->plane > 0) {
+        // 平面布局：按通道平面分段处理
+        size_t i = begin;
+        while (i < end) {
+            size_t plane_index = i / job->plane;
+            size_t plane_end = (plane_index + 1) * job->plane;
+            if (plane_end > end) plane_end = end;
+            uint32_t c = (uint32_t)(plane_index % job->planes) % job->channels;
+            float s = job->scale[c];
+            float b = job->bias[c];
+            for (; i < plane_end; i++) {
+                output_data[i] = preprocess_load_element(job->input->data, job->input->dtype, i) * s + b;
+            }
+        }
+        return;
+    }
+    
+    // 交错布局：通道为最内层维度
+    uint32_t period = job->period;
+    uint32_t channels = job->channels;
+    
+    if (job->input->dtype == TENSOR_TYPE_FLOAT32) {
+        const float* input_data = (const float*)job->input->data;
+        for (size_t i = begin; i < end; i++) {
+            uint32_t channel = (i % period) % channels;
+            output_data[i] = input_data[i] * job->scale[channel] + job->bias[channel];
+        }
+    } else if (job->input->dtype == TENSOR_TYPE_UINT8) {
+        const uint8_t* input_data = (const uint8_t*)job->input->data;
+        for (size_t i = begin; i < end; i++) {
+            uint32_t channel = (i % period) % channels;
+            output_data[i] = input_data[i] * job->scale[channel] + job->bias[channel];
+        }
+    } else {
+        for (size_t i = begin; i < end; i++) {
+            uint32_t channel = (i % period) % channels;
+            output_data[i] = preprocess_load_element(job->input->data, job->input->dtype, i) *
+                             job->scale[channel] + job->bias[channel];
+        }
+    }
+}
+
+static int normalize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                             uint32_t num_threads) {
     if (!input || !output || !params) return -1;
     
-    uint32_t channels = params->params.normalize.channels;
-    float mean[4] = {0};
-    float std[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    normalize_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.input = input;
+    job.output = (float*)output->data;
+    job.channels = params->params.normalize.channels;
     
-    for (uint32_t i = 0; i < channels; i++) {
-        mean[i] = params->params.normalize.mean[i];
-        std[i] = params->params.normalize.std[i];
+    // (x - mean) / std 改写为 x * scale + bias
+    for (uint32_t i = 0; i < job.channels; i++) {
+        float std = params->params.normalize.std[i];
+        if (std == 0.0f) std = 1.0f;
+        job.scale[i] = 1.0f / std;
+        job.bias[i] = -params->params.normalize.mean[i] / std;
     }
     
-    // 简单的归一化实现
     size_t total_elements = 1;
     for (uint32_t i = 0; i < input->shape.ndim; i++) {
         total_elements *= input->shape.dims[i];
     }
     
-    if (input->dtype == TENSOR_TYPE_FLOAT32) {
-        float* input_data = (float*)input->data;
-        float* output_data = (float*)output->data;
-        
-        for (size_t i = 0; i < total_elements; i++) {
-            uint32_t channel = i % channels;
-            output_data[i] = (input_data[i] - mean[channel]) / std[channel];
-        }
-    } else {
-        LOG_ERROR("Unsupported data type for normalization");
-        return -1;
+    preprocess_image_dims_t dims;
+    bool is_image = preprocess_image_dims_from_shape(&input->shape, input->format, &dims) == 0;
+    
+    if (is_image && dims.nchw) {
+        job.plane = (size_t)dims.h * dims.w;
+        job.planes = dims.c;
     }
+    job.period = is_image ? dims.c : job.channels;
+    
+    size_t bytes_per_element = tensor_get_dtype_size(input->dtype) + sizeof(float);
+    preprocess_parallel_for(num_threads, total_elements, bytes_per_element, normalize_range, &job);
     
     return 0;
 }
 
-static int resize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params) {
-    if (!input || !output || !params) return -1;
-    
-    uint32_t width = params->params.resize.width;
-    uint32_t height = params->params.resize.height;
-    interpolation_method_e method = params->params.resize.method;
+/**
+ * @brief 缩放区间上下文
+ */
+typedef struct {
+    const Tensor* input;
+    Tensor* output;
+    preprocess_image_dims_t in;
+    preprocess_image_dims_t out;
+    bool linear;
+    float sx;
+    float sy;
+} resize_job_t;
+
+// 处理输出行 [begin, end)，行号按 batch*height 展开
+static void resize_range(void* context, size_t begin, size_t end) {
+    const resize_job_t* job = (const resize_job_t*)context;
+    const Tensor* input = job->input;
+    Tensor* output = job->output;
+    const preprocess_image_dims_t* in = &job->in;
+    const preprocess_image_dims_t* out = &job->out;
+    bool linear = job->linear;
     
-    // 简单的最近邻插值实现
-    if (input->dtype == TENSOR_TYPE_FLOAT32) {
-        float* input_data = (float*)input->data;
-        float* output_data = (float*)output->data;
-        
-        // 假设输入是NHWC格式的图像
-        uint32_t input_height = input->shape.dims[1];
-        uint32_t input_width = input->shape.dims[2];
-        uint32_t channels = input->shape.dims[3];
+    for (size_t row = begin; row < end; row++) {
+        uint32_t n = (uint32_t)(row / out->h);
+        uint32_t y = (uint32_t)(row % out->h);
+        uint32_t y0, y1;
+        float wy = 0.0f;
+        if (linear) {
+            float fy = (y + 0.5f) * job->sy - 0.5f;
+            if (fy < 0.0f) fy = 0.0f;
+            y0 = (uint32_t)fy;
+            if (y0 > in->h - 1) y0 = in->h - 1;
+            y1 = y0 + 1 < in->h ? y0 + 1 : in->h - 1;
+            wy = fy - y0;
+        } else {
+            y0 = y1 = (y * in->h) / out->h;
+        }
         
-        for (uint32_t y = 0; y < height; y++) {
-            for (uint32_t x = 0; x < width; x++) {
-                uint32_t src_x = (x * input_width) / width;
-                uint32_t src_y = (y * input_height) / height;
-                
-                for (uint32_t c = 0; c < channels; c++) {
-                    uint32_t src_idx = (src_y * input_width + src_x) * channels + c;
-                    uint32_t dst_idx = (y * width + x) * channels + c;
-                    output_data[dst_idx] = input_data[src_idx];
+        for (uint32_t x = 0; x < out->w; x++) {
+            uint32_t x0, x1;
+            float wx = 0.0f;
+            if (linear) {
+                float fx = (x + 0.5f) * job->sx - 0.5f;
+                if (fx < 0.0f) fx = 0.0f;
+                x0 = (uint32_t)fx;
+                if (x0 > in->w - 1) x0 = in->w - 1;
+                x1 = x0 + 1 < in->w ? x0 + 1 : in->w - 1;
+                wx = fx - x0;
+            } else {
+                x0 = x1 = (x * in->w) / out->w;
+            }
+            
+            for (uint32_t c = 0; c < out->c; c++) {
+                size_t dst_idx = image_offset(out, n, y, x, c);
+                float v00 = preprocess_load_element(input->data, input->dtype, image_offset(in, n, y0, x0, c));
+                if (!linear) {
+                    preprocess_store_element(output->data, output->dtype, dst_idx, v00);
+                    continue;
                 }
+                float v01 = preprocess_load_element(input->data, input->dtype, image_offset(in, n, y0, x1, c));
+                float v10 = preprocess_load_element(input->data, input->dtype, image_offset(in, n, y1, x0, c));
+                float v11 = preprocess_load_element(input->data, input->dtype, image_offset(in, n, y1, x1, c));
+                float top = v00 + (v01 - v00) * wx;
+                float bottom = v10 + (v11 - v10) * wx;
+                preprocess_store_element(output->data, output->dtype, dst_idx, top + (bottom - top) * wy);
             }
         }
-    } else {
-        LOG_ERROR("Unsupported data type for resize");
+    }
+}
+
+static int resize_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                          uint32_t num_threads) {
+    if (!input || !output || !params) return -1;
+    
+    resize_job_t job;
+    job.input = input;
+    job.output = output;
+    if (preprocess_image_dims_from_shape(&input->shape, input->format, &job.in) != 0) {
+        LOG_ERROR("Resize expects a 3D or 4D image tensor");
         return -1;
     }
     
+    job.out = job.in;
+    job.out.w = params->params.resize.width;
+    job.out.h = params->params.resize.height;
+    
+    // 三次、Lanczos和区域插值暂按双线性处理
+    job.linear = params->params.resize.method != INTERPOLATION_NEAREST;
+    job.sx = (float)job.in.w / job.out.w;
+    job.sy = (float)job.in.h / job.out.h;
+    
+    // 每个输出行读取约两行源数据（双线性）并写出一行
+    size_t elem = tensor_get_dtype_size(input->dtype);
+    size_t src_rows = job.linear ? 2 : 1;
+    size_t bytes_per_row = ((size_t)job.in.w * src_rows + job.out.w) * job.in.c * elem;
+    preprocess_parallel_for(num_threads, (size_t)job.out.n * job.out.h, bytes_per_row, resize_range, &job);
+    
     return 0;
 }
 
@@ -574,11 +2233,59 @@ static int rotate_execute(const Tensor* input, Tensor* output, const preprocess_
     return 0;
 }
 
-static int flip_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params) {
-    (void)input;
-    (void)output;
-    (void)params;
-    // TODO: 实现翻转操作
+/**
+ * @brief 图像行区间上下文（翻转、裁剪）
+ */
+typedef struct {
+    const Tensor* input;
+    Tensor* output;
+    const preprocess_params_t* params;
+    preprocess_image_dims_t in;
+    preprocess_image_dims_t out;
+    size_t elem;
+} image_rows_job_t;
+
+static void flip_range(void* context, size_t begin, size_t end) {
+    const image_rows_job_t* job = (const image_rows_job_t*)context;
+    const preprocess_image_dims_t* d = &job->in;
+    const uint8_t* src = (const uint8_t*)job->input->data;
+    uint8_t* dst = (uint8_t*)job->output->data;
+    size_t elem = job->elem;
+    bool fh = job->params->params.flip.horizontal;
+    bool fv = job->params->params.flip.vertical;
+    
+    for (size_t row = begin; row < end; row++) {
+        uint32_t n = (uint32_t)(row / d->h);
+        uint32_t y = (uint32_t)(row % d->h);
+        uint32_t sy = fv ? d->h - 1 - y : y;
+        for (uint32_t x = 0; x < d->w; x++) {
+            uint32_t sx = fh ? d->w - 1 - x : x;
+            for (uint32_t c = 0; c < d->c; c++) {
+                memcpy(dst + image_offset(d, n, y, x, c) * elem,
+                       src + image_offset(d, n, sy, sx, c) * elem, elem);
+            }
+        }
+    }
+}
+
+static int flip_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                        uint32_t num_threads) {
+    if (!input || !output || !params) return -1;
+    
+    image_rows_job_t job;
+    job.input = input;
+    job.output = output;
+    job.params = params;
+    if (preprocess_image_dims_from_shape(&input->shape, input->format, &job.in) != 0) {
+        LOG_ERROR("Flip expects a 3D or 4D image tensor");
+        return -1;
+    }
+    job.out = job.in;
+    job.elem = tensor_get_dtype_size(input->dtype);
+    
+    size_t bytes_per_row = 2 * (size_t)job.in.w * job.in.c * job.elem;
+    preprocess_parallel_for(num_threads, (size_t)job.in.n * job.in.h, bytes_per_row, flip_range, &job);
+    
     return 0;
 }
 
@@ -590,10 +2297,144 @@ static int pad_execute(const Tensor* input, Tensor* output, const preprocess_par
     return 0;
 }
 
-static int crop_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params) {
-    (void)input;
-    (void)output;
-    (void)params;
-    // TODO: 实现裁剪操作
+static void crop_range(void* context, size_t begin, size_t end) {
+    const image_rows_job_t* job = (const image_rows_job_t*)context;
+    const preprocess_image_dims_t* in = &job->in;
+    const preprocess_image_dims_t* out = &job->out;
+    const uint8_t* src = (const uint8_t*)job->input->data;
+    uint8_t* dst = (uint8_t*)job->output->data;
+    size_t elem = job->elem;
+    uint32_t x0 = job->params->params.crop.x;
+    uint32_t y0 = job->params->params.crop.y;
+    
+    // 每行窗口在内存中连续：NHWC 一行包含全部通道，NCHW 按平面逐行复制
+    size_t row_bytes = (size_t)out->w * (in->nchw ? 1 : in->c) * elem;
+    uint32_t planes = in->nchw ? in->c : 1;
+    
+    for (size_t row = begin; row < end; row++) {
+        uint32_t n = (uint32_t)(row / out->h);
+        uint32_t y = (uint32_t)(row % out->h);
+        for (uint32_t p = 0; p < planes; p++) {
+            memcpy(dst + image_offset(out, n, y, 0, p) * elem,
+                   src + image_offset(in, n, y0 + y, x0, p) * elem, row_bytes);
+        }
+    }
+}
+
+static int crop_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                        uint32_t num_threads) {
+    if (!input || !output || !params) return -1;
+    
+    image_rows_job_t job;
+    job.input = input;
+    job.output = output;
+    job.params = params;
+    if (preprocess_image_dims_from_shape(&input->shape, input->format, &job.in) != 0) {
+        LOG_ERROR("Crop expects a 3D or 4D image tensor");
+        return -1;
+    }
+    
+    job.out = job.in;
+    job.out.w = params->params.crop.width;
+    job.out.h = params->params.crop.height;
+    job.elem = tensor_get_dtype_size(input->dtype);
+    
+    size_t bytes_per_row = 2 * (size_t)job.out.w * job.in.c * job.elem;
+    preprocess_parallel_for(num_threads, (size_t)job.out.n * job.out.h, bytes_per_row, crop_range, &job);
+    
+    return 0;
+}
+
+static int transpose_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params) {
+    if (!input || !output || !params) return -1;
+    
+    uint32_t ndim = params->params.transpose.ndim;
+    const uint32_t* perm = params->params.transpose.perm;
+    size_t elem = tensor_get_dtype_size(input->dtype);
+    
+    // 输入各维步长
+    size_t in_strides[TENSOR_MAX_DIMS];
+    size_t stride = 1;
+    for (int i = (int)ndim - 1; i >= 0; i--) {
+        in_strides[i] = stride;
+        stride *= input->shape.dims[i];
+    }
+    
+    // 输出第 i 维对应输入第 perm[i] 维
+    size_t out_strides_in[TENSOR_MAX_DIMS];
+    for (uint32_t i = 0; i < ndim; i++) {
+        out_strides_in[i] = in_strides[perm[i]];
+    }
+    
+    size_t total = stride;
+    uint32_t index[TENSOR_MAX_DIMS] = {0};
+    size_t src_offset = 0;
+    const uint8_t* src = (const uint8_t*)input->data;
+    uint8_t* dst = (uint8_t*)output->data;
+    
+    for (size_t i = 0; i < total; i++) {
+        memcpy(dst + i * elem, src + src_offset * elem, elem);
+        
+        // 输出索引按行优先递增，同时维护输入偏移
+        for (int d = (int)ndim - 1; d >= 0; d--) {
+            index[d]++;
+            src_offset += out_strides_in[d];
+            if (index[d] < output->shape.dims[d]) break;
+            src_offset -= out_strides_in[d] * index[d];
+            index[d] = 0;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief 类型转换区间上下文
+ */
+typedef struct {
+    const Tensor* input;
+    Tensor* output;
+} cast_job_t;
+
+static void cast_range(void* context, size_t begin, size_t end) {
+    const cast_job_t* job = (const cast_job_t*)context;
+    const Tensor* input = job->input;
+    Tensor* output = job->output;
+    
+    if (input->dtype == output->dtype) {
+        size_t elem = tensor_get_dtype_size(input->dtype);
+        memcpy((uint8_t*)output->data + begin * elem, (const uint8_t*)input->data + begin * elem,
+               (end - begin) * elem);
+        return;
+    }
+    
+    if (input->dtype == TENSOR_TYPE_UINT8 && output->dtype == TENSOR_TYPE_FLOAT32) {
+        const uint8_t* src = (const uint8_t*)input->data;
+        float* dst = (float*)output->data;
+        for (size_t i = begin; i < end; i++) {
+            dst[i] = src[i];
+        }
+        return;
+    }
+    
+    for (size_t i = begin; i < end; i++) {
+        preprocess_store_element(output->data, output->dtype, i,
+                                 preprocess_load_element(input->data, input->dtype, i));
+    }
+}
+
+static int cast_execute(const Tensor* input, Tensor* output, const preprocess_params_t* params,
+                        uint32_t num_threads) {
+    if (!input || !output || !params) return -1;
+    
+    size_t total = 1;
+    for (uint32_t i = 0; i < input->shape.ndim; i++) {
+        total *= input->shape.dims[i];
+    }
+    
+    cast_job_t job = {input, output};
+    size_t bytes_per_element = tensor_get_dtype_size(input->dtype) + tensor_get_dtype_size(output->dtype);
+    preprocess_parallel_for(num_threads, total, bytes_per_element, cast_range, &job);
+    
     return 0;
-} 
\ No newline at end of file
+}
@@ -6,6 +6,9 @@
 #include <stddef.h>
 #include "core/tensor.h"
 #include "core/multimodal.h"
+#include "core/memory_pool.h"
+#include "core/model_parser.h"
+#include "utils/tokenizer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -86,6 +89,26 @@ typedef enum {
     INTERPOLATION_AREA              /**< 区域插值 */
 } interpolation_method_e;
 
+/**
+ * @brief 像素格式（颜色空间转换）
+ */
+typedef enum {
+    COLOR_FORMAT_RGB = 0,           /**< RGB 交错，[(N,) H, W, 3] */
+    COLOR_FORMAT_BGR,               /**< BGR 交错，[(N,) H, W, 3] */
+    COLOR_FORMAT_NV12,              /**< Y 平面 + UV 交错，[(N,) H*3/2, W] */
+    COLOR_FORMAT_NV21,              /**< Y 平面 + VU 交错，[(N,) H*3/2, W] */
+    COLOR_FORMAT_I420,              /**< Y、U、V 三个平面，[(N,) H*3/2, W] */
+    COLOR_FORMAT_YUYV               /**< Y0 U Y1 V 打包，[(N,) H, W, 2] */
+} color_format_e;
+
+/**
+ * @brief YUV 色彩标准
+ */
+typedef enum {
+    COLOR_STANDARD_BT601 = 0,       /**< BT.601（标清） */
+    COLOR_STANDARD_BT709            /**< BT.709（高清） */
+} color_standard_e;
+
 /**
  * @brief 填充模式
  */
@@ -97,6 +120,16 @@ typedef enum {
     PADDING_SYMMETRIC               /**< 对称填充 */
 } padding_mode_e;
 
+/**
+ * @brief 形态学操作（矩形结构元素）
+ */
+typedef enum {
+    MORPHOLOGY_ERODE = 0,           /**< 腐蚀（窗口最小值） */
+    MORPHOLOGY_DILATE,              /**< 膨胀（窗口最大值） */
+    MORPHOLOGY_OPEN,                /**< 开运算（先腐蚀后膨胀） */
+    MORPHOLOGY_CLOSE                /**< 闭运算（先膨胀后腐蚀） */
+} morphology_op_e;
+
 /**
  * @brief 预处理参数
  */
@@ -137,6 +170,15 @@ typedef struct {
             float value;            /**< 填充值 */
         } pad;
         
+        struct {
+            uint32_t perm[TENSOR_MAX_DIMS]; /**< 维度排列 */
+            uint32_t ndim;          /**< 维度数量 */
+        } transpose;
+        
+        struct {
+            TensorDataType dtype;   /**< 目标数据类型 */
+        } cast;
+        
         struct {
             uint32_t x;             /**< 起始X */
             uint32_t y;             /**< 起始Y */
@@ -145,22 +187,49 @@ typedef struct {
         } crop;
         
         struct {
-            float factor;           /**< 调整因子 */
+            float factor;           /**< 调整因子（输出 = 输入 × 因子） */
         } brightness;
         
         struct {
-            float factor;           /**< 调整因子 */
+            float factor;           /**< 调整因子（以中灰128为支点缩放） */
         } contrast;
         
         struct {
-            float gamma;            /**< 伽马值 */
+            float gamma;            /**< 伽马值（输出 = 255 × (输入/255)^gamma） */
         } gamma;
         
         struct {
-            uint32_t kernel_size;   /**< 核大小 */
-            float sigma;            /**< 标准差 */
+            color_format_e src_format; /**< 源像素格式 */
+            color_format_e dst_format; /**< 目标像素格式（RGB或BGR） */
+            color_standard_e standard; /**< YUV 色彩标准 */
+            bool full_range;        /**< YUV 为全范围（0~255），否则为有限范围（Y 16~235） */
+        } color_convert;
+        
+        struct {
+            float scale[4];         /**< 量化缩放因子（实数 = (量化值 - 零点) × scale） */
+            int32_t zero_point[4];  /**< 量化零点 */
+            uint32_t channels;      /**< 通道数（1表示逐张量） */
+            TensorDataType dtype;   /**< 量化类型（INT8或UINT8；反量化时由输入决定） */
+        } quantize;                 /**< 量化与反量化共用 */
+        
+        struct {
+            uint32_t kernel_size;   /**< 核大小（奇数；高斯模糊为0时取 2*ceil(3*sigma)+1） */
+            float sigma;            /**< 高斯标准差（0表示由核大小推导） */
+            bool box;               /**< 均值（盒式）滤波，忽略 sigma */
         } blur;
         
+        struct {
+            uint32_t kernel_size;   /**< 高斯核大小（规则同 blur） */
+            float sigma;            /**< 高斯标准差 */
+            float amount;           /**< 锐化强度（输出 = 输入 + amount × (输入 - 模糊)） */
+        } sharpen;
+        
+        struct {
+            morphology_op_e op;     /**< 形态学操作 */
+            uint32_t kernel_width;  /**< 结构元素宽度（奇数） */
+            uint32_t kernel_height; /**< 结构元素高度（奇数） */
+        } morphology;
+        
         struct {
             uint32_t sample_rate;   /**< 采样率 */
             uint32_t target_rate;   /**< 目标采样率 */
@@ -171,22 +240,38 @@ typedef struct {
         } amplitude_scale;
         
         struct {
-            uint32_t window_size;   /**< 窗口大小 */
+            uint32_t window_size;   /**< 窗口大小（输出 Hann 加窗后的帧） */
             uint32_t hop_size;      /**< 跳跃大小 */
         } windowing;
         
         struct {
-            uint32_t n_fft;         /**< FFT点数 */
+            uint32_t n_fft;         /**< FFT点数（输出幅度谱） */
             uint32_t hop_length;    /**< 跳跃长度 */
-            uint32_t win_length;    /**< 窗口长度 */
+            uint32_t win_length;    /**< 窗口长度（0表示等于 n_fft） */
         } fft;
         
+        struct {
+            uint32_t n_fft;         /**< FFT点数 */
+            uint32_t hop_length;    /**< 跳跃长度 */
+            uint32_t win_length;    /**< 窗口长度（0表示等于 n_fft） */
+            uint32_t n_mels;        /**< 梅尔频带数（0表示线性功率谱） */
+            uint32_t sample_rate;   /**< 采样率（0表示16000） */
+            bool log_scale;         /**< 是否转换为 dB */
+        } spectrogram;
+        
         struct {
             uint32_t n_mfcc;        /**< MFCC系数数量 */
             uint32_t n_fft;         /**< FFT点数 */
             uint32_t hop_length;    /**< 跳跃长度 */
+            uint32_t n_mels;        /**< 梅尔频带数（0表示40） */
+            uint32_t sample_rate;   /**< 采样率（0表示16000） */
         } mfcc;
         
+        struct {
+            tokenizer_t tokenizer;  /**< 分词器（由调用方持有） */
+            uint32_t max_length;    /**< 每条文本的最大 token 数 */
+        } tokenize;
+        
         struct {
             uint32_t max_length;    /**< 最大长度 */
             uint32_t pad_value;     /**< 填充值 */
@@ -197,7 +282,8 @@ typedef struct {
         } sequence_truncate;
         
         struct {
-            uint32_t target_points; /**< 目标点数 */
+            uint32_t target_points; /**< 目标点数（voxel_size 为0时据此搜索体素边长） */
+            float voxel_size;       /**< 体素边长（0表示由 target_points 决定） */
         } downsample;
         
         struct {
@@ -222,6 +308,44 @@ typedef struct {
     } params;
 } preprocess_params_t;
 
+/**
+ * @brief 预处理管道融合统计
+ */
+typedef struct {
+    uint32_t fused_groups;          /**< 融合组数量 */
+    uint32_t fused_ops;             /**< 被融合的操作数量 */
+    uint32_t fallback_ops;          /**< 逐操作执行的操作数量 */
+    uint64_t executions;            /**< 执行次数 */
+    uint64_t unfused_bytes;         /**< 逐操作执行所需的内存流量（字节） */
+    uint64_t fused_bytes;           /**< 实际产生的内存流量（字节） */
+    uint64_t scratch_allocs;        /**< 中间结果缓冲区分配次数 */
+} preprocess_fusion_stats_t;
+
+/**
+ * @brief 管道静态缓冲区计划配置
+ */
+typedef struct {
+    TensorShape input_shape;        /**< 输入形状 */
+    TensorDataType input_dtype;     /**< 输入类型 */
+    TensorFormat input_format;      /**< 输入格式 */
+    memory_pool_t memory_pool;      /**< 缓冲区来源（NULL表示直接分配，内存池须比管道存活更久） */
+    bool bind_output;               /**< 输出也放在计划缓冲区中（结果在下一次执行前有效） */
+} preprocess_plan_config_t;
+
+/**
+ * @brief 管道静态缓冲区计划信息
+ */
+typedef struct {
+    TensorShape output_shape;       /**< 输出形状 */
+    TensorDataType output_dtype;    /**< 输出类型 */
+    TensorFormat output_format;     /**< 输出格式 */
+    size_t output_bytes;            /**< 输出字节数 */
+    uint32_t intermediate_count;    /**< 中间结果数量 */
+    size_t scratch_bytes;           /**< 中间结果缓冲区字节数 */
+    size_t total_bytes;             /**< 计划缓冲区总字节数（含绑定的输出） */
+    uint64_t planned_executions;    /**< 按计划执行的次数 */
+} preprocess_plan_info_t;
+
 /**
  * @brief 预处理操作句柄
  */
@@ -232,6 +356,14 @@ typedef struct PreprocessOp* preprocess_op_t;
  */
 typedef struct PreprocessPipeline* preprocess_pipeline_t;
 
+/**
+ * @brief 模态与预处理管道的对应关系
+ */
+typedef struct {
+    modality_type_e modality;       /**< 模态类型 */
+    preprocess_pipeline_t pipeline; /**< 该模态使用的管道 */
+} preprocess_modality_pipeline_t;
+
 /**
  * @brief 自定义预处理函数类型
  */
@@ -305,17 +437,51 @@ int preprocess_pipeline_remove_op(preprocess_pipeline_t pipeline, uint32_t index
  */
 int preprocess_pipeline_execute(preprocess_pipeline_t pipeline, const Tensor* input, Tensor* output);
 
+/**
+ * @brief 编译预处理管道
+ * 
+ * 将连续的可融合操作（裁剪、缩放、翻转、归一化、类型转换、NHWC/NCHW转置）
+ * 合并为单个融合内核，每个源像素只读取一次并直接写出最终张量；
+ * 不可融合的操作回退为逐操作执行。添加或移除操作后会自动重新编译。
+ * 
+ * @param pipeline 预处理管道
+ * @return int 0成功，其他失败
+ */
+int preprocess_pipeline_compile(preprocess_pipeline_t pipeline);
+
+/**
+ * @brief 启用或禁用操作融合
+ * 
+ * @param pipeline 预处理管道
+ * @param enable 是否启用融合（默认启用）
+ * @return int 0成功，其他失败
+ */
+int preprocess_pipeline_set_fusion(preprocess_pipeline_t pipeline, bool enable);
+
+/**
+ * @brief 获取融合统计信息
+ * 
+ * @param pipeline 预处理管道
+ * @param stats 输出统计信息
+ * @return int 0成功，其他失败
+ */
+int preprocess_pipeline_get_fusion_stats(preprocess_pipeline_t pipeline, preprocess_fusion_stats_t* stats);
+
 /**
  * @brief 批量执行预处理管道
  * 
+ * 各样本的结果直接写入一个连续批量张量的对应切片（NCHW 或 NHWC，
+ * 由管道输出布局决定），无需再拼接。输入形状一致时，样本在共享
+ * 线程池上并发处理，并行度由 preprocess_pipeline_set_parallel 设置。
+ * 
  * @param pipeline 预处理管道
- * @param inputs 输入张量数组
- * @param outputs 输出张量数组
+ * @param inputs 输入张量数组（每个为单个样本）
+ * @param output 批量输出张量（data为NULL时自动分配）
  * @param batch_size 批量大小
  * @return int 0成功，其他失败
  */
 int preprocess_pipeline_execute_batch(preprocess_pipeline_t pipeline, const Tensor* inputs, 
-                                     Tensor* outputs, uint32_t batch_size);
+                                     Tensor* output, uint32_t batch_size);
 
 /**
  * @brief 获取管道操作数量
@@ -364,6 +530,8 @@ preprocess_pipeline_t preprocess_pipeline_deserialize(const void* buffer, size_t
 /**
  * @brief 多模态预处理
  * 
+ * 对每个模态依次应用同一个管道，结果写入输出容器的规则同 preprocess_multimodal_execute_pipelines。
+ * 
  * @param pipeline 预处理管道
  * @param input 输入多模态数据
  * @param output 输出多模态数据
@@ -372,6 +540,39 @@ preprocess_pipeline_t preprocess_pipeline_deserialize(const void* buffer, size_t
 int preprocess_multimodal_execute(preprocess_pipeline_t pipeline, const MultiModalData* input, 
                                  MultiModalData* output);
 
+/**
+ * @brief 按模态并发执行各自的预处理管道
+ * 
+ * 每个输入模态使用映射中对应的管道，各模态在共享线程池上并发执行，总耗时接近最慢的模态。
+ * 模态数据按 3 维及以上为 NHWC、其余为 NC 解释为张量。输出容器中已有同类模态（同类多个时按出现顺序对应）
+ * 且缓冲区足够时结果直接写入其中，否则追加模态并分配缓冲区。没有对应管道的模态不写入输出。
+ * 
+ * @param pipelines 模态到管道的映射（同一管道可对应多个模态，此时这些模态依次执行）
+ * @param pipeline_count 映射数量
+ * @param input 输入多模态数据
+ * @param output 输出多模态数据（不能与输入相同）
+ * @param num_threads 最大并发模态数（0表示不限制）
+ * @return int 0成功，其他失败（任一模态失败）
+ */
+int preprocess_multimodal_execute_pipelines(const preprocess_modality_pipeline_t* pipelines, uint32_t pipeline_count,
+                                            const MultiModalData* input, MultiModalData* output,
+                                            uint32_t num_threads);
+
+/**
+ * @brief 为多模态输出预先分配缓冲区
+ * 
+ * 按各管道推断的输出形状在输出容器中准备模态和缓冲区，之后形状不变的执行不再分配内存。
+ * 含有无法静态推断的操作的模态跳过，执行时再分配。
+ * 
+ * @param pipelines 模态到管道的映射
+ * @param pipeline_count 映射数量
+ * @param input 代表性输入（只使用形状和类型）
+ * @param output 输出多模态数据
+ * @return int 0成功，其他失败
+ */
+int preprocess_multimodal_prepare_output(const preprocess_modality_pipeline_t* pipelines, uint32_t pipeline_count,
+                                         const MultiModalData* input, MultiModalData* output);
+
 /**
  * @brief 创建自定义预处理操作
  * 
@@ -418,9 +619,25 @@ preprocess_type_e preprocess_type_from_string(const char* type_str);
  */
 bool preprocess_validate_params(preprocess_type_e type, const preprocess_params_t* params);
 
+/**
+ * @brief 由模型输入/输出规格生成量化或反量化参数
+ * 
+ * 规格为 INT8/UINT8 且 scale 大于0时生成逐张量参数：模型输入追加 PREPROCESS_QUANTIZE，
+ * 模型输出使用 PREPROCESS_DEQUANTIZE。量化紧跟归一化时两者融合为一次遍历。
+ * 
+ * @param spec 模型输入/输出规格
+ * @param type PREPROCESS_QUANTIZE 或 PREPROCESS_DEQUANTIZE
+ * @param params 输出参数
+ * @return int 0成功，-1表示规格未量化或参数无效
+ */
+int preprocess_quantize_params_from_spec(const model_io_spec_t* spec, preprocess_type_e type,
+                                         preprocess_params_t* params);
+
 /**
  * @brief 获取预处理操作的输出形状
  * 
+ * 图像类操作（裁剪、缩放等）按 NHWC 布局解释输入形状。
+ * 
  * @param op 预处理操作
  * @param input_shape 输入形状
  * @param output_shape 输出形状
@@ -456,6 +673,9 @@ int preprocess_pipeline_benchmark(preprocess_pipeline_t pipeline, const Tensor*
 /**
  * @brief 预处理操作缓存
  * 
+ * 亮度、对比度和伽马操作（仅支持 UINT8）以 256 项查找表实现，
+ * 启用缓存后查找表只构建一次。
+ * 
  * @param op 预处理操作
  * @param enable 是否启用缓存
  * @return int 0成功，其他失败
@@ -465,12 +685,48 @@ int preprocess_op_set_cache(preprocess_op_t op, bool enable);
 /**
  * @brief 预处理管道并行化
  * 
+ * 缩放、归一化、裁剪、翻转、类型转换及融合内核按输出行切分为
+ * 适合 L2 缓存的分块，在进程共享线程池上并行执行。
+ * 
  * @param pipeline 预处理管道
- * @param num_threads 线程数
+ * @param num_threads 线程数（包含调用线程，1表示串行）
  * @return int 0成功，其他失败
  */
 int preprocess_pipeline_set_parallel(preprocess_pipeline_t pipeline, uint32_t num_threads);
 
+/**
+ * @brief 为给定输入形状生成静态缓冲区计划
+ * 
+ * 沿操作链推断每个执行段的输出形状、类型和格式，融合组在此时完成绑定；
+ * 相邻中间结果交替使用两块区域，所有区域一次性分配。之后输入形状、类型和格式
+ * 与计划一致的执行直接使用预先绑定的缓冲区，不再推断形状或分配中间结果；
+ * 不一致时按原方式动态执行。增删操作或切换融合会使计划失效。
+ * 
+ * 包含无法静态推断输出的操作（自定义操作、点云降采样等）时无法生成计划。
+ * 批量执行不使用计划。
+ * 
+ * @param pipeline 预处理管道
+ * @param config 计划配置
+ * @return int 0成功，其他失败
+ */
+int preprocess_pipeline_plan(preprocess_pipeline_t pipeline, const preprocess_plan_config_t* config);
+
+/**
+ * @brief 获取当前计划信息
+ * 
+ * @param pipeline 预处理管道
+ * @param info 输出计划信息
+ * @return int 0成功，没有有效计划时返回-1
+ */
+int preprocess_pipeline_get_plan_info(preprocess_pipeline_t pipeline, preprocess_plan_info_t* info);
+
+/**
+ * @brief 释放当前计划及其缓冲区，恢复动态执行
+ * 
+ * @param pipeline 预处理管道
+ */
+void preprocess_pipeline_clear_plan(preprocess_pipeline_t pipeline);
+
 /**
  * @brief 预处理操作调试信息
  * 
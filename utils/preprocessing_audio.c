@@ -0,0 +1,321 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// 未指定时的默认采样率和 MFCC 梅尔频带数
+#define PREPROCESS_AUDIO_DEFAULT_RATE 16000
+#define PREPROCESS_AUDIO_DEFAULT_MFCC_MELS 40
+
+/**
+ * @brief 音频特征分块上下文
+ */
+typedef struct {
+    audio_frontend_t frontend;
+    const float* samples;           /**< [批量, 采样] */
+    size_t num_samples;             /**< 每行采样数 */
+    float* output;                  /**< [批量, 帧, 维度] */
+    uint32_t frames;                /**< 每行帧数 */
+    uint32_t dim;                   /**< 特征维度 */
+    uint8_t* work;                  /**< 每个工作槽一份前端工作区 */
+    size_t work_stride;             /**< 相邻工作槽的间距 */
+    atomic_int result;              /**< 任一分块失败时置为-1 */
+} audio_job_t;
+
+bool preprocess_audio_is_op(preprocess_type_e type) {
+    switch (type) {
+        case PREPROCESS_WINDOWING:
+        case PREPROCESS_FFT:
+        case PREPROCESS_SPECTROGRAM:
+        case PREPROCESS_MFCC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 将操作参数转换为前端配置
+static void params_to_config(const preprocess_params_t* params, audio_frontend_config_t* config) {
+    switch (params->type) {
+        case PREPROCESS_WINDOWING:
+            *config = audio_frontend_default_config(AUDIO_FEATURE_FRAMES);
+            config->n_fft = params->params.windowing.window_size;
+            config->win_length = params->params.windowing.window_size;
+            config->hop_length = params->params.windowing.hop_size;
+            break;
+
+        case PREPROCESS_FFT:
+            *config = audio_frontend_default_config(AUDIO_FEATURE_MAGNITUDE);
+            config->n_fft = params->params.fft.n_fft;
+            config->win_length = params->params.fft.win_length;
+            config->hop_length = params->params.fft.hop_length;
+            break;
+
+        case PREPROCESS_SPECTROGRAM: {
+            uint32_t n_mels = params->params.spectrogram.n_mels;
+            *config = audio_frontend_default_config(n_mels > 0 ? AUDIO_FEATURE_MEL : AUDIO_FEATURE_POWER);
+            config->n_fft = params->params.spectrogram.n_fft;
+            config->win_length = params->params.spectrogram.win_length;
+            config->hop_length = params->params.spectrogram.hop_length;
+            config->n_mels = n_mels;
+            config->log_scale = params->params.spectrogram.log_scale;
+            if (params->params.spectrogram.sample_rate > 0) {
+                config->sample_rate = params->params.spectrogram.sample_rate;
+            }
+            break;
+        }
+
+        default:
+            *config = audio_frontend_default_config(AUDIO_FEATURE_MFCC);
+            config->n_fft = params->params.mfcc.n_fft;
+            config->win_length = 0;
+            config->hop_length = params->params.mfcc.hop_length;
+            config->n_mfcc = params->params.mfcc.n_mfcc;
+            config->n_mels = params->params.mfcc.n_mels > 0 ? params->params.mfcc.n_mels
+                                                            : PREPROCESS_AUDIO_DEFAULT_MFCC_MELS;
+            config->sample_rate = params->params.mfcc.sample_rate > 0 ? params->params.mfcc.sample_rate
+                                                                     : PREPROCESS_AUDIO_DEFAULT_RATE;
+            break;
+    }
+}
+
+// 获取操作的前端；窗函数、旋转因子和滤波器组只在首次使用时计算
+static audio_frontend_t get_op_frontend(preprocess_op_t op) {
+    pthread_mutex_lock(&op->mutex);
+    if (!op->audio) {
+        audio_frontend_config_t config;
+        params_to_config(&op->params, &config);
+        op->audio = audio_frontend_create(&config);
+    }
+    audio_frontend_t frontend = op->audio;
+    pthread_mutex_unlock(&op->mutex);
+
+    return frontend;
+}
+
+// 解析 [采样] 或 [批量, 采样] 形状
+static int audio_rows_from_shape(const TensorShape* shape, uint32_t* rows, size_t* samples) {
+    if (shape->ndim == 1) {
+        *rows = 1;
+        *samples = shape->dims[0];
+        return 0;
+    }
+    if (shape->ndim == 2) {
+        *rows = shape->dims[0];
+        *samples = shape->dims[1];
+        return 0;
+    }
+    return -1;
+}
+
+// 取得浮点采样并预留 extra 字节的附加工作区
+// 16 位 PCM 转换为 [-1, 1) 浮点放在工作区开头，附加工作区紧随其后；buffer 返回整块工作区以便归还
+static const float* samples_as_float(const Tensor* input, size_t total, size_t extra,
+                                     preprocess_workspace_t* workspace, uint8_t** buffer, uint8_t** extra_area) {
+    if (input->dtype != TENSOR_TYPE_FLOAT32 && input->dtype != TENSOR_TYPE_INT16) {
+        LOG_ERROR("Audio ops require FLOAT32 or INT16 samples");
+        return NULL;
+    }
+
+    size_t converted_bytes = 0;
+    if (input->dtype == TENSOR_TYPE_INT16) {
+        converted_bytes = preprocess_workspace_stride(sizeof(float) * total);
+    }
+    *buffer = NULL;
+    *extra_area = NULL;
+    if (converted_bytes + extra > 0) {
+        *buffer = preprocess_workspace_reserve(workspace, converted_bytes + extra);
+        if (!*buffer) {
+            LOG_ERROR("Failed to allocate sample buffer");
+            return NULL;
+        }
+        *extra_area = *buffer + converted_bytes;
+    }
+
+    if (input->dtype == TENSOR_TYPE_FLOAT32) {
+        return (const float*)input->data;
+    }
+
+    const int16_t* pcm = (const int16_t*)input->data;
+    float* samples = (float*)*buffer;
+    for (size_t i = 0; i < total; i++) {
+        samples[i] = pcm[i] * (1.0f / 32768.0f);
+    }
+    return samples;
+}
+
+int preprocess_audio_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                                 TensorShape* output_shape) {
+    uint32_t rows;
+    size_t samples;
+    if (audio_rows_from_shape(input_shape, &rows, &samples) != 0) {
+        LOG_ERROR("Audio features expect a 1D or 2D sample tensor");
+        return -1;
+    }
+
+    audio_frontend_t frontend = get_op_frontend(op);
+    if (!frontend) return -1;
+
+    uint32_t frames = audio_frontend_get_frame_count(frontend, samples);
+    if (frames == 0) {
+        LOG_ERROR("Audio signal of %zu samples is shorter than one frame", samples);
+        return -1;
+    }
+
+    uint32_t dim = audio_frontend_get_feature_dim(frontend);
+    if (input_shape->ndim == 1) {
+        output_shape->ndim = 2;
+        output_shape->dims[0] = frames;
+        output_shape->dims[1] = dim;
+    } else {
+        output_shape->ndim = 3;
+        output_shape->dims[0] = rows;
+        output_shape->dims[1] = frames;
+        output_shape->dims[2] = dim;
+    }
+    return 0;
+}
+
+// 计算 [begin, end) 范围内的帧（按 行*帧 展开），每段不跨行
+static void audio_range(void* context, uint32_t slot, size_t begin, size_t end) {
+    audio_job_t* job = (audio_job_t*)context;
+    void* work = job->work + slot * job->work_stride;
+    const audio_frontend_config_t* config = audio_frontend_get_config(job->frontend);
+
+    size_t i = begin;
+    while (i < end) {
+        size_t row = i / job->frames;
+        size_t first = i % job->frames;
+        size_t row_end = (row + 1) * job->frames;
+        if (row_end > end) row_end = end;
+        uint32_t count = (uint32_t)(row_end - i);
+
+        // 只传入这些帧覆盖的采样，帧边界与整行计算一致
+        const float* src = job->samples + row * job->num_samples + first * config->hop_length;
+        size_t span = (size_t)(count - 1) * config->hop_length + config->n_fft;
+        float* dst = job->output + i * job->dim;
+
+        uint32_t produced = 0;
+        if (audio_frontend_compute_with_work(job->frontend, src, span, dst, count, &produced, work) != 0 ||
+            produced != count) {
+            atomic_store(&job->result, -1);
+        }
+        i = row_end;
+    }
+}
+
+int preprocess_audio_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                             uint32_t num_threads, preprocess_workspace_t* workspace) {
+    audio_frontend_t frontend = get_op_frontend(op);
+    if (!frontend) return -1;
+
+    audio_job_t job;
+    memset(&job, 0, sizeof(job));
+    atomic_init(&job.result, 0);
+    job.frontend = frontend;
+    job.output = (float*)output->data;
+    job.dim = audio_frontend_get_feature_dim(frontend);
+
+    uint32_t rows;
+    if (audio_rows_from_shape(&input->shape, &rows, &job.num_samples) != 0) return -1;
+    job.frames = audio_frontend_get_frame_count(frontend, job.num_samples);
+
+    job.work_stride = preprocess_workspace_stride(audio_frontend_get_work_size(frontend));
+    uint8_t* buffer = NULL;
+    job.samples = samples_as_float(input, (size_t)rows * job.num_samples,
+                                   job.work_stride * preprocess_parallel_slots(num_threads), workspace, &buffer,
+                                   &job.work);
+    if (!job.samples) return -1;
+
+    const audio_frontend_config_t* config = audio_frontend_get_config(frontend);
+    size_t frame_bytes = sizeof(float) * ((size_t)config->hop_length + job.dim);
+    preprocess_parallel_for_slots(num_threads, (size_t)rows * job.frames, frame_bytes, audio_range, &job);
+
+    preprocess_workspace_release(workspace, buffer);
+    return atomic_load(&job.result);
+}
+
+/**
+ * @brief 重采样分行上下文
+ */
+typedef struct {
+    audio_resampler_t resampler;
+    const float* samples;           /**< [批量, 采样] */
+    size_t num_samples;             /**< 每行输入采样数 */
+    float* output;                  /**< [批量, 输出采样] */
+    size_t output_length;           /**< 每行输出采样数 */
+    atomic_int result;              /**< 任一行失败时置为-1 */
+} resample_job_t;
+
+static audio_resampler_t get_op_resampler(preprocess_op_t op) {
+    pthread_mutex_lock(&op->mutex);
+    if (!op->resampler) {
+        op->resampler = audio_resampler_create(op->params.params.resample.sample_rate,
+                                               op->params.params.resample.target_rate);
+    }
+    audio_resampler_t resampler = op->resampler;
+    pthread_mutex_unlock(&op->mutex);
+
+    return resampler;
+}
+
+int preprocess_resample_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                                    TensorShape* output_shape) {
+    uint32_t rows;
+    size_t samples;
+    if (audio_rows_from_shape(input_shape, &rows, &samples) != 0) {
+        LOG_ERROR("Resample expects a 1D or 2D sample tensor");
+        return -1;
+    }
+
+    audio_resampler_t resampler = get_op_resampler(op);
+    if (!resampler) return -1;
+
+    size_t length = audio_resampler_get_output_length(resampler, samples);
+    if (length == 0 || length > UINT32_MAX) return -1;
+
+    *output_shape = *input_shape;
+    output_shape->dims[input_shape->ndim - 1] = (uint32_t)length;
+    return 0;
+}
+
+static void resample_range(void* context, size_t begin, size_t end) {
+    resample_job_t* job = (resample_job_t*)context;
+
+    for (size_t row = begin; row < end; row++) {
+        size_t produced = 0;
+        if (audio_resampler_convert(job->resampler, job->samples + row * job->num_samples, job->num_samples,
+                                    job->output + row * job->output_length, job->output_length,
+                                    &produced) != 0) {
+            atomic_store(&job->result, -1);
+        }
+    }
+}
+
+int preprocess_resample_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                                uint32_t num_threads, preprocess_workspace_t* workspace) {
+    audio_resampler_t resampler = get_op_resampler(op);
+    if (!resampler) return -1;
+
+    resample_job_t job;
+    memset(&job, 0, sizeof(job));
+    atomic_init(&job.result, 0);
+    job.resampler = resampler;
+    job.output = (float*)output->data;
+
+    uint32_t rows;
+    if (audio_rows_from_shape(&input->shape, &rows, &job.num_samples) != 0) return -1;
+    job.output_length = audio_resampler_get_output_length(resampler, job.num_samples);
+
+    uint8_t* buffer = NULL;
+    uint8_t* unused = NULL;
+    job.samples = samples_as_float(input, (size_t)rows * job.num_samples, 0, workspace, &buffer, &unused);
+    if (!job.samples) return -1;
+
+    size_t row_bytes = sizeof(float) * (job.num_samples + job.output_length);
+    preprocess_parallel_for(num_threads, rows, row_bytes, resample_range, &job);
+
+    preprocess_workspace_release(workspace, buffer);
+    return atomic_load(&job.result);
+}
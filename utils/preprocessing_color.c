@@ -0,0 +1,338 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief 颜色空间转换
+ *
+ * YUV 帧逐行转换为交错 RGB/BGR：色度按 4:2:0 / 4:2:2 最近邻上采样，
+ * 先把一行的色度（以及 YUYV 的亮度）解交错为平面，再由向量内核以 Q13 定点系数
+ * 每次转换 8 个像素。标量尾部使用相同的定点公式，结果与向量路径逐位一致。
+ */
+
+// 定点系数小数位数
+#define COLOR_SHIFT 13
+#define COLOR_ONE (1 << COLOR_SHIFT)
+#define COLOR_ROUND (1 << (COLOR_SHIFT - 1))
+
+static bool color_is_yuv420(color_format_e format) {
+    return format == COLOR_FORMAT_NV12 || format == COLOR_FORMAT_NV21 || format == COLOR_FORMAT_I420;
+}
+
+// 由 Kr、Kb 推导 YUV->RGB 系数；有限范围时亮度按 255/219、色度按 255/224 拉伸
+static void color_coefficients(color_standard_e standard, bool full_range, preprocess_color_t* color) {
+    double kr = standard == COLOR_STANDARD_BT709 ? 0.2126 : 0.299;
+    double kb = standard == COLOR_STANDARD_BT709 ? 0.0722 : 0.114;
+    double kg = 1.0 - kr - kb;
+    double y_scale = full_range ? 1.0 : 255.0 / 219.0;
+    double c_scale = full_range ? 1.0 : 255.0 / 224.0;
+
+    color->y_offset = full_range ? 0 : 16;
+    color->y_gain = (int16_t)lround(y_scale * COLOR_ONE);
+    color->rv = (int16_t)lround(2.0 * (1.0 - kr) * c_scale * COLOR_ONE);
+    color->bu = (int16_t)lround(2.0 * (1.0 - kb) * c_scale * COLOR_ONE);
+    color->gu = (int16_t)lround(2.0 * kb * (1.0 - kb) / kg * c_scale * COLOR_ONE);
+    color->gv = (int16_t)lround(2.0 * kr * (1.0 - kr) / kg * c_scale * COLOR_ONE);
+}
+
+int preprocess_color_setup(const preprocess_params_t* params, const TensorShape* shape,
+                           preprocess_color_t* color, preprocess_image_dims_t* dims) {
+    if (!params || !shape) return -1;
+
+    const uint32_t* d = shape->dims;
+    uint32_t ndim = shape->ndim;
+    color_format_e src = params->params.color_convert.src_format;
+
+    preprocess_image_dims_t out;
+    memset(&out, 0, sizeof(out));
+    out.c = 3;
+    out.n = 1;
+    size_t frame_bytes = 0;
+
+    if (color_is_yuv420(src)) {
+        // [(N,) H*3/2, W]：行数为3的倍数时 H 必为偶数
+        if (ndim != 2 && ndim != 3) return -1;
+        out.has_batch = ndim == 3;
+        if (out.has_batch) out.n = d[0];
+        uint32_t rows = d[ndim - 2];
+        out.w = d[ndim - 1];
+        if (rows % 3 != 0 || out.w % 2 != 0) return -1;
+        out.h = rows / 3 * 2;
+        frame_bytes = (size_t)rows * out.w;
+    } else if (src == COLOR_FORMAT_YUYV) {
+        if ((ndim != 3 && ndim != 4) || d[ndim - 1] != 2) return -1;
+        out.has_batch = ndim == 4;
+        if (out.has_batch) out.n = d[0];
+        out.h = d[ndim - 3];
+        out.w = d[ndim - 2];
+        if (out.w % 2 != 0) return -1;
+        frame_bytes = (size_t)out.h * out.w * 2;
+    } else {
+        if ((ndim != 3 && ndim != 4) || d[ndim - 1] != 3) return -1;
+        out.has_batch = ndim == 4;
+        if (out.has_batch) out.n = d[0];
+        out.h = d[ndim - 3];
+        out.w = d[ndim - 2];
+        frame_bytes = (size_t)out.h * out.w * 3;
+    }
+
+    if (out.n == 0 || out.h == 0 || out.w == 0) return -1;
+
+    if (color) {
+        memset(color, 0, sizeof(*color));
+        color->src_format = src;
+        color->bgr = params->params.color_convert.dst_format == COLOR_FORMAT_BGR;
+        color->width = out.w;
+        color->height = out.h;
+        color->frame_bytes = frame_bytes;
+        color_coefficients(params->params.color_convert.standard, params->params.color_convert.full_range, color);
+    }
+    if (dims) {
+        *dims = out;
+    }
+    return 0;
+}
+
+static inline uint8_t color_clamp(int32_t v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+// 平面 Y、U、V（色度为半宽）转换为交错三通道
+static void yuv_row_to_rgb(const preprocess_color_t* k, const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                           uint8_t* dst, uint32_t width) {
+    uint32_t x = 0;
+    const int ri = k->bgr ? 2 : 0;
+    const int bi = k->bgr ? 0 : 2;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i y_offset = _mm_set1_epi16(k->y_offset);
+    const __m128i c_offset = _mm_set1_epi16(128);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i round = _mm_set1_epi32(COLOR_ROUND);
+    // madd 按 16 位对相乘相加：低半部分为亮度，高半部分为色度
+    const __m128i k_r = _mm_set_epi16(k->rv, k->y_gain, k->rv, k->y_gain, k->rv, k->y_gain, k->rv, k->y_gain);
+    const __m128i k_b = _mm_set_epi16(k->bu, k->y_gain, k->bu, k->y_gain, k->bu, k->y_gain, k->bu, k->y_gain);
+    const __m128i k_g = _mm_set_epi16(-k->gu, k->y_gain, -k->gu, k->y_gain, -k->gu, k->y_gain, -k->gu, k->y_gain);
+    const __m128i k_gv = _mm_set_epi16(COLOR_ROUND, -k->gv, COLOR_ROUND, -k->gv, COLOR_ROUND, -k->gv,
+                                       COLOR_ROUND, -k->gv);
+
+    for (; x + 8 <= width; x += 8) {
+        uint32_t u4, v4;
+        memcpy(&u4, u + x / 2, 4);
+        memcpy(&v4, v + x / 2, 4);
+        __m128i uu = _mm_cvtsi32_si128((int)u4);
+        __m128i vv = _mm_cvtsi32_si128((int)v4);
+
+        __m128i c = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(y + x)), zero), y_offset);
+        __m128i dd = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(uu, uu), zero), c_offset);
+        __m128i ee = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(vv, vv), zero), c_offset);
+
+        __m128i ce_lo = _mm_unpacklo_epi16(c, ee), ce_hi = _mm_unpackhi_epi16(c, ee);
+        __m128i cd_lo = _mm_unpacklo_epi16(c, dd), cd_hi = _mm_unpackhi_epi16(c, dd);
+        __m128i e1_lo = _mm_unpacklo_epi16(ee, one), e1_hi = _mm_unpackhi_epi16(ee, one);
+
+        __m128i r = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_lo, k_r), round), COLOR_SHIFT),
+            _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_hi, k_r), round), COLOR_SHIFT));
+        __m128i g = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, k_g), _mm_madd_epi16(e1_lo, k_gv)), COLOR_SHIFT),
+            _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, k_g), _mm_madd_epi16(e1_hi, k_gv)), COLOR_SHIFT));
+        __m128i b = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, k_b), round), COLOR_SHIFT),
+            _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, k_b), round), COLOR_SHIFT));
+
+        // SSE2 没有字节重排，三个通道经栈上缓冲交错写出
+        uint8_t planes[3][16];
+        _mm_storeu_si128((__m128i*)planes[ri], _mm_packus_epi16(r, r));
+        _mm_storeu_si128((__m128i*)planes[1], _mm_packus_epi16(g, g));
+        _mm_storeu_si128((__m128i*)planes[bi], _mm_packus_epi16(b, b));
+        uint8_t* out = dst + (size_t)x * 3;
+        for (int i = 0; i < 8; i++) {
+            out[3 * i + 0] = planes[0][i];
+            out[3 * i + 1] = planes[1][i];
+            out[3 * i + 2] = planes[2][i];
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const int16x8_t y_offset = vdupq_n_s16(k->y_offset);
+    const int16x8_t c_offset = vdupq_n_s16(128);
+    const int16x4_t y_gain = vdup_n_s16(k->y_gain);
+    const int16x4_t rv = vdup_n_s16(k->rv);
+    const int16x4_t gu = vdup_n_s16(k->gu);
+    const int16x4_t gv = vdup_n_s16(k->gv);
+    const int16x4_t bu = vdup_n_s16(k->bu);
+
+    for (; x + 8 <= width; x += 8) {
+        uint32_t u4, v4;
+        memcpy(&u4, u + x / 2, 4);
+        memcpy(&v4, v + x / 2, 4);
+        uint8x8_t uu = vreinterpret_u8_u32(vdup_n_u32(u4));
+        uint8x8_t vv = vreinterpret_u8_u32(vdup_n_u32(v4));
+
+        int16x8_t c = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + x))), y_offset);
+        int16x8_t dd = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vzip1_u8(uu, uu))), c_offset);
+        int16x8_t ee = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vzip1_u8(vv, vv))), c_offset);
+
+        int32x4_t y_lo = vmull_s16(vget_low_s16(c), y_gain);
+        int32x4_t y_hi = vmull_s16(vget_high_s16(c), y_gain);
+
+        // 舍入右移并饱和收窄，与 SSE2 的 (x + round) >> 13 后饱和打包一致
+        int16x8_t r = vcombine_s16(vqrshrn_n_s32(vmlal_s16(y_lo, vget_low_s16(ee), rv), COLOR_SHIFT),
+                                   vqrshrn_n_s32(vmlal_s16(y_hi, vget_high_s16(ee), rv), COLOR_SHIFT));
+        int16x8_t g = vcombine_s16(
+            vqrshrn_n_s32(vmlsl_s16(vmlsl_s16(y_lo, vget_low_s16(dd), gu), vget_low_s16(ee), gv), COLOR_SHIFT),
+            vqrshrn_n_s32(vmlsl_s16(vmlsl_s16(y_hi, vget_high_s16(dd), gu), vget_high_s16(ee), gv), COLOR_SHIFT));
+        int16x8_t b = vcombine_s16(vqrshrn_n_s32(vmlal_s16(y_lo, vget_low_s16(dd), bu), COLOR_SHIFT),
+                                   vqrshrn_n_s32(vmlal_s16(y_hi, vget_high_s16(dd), bu), COLOR_SHIFT));
+
+        uint8x8x3_t pixels;
+        pixels.val[ri] = vqmovun_s16(r);
+        pixels.val[1] = vqmovun_s16(g);
+        pixels.val[bi] = vqmovun_s16(b);
+        vst3_u8(dst + (size_t)x * 3, pixels);
+    }
+#endif
+
+    for (; x < width; x++) {
+        int32_t c = (int32_t)y[x] - k->y_offset;
+        int32_t dd = (int32_t)u[x / 2] - 128;
+        int32_t ee = (int32_t)v[x / 2] - 128;
+        uint8_t* out = dst + (size_t)x * 3;
+        out[ri] = color_clamp((c * k->y_gain + ee * k->rv + COLOR_ROUND) >> COLOR_SHIFT);
+        out[1] = color_clamp((c * k->y_gain - dd * k->gu - ee * k->gv + COLOR_ROUND) >> COLOR_SHIFT);
+        out[bi] = color_clamp((c * k->y_gain + dd * k->bu + COLOR_ROUND) >> COLOR_SHIFT);
+    }
+}
+
+void preprocess_color_convert_row(const preprocess_color_t* color, const uint8_t* src, uint32_t n,
+                                  uint32_t y, uint8_t* dst, uint8_t* scratch) {
+    const uint8_t* frame = src + n * color->frame_bytes;
+    const uint32_t w = color->width;
+    const uint32_t half = w / 2;
+    const uint8_t* luma = NULL;
+    const uint8_t* u = NULL;
+    const uint8_t* v = NULL;
+
+    switch (color->src_format) {
+        case COLOR_FORMAT_NV12:
+        case COLOR_FORMAT_NV21: {
+            const uint8_t* uv = frame + (size_t)color->height * w + (size_t)(y / 2) * w;
+            uint32_t u_index = color->src_format == COLOR_FORMAT_NV21 ? 1 : 0;
+            uint8_t* us = scratch;
+            uint8_t* vs = scratch + half;
+            for (uint32_t i = 0; i < half; i++) {
+                us[i] = uv[2 * i + u_index];
+                vs[i] = uv[2 * i + (u_index ^ 1)];
+            }
+            luma = frame + (size_t)y * w;
+            u = us;
+            v = vs;
+            break;
+        }
+
+        case COLOR_FORMAT_I420: {
+            size_t plane = (size_t)color->height * w;
+            luma = frame + (size_t)y * w;
+            u = frame + plane + (size_t)(y / 2) * half;
+            v = frame + plane + plane / 4 + (size_t)(y / 2) * half;
+            break;
+        }
+
+        case COLOR_FORMAT_YUYV: {
+            const uint8_t* p = frame + (size_t)y * w * 2;
+            uint8_t* ys = scratch;
+            uint8_t* us = scratch + w;
+            uint8_t* vs = scratch + w + half;
+            for (uint32_t i = 0; i < half; i++) {
+                ys[2 * i] = p[4 * i];
+                us[i] = p[4 * i + 1];
+                ys[2 * i + 1] = p[4 * i + 2];
+                vs[i] = p[4 * i + 3];
+            }
+            luma = ys;
+            u = us;
+            v = vs;
+            break;
+        }
+
+        default: {
+            // RGB/BGR：相同顺序直接复制，否则交换 R、B
+            const uint8_t* row = frame + (size_t)y * w * 3;
+            bool swap = (color->src_format == COLOR_FORMAT_BGR) != color->bgr;
+            if (!swap) {
+                memcpy(dst, row, (size_t)w * 3);
+                return;
+            }
+            for (uint32_t x = 0; x < w; x++) {
+                dst[3 * x + 0] = row[3 * x + 2];
+                dst[3 * x + 1] = row[3 * x + 1];
+                dst[3 * x + 2] = row[3 * x + 0];
+            }
+            return;
+        }
+    }
+
+    yuv_row_to_rgb(color, luma, u, v, dst, w);
+}
+
+/**
+ * @brief 颜色空间转换行区间上下文
+ */
+typedef struct {
+    preprocess_color_t color;
+    const uint8_t* src;
+    uint8_t* dst;
+    uint8_t* scratch;               /**< 每个工作槽一行临时缓冲区 */
+    size_t scratch_stride;          /**< 相邻工作槽的间距 */
+} color_job_t;
+
+static void color_rows_range(void* context, uint32_t slot, size_t begin, size_t end) {
+    const color_job_t* job = (const color_job_t*)context;
+    const uint32_t w = job->color.width;
+    const uint32_t h = job->color.height;
+    uint8_t* scratch = job->scratch + slot * job->scratch_stride;
+
+    for (size_t r = begin; r < end; r++) {
+        preprocess_color_convert_row(&job->color, job->src, (uint32_t)(r / h), (uint32_t)(r % h),
+                                     job->dst + r * w * 3, scratch);
+    }
+}
+
+int preprocess_color_execute(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                             preprocess_workspace_t* workspace) {
+    if (input->dtype != TENSOR_TYPE_UINT8 || !input->data) {
+        LOG_ERROR("Color conversion requires a UINT8 input tensor");
+        return -1;
+    }
+
+    color_job_t job;
+    memset(&job, 0, sizeof(job));
+    preprocess_image_dims_t dims;
+    if (preprocess_color_setup(&op->params, &input->shape, &job.color, &dims) != 0) {
+        LOG_ERROR("Input shape does not match the color conversion source format");
+        return -1;
+    }
+    job.src = (const uint8_t*)input->data;
+    job.dst = (uint8_t*)output->data;
+
+    job.scratch_stride = preprocess_workspace_stride((size_t)dims.w * 2);
+    job.scratch = preprocess_workspace_reserve(workspace,
+                                               job.scratch_stride * preprocess_parallel_slots(num_threads));
+    if (!job.scratch) return -1;
+
+    size_t rows = (size_t)dims.n * dims.h;
+    size_t bytes_per_row = job.color.frame_bytes / dims.h + (size_t)dims.w * 3;
+    preprocess_parallel_for_slots(num_threads, rows, bytes_per_row, color_rows_range, &job);
+
+    preprocess_workspace_release(workspace, job.scratch);
+    return 0;
+}
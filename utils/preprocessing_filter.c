@@ -0,0 +1,604 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief 邻域滤波（模糊、锐化、边缘检测、形态学）
+ *
+ * 图像按平面处理：NHWC 每帧一个平面、行内交错 C 个通道，NCHW 每个通道一个平面，
+ * 因此一行总是连续的 W*C 个元素。源行先按复制边界扩展为浮点行再做水平滤波，
+ * 水平结果进入环形缓冲区，垂直方向在整行上向量化完成。
+ *
+ * - 高斯模糊、锐化、Sobel：行、列两次一维卷积，每个抽头是一次向量化的 y += a*x
+ * - 均值滤波：水平、垂直都维护滑动窗口和，每像素代价与核大小无关
+ * - 形态学：van Herk/Gil-Werman 算法，按核长分块求前缀、后缀极值，每像素约3次比较
+ *
+ * 并行单位是平面内连续的若干行（行块），每个行块额外读取上下各 r 行的邻域。
+ */
+
+// 核大小上限（UINT8 均值滤波的窗口和在 float 中保持精确）
+#define FILTER_MAX_KERNEL 255
+
+// 行块最少行数；邻域较大时放大到 4r，使重叠读取不超过一半
+#define FILTER_BLOCK_ROWS 32
+
+// 高斯核大小：未指定时覆盖 ±3 sigma
+static uint32_t gaussian_size(uint32_t kernel_size, float sigma) {
+    if (kernel_size > 0) return kernel_size;
+    return 2 * (uint32_t)ceilf(3.0f * sigma) + 1;
+}
+
+static bool gaussian_valid(uint32_t kernel_size, float sigma) {
+    if (!(sigma >= 0.0f) || sigma > FILTER_MAX_KERNEL) return false;
+    if (kernel_size == 0 && sigma == 0.0f) return false;
+    uint32_t size = gaussian_size(kernel_size, sigma);
+    return size % 2 == 1 && size <= FILTER_MAX_KERNEL;
+}
+
+bool preprocess_filter_params_valid(preprocess_type_e type, const preprocess_params_t* params) {
+    switch (type) {
+        case PREPROCESS_BLUR:
+            if (params->params.blur.box) {
+                uint32_t size = params->params.blur.kernel_size;
+                return size % 2 == 1 && size <= FILTER_MAX_KERNEL;
+            }
+            return gaussian_valid(params->params.blur.kernel_size, params->params.blur.sigma);
+
+        case PREPROCESS_SHARPEN:
+            return gaussian_valid(params->params.sharpen.kernel_size, params->params.sharpen.sigma) &&
+                   params->params.sharpen.amount >= 0.0f;
+
+        case PREPROCESS_EDGE_DETECT:
+            return true;
+
+        case PREPROCESS_MORPHOLOGY: {
+            uint32_t w = params->params.morphology.kernel_width;
+            uint32_t h = params->params.morphology.kernel_height;
+            return params->params.morphology.op <= MORPHOLOGY_CLOSE &&
+                   w % 2 == 1 && h % 2 == 1 && w <= FILTER_MAX_KERNEL && h <= FILTER_MAX_KERNEL;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// 归一化高斯抽头；sigma 为0时按核大小推导（与 OpenCV 相同）
+static void gaussian_taps(uint32_t size, float sigma, float* taps) {
+    double s = sigma > 0.0f ? sigma : 0.3 * ((size - 1) * 0.5 - 1.0) + 0.8;
+    int r = (int)size / 2;
+    double sum = 0.0;
+    for (int i = 0; i < (int)size; i++) {
+        double x = i - r;
+        sum += exp(-x * x / (2.0 * s * s));
+    }
+    for (int i = 0; i < (int)size; i++) {
+        double x = i - r;
+        taps[i] = (float)(exp(-x * x / (2.0 * s * s)) / sum);
+    }
+}
+
+// dst = a * src（dst 可与 src 相同）
+static void row_scale(float* dst, const float* src, float a, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128 va = _mm_set1_ps(a);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), va));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), a));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = a * src[i];
+    }
+}
+
+// dst += a * src
+static void row_axpy(float* dst, const float* src, float a, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128 va = _mm_set1_ps(a);
+    for (; i + 4 <= n; i += 4) {
+        __m128 d = _mm_loadu_ps(dst + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(src + i), va)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), a));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] += a * src[i];
+    }
+}
+
+// dst = sqrt(x² + y²)（dst 可与 x 相同）
+static void row_magnitude(float* dst, const float* x, const float* y, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_loadu_ps(x + i);
+        __m128 b = _mm_loadu_ps(y + i);
+        _mm_storeu_ps(dst + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b))));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t a = vld1q_f32(x + i);
+        float32x4_t b = vld1q_f32(y + i);
+        vst1q_f32(dst + i, vsqrtq_f32(vmlaq_f32(vmulq_f32(a, a), b, b)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = sqrtf(x[i] * x[i] + y[i] * y[i]);
+    }
+}
+
+static inline float extreme(float a, float b, bool dilate) {
+    return dilate ? (a > b ? a : b) : (a < b ? a : b);
+}
+
+// dst = max(a, b) 或 min(a, b)（dst 可与 a、b 相同）
+static void row_extreme(float* dst, const float* a, const float* b, size_t n, bool dilate) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (dilate) {
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_max_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+    } else {
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_min_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    if (dilate) {
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(dst + i, vmaxq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+        }
+    } else {
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(dst + i, vminq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = extreme(a[i], b[i], dilate);
+    }
+}
+
+// 读取 n 个元素并转换为 float
+static void load_row(const void* src, TensorDataType dtype, size_t offset, float* dst, size_t n) {
+    if (dtype == TENSOR_TYPE_FLOAT32) {
+        memcpy(dst, (const float*)src + offset, n * sizeof(float));
+        return;
+    }
+
+    const uint8_t* s = (const uint8_t*)src + offset;
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_ps(dst + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_ps(dst + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vmovl_u8(vld1_u8(s + i));
+        vst1q_f32(dst + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))));
+        vst1q_f32(dst + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = (float)s[i];
+    }
+}
+
+// 写回 n 个元素；UINT8 就近取偶并饱和
+static void store_row(void* dst, TensorDataType dtype, size_t offset, const float* src, size_t n) {
+    if (dtype == TENSOR_TYPE_FLOAT32) {
+        memcpy((float*)dst + offset, src, n * sizeof(float));
+        return;
+    }
+
+    uint8_t* d = (uint8_t*)dst + offset;
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128 lo = _mm_setzero_ps();
+    __m128 hi = _mm_set1_ps(255.0f);
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lo), hi));
+        __m128i b = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), lo), hi));
+        __m128i c = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 8), lo), hi));
+        __m128i e = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 12), lo), hi));
+        _mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, e)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= n; i += 8) {
+        int32x4_t a = vcvtnq_s32_f32(vld1q_f32(src + i));
+        int32x4_t b = vcvtnq_s32_f32(vld1q_f32(src + i + 4));
+        vst1_u8(d + i, vqmovun_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b))));
+    }
+#endif
+    for (; i < n; i++) {
+        float v = src[i];
+        v = v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v);
+        d[i] = (uint8_t)lrintf(v);
+    }
+}
+
+/**
+ * @brief 滤波任务上下文
+ */
+typedef struct {
+    preprocess_type_e type;
+    TensorDataType dtype;
+    const void* src;
+    void* dst;
+    uint32_t height;                /**< 平面行数 */
+    uint32_t width;                 /**< 每行像素数 */
+    uint32_t channels;              /**< 每像素交错通道数（NCHW 为1） */
+    size_t row_len;                 /**< 每行元素数 */
+    uint32_t block_rows;            /**< 行块行数 */
+    uint32_t blocks;                /**< 每个平面的行块数 */
+    uint32_t radius;                /**< 卷积半径（形态学为垂直半径） */
+    uint32_t radius_x;              /**< 形态学水平半径 */
+    bool box;                       /**< 均值滤波 */
+    bool dilate;                    /**< 形态学取最大值 */
+    float amount;                   /**< 锐化强度 */
+    float taps[FILTER_MAX_KERNEL];  /**< 高斯抽头 */
+    float* buffers;                 /**< 每个工作槽一组行缓冲区 */
+    size_t buffer_stride;           /**< 相邻工作槽的间距（float 个数） */
+} filter_job_t;
+
+// 将源行读入 pad 中部，两侧按复制边界各扩展 r 个像素
+static void load_padded(const filter_job_t* job, size_t offset, uint32_t r, float* pad) {
+    const size_t c = job->channels;
+    float* row = pad + (size_t)r * c;
+    load_row(job->src, job->dtype, offset, row, job->row_len);
+    for (uint32_t i = 0; i < r; i++) {
+        memcpy(pad + (size_t)i * c, row, c * sizeof(float));
+        memcpy(row + job->row_len + (size_t)i * c, row + job->row_len - c, c * sizeof(float));
+    }
+}
+
+// 水平卷积：dst[j] = Σ taps[i] × pad[j + i*stride]
+static void conv_row(const float* pad, const float* taps, uint32_t size, size_t stride, size_t n, float* dst) {
+    row_scale(dst, pad, taps[0], n);
+    for (uint32_t i = 1; i < size; i++) {
+        if (taps[i] != 0.0f) row_axpy(dst, pad + i * stride, taps[i], n);
+    }
+}
+
+// 水平滑动窗口和：每像素一次加一次减
+static void box_row(const float* pad, uint32_t size, uint32_t channels, uint32_t width, float* dst) {
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < size; i++) {
+            sum += pad[(size_t)i * channels + ch];
+        }
+        dst[ch] = (float)sum;
+        for (uint32_t x = 1; x < width; x++) {
+            sum += pad[(size_t)(x + size - 1) * channels + ch] - pad[(size_t)(x - 1) * channels + ch];
+            dst[(size_t)x * channels + ch] = (float)sum;
+        }
+    }
+}
+
+/**
+ * @brief 行区间回调：把行块区间拆成各平面内的连续行 [y0, y1)
+ */
+typedef void (*filter_band_func_t)(filter_job_t* job, float* buffers, size_t base, uint32_t y0, uint32_t y1);
+
+static void for_each_band(filter_job_t* job, float* buffers, size_t begin, size_t end, filter_band_func_t func) {
+    size_t block = begin;
+    while (block < end) {
+        size_t plane = block / job->blocks;
+        size_t last = (plane + 1) * job->blocks;
+        if (last > end) last = end;
+
+        uint32_t y0 = (uint32_t)(block % job->blocks) * job->block_rows;
+        uint32_t y1 = (uint32_t)(last - plane * job->blocks) * job->block_rows;
+        if (y1 > job->height) y1 = job->height;
+        func(job, buffers, plane * job->height * job->row_len, y0, y1);
+        block = last;
+    }
+}
+
+// 卷积类滤波的缓冲区：扩展行、两个 (2r+2) 行环形缓冲区、三个整行
+static size_t conv_buffer_floats(const filter_job_t* job) {
+    size_t slots = 2 * (size_t)job->radius + 2;
+    size_t pad = ((size_t)job->width + 2 * job->radius) * job->channels;
+    return pad + 2 * slots * job->row_len + 3 * job->row_len;
+}
+
+static void conv_band(filter_job_t* job, float* buffers, size_t base, uint32_t y0, uint32_t y1) {
+    static const float smooth[3] = {1.0f, 2.0f, 1.0f};
+    static const float diff[3] = {-1.0f, 0.0f, 1.0f};
+
+    const uint32_t r = job->radius;
+    const uint32_t size = 2 * r + 1;
+    const int64_t slots = 2 * (int64_t)r + 2;
+    const size_t len = job->row_len;
+    const int64_t h = job->height;
+    const bool sobel = job->type == PREPROCESS_EDGE_DETECT;
+
+    float* pad = buffers;
+    float* ring_a = pad + ((size_t)job->width + 2 * r) * job->channels;
+    float* ring_b = ring_a + (size_t)slots * len;
+    float* acc = ring_b + (size_t)slots * len;
+    float* out = acc + len;
+    float* orig = out + len;
+
+    // 虚拟行 t 可以越界（按复制边界取 clamp(t)），在环形缓冲区中的位置为 (t + r) % slots
+#define RING(ring, t) ((ring) + (size_t)(((t) + r) % slots) * len)
+
+    int64_t next = (int64_t)y0 - r;
+    for (uint32_t y = y0; y < y1; y++) {
+        for (; next <= (int64_t)y + r; next++) {
+            int64_t s = next < 0 ? 0 : (next >= h ? h - 1 : next);
+            load_padded(job, base + (size_t)s * len, r, pad);
+            if (job->box) {
+                box_row(pad, size, job->channels, job->width, RING(ring_a, next));
+            } else if (sobel) {
+                conv_row(pad, smooth, 3, job->channels, len, RING(ring_a, next));
+                conv_row(pad, diff, 3, job->channels, len, RING(ring_b, next));
+            } else {
+                conv_row(pad, job->taps, size, job->channels, len, RING(ring_a, next));
+            }
+        }
+
+        int64_t t = y;
+        if (job->box) {
+            // 垂直滑动窗口和：块内第一行完整求和，之后每行一次加一次减
+            if (y == y0) {
+                row_scale(acc, RING(ring_a, t - r), 1.0f, len);
+                for (int64_t i = t - r + 1; i <= t + r; i++) {
+                    row_axpy(acc, RING(ring_a, i), 1.0f, len);
+                }
+            } else {
+                row_axpy(acc, RING(ring_a, t + r), 1.0f, len);
+                row_axpy(acc, RING(ring_a, t - r - 1), -1.0f, len);
+            }
+            row_scale(out, acc, 1.0f / ((float)size * size), len);
+        } else if (sobel) {
+            // Gx：水平差分再垂直 [1 2 1] 平滑；Gy：水平平滑再垂直差分
+            row_scale(out, RING(ring_b, t - 1), 1.0f, len);
+            row_axpy(out, RING(ring_b, t), 2.0f, len);
+            row_axpy(out, RING(ring_b, t + 1), 1.0f, len);
+            row_scale(acc, RING(ring_a, t + 1), 1.0f, len);
+            row_axpy(acc, RING(ring_a, t - 1), -1.0f, len);
+            row_magnitude(out, out, acc, len);
+        } else {
+            row_scale(out, RING(ring_a, t - r), job->taps[0], len);
+            for (uint32_t i = 1; i < size; i++) {
+                row_axpy(out, RING(ring_a, t - r + i), job->taps[i], len);
+            }
+            if (job->type == PREPROCESS_SHARPEN) {
+                // 反锐化掩模：输入 + amount × (输入 - 模糊)
+                load_row(job->src, job->dtype, base + (size_t)y * len, orig, len);
+                row_scale(out, out, -job->amount, len);
+                row_axpy(out, orig, 1.0f + job->amount, len);
+            }
+        }
+
+        store_row(job->dst, job->dtype, base + (size_t)y * len, out, len);
+    }
+
+#undef RING
+}
+
+// 形态学的缓冲区：扩展行及其前缀、后缀极值，行块（含上下邻域）的水平结果及其后缀极值，输出行
+static size_t morph_buffer_floats(const filter_job_t* job) {
+    size_t pad = ((size_t)job->width + 2 * job->radius_x) * job->channels;
+    size_t rows = (size_t)job->block_rows + 2 * job->radius;
+    return 3 * pad + 2 * rows * job->row_len + job->row_len;
+}
+
+// 一行的块内前缀极值 G 与后缀极值 S；块内沿像素递推，OP 为 fmaxf 或 fminf
+#define HGW_ROW(X, G, S, PIXELS, C, K, OP)                                          \
+    do {                                                                            \
+        for (size_t b0 = 0; b0 < (PIXELS); b0 += (K)) {                             \
+            size_t b1 = b0 + (K) < (PIXELS) ? b0 + (K) : (PIXELS);                  \
+            memcpy((G) + b0 * (C), (X) + b0 * (C), (C) * sizeof(float));            \
+            for (size_t j = (b0 + 1) * (C); j < b1 * (C); j++) {                    \
+                (G)[j] = OP((G)[j - (C)], (X)[j]);                                  \
+            }                                                                       \
+            memcpy((S) + (b1 - 1) * (C), (X) + (b1 - 1) * (C), (C) * sizeof(float)); \
+            for (size_t j = (b1 - 1) * (C); j-- > b0 * (C);) {                      \
+                (S)[j] = OP((S)[j + (C)], (X)[j]);                                  \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+// van Herk/Gil-Werman：按核长 k 分块，g 为块内前缀极值，h 为块内后缀极值，
+// 窗口 [x, x+k-1] 至多跨两个块，结果为 h[x] 与 g[x+k-1] 的极值
+static void morph_band(filter_job_t* job, float* buffers, size_t base, uint32_t y0, uint32_t y1) {
+    const uint32_t rx = job->radius_x;
+    const uint32_t ry = job->radius;
+    const uint32_t kx = 2 * rx + 1;
+    const uint32_t ky = 2 * ry + 1;
+    const size_t c = job->channels;
+    const size_t len = job->row_len;
+    const size_t pad_len = ((size_t)job->width + 2 * rx) * c;
+    const size_t pixels = (size_t)job->width + 2 * rx;
+    const bool dilate = job->dilate;
+    const int64_t h = job->height;
+
+    float* pad = buffers;
+    float* g = pad + pad_len;
+    float* s = g + pad_len;
+    float* rows = s + pad_len;
+    float* suffix = rows + ((size_t)job->block_rows + 2 * ry) * len;
+    float* out = suffix + ((size_t)job->block_rows + 2 * ry) * len;
+
+    for (uint32_t c0 = y0; c0 < y1; c0 += job->block_rows) {
+        uint32_t c1 = c0 + job->block_rows < y1 ? c0 + job->block_rows : y1;
+        size_t m = (size_t)(c1 - c0) + 2 * ry;
+
+        // 水平方向：逐行求前缀、后缀极值后合并
+        for (size_t i = 0; i < m; i++) {
+            int64_t t = (int64_t)c0 - ry + (int64_t)i;
+            int64_t src_row = t < 0 ? 0 : (t >= h ? h - 1 : t);
+            load_padded(job, base + (size_t)src_row * len, rx, pad);
+
+            if (dilate) {
+                HGW_ROW(pad, g, s, pixels, c, kx, fmaxf);
+            } else {
+                HGW_ROW(pad, g, s, pixels, c, kx, fminf);
+            }
+            row_extreme(rows + i * len, s, g + (size_t)(kx - 1) * c, len, dilate);
+        }
+
+        // 垂直方向：以整行为单位求后缀极值，前缀极值原地写回
+        for (size_t i = m; i-- > 0;) {
+            float* si = suffix + i * len;
+            if (i == m - 1 || (i + 1) % ky == 0) {
+                memcpy(si, rows + i * len, len * sizeof(float));
+            } else {
+                row_extreme(si, si + len, rows + i * len, len, dilate);
+            }
+        }
+        for (size_t i = 1; i < m; i++) {
+            if (i % ky != 0) {
+                row_extreme(rows + i * len, rows + (i - 1) * len, rows + i * len, len, dilate);
+            }
+        }
+
+        for (uint32_t y = c0; y < c1; y++) {
+            size_t i = y - c0;
+            row_extreme(out, suffix + i * len, rows + (i + ky - 1) * len, len, dilate);
+            store_row(job->dst, job->dtype, base + (size_t)y * len, out, len);
+        }
+    }
+}
+
+static void filter_range(void* context, uint32_t slot, size_t begin, size_t end) {
+    filter_job_t* job = (filter_job_t*)context;
+    bool morph = job->type == PREPROCESS_MORPHOLOGY;
+
+    float* buffers = job->buffers + slot * job->buffer_stride;
+    for_each_band(job, buffers, begin, end, morph ? morph_band : conv_band);
+}
+
+// 执行一遍滤波：src -> dst
+static void filter_pass(filter_job_t* job, const void* src, void* dst, size_t planes, uint32_t num_threads) {
+    job->src = src;
+    job->dst = dst;
+
+    size_t elem = job->dtype == TENSOR_TYPE_FLOAT32 ? sizeof(float) : 1;
+    size_t bytes_per_block = (size_t)job->block_rows * job->row_len * elem * 2;
+    preprocess_parallel_for_slots(num_threads, planes * job->blocks, bytes_per_block, filter_range, job);
+}
+
+int preprocess_filter_execute(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                              preprocess_workspace_t* workspace) {
+    if ((input->dtype != TENSOR_TYPE_UINT8 && input->dtype != TENSOR_TYPE_FLOAT32) || !input->data) {
+        LOG_ERROR("Filter ops require UINT8 or FLOAT32 image tensors");
+        return -1;
+    }
+
+    preprocess_image_dims_t dims;
+    if (preprocess_image_dims_from_shape(&input->shape, input->format, &dims) != 0) {
+        LOG_ERROR("Filter ops require an image tensor");
+        return -1;
+    }
+    if (dims.n == 0 || dims.h == 0 || dims.w == 0 || dims.c == 0) return 0;
+
+    filter_job_t job_storage;
+    memset(&job_storage, 0, sizeof(job_storage));
+    filter_job_t* job = &job_storage;
+
+    const preprocess_params_t* params = &op->params;
+    job->type = params->type;
+    job->dtype = input->dtype;
+    job->height = dims.h;
+    job->width = dims.w;
+    job->channels = dims.nchw ? 1 : dims.c;
+    job->row_len = (size_t)job->width * job->channels;
+    size_t planes = dims.nchw ? (size_t)dims.n * dims.c : dims.n;
+
+    morphology_op_e morph = MORPHOLOGY_ERODE;
+    switch (params->type) {
+        case PREPROCESS_BLUR:
+            if (params->params.blur.box) {
+                job->box = true;
+                job->radius = params->params.blur.kernel_size / 2;
+            } else {
+                uint32_t size = gaussian_size(params->params.blur.kernel_size, params->params.blur.sigma);
+                job->radius = size / 2;
+                gaussian_taps(size, params->params.blur.sigma, job->taps);
+            }
+            break;
+
+        case PREPROCESS_SHARPEN: {
+            uint32_t size = gaussian_size(params->params.sharpen.kernel_size, params->params.sharpen.sigma);
+            job->radius = size / 2;
+            job->amount = params->params.sharpen.amount;
+            gaussian_taps(size, params->params.sharpen.sigma, job->taps);
+            break;
+        }
+
+        case PREPROCESS_EDGE_DETECT:
+            job->radius = 1;
+            break;
+
+        default:
+            morph = params->params.morphology.op;
+            job->radius_x = params->params.morphology.kernel_width / 2;
+            job->radius = params->params.morphology.kernel_height / 2;
+            break;
+    }
+
+    job->block_rows = FILTER_BLOCK_ROWS;
+    uint32_t reach = job->radius > job->radius_x ? job->radius : job->radius_x;
+    if (job->block_rows < 4 * reach) job->block_rows = 4 * reach;
+    job->blocks = (job->height + job->block_rows - 1) / job->block_rows;
+
+    // 工作区依次存放各工作槽的行缓冲区和开、闭运算两遍之间的中间结果
+    bool two_pass = params->type == PREPROCESS_MORPHOLOGY && morph != MORPHOLOGY_ERODE &&
+                    morph != MORPHOLOGY_DILATE;
+    size_t floats = params->type == PREPROCESS_MORPHOLOGY ? morph_buffer_floats(job) : conv_buffer_floats(job);
+    size_t buffer_bytes = preprocess_workspace_stride(sizeof(float) * floats);
+    size_t slot_bytes = buffer_bytes * preprocess_parallel_slots(num_threads);
+    size_t temp_bytes = two_pass ? preprocess_shape_bytes(&input->shape, input->dtype) : 0;
+    uint8_t* buffer = preprocess_workspace_reserve(workspace, slot_bytes + temp_bytes);
+    if (!buffer) {
+        LOG_ERROR("Failed to allocate filter buffers");
+        return -1;
+    }
+    job->buffers = (float*)buffer;
+    job->buffer_stride = buffer_bytes / sizeof(float);
+
+    if (params->type != PREPROCESS_MORPHOLOGY) {
+        filter_pass(job, input->data, output->data, planes, num_threads);
+    } else if (!two_pass) {
+        job->dilate = morph == MORPHOLOGY_DILATE;
+        filter_pass(job, input->data, output->data, planes, num_threads);
+    } else {
+        // 开、闭运算：两遍之间的中间结果与输入同类型（极值运算在 UINT8 上无损）
+        void* temp = buffer + slot_bytes;
+        job->dilate = morph == MORPHOLOGY_CLOSE;
+        filter_pass(job, input->data, temp, planes, num_threads);
+        job->dilate = !job->dilate;
+        filter_pass(job, temp, output->data, planes, num_threads);
+    }
+
+    preprocess_workspace_release(workspace, buffer);
+    return 0;
+}
@@ -0,0 +1,482 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * @brief 预处理融合内核
+ *
+ * 把 颜色空间转换 -> 裁剪 -> 缩放 -> 翻转 -> 归一化/类型转换/量化 -> NHWC/NCHW 转置
+ * 这类常见序列编译为一次遍历：每个输出行只从源图像采样一次，在缓存内的行缓冲上完成
+ * 逐通道仿射，然后直接按目标布局和类型写出最终张量。源为 YUV 帧时只转换被采样到的源行。
+ */
+
+bool preprocess_fusion_accepts(const preprocess_fused_kernel_t* kernel, uint32_t op_count,
+                               preprocess_op_t op) {
+    if (!kernel || !op) return false;
+
+    // 转为非浮点类型后不再继续融合
+    if (op_count > 0 && kernel->has_cast && kernel->cast_dtype != TENSOR_TYPE_FLOAT32) {
+        return false;
+    }
+
+    const preprocess_params_t* params = &op->params;
+
+    // 量化之后只允许不改变数值的翻转和转置
+    if (kernel->has_quant && params->type != PREPROCESS_FLIP && params->type != PREPROCESS_TRANSPOSE) {
+        return false;
+    }
+
+    switch (params->type) {
+        case PREPROCESS_COLOR_CONVERT:
+            // 颜色空间转换只能作为融合组的第一个操作
+            return op_count == 0;
+
+        case PREPROCESS_CROP:
+            // 裁剪只能出现在缩放和翻转之前，连续裁剪需落在上一个窗口内
+            if (kernel->has_resize || kernel->flip_h || kernel->flip_v) return false;
+            if (kernel->crop_w > 0 &&
+                (params->params.crop.x + params->params.crop.width > kernel->crop_w ||
+                 params->params.crop.y + params->params.crop.height > kernel->crop_h)) {
+                return false;
+            }
+            return true;
+
+        case PREPROCESS_RESIZE:
+            if (kernel->has_resize || kernel->flip_h || kernel->flip_v) return false;
+            return params->params.resize.method == INTERPOLATION_NEAREST ||
+                   params->params.resize.method == INTERPOLATION_LINEAR;
+
+        case PREPROCESS_FLIP:
+            return true;
+
+        case PREPROCESS_NORMALIZE:
+            return !kernel->has_affine ||
+                   kernel->affine_channels == params->params.normalize.channels;
+
+        case PREPROCESS_CAST:
+            return params->params.cast.dtype == TENSOR_TYPE_FLOAT32 ||
+                   params->params.cast.dtype == TENSOR_TYPE_UINT8 ||
+                   params->params.cast.dtype == TENSOR_TYPE_INT8 ||
+                   params->params.cast.dtype == TENSOR_TYPE_INT16 ||
+                   params->params.cast.dtype == TENSOR_TYPE_INT32;
+
+        case PREPROCESS_QUANTIZE:
+            return true;
+
+        case PREPROCESS_TRANSPOSE: {
+            if (kernel->transpose_count >= 8) return false;
+            if (kernel->transpose_rank != 0 &&
+                kernel->transpose_rank != params->params.transpose.ndim) {
+                return false;
+            }
+            const uint32_t* p = params->params.transpose.perm;
+            if (params->params.transpose.ndim == 4) {
+                return (p[0] == 0 && p[1] == 3 && p[2] == 1 && p[3] == 2) ||
+                       (p[0] == 0 && p[1] == 2 && p[2] == 3 && p[3] == 1);
+            }
+            if (params->params.transpose.ndim == 3) {
+                return (p[0] == 2 && p[1] == 0 && p[2] == 1) ||
+                       (p[0] == 1 && p[1] == 2 && p[2] == 0);
+            }
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
+
+void preprocess_fusion_append(preprocess_fused_kernel_t* kernel, preprocess_op_t op) {
+    const preprocess_params_t* params = &op->params;
+
+    switch (params->type) {
+        case PREPROCESS_COLOR_CONVERT:
+            kernel->has_color = true;
+            kernel->color = *params;
+            break;
+
+        case PREPROCESS_CROP:
+            kernel->crop_x += params->params.crop.x;
+            kernel->crop_y += params->params.crop.y;
+            kernel->crop_w = params->params.crop.width;
+            kernel->crop_h = params->params.crop.height;
+            break;
+
+        case PREPROCESS_RESIZE:
+            kernel->has_resize = true;
+            kernel->resize_w = params->params.resize.width;
+            kernel->resize_h = params->params.resize.height;
+            kernel->method = params->params.resize.method;
+            kernel->resize_before_float = !kernel->has_affine && !kernel->has_cast;
+            break;
+
+        case PREPROCESS_FLIP:
+            kernel->flip_h ^= params->params.flip.horizontal;
+            kernel->flip_v ^= params->params.flip.vertical;
+            break;
+
+        case PREPROCESS_NORMALIZE: {
+            uint32_t channels = params->params.normalize.channels;
+            for (uint32_t c = 0; c < channels; c++) {
+                float std = params->params.normalize.std[c];
+                if (std == 0.0f) std = 1.0f;
+                float s = 1.0f / std;
+                float b = -params->params.normalize.mean[c] / std;
+                if (kernel->has_affine) {
+                    // 复合仿射：s * (s0 * x + b0) + b
+                    kernel->bias[c] = s * kernel->bias[c] + b;
+                    kernel->scale[c] = s * kernel->scale[c];
+                } else {
+                    kernel->scale[c] = s;
+                    kernel->bias[c] = b;
+                }
+            }
+            kernel->has_affine = true;
+            kernel->affine_channels = channels;
+            break;
+        }
+
+        case PREPROCESS_CAST:
+            kernel->has_cast = true;
+            kernel->cast_dtype = params->params.cast.dtype;
+            break;
+
+        case PREPROCESS_QUANTIZE:
+            kernel->has_quant = true;
+            kernel->quant_dtype = params->params.quantize.dtype;
+            kernel->quant_channels = params->params.quantize.channels;
+            for (uint32_t c = 0; c < kernel->quant_channels; c++) {
+                kernel->quant_scale[c] = params->params.quantize.scale[c];
+                kernel->quant_zero_point[c] = (float)params->params.quantize.zero_point[c];
+            }
+            break;
+
+        case PREPROCESS_TRANSPOSE:
+            kernel->transpose_rank = params->params.transpose.ndim;
+            kernel->transpose_to_nchw[kernel->transpose_count++] =
+                params->params.transpose.ndim == 4 ? params->params.transpose.perm[1] == 3
+                                                   : params->params.transpose.perm[0] == 2;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void preprocess_fusion_unbind(preprocess_fused_binding_t* binding) {
+    if (!binding) return;
+
+    free(binding->x0);
+    free(binding->x1);
+    free(binding->wx);
+    free(binding->y0);
+    free(binding->y1);
+    free(binding->wy);
+    memset(binding, 0, sizeof(*binding));
+}
+
+// 计算一个轴上输出坐标到源坐标的映射
+static void build_axis_map(uint32_t out_len, uint32_t src_len, uint32_t offset, bool resize,
+                           bool linear, bool flip, uint32_t* i0, uint32_t* i1, float* w) {
+    float scale = (float)src_len / out_len;
+
+    for (uint32_t i = 0; i < out_len; i++) {
+        uint32_t o = flip ? out_len - 1 - i : i;
+        uint32_t a, b;
+        float t = 0.0f;
+
+        if (!resize) {
+            a = b = o;
+        } else if (linear) {
+            float f = (o + 0.5f) * scale - 0.5f;
+            if (f < 0.0f) f = 0.0f;
+            a = (uint32_t)f;
+            if (a > src_len - 1) a = src_len - 1;
+            b = a + 1 < src_len ? a + 1 : src_len - 1;
+            t = f - a;
+        } else {
+            a = b = (o * src_len) / out_len;
+        }
+
+        i0[i] = a + offset;
+        i1[i] = b + offset;
+        w[i] = t;
+    }
+}
+
+int preprocess_fusion_bind(const preprocess_fused_kernel_t* kernel, const Tensor* input,
+                           preprocess_fused_binding_t* binding) {
+    if (!kernel || !input || !binding) return -1;
+
+    memset(binding, 0, sizeof(*binding));
+
+    if (input->dtype != TENSOR_TYPE_UINT8 && input->dtype != TENSOR_TYPE_FLOAT32) return -1;
+    if (kernel->has_color) {
+        // 颜色空间转换后按交错 RGB/BGR 图像继续
+        if (input->dtype != TENSOR_TYPE_UINT8) return -1;
+        if (preprocess_color_setup(&kernel->color, &input->shape, &binding->color, &binding->in) != 0) return -1;
+        binding->has_color = true;
+    } else if (preprocess_image_dims_from_shape(&input->shape, input->format, &binding->in) != 0) {
+        return -1;
+    }
+
+    const preprocess_image_dims_t* in = &binding->in;
+
+    // 转置序列必须与实际布局一致
+    bool nchw = in->nchw;
+    if (kernel->transpose_count > 0 && kernel->transpose_rank != (in->has_batch ? 4u : 3u)) return -1;
+    for (uint32_t i = 0; i < kernel->transpose_count; i++) {
+        if (kernel->transpose_to_nchw[i] == nchw) return -1;
+        nchw = !nchw;
+    }
+
+    uint32_t cx = kernel->crop_x, cy = kernel->crop_y;
+    uint32_t cw = kernel->crop_w ? kernel->crop_w : in->w;
+    uint32_t ch = kernel->crop_h ? kernel->crop_h : in->h;
+    if (cx + cw > in->w || cy + ch > in->h) return -1;
+
+    if ((kernel->has_affine || kernel->has_quant) && in->c > 4) return -1;
+
+    binding->out = *in;
+    binding->out.nchw = nchw;
+    binding->out.w = kernel->has_resize ? kernel->resize_w : cw;
+    binding->out.h = kernel->has_resize ? kernel->resize_h : ch;
+
+    binding->in_dtype = input->dtype;
+    if (kernel->has_quant) {
+        binding->out_dtype = kernel->quant_dtype;
+    } else if (kernel->has_cast) {
+        binding->out_dtype = kernel->cast_dtype;
+    } else if (kernel->has_affine) {
+        binding->out_dtype = TENSOR_TYPE_FLOAT32;
+    } else {
+        binding->out_dtype = input->dtype;
+    }
+
+    binding->linear = kernel->has_resize && kernel->method == INTERPOLATION_LINEAR;
+    binding->round_interp = binding->linear && kernel->resize_before_float &&
+                            input->dtype == TENSOR_TYPE_UINT8;
+
+    binding->has_affine = kernel->has_affine || kernel->has_quant;
+    binding->quantize = kernel->has_quant;
+    for (uint32_t c = 0; c < in->c && c < 4; c++) {
+        binding->scale[c] = kernel->has_affine ? kernel->scale[c % kernel->affine_channels] : 1.0f;
+        binding->bias[c] = kernel->has_affine ? kernel->bias[c % kernel->affine_channels] : 0.0f;
+        if (kernel->has_quant) {
+            // 复合量化：(s * x + b) / qs + zp
+            float inv = 1.0f / kernel->quant_scale[c % kernel->quant_channels];
+            binding->scale[c] *= inv;
+            binding->bias[c] = binding->bias[c] * inv + kernel->quant_zero_point[c % kernel->quant_channels];
+        }
+    }
+
+    uint32_t ow = binding->out.w, oh = binding->out.h;
+    binding->x0 = malloc(ow * sizeof(uint32_t));
+    binding->x1 = malloc(ow * sizeof(uint32_t));
+    binding->wx = malloc(ow * sizeof(float));
+    binding->y0 = malloc(oh * sizeof(uint32_t));
+    binding->y1 = malloc(oh * sizeof(uint32_t));
+    binding->wy = malloc(oh * sizeof(float));
+    if (!binding->x0 || !binding->x1 || !binding->wx ||
+        !binding->y0 || !binding->y1 || !binding->wy) {
+        LOG_ERROR("Failed to allocate fused kernel coordinate tables");
+        preprocess_fusion_unbind(binding);
+        return -1;
+    }
+
+    build_axis_map(ow, cw, cx, kernel->has_resize, binding->linear, kernel->flip_h,
+                   binding->x0, binding->x1, binding->wx);
+    build_axis_map(oh, ch, cy, kernel->has_resize, binding->linear, kernel->flip_v,
+                   binding->y0, binding->y1, binding->wy);
+
+    // 行缓冲后附一段平面缓冲，供平面布局的量化输出逐通道取出；
+    // 颜色转换另需两条转换后的源行和解交错临时缓冲区
+    binding->work_bytes = (size_t)ow * (in->c + 1) * sizeof(float);
+    if (binding->has_color) {
+        binding->work_bytes += (size_t)in->w * 3 * 2 + (size_t)in->w * 2;
+    }
+
+    TensorShape out_shape = preprocess_image_dims_to_shape(&binding->out);
+    binding->fused_bytes = preprocess_shape_bytes(&input->shape, input->dtype) +
+                           preprocess_shape_bytes(&out_shape, binding->out_dtype);
+
+    return 0;
+}
+
+// 按布局计算的步长
+typedef struct {
+    size_t pixel;
+    size_t channel;
+    size_t row;
+    size_t batch;
+} image_strides_t;
+
+static image_strides_t image_strides(const preprocess_image_dims_t* d) {
+    image_strides_t s;
+    if (d->nchw) {
+        s.pixel = 1;
+        s.channel = (size_t)d->h * d->w;
+        s.row = d->w;
+    } else {
+        s.pixel = d->c;
+        s.channel = 1;
+        s.row = (size_t)d->w * d->c;
+    }
+    s.batch = (size_t)d->h * d->w * d->c;
+    return s;
+}
+
+/**
+ * @brief 颜色空间转换的源行缓存
+ *
+ * 相邻输出行常共用源行，保留最近转换的两行。
+ */
+typedef struct {
+    uint8_t* rows[2];               /**< 转换后的交错三通道源行 */
+    size_t keys[2];                 /**< 对应的 帧 * 高度 + 行（SIZE_MAX 表示空） */
+    uint32_t last;                  /**< 最近使用的槽位 */
+    uint8_t* scratch;               /**< 解交错临时缓冲区 */
+} color_row_cache_t;
+
+static const uint8_t* color_source_row(const preprocess_fused_binding_t* b, const Tensor* input,
+                                       color_row_cache_t* cache, uint32_t n, uint32_t y) {
+    size_t key = (size_t)n * b->in.h + y;
+    for (uint32_t i = 0; i < 2; i++) {
+        if (cache->keys[i] == key) {
+            cache->last = i;
+            return cache->rows[i];
+        }
+    }
+
+    uint32_t slot = cache->last ^ 1;
+    preprocess_color_convert_row(&b->color, (const uint8_t*)input->data, n, y, cache->rows[slot], cache->scratch);
+    cache->keys[slot] = key;
+    cache->last = slot;
+    return cache->rows[slot];
+}
+
+// 采样一行源像素到交错排列的浮点行缓冲 row[x * C + c]，ROW0/ROW1 为上下两条源行
+#define FUSION_GATHER_ROW(T, ROW0, ROW1)                                                \
+    do {                                                                                \
+        const T* r0 = (ROW0);                                                           \
+        const T* r1 = (ROW1);                                                           \
+        float wy = b->wy[y];                                                            \
+        for (uint32_t x = 0; x < ow; x++) {                                             \
+            size_t o0 = b->x0[x] * is.pixel;                                            \
+            size_t o1 = b->x1[x] * is.pixel;                                            \
+            float wx = b->wx[x];                                                        \
+            float* dst = row + (size_t)x * channels;                                    \
+            for (uint32_t c = 0; c < channels; c++) {                                   \
+                size_t co = c * is.channel;                                             \
+                float v = (float)r0[o0 + co];                                           \
+                if (b->linear) {                                                        \
+                    float top = v + ((float)r0[o1 + co] - v) * wx;                      \
+                    float v10 = (float)r1[o0 + co];                                     \
+                    float bottom = v10 + ((float)r1[o1 + co] - v10) * wx;               \
+                    v = top + (bottom - top) * wy;                                      \
+                    if (b->round_interp) {                                              \
+                        v = floorf(v + 0.5f);                                           \
+                        v = v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v);                \
+                    }                                                                   \
+                }                                                                       \
+                dst[c] = v;                                                             \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+int preprocess_fusion_run_rows(const preprocess_fused_binding_t* b, const Tensor* input,
+                               Tensor* output, uint32_t row_begin, uint32_t row_end, void* work) {
+    if (!b || !input || !output || !output->data || !work) return -1;
+
+    const uint32_t channels = b->in.c;
+    const uint32_t ow = b->out.w;
+    const uint32_t oh = b->out.h;
+    const image_strides_t is = image_strides(&b->in);
+    const image_strides_t os = image_strides(&b->out);
+
+    // 工作区布局与 preprocess_fusion_bind 计算的 work_bytes 一致
+    float* row = (float*)work;
+    color_row_cache_t cache = {{NULL, NULL}, {SIZE_MAX, SIZE_MAX}, 0, NULL};
+    if (b->has_color) {
+        size_t row_bytes = (size_t)b->in.w * 3;
+        uint8_t* color_buffer = (uint8_t*)(row + (size_t)ow * (channels + 1));
+        cache.rows[0] = color_buffer;
+        cache.rows[1] = color_buffer + row_bytes;
+        cache.scratch = color_buffer + row_bytes * 2;
+    }
+
+    for (uint32_t r = row_begin; r < row_end; r++) {
+        uint32_t n = r / oh;
+        uint32_t y = r % oh;
+
+        if (b->has_color) {
+            const uint8_t* src0 = color_source_row(b, input, &cache, n, b->y0[y]);
+            const uint8_t* src1 = color_source_row(b, input, &cache, n, b->y1[y]);
+            FUSION_GATHER_ROW(uint8_t, src0, src1);
+        } else if (b->in_dtype == TENSOR_TYPE_UINT8) {
+            FUSION_GATHER_ROW(uint8_t, (const uint8_t*)input->data + n * is.batch + b->y0[y] * is.row,
+                              (const uint8_t*)input->data + n * is.batch + b->y1[y] * is.row);
+        } else {
+            FUSION_GATHER_ROW(float, (const float*)input->data + n * is.batch + b->y0[y] * is.row,
+                              (const float*)input->data + n * is.batch + b->y1[y] * is.row);
+        }
+
+        size_t out_base = n * os.batch + y * os.row;
+
+        if (b->quantize) {
+            uint8_t* dst = (uint8_t*)output->data + out_base;
+            if (b->out.nchw) {
+                float* plane = row + (size_t)ow * channels;
+                for (uint32_t c = 0; c < channels; c++) {
+                    for (uint32_t x = 0; x < ow; x++) {
+                        plane[x] = row[(size_t)x * channels + c];
+                    }
+                    preprocess_quantize_affine(plane, dst + c * os.channel, b->out_dtype, ow,
+                                               &b->scale[c], &b->bias[c], 1);
+                }
+            } else {
+                preprocess_quantize_affine(row, dst, b->out_dtype, (size_t)ow * channels,
+                                           b->scale, b->bias, channels);
+            }
+        } else if (b->out_dtype == TENSOR_TYPE_FLOAT32) {
+            float* dst = (float*)output->data + out_base;
+            if (b->out.nchw) {
+                for (uint32_t c = 0; c < channels; c++) {
+                    float* plane = dst + c * os.channel;
+                    if (b->has_affine) {
+                        float s = b->scale[c], bias = b->bias[c];
+                        for (uint32_t x = 0; x < ow; x++) {
+                            plane[x] = row[(size_t)x * channels + c] * s + bias;
+                        }
+                    } else {
+                        for (uint32_t x = 0; x < ow; x++) {
+                            plane[x] = row[(size_t)x * channels + c];
+                        }
+                    }
+                }
+            } else if (b->has_affine) {
+                for (uint32_t x = 0; x < ow; x++) {
+                    for (uint32_t c = 0; c < channels; c++) {
+                        size_t i = (size_t)x * channels + c;
+                        dst[i] = row[i] * b->scale[c] + b->bias[c];
+                    }
+                }
+            } else {
+                memcpy(dst, row, (size_t)ow * channels * sizeof(float));
+            }
+        } else {
+            for (uint32_t x = 0; x < ow; x++) {
+                for (uint32_t c = 0; c < channels; c++) {
+                    float v = row[(size_t)x * channels + c];
+                    if (b->has_affine) v = v * b->scale[c] + b->bias[c];
+                    preprocess_store_element(output->data, b->out_dtype,
+                                             out_base + x * os.pixel + c * os.channel, v);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,616 @@
+#ifndef MODYN_UTILS_PREPROCESSING_INTERNAL_H
+#define MODYN_UTILS_PREPROCESSING_INTERNAL_H
+
+/**
+ * @brief 预处理模块内部定义
+ *
+ * 仅供 utils/preprocessing*.c 使用，不对外安装。
+ */
+
+#include "utils/preprocessing.h"
+#include "utils/audio_utils.h"
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 预处理操作内部结构
+ */
+struct PreprocessOp {
+    preprocess_params_t params;
+    custom_preprocess_func_t custom_func;
+    void* context;
+    bool enable_cache;
+    uint8_t lut[256];               /**< 缓存的查找表（亮度、对比度、伽马） */
+    bool lut_valid;                 /**< 查找表缓存是否有效 */
+    audio_frontend_t audio;         /**< 音频特征前端（首次使用时按参数创建） */
+    audio_resampler_t resampler;    /**< 重采样器（首次使用时按参数创建） */
+    pthread_mutex_t mutex;
+};
+
+/**
+ * @brief 图像张量维度（与存储布局无关）
+ */
+typedef struct {
+    uint32_t n;                     /**< 批量 */
+    uint32_t h;                     /**< 高度 */
+    uint32_t w;                     /**< 宽度 */
+    uint32_t c;                     /**< 通道 */
+    bool nchw;                      /**< 是否为平面布局 */
+    bool has_batch;                 /**< 是否包含批量维度 */
+} preprocess_image_dims_t;
+
+/**
+ * @brief 颜色空间转换针对具体输入的绑定
+ *
+ * YUV 系数为 Q13 定点：C = Y - y_offset，D = U - 128，E = V - 128，
+ * R = C*y_gain + E*rv，G = C*y_gain - D*gu - E*gv，B = C*y_gain + D*bu。
+ */
+typedef struct {
+    color_format_e src_format;      /**< 源像素格式 */
+    bool bgr;                       /**< 输出 BGR 顺序 */
+    uint32_t width;                 /**< 图像宽度 */
+    uint32_t height;                /**< 图像高度 */
+    size_t frame_bytes;             /**< 每帧源数据字节数 */
+    int16_t y_offset;               /**< 亮度偏移 */
+    int16_t y_gain;                 /**< 亮度增益 */
+    int16_t rv;                     /**< V 对 R 的系数 */
+    int16_t gu;                     /**< U 对 G 的系数 */
+    int16_t gv;                     /**< V 对 G 的系数 */
+    int16_t bu;                     /**< U 对 B 的系数 */
+} preprocess_color_t;
+
+/**
+ * @brief 融合图像内核描述（与输入形状无关）
+ */
+typedef struct {
+    bool has_color;                 /**< 以颜色空间转换开始 */
+    preprocess_params_t color;      /**< 颜色空间转换参数 */
+    uint32_t crop_x;                /**< 源窗口起始X */
+    uint32_t crop_y;                /**< 源窗口起始Y */
+    uint32_t crop_w;                /**< 源窗口宽度（0表示整幅图像） */
+    uint32_t crop_h;                /**< 源窗口高度（0表示整幅图像） */
+    bool has_resize;                /**< 是否包含缩放 */
+    uint32_t resize_w;              /**< 缩放宽度 */
+    uint32_t resize_h;              /**< 缩放高度 */
+    interpolation_method_e method;  /**< 插值方法 */
+    bool flip_h;                    /**< 水平翻转 */
+    bool flip_v;                    /**< 垂直翻转 */
+    bool has_affine;                /**< 是否包含逐通道仿射（归一化） */
+    uint32_t affine_channels;       /**< 仿射参数通道数 */
+    float scale[4];                 /**< 逐通道缩放 */
+    float bias[4];                  /**< 逐通道偏置 */
+    bool has_cast;                  /**< 是否指定输出类型 */
+    TensorDataType cast_dtype;      /**< 输出类型 */
+    bool has_quant;                 /**< 是否以量化结束 */
+    TensorDataType quant_dtype;     /**< 量化类型 */
+    uint32_t quant_channels;        /**< 量化参数通道数 */
+    float quant_scale[4];           /**< 逐通道量化缩放因子 */
+    float quant_zero_point[4];      /**< 逐通道量化零点 */
+    bool resize_before_float;       /**< 缩放发生在转为浮点之前（整型输入需逐步取整） */
+    uint32_t transpose_count;       /**< 转置次数 */
+    uint32_t transpose_rank;        /**< 转置的张量维度数（3或4） */
+    bool transpose_to_nchw[8];      /**< 每次转置是否为 NHWC->NCHW */
+} preprocess_fused_kernel_t;
+
+/**
+ * @brief 融合内核针对具体输入形状的绑定结果
+ */
+typedef struct {
+    preprocess_image_dims_t in;     /**< 输入维度 */
+    preprocess_image_dims_t out;    /**< 输出维度 */
+    TensorDataType in_dtype;        /**< 输入类型 */
+    TensorDataType out_dtype;       /**< 输出类型 */
+    uint32_t* x0;                   /**< 每个输出列的左侧源列 */
+    uint32_t* x1;                   /**< 每个输出列的右侧源列 */
+    float* wx;                      /**< 每个输出列的右侧权重 */
+    uint32_t* y0;                   /**< 每个输出行的上方源行 */
+    uint32_t* y1;                   /**< 每个输出行的下方源行 */
+    float* wy;                      /**< 每个输出行的下方权重 */
+    bool linear;                    /**< 是否双线性采样 */
+    bool round_interp;              /**< 插值结果是否按整型取整 */
+    float scale[4];                 /**< 按图像通道展开的缩放 */
+    float bias[4];                  /**< 按图像通道展开的偏置 */
+    bool has_affine;                /**< 是否应用仿射 */
+    bool quantize;                  /**< 仿射后饱和量化（缩放和偏置已与量化参数复合） */
+    bool has_color;                 /**< 源为 YUV/BGR 帧，按需逐行转换为 RGB 后采样 */
+    preprocess_color_t color;       /**< 颜色空间转换绑定 */
+    size_t work_bytes;              /**< 每个工作线程的行缓冲区字节数 */
+    uint64_t fused_bytes;           /**< 融合执行一次的内存流量 */
+    uint64_t unfused_bytes;         /**< 逐操作执行一次的内存流量 */
+} preprocess_fused_binding_t;
+
+/**
+ * @brief 管道执行段：融合组或单个回退操作
+ */
+typedef struct {
+    uint32_t first_op;              /**< 起始操作索引 */
+    uint32_t op_count;              /**< 操作数量 */
+    bool fused;                     /**< 是否为融合组 */
+    bool lut;                       /**< 是否为组合查找表组 */
+    preprocess_fused_kernel_t kernel; /**< 融合内核 */
+    bool bound;                     /**< 是否已绑定输入形状 */
+    TensorShape bound_shape;        /**< 绑定的输入形状 */
+    TensorDataType bound_dtype;     /**< 绑定的输入类型 */
+    TensorFormat bound_format;      /**< 绑定的输入格式 */
+    bool bind_failed;               /**< 该形状无法融合，回退逐操作执行 */
+    preprocess_fused_binding_t binding; /**< 绑定结果 */
+} preprocess_segment_t;
+
+/**
+ * @brief 内核工作区
+ *
+ * 内核执行时的临时内存（查找表、类型转换、逐线程的行缓冲区等），容量增长后保留，
+ * 输入形状不变时重复执行不再分配内存。
+ */
+typedef struct {
+    void* data;
+    size_t size;
+} preprocess_workspace_t;
+
+/**
+ * @brief 中间结果乒乓缓冲区
+ *
+ * 相邻中间结果交替使用两块缓冲区，容量按推断的输出形状增长后保留，
+ * 输入形状不变时执行过程不再分配内存。
+ */
+typedef struct preprocess_scratch_t {
+    void* data[2];                  /**< 两块缓冲区 */
+    size_t size[2];                 /**< 缓冲区容量 */
+    uint32_t next;                  /**< 下一个中间结果使用的缓冲区 */
+    uint32_t pending;               /**< 最近一次分配出去的缓冲区 */
+    preprocess_workspace_t workspace; /**< 逐操作执行时的内核工作区 */
+    struct preprocess_scratch_t* link; /**< 空闲链表 */
+} preprocess_scratch_t;
+
+/**
+ * @brief 计划步骤类型
+ */
+typedef enum {
+    PREPROCESS_PLAN_OP = 0,         /**< 单个操作 */
+    PREPROCESS_PLAN_LUT,            /**< 组合查找表组 */
+    PREPROCESS_PLAN_FUSED           /**< 融合组 */
+} preprocess_plan_kind_e;
+
+/**
+ * @brief 计划中的一个执行步骤及其输出
+ */
+typedef struct {
+    preprocess_plan_kind_e kind;    /**< 步骤类型 */
+    uint32_t first_op;              /**< 起始操作索引 */
+    uint32_t op_count;              /**< 操作数量 */
+    preprocess_fused_binding_t binding; /**< 融合组绑定（计划独占，不受动态执行重绑定影响） */
+    size_t rows;                    /**< 融合组输出行数 */
+    size_t bytes_per_row;           /**< 融合组每行读写字节数 */
+    TensorShape shape;              /**< 输出形状 */
+    TensorDataType dtype;           /**< 输出类型 */
+    TensorFormat format;            /**< 输出格式 */
+    size_t bytes;                   /**< 输出字节数 */
+    size_t offset;                  /**< 在计划缓冲区中的偏移（未绑定的最终输出为 SIZE_MAX） */
+    uint64_t fused_bytes;           /**< 执行一次的内存流量 */
+    uint64_t unfused_bytes;         /**< 逐操作执行一次的内存流量 */
+} preprocess_plan_step_t;
+
+/**
+ * @brief 管道静态缓冲区计划
+ */
+typedef struct {
+    preprocess_plan_config_t config; /**< 计划配置 */
+    preprocess_plan_step_t* steps;  /**< 执行步骤（不超过操作数） */
+    uint32_t step_count;
+    uint8_t* arena;                 /**< 计划缓冲区 */
+    size_t arena_bytes;             /**< 计划缓冲区字节数 */
+    size_t scratch_bytes;           /**< 其中中间结果占用的字节数 */
+    memory_handle_t handle;         /**< 从内存池分配时的句柄 */
+    preprocess_workspace_t workspace; /**< 按计划执行时的内核工作区 */
+    uint64_t executions;            /**< 按计划执行的次数 */
+} preprocess_plan_t;
+
+/**
+ * @brief 预处理管道内部结构
+ */
+struct PreprocessPipeline {
+    preprocess_op_t* ops;
+    uint32_t op_count;
+    uint32_t capacity;
+    uint32_t num_threads;
+    bool enable_fusion;
+    bool compiled;
+    preprocess_segment_t* segments;
+    uint32_t segment_count;
+    preprocess_fusion_stats_t fusion_stats;
+    preprocess_scratch_t* free_scratch; /**< 空闲的乒乓缓冲区（批量并发时每个样本一组） */
+    pthread_mutex_t scratch_mutex;
+    preprocess_plan_t* plan;        /**< 静态缓冲区计划（NULL表示动态执行） */
+    pthread_mutex_t mutex;
+};
+
+/**
+ * @brief 解析图像张量维度
+ *
+ * 支持 3 维（HWC/CHW）和 4 维（NHWC/NCHW）张量，布局由 tensor->format 决定。
+ *
+ * @return int 0成功，其他失败
+ */
+int preprocess_image_dims_from_shape(const TensorShape* shape, TensorFormat format,
+                                     preprocess_image_dims_t* dims);
+
+/**
+ * @brief 由图像维度构造张量形状
+ */
+TensorShape preprocess_image_dims_to_shape(const preprocess_image_dims_t* dims);
+
+/**
+ * @brief 计算形状对应的字节数
+ */
+size_t preprocess_shape_bytes(const TensorShape* shape, TensorDataType dtype);
+
+/**
+ * @brief 准备输出张量：未分配时按形状分配，已分配时检查容量
+ *
+ * @return int 0成功，其他失败
+ */
+int preprocess_prepare_output(Tensor* output, const TensorShape* shape, TensorDataType dtype,
+                              TensorFormat format);
+
+/**
+ * @brief 取得至少 bytes 字节的工作区，起始地址按缓存行对齐
+ *
+ * workspace 为 NULL 时单独分配，由 preprocess_workspace_release 释放。
+ *
+ * @return void* 工作区，失败返回NULL
+ */
+void* preprocess_workspace_reserve(preprocess_workspace_t* workspace, size_t bytes);
+
+/**
+ * @brief 归还 preprocess_workspace_reserve 取得的内存（workspace 非 NULL 时保留以便复用）
+ */
+void preprocess_workspace_release(preprocess_workspace_t* workspace, void* data);
+
+/**
+ * @brief 释放工作区持有的内存
+ */
+void preprocess_workspace_free(preprocess_workspace_t* workspace);
+
+/**
+ * @brief 逐线程切分工作区时每份的字节数（按缓存行取整，避免伪共享）
+ */
+size_t preprocess_workspace_stride(size_t bytes);
+
+/**
+ * @brief 按类型读取一个元素并转换为 float
+ */
+float preprocess_load_element(const void* data, TensorDataType dtype, size_t index);
+
+/**
+ * @brief 将 float 按类型（饱和、四舍五入）写入一个元素
+ */
+void preprocess_store_element(void* data, TensorDataType dtype, size_t index, float value);
+
+/**
+ * @brief 按张量格式推断操作输出形状
+ *
+ * @return int 0成功，其他表示无法推断
+ */
+int preprocess_op_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                              TensorFormat input_format, TensorShape* output_shape);
+
+/**
+ * @brief 推断操作输出类型
+ */
+TensorDataType preprocess_op_output_dtype(preprocess_op_t op, TensorDataType input_dtype);
+
+/**
+ * @brief 推断操作输出格式
+ */
+TensorFormat preprocess_op_output_format(preprocess_op_t op, const TensorShape* input_shape,
+                                         TensorFormat input_format);
+
+/**
+ * @brief 沿操作链推断管道对给定输入的输出形状、类型和格式
+ *
+ * @return int 0成功，其他表示含有无法静态推断的操作
+ */
+int preprocess_pipeline_infer_output(preprocess_pipeline_t pipeline, const Tensor* input, TensorShape* shape,
+                                     TensorDataType* dtype, TensorFormat* format);
+
+/**
+ * @brief 判断操作能否并入融合组
+ */
+bool preprocess_fusion_accepts(const preprocess_fused_kernel_t* kernel, uint32_t op_count,
+                               preprocess_op_t op);
+
+/**
+ * @brief 将操作追加到融合内核描述
+ */
+void preprocess_fusion_append(preprocess_fused_kernel_t* kernel, preprocess_op_t op);
+
+/**
+ * @brief 将融合内核绑定到具体输入
+ *
+ * 只使用输入的形状、类型和格式，可在数据就绪前绑定。
+ *
+ * @return int 0成功，其他表示该输入无法融合
+ */
+int preprocess_fusion_bind(const preprocess_fused_kernel_t* kernel, const Tensor* input,
+                           preprocess_fused_binding_t* binding);
+
+/**
+ * @brief 释放绑定结果
+ */
+void preprocess_fusion_unbind(preprocess_fused_binding_t* binding);
+
+/**
+ * @brief 执行融合内核的一段输出行
+ *
+ * @param binding 绑定结果
+ * @param input 输入张量
+ * @param output 输出张量（已分配）
+ * @param row_begin 起始行（按 batch*height 展开）
+ * @param row_end 结束行（不含）
+ * @param work 行缓冲区（不少于 binding->work_bytes 字节，并发执行的分块各用一份）
+ * @return int 0成功，其他失败
+ */
+int preprocess_fusion_run_rows(const preprocess_fused_binding_t* binding, const Tensor* input,
+                               Tensor* output, uint32_t row_begin, uint32_t row_end, void* work);
+
+/**
+ * @brief 判断操作是否为 UINT8 查找表操作（亮度、对比度、伽马、直方图均衡化）
+ */
+bool preprocess_lut_is_op(preprocess_type_e type);
+
+/**
+ * @brief 对 count 个 UINT8 元素应用 256 项查找表
+ */
+void preprocess_lut_apply(const uint8_t table[256], const uint8_t* src, uint8_t* dst, size_t count);
+
+/**
+ * @brief 将连续的查找表操作组合为一张表并一次遍历完成
+ *
+ * @param ops 操作数组
+ * @param count 操作数量
+ * @param input UINT8 输入张量
+ * @param output UINT8 输出张量（已分配，可与输入相同）
+ * @param num_threads 最大并行度
+ * @param workspace 内核工作区（NULL 表示单独分配）
+ * @return int 0成功，其他失败
+ */
+int preprocess_lut_execute(const preprocess_op_t* ops, uint32_t count, const Tensor* input,
+                           Tensor* output, uint32_t num_threads, preprocess_workspace_t* workspace);
+
+/**
+ * @brief 判断操作是否为音频特征操作（加窗、FFT、频谱图、MFCC）
+ */
+bool preprocess_audio_is_op(preprocess_type_e type);
+
+/**
+ * @brief 推断音频特征操作的输出形状
+ *
+ * 输入为 [采样] 或 [批量, 采样]，输出为 [帧, 维度] 或 [批量, 帧, 维度]。
+ *
+ * @return int 0成功，其他表示无法推断
+ */
+int preprocess_audio_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                                 TensorShape* output_shape);
+
+/**
+ * @brief 执行音频特征操作，按帧分块并行
+ *
+ * @param op 操作
+ * @param input FLOAT32 或 INT16（按 1/32768 缩放）输入张量
+ * @param output FLOAT32 输出张量（已分配）
+ * @param num_threads 最大并行度
+ * @param workspace 内核工作区（NULL 表示单独分配）
+ * @return int 0成功，其他失败
+ */
+int preprocess_audio_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                             uint32_t num_threads, preprocess_workspace_t* workspace);
+
+/**
+ * @brief 推断重采样操作的输出形状（[采样] 或 [批量, 采样]，仅最后一维变化）
+ *
+ * @return int 0成功，其他表示无法推断
+ */
+int preprocess_resample_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                                    TensorShape* output_shape);
+
+/**
+ * @brief 执行重采样操作，各行并行
+ *
+ * @param op 操作
+ * @param input FLOAT32 或 INT16（按 1/32768 缩放）输入张量
+ * @param output FLOAT32 输出张量（已分配）
+ * @param num_threads 最大并行度
+ * @param workspace 内核工作区（NULL 表示单独分配）
+ * @return int 0成功，其他失败
+ */
+int preprocess_resample_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                                uint32_t num_threads, preprocess_workspace_t* workspace);
+
+/**
+ * @brief 推断分词操作的输出形状（[文本数] -> [文本数, max_length]）
+ *
+ * @return int 0成功，其他表示无法推断
+ */
+int preprocess_tokenize_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                                    TensorShape* output_shape);
+
+/**
+ * @brief 执行分词操作，各条文本并行，不足 max_length 的部分填充补齐词
+ *
+ * @param op 操作
+ * @param input STRING 输入张量
+ * @param output INT32 输出张量（已分配）
+ * @param num_threads 最大并行度
+ * @return int 0成功，其他失败
+ */
+int preprocess_tokenize_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                                uint32_t num_threads);
+
+/**
+ * @brief 推断法向量估计的输出形状（[点, 通道] -> [点, 通道 + 3]）
+ *
+ * 降采样和离群点去除的输出点数取决于数据，无法静态推断。
+ *
+ * @return int 0成功，其他表示无法推断
+ */
+int preprocess_normal_estimation_infer_shape(const TensorShape* input_shape, TensorShape* output_shape);
+
+/**
+ * @brief 执行点云操作（体素降采样、统计离群点去除、法向量估计）
+ *
+ * 输入为 FLOAT32 [点, 通道]，前三个通道为 x、y、z。降采样和离群点去除自行分配输出，
+ * 邻域查询基于 k-d 树，逐点计算在共享线程池上并行。
+ *
+ * @param op 操作
+ * @param input 输入点云
+ * @param output 输出点云
+ * @param num_threads 最大并行度
+ * @return int 0成功，其他失败
+ */
+int preprocess_pointcloud_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                                  uint32_t num_threads);
+
+/**
+ * @brief 按颜色空间转换参数解析输入形状
+ *
+ * @param params 颜色空间转换参数
+ * @param shape 源张量形状
+ * @param color 输出绑定（可为NULL）
+ * @param dims 输出的交错三通道图像维度（可为NULL）
+ * @return int 0成功，其他表示形状与源格式不符
+ */
+int preprocess_color_setup(const preprocess_params_t* params, const TensorShape* shape,
+                           preprocess_color_t* color, preprocess_image_dims_t* dims);
+
+/**
+ * @brief 将第 n 帧的第 y 行转换为交错三通道 UINT8
+ *
+ * @param color 颜色空间转换绑定
+ * @param src 源张量数据
+ * @param n 帧索引
+ * @param y 行索引
+ * @param dst 输出行（width * 3 字节）
+ * @param scratch 临时缓冲区（不少于 width * 2 字节）
+ */
+void preprocess_color_convert_row(const preprocess_color_t* color, const uint8_t* src, uint32_t n,
+                                  uint32_t y, uint8_t* dst, uint8_t* scratch);
+
+/**
+ * @brief 执行颜色空间转换操作，按行分块并行
+ *
+ * @return int 0成功，其他失败
+ */
+int preprocess_color_execute(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                             preprocess_workspace_t* workspace);
+
+/**
+ * @brief 检查量化/反量化参数
+ */
+bool preprocess_quant_params_valid(preprocess_type_e type, const preprocess_params_t* params);
+
+/**
+ * @brief 量化：dst = 饱和(就近取偶(src × scale + bias))
+ *
+ * scale/bias 按通道周期 period 循环，src[0] 对应通道0；period 不超过4时使用向量路径。
+ *
+ * @param src 浮点输入
+ * @param dst INT8 或 UINT8 输出
+ * @param dtype 输出类型
+ * @param count 元素数
+ * @param scale 逐通道乘数（1/量化缩放因子，可与归一化复合）
+ * @param bias 逐通道偏置（零点，可与归一化复合）
+ * @param period 通道周期
+ */
+void preprocess_quantize_affine(const float* src, void* dst, TensorDataType dtype, size_t count,
+                                const float* scale, const float* bias, uint32_t period);
+
+/**
+ * @brief 反量化：dst = src × scale + bias（bias 为 -零点 × 缩放因子）
+ *
+ * 通道周期约定与 preprocess_quantize_affine 相同。
+ */
+void preprocess_dequantize_affine(const void* src, TensorDataType dtype, float* dst, size_t count,
+                                  const float* scale, const float* bias, uint32_t period);
+
+/**
+ * @brief 执行量化或反量化操作，按元素分块并行
+ *
+ * 通道轴与归一化一致：图像张量为通道维，其余张量为最内层维度。
+ *
+ * @param op 操作
+ * @param input 输入张量（反量化要求 INT8/UINT8）
+ * @param output 输出张量（已分配）
+ * @param num_threads 最大并行度
+ * @param workspace 内核工作区（NULL 表示单独分配）
+ * @return int 0成功，其他失败
+ */
+int preprocess_quant_execute(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                             preprocess_workspace_t* workspace);
+
+/**
+ * @brief 检查模糊、锐化、边缘检测和形态学参数
+ */
+bool preprocess_filter_params_valid(preprocess_type_e type, const preprocess_params_t* params);
+
+/**
+ * @brief 执行邻域滤波操作（模糊、锐化、边缘检测、形态学），按行分块并行
+ *
+ * 支持 UINT8 和 FLOAT32 图像（NHWC/NCHW），边界按复制像素处理，输出形状和类型与输入相同。
+ * 边缘检测输出 3x3 Sobel 梯度幅值。
+ *
+ * @param op 操作
+ * @param input 输入图像
+ * @param output 输出图像（已分配）
+ * @param num_threads 最大并行度
+ * @param workspace 内核工作区（NULL 表示单独分配）
+ * @return int 0成功，其他失败
+ */
+int preprocess_filter_execute(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                              preprocess_workspace_t* workspace);
+
+/**
+ * @brief 区间任务函数：处理 [begin, end) 范围内的单元（行或元素）
+ */
+typedef void (*preprocess_range_func_t)(void* context, size_t begin, size_t end);
+
+/**
+ * @brief 将单元区间按 L2 缓存大小切分为分块，在共享线程池上并行执行
+ *
+ * 数据量较小或 num_threads 为 1 时直接在调用线程执行。
+ *
+ * @param num_threads 最大并行度
+ * @param units 单元总数
+ * @param bytes_per_unit 每个单元读写的字节数（用于确定分块大小）
+ * @param func 区间任务函数
+ * @param context 用户上下文
+ */
+void preprocess_parallel_for(uint32_t num_threads, size_t units, size_t bytes_per_unit,
+                             preprocess_range_func_t func, void* context);
+
+/**
+ * @brief 带工作槽的区间任务函数
+ *
+ * 同时执行的分块持有互不相同的 slot，取值范围为 [0, preprocess_parallel_slots(num_threads))，
+ * 用于索引逐线程的工作区。
+ */
+typedef void (*preprocess_slot_range_func_t)(void* context, uint32_t slot, size_t begin, size_t end);
+
+/**
+ * @brief 给定并行度下同时执行的分块数上限
+ */
+uint32_t preprocess_parallel_slots(uint32_t num_threads);
+
+/**
+ * @brief 同 preprocess_parallel_for，任务函数额外获得工作槽编号
+ */
+void preprocess_parallel_for_slots(uint32_t num_threads, size_t units, size_t bytes_per_unit,
+                                   preprocess_slot_range_func_t func, void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_PREPROCESSING_INTERNAL_H
@@ -0,0 +1,310 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief 查找表应用上下文
+ */
+typedef struct {
+    const uint8_t* src;
+    uint8_t* dst;
+    const uint8_t* tables;          /**< 每张表 256 项，按 (n, c) 排列 */
+    uint32_t table_count;           /**< 1 表示所有通道共用一张表 */
+    preprocess_image_dims_t dims;
+} lut_apply_job_t;
+
+bool preprocess_lut_is_op(preprocess_type_e type) {
+    switch (type) {
+        case PREPROCESS_BRIGHTNESS:
+        case PREPROCESS_CONTRAST:
+        case PREPROCESS_GAMMA:
+        case PREPROCESS_HISTOGRAM_EQ:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline uint8_t saturate_u8(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 255.0f) return 255;
+    return (uint8_t)(value + 0.5f);
+}
+
+// 由参数构建与数据无关的查找表
+static void build_static_lut(const preprocess_params_t* params, uint8_t table[256]) {
+    switch (params->type) {
+        case PREPROCESS_BRIGHTNESS: {
+            float factor = params->params.brightness.factor;
+            for (int i = 0; i < 256; i++) {
+                table[i] = saturate_u8(i * factor);
+            }
+            break;
+        }
+        case PREPROCESS_CONTRAST: {
+            // 以中灰 128 为支点，查找表与图像内容无关
+            float factor = params->params.contrast.factor;
+            for (int i = 0; i < 256; i++) {
+                table[i] = saturate_u8((i - 128.0f) * factor + 128.0f);
+            }
+            break;
+        }
+        case PREPROCESS_GAMMA: {
+            float gamma = params->params.gamma.gamma;
+            for (int i = 0; i < 256; i++) {
+                table[i] = saturate_u8(255.0f * powf(i / 255.0f, gamma));
+            }
+            break;
+        }
+        default:
+            for (int i = 0; i < 256; i++) {
+                table[i] = (uint8_t)i;
+            }
+            break;
+    }
+}
+
+// 获取操作的查找表，启用缓存时每组参数只构建一次
+static void get_op_lut(preprocess_op_t op, uint8_t table[256]) {
+    pthread_mutex_lock(&op->mutex);
+    if (op->enable_cache && op->lut_valid) {
+        memcpy(table, op->lut, 256);
+    } else {
+        build_static_lut(&op->params, table);
+        if (op->enable_cache) {
+            memcpy(op->lut, table, 256);
+            op->lut_valid = true;
+        }
+    }
+    pthread_mutex_unlock(&op->mutex);
+}
+
+// 按 PIL 的方式由直方图生成均衡化查找表
+static void build_equalize_lut(const uint32_t hist[256], uint8_t table[256]) {
+    uint64_t total = 0;
+    int last = -1;
+    for (int i = 0; i < 256; i++) {
+        total += hist[i];
+        if (hist[i]) last = i;
+    }
+
+    uint64_t step = last >= 0 ? (total - hist[last]) / 255 : 0;
+    if (step == 0) {
+        for (int i = 0; i < 256; i++) {
+            table[i] = (uint8_t)i;
+        }
+        return;
+    }
+
+    uint64_t n = step / 2;
+    for (int i = 0; i < 256; i++) {
+        uint64_t v = n / step;
+        table[i] = (uint8_t)(v > 255 ? 255 : v);
+        n += hist[i];
+    }
+}
+
+// 按 (n, c) 统计输入直方图
+static void compute_histograms(const uint8_t* src, const preprocess_image_dims_t* d, uint32_t* hist) {
+    memset(hist, 0, sizeof(uint32_t) * 256 * d->n * d->c);
+    size_t plane = (size_t)d->h * d->w;
+
+    for (uint32_t n = 0; n < d->n; n++) {
+        if (d->nchw) {
+            for (uint32_t c = 0; c < d->c; c++) {
+                uint32_t* h = hist + ((size_t)n * d->c + c) * 256;
+                const uint8_t* p = src + ((size_t)n * d->c + c) * plane;
+                for (size_t i = 0; i < plane; i++) {
+                    h[p[i]]++;
+                }
+            }
+        } else {
+            uint32_t* h = hist + (size_t)n * d->c * 256;
+            const uint8_t* p = src + (size_t)n * plane * d->c;
+            for (size_t i = 0; i < plane; i++) {
+                for (uint32_t c = 0; c < d->c; c++) {
+                    h[c * 256 + p[i * d->c + c]]++;
+                }
+            }
+        }
+    }
+}
+
+void preprocess_lut_apply(const uint8_t table[256], const uint8_t* src, uint8_t* dst, size_t count) {
+    size_t i = 0;
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    // 256 项表拆成四段 64 字节，TBL/TBX 每次查一段
+    uint8x16x4_t t0 = vld1q_u8_x4(table);
+    uint8x16x4_t t1 = vld1q_u8_x4(table + 64);
+    uint8x16x4_t t2 = vld1q_u8_x4(table + 128);
+    uint8x16x4_t t3 = vld1q_u8_x4(table + 192);
+    uint8x16_t offset = vdupq_n_u8(64);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t idx = vld1q_u8(src + i);
+        uint8x16_t r = vqtbl4q_u8(t0, idx);
+        idx = vsubq_u8(idx, offset);
+        r = vqtbx4q_u8(r, t1, idx);
+        idx = vsubq_u8(idx, offset);
+        r = vqtbx4q_u8(r, t2, idx);
+        idx = vsubq_u8(idx, offset);
+        r = vqtbx4q_u8(r, t3, idx);
+        vst1q_u8(dst + i, r);
+    }
+#endif
+
+    // 标量路径展开以隐藏查表延迟
+    for (; i + 8 <= count; i += 8) {
+        uint8_t v0 = table[src[i + 0]];
+        uint8_t v1 = table[src[i + 1]];
+        uint8_t v2 = table[src[i + 2]];
+        uint8_t v3 = table[src[i + 3]];
+        uint8_t v4 = table[src[i + 4]];
+        uint8_t v5 = table[src[i + 5]];
+        uint8_t v6 = table[src[i + 6]];
+        uint8_t v7 = table[src[i + 7]];
+        dst[i + 0] = v0;
+        dst[i + 1] = v1;
+        dst[i + 2] = v2;
+        dst[i + 3] = v3;
+        dst[i + 4] = v4;
+        dst[i + 5] = v5;
+        dst[i + 6] = v6;
+        dst[i + 7] = v7;
+    }
+    for (; i < count; i++) {
+        dst[i] = table[src[i]];
+    }
+}
+
+static void lut_apply_range(void* context, size_t begin, size_t end) {
+    const lut_apply_job_t* job = (const lut_apply_job_t*)context;
+
+    if (job->table_count == 1) {
+        preprocess_lut_apply(job->tables, job->src + begin, job->dst + begin, end - begin);
+        return;
+    }
+
+    const preprocess_image_dims_t* d = &job->dims;
+    size_t plane = (size_t)d->h * d->w;
+
+    if (d->nchw) {
+        // 平面布局：每个通道平面使用各自的表
+        size_t i = begin;
+        while (i < end) {
+            size_t plane_index = i / plane;
+            size_t plane_end = (plane_index + 1) * plane;
+            if (plane_end > end) plane_end = end;
+            preprocess_lut_apply(job->tables + plane_index * 256, job->src + i, job->dst + i, plane_end - i);
+            i = plane_end;
+        }
+        return;
+    }
+
+    // 交错布局：按像素内通道选择表
+    size_t image_size = plane * d->c;
+    for (size_t i = begin; i < end; i++) {
+        size_t n = i / image_size;
+        uint32_t c = (uint32_t)(i % d->c);
+        job->dst[i] = job->tables[(n * d->c + c) * 256 + job->src[i]];
+    }
+}
+
+int preprocess_lut_execute(const preprocess_op_t* ops, uint32_t count, const Tensor* input,
+                           Tensor* output, uint32_t num_threads, preprocess_workspace_t* workspace) {
+    if (!ops || count == 0 || !input || !output) return -1;
+
+    if (input->dtype != TENSOR_TYPE_UINT8 || output->dtype != TENSOR_TYPE_UINT8) {
+        LOG_ERROR("Photometric lookup-table ops require UINT8 tensors");
+        return -1;
+    }
+
+    lut_apply_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.src = (const uint8_t*)input->data;
+    job.dst = (uint8_t*)output->data;
+
+    size_t total = preprocess_shape_bytes(&input->shape, input->dtype);
+    bool has_equalize = false;
+    for (uint32_t i = 0; i < count; i++) {
+        if (ops[i]->params.type == PREPROCESS_HISTOGRAM_EQ) has_equalize = true;
+    }
+
+    if (has_equalize) {
+        if (preprocess_image_dims_from_shape(&input->shape, input->format, &job.dims) != 0) {
+            LOG_ERROR("Histogram equalization expects a 3D or 4D image tensor");
+            return -1;
+        }
+        job.table_count = job.dims.n * job.dims.c;
+    } else {
+        job.table_count = 1;
+    }
+
+    // 常见情况只有一张表，放在栈上；逐帧逐通道的表和直方图取自工作区
+    uint8_t single_table[256];
+    uint32_t single_hist[256];
+    uint8_t* tables = single_table;
+    uint32_t* hist = single_hist;
+    void* buffer = NULL;
+    if (job.table_count > 1) {
+        size_t table_bytes = preprocess_workspace_stride((size_t)job.table_count * 256);
+        size_t hist_bytes = has_equalize ? sizeof(uint32_t) * 256 * job.table_count : 0;
+        buffer = preprocess_workspace_reserve(workspace, table_bytes + hist_bytes);
+        if (!buffer) {
+            LOG_ERROR("Failed to allocate lookup tables");
+            return -1;
+        }
+        tables = (uint8_t*)buffer;
+        hist = (uint32_t*)((uint8_t*)buffer + table_bytes);
+    }
+
+    for (uint32_t t = 0; t < job.table_count; t++) {
+        for (int v = 0; v < 256; v++) {
+            tables[t * 256 + v] = (uint8_t)v;
+        }
+    }
+
+    // 连续的查找表操作组合成一张表；均衡化的直方图由输入直方图经当前表映射得到
+    bool hist_ready = false;
+    for (uint32_t i = 0; i < count; i++) {
+        if (ops[i]->params.type == PREPROCESS_HISTOGRAM_EQ) {
+            if (!hist_ready) {
+                compute_histograms(job.src, &job.dims, hist);
+                hist_ready = true;
+            }
+            for (uint32_t t = 0; t < job.table_count; t++) {
+                uint8_t* table = tables + t * 256;
+                uint32_t mapped[256] = {0};
+                uint8_t eq[256];
+                for (int v = 0; v < 256; v++) {
+                    mapped[table[v]] += hist[t * 256 + v];
+                }
+                build_equalize_lut(mapped, eq);
+                for (int v = 0; v < 256; v++) {
+                    table[v] = eq[table[v]];
+                }
+            }
+        } else {
+            uint8_t lut[256];
+            get_op_lut(ops[i], lut);
+            for (uint32_t t = 0; t < job.table_count; t++) {
+                uint8_t* table = tables + t * 256;
+                for (int v = 0; v < 256; v++) {
+                    table[v] = lut[table[v]];
+                }
+            }
+        }
+    }
+
+    job.tables = tables;
+    preprocess_parallel_for(num_threads, total, 2, lut_apply_range, &job);
+
+    preprocess_workspace_release(workspace, buffer);
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/thread_pool.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 多模态预处理
+ *
+ * 每个模态是一个任务：输入以不拥有内存的张量视图传入管道，输出直接写入输出容器中对应模态的缓冲区。
+ * 使用同一管道的模态归为一组依次执行（管道执行本身是串行化的），不同组在共享线程池上并发；
+ * 管道内部的分块并行嵌套在同一线程池上，调用线程参与执行，不会死锁。
+ */
+
+/**
+ * @brief 单个模态的执行任务
+ */
+typedef struct {
+    const ModalityData* input;
+    uint32_t slot_index;            /**< 输出容器中的对应模态 */
+    ModalityData* slot;
+    preprocess_pipeline_t pipeline;
+    int result;
+} modality_task_t;
+
+/**
+ * @brief 多模态执行上下文
+ */
+typedef struct {
+    modality_task_t* tasks;
+    uint32_t* group_begin;          /**< 第 i 组任务为 [group_begin[i], group_begin[i+1]) */
+} multimodal_job_t;
+
+static preprocess_pipeline_t find_pipeline(const preprocess_modality_pipeline_t* pipelines, uint32_t count,
+                                           modality_type_e modality) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (pipelines[i].modality == modality) return pipelines[i].pipeline;
+    }
+    return NULL;
+}
+
+// 把模态数据解释为张量：3 维及以上为交错图像布局
+static Tensor modality_view(const ModalityData* modal) {
+    Tensor view = {0};
+    view.dtype = modal->data_type;
+    view.shape = modal->shape;
+    view.format = modal->shape.ndim >= 3 ? TENSOR_FORMAT_NHWC : TENSOR_FORMAT_NC;
+    view.memory_type = TENSOR_MEMORY_CPU;
+    view.data = modal->data;
+    view.size = modal->data_size;
+    view.owns_data = false;
+    return view;
+}
+
+// 容器中第 occurrence 个该类模态的索引，不存在时返回 UINT32_MAX
+static uint32_t find_slot(const MultiModalData* data, modality_type_e modality, uint32_t occurrence) {
+    for (uint32_t i = 0; i < data->modality_count; i++) {
+        if (data->modalities[i].modality != modality) continue;
+        if (occurrence == 0) return i;
+        occurrence--;
+    }
+    return UINT32_MAX;
+}
+
+// 为每个有管道的输入模态确定输出槽位，缺少的追加空模态；
+// 追加可能使容器扩容，因此全部追加完成后才取槽位指针
+static int bind_slots(const preprocess_modality_pipeline_t* pipelines, uint32_t pipeline_count,
+                      const MultiModalData* input, MultiModalData* output, modality_task_t* tasks,
+                      uint32_t* task_count) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < input->modality_count; i++) {
+        const ModalityData* modal = &input->modalities[i];
+        preprocess_pipeline_t pipeline = find_pipeline(pipelines, pipeline_count, modal->modality);
+        if (!pipeline) continue;
+
+        uint32_t occurrence = 0;
+        for (uint32_t j = 0; j < i; j++) {
+            if (input->modalities[j].modality == modal->modality) occurrence++;
+        }
+
+        uint32_t slot = find_slot(output, modal->modality, occurrence);
+        while (slot == UINT32_MAX) {
+            ModalityData empty;
+            memset(&empty, 0, sizeof(empty));
+            empty.modality = modal->modality;
+            empty.format = modal->format;
+            if (multimodal_data_add(output, &empty) != 0) return -1;
+            slot = find_slot(output, modal->modality, occurrence);
+        }
+        if (output->modalities[slot].borrowed) {
+            // 反序列化得到的视图指向外部只读缓冲区，不能作为输出
+            LOG_ERROR("Output %s slot is a read-only view", modality_type_to_string(modal->modality));
+            return -1;
+        }
+
+        tasks[count].input = modal;
+        tasks[count].slot_index = slot;
+        tasks[count].pipeline = pipeline;
+        tasks[count].result = 0;
+        count++;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        tasks[i].slot = &output->modalities[tasks[i].slot_index];
+    }
+    *task_count = count;
+    return 0;
+}
+
+static int compare_task_pipeline(const void* a, const void* b) {
+    uintptr_t pa = (uintptr_t)((const modality_task_t*)a)->pipeline;
+    uintptr_t pb = (uintptr_t)((const modality_task_t*)b)->pipeline;
+    return pa < pb ? -1 : (pa > pb ? 1 : 0);
+}
+
+static void run_modality(modality_task_t* task) {
+    const ModalityData* input = task->input;
+    ModalityData* slot = task->slot;
+    Tensor in = modality_view(input);
+    Tensor out = {0};
+
+    // 槽位已有足够大的缓冲区时原地写入，否则由管道分配
+    TensorShape shape;
+    TensorDataType dtype;
+    TensorFormat format;
+    if (slot->data && preprocess_pipeline_infer_output(task->pipeline, &in, &shape, &dtype, &format) == 0 &&
+        preprocess_shape_bytes(&shape, dtype) <= slot->data_size) {
+        out.data = slot->data;
+        out.size = slot->data_size;
+        out.memory_type = TENSOR_MEMORY_CPU;
+        out.owns_data = false;
+    }
+
+    int ret = preprocess_pipeline_execute(task->pipeline, &in, &out);
+    if (ret == 0 && out.data != slot->data) {
+        void* data = out.data;
+        if (!out.owns_data) {
+            // 静态计划绑定的输出属于管道，复制到容器自己的缓冲区
+            data = malloc(out.size);
+            if (data) {
+                memcpy(data, out.data, out.size);
+            } else {
+                LOG_ERROR("Failed to allocate %s output", modality_type_to_string(input->modality));
+                ret = -1;
+            }
+        }
+        if (ret == 0) {
+            free(slot->data);
+            slot->data = data;
+        }
+    } else if (ret != 0 && out.owns_data) {
+        free(out.data);
+    }
+
+    if (ret == 0) {
+        slot->data_size = out.size;
+        slot->shape = out.shape;
+        slot->data_type = out.dtype;
+        slot->timestamp = input->timestamp;
+        slot->sequence_id = input->sequence_id;
+        if (slot->format == DATA_FORMAT_UNKNOWN) slot->format = input->format;
+    } else {
+        LOG_ERROR("Preprocessing failed for modality %s", modality_type_to_string(input->modality));
+    }
+    task->result = ret;
+}
+
+static void multimodal_group_task(void* context, uint32_t index) {
+    multimodal_job_t* job = (multimodal_job_t*)context;
+    for (uint32_t i = job->group_begin[index]; i < job->group_begin[index + 1]; i++) {
+        run_modality(&job->tasks[i]);
+    }
+}
+
+int preprocess_multimodal_execute_pipelines(const preprocess_modality_pipeline_t* pipelines, uint32_t pipeline_count,
+                                            const MultiModalData* input, MultiModalData* output,
+                                            uint32_t num_threads) {
+    if (!pipelines || !input || !output || input == output) return -1;
+    if (input->modality_count == 0) return 0;
+
+    modality_task_t* tasks = calloc(input->modality_count, sizeof(modality_task_t));
+    uint32_t* group_begin = calloc((size_t)input->modality_count + 1, sizeof(uint32_t));
+    if (!tasks || !group_begin) {
+        LOG_ERROR("Failed to allocate multimodal tasks");
+        free(tasks);
+        free(group_begin);
+        return -1;
+    }
+
+    uint32_t task_count = 0;
+    if (bind_slots(pipelines, pipeline_count, input, output, tasks, &task_count) != 0) {
+        LOG_ERROR("Failed to prepare multimodal output");
+        free(tasks);
+        free(group_begin);
+        return -1;
+    }
+
+    // 同一管道的模态相邻排列，组成一个串行组
+    qsort(tasks, task_count, sizeof(modality_task_t), compare_task_pipeline);
+    uint32_t groups = 0;
+    for (uint32_t i = 0; i < task_count; i++) {
+        if (i == 0 || tasks[i].pipeline != tasks[i - 1].pipeline) group_begin[groups++] = i;
+    }
+    group_begin[groups] = task_count;
+
+    multimodal_job_t job = {
+        .tasks = tasks,
+        .group_begin = group_begin
+    };
+
+    uint32_t parallel = num_threads == 0 || num_threads > groups ? groups : num_threads;
+    thread_pool_t pool = NULL;
+    if (parallel > 1) {
+        pool = thread_pool_get_shared();
+        if (pool) thread_pool_reserve(pool, parallel - 1);
+    }
+    if (groups > 0) {
+        thread_pool_parallel_for(pool, groups, parallel, multimodal_group_task, &job);
+    }
+
+    int ret = 0;
+    for (uint32_t i = 0; i < task_count; i++) {
+        if (tasks[i].result != 0) ret = -1;
+    }
+
+    free(tasks);
+    free(group_begin);
+    return ret;
+}
+
+int preprocess_multimodal_execute(preprocess_pipeline_t pipeline, const MultiModalData* input,
+                                  MultiModalData* output) {
+    if (!pipeline || !input || !output) return -1;
+
+    preprocess_modality_pipeline_t* map = calloc(input->modality_count + 1, sizeof(preprocess_modality_pipeline_t));
+    if (!map) return -1;
+    for (uint32_t i = 0; i < input->modality_count; i++) {
+        map[i].modality = input->modalities[i].modality;
+        map[i].pipeline = pipeline;
+    }
+
+    int ret = preprocess_multimodal_execute_pipelines(map, input->modality_count, input, output, 1);
+    free(map);
+    return ret;
+}
+
+int preprocess_multimodal_prepare_output(const preprocess_modality_pipeline_t* pipelines, uint32_t pipeline_count,
+                                         const MultiModalData* input, MultiModalData* output) {
+    if (!pipelines || !input || !output || input == output) return -1;
+    if (input->modality_count == 0) return 0;
+
+    modality_task_t* tasks = calloc(input->modality_count, sizeof(modality_task_t));
+    if (!tasks) return -1;
+
+    uint32_t task_count = 0;
+    int ret = bind_slots(pipelines, pipeline_count, input, output, tasks, &task_count);
+
+    for (uint32_t i = 0; i < task_count && ret == 0; i++) {
+        Tensor in = modality_view(tasks[i].input);
+        TensorShape shape;
+        TensorDataType dtype;
+        TensorFormat format;
+        if (preprocess_pipeline_infer_output(tasks[i].pipeline, &in, &shape, &dtype, &format) != 0) {
+            continue;
+        }
+
+        ModalityData* slot = tasks[i].slot;
+        size_t bytes = preprocess_shape_bytes(&shape, dtype);
+        if (!slot->data || slot->data_size < bytes) {
+            void* data = realloc(slot->data, bytes);
+            if (!data) {
+                LOG_ERROR("Failed to allocate %s output (%zu bytes)",
+                          modality_type_to_string(slot->modality), bytes);
+                ret = -1;
+                break;
+            }
+            slot->data = data;
+        }
+        slot->data_size = bytes;
+        slot->shape = shape;
+        slot->data_type = dtype;
+    }
+
+    free(tasks);
+    return ret;
+}
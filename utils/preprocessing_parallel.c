@@ -0,0 +1,118 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/thread_pool.h"
+#include <stdatomic.h>
+#include <unistd.h>
+
+// 默认 L2 缓存大小（无法从系统查询时使用）
+#define PREPROCESS_DEFAULT_L2_BYTES (256 * 1024)
+
+// 低于该数据量时并行调度开销大于收益
+#define PREPROCESS_PARALLEL_MIN_BYTES (64 * 1024)
+
+// 工作槽占用位图的位数
+#define PREPROCESS_PARALLEL_MAX_SLOTS 32
+
+/**
+ * @brief 分块并行上下文
+ */
+typedef struct {
+    preprocess_range_func_t func;
+    preprocess_slot_range_func_t slot_func;
+    void* context;
+    size_t units;
+    size_t units_per_tile;
+    atomic_uint busy;               /**< 正在使用的工作槽 */
+} preprocess_tile_job_t;
+
+static size_t g_l2_bytes = 0;
+static pthread_once_t g_l2_once = PTHREAD_ONCE_INIT;
+
+static void detect_l2_size(void) {
+    long size = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    g_l2_bytes = size > 0 ? (size_t)size : PREPROCESS_DEFAULT_L2_BYTES;
+}
+
+// 同时执行的分块数不超过线程池并行度，因此总能找到空闲的工作槽
+static uint32_t claim_slot(atomic_uint* busy) {
+    unsigned int mask = atomic_load(busy);
+    while (true) {
+        uint32_t slot = (uint32_t)__builtin_ctz(~mask);
+        if (atomic_compare_exchange_weak(busy, &mask, mask | (1u << slot))) return slot;
+    }
+}
+
+static void run_tile(void* context, uint32_t index) {
+    preprocess_tile_job_t* job = (preprocess_tile_job_t*)context;
+    size_t begin = (size_t)index * job->units_per_tile;
+    size_t end = begin + job->units_per_tile;
+    if (end > job->units) end = job->units;
+
+    if (!job->slot_func) {
+        job->func(job->context, begin, end);
+        return;
+    }
+
+    uint32_t slot = claim_slot(&job->busy);
+    job->slot_func(job->context, slot, begin, end);
+    atomic_fetch_and(&job->busy, ~(1u << slot));
+}
+
+// 数据量足够时按分块并行，否则在调用线程执行全部单元
+static void run_tiles(uint32_t num_threads, size_t bytes_per_unit, preprocess_tile_job_t* job) {
+    if (num_threads <= 1 || job->units == 1 || job->units * bytes_per_unit < PREPROCESS_PARALLEL_MIN_BYTES) {
+        if (job->slot_func) {
+            job->slot_func(job->context, 0, 0, job->units);
+        } else {
+            job->func(job->context, 0, job->units);
+        }
+        return;
+    }
+
+    pthread_once(&g_l2_once, detect_l2_size);
+
+    // 每个分块的输入输出工作集占用一半 L2，留出空间给坐标表和栈
+    size_t per_tile = bytes_per_unit > 0 ? (g_l2_bytes / 2) / bytes_per_unit : job->units;
+    if (per_tile == 0) per_tile = 1;
+
+    // 至少保证每个线程分到一个分块
+    size_t per_thread = (job->units + num_threads - 1) / num_threads;
+    if (per_tile > per_thread) per_tile = per_thread;
+
+    job->units_per_tile = per_tile;
+    uint32_t tiles = (uint32_t)((job->units + per_tile - 1) / per_tile);
+
+    thread_pool_parallel_for(thread_pool_get_shared(), tiles, num_threads, run_tile, job);
+}
+
+void preprocess_parallel_for(uint32_t num_threads, size_t units, size_t bytes_per_unit,
+                             preprocess_range_func_t func, void* context) {
+    if (units == 0) return;
+
+    preprocess_tile_job_t job = {
+        .func = func,
+        .context = context,
+        .units = units
+    };
+    run_tiles(num_threads, bytes_per_unit, &job);
+}
+
+uint32_t preprocess_parallel_slots(uint32_t num_threads) {
+    if (num_threads <= 1) return 1;
+    return num_threads < PREPROCESS_PARALLEL_MAX_SLOTS ? num_threads : PREPROCESS_PARALLEL_MAX_SLOTS;
+}
+
+void preprocess_parallel_for_slots(uint32_t num_threads, size_t units, size_t bytes_per_unit,
+                                   preprocess_slot_range_func_t func, void* context) {
+    if (units == 0) return;
+
+    preprocess_tile_job_t job = {
+        .slot_func = func,
+        .context = context,
+        .units = units
+    };
+    atomic_init(&job.busy, 0);
+    run_tiles(preprocess_parallel_slots(num_threads), bytes_per_unit, &job);
+}
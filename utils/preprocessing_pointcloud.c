@@ -0,0 +1,254 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/pointcloud_utils.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+// 法向量估计未指定 k 时使用的邻居数
+#define PREPROCESS_NORMAL_DEFAULT_K 32
+
+/**
+ * @brief 逐点邻域计算上下文（离群点去除、法向量估计）
+ */
+typedef struct {
+    kdtree_t tree;
+    const float* points;            /**< [点, 通道] */
+    uint32_t channels;
+    uint32_t k;                     /**< 每次查询的邻居数 */
+    float radius;                   /**< 法向量邻域半径（0表示不限制） */
+    float* mean_distance;           /**< 离群点去除：到 k 个邻居的平均距离 */
+    float* output;                  /**< 法向量估计：[点, 通道 + 3] */
+    atomic_int result;              /**< 任一分块失败时置为-1 */
+} neighborhood_job_t;
+
+// 解析 [点, 通道] 浮点点云
+static int pointcloud_from_tensor(const Tensor* input, uint32_t* count, uint32_t* channels) {
+    if (input->dtype != TENSOR_TYPE_FLOAT32 || input->shape.ndim != 2 || input->shape.dims[1] < 3 ||
+        !input->data) {
+        LOG_ERROR("Point cloud ops expect a FLOAT32 [points, channels>=3] tensor");
+        return -1;
+    }
+    *count = input->shape.dims[0];
+    *channels = input->shape.dims[1];
+    return *count > 0 ? 0 : -1;
+}
+
+int preprocess_normal_estimation_infer_shape(const TensorShape* input_shape, TensorShape* output_shape) {
+    if (input_shape->ndim != 2 || input_shape->dims[1] < 3) {
+        LOG_ERROR("Normal estimation expects a [points, channels>=3] tensor");
+        return -1;
+    }
+
+    *output_shape = *input_shape;
+    output_shape->dims[1] += 3;
+    return 0;
+}
+
+static int downsample_execute(const preprocess_op_t op, const Tensor* input, Tensor* output) {
+    uint32_t count;
+    uint32_t channels;
+    if (pointcloud_from_tensor(input, &count, &channels) != 0) return -1;
+
+    const float* points = (const float*)input->data;
+    float voxel_size = op->params.params.downsample.voxel_size;
+    uint32_t target = op->params.params.downsample.target_points;
+
+    // 未指定体素边长时搜索满足目标点数的最小边长；点数已达标时原样输出
+    if (voxel_size <= 0.0f && target >= count) {
+        TensorShape shape = input->shape;
+        if (preprocess_prepare_output(output, &shape, TENSOR_TYPE_FLOAT32, input->format) != 0) return -1;
+        memcpy(output->data, points, (size_t)count * channels * sizeof(float));
+        return 0;
+    }
+    if (voxel_size <= 0.0f) {
+        voxel_size = pointcloud_voxel_size_for_target(points, count, channels, target);
+        if (voxel_size <= 0.0f) return -1;
+    }
+
+    float* reduced = malloc((size_t)count * channels * sizeof(float));
+    if (!reduced) {
+        LOG_ERROR("Failed to allocate voxel buffer");
+        return -1;
+    }
+
+    uint32_t kept = 0;
+    int ret = pointcloud_voxel_downsample(points, count, channels, voxel_size, reduced, &kept);
+    if (ret == 0) {
+        TensorShape shape = input->shape;
+        shape.dims[0] = kept;
+        ret = preprocess_prepare_output(output, &shape, TENSOR_TYPE_FLOAT32, input->format);
+    }
+    if (ret == 0) {
+        memcpy(output->data, reduced, (size_t)kept * channels * sizeof(float));
+        LOG_DEBUG("Voxel downsampling (%.4f): %u -> %u points", voxel_size, count, kept);
+    }
+
+    free(reduced);
+    return ret;
+}
+
+// 计算 [begin, end) 中每个点到 k 个最近邻（不含自身）的平均距离
+static void mean_distance_range(void* context, size_t begin, size_t end) {
+    neighborhood_job_t* job = (neighborhood_job_t*)context;
+    uint32_t query_k = job->k + 1;
+    uint32_t* indices = malloc(sizeof(uint32_t) * query_k);
+    float* distances = malloc(sizeof(float) * query_k);
+    if (!indices || !distances) {
+        atomic_store(&job->result, -1);
+        free(indices);
+        free(distances);
+        return;
+    }
+
+    for (size_t i = begin; i < end; i++) {
+        const float* p = job->points + i * job->channels;
+        uint32_t found = kdtree_knn(job->tree, p, query_k, indices, distances);
+
+        double sum = 0.0;
+        uint32_t used = 0;
+        for (uint32_t n = 0; n < found && used < job->k; n++) {
+            if (indices[n] == i) continue;
+            sum += sqrtf(distances[n]);
+            used++;
+        }
+        job->mean_distance[i] = used > 0 ? (float)(sum / used) : 0.0f;
+    }
+
+    free(indices);
+    free(distances);
+}
+
+static int outlier_removal_execute(const preprocess_op_t op, const Tensor* input, Tensor* output,
+                                   uint32_t num_threads) {
+    uint32_t count;
+    uint32_t channels;
+    if (pointcloud_from_tensor(input, &count, &channels) != 0) return -1;
+
+    neighborhood_job_t job;
+    memset(&job, 0, sizeof(job));
+    atomic_init(&job.result, 0);
+    job.points = (const float*)input->data;
+    job.channels = channels;
+    job.k = op->params.params.outlier_removal.k;
+    job.tree = kdtree_build(job.points, count, channels, num_threads);
+    job.mean_distance = malloc(sizeof(float) * count);
+    if (!job.tree || !job.mean_distance) {
+        kdtree_destroy(job.tree);
+        free(job.mean_distance);
+        return -1;
+    }
+
+    preprocess_parallel_for(num_threads, count, sizeof(float) * 4 * (job.k + 1), mean_distance_range, &job);
+    kdtree_destroy(job.tree);
+
+    int ret = atomic_load(&job.result);
+    if (ret != 0) {
+        free(job.mean_distance);
+        return ret;
+    }
+
+    // 平均距离超过 均值 + std_ratio * 标准差 的点视为离群点
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += job.mean_distance[i];
+        sum_sq += (double)job.mean_distance[i] * job.mean_distance[i];
+    }
+    double mean = sum / count;
+    double variance = sum_sq / count - mean * mean;
+    double threshold = mean + op->params.params.outlier_removal.std_ratio * sqrt(variance > 0.0 ? variance : 0.0);
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (job.mean_distance[i] <= threshold) kept++;
+    }
+
+    TensorShape shape = input->shape;
+    shape.dims[0] = kept;
+    ret = kept > 0 ? preprocess_prepare_output(output, &shape, TENSOR_TYPE_FLOAT32, input->format) : -1;
+    if (ret == 0) {
+        float* dst = (float*)output->data;
+        for (uint32_t i = 0; i < count; i++) {
+            if (job.mean_distance[i] > threshold) continue;
+            memcpy(dst, job.points + (size_t)i * channels, sizeof(float) * channels);
+            dst += channels;
+        }
+        LOG_DEBUG("Statistical outlier removal: %u -> %u points", count, kept);
+    }
+
+    free(job.mean_distance);
+    return ret;
+}
+
+// 估计 [begin, end) 中每个点的法向量，输出原通道后接 nx、ny、nz
+static void normal_range(void* context, size_t begin, size_t end) {
+    neighborhood_job_t* job = (neighborhood_job_t*)context;
+    uint32_t* indices = malloc(sizeof(uint32_t) * job->k);
+    float* distances = malloc(sizeof(float) * job->k);
+    if (!indices || !distances) {
+        atomic_store(&job->result, -1);
+        free(indices);
+        free(distances);
+        return;
+    }
+
+    // 传感器坐标系下视点为原点，法向量朝向传感器
+    const float viewpoint[3] = {0.0f, 0.0f, 0.0f};
+    const float r2 = job->radius * job->radius;
+    const uint32_t out_channels = job->channels + 3;
+
+    for (size_t i = begin; i < end; i++) {
+        const float* p = job->points + i * job->channels;
+        uint32_t found = kdtree_knn(job->tree, p, job->k, indices, distances);
+        if (job->radius > 0.0f) {
+            while (found > 0 && distances[found - 1] > r2) found--;
+        }
+
+        float* dst = job->output + i * out_channels;
+        memcpy(dst, p, sizeof(float) * job->channels);
+        pointcloud_estimate_normal(job->points, job->channels, indices, found, viewpoint, dst + job->channels);
+    }
+
+    free(indices);
+    free(distances);
+}
+
+static int normal_estimation_execute(const preprocess_op_t op, const Tensor* input, Tensor* output,
+                                     uint32_t num_threads) {
+    uint32_t count;
+    uint32_t channels;
+    if (pointcloud_from_tensor(input, &count, &channels) != 0) return -1;
+
+    neighborhood_job_t job;
+    memset(&job, 0, sizeof(job));
+    atomic_init(&job.result, 0);
+    job.points = (const float*)input->data;
+    job.channels = channels;
+    job.k = op->params.params.normal_estimation.k > 0 ? op->params.params.normal_estimation.k
+                                                      : PREPROCESS_NORMAL_DEFAULT_K;
+    job.radius = op->params.params.normal_estimation.radius;
+    job.output = (float*)output->data;
+    job.tree = kdtree_build(job.points, count, channels, num_threads);
+    if (!job.tree) return -1;
+
+    preprocess_parallel_for(num_threads, count, sizeof(float) * 4 * job.k, normal_range, &job);
+
+    kdtree_destroy(job.tree);
+    return atomic_load(&job.result);
+}
+
+int preprocess_pointcloud_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                                  uint32_t num_threads) {
+    switch (op->params.type) {
+        case PREPROCESS_DOWNSAMPLE:
+            return downsample_execute(op, input, output);
+        case PREPROCESS_OUTLIER_REMOVAL:
+            return outlier_removal_execute(op, input, output, num_threads);
+        case PREPROCESS_NORMAL_ESTIMATION:
+            return normal_estimation_execute(op, input, output, num_threads);
+        default:
+            return -1;
+    }
+}
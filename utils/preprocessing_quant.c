@@ -0,0 +1,372 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief INT8/UINT8 量化与反量化
+ *
+ * 量化值 q 与实数 r 满足 r = (q - zero_point) × scale。两个方向都改写为
+ * 逐通道的 y = x × a + b，与归一化的仿射可直接复合，向量内核一次完成
+ * 乘加、饱和与取整（就近取偶，与向量转换指令一致）。
+ */
+
+// 非浮点输入分块转为浮点后再量化
+#define QUANT_CHUNK 240
+
+// 向量路径支持的最大通道周期（12 是 1~4 的公倍数）
+#define QUANT_PATTERN 12
+
+bool preprocess_quant_params_valid(preprocess_type_e type, const preprocess_params_t* params) {
+    uint32_t channels = params->params.quantize.channels;
+    TensorDataType dtype = params->params.quantize.dtype;
+
+    if (channels == 0 || channels > 4) return false;
+    if (type == PREPROCESS_QUANTIZE && dtype != TENSOR_TYPE_INT8 && dtype != TENSOR_TYPE_UINT8) return false;
+
+    // 反量化的零点范围由输入类型决定，未指定类型时按 INT8/UINT8 的并集检查
+    int32_t lo = dtype == TENSOR_TYPE_UINT8 ? 0 : -128;
+    int32_t hi = dtype == TENSOR_TYPE_INT8 ? 127 : 255;
+    for (uint32_t c = 0; c < channels; c++) {
+        float scale = params->params.quantize.scale[c];
+        int32_t zero_point = params->params.quantize.zero_point[c];
+        if (!(scale > 0.0f) || !isfinite(scale)) return false;
+        if (zero_point < lo || zero_point > hi) return false;
+    }
+    return true;
+}
+
+int preprocess_quantize_params_from_spec(const model_io_spec_t* spec, preprocess_type_e type,
+                                         preprocess_params_t* params) {
+    if (!spec || !params || (type != PREPROCESS_QUANTIZE && type != PREPROCESS_DEQUANTIZE)) return -1;
+
+    if ((spec->data_type != TENSOR_TYPE_INT8 && spec->data_type != TENSOR_TYPE_UINT8) || !(spec->scale > 0.0f)) {
+        LOG_DEBUG("Model tensor %s is not quantized", spec->name ? spec->name : "(unnamed)");
+        return -1;
+    }
+
+    memset(params, 0, sizeof(*params));
+    params->type = type;
+    params->params.quantize.scale[0] = spec->scale;
+    params->params.quantize.zero_point[0] = spec->zero_point;
+    params->params.quantize.channels = 1;
+    params->params.quantize.dtype = spec->data_type;
+
+    return preprocess_quant_params_valid(type, params) ? 0 : -1;
+}
+
+void preprocess_quantize_affine(const float* src, void* dst, TensorDataType dtype, size_t count,
+                                const float* scale, const float* bias, uint32_t period) {
+    const float lo = dtype == TENSOR_TYPE_INT8 ? -128.0f : 0.0f;
+    const float hi = dtype == TENSOR_TYPE_INT8 ? 127.0f : 255.0f;
+    size_t i = 0;
+
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+    if (period <= 4) {
+        // 通道参数展开为三个向量的周期模式，每次处理 16 个元素（4 个向量）
+        float ps[QUANT_PATTERN];
+        float pb[QUANT_PATTERN];
+        for (uint32_t k = 0; k < QUANT_PATTERN; k++) {
+            ps[k] = scale[k % period];
+            pb[k] = bias[k % period];
+        }
+
+#if defined(__SSE2__)
+        __m128 vs[3], vb[3];
+        for (int k = 0; k < 3; k++) {
+            vs[k] = _mm_loadu_ps(ps + 4 * k);
+            vb[k] = _mm_loadu_ps(pb + 4 * k);
+        }
+        const __m128 vlo = _mm_set1_ps(lo);
+        const __m128 vhi = _mm_set1_ps(hi);
+
+        for (; i + 16 <= count; i += 16) {
+            size_t base = i / 4;
+            __m128i q[4];
+            for (int k = 0; k < 4; k++) {
+                size_t p = (base + k) % 3;
+                __m128 x = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4 * k), vs[p]), vb[p]);
+                // max 的 NaN 取第二个操作数，NaN 饱和到下界
+                x = _mm_min_ps(_mm_max_ps(x, vlo), vhi);
+                q[k] = _mm_cvtps_epi32(x);
+            }
+            __m128i lo16 = _mm_packs_epi32(q[0], q[1]);
+            __m128i hi16 = _mm_packs_epi32(q[2], q[3]);
+            __m128i r = dtype == TENSOR_TYPE_INT8 ? _mm_packs_epi16(lo16, hi16) : _mm_packus_epi16(lo16, hi16);
+            _mm_storeu_si128((__m128i*)((uint8_t*)dst + i), r);
+        }
+#else
+        float32x4_t vs[3], vb[3];
+        for (int k = 0; k < 3; k++) {
+            vs[k] = vld1q_f32(ps + 4 * k);
+            vb[k] = vld1q_f32(pb + 4 * k);
+        }
+        const float32x4_t vlo = vdupq_n_f32(lo);
+        const float32x4_t vhi = vdupq_n_f32(hi);
+
+        for (; i + 16 <= count; i += 16) {
+            size_t base = i / 4;
+            int32x4_t q[4];
+            for (int k = 0; k < 4; k++) {
+                size_t p = (base + k) % 3;
+                float32x4_t x = vaddq_f32(vmulq_f32(vld1q_f32(src + i + 4 * k), vs[p]), vb[p]);
+                x = vminq_f32(vmaxnmq_f32(x, vlo), vhi);
+                q[k] = vcvtnq_s32_f32(x);
+            }
+            int16x8_t lo16 = vcombine_s16(vqmovn_s32(q[0]), vqmovn_s32(q[1]));
+            int16x8_t hi16 = vcombine_s16(vqmovn_s32(q[2]), vqmovn_s32(q[3]));
+            if (dtype == TENSOR_TYPE_INT8) {
+                vst1q_s8((int8_t*)dst + i, vcombine_s8(vqmovn_s16(lo16), vqmovn_s16(hi16)));
+            } else {
+                vst1q_u8((uint8_t*)dst + i, vcombine_u8(vqmovun_s16(lo16), vqmovun_s16(hi16)));
+            }
+        }
+#endif
+    }
+#endif
+
+    for (; i < count; i++) {
+        uint32_t c = (uint32_t)(i % period);
+        float v = nearbyintf(fminf(fmaxf(src[i] * scale[c] + bias[c], lo), hi));
+        if (dtype == TENSOR_TYPE_INT8) {
+            ((int8_t*)dst)[i] = (int8_t)v;
+        } else {
+            ((uint8_t*)dst)[i] = (uint8_t)v;
+        }
+    }
+}
+
+void preprocess_dequantize_affine(const void* src, TensorDataType dtype, float* dst, size_t count,
+                                  const float* scale, const float* bias, uint32_t period) {
+    size_t i = 0;
+
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+    if (period <= 4) {
+        float ps[QUANT_PATTERN];
+        float pb[QUANT_PATTERN];
+        for (uint32_t k = 0; k < QUANT_PATTERN; k++) {
+            ps[k] = scale[k % period];
+            pb[k] = bias[k % period];
+        }
+
+#if defined(__SSE2__)
+        __m128 vs[3], vb[3];
+        for (int k = 0; k < 3; k++) {
+            vs[k] = _mm_loadu_ps(ps + 4 * k);
+            vb[k] = _mm_loadu_ps(pb + 4 * k);
+        }
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i + 16 <= count; i += 16) {
+            __m128i raw = _mm_loadu_si128((const __m128i*)((const uint8_t*)src + i));
+            __m128i lo16, hi16;
+            if (dtype == TENSOR_TYPE_INT8) {
+                lo16 = _mm_srai_epi16(_mm_unpacklo_epi8(raw, raw), 8);
+                hi16 = _mm_srai_epi16(_mm_unpackhi_epi8(raw, raw), 8);
+            } else {
+                lo16 = _mm_unpacklo_epi8(raw, zero);
+                hi16 = _mm_unpackhi_epi8(raw, zero);
+            }
+            __m128i q[4] = {
+                _mm_srai_epi32(_mm_unpacklo_epi16(lo16, lo16), 16),
+                _mm_srai_epi32(_mm_unpackhi_epi16(lo16, lo16), 16),
+                _mm_srai_epi32(_mm_unpacklo_epi16(hi16, hi16), 16),
+                _mm_srai_epi32(_mm_unpackhi_epi16(hi16, hi16), 16),
+            };
+            size_t base = i / 4;
+            for (int k = 0; k < 4; k++) {
+                size_t p = (base + k) % 3;
+                __m128 x = _mm_cvtepi32_ps(q[k]);
+                _mm_storeu_ps(dst + i + 4 * k, _mm_add_ps(_mm_mul_ps(x, vs[p]), vb[p]));
+            }
+        }
+#else
+        float32x4_t vs[3], vb[3];
+        for (int k = 0; k < 3; k++) {
+            vs[k] = vld1q_f32(ps + 4 * k);
+            vb[k] = vld1q_f32(pb + 4 * k);
+        }
+
+        for (; i + 16 <= count; i += 16) {
+            int16x8_t lo16, hi16;
+            if (dtype == TENSOR_TYPE_INT8) {
+                int8x16_t raw = vld1q_s8((const int8_t*)src + i);
+                lo16 = vmovl_s8(vget_low_s8(raw));
+                hi16 = vmovl_high_s8(raw);
+            } else {
+                uint8x16_t raw = vld1q_u8((const uint8_t*)src + i);
+                lo16 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(raw)));
+                hi16 = vreinterpretq_s16_u16(vmovl_high_u8(raw));
+            }
+            int32x4_t q[4] = {
+                vmovl_s16(vget_low_s16(lo16)), vmovl_high_s16(lo16),
+                vmovl_s16(vget_low_s16(hi16)), vmovl_high_s16(hi16),
+            };
+            size_t base = i / 4;
+            for (int k = 0; k < 4; k++) {
+                size_t p = (base + k) % 3;
+                float32x4_t x = vcvtq_f32_s32(q[k]);
+                vst1q_f32(dst + i + 4 * k, vaddq_f32(vmulq_f32(x, vs[p]), vb[p]));
+            }
+        }
+#endif
+    }
+#endif
+
+    for (; i < count; i++) {
+        uint32_t c = (uint32_t)(i % period);
+        float q = dtype == TENSOR_TYPE_INT8 ? (float)((const int8_t*)src)[i] : (float)((const uint8_t*)src)[i];
+        dst[i] = q * scale[c] + bias[c];
+    }
+}
+
+/**
+ * @brief 量化区间上下文
+ */
+typedef struct {
+    const Tensor* input;
+    void* output;
+    TensorDataType dtype;           /**< 量化类型 */
+    bool dequantize;                /**< 是否为反量化 */
+    float* scale;                   /**< 按通道周期展开的乘数 */
+    float* bias;                    /**< 按通道周期展开的偏置 */
+    uint32_t period;                /**< 交错布局的通道周期 */
+    size_t plane;                   /**< 平面布局的通道平面大小（0表示交错布局） */
+} quant_job_t;
+
+// 处理从 offset 开始、与通道周期对齐的 count 个元素
+static void quant_span(const quant_job_t* job, size_t offset, size_t count, const float* scale,
+                       const float* bias, uint32_t period) {
+    if (job->dequantize) {
+        preprocess_dequantize_affine((const uint8_t*)job->input->data + offset, job->input->dtype,
+                                     (float*)job->output + offset, count, scale, bias, period);
+        return;
+    }
+
+    uint8_t* dst = (uint8_t*)job->output + offset;
+    if (job->input->dtype == TENSOR_TYPE_FLOAT32) {
+        preprocess_quantize_affine((const float*)job->input->data + offset, dst, job->dtype, count,
+                                   scale, bias, period);
+        return;
+    }
+
+    // 块长取通道周期的整数倍，使每块都从通道0开始
+    float buffer[QUANT_CHUNK];
+    size_t chunk = period <= QUANT_CHUNK ? QUANT_CHUNK / period * period : 0;
+    if (chunk == 0) {
+        for (size_t i = 0; i < count; i++) {
+            buffer[0] = preprocess_load_element(job->input->data, job->input->dtype, offset + i);
+            preprocess_quantize_affine(buffer, dst + i, job->dtype, 1, &scale[i % period], &bias[i % period], 1);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < count; i += chunk) {
+        size_t n = count - i < chunk ? count - i : chunk;
+        for (size_t k = 0; k < n; k++) {
+            buffer[k] = preprocess_load_element(job->input->data, job->input->dtype, offset + i + k);
+        }
+        preprocess_quantize_affine(buffer, dst + i, job->dtype, n, scale, bias, period);
+    }
+}
+
+static void quant_range(void* context, size_t begin, size_t end) {
+    const quant_job_t* job = (const quant_job_t*)context;
+
+    if (job->plane > 0) {
+        // 平面布局：每个通道平面使用单一参数
+        size_t i = begin;
+        while (i < end) {
+            size_t plane_index = i / job->plane;
+            size_t plane_end = (plane_index + 1) * job->plane;
+            if (plane_end > end) plane_end = end;
+            uint32_t c = (uint32_t)(plane_index % job->period);
+            quant_span(job, i, plane_end - i, &job->scale[c], &job->bias[c], 1);
+            i = plane_end;
+        }
+        return;
+    }
+
+    // 交错布局：逐元素处理到通道周期边界，之后的向量内核从通道0开始
+    size_t i = begin;
+    while (i < end && i % job->period != 0) {
+        uint32_t c = (uint32_t)(i % job->period);
+        quant_span(job, i, 1, &job->scale[c], &job->bias[c], 1);
+        i++;
+    }
+    if (i < end) {
+        quant_span(job, i, end - i, job->scale, job->bias, job->period);
+    }
+}
+
+int preprocess_quant_execute(preprocess_op_t op, const Tensor* input, Tensor* output, uint32_t num_threads,
+                             preprocess_workspace_t* workspace) {
+    const preprocess_params_t* params = &op->params;
+    bool dequantize = params->type == PREPROCESS_DEQUANTIZE;
+
+    if (!input->data || input->dtype == TENSOR_TYPE_STRING ||
+        (dequantize && input->dtype != TENSOR_TYPE_INT8 && input->dtype != TENSOR_TYPE_UINT8)) {
+        LOG_ERROR("Unsupported input type %d for %s", input->dtype, preprocess_type_to_string(params->type));
+        return -1;
+    }
+
+    quant_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.input = input;
+    job.output = output->data;
+    job.dtype = params->params.quantize.dtype;
+    job.dequantize = dequantize;
+
+    // 通道轴与归一化一致：图像按通道维，其余张量按最内层维度周期
+    uint32_t channels = params->params.quantize.channels;
+    preprocess_image_dims_t dims;
+    bool is_image = channels > 1 && preprocess_image_dims_from_shape(&input->shape, input->format, &dims) == 0;
+    job.period = is_image ? dims.c : channels;
+    if (is_image && dims.nchw) {
+        job.plane = (size_t)dims.h * dims.w;
+    }
+
+    // 通道数是参数个数的整数倍时参数按 channels 循环，周期不超过4，参数放在栈上
+    if (job.period % channels == 0) {
+        job.period = channels;
+    }
+    float affine[8];
+    void* buffer = NULL;
+    if (job.period <= 4) {
+        job.scale = affine;
+        job.bias = affine + 4;
+    } else {
+        buffer = preprocess_workspace_reserve(workspace, sizeof(float) * 2 * job.period);
+        if (!buffer) return -1;
+        job.scale = (float*)buffer;
+        job.bias = job.scale + job.period;
+    }
+
+    for (uint32_t c = 0; c < job.period; c++) {
+        float scale = params->params.quantize.scale[c % channels];
+        float zero_point = (float)params->params.quantize.zero_point[c % channels];
+        if (dequantize) {
+            // r = q × scale - zero_point × scale
+            job.scale[c] = scale;
+            job.bias[c] = -zero_point * scale;
+        } else {
+            // q = r / scale + zero_point
+            job.scale[c] = 1.0f / scale;
+            job.bias[c] = zero_point;
+        }
+    }
+
+    size_t total_elements = tensor_get_element_count(input);
+    size_t bytes_per_element = tensor_get_dtype_size(input->dtype) + tensor_get_dtype_size(output->dtype);
+    preprocess_parallel_for(num_threads, total_elements, bytes_per_element, quant_range, &job);
+
+    preprocess_workspace_release(workspace, buffer);
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include "utils/preprocessing_internal.h"
+#include "utils/logger.h"
+
+int preprocess_tokenize_infer_shape(preprocess_op_t op, const TensorShape* input_shape,
+                                    TensorShape* output_shape) {
+    if (input_shape->ndim != 1) {
+        LOG_ERROR("Tokenize expects a 1D string tensor");
+        return -1;
+    }
+
+    output_shape->ndim = 2;
+    output_shape->dims[0] = input_shape->dims[0];
+    output_shape->dims[1] = op->params.params.tokenize.max_length;
+    return 0;
+}
+
+int preprocess_tokenize_execute(preprocess_op_t op, const Tensor* input, Tensor* output,
+                                uint32_t num_threads) {
+    if (input->dtype != TENSOR_TYPE_STRING || !input->data) {
+        LOG_ERROR("Tokenize requires a STRING input tensor");
+        return -1;
+    }
+
+    return tokenizer_encode_batch(op->params.params.tokenize.tokenizer, (const char* const*)input->data,
+                                  input->shape.dims[0], (int32_t*)output->data,
+                                  op->params.params.tokenize.max_length, NULL, num_threads);
+}
@@ -0,0 +1,694 @@
+#include "utils/tensor_codec.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * 帧格式（小端）：
+ *   0  magic "MTC1"   4  version u8   5  element_size u8   6  filters u8（bit0 差分，bit1-2 重排方式）  7 保留
+ *   8  original_size u64             16 block_size u32    20 保留
+ * 随后每块：u32 块头（低31位为块数据长度，最高位表示原样存储）+ 块数据。
+ */
+
+static const uint8_t CODEC_MAGIC[4] = { 'M', 'T', 'C', '1' };
+
+#define CODEC_VERSION 1
+#define CODEC_HEADER_SIZE 24
+#define CODEC_BLOCK_STORED 0x80000000u
+#define CODEC_MAX_BLOCK_SIZE (16u * 1024 * 1024)
+
+#define LZ_HASH_BITS 14
+#define LZ_MIN_MATCH 4
+#define LZ_LAST_LITERALS 5
+#define LZ_MF_LIMIT 12
+#define LZ_MAX_DISTANCE 65535
+#define LZ_SKIP_TRIGGER 6
+
+static uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void put_le64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t get_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_le64(const uint8_t* p) {
+    return (uint64_t)get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+// ==================== 差分 ====================
+
+// 按元素宽度做整数差分（回绕运算，无损）；元素按主机字节序解释，解码时对称。
+// 每个差值只依赖输入，循环可以向量化
+static void delta_encode(const uint8_t* in, uint8_t* out, size_t count, uint32_t width) {
+    if (count == 0) return;
+    memcpy(out, in, width);
+
+    switch (width) {
+        case 1:
+            for (size_t i = 1; i < count; i++) {
+                out[i] = (uint8_t)(in[i] - in[i - 1]);
+            }
+            break;
+        case 2:
+            for (size_t i = 1; i < count; i++) {
+                uint16_t v, p;
+                memcpy(&v, in + 2 * i, 2);
+                memcpy(&p, in + 2 * i - 2, 2);
+                v = (uint16_t)(v - p);
+                memcpy(out + 2 * i, &v, 2);
+            }
+            break;
+        case 4:
+            for (size_t i = 1; i < count; i++) {
+                uint32_t v = read32(in + 4 * i) - read32(in + 4 * i - 4);
+                memcpy(out + 4 * i, &v, 4);
+            }
+            break;
+        default:
+            for (size_t i = 1; i < count; i++) {
+                uint64_t v = read64(in + 8 * i) - read64(in + 8 * i - 8);
+                memcpy(out + 8 * i, &v, 8);
+            }
+            break;
+    }
+}
+
+// 差分解码（原地前缀和）
+static void delta_decode(uint8_t* data, size_t count, uint32_t width) {
+    switch (width) {
+        case 1: {
+            uint8_t acc = 0;
+            for (size_t i = 0; i < count; i++) {
+                acc = (uint8_t)(acc + data[i]);
+                data[i] = acc;
+            }
+            break;
+        }
+        case 2: {
+            uint16_t acc = 0;
+            for (size_t i = 0; i < count; i++) {
+                uint16_t d;
+                memcpy(&d, data + 2 * i, 2);
+                acc = (uint16_t)(acc + d);
+                memcpy(data + 2 * i, &acc, 2);
+            }
+            break;
+        }
+        case 4: {
+            uint32_t acc = 0;
+            for (size_t i = 0; i < count; i++) {
+                acc += read32(data + 4 * i);
+                memcpy(data + 4 * i, &acc, 4);
+            }
+            break;
+        }
+        default: {
+            uint64_t acc = 0;
+            for (size_t i = 0; i < count; i++) {
+                acc += read64(data + 8 * i);
+                memcpy(data + 8 * i, &acc, 8);
+            }
+            break;
+        }
+    }
+}
+
+// ==================== 重排 ====================
+
+// 字节重排：第 b 个字节平面依次存放所有元素的第 b 个字节
+static void byte_shuffle(const uint8_t* in, uint8_t* out, size_t count, uint32_t width) {
+    if (width == 2) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = in[2 * i];
+            out[count + i] = in[2 * i + 1];
+        }
+        return;
+    }
+    if (width == 4) {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = in[4 * i];
+            out[count + i] = in[4 * i + 1];
+            out[2 * count + i] = in[4 * i + 2];
+            out[3 * count + i] = in[4 * i + 3];
+        }
+        return;
+    }
+    for (uint32_t b = 0; b < width; b++) {
+        for (size_t i = 0; i < count; i++) {
+            out[b * count + i] = in[i * width + b];
+        }
+    }
+}
+
+static void byte_unshuffle(const uint8_t* in, uint8_t* out, size_t count, uint32_t width) {
+    if (width == 2) {
+        for (size_t i = 0; i < count; i++) {
+            out[2 * i] = in[i];
+            out[2 * i + 1] = in[count + i];
+        }
+        return;
+    }
+    if (width == 4) {
+        for (size_t i = 0; i < count; i++) {
+            out[4 * i] = in[i];
+            out[4 * i + 1] = in[count + i];
+            out[4 * i + 2] = in[2 * count + i];
+            out[4 * i + 3] = in[3 * count + i];
+        }
+        return;
+    }
+    for (uint32_t b = 0; b < width; b++) {
+        for (size_t i = 0; i < count; i++) {
+            out[i * width + b] = in[b * count + i];
+        }
+    }
+}
+
+// 8x8 位矩阵转置：第 i 个字节的第 j 位与第 j 个字节的第 i 位交换（自身为逆运算）
+static uint64_t transpose8x8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+#if defined(__SSE2__)
+// 对两个 64 位通道分别做 8x8 位矩阵转置
+static __m128i transpose8x8_x2(__m128i x) {
+    const __m128i m1 = _mm_set1_epi64x(0x00AA00AA00AA00AALL);
+    const __m128i m2 = _mm_set1_epi64x(0x0000CCCC0000CCCCLL);
+    const __m128i m3 = _mm_set1_epi64x(0x00000000F0F0F0F0LL);
+    __m128i t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi64(x, 7)), m1);
+    x = _mm_xor_si128(_mm_xor_si128(x, t), _mm_slli_epi64(t, 7));
+    t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi64(x, 14)), m2);
+    x = _mm_xor_si128(_mm_xor_si128(x, t), _mm_slli_epi64(t, 14));
+    t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi64(x, 28)), m3);
+    x = _mm_xor_si128(_mm_xor_si128(x, t), _mm_slli_epi64(t, 28));
+    return x;
+}
+#endif
+
+// 把一个字节平面拆成 8 个位平面：第 b 个位平面的第 k 字节的第 j 位取自输入第 8k+j 字节的第 b 位；
+// 不足 8 字节的尾部原样放在最后
+static void bit_shuffle_plane(const uint8_t* in, uint8_t* out, size_t size) {
+    size_t groups = size / 8;
+    size_t k = 0;
+#if defined(__SSE2__)
+    // 每次 16 字节：movemask 取各字节最高位，左移后依次得到第 7..0 位平面的两个字节
+    for (; k + 2 <= groups; k += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + 8 * k));
+        for (int b = 7; b >= 0; b--) {
+            uint16_t mask = (uint16_t)_mm_movemask_epi8(v);
+            memcpy(out + b * groups + k, &mask, 2);
+            v = _mm_slli_epi16(v, 1);
+        }
+    }
+#endif
+    for (; k < groups; k++) {
+        uint64_t x = transpose8x8(read64(in + 8 * k));
+        for (int b = 0; b < 8; b++) {
+            out[b * groups + k] = (uint8_t)(x >> (8 * b));
+        }
+    }
+    memcpy(out + 8 * groups, in + 8 * groups, size - 8 * groups);
+}
+
+static void bit_unshuffle_plane(const uint8_t* in, uint8_t* out, size_t size) {
+    size_t groups = size / 8;
+    size_t k = 0;
+#if defined(__SSE2__)
+    // 每次 16 组：先把 8 个位平面按组交错（字节转置），再在每个 64 位通道内做位转置
+    for (; k + 16 <= groups; k += 16) {
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(in + 0 * groups + k));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(in + 1 * groups + k));
+        __m128i p2 = _mm_loadu_si128((const __m128i*)(in + 2 * groups + k));
+        __m128i p3 = _mm_loadu_si128((const __m128i*)(in + 3 * groups + k));
+        __m128i p4 = _mm_loadu_si128((const __m128i*)(in + 4 * groups + k));
+        __m128i p5 = _mm_loadu_si128((const __m128i*)(in + 5 * groups + k));
+        __m128i p6 = _mm_loadu_si128((const __m128i*)(in + 6 * groups + k));
+        __m128i p7 = _mm_loadu_si128((const __m128i*)(in + 7 * groups + k));
+
+        __m128i a01l = _mm_unpacklo_epi8(p0, p1), a01h = _mm_unpackhi_epi8(p0, p1);
+        __m128i a23l = _mm_unpacklo_epi8(p2, p3), a23h = _mm_unpackhi_epi8(p2, p3);
+        __m128i a45l = _mm_unpacklo_epi8(p4, p5), a45h = _mm_unpackhi_epi8(p4, p5);
+        __m128i a67l = _mm_unpacklo_epi8(p6, p7), a67h = _mm_unpackhi_epi8(p6, p7);
+
+        __m128i lo[4] = {
+            _mm_unpacklo_epi16(a01l, a23l), _mm_unpackhi_epi16(a01l, a23l),
+            _mm_unpacklo_epi16(a01h, a23h), _mm_unpackhi_epi16(a01h, a23h)
+        };
+        __m128i hi[4] = {
+            _mm_unpacklo_epi16(a45l, a67l), _mm_unpackhi_epi16(a45l, a67l),
+            _mm_unpacklo_epi16(a45h, a67h), _mm_unpackhi_epi16(a45h, a67h)
+        };
+
+        for (int m = 0; m < 4; m++) {
+            __m128i g01 = transpose8x8_x2(_mm_unpacklo_epi32(lo[m], hi[m]));
+            __m128i g23 = transpose8x8_x2(_mm_unpackhi_epi32(lo[m], hi[m]));
+            _mm_storeu_si128((__m128i*)(out + 8 * (k + 4 * m)), g01);
+            _mm_storeu_si128((__m128i*)(out + 8 * (k + 4 * m + 2)), g23);
+        }
+    }
+#endif
+    for (; k < groups; k++) {
+        uint64_t x = 0;
+        for (int b = 0; b < 8; b++) {
+            x |= (uint64_t)in[b * groups + k] << (8 * b);
+        }
+        x = transpose8x8(x);
+        memcpy(out + 8 * k, &x, 8);
+    }
+    memcpy(out + 8 * groups, in + 8 * groups, size - 8 * groups);
+}
+
+// ==================== LZ 后端 ====================
+
+static uint32_t lz_hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static uint8_t* lz_write_length(uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+// 长度字段扩展需要的字节数
+static size_t lz_length_bytes(size_t length) {
+    return length >= 15 ? (length - 15) / 255 + 1 : 0;
+}
+
+// 压缩一块数据，输出超过 capacity 时返回0（调用者改为原样存储）
+static size_t lz_compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity, uint32_t* table) {
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* iend = src + size;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + capacity;
+
+    if (size > LZ_MF_LIMIT) {
+        const uint8_t* mflimit = iend - LZ_MF_LIMIT;
+        const uint8_t* matchlimit = iend - LZ_LAST_LITERALS;
+        memset(table, 0, sizeof(uint32_t) << LZ_HASH_BITS);
+        ip++;
+
+        while (ip < mflimit) {
+            // 查找匹配：连续未命中时逐渐加大步长，快速跳过不可压缩的数据
+            const uint8_t* ref;
+            uint32_t attempts = 1u << LZ_SKIP_TRIGGER;
+            for (;;) {
+                uint32_t sequence = read32(ip);
+                uint32_t h = lz_hash(sequence);
+                ref = src + table[h];
+                table[h] = (uint32_t)(ip - src);
+                if (ref < ip && ip - ref <= LZ_MAX_DISTANCE && read32(ref) == sequence) break;
+                ip += attempts++ >> LZ_SKIP_TRIGGER;
+                if (ip >= mflimit) goto last_literals;
+            }
+
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+
+            const uint8_t* mp = ip + LZ_MIN_MATCH;
+            const uint8_t* rp = ref + LZ_MIN_MATCH;
+            while (mp + 8 <= matchlimit) {
+                uint64_t diff = read64(mp) ^ read64(rp);
+                if (diff) {
+                    mp += __builtin_ctzll(diff) >> 3;
+                    goto match_found;
+                }
+                mp += 8;
+                rp += 8;
+            }
+            while (mp < matchlimit && *mp == *rp) {
+                mp++;
+                rp++;
+            }
+match_found:;
+            size_t literals = (size_t)(ip - anchor);
+            size_t match = (size_t)(mp - ip) - LZ_MIN_MATCH;
+            size_t need = 1 + lz_length_bytes(literals) + literals + 2 + lz_length_bytes(match);
+            if (need > (size_t)(oend - op)) return 0;
+
+            uint8_t* token = op++;
+            *token = (uint8_t)((literals >= 15 ? 15 : literals) << 4);
+            if (literals >= 15) op = lz_write_length(op, literals - 15);
+            memcpy(op, anchor, literals);
+            op += literals;
+
+            size_t offset = (size_t)(ip - ref);
+            *op++ = (uint8_t)offset;
+            *op++ = (uint8_t)(offset >> 8);
+            *token |= (uint8_t)(match >= 15 ? 15 : match);
+            if (match >= 15) op = lz_write_length(op, match - 15);
+
+            ip = mp;
+            anchor = ip;
+            if (ip - 2 > src) {
+                table[lz_hash(read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+            }
+        }
+    }
+
+last_literals:;
+    size_t literals = (size_t)(iend - anchor);
+    if (1 + lz_length_bytes(literals) + literals > (size_t)(oend - op)) return 0;
+    *op++ = (uint8_t)((literals >= 15 ? 15 : literals) << 4);
+    if (literals >= 15) op = lz_write_length(op, literals - 15);
+    memcpy(op, anchor, literals);
+    op += literals;
+    return (size_t)(op - dst);
+}
+
+static int lz_read_length(const uint8_t** ip, const uint8_t* iend, size_t* length) {
+    uint8_t b;
+    do {
+        if (*ip >= iend) return -1;
+        b = *(*ip)++;
+        *length += b;
+    } while (b == 255);
+    return 0;
+}
+
+// 解压一块数据，输出必须恰好为 size 字节
+static int lz_decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t size) {
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + src_size;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + size;
+
+    for (;;) {
+        if (ip >= iend) return -1;
+        uint32_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && lz_read_length(&ip, iend, &literals) != 0) return -1;
+        if (literals > (size_t)(iend - ip) || literals > (size_t)(oend - op)) return -1;
+        if (literals <= 16 && iend - ip >= 16 && oend - op >= 16) {
+            // 短字面量用定长复制，避免逐次调用变长 memcpy
+            memcpy(op, ip, 16);
+        } else {
+            memcpy(op, ip, literals);
+        }
+        op += literals;
+        ip += literals;
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return -1;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) return -1;
+
+        size_t match = token & 15;
+        if (match == 15 && lz_read_length(&ip, iend, &match) != 0) return -1;
+        match += LZ_MIN_MATCH;
+        if (match > (size_t)(oend - op)) return -1;
+
+        const uint8_t* ref = op - offset;
+        if (offset == 1) {
+            memset(op, *ref, match);
+            op += match;
+        } else if (offset >= 8 && match + 8 <= (size_t)(oend - op)) {
+            // 间距不小于 8 时按 8 字节复制，末尾最多多写 7 字节（仍在输出范围内，随后被覆盖）
+            uint8_t* end = op + match;
+            do {
+                memcpy(op, ref, 8);
+                op += 8;
+                ref += 8;
+            } while (op < end);
+            op = end;
+        } else {
+            for (size_t i = 0; i < match; i++) {
+                op[i] = ref[i];
+            }
+            op += match;
+        }
+    }
+
+    return op == oend ? 0 : -1;
+}
+
+// ==================== 帧 ====================
+
+static bool options_valid(const tensor_codec_options_t* options) {
+    uint32_t w = options->element_size;
+    return (w == 1 || w == 2 || w == 4 || w == 8) && options->shuffle >= TENSOR_CODEC_SHUFFLE_NONE &&
+           options->shuffle <= TENSOR_CODEC_SHUFFLE_BIT;
+}
+
+// 依次做差分和重排，返回最终所在的缓冲区
+static const uint8_t* apply_filters(const uint8_t* src, size_t size, const tensor_codec_options_t* options,
+                                    uint8_t* a, uint8_t* b) {
+    uint32_t width = options->element_size;
+    size_t count = size / width;
+    size_t filtered = count * width;
+    const uint8_t* cur = src;
+
+    if (options->delta) {
+        delta_encode(cur, a, count, width);
+        cur = a;
+    }
+    if (options->shuffle != TENSOR_CODEC_SHUFFLE_NONE && width > 1) {
+        uint8_t* next = cur == a ? b : a;
+        byte_shuffle(cur, next, count, width);
+        cur = next;
+    }
+    if (options->shuffle == TENSOR_CODEC_SHUFFLE_BIT) {
+        uint8_t* next = cur == a ? b : a;
+        for (uint32_t p = 0; p < width; p++) {
+            bit_shuffle_plane(cur + p * count, next + p * count, count);
+        }
+        cur = next;
+    }
+
+    // 不足一个元素的尾部原样保留
+    if (cur != src) {
+        memcpy((uint8_t*)cur + filtered, src + filtered, size - filtered);
+    }
+    return cur;
+}
+
+// 逆向重排和差分，结果写入 dst（in 为 LZ 解出的数据，可能被改写）
+static void undo_filters(uint8_t* in, size_t size, uint32_t width, tensor_codec_shuffle_e shuffle, bool delta,
+                         uint8_t* scratch, uint8_t* dst) {
+    size_t count = size / width;
+    size_t filtered = count * width;
+    uint8_t* cur = in;
+
+    if (shuffle == TENSOR_CODEC_SHUFFLE_BIT) {
+        for (uint32_t p = 0; p < width; p++) {
+            bit_unshuffle_plane(cur + p * count, scratch + p * count, count);
+        }
+        memcpy(scratch + filtered, cur + filtered, size - filtered);
+        cur = scratch;
+    }
+    if (shuffle != TENSOR_CODEC_SHUFFLE_NONE && width > 1) {
+        byte_unshuffle(cur, dst, count, width);
+        memcpy(dst + filtered, cur + filtered, size - filtered);
+    } else if (cur != dst) {
+        memcpy(dst, cur, size);
+    }
+    if (delta) {
+        delta_decode(dst, count, width);
+    }
+}
+
+size_t tensor_codec_compress_bound(size_t size) {
+    size_t blocks = (size + TENSOR_CODEC_BLOCK_SIZE - 1) / TENSOR_CODEC_BLOCK_SIZE;
+    return CODEC_HEADER_SIZE + blocks * 4 + size;
+}
+
+int tensor_codec_compress(const void* src, size_t size, const tensor_codec_options_t* options,
+                          void* dst, size_t capacity, size_t* written) {
+    if ((!src && size > 0) || !options || !dst || !written || !options_valid(options)) {
+        LOG_ERROR("Invalid tensor codec arguments");
+        return -1;
+    }
+    if (capacity < CODEC_HEADER_SIZE) {
+        return -1;
+    }
+
+    bool filtered = options->delta || options->shuffle != TENSOR_CODEC_SHUFFLE_NONE;
+    uint8_t* scratch = malloc(2 * (size_t)TENSOR_CODEC_BLOCK_SIZE + (sizeof(uint32_t) << LZ_HASH_BITS));
+    if (!scratch) {
+        LOG_ERROR("Failed to allocate codec scratch buffers");
+        return -1;
+    }
+    uint8_t* a = scratch;
+    uint8_t* b = scratch + TENSOR_CODEC_BLOCK_SIZE;
+    uint32_t* table = (uint32_t*)(scratch + 2 * (size_t)TENSOR_CODEC_BLOCK_SIZE);
+
+    uint8_t* out = dst;
+    memcpy(out, CODEC_MAGIC, sizeof(CODEC_MAGIC));
+    out[4] = CODEC_VERSION;
+    out[5] = (uint8_t)options->element_size;
+    out[6] = (uint8_t)((options->delta ? 1 : 0) | ((uint32_t)options->shuffle << 1));
+    out[7] = 0;
+    put_le64(out + 8, size);
+    put_le32(out + 16, TENSOR_CODEC_BLOCK_SIZE);
+    put_le32(out + 20, 0);
+
+    const uint8_t* in = src;
+    size_t pos = CODEC_HEADER_SIZE;
+    int ret = 0;
+    for (size_t offset = 0; offset < size; offset += TENSOR_CODEC_BLOCK_SIZE) {
+        size_t block = size - offset < TENSOR_CODEC_BLOCK_SIZE ? size - offset : TENSOR_CODEC_BLOCK_SIZE;
+        if (capacity - pos < 4) {
+            ret = -1;
+            break;
+        }
+
+        const uint8_t* data = filtered ? apply_filters(in + offset, block, options, a, b) : in + offset;
+        size_t room = capacity - pos - 4;
+        size_t limit = block - 1 < room ? block - 1 : room;
+        size_t packed = block > 1 ? lz_compress(data, block, out + pos + 4, limit, table) : 0;
+
+        if (packed > 0) {
+            put_le32(out + pos, (uint32_t)packed);
+        } else {
+            if (block > room) {
+                ret = -1;
+                break;
+            }
+            memcpy(out + pos + 4, in + offset, block);
+            put_le32(out + pos, (uint32_t)block | CODEC_BLOCK_STORED);
+            packed = block;
+        }
+        pos += 4 + packed;
+    }
+
+    free(scratch);
+    if (ret != 0) {
+        LOG_ERROR("Tensor codec output buffer too small (%zu bytes)", capacity);
+        return -1;
+    }
+
+    *written = pos;
+    return 0;
+}
+
+int tensor_codec_get_original_size(const void* src, size_t size, size_t* original) {
+    const uint8_t* in = src;
+    if (!src || !original || size < CODEC_HEADER_SIZE || memcmp(in, CODEC_MAGIC, sizeof(CODEC_MAGIC)) != 0 ||
+        in[4] != CODEC_VERSION) {
+        return -1;
+    }
+
+    // 每块至少占块头和一个字节，据此拒绝声称的大小明显不可能的帧，避免按损坏的头分配内存
+    uint64_t value = get_le64(in + 8);
+    uint32_t block_size = get_le32(in + 16);
+    if (block_size == 0 || (uint64_t)(size_t)value != value ||
+        value / block_size + (value % block_size != 0) > (size - CODEC_HEADER_SIZE) / 5) {
+        return -1;
+    }
+    *original = (size_t)value;
+    return 0;
+}
+
+int tensor_codec_decompress(const void* src, size_t size, void* dst, size_t capacity, size_t* written) {
+    size_t original = 0;
+    if (!dst || !written || tensor_codec_get_original_size(src, size, &original) != 0) {
+        LOG_ERROR("Not a tensor codec frame");
+        return -1;
+    }
+    if (original > capacity) {
+        LOG_ERROR("Tensor codec output buffer too small: need %zu, have %zu", original, capacity);
+        return -1;
+    }
+
+    const uint8_t* in = src;
+    uint32_t width = in[5];
+    bool delta = (in[6] & 1) != 0;
+    tensor_codec_shuffle_e shuffle = (tensor_codec_shuffle_e)((in[6] >> 1) & 3);
+    uint32_t block_size = get_le32(in + 16);
+    if ((width != 1 && width != 2 && width != 4 && width != 8) || shuffle > TENSOR_CODEC_SHUFFLE_BIT ||
+        (in[6] & ~7u) != 0 || block_size == 0 || block_size > CODEC_MAX_BLOCK_SIZE) {
+        LOG_ERROR("Corrupt tensor codec header");
+        return -1;
+    }
+
+    bool filtered = delta || shuffle != TENSOR_CODEC_SHUFFLE_NONE;
+    uint8_t* scratch = filtered ? malloc(2 * (size_t)block_size) : NULL;
+    if (filtered && !scratch) {
+        LOG_ERROR("Failed to allocate codec scratch buffers");
+        return -1;
+    }
+
+    uint8_t* out = dst;
+    size_t pos = CODEC_HEADER_SIZE;
+    int ret = 0;
+    for (size_t offset = 0; offset < original && ret == 0; offset += block_size) {
+        size_t block = original - offset < block_size ? original - offset : block_size;
+        if (size - pos < 4) {
+            ret = -1;
+            break;
+        }
+
+        uint32_t header = get_le32(in + pos);
+        size_t packed = header & ~CODEC_BLOCK_STORED;
+        pos += 4;
+        if (packed > size - pos) {
+            ret = -1;
+            break;
+        }
+
+        if (header & CODEC_BLOCK_STORED) {
+            if (packed != block) {
+                ret = -1;
+                break;
+            }
+            memcpy(out + offset, in + pos, block);
+        } else if (!filtered) {
+            ret = lz_decompress(in + pos, packed, out + offset, block);
+        } else {
+            ret = lz_decompress(in + pos, packed, scratch, block);
+            if (ret == 0) {
+                undo_filters(scratch, block, width, shuffle, delta, scratch + block_size, out + offset);
+            }
+        }
+        pos += packed;
+    }
+
+    free(scratch);
+    if (ret != 0 || pos != size) {
+        LOG_ERROR("Corrupt tensor codec data");
+        return -1;
+    }
+
+    *written = original;
+    return 0;
+}
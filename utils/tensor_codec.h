@@ -0,0 +1,93 @@
+#ifndef MODYN_UTILS_TENSOR_CODEC_H
+#define MODYN_UTILS_TENSOR_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 张量无损压缩
+ *
+ * 数据按块（TENSOR_CODEC_BLOCK_SIZE）独立处理，每块依次经过：
+ * - 差分（可选）：按元素宽度做整数差分，适合缓慢变化的传感器流和音频
+ * - 重排：字节重排把各元素的同一字节放在一起，位重排进一步按位平面排列
+ * - LZ 后端：LZ4 风格的贪心匹配，没有熵编码，解压只做复制
+ * 压缩后不变小的块按原样存储，因此最坏情况只比原始数据多少量的块头。
+ */
+
+/**
+ * @brief 压缩块大小（字节）
+ */
+#define TENSOR_CODEC_BLOCK_SIZE (128 * 1024)
+
+/**
+ * @brief 重排方式
+ */
+typedef enum {
+    TENSOR_CODEC_SHUFFLE_NONE = 0,  /**< 不重排 */
+    TENSOR_CODEC_SHUFFLE_BYTE,      /**< 字节重排 */
+    TENSOR_CODEC_SHUFFLE_BIT        /**< 位重排 */
+} tensor_codec_shuffle_e;
+
+/**
+ * @brief 压缩选项
+ */
+typedef struct {
+    uint32_t element_size;          /**< 元素宽度（1、2、4、8字节） */
+    tensor_codec_shuffle_e shuffle; /**< 重排方式 */
+    bool delta;                     /**< 是否做差分 */
+} tensor_codec_options_t;
+
+/**
+ * @brief 压缩结果的最大可能大小
+ *
+ * @param size 原始数据大小
+ * @return size_t 输出缓冲区需要的字节数
+ */
+size_t tensor_codec_compress_bound(size_t size);
+
+/**
+ * @brief 压缩数据
+ *
+ * @param src 原始数据
+ * @param size 原始数据大小
+ * @param options 压缩选项
+ * @param dst 输出缓冲区
+ * @param capacity 输出缓冲区大小（不小于 tensor_codec_compress_bound 时一定成功）
+ * @param written 输出压缩后的大小
+ * @return int 0成功，其他失败
+ */
+int tensor_codec_compress(const void* src, size_t size, const tensor_codec_options_t* options,
+                          void* dst, size_t capacity, size_t* written);
+
+/**
+ * @brief 读取压缩数据的原始大小
+ *
+ * @param src 压缩数据
+ * @param size 压缩数据大小
+ * @param original 输出原始大小
+ * @return int 0成功，其他失败（不是压缩数据）
+ */
+int tensor_codec_get_original_size(const void* src, size_t size, size_t* original);
+
+/**
+ * @brief 解压数据（校验所有长度和偏移，损坏的输入返回失败）
+ *
+ * @param src 压缩数据
+ * @param size 压缩数据大小
+ * @param dst 输出缓冲区
+ * @param capacity 输出缓冲区大小（不小于原始大小）
+ * @param written 输出解压后的大小
+ * @return int 0成功，其他失败
+ */
+int tensor_codec_decompress(const void* src, size_t size, void* dst, size_t capacity, size_t* written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_TENSOR_CODEC_H
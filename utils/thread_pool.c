@@ -0,0 +1,228 @@
+#include "utils/thread_pool.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @brief 并行任务批次（位于调用线程栈上）
+ */
+typedef struct thread_pool_job_t {
+    thread_pool_task_func_t func;
+    void* context;
+    uint32_t task_count;
+    uint32_t next_task;         /**< 下一个待领取的任务 */
+    uint32_t done_tasks;        /**< 已完成任务数 */
+    uint32_t max_parallel;      /**< 最大并行度 */
+    uint32_t active;            /**< 正在执行该批次的线程数 */
+    struct thread_pool_job_t* next;
+} thread_pool_job_t;
+
+/**
+ * @brief 线程池内部结构
+ */
+struct thread_pool_internal_t {
+    pthread_t workers[THREAD_POOL_MAX_WORKERS];
+    uint32_t worker_count;
+    thread_pool_job_t* jobs;    /**< 尚有未领取任务的批次 */
+    bool shutdown;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+};
+
+static thread_pool_t g_shared_pool = NULL;
+static pthread_once_t g_shared_once = PTHREAD_ONCE_INIT;
+
+// 从队列中摘除批次（调用方持有锁）
+static void unlink_job(thread_pool_t pool, thread_pool_job_t* job) {
+    thread_pool_job_t** link = &pool->jobs;
+    while (*link) {
+        if (*link == job) {
+            *link = job->next;
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
+
+// 领取并执行批次中的任务，直到任务领完（调用方持有锁）
+static void drain_job(thread_pool_t pool, thread_pool_job_t* job) {
+    while (job->next_task < job->task_count) {
+        uint32_t index = job->next_task++;
+        if (job->next_task == job->task_count) {
+            unlink_job(pool, job);
+        }
+
+        pthread_mutex_unlock(&pool->mutex);
+        job->func(job->context, index);
+        pthread_mutex_lock(&pool->mutex);
+
+        job->done_tasks++;
+    }
+}
+
+// 查找可加入的批次（调用方持有锁）
+static thread_pool_job_t* find_job(thread_pool_t pool) {
+    for (thread_pool_job_t* job = pool->jobs; job; job = job->next) {
+        if (job->max_parallel == 0 || job->active < job->max_parallel) {
+            return job;
+        }
+    }
+    return NULL;
+}
+
+static void* worker_thread(void* arg) {
+    thread_pool_t pool = (thread_pool_t)arg;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        thread_pool_job_t* job;
+        while (!pool->shutdown && !(job = find_job(pool))) {
+            pthread_cond_wait(&pool->work_cond, &pool->mutex);
+        }
+        if (pool->shutdown) break;
+
+        job->active++;
+        drain_job(pool, job);
+        job->active--;
+
+        if (job->done_tasks == job->task_count && job->active == 0) {
+            pthread_cond_broadcast(&pool->done_cond);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+thread_pool_t thread_pool_create(uint32_t num_workers) {
+    thread_pool_t pool = malloc(sizeof(struct thread_pool_internal_t));
+    if (!pool) {
+        LOG_ERROR("Failed to allocate thread pool");
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(struct thread_pool_internal_t));
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    if (thread_pool_reserve(pool, num_workers) != 0) {
+        thread_pool_destroy(pool);
+        return NULL;
+    }
+
+    LOG_DEBUG("Created thread pool with %u workers", pool->worker_count);
+    return pool;
+}
+
+void thread_pool_destroy(thread_pool_t pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+int thread_pool_reserve(thread_pool_t pool, uint32_t num_workers) {
+    if (!pool) return -1;
+
+    if (num_workers > THREAD_POOL_MAX_WORKERS) {
+        num_workers = THREAD_POOL_MAX_WORKERS;
+    }
+
+    int ret = 0;
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->worker_count < num_workers) {
+        if (pthread_create(&pool->workers[pool->worker_count], NULL, worker_thread, pool) != 0) {
+            LOG_ERROR("Failed to create worker thread");
+            ret = -1;
+            break;
+        }
+        pool->worker_count++;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return ret;
+}
+
+uint32_t thread_pool_get_worker_count(thread_pool_t pool) {
+    if (!pool) return 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    uint32_t count = pool->worker_count;
+    pthread_mutex_unlock(&pool->mutex);
+
+    return count;
+}
+
+int thread_pool_parallel_for(thread_pool_t pool, uint32_t task_count, uint32_t max_parallel,
+                             thread_pool_task_func_t func, void* context) {
+    if (!func) return -1;
+    if (task_count == 0) return 0;
+
+    // 单任务或无线程池时直接在调用线程执行
+    if (!pool || task_count == 1 || max_parallel == 1) {
+        for (uint32_t i = 0; i < task_count; i++) {
+            func(context, i);
+        }
+        return 0;
+    }
+
+    thread_pool_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.func = func;
+    job.context = context;
+    job.task_count = task_count;
+    job.max_parallel = max_parallel;
+    job.active = 1;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    if (pool->worker_count == 0) {
+        pthread_mutex_unlock(&pool->mutex);
+        for (uint32_t i = 0; i < task_count; i++) {
+            func(context, i);
+        }
+        return 0;
+    }
+
+    job.next = pool->jobs;
+    pool->jobs = &job;
+    pthread_cond_broadcast(&pool->work_cond);
+
+    // 调用线程同样领取任务，避免嵌套调用时死锁
+    drain_job(pool, &job);
+    job.active--;
+
+    // 批次位于栈上，必须等所有参与线程离开后才能返回
+    while (job.done_tasks < job.task_count || job.active > 0) {
+        pthread_cond_wait(&pool->done_cond, &pool->mutex);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+    return 0;
+}
+
+static void create_shared_pool(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t workers = cpus > 1 ? (uint32_t)(cpus - 1) : 0;
+    g_shared_pool = thread_pool_create(workers);
+}
+
+thread_pool_t thread_pool_get_shared(void) {
+    pthread_once(&g_shared_once, create_shared_pool);
+    return g_shared_pool;
+}
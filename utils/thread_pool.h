@@ -0,0 +1,89 @@
+#ifndef MODYN_UTILS_THREAD_POOL_H
+#define MODYN_UTILS_THREAD_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 线程池最大工作线程数
+ */
+#define THREAD_POOL_MAX_WORKERS 64
+
+/**
+ * @brief 线程池句柄
+ */
+typedef struct thread_pool_internal_t* thread_pool_t;
+
+/**
+ * @brief 并行任务函数
+ *
+ * @param context 用户上下文
+ * @param index 任务索引 [0, task_count)
+ */
+typedef void (*thread_pool_task_func_t)(void* context, uint32_t index);
+
+/**
+ * @brief 创建线程池
+ *
+ * @param num_workers 工作线程数（0表示所有任务在调用线程执行）
+ * @return thread_pool_t 线程池实例
+ */
+thread_pool_t thread_pool_create(uint32_t num_workers);
+
+/**
+ * @brief 销毁线程池（等待工作线程退出）
+ *
+ * @param pool 线程池实例
+ */
+void thread_pool_destroy(thread_pool_t pool);
+
+/**
+ * @brief 确保线程池至少拥有指定数量的工作线程
+ *
+ * @param pool 线程池实例
+ * @param num_workers 工作线程数（超过 THREAD_POOL_MAX_WORKERS 时截断）
+ * @return int 0成功，其他失败
+ */
+int thread_pool_reserve(thread_pool_t pool, uint32_t num_workers);
+
+/**
+ * @brief 获取工作线程数
+ *
+ * @param pool 线程池实例
+ * @return uint32_t 工作线程数
+ */
+uint32_t thread_pool_get_worker_count(thread_pool_t pool);
+
+/**
+ * @brief 并行执行 task_count 个任务并等待全部完成
+ *
+ * 调用线程参与执行，因此可在任务内部嵌套调用而不会死锁。
+ *
+ * @param pool 线程池实例（NULL表示在调用线程串行执行）
+ * @param task_count 任务数量
+ * @param max_parallel 最大并行度（包含调用线程，0表示不限制）
+ * @param func 任务函数
+ * @param context 用户上下文
+ * @return int 0成功，其他失败
+ */
+int thread_pool_parallel_for(thread_pool_t pool, uint32_t task_count, uint32_t max_parallel,
+                             thread_pool_task_func_t func, void* context);
+
+/**
+ * @brief 获取进程共享线程池
+ *
+ * 首次调用时按在线 CPU 数创建，进程退出前不会销毁。
+ *
+ * @return thread_pool_t 共享线程池
+ */
+thread_pool_t thread_pool_get_shared(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_THREAD_POOL_H
@@ -0,0 +1,972 @@
+#include "utils/tokenizer.h"
+#include "utils/thread_pool.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// 编译后文件的魔数（"MDTK"）与版本
+#define TOKENIZER_MAGIC 0x4B54444Du
+#define TOKENIZER_VERSION 1
+
+// 续接前缀的最大长度（含结尾 NUL）
+#define TOKENIZER_PREFIX_BYTES 8
+
+// 合并表空槽标记
+#define MERGE_EMPTY UINT32_MAX
+
+/**
+ * @brief 编译后映像的文件头
+ *
+ * 映像布局：文件头 | Trie 单元 | 合并表 | 字符串偏移 | 字符串池，各段 4 字节对齐。
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t type;                  /**< tokenizer_type_e */
+    uint32_t lowercase;
+    uint32_t max_word_chars;
+    uint32_t vocab_size;
+    int32_t unk_id;
+    int32_t pad_id;
+    uint32_t trie_size;             /**< 双数组单元数 */
+    uint32_t merge_slots;           /**< 合并表槽数（2 的幂，0 表示无合并规则） */
+    uint32_t string_bytes;          /**< 字符串池字节数 */
+    char prefix[TOKENIZER_PREFIX_BYTES]; /**< WordPiece 续接前缀 */
+} tokenizer_header_t;
+
+/**
+ * @brief 双数组 Trie 单元：状态 s 经字节 c 转移到 t = base[s] + c，要求 check[t] == s
+ */
+typedef struct {
+    int32_t base;
+    int32_t check;                  /**< 父状态，-1 表示空闲 */
+    int32_t value;                  /**< 以该状态结尾的 token id，-1 表示非终止 */
+} trie_cell_t;
+
+/**
+ * @brief 合并规则：(left, right) -> merged，rank 越小优先级越高
+ */
+typedef struct {
+    uint32_t left;
+    uint32_t right;
+    int32_t rank;
+    int32_t merged;
+} merge_entry_t;
+
+/**
+ * @brief 分词器内部结构（所有表均指向同一块映像）
+ */
+struct tokenizer_internal_t {
+    void* image;
+    size_t image_size;
+    bool mapped;                    /**< 映像来自 mmap */
+    const tokenizer_header_t* header;
+    const trie_cell_t* trie;
+    const merge_entry_t* merges;
+    const uint32_t* offsets;
+    const char* strings;
+    int32_t prefix_state;           /**< 读入续接前缀后的状态，-1 表示前缀不在词表中 */
+};
+
+/**
+ * @brief 构建期指针 Trie 节点
+ */
+typedef struct {
+    uint32_t child;                 /**< 第一个子节点，0 表示无 */
+    uint32_t sibling;               /**< 下一个兄弟节点，0 表示无 */
+    int32_t id;
+    uint8_t label;
+} build_node_t;
+
+/**
+ * @brief 构建期数据
+ */
+typedef struct {
+    build_node_t* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+    trie_cell_t* cells;
+    uint32_t cell_capacity;
+    uint32_t cell_used;             /**< 已使用的最大单元序号 + 1 */
+} trie_builder_t;
+
+/**
+ * @brief 分词输出
+ */
+typedef struct {
+    int32_t* ids;
+    uint32_t capacity;
+    uint32_t count;                 /**< 已产生的 token 数（可能超过容量） */
+} token_sink_t;
+
+/**
+ * @brief BPE 候选合并
+ */
+typedef struct {
+    int32_t rank;
+    int32_t left_id;
+    int32_t right_id;
+    uint32_t left;                  /**< 左侧符号位置 */
+} bpe_candidate_t;
+
+/**
+ * @brief 批量分词上下文
+ */
+typedef struct {
+    tokenizer_t tokenizer;
+    const char* const* texts;
+    int32_t* ids;
+    uint32_t max_length;
+    uint32_t* lengths;
+} tokenize_batch_job_t;
+
+tokenizer_config_t tokenizer_default_config(tokenizer_type_e type) {
+    tokenizer_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.type = type;
+    config.max_word_chars = 100;
+
+    if (type == TOKENIZER_WORDPIECE) {
+        config.lowercase = true;
+        config.unk_token = "[UNK]";
+        config.pad_token = "[PAD]";
+        config.continuation_prefix = "##";
+    } else {
+        config.lowercase = false;
+        config.unk_token = "<unk>";
+        config.pad_token = "<pad>";
+        config.continuation_prefix = NULL;
+    }
+    return config;
+}
+
+// ================================
+// 双数组 Trie
+// ================================
+
+static inline int32_t trie_next(const trie_cell_t* trie, uint32_t size, int32_t state, uint8_t c) {
+    uint32_t t = (uint32_t)trie[state].base + c;
+    if (t >= size || trie[t].check != state) return -1;
+    return (int32_t)t;
+}
+
+// 从 state 出发读入 length 个字节，失败返回-1
+static int32_t trie_walk(const trie_cell_t* trie, uint32_t size, int32_t state, const char* key, size_t length) {
+    for (size_t i = 0; i < length && state >= 0; i++) {
+        state = trie_next(trie, size, state, (uint8_t)key[i]);
+    }
+    return state;
+}
+
+static int32_t trie_lookup(const trie_cell_t* trie, uint32_t size, const char* key, size_t length) {
+    int32_t state = trie_walk(trie, size, 0, key, length);
+    return state >= 0 ? trie[state].value : -1;
+}
+
+static int builder_add_node(trie_builder_t* b, uint8_t label) {
+    if (b->node_count == b->node_capacity) {
+        uint32_t capacity = b->node_capacity ? b->node_capacity * 2 : 1024;
+        build_node_t* grown = realloc(b->nodes, sizeof(build_node_t) * capacity);
+        if (!grown) return -1;
+        b->nodes = grown;
+        b->node_capacity = capacity;
+    }
+
+    build_node_t* node = &b->nodes[b->node_count];
+    node->child = 0;
+    node->sibling = 0;
+    node->id = -1;
+    node->label = label;
+    return (int)b->node_count++;
+}
+
+static int builder_insert(trie_builder_t* b, const char* key, int32_t id) {
+    uint32_t node = 0;
+
+    for (const uint8_t* p = (const uint8_t*)key; *p; p++) {
+        uint32_t child = b->nodes[node].child;
+        while (child && b->nodes[child].label != *p) {
+            child = b->nodes[child].sibling;
+        }
+        if (!child) {
+            int created = builder_add_node(b, *p);
+            if (created < 0) return -1;
+            child = (uint32_t)created;
+            b->nodes[child].sibling = b->nodes[node].child;
+            b->nodes[node].child = child;
+        }
+        node = child;
+    }
+
+    // 重复的 token 保留第一个 id
+    if (b->nodes[node].id < 0) b->nodes[node].id = id;
+    return 0;
+}
+
+static int builder_reserve_cells(trie_builder_t* b, uint32_t size) {
+    if (size <= b->cell_capacity) return 0;
+
+    uint32_t capacity = b->cell_capacity ? b->cell_capacity : 4096;
+    while (capacity < size) capacity *= 2;
+
+    trie_cell_t* grown = realloc(b->cells, sizeof(trie_cell_t) * capacity);
+    if (!grown) return -1;
+    for (uint32_t i = b->cell_capacity; i < capacity; i++) {
+        grown[i].base = 0;
+        grown[i].check = -1;
+        grown[i].value = -1;
+    }
+    b->cells = grown;
+    b->cell_capacity = capacity;
+    return 0;
+}
+
+// 按广度优先把指针 Trie 转换为双数组，为每个节点寻找能容纳所有子节点的 base
+static int builder_compile(trie_builder_t* b) {
+    uint32_t* queue_node = malloc(sizeof(uint32_t) * b->node_count);
+    int32_t* queue_state = malloc(sizeof(int32_t) * b->node_count);
+    if (!queue_node || !queue_state || builder_reserve_cells(b, 4096) != 0) {
+        free(queue_node);
+        free(queue_state);
+        return -1;
+    }
+
+    b->cells[0].check = 0;
+    b->cells[0].value = b->nodes[0].id;
+    b->cell_used = 1;
+
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t first_free = 1;
+    queue_node[tail] = 0;
+    queue_state[tail++] = 0;
+
+    while (head < tail) {
+        uint32_t node = queue_node[head];
+        int32_t state = queue_state[head++];
+
+        uint32_t child = b->nodes[node].child;
+        if (!child) continue;
+
+        uint8_t min_label = 255;
+        uint8_t max_label = 0;
+        for (uint32_t c = child; c; c = b->nodes[c].sibling) {
+            if (b->nodes[c].label < min_label) min_label = b->nodes[c].label;
+            if (b->nodes[c].label > max_label) max_label = b->nodes[c].label;
+        }
+
+        while (first_free < b->cell_capacity && b->cells[first_free].check != -1) {
+            first_free++;
+        }
+
+        // 从第一个空闲单元开始，找到所有子节点位置都空闲的 base
+        uint32_t base = first_free > min_label ? first_free - min_label : 0;
+        while (true) {
+            if (builder_reserve_cells(b, base + max_label + 1) != 0) {
+                free(queue_node);
+                free(queue_state);
+                return -1;
+            }
+            bool fits = true;
+            for (uint32_t c = child; c && fits; c = b->nodes[c].sibling) {
+                fits = b->cells[base + b->nodes[c].label].check == -1;
+            }
+            if (fits) break;
+            base++;
+        }
+
+        b->cells[state].base = (int32_t)base;
+        for (uint32_t c = child; c; c = b->nodes[c].sibling) {
+            uint32_t t = base + b->nodes[c].label;
+            b->cells[t].check = state;
+            b->cells[t].value = b->nodes[c].id;
+            if (t + 1 > b->cell_used) b->cell_used = t + 1;
+            queue_node[tail] = c;
+            queue_state[tail++] = (int32_t)t;
+        }
+    }
+
+    free(queue_node);
+    free(queue_state);
+    return 0;
+}
+
+// ================================
+// 合并表
+// ================================
+
+static inline uint32_t merge_hash(uint32_t left, uint32_t right) {
+    uint64_t key = ((uint64_t)left << 32) | right;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static const merge_entry_t* merge_find(tokenizer_t tok, int32_t left, int32_t right) {
+    uint32_t slots = tok->header->merge_slots;
+    if (slots == 0 || left < 0 || right < 0) return NULL;
+
+    uint32_t mask = slots - 1;
+    for (uint32_t i = merge_hash((uint32_t)left, (uint32_t)right) & mask;; i = (i + 1) & mask) {
+        const merge_entry_t* e = &tok->merges[i];
+        if (e->left == MERGE_EMPTY) return NULL;
+        if (e->left == (uint32_t)left && e->right == (uint32_t)right) return e;
+    }
+}
+
+// ================================
+// 映像
+// ================================
+
+static size_t align4(size_t n) {
+    return (n + 3) & ~(size_t)3;
+}
+
+// 计算各段偏移并绑定指针，同时校验映像完整性
+static int bind_image(tokenizer_t tok) {
+    if (tok->image_size < sizeof(tokenizer_header_t)) return -1;
+
+    const tokenizer_header_t* h = (const tokenizer_header_t*)tok->image;
+    if (h->magic != TOKENIZER_MAGIC || h->version != TOKENIZER_VERSION) return -1;
+    if (h->merge_slots & (h->merge_slots - 1)) return -1;
+    if (h->trie_size == 0 || h->prefix[TOKENIZER_PREFIX_BYTES - 1] != '\0') return -1;
+
+    size_t offset = align4(sizeof(tokenizer_header_t));
+    size_t trie_offset = offset;
+    offset += (size_t)h->trie_size * sizeof(trie_cell_t);
+    size_t merge_offset = offset;
+    offset += (size_t)h->merge_slots * sizeof(merge_entry_t);
+    size_t offsets_offset = offset;
+    offset += (size_t)h->vocab_size * sizeof(uint32_t);
+    size_t strings_offset = offset;
+    offset += h->string_bytes;
+    if (offset != tok->image_size || h->string_bytes == 0) return -1;
+
+    const uint8_t* base = (const uint8_t*)tok->image;
+    tok->header = h;
+    tok->trie = (const trie_cell_t*)(base + trie_offset);
+    tok->merges = (const merge_entry_t*)(base + merge_offset);
+    tok->offsets = (const uint32_t*)(base + offsets_offset);
+    tok->strings = (const char*)(base + strings_offset);
+
+    if (tok->strings[h->string_bytes - 1] != '\0') return -1;
+    for (uint32_t i = 0; i < h->vocab_size; i++) {
+        if (tok->offsets[i] >= h->string_bytes) return -1;
+    }
+
+    // 映像中的 id 会直接写入模型输入，必须都落在词表内
+    if (h->type != TOKENIZER_WORDPIECE && h->type != TOKENIZER_BPE) return -1;
+    // 编码时按 TOKENIZER_MAX_WORD_CHARS 使用栈上数组，单词长度上限不能超过它
+    if (h->max_word_chars == 0 || h->max_word_chars > TOKENIZER_MAX_WORD_CHARS) return -1;
+    if (h->vocab_size == 0 || h->vocab_size > (uint32_t)INT32_MAX) return -1;
+    if (h->unk_id < -1 || h->unk_id >= (int32_t)h->vocab_size) return -1;
+    if (h->pad_id < 0 || h->pad_id >= (int32_t)h->vocab_size) return -1;
+    for (uint32_t i = 0; i < h->trie_size; i++) {
+        int32_t value = tok->trie[i].value;
+        if (value < -1 || value >= (int32_t)h->vocab_size) return -1;
+    }
+
+    // 合并表必须留有空槽，否则查找时线性探测不会终止
+    bool has_empty = h->merge_slots == 0;
+    for (uint32_t i = 0; i < h->merge_slots; i++) {
+        const merge_entry_t* e = &tok->merges[i];
+        if (e->left == MERGE_EMPTY) {
+            has_empty = true;
+            continue;
+        }
+        if (e->left >= h->vocab_size || e->right >= h->vocab_size ||
+            e->merged < 0 || e->merged >= (int32_t)h->vocab_size) {
+            return -1;
+        }
+    }
+    if (!has_empty) return -1;
+
+    tok->prefix_state = -1;
+    if (h->type == TOKENIZER_WORDPIECE && h->prefix[0]) {
+        tok->prefix_state = trie_walk(tok->trie, h->trie_size, 0, h->prefix, strlen(h->prefix));
+    }
+    return 0;
+}
+
+tokenizer_t tokenizer_create(const tokenizer_config_t* config, const char* const* vocab, uint32_t vocab_size,
+                             const char* const* merges, uint32_t merge_count) {
+    if (!config || !vocab || vocab_size == 0) return NULL;
+
+    const char* prefix = config->continuation_prefix ? config->continuation_prefix : "";
+    if (strlen(prefix) >= TOKENIZER_PREFIX_BYTES) {
+        LOG_ERROR("Continuation prefix is longer than %d bytes", TOKENIZER_PREFIX_BYTES - 1);
+        return NULL;
+    }
+
+    trie_builder_t builder;
+    memset(&builder, 0, sizeof(builder));
+    tokenizer_t tok = NULL;
+    int ret = builder_add_node(&builder, 0) < 0 ? -1 : 0;
+
+    size_t string_bytes = 1;
+    for (uint32_t i = 0; i < vocab_size && ret == 0; i++) {
+        const char* token = vocab[i] ? vocab[i] : "";
+        if (token[0]) ret = builder_insert(&builder, token, (int32_t)i);
+        string_bytes += strlen(token) + 1;
+    }
+    if (ret == 0) ret = builder_compile(&builder);
+    if (ret != 0) {
+        LOG_ERROR("Failed to build tokenizer trie");
+        goto done;
+    }
+
+    uint32_t trie_size = builder.cell_used;
+    uint32_t merge_slots = 0;
+    if (config->type == TOKENIZER_BPE && merges && merge_count > 0) {
+        merge_slots = 16;
+        while (merge_slots < merge_count * 2) merge_slots *= 2;
+    }
+
+    size_t image_size = align4(sizeof(tokenizer_header_t)) + (size_t)trie_size * sizeof(trie_cell_t) +
+                        (size_t)merge_slots * sizeof(merge_entry_t) + (size_t)vocab_size * sizeof(uint32_t) +
+                        string_bytes;
+
+    tok = calloc(1, sizeof(struct tokenizer_internal_t));
+    void* image = tok ? calloc(1, image_size) : NULL;
+    if (!image) {
+        LOG_ERROR("Failed to allocate tokenizer image");
+        free(tok);
+        tok = NULL;
+        goto done;
+    }
+    tok->image = image;
+    tok->image_size = image_size;
+
+    tokenizer_header_t* h = (tokenizer_header_t*)image;
+    h->magic = TOKENIZER_MAGIC;
+    h->version = TOKENIZER_VERSION;
+    h->type = (uint32_t)config->type;
+    h->lowercase = config->lowercase ? 1 : 0;
+    h->max_word_chars = config->max_word_chars == 0 || config->max_word_chars > TOKENIZER_MAX_WORD_CHARS
+                            ? TOKENIZER_MAX_WORD_CHARS : config->max_word_chars;
+    h->vocab_size = vocab_size;
+    h->trie_size = trie_size;
+    h->merge_slots = merge_slots;
+    h->string_bytes = (uint32_t)string_bytes;
+    strcpy(h->prefix, prefix);
+
+    uint8_t* cursor = (uint8_t*)image + align4(sizeof(tokenizer_header_t));
+    memcpy(cursor, builder.cells, (size_t)trie_size * sizeof(trie_cell_t));
+    const trie_cell_t* trie = (const trie_cell_t*)cursor;
+    cursor += (size_t)trie_size * sizeof(trie_cell_t);
+
+    merge_entry_t* table = (merge_entry_t*)cursor;
+    for (uint32_t i = 0; i < merge_slots; i++) {
+        table[i].left = MERGE_EMPTY;
+    }
+    cursor += (size_t)merge_slots * sizeof(merge_entry_t);
+
+    // 字符串池首字节为空串，供空 token 使用
+    uint32_t* offsets = (uint32_t*)cursor;
+    char* strings = (char*)(cursor + (size_t)vocab_size * sizeof(uint32_t));
+    size_t pos = 1;
+    for (uint32_t i = 0; i < vocab_size; i++) {
+        const char* token = vocab[i] ? vocab[i] : "";
+        size_t len = strlen(token);
+        offsets[i] = len ? (uint32_t)pos : 0;
+        memcpy(strings + pos, token, len + 1);
+        pos += len + 1;
+    }
+
+    h->unk_id = config->unk_token ? trie_lookup(trie, trie_size, config->unk_token, strlen(config->unk_token)) : -1;
+    h->pad_id = config->pad_token ? trie_lookup(trie, trie_size, config->pad_token, strlen(config->pad_token)) : -1;
+    if (h->pad_id < 0) h->pad_id = 0;
+
+    // 合并规则 "左 右"：三个 token 都在词表中时才生效
+    uint32_t accepted = 0;
+    for (uint32_t r = 0; r < merge_count && merge_slots > 0; r++) {
+        const char* rule = merges[r];
+        const char* space = rule ? strchr(rule, ' ') : NULL;
+        if (!space || rule[0] == '#') continue;
+
+        size_t left_len = (size_t)(space - rule);
+        const char* right = space + 1;
+        size_t right_len = strcspn(right, " \r\n");
+        int32_t left_id = trie_lookup(trie, trie_size, rule, left_len);
+        int32_t right_id = trie_lookup(trie, trie_size, right, right_len);
+        int32_t state = trie_walk(trie, trie_size, 0, rule, left_len);
+        state = state >= 0 ? trie_walk(trie, trie_size, state, right, right_len) : -1;
+        int32_t merged_id = state >= 0 ? trie[state].value : -1;
+        if (left_id < 0 || right_id < 0 || merged_id < 0) continue;
+
+        uint32_t mask = merge_slots - 1;
+        uint32_t i = merge_hash((uint32_t)left_id, (uint32_t)right_id) & mask;
+        while (table[i].left != MERGE_EMPTY &&
+               !(table[i].left == (uint32_t)left_id && table[i].right == (uint32_t)right_id)) {
+            i = (i + 1) & mask;
+        }
+        if (table[i].left != MERGE_EMPTY) continue;
+
+        table[i].left = (uint32_t)left_id;
+        table[i].right = (uint32_t)right_id;
+        table[i].rank = (int32_t)r;
+        table[i].merged = merged_id;
+        accepted++;
+    }
+
+    if (bind_image(tok) != 0) {
+        LOG_ERROR("Tokenizer image is inconsistent");
+        tokenizer_destroy(tok);
+        tok = NULL;
+        goto done;
+    }
+
+    LOG_DEBUG("Created tokenizer: vocab=%u, trie=%u cells, merges=%u", vocab_size, trie_size, accepted);
+
+done:
+    free(builder.nodes);
+    free(builder.cells);
+    return tok;
+}
+
+// 读取文本文件并按行切分（就地替换换行符），返回行指针数组
+static char** read_lines(const char* path, char** buffer, uint32_t* count) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        LOG_ERROR("Failed to open %s", path);
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(fp);
+        return NULL;
+    }
+
+    char* data = malloc((size_t)size + 1);
+    if (!data || fread(data, 1, (size_t)size, fp) != (size_t)size) {
+        LOG_ERROR("Failed to read %s", path);
+        free(data);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    data[size] = '\0';
+
+    uint32_t lines = 0;
+    for (long i = 0; i < size; i++) {
+        if (data[i] == '\n') lines++;
+    }
+    if (size > 0 && data[size - 1] != '\n') lines++;
+
+    char** result = malloc(sizeof(char*) * (lines ? lines : 1));
+    if (!result) {
+        free(data);
+        return NULL;
+    }
+
+    uint32_t n = 0;
+    char* line = data;
+    for (long i = 0; i <= size && n < lines; i++) {
+        if (data[i] == '\n' || data[i] == '\0') {
+            data[i] = '\0';
+            if (i > 0 && data[i - 1] == '\r') data[i - 1] = '\0';
+            result[n++] = line;
+            line = data + i + 1;
+        }
+    }
+
+    *buffer = data;
+    *count = n;
+    return result;
+}
+
+tokenizer_t tokenizer_create_from_files(const tokenizer_config_t* config, const char* vocab_path,
+                                        const char* merges_path) {
+    if (!config || !vocab_path) return NULL;
+
+    char* vocab_data = NULL;
+    char* merge_data = NULL;
+    uint32_t vocab_size = 0;
+    uint32_t merge_count = 0;
+    char** merges = NULL;
+
+    char** vocab = read_lines(vocab_path, &vocab_data, &vocab_size);
+    if (!vocab) return NULL;
+
+    if (merges_path) {
+        merges = read_lines(merges_path, &merge_data, &merge_count);
+        if (!merges) {
+            free(vocab);
+            free(vocab_data);
+            return NULL;
+        }
+    }
+
+    tokenizer_t tok = tokenizer_create(config, (const char* const*)vocab, vocab_size,
+                                       (const char* const*)merges, merge_count);
+
+    free(vocab);
+    free(vocab_data);
+    free(merges);
+    free(merge_data);
+    return tok;
+}
+
+int tokenizer_save(tokenizer_t tokenizer, const char* path) {
+    if (!tokenizer || !path) return -1;
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) {
+        LOG_ERROR("Failed to create %s", path);
+        return -1;
+    }
+
+    size_t written = fwrite(tokenizer->image, 1, tokenizer->image_size, fp);
+    int ret = fclose(fp);
+    if (written != tokenizer->image_size || ret != 0) {
+        LOG_ERROR("Failed to write tokenizer to %s", path);
+        return -1;
+    }
+    return 0;
+}
+
+tokenizer_t tokenizer_load(const char* path) {
+    if (!path) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open %s", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void* image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        LOG_ERROR("Failed to map %s", path);
+        return NULL;
+    }
+
+    tokenizer_t tok = calloc(1, sizeof(struct tokenizer_internal_t));
+    if (!tok) {
+        munmap(image, (size_t)st.st_size);
+        return NULL;
+    }
+    tok->image = image;
+    tok->image_size = (size_t)st.st_size;
+    tok->mapped = true;
+
+    if (bind_image(tok) != 0) {
+        LOG_ERROR("%s is not a valid tokenizer file", path);
+        tokenizer_destroy(tok);
+        return NULL;
+    }
+
+    LOG_DEBUG("Mapped tokenizer %s: vocab=%u", path, tok->header->vocab_size);
+    return tok;
+}
+
+void tokenizer_destroy(tokenizer_t tokenizer) {
+    if (!tokenizer) return;
+
+    if (tokenizer->mapped) {
+        munmap(tokenizer->image, tokenizer->image_size);
+    } else {
+        free(tokenizer->image);
+    }
+    free(tokenizer);
+}
+
+uint32_t tokenizer_get_vocab_size(tokenizer_t tokenizer) {
+    return tokenizer ? tokenizer->header->vocab_size : 0;
+}
+
+int32_t tokenizer_get_pad_id(tokenizer_t tokenizer) {
+    return tokenizer ? tokenizer->header->pad_id : 0;
+}
+
+int32_t tokenizer_token_to_id(tokenizer_t tokenizer, const char* token) {
+    if (!tokenizer || !token || !token[0]) return -1;
+    return trie_lookup(tokenizer->trie, tokenizer->header->trie_size, token, strlen(token));
+}
+
+const char* tokenizer_id_to_token(tokenizer_t tokenizer, int32_t id) {
+    if (!tokenizer || id < 0 || (uint32_t)id >= tokenizer->header->vocab_size) return NULL;
+    return tokenizer->strings + tokenizer->offsets[id];
+}
+
+// ================================
+// 分词
+// ================================
+
+static inline void sink_emit(token_sink_t* sink, int32_t id) {
+    if (id < 0) return;
+    if (sink->count < sink->capacity) sink->ids[sink->count] = id;
+    sink->count++;
+}
+
+static inline size_t utf8_length(uint8_t c) {
+    if (c < 0x80) return 1;
+    if (c >= 0xF0) return 4;
+    if (c >= 0xE0) return 3;
+    if (c >= 0xC0) return 2;
+    return 1;
+}
+
+static uint32_t utf8_decode(const uint8_t* p, size_t len) {
+    switch (len) {
+        case 2: return ((uint32_t)(p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+        case 3: return ((uint32_t)(p[0] & 0x0F) << 12) | ((uint32_t)(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        case 4: return ((uint32_t)(p[0] & 0x07) << 18) | ((uint32_t)(p[1] & 0x3F) << 12) |
+                       ((uint32_t)(p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        default: return p[0];
+    }
+}
+
+static inline bool is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static inline bool is_ascii_punct(uint8_t c) {
+    return (c >= 33 && c <= 47) || (c >= 58 && c <= 64) || (c >= 91 && c <= 96) || (c >= 123 && c <= 126);
+}
+
+// CJK 汉字、CJK 标点和全角字符各自成词（与 BERT 的中文处理一致）
+static bool is_standalone(uint32_t cp) {
+    return (cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+           (cp >= 0x20000 && cp <= 0x2CEAF) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+           (cp >= 0x2F800 && cp <= 0x2FA1F) || (cp >= 0x3000 && cp <= 0x303F) ||
+           (cp >= 0xFF00 && cp <= 0xFFEF);
+}
+
+// WordPiece：从词首开始在 Trie 上一次遍历找到最长匹配，后续片段从续接前缀状态开始
+static void wordpiece_word(tokenizer_t tok, const char* word, size_t len, token_sink_t* sink) {
+    const trie_cell_t* trie = tok->trie;
+    uint32_t size = tok->header->trie_size;
+    uint32_t rollback = sink->count;
+    size_t start = 0;
+
+    while (start < len) {
+        int32_t state = start == 0 ? 0 : tok->prefix_state;
+        int32_t best_id = -1;
+        size_t best_end = start;
+
+        for (size_t p = start; p < len && state >= 0; p++) {
+            state = trie_next(trie, size, state, (uint8_t)word[p]);
+            if (state >= 0 && trie[state].value >= 0) {
+                best_id = trie[state].value;
+                best_end = p + 1;
+            }
+        }
+
+        if (best_id < 0) {
+            // 任一片段无法匹配时整个词输出为未知词
+            sink->count = rollback;
+            sink_emit(sink, tok->header->unk_id);
+            return;
+        }
+
+        sink_emit(sink, best_id);
+        start = best_end;
+    }
+}
+
+static void heap_push(bpe_candidate_t* heap, uint32_t* size, bpe_candidate_t item) {
+    uint32_t i = (*size)++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (heap[parent].rank < item.rank ||
+            (heap[parent].rank == item.rank && heap[parent].left <= item.left)) {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = item;
+}
+
+static bpe_candidate_t heap_pop(bpe_candidate_t* heap, uint32_t* size) {
+    bpe_candidate_t top = heap[0];
+    bpe_candidate_t last = heap[--(*size)];
+    uint32_t i = 0;
+
+    while (true) {
+        uint32_t child = 2 * i + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && (heap[child + 1].rank < heap[child].rank ||
+                                  (heap[child + 1].rank == heap[child].rank &&
+                                   heap[child + 1].left < heap[child].left))) {
+            child++;
+        }
+        if (last.rank < heap[child].rank || (last.rank == heap[child].rank && last.left <= heap[child].left)) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+static void bpe_push_pair(tokenizer_t tok, bpe_candidate_t* heap, uint32_t* size, const int32_t* ids,
+                          uint32_t left, uint32_t right) {
+    const merge_entry_t* e = merge_find(tok, ids[left], ids[right]);
+    if (!e) return;
+
+    bpe_candidate_t item = { e->rank, ids[left], ids[right], left };
+    heap_push(heap, size, item);
+}
+
+// BPE：以字符为初始符号，用最小堆按合并优先级反复合并相邻符号
+static void bpe_word(tokenizer_t tok, const char* word, size_t len, uint32_t chars, token_sink_t* sink) {
+    int32_t ids[TOKENIZER_MAX_WORD_CHARS];
+    int32_t prev[TOKENIZER_MAX_WORD_CHARS];
+    int32_t next[TOKENIZER_MAX_WORD_CHARS];
+    bpe_candidate_t heap[3 * TOKENIZER_MAX_WORD_CHARS];
+    uint32_t heap_size = 0;
+    uint32_t n = 0;
+
+    for (size_t p = 0; p < len && n < chars; n++) {
+        size_t cl = utf8_length((uint8_t)word[p]);
+        if (p + cl > len) cl = len - p;
+        int32_t id = trie_lookup(tok->trie, tok->header->trie_size, word + p, cl);
+        ids[n] = id >= 0 ? id : tok->header->unk_id;
+        prev[n] = (int32_t)n - 1;
+        next[n] = (int32_t)n + 1;
+        p += cl;
+    }
+    if (n == 0) return;
+    next[n - 1] = -1;
+
+    for (uint32_t i = 0; i + 1 < n; i++) {
+        bpe_push_pair(tok, heap, &heap_size, ids, i, i + 1);
+    }
+
+    while (heap_size > 0) {
+        bpe_candidate_t top = heap_pop(heap, &heap_size);
+        uint32_t left = top.left;
+        int32_t right = next[left];
+
+        // 过期候选：左侧已被合并掉，或相邻符号已变化
+        if (ids[left] != top.left_id || right < 0 || ids[right] != top.right_id) continue;
+
+        const merge_entry_t* e = merge_find(tok, top.left_id, top.right_id);
+        ids[left] = e->merged;
+        ids[right] = -2;
+        next[left] = next[right];
+        if (next[right] >= 0) prev[next[right]] = (int32_t)left;
+
+        if (prev[left] >= 0) bpe_push_pair(tok, heap, &heap_size, ids, (uint32_t)prev[left], left);
+        if (next[left] >= 0) bpe_push_pair(tok, heap, &heap_size, ids, left, (uint32_t)next[left]);
+    }
+
+    for (int32_t i = 0; i >= 0; i = next[i]) {
+        sink_emit(sink, ids[i]);
+    }
+}
+
+static void encode_word(tokenizer_t tok, const char* word, size_t len, uint32_t chars, token_sink_t* sink) {
+    const tokenizer_header_t* h = tok->header;
+    if (chars > h->max_word_chars) {
+        sink_emit(sink, h->unk_id);
+        return;
+    }
+
+    // 小写化只影响 ASCII，字节长度不变
+    char lowered[TOKENIZER_MAX_WORD_CHARS * 4];
+    if (h->lowercase) {
+        for (size_t i = 0; i < len; i++) {
+            char c = word[i];
+            lowered[i] = (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+        }
+        word = lowered;
+    }
+
+    if (h->type == TOKENIZER_WORDPIECE) {
+        wordpiece_word(tok, word, len, sink);
+    } else {
+        bpe_word(tok, word, len, chars, sink);
+    }
+}
+
+int tokenizer_encode(tokenizer_t tokenizer, const char* text, size_t length, int32_t* ids,
+                     uint32_t max_ids, uint32_t* num_ids) {
+    if (!tokenizer || (!text && length > 0) || (!ids && max_ids > 0) || !num_ids) return -1;
+
+    token_sink_t sink = { ids, max_ids, 0 };
+    const uint8_t* p = (const uint8_t*)text;
+    size_t i = 0;
+
+    while (i < length && sink.count < max_ids) {
+        if (is_space(p[i])) {
+            i++;
+            continue;
+        }
+
+        size_t cl = utf8_length(p[i]);
+        if (i + cl > length) cl = length - i;
+        if ((cl == 1 && is_ascii_punct(p[i])) || (cl > 1 && is_standalone(utf8_decode(p + i, cl)))) {
+            encode_word(tokenizer, text + i, cl, 1, &sink);
+            i += cl;
+            continue;
+        }
+
+        // 收集到空白、标点或独立字符为止
+        size_t start = i;
+        uint32_t chars = 0;
+        while (i < length && !is_space(p[i])) {
+            cl = utf8_length(p[i]);
+            if (i + cl > length) cl = length - i;
+            if ((cl == 1 && is_ascii_punct(p[i])) || (cl > 1 && is_standalone(utf8_decode(p + i, cl)))) break;
+            i += cl;
+            chars++;
+        }
+        encode_word(tokenizer, text + start, i - start, chars, &sink);
+    }
+
+    *num_ids = sink.count < max_ids ? sink.count : max_ids;
+    return 0;
+}
+
+static void encode_batch_task(void* context, uint32_t index) {
+    const tokenize_batch_job_t* job = (const tokenize_batch_job_t*)context;
+    int32_t* row = job->ids + (size_t)index * job->max_length;
+    const char* text = job->texts[index] ? job->texts[index] : "";
+    uint32_t count = 0;
+
+    tokenizer_encode(job->tokenizer, text, strlen(text), row, job->max_length, &count);
+
+    int32_t pad = job->tokenizer->header->pad_id;
+    for (uint32_t i = count; i < job->max_length; i++) {
+        row[i] = pad;
+    }
+    if (job->lengths) job->lengths[index] = count;
+}
+
+int tokenizer_encode_batch(tokenizer_t tokenizer, const char* const* texts, uint32_t count, int32_t* ids,
+                           uint32_t max_length, uint32_t* lengths, uint32_t num_threads) {
+    if (!tokenizer || !texts || !ids || max_length == 0) return -1;
+    if (count == 0) return 0;
+
+    tokenize_batch_job_t job = {
+        .tokenizer = tokenizer,
+        .texts = texts,
+        .ids = ids,
+        .max_length = max_length,
+        .lengths = lengths
+    };
+
+    thread_pool_t pool = thread_pool_get_shared();
+    if (num_threads > 1) thread_pool_reserve(pool, num_threads - 1);
+
+    return thread_pool_parallel_for(pool, count, num_threads == 0 ? 1 : num_threads, encode_batch_task, &job);
+}
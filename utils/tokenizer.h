@@ -0,0 +1,178 @@
+#ifndef MODYN_UTILS_TOKENIZER_H
+#define MODYN_UTILS_TOKENIZER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 分词算法
+ */
+typedef enum {
+    TOKENIZER_WORDPIECE = 0,        /**< WordPiece 贪心最长匹配（BERT） */
+    TOKENIZER_BPE                   /**< 按合并规则优先级的 BPE */
+} tokenizer_type_e;
+
+/**
+ * @brief 单词最大字符数上限
+ */
+#define TOKENIZER_MAX_WORD_CHARS 200
+
+/**
+ * @brief 分词器配置
+ *
+ * 预分词按空白切分，ASCII 标点和 CJK 汉字各自成为单独的词；
+ * 超过 max_word_chars 个字符的词整体输出为未知词。
+ */
+typedef struct {
+    tokenizer_type_e type;          /**< 分词算法 */
+    bool lowercase;                 /**< 是否将 ASCII 字母转为小写 */
+    const char* unk_token;          /**< 未知词（不在词表中时不输出） */
+    const char* pad_token;          /**< 批量补齐词（不在词表中时使用 0） */
+    const char* continuation_prefix; /**< WordPiece 词内续接前缀，最长 7 字节 */
+    uint32_t max_word_chars;        /**< 单词最大字符数（不超过 TOKENIZER_MAX_WORD_CHARS） */
+} tokenizer_config_t;
+
+/**
+ * @brief 分词器句柄
+ */
+typedef struct tokenizer_internal_t* tokenizer_t;
+
+/**
+ * @brief 获取默认配置
+ *
+ * WordPiece 使用 [UNK]/[PAD]/"##" 并转小写，BPE 使用 <unk>/<pad> 且保留大小写。
+ *
+ * @param type 分词算法
+ * @return tokenizer_config_t 默认配置
+ */
+tokenizer_config_t tokenizer_default_config(tokenizer_type_e type);
+
+/**
+ * @brief 由内存中的词表和合并规则创建分词器
+ *
+ * 词表编译为双数组 Trie，合并规则编译为按 (左, 右) 索引的哈希表。
+ *
+ * @param config 配置
+ * @param vocab 词表，下标即 token id
+ * @param vocab_size 词表大小
+ * @param merges 合并规则 "左 右"，下标即优先级（BPE 使用，可为NULL）
+ * @param merge_count 合并规则数量
+ * @return tokenizer_t 分词器实例
+ */
+tokenizer_t tokenizer_create(const tokenizer_config_t* config, const char* const* vocab, uint32_t vocab_size,
+                             const char* const* merges, uint32_t merge_count);
+
+/**
+ * @brief 由文本文件创建分词器
+ *
+ * 词表文件每行一个 token（行号即 id）；合并规则文件每行 "左 右"，以 # 开头的行忽略。
+ *
+ * @param config 配置
+ * @param vocab_path 词表文件路径
+ * @param merges_path 合并规则文件路径（WordPiece 可为NULL）
+ * @return tokenizer_t 分词器实例
+ */
+tokenizer_t tokenizer_create_from_files(const tokenizer_config_t* config, const char* vocab_path,
+                                        const char* merges_path);
+
+/**
+ * @brief 将编译后的分词器保存为二进制文件
+ *
+ * @param tokenizer 分词器实例
+ * @param path 输出路径
+ * @return int 0成功，其他失败
+ */
+int tokenizer_save(tokenizer_t tokenizer, const char* path);
+
+/**
+ * @brief 以内存映射方式加载 tokenizer_save 生成的文件
+ *
+ * Trie、字符串池和合并表直接在映射内存上使用，加载时不做解析和分配。
+ *
+ * @param path 文件路径
+ * @return tokenizer_t 分词器实例
+ */
+tokenizer_t tokenizer_load(const char* path);
+
+/**
+ * @brief 销毁分词器
+ *
+ * @param tokenizer 分词器实例
+ */
+void tokenizer_destroy(tokenizer_t tokenizer);
+
+/**
+ * @brief 获取词表大小
+ *
+ * @param tokenizer 分词器实例
+ * @return uint32_t 词表大小
+ */
+uint32_t tokenizer_get_vocab_size(tokenizer_t tokenizer);
+
+/**
+ * @brief 获取补齐词 id
+ *
+ * @param tokenizer 分词器实例
+ * @return int32_t 补齐词 id
+ */
+int32_t tokenizer_get_pad_id(tokenizer_t tokenizer);
+
+/**
+ * @brief 查找 token 的 id
+ *
+ * @param tokenizer 分词器实例
+ * @param token token 字符串
+ * @return int32_t token id，不存在时返回-1
+ */
+int32_t tokenizer_token_to_id(tokenizer_t tokenizer, const char* token);
+
+/**
+ * @brief 查找 id 对应的 token
+ *
+ * @param tokenizer 分词器实例
+ * @param id token id
+ * @return const char* token 字符串，id 无效时返回NULL
+ */
+const char* tokenizer_id_to_token(tokenizer_t tokenizer, int32_t id);
+
+/**
+ * @brief 对一段 UTF-8 文本分词
+ *
+ * 输出超过 max_ids 时截断。可在多个线程中对同一分词器并发调用。
+ *
+ * @param tokenizer 分词器实例
+ * @param text UTF-8 文本
+ * @param length 文本字节数
+ * @param ids 输出 token id
+ * @param max_ids 输出缓冲区容量
+ * @param num_ids 输出实际 token 数
+ * @return int 0成功，其他失败
+ */
+int tokenizer_encode(tokenizer_t tokenizer, const char* text, size_t length, int32_t* ids,
+                     uint32_t max_ids, uint32_t* num_ids);
+
+/**
+ * @brief 在共享线程池上并行分词一批文本
+ *
+ * @param tokenizer 分词器实例
+ * @param texts 以 NUL 结尾的 UTF-8 文本数组
+ * @param count 文本数量
+ * @param ids 输出 [count, max_length]，不足部分填充补齐词
+ * @param max_length 每条文本的最大 token 数
+ * @param lengths 每条文本的实际 token 数（可为NULL）
+ * @param num_threads 最大并行度
+ * @return int 0成功，其他失败
+ */
+int tokenizer_encode_batch(tokenizer_t tokenizer, const char* const* texts, uint32_t count, int32_t* ids,
+                           uint32_t max_length, uint32_t* lengths, uint32_t num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODYN_UTILS_TOKENIZER_H